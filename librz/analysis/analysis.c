@@ -45,6 +45,10 @@ void rz_analysis_hint_storage_init(RzAnalysis *a);
 
 void rz_analysis_hint_storage_fini(RzAnalysis *a);
 
+RZ_IPI bool rz_analysis_decoders_init(RzAnalysis *analysis);
+
+RZ_IPI void rz_analysis_decoders_fini(RzAnalysis *analysis);
+
 static void rz_meta_item_fini(RzAnalysisMetaItem *item) {
 	free(item->str);
 }
@@ -102,6 +106,7 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	(void)rz_analysis_xrefs_init(analysis);
 	analysis->diff_thbb = RZ_ANALYSIS_THRESHOLDBB;
 	analysis->diff_thfcn = RZ_ANALYSIS_THRESHOLDFCN;
+	analysis->diff_candidates = RZ_ANALYSIS_DIFF_CANDIDATES;
 	analysis->syscall = rz_syscall_new();
 	analysis->arch_target = rz_arch_target_new();
 	analysis->platform_target = rz_arch_platform_target_new();
@@ -127,8 +132,26 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	return analysis;
 }
 
+static bool plugin_init(RzAnalysis *analysis, RzAnalysisPlugin *p) {
+	analysis->cur = p;
+	if (p->init && !p->init(&analysis->plugin_data)) {
+		RZ_LOG_ERROR("analysis plugin '%s' failed to initialize.\n", p->name);
+		return false;
+	}
+	if (!rz_analysis_decoders_init(analysis)) {
+		RZ_LOG_ERROR("cannot allocate the decoders of analysis plugin '%s'.\n", p->name);
+		if (p->fini) {
+			p->fini(analysis->plugin_data);
+		}
+		analysis->plugin_data = NULL;
+		return false;
+	}
+	return true;
+}
+
 RZ_API void plugin_fini(RzAnalysis *analysis) {
 	RzAnalysisPlugin *p = analysis->cur;
+	rz_analysis_decoders_fini(analysis);
 	if (p && p->fini && !p->fini(analysis->plugin_data)) {
 		RZ_LOG_ERROR("analysis plugin '%s' failed to terminate.\n", p->name);
 	}
@@ -143,6 +166,7 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	}
 
 	plugin_fini(a);
+	rz_analysis_op_cache_set_size(a, 0);
 
 	rz_analysis_il_vm_cleanup(a);
 	rz_list_free(a->fcns);
@@ -180,6 +204,41 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	return NULL;
 }
 
+/**
+ * \brief Create a new RzAnalysis decoding instructions like \p a
+ *
+ * Only what rz_analysis_op() depends on is replicated: the current plugin,
+ * with a plugin context of its own, bits, cpu, endianness and options.
+ * Hints, io and core bindings are not, so the returned instance can decode
+ * from another thread when the plugin has RzAnalysisPlugin.op_stateless set.
+ */
+RZ_API RZ_OWN RzAnalysis *rz_analysis_new_decoder(RZ_NONNULL RzAnalysis *a) {
+	rz_return_val_if_fail(a, NULL);
+	RzAnalysis *d = rz_analysis_new();
+	if (!d) {
+		return NULL;
+	}
+	if (a->os) {
+		free(d->os);
+		d->os = strdup(a->os);
+	}
+	free(d->cpu);
+	d->cpu = a->cpu ? strdup(a->cpu) : NULL;
+	d->bits = a->bits;
+	d->pcalign = a->pcalign;
+	d->opt = a->opt;
+	rz_analysis_set_big_endian(d, a->big_endian);
+	if (a->cur) {
+		if (!plugin_init(d, a->cur)) {
+			d->cur = NULL;
+			rz_analysis_free(d);
+			return NULL;
+		}
+		rz_analysis_set_reg_profile(d);
+	}
+	return d;
+}
+
 RZ_API int rz_analysis_add(RzAnalysis *analysis, RzAnalysisPlugin *p) {
 	rz_list_append(analysis->plugins, p);
 	return true;
@@ -195,9 +254,7 @@ RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name) {
 				continue;
 			}
 			plugin_fini(analysis);
-			analysis->cur = h;
-			if (h->init && !h->init(&analysis->plugin_data)) {
-				RZ_LOG_ERROR("analysis plugin '%s' failed to initialize.\n", h->name);
+			if (!plugin_init(analysis, h)) {
 				return false;
 			}
 			rz_analysis_set_reg_profile(analysis);
@@ -220,6 +277,8 @@ RZ_API bool rz_analysis_set_reg_profile(RzAnalysis *analysis) {
 	bool ret = false;
 	char *p = rz_analysis_get_reg_profile(analysis);
 	if (p) {
+		// the cached ops point to the registers being replaced
+		rz_analysis_op_cache_clear(analysis);
 		rz_reg_set_profile_string(analysis->reg, p);
 		ret = true;
 	}
@@ -312,6 +371,7 @@ RZ_API int rz_analysis_get_address_bits(RzAnalysis *analysis) {
 RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
 	free(analysis->cpu);
 	analysis->cpu = cpu ? strdup(cpu) : NULL;
+	rz_analysis_op_cache_clear(analysis);
 	int v = rz_analysis_archinfo(analysis, RZ_ANALYSIS_ARCHINFO_ALIGN);
 	if (v != -1) {
 		analysis->pcalign = v;
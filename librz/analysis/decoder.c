@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file decoder.c
+ * Per-thread decoding contexts of the analysis plugins.
+ *
+ * Plugins implementing RzAnalysisPlugin.decoder_new keep what op() mutates
+ * while decoding (disassembler handles, instruction buffers, ...) in a
+ * context obtained with rz_analysis_decoder(), instead of plugin_data.
+ * Each thread gets its own context, created on its first use, so that the
+ * same RzAnalysis can decode from several threads without any lock.
+ */
+
+struct rz_analysis_decoders_t {
+	RzAnalysisPlugin *plugin;
+	RzThreadLocal *local; ///< Decoder of the calling thread
+	RzThreadLock *lock; ///< Guards all
+	RzList /*<Decoder *>*/ *all; ///< Decoders of all the threads, owned
+};
+
+typedef struct {
+	RzAnalysisDecoders *owner;
+	void *ctx;
+} Decoder;
+
+static void decoder_free(Decoder *dec) {
+	if (!dec) {
+		return;
+	}
+	dec->owner->plugin->decoder_free(dec->ctx);
+	free(dec);
+}
+
+// Called from the exiting thread, the owner is alive as long as the threads using it are
+static void decoder_thread_exit(void *value) {
+	Decoder *dec = value;
+	RzAnalysisDecoders *owner = dec->owner;
+	rz_th_lock_enter(owner->lock);
+	rz_list_delete_data(owner->all, dec);
+	rz_th_lock_leave(owner->lock);
+}
+
+RZ_IPI bool rz_analysis_decoders_init(RzAnalysis *analysis) {
+	RzAnalysisPlugin *plugin = analysis->cur;
+	if (!plugin || !plugin->decoder_new || !plugin->decoder_free) {
+		return true;
+	}
+	RzAnalysisDecoders *decs = RZ_NEW0(RzAnalysisDecoders);
+	if (!decs) {
+		return false;
+	}
+	decs->plugin = plugin;
+	decs->local = rz_th_local_new(decoder_thread_exit);
+	decs->lock = rz_th_lock_new(false);
+	decs->all = rz_list_newf((RzListFree)decoder_free);
+	if (!decs->local || !decs->lock || !decs->all) {
+		rz_th_local_free(decs->local);
+		rz_th_lock_free(decs->lock);
+		rz_list_free(decs->all);
+		free(decs);
+		return false;
+	}
+	analysis->decoders = decs;
+	return true;
+}
+
+RZ_IPI void rz_analysis_decoders_fini(RzAnalysis *analysis) {
+	RzAnalysisDecoders *decs = analysis->decoders;
+	if (!decs) {
+		return;
+	}
+	// no destructor can run anymore once the slot is gone
+	rz_th_local_free(decs->local);
+	rz_list_free(decs->all);
+	rz_th_lock_free(decs->lock);
+	free(decs);
+	analysis->decoders = NULL;
+}
+
+/**
+ * \brief Get the decoding context of the current plugin for the calling thread
+ *
+ * The context is created by RzAnalysisPlugin.decoder_new the first time a
+ * thread asks for it, and released when the thread exits or when the plugin
+ * is not used anymore.
+ *
+ * \return the context, or NULL if the plugin has none or it cannot be created
+ */
+RZ_API RZ_BORROW void *rz_analysis_decoder(RZ_NONNULL RzAnalysis *analysis) {
+	rz_return_val_if_fail(analysis, NULL);
+	RzAnalysisDecoders *decs = analysis->decoders;
+	if (!decs) {
+		return NULL;
+	}
+	Decoder *dec = rz_th_local_get(decs->local);
+	if (dec) {
+		return dec->ctx;
+	}
+	dec = RZ_NEW0(Decoder);
+	if (!dec) {
+		return NULL;
+	}
+	dec->owner = decs;
+	dec->ctx = decs->plugin->decoder_new(analysis);
+	if (!dec->ctx) {
+		free(dec);
+		return NULL;
+	}
+	rz_th_lock_enter(decs->lock);
+	if (!rz_list_append(decs->all, dec)) {
+		rz_th_lock_leave(decs->lock);
+		decoder_free(dec);
+		return NULL;
+	}
+	if (!rz_th_local_set(decs->local, dec)) {
+		rz_list_delete_data(decs->all, dec);
+		dec = NULL;
+	}
+	rz_th_lock_leave(decs->lock);
+	return dec ? dec->ctx : NULL;
+}
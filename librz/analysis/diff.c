@@ -109,10 +109,21 @@ RZ_API size_t rz_analysis_diff_fingerprint_fcn(RzAnalysis *analysis, RzAnalysisF
 	return fcn->fingerprint_size;
 }
 
+/**
+ * Upper bound of the similarity of two buffers of sizes \p a and \p b, since
+ * at least their difference has to be inserted. It is computed the same way
+ * as the similarity returned by rz_diff_levenstein_distance().
+ */
+static double diff_max_similarity(ut64 a, ut64 b) {
+	ut64 max = RZ_MAX(a, b);
+	return max ? 1.0 - (double)(max - RZ_MIN(a, b)) / max : 1.0;
+}
+
 RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2) {
-	RzAnalysisBlock *bb, *bb2, *mbb, *mbb2;
+	RzAnalysisBlock *bb, *bb2, *mbb, *mbb2, *last;
 	RzListIter *iter, *iter2;
-	double t, ot;
+	double t = 0.0, ot;
+	bool t_last = false;
 
 	if (!analysis || !fcn || !fcn2) {
 		return false;
@@ -126,10 +137,18 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 			continue;
 		}
 		ot = 0;
-		mbb = mbb2 = NULL;
+		mbb = mbb2 = last = NULL;
 		rz_list_foreach (fcn2->bbs, iter2, bb2) {
 			if (!bb2->diff || bb2->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL) {
+				last = bb2;
+				double max = diff_max_similarity(bb->size, bb2->size);
+				if (max <= analysis->diff_thbb || max <= ot) {
+					// cannot be a better match, skip the distance
+					t_last = false;
+					continue;
+				}
 				rz_diff_levenstein_distance(bb->fingerprint, bb->size, bb2->fingerprint, bb2->size, NULL, &t);
+				t_last = true;
 				if (t > analysis->diff_thbb && t > ot) {
 					ot = t;
 					mbb = bb;
@@ -150,6 +169,10 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 			if (!mbb->diff || !mbb2->diff) {
 				return false;
 			}
+			if (ot != 1 && !t_last) {
+				// the verdict below uses the similarity with the last block of fcn2
+				rz_diff_levenstein_distance(bb->fingerprint, bb->size, last->fingerprint, last->size, NULL, &t);
+			}
 			if (ot == 1 || t > analysis->diff_thfcn) {
 				mbb->diff->type = mbb2->diff->type = RZ_ANALYSIS_DIFF_TYPE_MATCH;
 			} else {
@@ -173,113 +196,594 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 	return true;
 }
 
-RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
-	RzAnalysisFunction *fcn, *fcn2, *mfcn, *mfcn2;
-	RzListIter *iter, *iter2;
-	double t, ot, sizes_div;
+/* Set flag in matched functions and diff their blocks */
+static void diff_fcn_pair(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2, double dist, int type) {
+	fcn->diff->type = fcn2->diff->type = type;
+	fcn->diff->dist = fcn2->diff->dist = dist;
+	RZ_FREE(fcn->fingerprint);
+	RZ_FREE(fcn2->fingerprint);
+	fcn->diff->addr = fcn2->addr;
+	fcn2->diff->addr = fcn->addr;
+	fcn->diff->size = fcn2->fingerprint_size;
+	fcn2->diff->size = fcn->fingerprint_size;
+	RZ_FREE(fcn->diff->name);
+	if (fcn2->name) {
+		fcn->diff->name = strdup(fcn2->name);
+	}
+	RZ_FREE(fcn2->diff->name);
+	if (fcn->name) {
+		fcn2->diff->name = strdup(fcn->name);
+	}
+	rz_analysis_diff_bb(analysis, fcn, fcn2);
+}
 
-	if (!analysis) {
+/* Compare functions with the same name */
+static bool diff_fcns_by_name(RzAnalysis *analysis, RzAnalysisFunction **fcns1, size_t n1, RzAnalysisFunction **fcns2, size_t n2, RzAnalysisDiffStats *stats) {
+	if (!n2) {
+		return true;
+	}
+	HtPP *by_name = ht_pp_new0();
+	if (!by_name) {
 		return false;
 	}
-	if (analysis->cur && analysis->cur->diff_fcn) {
-		return (analysis->cur->diff_fcn(analysis, fcns1, fcns2));
+	// a function without a name pairs with anything
+	size_t unnamed = n2;
+	for (size_t i = 0; i < n2; i++) {
+		if (!fcns2[i]->name) {
+			unnamed = RZ_MIN(unnamed, i);
+		} else {
+			// the first one with the name is kept
+			ht_pp_insert(by_name, fcns2[i]->name, (void *)(size_t)(i + 1));
+		}
 	}
-	/* Compare functions with the same name */
-	rz_list_foreach (fcns1, iter, fcn) {
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			if (fcn->name && fcn2->name && strcmp(fcn->name, fcn2->name)) {
+	for (size_t i = 0; i < n1; i++) {
+		RzAnalysisFunction *fcn = fcns1[i];
+		size_t j = 0;
+		if (fcn->name) {
+			j = (size_t)ht_pp_find(by_name, fcn->name, NULL);
+			j = j ? RZ_MIN(j - 1, unnamed) : unnamed;
+			if (j == n2) {
 				continue;
 			}
-			rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size,
-				fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
-			/* Set flag in matched functions */
-			fcn->diff->type = fcn2->diff->type = (t >= RZ_ANALYSIS_DIFF_THRESHOLD)
-				? RZ_ANALYSIS_DIFF_TYPE_MATCH
-				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			fcn->diff->dist = fcn2->diff->dist = t;
-			RZ_FREE(fcn->fingerprint);
-			RZ_FREE(fcn2->fingerprint);
-			fcn->diff->addr = fcn2->addr;
-			fcn2->diff->addr = fcn->addr;
-			fcn->diff->size = fcn2->fingerprint_size;
-			fcn2->diff->size = fcn->fingerprint_size;
-			RZ_FREE(fcn->diff->name);
-			if (fcn2->name) {
-				fcn->diff->name = strdup(fcn2->name);
-			}
-			RZ_FREE(fcn2->diff->name);
-			if (fcn->name) {
-				fcn2->diff->name = strdup(fcn->name);
-			}
-			rz_analysis_diff_bb(analysis, fcn, fcn2);
-			break;
 		}
+		RzAnalysisFunction *fcn2 = fcns2[j];
+		double t = 0.0;
+		rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size,
+			fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
+		stats->compared++;
+		diff_fcn_pair(analysis, fcn, fcn2, t,
+			t >= RZ_ANALYSIS_DIFF_THRESHOLD ? RZ_ANALYSIS_DIFF_TYPE_MATCH : RZ_ANALYSIS_DIFF_TYPE_UNMATCH);
+		stats->by_name++;
 	}
-	/* Compare remaining functions */
-	rz_list_foreach (fcns1, iter, fcn) {
-		if (fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-			continue;
-		} else if (!fcn->fingerprint_size) {
-			continue;
-		} else if (fcn->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn->type != RZ_ANALYSIS_FCN_TYPE_SYM) {
+	ht_pp_free(by_name);
+	return true;
+}
+
+static bool diff_fcn_eligible(RzAnalysisFunction *fcn) {
+	return fcn->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL && fcn->fingerprint_size &&
+		(fcn->type == RZ_ANALYSIS_FCN_TYPE_FCN || fcn->type == RZ_ANALYSIS_FCN_TYPE_SYM);
+}
+
+static double diff_sizes_ratio(ut64 a, ut64 b) {
+	return a > b ? (double)b / a : (double)a / b;
+}
+
+/* Compare remaining functions, each against all the others */
+static void diff_fcns_exhaustive(RzAnalysis *analysis, RzAnalysisFunction **fcns1, size_t n1, RzAnalysisFunction **fcns2, size_t n2, RzAnalysisDiffStats *stats) {
+	for (size_t i = 0; i < n1; i++) {
+		RzAnalysisFunction *fcn = fcns1[i], *mfcn2 = NULL;
+		if (!diff_fcn_eligible(fcn)) {
 			continue;
 		}
-		ot = 0.0;
-		mfcn = mfcn2 = NULL;
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			if (fcn2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-				continue;
-			} else if (!fcn2->fingerprint_size) {
+		double t = 0.0, ot = 0.0;
+		for (size_t j = 0; j < n2; j++) {
+			RzAnalysisFunction *fcn2 = fcns2[j];
+			if (!diff_fcn_eligible(fcn2)) {
 				continue;
-			} else if (fcn2->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn2->type != RZ_ANALYSIS_FCN_TYPE_SYM) {
-				continue;
-			}
-			if (fcn->fingerprint_size > fcn2->fingerprint_size) {
-				sizes_div = fcn2->fingerprint_size;
-				sizes_div /= fcn->fingerprint_size;
-			} else {
-				sizes_div = fcn->fingerprint_size;
-				sizes_div /= fcn2->fingerprint_size;
 			}
-			if (sizes_div < RZ_ANALYSIS_DIFF_THRESHOLD) {
+			if (diff_sizes_ratio(fcn->fingerprint_size, fcn2->fingerprint_size) < RZ_ANALYSIS_DIFF_THRESHOLD) {
 				continue;
 			}
 			rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size, fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
+			stats->compared++;
 			if (t > ot) {
 				ot = t;
-				mfcn = fcn;
 				mfcn2 = fcn2;
 				if (ot >= RZ_ANALYSIS_DIFF_THRESHOLD) {
 					break;
 				}
 			}
 		}
-		if (mfcn && mfcn2) {
-			mfcn->diff->dist = mfcn2->diff->dist = ot;
-			/* Set flag in matched functions */
-			mfcn->diff->type = mfcn2->diff->type = (ot > RZ_ANALYSIS_DIFF_THRESHOLD)
-				? RZ_ANALYSIS_DIFF_TYPE_MATCH
-				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			RZ_FREE(mfcn->fingerprint);
-			RZ_FREE(mfcn2->fingerprint);
-			mfcn->diff->addr = mfcn2->addr;
-			mfcn2->diff->addr = mfcn->addr;
-			mfcn->diff->size = mfcn2->fingerprint_size;
-			mfcn2->diff->size = mfcn->fingerprint_size;
-			RZ_FREE(mfcn->diff->name);
-			if (mfcn2->name) {
-				mfcn->diff->name = strdup(mfcn2->name);
+		if (mfcn2) {
+			diff_fcn_pair(analysis, fcn, mfcn2, ot,
+				ot > RZ_ANALYSIS_DIFF_THRESHOLD ? RZ_ANALYSIS_DIFF_TYPE_MATCH : RZ_ANALYSIS_DIFF_TYPE_UNMATCH);
+			stats->similar++;
+		}
+	}
+}
+
+/*
+ * The remaining functions are compared only against a few candidates: the
+ * ones sharing a band of their MinHash sketch (4-byte shingles of the
+ * fingerprint), ranked by the estimated similarity and then by the closest
+ * count of blocks and complexity, plus the ones of the closest sizes.
+ */
+#define DIFF_MINHASHES    32
+#define DIFF_BAND_ROWS    2
+#define DIFF_BANDS        (DIFF_MINHASHES / DIFF_BAND_ROWS)
+#define DIFF_BUCKET_MAX   256
+#define DIFF_MIN_PARALLEL 64
+
+typedef struct {
+	ut64 key;
+	ut32 idx; ///< index of the function in its list
+} DiffKey;
+
+typedef struct {
+	ut64 minhash[DIFF_MINHASHES];
+	ut32 nbbs;
+	int complexity;
+} DiffSketch;
+
+typedef struct {
+	ut32 idx; ///< index of the candidate in the second list
+	double dist;
+} DiffCandidate;
+
+typedef struct {
+	ut32 idx;
+	ut32 shared; ///< count of equal minhashes
+	ut32 nbbs_delta;
+	ut32 complexity_delta;
+} DiffRank;
+
+typedef struct {
+	RzAnalysisFunction **fcns1;
+	RzAnalysisFunction **fcns2;
+	DiffSketch *sketches2; ///< sketches of the functions of the second list
+	DiffKey *bands; ///< keys of the bands of the eligible functions of the second list, sorted
+	size_t n_bands;
+	DiffKey *sizes; ///< eligible functions of the second list, sorted by fingerprint size
+	size_t n_sizes;
+	size_t max_candidates;
+	ut32 *jobs; ///< functions of the first list to find candidates for
+	size_t n_jobs;
+	RzVector /*<DiffCandidate>*/ *candidates; ///< candidates of the jobs of each shard, one job after the other
+	size_t n_shards;
+	size_t *offsets; ///< offset of the candidates of each job in the ones of its shard
+	size_t *n_candidates;
+} DiffIndex;
+
+typedef struct {
+	DiffIndex *index;
+	size_t first; ///< first job of the shard, the next ones are step apart
+	size_t step;
+	DiffCandidate *scratch; ///< 2 * max_candidates slots for the job being computed
+	ut64 compared;
+	bool failed;
+} DiffShard;
+
+static inline ut64 diff_mix(ut64 x) {
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+static ut64 diff_fingerprint_hash(const ut8 *buf, size_t size) {
+	ut64 h = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < size; i++) {
+		h = (h ^ buf[i]) * 0x100000001b3ULL;
+	}
+	return h;
+}
+
+static void diff_sketch(RzAnalysisFunction *fcn, DiffSketch *sketch) {
+	ut64 seeds[DIFF_MINHASHES];
+	for (size_t k = 0; k < DIFF_MINHASHES; k++) {
+		seeds[k] = diff_mix(k + 1);
+		sketch->minhash[k] = UT64_MAX;
+	}
+	ut8 tail[4] = { 0 };
+	const ut8 *buf = fcn->fingerprint;
+	size_t shingles = fcn->fingerprint_size - 3;
+	if (fcn->fingerprint_size < 4) {
+		memcpy(tail, buf, fcn->fingerprint_size);
+		buf = tail;
+		shingles = 1;
+	}
+	for (size_t i = 0; i < shingles; i++) {
+		ut64 h = diff_mix(rz_read_le32(buf + i));
+		for (size_t k = 0; k < DIFF_MINHASHES; k++) {
+			ut64 v = (h ^ seeds[k]) * 0x9e3779b97f4a7c15ULL;
+			v ^= v >> 29;
+			sketch->minhash[k] = RZ_MIN(sketch->minhash[k], v);
+		}
+	}
+	sketch->nbbs = rz_list_length(fcn->bbs);
+	sketch->complexity = rz_analysis_function_complexity(fcn);
+}
+
+static ut64 diff_band_key(const DiffSketch *sketch, size_t band) {
+	ut64 key = band;
+	for (size_t r = 0; r < DIFF_BAND_ROWS; r++) {
+		key = diff_mix(key ^ sketch->minhash[band * DIFF_BAND_ROWS + r]);
+	}
+	return key;
+}
+
+static int diff_key_cmp(const void *a, const void *b) {
+	const DiffKey *ka = a, *kb = b;
+	if (ka->key != kb->key) {
+		return ka->key < kb->key ? -1 : 1;
+	}
+	return ka->idx < kb->idx ? -1 : ka->idx > kb->idx;
+}
+
+static int diff_idx_cmp(const void *a, const void *b) {
+	ut32 ia = *(const ut32 *)a, ib = *(const ut32 *)b;
+	return ia < ib ? -1 : ia > ib;
+}
+
+static int diff_candidate_cmp(const void *a, const void *b) {
+	return diff_idx_cmp(&((const DiffCandidate *)a)->idx, &((const DiffCandidate *)b)->idx);
+}
+
+static int diff_rank_cmp(const void *a, const void *b) {
+	const DiffRank *ra = a, *rb = b;
+	if (ra->shared != rb->shared) {
+		return ra->shared > rb->shared ? -1 : 1;
+	}
+	if (ra->nbbs_delta != rb->nbbs_delta) {
+		return ra->nbbs_delta < rb->nbbs_delta ? -1 : 1;
+	}
+	if (ra->complexity_delta != rb->complexity_delta) {
+		return ra->complexity_delta < rb->complexity_delta ? -1 : 1;
+	}
+	return diff_idx_cmp(&ra->idx, &rb->idx);
+}
+
+/* Index of the first key not lower than \p key */
+static size_t diff_keys_lower_bound(const DiffKey *keys, size_t n, ut64 key) {
+	size_t lo = 0, hi = n;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (keys[mid].key < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/* Fills \p out with the candidates of \p fcn sorted by their index and returns their count */
+static size_t diff_candidates_find(DiffIndex *index, RzAnalysisFunction *fcn, DiffCandidate *out) {
+	DiffSketch sketch;
+	diff_sketch(fcn, &sketch);
+	size_t k = index->max_candidates, count = 0;
+	ut32 *hits = RZ_NEWS(ut32, DIFF_BANDS * DIFF_BUCKET_MAX);
+	DiffRank *ranks = RZ_NEWS(DiffRank, DIFF_BANDS * DIFF_BUCKET_MAX);
+	if (hits && ranks) {
+		size_t n_hits = 0;
+		for (size_t b = 0; b < DIFF_BANDS; b++) {
+			ut64 key = diff_band_key(&sketch, b);
+			size_t i = diff_keys_lower_bound(index->bands, index->n_bands, key);
+			for (size_t n = 0; i < index->n_bands && index->bands[i].key == key && n < DIFF_BUCKET_MAX; i++, n++) {
+				hits[n_hits++] = index->bands[i].idx;
+			}
+		}
+		qsort(hits, n_hits, sizeof(ut32), diff_idx_cmp);
+		size_t n_ranks = 0;
+		for (size_t i = 0; i < n_hits; i++) {
+			if (i && hits[i] == hits[i - 1]) {
+				continue;
+			}
+			RzAnalysisFunction *fcn2 = index->fcns2[hits[i]];
+			if (diff_sizes_ratio(fcn->fingerprint_size, fcn2->fingerprint_size) < RZ_ANALYSIS_DIFF_THRESHOLD) {
+				continue;
 			}
-			RZ_FREE(mfcn2->diff->name);
-			if (mfcn->name) {
-				mfcn2->diff->name = strdup(mfcn->name);
+			const DiffSketch *sketch2 = &index->sketches2[hits[i]];
+			DiffRank *rank = &ranks[n_ranks++];
+			rank->idx = hits[i];
+			rank->shared = 0;
+			for (size_t m = 0; m < DIFF_MINHASHES; m++) {
+				rank->shared += sketch.minhash[m] == sketch2->minhash[m];
 			}
-			rz_analysis_diff_bb(analysis, mfcn, mfcn2);
+			rank->nbbs_delta = RZ_ABS((st64)sketch.nbbs - sketch2->nbbs);
+			rank->complexity_delta = RZ_ABS(sketch.complexity - sketch2->complexity);
+		}
+		qsort(ranks, n_ranks, sizeof(DiffRank), diff_rank_cmp);
+		for (size_t i = 0; i < n_ranks && count < k; i++) {
+			out[count++].idx = ranks[i].idx;
+		}
+	}
+	free(hits);
+	free(ranks);
+
+	// the closest sizes, for what the sketches missed
+	const ut64 size = fcn->fingerprint_size;
+	const DiffKey *sizes = index->sizes;
+	size_t hi = diff_keys_lower_bound(sizes, index->n_sizes, size), lo = hi;
+	for (size_t n = 0; n < k; n++) {
+		bool up = hi < index->n_sizes && diff_sizes_ratio(size, sizes[hi].key) >= RZ_ANALYSIS_DIFF_THRESHOLD;
+		bool down = lo > 0 && diff_sizes_ratio(size, sizes[lo - 1].key) >= RZ_ANALYSIS_DIFF_THRESHOLD;
+		if (!up && !down) {
+			break;
+		}
+		if (up && (!down || sizes[hi].key - size <= size - sizes[lo - 1].key)) {
+			out[count++].idx = sizes[hi++].idx;
+		} else {
+			out[count++].idx = sizes[--lo].idx;
+		}
+	}
+
+	// in the order of the list, like the exhaustive comparison
+	qsort(out, count, sizeof(DiffCandidate), diff_candidate_cmp);
+	size_t unique = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (!unique || out[unique - 1].idx != out[i].idx) {
+			out[unique++] = out[i];
 		}
 	}
+	return unique;
+}
+
+static void diff_shard_compute(void *user) {
+	DiffShard *shard = user;
+	DiffIndex *index = shard->index;
+	RzVector *found = &index->candidates[shard->first];
+	DiffCandidate *candidates = shard->scratch;
+	for (size_t j = shard->first; j < index->n_jobs; j += shard->step) {
+		RzAnalysisFunction *fcn = index->fcns1[index->jobs[j]];
+		size_t count = diff_candidates_find(index, fcn, candidates);
+		for (size_t i = 0; i < count; i++) {
+			RzAnalysisFunction *fcn2 = index->fcns2[candidates[i].idx];
+			candidates[i].dist = 0.0;
+			rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size,
+				fcn2->fingerprint, fcn2->fingerprint_size, NULL, &candidates[i].dist);
+		}
+		shard->compared += count;
+		index->offsets[j] = rz_vector_len(found);
+		if (count && !rz_vector_insert_range(found, rz_vector_len(found), candidates, count)) {
+			shard->failed = true;
+			return;
+		}
+		index->n_candidates[j] = count;
+	}
+}
+
+/* Computes the distances of the functions to match with all their candidates */
+static bool diff_candidates_compute(DiffIndex *index, size_t max_threads, RzAnalysisDiffStats *stats) {
+	size_t nshards;
+	RzThreadPool *pool = rz_th_pool_new_shards(max_threads, index->n_jobs, DIFF_MIN_PARALLEL, &nshards);
+	DiffShard *shards = RZ_NEWS0(DiffShard, nshards);
+	index->candidates = RZ_NEWS0(RzVector, nshards);
+	if (!shards || !index->candidates) {
+		free(shards);
+		rz_th_pool_free(pool);
+		return false;
+	}
+	index->n_shards = nshards;
+	bool ret = true;
+	for (size_t t = 0; t < nshards; t++) {
+		// interleaved, since the cost of a function grows with its size
+		DiffShard *shard = &shards[t];
+		shard->index = index;
+		shard->first = t;
+		shard->step = nshards;
+		rz_vector_init(&index->candidates[t], sizeof(DiffCandidate), NULL, NULL);
+		shard->scratch = RZ_NEWS(DiffCandidate, 2 * index->max_candidates + 1);
+		if (!shard->scratch) {
+			ret = false;
+		}
+	}
+	if (ret) {
+		rz_th_pool_run_shards(pool, shards, sizeof(DiffShard), nshards, diff_shard_compute);
+	} else {
+		rz_th_pool_free(pool);
+	}
+	for (size_t t = 0; t < nshards; t++) {
+		stats->compared += shards[t].compared;
+		ret &= !shards[t].failed;
+		free(shards[t].scratch);
+	}
+	free(shards);
+	return ret;
+}
+
+/* Pairs the functions with identical fingerprints */
+static bool diff_fcns_exact(RzAnalysis *analysis, RzAnalysisFunction **fcns1, size_t n1, RzAnalysisFunction **fcns2, size_t n2, RzAnalysisDiffStats *stats) {
+	DiffKey *hashes = RZ_NEWS(DiffKey, n2 + 1);
+	if (!hashes) {
+		return false;
+	}
+	size_t n_hashes = 0;
+	for (size_t i = 0; i < n2; i++) {
+		RzAnalysisFunction *fcn2 = fcns2[i];
+		if (diff_fcn_eligible(fcn2) && fcn2->fingerprint) {
+			hashes[n_hashes].key = diff_fingerprint_hash(fcn2->fingerprint, fcn2->fingerprint_size);
+			hashes[n_hashes++].idx = i;
+		}
+	}
+	qsort(hashes, n_hashes, sizeof(DiffKey), diff_key_cmp);
+	for (size_t i = 0; i < n1; i++) {
+		RzAnalysisFunction *fcn = fcns1[i];
+		if (!diff_fcn_eligible(fcn) || !fcn->fingerprint) {
+			continue;
+		}
+		ut64 key = diff_fingerprint_hash(fcn->fingerprint, fcn->fingerprint_size);
+		for (size_t j = diff_keys_lower_bound(hashes, n_hashes, key); j < n_hashes && hashes[j].key == key; j++) {
+			RzAnalysisFunction *fcn2 = fcns2[hashes[j].idx];
+			if (fcn2->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL && fcn2->fingerprint_size == fcn->fingerprint_size &&
+				!memcmp(fcn->fingerprint, fcn2->fingerprint, fcn->fingerprint_size)) {
+				diff_fcn_pair(analysis, fcn, fcn2, 1.0, RZ_ANALYSIS_DIFF_TYPE_MATCH);
+				stats->exact++;
+				break;
+			}
+		}
+	}
+	free(hashes);
 	return true;
 }
 
+/* Compare remaining functions, each against its candidates */
+static bool diff_fcns_candidates(RzAnalysis *analysis, RzAnalysisFunction **fcns1, size_t n1, RzAnalysisFunction **fcns2, size_t n2, RzAnalysisDiffStats *stats) {
+	if (!diff_fcns_exact(analysis, fcns1, n1, fcns2, n2, stats)) {
+		return false;
+	}
+	bool ret = false;
+	DiffIndex index = { 0 };
+	index.fcns1 = fcns1;
+	index.fcns2 = fcns2;
+	index.max_candidates = analysis->diff_candidates;
+	index.sketches2 = RZ_NEWS(DiffSketch, n2 + 1);
+	index.bands = RZ_NEWS(DiffKey, n2 * DIFF_BANDS + 1);
+	index.sizes = RZ_NEWS(DiffKey, n2 + 1);
+	index.jobs = RZ_NEWS(ut32, n1 + 1);
+	if (!index.sketches2 || !index.bands || !index.sizes || !index.jobs) {
+		goto beach;
+	}
+	for (size_t i = 0; i < n2; i++) {
+		RzAnalysisFunction *fcn2 = fcns2[i];
+		if (!diff_fcn_eligible(fcn2) || !fcn2->fingerprint) {
+			continue;
+		}
+		diff_sketch(fcn2, &index.sketches2[i]);
+		for (size_t b = 0; b < DIFF_BANDS; b++) {
+			index.bands[index.n_bands].key = diff_band_key(&index.sketches2[i], b);
+			index.bands[index.n_bands++].idx = i;
+		}
+		index.sizes[index.n_sizes].key = fcn2->fingerprint_size;
+		index.sizes[index.n_sizes++].idx = i;
+	}
+	qsort(index.bands, index.n_bands, sizeof(DiffKey), diff_key_cmp);
+	qsort(index.sizes, index.n_sizes, sizeof(DiffKey), diff_key_cmp);
+	for (size_t i = 0; i < n1; i++) {
+		if (diff_fcn_eligible(fcns1[i]) && fcns1[i]->fingerprint) {
+			index.jobs[index.n_jobs++] = i;
+		}
+	}
+	index.offsets = RZ_NEWS0(size_t, index.n_jobs + 1);
+	index.n_candidates = RZ_NEWS0(size_t, index.n_jobs + 1);
+	if (!index.offsets || !index.n_candidates ||
+		!diff_candidates_compute(&index, analysis->diff_threads, stats)) {
+		goto beach;
+	}
+
+	// the candidates are taken in the order of the functions, as they come
+	for (size_t j = 0; j < index.n_jobs; j++) {
+		RzAnalysisFunction *fcn = fcns1[index.jobs[j]], *mfcn2 = NULL;
+		const DiffCandidate *candidates = rz_vector_index_ptr(&index.candidates[j % index.n_shards], index.offsets[j]);
+		double ot = 0.0;
+		for (size_t i = 0; i < index.n_candidates[j]; i++) {
+			RzAnalysisFunction *fcn2 = fcns2[candidates[i].idx];
+			if (fcn2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
+				continue;
+			}
+			if (candidates[i].dist > ot) {
+				ot = candidates[i].dist;
+				mfcn2 = fcn2;
+				if (ot >= RZ_ANALYSIS_DIFF_THRESHOLD) {
+					break;
+				}
+			}
+		}
+		if (mfcn2) {
+			diff_fcn_pair(analysis, fcn, mfcn2, ot,
+				ot > RZ_ANALYSIS_DIFF_THRESHOLD ? RZ_ANALYSIS_DIFF_TYPE_MATCH : RZ_ANALYSIS_DIFF_TYPE_UNMATCH);
+			stats->similar++;
+		}
+	}
+	ret = true;
+
+beach:
+	free(index.sketches2);
+	free(index.bands);
+	free(index.sizes);
+	free(index.jobs);
+	for (size_t t = 0; t < index.n_shards; t++) {
+		rz_vector_fini(&index.candidates[t]);
+	}
+	free(index.candidates);
+	free(index.offsets);
+	free(index.n_candidates);
+	return ret;
+}
+
+static RzAnalysisFunction **diff_fcns_array(RzList /*<RzAnalysisFunction *>*/ *fcns, size_t *n) {
+	*n = rz_list_length(fcns);
+	RzAnalysisFunction **array = RZ_NEWS(RzAnalysisFunction *, *n + 1);
+	if (!array) {
+		return NULL;
+	}
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	size_t i = 0;
+	rz_list_foreach (fcns, iter, fcn) {
+		array[i++] = fcn;
+	}
+	return array;
+}
+
+/**
+ * \brief Pairs the functions of \p fcns1 with the ones of \p fcns2 and diffs their blocks
+ *
+ * The functions with the same name are paired first. When
+ * analysis->diff_candidates is not 0, the functions with identical
+ * fingerprints are paired next and the remaining ones are compared only
+ * against up to twice as many candidates, found through an index and
+ * compared with analysis->diff_threads threads (0 for all the cores).
+ * Otherwise each remaining function is compared against all the others.
+ *
+ * The pairs of the candidates are not always the ones of the exhaustive
+ * comparison: the exact pairing runs first, so a function can be paired
+ * with its identical copy even if the exhaustive comparison would have
+ * taken an earlier function above the threshold, and the functions it
+ * would have taken may not be among the candidates.
+ *
+ * \param stats if not NULL, filled with the counts of pairs and comparisons made
+ */
+RZ_API bool rz_analysis_diff_functions(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzList /*<RzAnalysisFunction *>*/ *fcns1,
+	RZ_NONNULL RzList /*<RzAnalysisFunction *>*/ *fcns2, RZ_NULLABLE RZ_OUT RzAnalysisDiffStats *stats) {
+	rz_return_val_if_fail(analysis && fcns1 && fcns2, false);
+	RzAnalysisDiffStats local;
+	if (!stats) {
+		stats = &local;
+	}
+	memset(stats, 0, sizeof(*stats));
+	ut64 start = rz_time_now_mono();
+	if (analysis->cur && analysis->cur->diff_fcn) {
+		bool ret = analysis->cur->diff_fcn(analysis, fcns1, fcns2);
+		stats->usecs = rz_time_now_mono() - start;
+		return ret;
+	}
+	size_t n1, n2;
+	RzAnalysisFunction **array1 = diff_fcns_array(fcns1, &n1);
+	RzAnalysisFunction **array2 = diff_fcns_array(fcns2, &n2);
+	bool ret = array1 && array2 && diff_fcns_by_name(analysis, array1, n1, array2, n2, stats);
+	if (ret) {
+		if (analysis->diff_candidates > 0) {
+			ret = diff_fcns_candidates(analysis, array1, n1, array2, n2, stats);
+		} else {
+			diff_fcns_exhaustive(analysis, array1, n1, array2, n2, stats);
+		}
+	}
+	free(array1);
+	free(array2);
+	stats->usecs = rz_time_now_mono() - start;
+	return ret;
+}
+
+RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
+	if (!analysis) {
+		return false;
+	}
+	return rz_analysis_diff_functions(analysis, fcns1, fcns2, NULL);
+}
+
 RZ_API int rz_analysis_diff_eval(RzAnalysis *analysis) {
 	if (analysis && analysis->cur && analysis->cur->diff_eval) {
 		return (analysis->cur->diff_eval(analysis));
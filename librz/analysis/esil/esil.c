@@ -121,6 +121,8 @@ RZ_API bool rz_analysis_esil_set_op(RzAnalysisEsil *esil, const char *op, RzAnal
 			free(eop);
 			return false;
 		}
+		// the word was pushed until now
+		rz_analysis_esil_bytecode_clear(esil);
 	}
 	eop->push = push;
 	eop->pop = pop;
@@ -167,6 +169,7 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	if (esil->analysis && esil == esil->analysis->esil) {
 		esil->analysis->esil = NULL;
 	}
+	rz_analysis_esil_bytecode_enable(esil, false);
 	ht_pp_free(esil->ops);
 	esil->ops = NULL;
 	rz_analysis_esil_interrupts_fini(esil);
@@ -2995,6 +2998,10 @@ static bool __stepOut(RzAnalysisEsil *esil, const char *cmd) {
 	return false;
 }
 
+RZ_IPI bool rz_analysis_esil_step_out(RzAnalysisEsil *esil, const char *cmd) {
+	return __stepOut(esil, cmd);
+}
+
 RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
 	int wordi = 0;
 	int dorunword;
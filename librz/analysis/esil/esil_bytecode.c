@@ -0,0 +1,284 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file esil_bytecode.c
+ * Compiled ESIL expressions.
+ *
+ * rz_analysis_esil_parse() splits its expression in words and looks each of
+ * them up in the table of operations every time it runs. Compiling does it
+ * once: the words are classified and the operations resolved, so that running
+ * the expression only walks an array. GOTO and REPEAT become jumps to an index.
+ * The behaviour is the one of the string path, which stays the reference.
+ *
+ * Operands are still pushed as strings and registers resolved by name by the
+ * operations, since they go through the register callbacks and hooks (traces,
+ * stats, ...) which must see them.
+ */
+
+#define ESIL_LOG(fmtstr, ...) \
+	if (esil->verbose) { \
+		RZ_LOG_WARN(fmtstr, ##__VA_ARGS__); \
+	}
+
+#define BYTECODE_CACHE_MAX 0x10000
+#define WORD_MAX_LEN       62
+
+RZ_IPI bool rz_analysis_esil_step_out(RzAnalysisEsil *esil, const char *cmd);
+
+typedef enum {
+	WORD_NOP, ///< empty word
+	WORD_PUSH, ///< anything which is not an operation
+	WORD_OP,
+	WORD_ELSE, ///< }{
+	WORD_END, ///< }
+} WordType;
+
+typedef struct {
+	WordType type;
+	RzAnalysisEsilOp *op; ///< for WORD_OP
+	const char *str; ///< into RzAnalysisEsilCode.buf
+} Word;
+
+struct rz_analysis_esil_code_t {
+	char *src; ///< the compiled expression
+	char *buf; ///< the words of src, each one NUL-terminated
+	Word *words;
+	size_t count;
+};
+
+/**
+ * \brief Compile the ESIL expression \p str for \p esil
+ *
+ * The operations are resolved from the ones of \p esil at this time, the code
+ * must not be run with another RzAnalysisEsil.
+ *
+ * \return the code, or NULL if \p str has to be run by rz_analysis_esil_parse()
+ */
+RZ_API RZ_OWN RzAnalysisEsilCode *rz_analysis_esil_compile(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL const char *str) {
+	rz_return_val_if_fail(esil && esil->ops && str, NULL);
+	// left to the string path: external commands, expressions ended by ';'
+	// and empty words, ",," also skips the word after it there
+	if (!*str || strchr(str, ';') || strstr(str, "#!") || strstr(str, ",,")) {
+		return NULL;
+	}
+	RzAnalysisEsilCode *code = RZ_NEW0(RzAnalysisEsilCode);
+	if (!code) {
+		return NULL;
+	}
+	code->count = 1;
+	for (const char *p = str; *p; p++) {
+		if (*p == ',') {
+			code->count++;
+		}
+	}
+	code->src = strdup(str);
+	code->buf = strdup(str);
+	code->words = RZ_NEWS0(Word, code->count);
+	if (!code->src || !code->buf || !code->words) {
+		goto fail;
+	}
+	char *word = code->buf;
+	for (size_t i = 0; i < code->count; i++) {
+		char *next = strchr(word, ',');
+		if (next) {
+			*next = '\0';
+		}
+		if (strlen(word) > WORD_MAX_LEN) {
+			goto fail;
+		}
+		Word *w = &code->words[i];
+		w->str = word;
+		if (!*word) {
+			w->type = WORD_NOP;
+		} else if (!strcmp(word, "}{")) {
+			w->type = WORD_ELSE;
+		} else if (!strcmp(word, "}")) {
+			w->type = WORD_END;
+		} else if ((w->op = ht_pp_find(esil->ops, word, NULL))) {
+			w->type = WORD_OP;
+		} else {
+			w->type = WORD_PUSH;
+		}
+		word = next ? next + 1 : NULL;
+	}
+	return code;
+fail:
+	rz_analysis_esil_code_free(code);
+	return NULL;
+}
+
+RZ_API void rz_analysis_esil_code_free(RZ_NULLABLE RzAnalysisEsilCode *code) {
+	if (!code) {
+		return;
+	}
+	free(code->words);
+	free(code->buf);
+	free(code->src);
+	free(code);
+}
+
+static bool run_word(RzAnalysisEsil *esil, const Word *w) {
+	if (--esil->parse_goto_count < 1) {
+		ESIL_LOG("ESIL infinite loop detected\n");
+		esil->trap = 1; // INTERNAL ERROR
+		esil->parse_stop = 1; // INTERNAL ERROR
+		return false;
+	}
+	switch (w->type) {
+	case WORD_ELSE:
+		if (esil->skip == 1) {
+			esil->skip = 0;
+		} else if (esil->skip == 0) {
+			esil->skip = 1;
+		}
+		return true;
+	case WORD_END:
+		if (esil->skip) {
+			esil->skip--;
+		}
+		return true;
+	case WORD_OP: {
+		if (esil->skip && strcmp(w->str, "?{")) {
+			return true;
+		}
+		if (esil->cb.hook_command && esil->cb.hook_command(esil, w->str)) {
+			return true;
+		}
+		rz_strbuf_set(&esil->current_opstr, w->str);
+		const bool ret = w->op->code(esil);
+		rz_strbuf_fini(&esil->current_opstr);
+		if (!ret) {
+			ESIL_LOG("%s returned 0\n", w->str);
+		}
+		return ret;
+	}
+	case WORD_PUSH:
+		if (esil->skip) {
+			return true;
+		}
+		if (!rz_analysis_esil_push(esil, w->str)) {
+			ESIL_LOG("ESIL stack is full\n");
+			esil->trap = 1;
+			esil->trap_code = 1;
+		}
+		return true;
+	default:
+		return true;
+	}
+}
+
+/**
+ * \brief Run \p code, compiled with rz_analysis_esil_compile() for \p esil
+ *
+ * Same as rz_analysis_esil_parse() with the source of \p code.
+ */
+RZ_API bool rz_analysis_esil_run(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL const RzAnalysisEsilCode *code) {
+	rz_return_val_if_fail(esil && code, false);
+	if (rz_analysis_esil_step_out(esil, esil->cmd_step)) {
+		(void)rz_analysis_esil_step_out(esil, esil->cmd_step_out);
+		return true;
+	}
+	esil->trap = 0;
+	if (esil->cmd && esil->cmd_todo && !strncmp(code->src, "TODO", 4)) {
+		esil->cmd(esil, esil->cmd_todo, esil->address, 0);
+	}
+	bool ret = true;
+restart:
+	esil->repeat = 0;
+	esil->skip = 0;
+	esil->parse_goto = -1;
+	esil->parse_stop = 0;
+	esil->parse_goto_count = esil->analysis ? esil->analysis->esil_goto_limit : RZ_ANALYSIS_ESIL_GOTO_LIMIT;
+	size_t pc = 0;
+	while (pc < code->count) {
+		const Word *w = &code->words[pc++];
+		if (w->type == WORD_NOP) {
+			continue;
+		}
+		if (!run_word(esil, w)) {
+			ret = false;
+			break;
+		}
+		if (esil->repeat) {
+			goto restart;
+		}
+		if (esil->parse_goto != -1) {
+			if (esil->parse_goto < 0 || (size_t)esil->parse_goto >= code->count) {
+				ESIL_LOG("Cannot find word %d\n", esil->parse_goto);
+				ret = false;
+				break;
+			}
+			pc = esil->parse_goto;
+			esil->parse_goto = -1;
+			continue;
+		}
+		if (esil->parse_stop) {
+			if (esil->parse_stop == 2) {
+				RZ_LOG_DEBUG("[esil at 0x%08" PFMT64x "] TODO: %s\n", esil->address,
+					pc < code->count ? code->src + (code->words[pc].str - code->buf) : "");
+			}
+			ret = false;
+			break;
+		}
+	}
+	(void)rz_analysis_esil_step_out(esil, esil->cmd_step_out);
+	return ret;
+}
+
+static void code_kv_free(HtUPKv *kv) {
+	rz_analysis_esil_code_free(kv->value);
+}
+
+/**
+ * \brief Enable or disable the cache of the expressions compiled by rz_analysis_esil_parse_at()
+ */
+RZ_API void rz_analysis_esil_bytecode_enable(RZ_NONNULL RzAnalysisEsil *esil, bool enable) {
+	rz_return_if_fail(esil);
+	if (!enable) {
+		ht_up_free(esil->bytecode);
+		esil->bytecode = NULL;
+	} else if (!esil->bytecode) {
+		esil->bytecode = ht_up_new(NULL, code_kv_free, NULL);
+	}
+}
+
+/**
+ * \brief Drop the compiled expressions, needed once the operations of \p esil change
+ */
+RZ_API void rz_analysis_esil_bytecode_clear(RZ_NONNULL RzAnalysisEsil *esil) {
+	rz_return_if_fail(esil);
+	if (esil->bytecode) {
+		rz_analysis_esil_bytecode_enable(esil, false);
+		rz_analysis_esil_bytecode_enable(esil, true);
+	}
+}
+
+/**
+ * \brief Run \p str, the ESIL of the instruction at \p addr
+ *
+ * When the cache is enabled with rz_analysis_esil_bytecode_enable(), \p str is
+ * compiled once per address and then run with rz_analysis_esil_run().
+ * Otherwise, or if it cannot be compiled, it is run by rz_analysis_esil_parse().
+ */
+RZ_API bool rz_analysis_esil_parse_at(RZ_NONNULL RzAnalysisEsil *esil, ut64 addr, RZ_NONNULL const char *str) {
+	rz_return_val_if_fail(esil && RZ_STR_ISNOTEMPTY(str), false);
+	if (!esil->bytecode) {
+		return rz_analysis_esil_parse(esil, str);
+	}
+	RzAnalysisEsilCode *code = ht_up_find(esil->bytecode, addr, NULL);
+	if (!code || strcmp(code->src, str)) {
+		code = rz_analysis_esil_compile(esil, str);
+		if (!code) {
+			ht_up_delete(esil->bytecode, addr);
+			return rz_analysis_esil_parse(esil, str);
+		}
+		if (esil->bytecode->count >= BYTECODE_CACHE_MAX) {
+			rz_analysis_esil_bytecode_clear(esil);
+		}
+		ht_up_update(esil->bytecode, addr, code);
+	}
+	return rz_analysis_esil_run(esil, code);
+}
@@ -7,9 +7,6 @@
 #define CMP_REG_CHANGE(x, y) ((x) - ((RzAnalysisEsilRegChange *)(y))->idx)
 #define CMP_MEM_CHANGE(x, y) ((x) - ((RzAnalysisEsilMemChange *)(y))->idx)
 
-static int ocbs_set = false;
-static RzAnalysisEsilCallbacks ocbs = { 0 };
-
 // IL trace wrapper of esil
 static inline bool esil_add_mem_trace(RzAnalysisEsilTrace *etrace, RzILTraceMemOp *mem) {
 	RzILTraceInstruction *instr_trace = rz_analysis_esil_get_instruction_trace(etrace, etrace->idx);
@@ -127,10 +124,10 @@ static int trace_hook_reg_read(RzAnalysisEsil *esil, const char *name, ut64 *res
 		// RZ_LOG_WARN("Register not found in profile\n");
 		return 0;
 	}
-	if (ocbs.hook_reg_read) {
+	if (esil->trace->ocbs.hook_reg_read) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_reg_read(esil, name, res, size);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_reg_read(esil, name, res, size);
 		esil->cb = cbs;
 	}
 	if (!ret && esil->cb.reg_read) {
@@ -171,10 +168,10 @@ static int trace_hook_reg_write(RzAnalysisEsil *esil, const char *name, ut64 *va
 
 	RzRegItem *ri = rz_reg_get(esil->analysis->reg, name, -1);
 	add_reg_change(esil->trace, esil->trace->idx + 1, ri, *val);
-	if (ocbs.hook_reg_write) {
+	if (esil->trace->ocbs.hook_reg_write) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_reg_write(esil, name, val);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_reg_write(esil, name, val);
 		esil->cb = cbs;
 	}
 	return ret;
@@ -207,10 +204,10 @@ static int trace_hook_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int le
 		RZ_FREE(mem_read);
 	}
 
-	if (ocbs.hook_mem_read) {
+	if (esil->trace->ocbs.hook_mem_read) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_mem_read(esil, addr, buf, len);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_mem_read(esil, addr, buf, len);
 		esil->cb = cbs;
 	}
 	return ret;
@@ -245,10 +242,10 @@ static int trace_hook_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf,
 		add_mem_change(esil->trace, esil->trace->idx + 1, addr + i, buf[i]);
 	}
 
-	if (ocbs.hook_mem_write) {
+	if (esil->trace->ocbs.hook_mem_write) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_mem_write(esil, addr, buf, len);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_mem_write(esil, addr, buf, len);
 		esil->cb = cbs;
 	}
 	return ret;
@@ -288,11 +285,11 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysi
 	}
 	/* save old callbacks */
 	int esil_verbose = esil->verbose;
-	if (ocbs_set) {
+	if (esil->trace->ocbs_set) {
 		RZ_LOG_ERROR("esil: Cannot call recursively\n");
 	}
-	ocbs = esil->cb;
-	ocbs_set = true;
+	esil->trace->ocbs = esil->cb;
+	esil->trace->ocbs_set = true;
 
 	RzILTraceInstruction *instruction = rz_analysis_il_trace_instruction_new(op->addr);
 	rz_pvector_push(esil->trace->instructions, instruction);
@@ -310,14 +307,76 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysi
 	rz_analysis_esil_parse(esil, expr);
 	rz_analysis_esil_stack_free(esil);
 	/* restore hooks */
-	esil->cb = ocbs;
-	ocbs_set = false;
+	esil->cb = esil->trace->ocbs;
+	esil->trace->ocbs_set = false;
 	esil->verbose = esil_verbose;
 	/* increment idx */
 	esil->trace->idx++;
 	esil->trace->end_idx++;
 }
 
+static int store_hook_reg_write(RzAnalysisEsil *esil, const char *name, ut64 *val) {
+	int ret = 0;
+	RzRegItem *ri = rz_reg_get(esil->analysis->reg, name, -1);
+	if (ri) {
+		rz_trace_store_add_reg(esil->trace_store, ri->offset | (ri->arena << 16), *val);
+	}
+	if (esil->trace_store_ocbs.hook_reg_write) {
+		RzAnalysisEsilCallbacks cbs = esil->cb;
+		esil->cb = esil->trace_store_ocbs;
+		ret = esil->trace_store_ocbs.hook_reg_write(esil, name, val);
+		esil->cb = cbs;
+	}
+	return ret;
+}
+
+static int store_hook_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf, int len) {
+	int ret = 0;
+	if (len > 0) {
+		rz_trace_store_add_mem(esil->trace_store, addr, buf, len);
+	}
+	if (esil->trace_store_ocbs.hook_mem_write) {
+		RzAnalysisEsilCallbacks cbs = esil->cb;
+		esil->cb = esil->trace_store_ocbs;
+		ret = esil->trace_store_ocbs.hook_mem_write(esil, addr, buf, len);
+		esil->cb = cbs;
+	}
+	return ret;
+}
+
+/**
+ * \brief Evaluates the esil of \p op, appending the registers and memory
+ * it writes to \p store
+ *
+ * The caller appends the pc of \p op to \p store before. Unlike
+ * rz_analysis_esil_trace_op(), nothing is kept to step back and the
+ * registers are recorded by their offset | (arena << 16).
+ */
+RZ_API void rz_analysis_esil_trace_op_store(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL RzAnalysisOp *op, RZ_NONNULL RzTraceStore *store) {
+	rz_return_if_fail(esil && op && store);
+	if (esil->trace_store) {
+		RZ_LOG_ERROR("esil: Cannot call recursively\n");
+		return;
+	}
+	const char *expr = rz_strbuf_get(&op->esil);
+	if (RZ_STR_ISEMPTY(expr)) {
+		return;
+	}
+	int esil_verbose = esil->verbose;
+	esil->trace_store = store;
+	esil->trace_store_ocbs = esil->cb;
+	esil->verbose = 0;
+	esil->cb.hook_reg_write = store_hook_reg_write;
+	esil->cb.hook_mem_write = store_hook_mem_write;
+
+	rz_analysis_esil_parse(esil, expr);
+	rz_analysis_esil_stack_free(esil);
+
+	esil->cb = esil->trace_store_ocbs;
+	esil->trace_store = NULL;
+	esil->verbose = esil_verbose;
+}
+
 static bool restore_memory_cb(void *user, const ut64 key, const void *value) {
 	size_t index;
 	RzAnalysisEsil *esil = user;
@@ -83,6 +83,7 @@ void rz_analysis_hint_storage_fini(RzAnalysis *a) {
 }
 
 RZ_API void rz_analysis_hint_clear(RzAnalysis *a) {
+	rz_analysis_op_cache_clear(a);
 	rz_analysis_hint_storage_fini(a);
 	rz_analysis_hint_storage_init(a);
 }
@@ -103,6 +104,7 @@ static bool addr_hint_range_delete_cb(void *user, const ut64 key, const void *va
 }
 
 RZ_API void rz_analysis_hint_del(RzAnalysis *a, ut64 addr, ut64 size) {
+	rz_analysis_op_cache_invalidate(a, addr, RZ_MAX(size, 1));
 	if (size <= 1) {
 		// only single address
 		ht_up_delete(a->addr_hints, addr);
@@ -138,6 +140,7 @@ RZ_API void rz_analysis_hint_del(RzAnalysis *a, ut64 addr, ut64 size) {
 }
 
 static void unset_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType type, ut64 addr) {
+	rz_analysis_op_cache_invalidate(analysis, addr, 1);
 	RzVector *records = ht_up_find(analysis->addr_hints, addr, NULL);
 	if (!records) {
 		return;
@@ -155,6 +158,7 @@ static void unset_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType
 
 // create or return the existing addr hint record of the given type at addr
 static RzAnalysisAddrHintRecord *ensure_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType type, ut64 addr) {
+	rz_analysis_op_cache_invalidate(analysis, addr, 1);
 	RzVector *records = ht_up_find(analysis->addr_hints, addr, NULL);
 	if (!records) {
 		records = rz_vector_new(sizeof(RzAnalysisAddrHintRecord), addr_hint_record_fini, NULL);
@@ -90,6 +90,38 @@ RZ_API void rz_analysis_il_config_add_label(RZ_NONNULL RzAnalysisILConfig *cfg,
 static void setup_vm_from_config(RzAnalysis *analysis, RzAnalysisILVM *vm, RzAnalysisILConfig *cfg);
 static void setup_vm_init_state(RzAnalysisILVM *vm, RZ_NULLABLE RzAnalysisILInitState *is, RZ_NULLABLE RzReg *reg);
 
+#define IL_CODE_BYTES     32
+#define IL_CODE_CACHE_MAX 0x10000
+
+/**
+ * IL of an instruction, kept to step it again without lifting it
+ */
+typedef struct {
+	int bits;
+	ut32 size; ///< of the instruction, at most IL_CODE_BYTES are compared on lookup
+	ut8 bytes[IL_CODE_BYTES];
+	RzILOpEffect *op;
+	RzILCode *code; ///< op compiled, NULL if it is walked by rz_il_vm_step()
+	bool running; ///< being stepped, so dropping it from the cache must not free it
+	bool dropped; ///< dropped from the cache while running, freed once the step is done
+} ILCode;
+
+static void il_code_free(ILCode *ilc) {
+	rz_il_code_free(ilc->code);
+	rz_il_op_effect_free(ilc->op);
+	free(ilc);
+}
+
+static void il_code_kv_free(HtUPKv *kv) {
+	ILCode *ilc = kv->value;
+	// the step may write to memory, which invalidates the cache under it
+	if (ilc->running) {
+		ilc->dropped = true;
+		return;
+	}
+	il_code_free(ilc);
+}
+
 /**
  * Create and initialize an RzAnalysisILVM with the current arch/cpu/bits configuration and plugin
  * \p init_state_reg optional RzReg to take variable values from, unless the plugin overrides them using RzAnalysisILInitState
@@ -114,6 +146,7 @@ RZ_API RZ_OWN RzAnalysisILVM *rz_analysis_il_vm_new(RzAnalysis *a, RZ_NULLABLE R
 		goto ruby_pool;
 	}
 	setup_vm_init_state(r, config->init_state, init_state_reg);
+	rz_analysis_il_vm_code_cache_enable(r, a->opt.il_compile);
 ruby_pool:
 	rz_analysis_il_config_free(config);
 	return r;
@@ -126,6 +159,7 @@ RZ_API void rz_analysis_il_vm_free(RZ_NULLABLE RzAnalysisILVM *vm) {
 	if (!vm) {
 		return;
 	}
+	ht_up_free(vm->code_cache);
 	rz_il_vm_free(vm->vm);
 	rz_il_reg_binding_free(vm->reg_binding);
 	rz_buf_free(vm->io_buf);
@@ -228,6 +262,75 @@ RZ_API bool rz_analysis_il_vm_sync_to_reg(RzAnalysisILVM *vm, RZ_NONNULL RzReg *
 	return rz_il_vm_sync_to_reg(vm->vm, vm->reg_binding, reg);
 }
 
+/**
+ * \brief Enable or disable the cache of the IL of the instructions stepped by rz_analysis_il_vm_step()
+ *
+ * With the cache, an instruction is lifted and compiled by rz_il_vm_compile()
+ * once, then run with rz_il_vm_step_code() as long as its bytes do not change.
+ * The IL which cannot be compiled is still cached and walked by rz_il_vm_step().
+ */
+RZ_API void rz_analysis_il_vm_code_cache_enable(RZ_NONNULL RzAnalysisILVM *vm, bool enable) {
+	rz_return_if_fail(vm);
+	if (!enable) {
+		ht_up_free(vm->code_cache);
+		vm->code_cache = NULL;
+	} else if (!vm->code_cache) {
+		vm->code_cache = ht_up_new(NULL, il_code_kv_free, NULL);
+	}
+}
+
+/**
+ * \brief Drop the IL cached for the instructions starting in [\p addr, \p addr + \p size)
+ */
+RZ_API void rz_analysis_il_vm_code_cache_invalidate(RZ_NONNULL RzAnalysisILVM *vm, ut64 addr, ut64 size) {
+	rz_return_if_fail(vm);
+	if (!vm->code_cache) {
+		return;
+	}
+	if (size > vm->code_cache->count) {
+		rz_analysis_il_vm_code_cache_enable(vm, false);
+		rz_analysis_il_vm_code_cache_enable(vm, true);
+		return;
+	}
+	ut64 to = addr + size < addr ? UT64_MAX : addr + size;
+	for (ut64 at = addr; at < to; at++) {
+		ht_up_delete(vm->code_cache, at);
+	}
+}
+
+static ILCode *il_code_get(RzAnalysis *analysis, RzAnalysisILVM *vm, ut64 addr, const ut8 *bytes) {
+	ILCode *ilc = ht_up_find(vm->code_cache, addr, NULL);
+	if (!ilc || ilc->bits != analysis->bits || memcmp(ilc->bytes, bytes, RZ_MIN(ilc->size, IL_CODE_BYTES))) {
+		return NULL;
+	}
+	return ilc;
+}
+
+static ILCode *il_code_put(RzAnalysis *analysis, RzAnalysisILVM *vm, ut64 addr, const ut8 *bytes, RzAnalysisOp *op) {
+	ILCode *ilc = RZ_NEW0(ILCode);
+	if (!ilc) {
+		return NULL;
+	}
+	ilc->bits = analysis->bits;
+	ilc->size = op->size > 0 ? op->size : 1;
+	memcpy(ilc->bytes, bytes, RZ_MIN(ilc->size, IL_CODE_BYTES));
+	// the op is owned by the cache from now on
+	ilc->op = op->il_op;
+	op->il_op = NULL;
+	ilc->code = rz_il_vm_compile(vm->vm, ilc->op);
+	if (vm->code_cache->count >= IL_CODE_CACHE_MAX) {
+		rz_analysis_il_vm_code_cache_enable(vm, false);
+		rz_analysis_il_vm_code_cache_enable(vm, true);
+	}
+	if (!ht_up_update(vm->code_cache, addr, ilc)) {
+		op->il_op = ilc->op;
+		rz_il_code_free(ilc->code);
+		free(ilc);
+		return NULL;
+	}
+	return ilc;
+}
+
 /**
  * Perform a single step in the VM
  *
@@ -249,15 +352,38 @@ RZ_API RzAnalysisILStepResult rz_analysis_il_vm_step(RZ_NONNULL RzAnalysis *anal
 	}
 	ut64 addr = rz_bv_to_ut64(vm->vm->pc);
 
-	ut8 code[32] = { 0 };
+	ut8 code[IL_CODE_BYTES] = { 0 };
 	analysis->read_at(analysis, addr, code, sizeof(code));
+	ILCode *ilc = vm->code_cache ? il_code_get(analysis, vm, addr, code) : NULL;
 	RzAnalysisOp op = { 0 };
-	int r = rz_analysis_op(analysis, &op, addr, code, sizeof(code), RZ_ANALYSIS_OP_MASK_IL | RZ_ANALYSIS_OP_MASK_HINT);
-	RzILOpEffect *ilop = r < 0 ? NULL : op.il_op;
+	RzILOpEffect *ilop = NULL;
+	ut64 next = addr + 1;
+	if (ilc) {
+		ilop = ilc->op;
+		next = addr + ilc->size;
+	} else {
+		int r = rz_analysis_op(analysis, &op, addr, code, sizeof(code), RZ_ANALYSIS_OP_MASK_IL | RZ_ANALYSIS_OP_MASK_HINT);
+		ilop = r < 0 ? NULL : op.il_op;
+		next = addr + (op.size > 0 ? op.size : 1);
+		if (ilop && vm->code_cache) {
+			ilc = il_code_put(analysis, vm, addr, code, &op);
+		}
+	}
 
 	RzAnalysisILStepResult res;
 	if (ilop) {
-		bool succ = rz_il_vm_step(vm->vm, ilop, addr + (op.size > 0 ? op.size : 1));
+		if (ilc) {
+			ilc->running = true;
+		}
+		bool succ = ilc && ilc->code
+			? rz_il_vm_step_code(vm->vm, ilc->code, next)
+			: rz_il_vm_step(vm->vm, ilop, next);
+		if (ilc) {
+			ilc->running = false;
+			if (ilc->dropped) {
+				il_code_free(ilc);
+			}
+		}
 		res = succ ? RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS : RZ_ANALYSIS_IL_STEP_IL_RUNTIME_ERROR;
 		if (reg) {
 			rz_analysis_il_vm_sync_to_reg(vm, reg);
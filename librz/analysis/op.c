@@ -6,6 +6,9 @@
 #include <rz_util.h>
 #include <rz_list.h>
 
+RZ_IPI int rz_analysis_op_cache_get(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+RZ_IPI void rz_analysis_op_cache_put(RzAnalysis *analysis, RzAnalysisOp *op, int ret, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+
 RZ_API RzAnalysisOp *rz_analysis_op_new(void) {
 	RzAnalysisOp *op = RZ_NEW(RzAnalysisOp);
 	rz_analysis_op_init(op);
@@ -98,6 +101,7 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 	rz_return_val_if_fail(analysis && op && len > 0, -1);
 
 	int ret = RZ_MIN(2, len);
+	bool decoded = false;
 	if (len > 0 && analysis->cur && analysis->cur->op) {
 		// use core binding to set asm.bits correctly based on the addr
 		// this is because of the hassle of arm/thumb
@@ -111,6 +115,11 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 			op->size = 1;
 			return -1;
 		}
+		ret = rz_analysis_op_cache_get(analysis, op, addr, data, len, mask);
+		if (ret > 0) {
+			return ret;
+		}
+		decoded = true;
 		ret = analysis->cur->op(analysis, op, addr, data, len, mask);
 		if (ret < 1) {
 			op->type = RZ_ANALYSIS_OP_TYPE_ILL;
@@ -138,6 +147,9 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 			rz_analysis_hint_free(hint);
 		}
 	}
+	if (decoded) {
+		rz_analysis_op_cache_put(analysis, op, ret, addr, data, len, mask);
+	}
 	return ret;
 }
 
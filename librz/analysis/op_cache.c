@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file op_cache.c
+ * Cache of the ops decoded by rz_analysis_op().
+ *
+ * The same instructions are decoded again and again by the disassembler, the
+ * function analysis, aar, ESIL, ... The cache keeps the last ops decoded in
+ * sets of OP_CACHE_WAYS slots indexed by address, so that decoding one of
+ * them again with the same mask is only a copy. An entry is only valid for
+ * the plugin, bits and endianness it was decoded with, and for the same
+ * bytes, which are compared on lookup.
+ *
+ * Only the plugins with op_stateless set are cached, the others depend on
+ * the instructions decoded before. Ops with IL or a switch are not cached.
+ */
+
+#define OP_CACHE_BYTES 16
+#define OP_CACHE_WAYS  4
+
+typedef struct {
+	ut64 addr; ///< UT64_MAX when the slot is empty
+	RzAnalysisPlugin *plugin;
+	int bits;
+	int big_endian;
+	RzAnalysisOpMask mask;
+	int ret; ///< returned by rz_analysis_op()
+	ut8 len; ///< bytes compared on lookup
+	ut8 bytes[OP_CACHE_BYTES];
+	RzAnalysisOp op;
+} OpCacheEntry;
+
+struct rz_analysis_op_cache_t {
+	OpCacheEntry *entries; ///< sets of OP_CACHE_WAYS entries
+	size_t sets_mask; ///< number of sets - 1
+	ut32 victim; ///< next way replaced in a full set
+};
+
+static void op_copy(RzAnalysisOp *dst, const RzAnalysisOp *src) {
+	*dst = *src;
+	dst->mnemonic = src->mnemonic ? strdup(src->mnemonic) : NULL;
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(src->src); i++) {
+		dst->src[i] = src->src[i] ? rz_analysis_value_copy(src->src[i]) : NULL;
+	}
+	dst->dst = src->dst ? rz_analysis_value_copy(src->dst) : NULL;
+	if (src->access) {
+		dst->access = rz_list_newf((RzListFree)rz_analysis_value_free);
+		RzListIter *it;
+		RzAnalysisValue *val;
+		rz_list_foreach (src->access, it, val) {
+			rz_list_append(dst->access, rz_analysis_value_copy(val));
+		}
+	}
+	rz_strbuf_init(&dst->esil);
+	rz_strbuf_copy(&dst->esil, (RzStrBuf *)&src->esil);
+	rz_strbuf_init(&dst->opex);
+	rz_strbuf_copy(&dst->opex, (RzStrBuf *)&src->opex);
+	dst->il_op = NULL;
+	dst->switch_op = NULL;
+}
+
+static void entry_fini(OpCacheEntry *e) {
+	if (e->addr != UT64_MAX) {
+		rz_analysis_op_fini(&e->op);
+		e->addr = UT64_MAX;
+	}
+}
+
+static inline OpCacheEntry *set_at(RzAnalysisOpCache *cache, ut64 addr) {
+	return &cache->entries[(addr & cache->sets_mask) * OP_CACHE_WAYS];
+}
+
+static inline ut8 key_len(int len) {
+	return len < OP_CACHE_BYTES ? len : OP_CACHE_BYTES;
+}
+
+static inline bool is_cacheable(RzAnalysis *analysis, RzAnalysisOpMask mask) {
+	return analysis->op_cache && analysis->cur->op_stateless && !(mask & RZ_ANALYSIS_OP_MASK_IL);
+}
+
+/**
+ * \brief Fills \p op from the cache when it holds the op at \p addr for the same bytes
+ * \return the value rz_analysis_op() returned for it, or 0 on a miss
+ */
+RZ_IPI int rz_analysis_op_cache_get(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
+	if (!is_cacheable(analysis, mask)) {
+		return 0;
+	}
+	OpCacheEntry *set = set_at(analysis->op_cache, addr);
+	for (size_t i = 0; i < OP_CACHE_WAYS; i++) {
+		OpCacheEntry *e = &set[i];
+		if (e->addr == addr && e->mask == mask && e->plugin == analysis->cur &&
+			e->bits == analysis->bits && e->big_endian == analysis->big_endian &&
+			e->len == key_len(len) && !memcmp(e->bytes, data, e->len)) {
+			op_copy(op, &e->op);
+			return e->ret;
+		}
+	}
+	return 0;
+}
+
+/**
+ * \brief Stores \p op, the result of rz_analysis_op() with these arguments
+ */
+RZ_IPI void rz_analysis_op_cache_put(RzAnalysis *analysis, RzAnalysisOp *op, int ret, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
+	if (!is_cacheable(analysis, mask) || ret < 1 || ret > key_len(len) || op->il_op || op->switch_op) {
+		return;
+	}
+	RzAnalysisOpCache *cache = analysis->op_cache;
+	OpCacheEntry *set = set_at(cache, addr);
+	OpCacheEntry *e = NULL;
+	for (size_t i = 0; i < OP_CACHE_WAYS; i++) {
+		if (set[i].addr == UT64_MAX || (set[i].addr == addr && set[i].mask == mask)) {
+			e = &set[i];
+			break;
+		}
+	}
+	if (!e) {
+		e = &set[cache->victim++ % OP_CACHE_WAYS];
+	}
+	entry_fini(e);
+	e->addr = addr;
+	e->plugin = analysis->cur;
+	e->bits = analysis->bits;
+	e->big_endian = analysis->big_endian;
+	e->mask = mask;
+	e->ret = ret;
+	e->len = key_len(len);
+	memcpy(e->bytes, data, e->len);
+	op_copy(&e->op, op);
+}
+
+/**
+ * \brief Set the number of ops cached by rz_analysis_op(), 0 disables the cache
+ *
+ * The size is rounded up to a power of two, of at least OP_CACHE_WAYS ops.
+ * The cache is not thread-safe, the decoders created with
+ * rz_analysis_new_decoder() do not use it.
+ */
+RZ_API bool rz_analysis_op_cache_set_size(RZ_NONNULL RzAnalysis *analysis, size_t size) {
+	rz_return_val_if_fail(analysis, false);
+	RzAnalysisOpCache *cache = analysis->op_cache;
+	if (cache) {
+		rz_analysis_op_cache_clear(analysis);
+		free(cache->entries);
+		free(cache);
+		analysis->op_cache = NULL;
+	}
+	if (!size) {
+		return true;
+	}
+	size_t sets = 1;
+	while (sets * OP_CACHE_WAYS < size && sets < SIZE_MAX / (2 * OP_CACHE_WAYS)) {
+		sets <<= 1;
+	}
+	size_t n = sets * OP_CACHE_WAYS;
+	cache = RZ_NEW0(RzAnalysisOpCache);
+	if (!cache) {
+		return false;
+	}
+	cache->entries = RZ_NEWS(OpCacheEntry, n);
+	if (!cache->entries) {
+		free(cache);
+		return false;
+	}
+	for (size_t i = 0; i < n; i++) {
+		cache->entries[i].addr = UT64_MAX;
+	}
+	cache->sets_mask = sets - 1;
+	analysis->op_cache = cache;
+	return true;
+}
+
+/**
+ * \brief Drop the cached ops starting in [\p addr, \p addr + \p size)
+ *
+ * To be called when the hints of this range change. The bytes being compared
+ * on lookup, calling it when they change only releases the stale ops sooner.
+ * The IL cached by the user-faced vm for this range is dropped too.
+ */
+RZ_API void rz_analysis_op_cache_invalidate(RZ_NONNULL RzAnalysis *analysis, ut64 addr, ut64 size) {
+	rz_return_if_fail(analysis);
+	if (analysis->il_vm) {
+		rz_analysis_il_vm_code_cache_invalidate(analysis->il_vm, addr, size);
+	}
+	RzAnalysisOpCache *cache = analysis->op_cache;
+	if (!cache || !size) {
+		return;
+	}
+	if (size > cache->sets_mask) {
+		rz_analysis_op_cache_clear(analysis);
+		return;
+	}
+	ut64 to = addr + size < addr ? UT64_MAX : addr + size;
+	for (ut64 at = addr; at < to; at++) {
+		OpCacheEntry *set = set_at(cache, at);
+		for (size_t i = 0; i < OP_CACHE_WAYS; i++) {
+			if (set[i].addr == at) {
+				entry_fini(&set[i]);
+			}
+		}
+	}
+}
+
+/**
+ * \brief Drop all the cached ops, and the IL cached by the user-faced vm
+ */
+RZ_API void rz_analysis_op_cache_clear(RZ_NONNULL RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	if (analysis->il_vm && analysis->il_vm->code_cache) {
+		rz_analysis_il_vm_code_cache_enable(analysis->il_vm, false);
+		rz_analysis_il_vm_code_cache_enable(analysis->il_vm, true);
+	}
+	RzAnalysisOpCache *cache = analysis->op_cache;
+	if (!cache) {
+		return;
+	}
+	for (size_t i = 0; i < (cache->sets_mask + 1) * OP_CACHE_WAYS; i++) {
+		entry_fini(&cache->entries[i]);
+	}
+}
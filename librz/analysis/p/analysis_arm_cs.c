@@ -16,10 +16,14 @@
 
 typedef struct arm_cs_context_t {
 	RzArmITContext it;
+} ArmCSContext;
+
+typedef struct arm_cs_decoder_t {
 	csh handle;
 	int omode;
 	int obits;
-} ArmCSContext;
+	cs_insn *insn; ///< allocated with handle, filled by cs_disasm_iter()
+} ArmCSDecoder;
 
 static const char *shift_type_name(arm_shifter type) {
 	switch (type) {
@@ -573,8 +577,7 @@ static int cond_cs2r2(int cc) {
 	return cc;
 }
 
-static void anop64(ArmCSContext *ctx, RzAnalysisOp *op, cs_insn *insn) {
-	csh handle = ctx->handle;
+static void anop64(csh handle, RzAnalysisOp *op, cs_insn *insn) {
 	ut64 addr = op->addr;
 
 	/* grab family */
@@ -1737,18 +1740,23 @@ static void patch_capstone_bugs(cs_insn *insn, int bits, bool big_endian) {
 }
 
 static int analysis_op(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	ArmCSContext *ctx = (ArmCSContext *)a->plugin_data;
+	ArmCSDecoder *ctx = rz_analysis_decoder(a);
+	if (!ctx) {
+		return -1;
+	}
 
-	cs_insn *insn = NULL;
 	int mode = (a->bits == 16) ? CS_MODE_THUMB : CS_MODE_ARM;
-	int n, ret;
 	mode |= (a->big_endian) ? CS_MODE_BIG_ENDIAN : CS_MODE_LITTLE_ENDIAN;
 	if (a->cpu && strstr(a->cpu, "cortex")) {
 		mode |= CS_MODE_MCLASS;
 	}
 
 	if (mode != ctx->omode || a->bits != ctx->obits) {
-		cs_close(&ctx->handle);
+		if (ctx->handle) {
+			cs_free(ctx->insn, 1);
+			ctx->insn = NULL;
+			cs_close(&ctx->handle);
+		}
 		ctx->handle = 0; // unnecessary
 		ctx->omode = mode;
 		ctx->obits = a->bits;
@@ -1756,20 +1764,29 @@ static int analysis_op(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *bu
 	op->size = (a->bits == 16) ? 2 : 4;
 	op->addr = addr;
 	if (ctx->handle == 0) {
-		ret = (a->bits == 64) ? cs_open(CS_ARCH_ARM64, mode, &ctx->handle) : cs_open(CS_ARCH_ARM, mode, &ctx->handle);
-		cs_option(ctx->handle, CS_OPT_DETAIL, CS_OPT_ON);
+		int ret = (a->bits == 64) ? cs_open(CS_ARCH_ARM64, mode, &ctx->handle) : cs_open(CS_ARCH_ARM, mode, &ctx->handle);
 		if (ret != CS_ERR_OK) {
 			ctx->handle = 0;
 			return -1;
 		}
+		cs_option(ctx->handle, CS_OPT_DETAIL, CS_OPT_ON);
+		ctx->insn = cs_malloc(ctx->handle);
+		if (!ctx->insn) {
+			cs_close(&ctx->handle);
+			ctx->handle = 0;
+			return -1;
+		}
 	}
 	int haa = hackyArmAnal(a, op, buf, len); // TODO: disable this for capstone 5 after testing that everything works
 	if (haa > 0) {
 		return haa;
 	}
 
-	n = cs_disasm(ctx->handle, (ut8 *)buf, len, addr, 1, &insn);
-	if (n < 1) {
+	cs_insn *insn = ctx->insn;
+	const ut8 *code = buf;
+	size_t size = len;
+	ut64 pc = addr;
+	if (!cs_disasm_iter(ctx->handle, &code, &size, &pc, insn)) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
 			op->mnemonic = strdup("invalid");
@@ -1787,7 +1804,7 @@ static int analysis_op(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *bu
 		op->size = insn->size;
 		op->id = insn->id;
 		if (a->bits == 64) {
-			anop64(ctx, op, insn);
+			anop64(ctx->handle, op, insn);
 			if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
 				opex64(&op->opex, ctx->handle, insn);
 			}
@@ -1813,9 +1830,7 @@ static int analysis_op(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *bu
 		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 			op_fillval(a, op, ctx->handle, insn, a->bits);
 		}
-		cs_free(insn, n);
 	}
-	//		cs_close (&handle);
 	return op->size;
 }
 
@@ -2387,9 +2402,6 @@ static bool init(void **user) {
 		return false;
 	}
 	rz_arm_it_context_init(&ctx->it);
-	ctx->handle = 0;
-	ctx->omode = -1;
-	ctx->obits = 32;
 	*user = ctx;
 	return true;
 }
@@ -2397,12 +2409,30 @@ static bool init(void **user) {
 static bool fini(void *user) {
 	rz_return_val_if_fail(user, false);
 	ArmCSContext *ctx = (ArmCSContext *)user;
-	cs_close(&ctx->handle);
 	rz_arm_it_context_fini(&ctx->it);
 	free(ctx);
 	return true;
 }
 
+static void *decoder_new(RzAnalysis *analysis) {
+	ArmCSDecoder *ctx = RZ_NEW0(ArmCSDecoder);
+	if (!ctx) {
+		return NULL;
+	}
+	ctx->omode = -1;
+	ctx->obits = 32;
+	return ctx;
+}
+
+static void decoder_free(void *decoder) {
+	ArmCSDecoder *ctx = (ArmCSDecoder *)decoder;
+	if (ctx->handle) {
+		cs_free(ctx->insn, 1);
+		cs_close(&ctx->handle);
+	}
+	free(ctx);
+}
+
 static RzAnalysisILConfig *il_config(RzAnalysis *analysis) {
 	if (analysis->bits == 64) {
 		return rz_arm_cs_64_il_config(analysis->big_endian);
@@ -2426,6 +2456,8 @@ RzAnalysisPlugin rz_analysis_plugin_arm_cs = {
 	.il_config = il_config,
 	.init = &init,
 	.fini = &fini,
+	.decoder_new = &decoder_new,
+	.decoder_free = &decoder_free,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -7,6 +7,13 @@
 #include <capstone/mips.h>
 
 static ut64 t9_pre = UT64_MAX;
+
+typedef struct mips_cs_decoder_t {
+	csh handle;
+	int omode;
+	int obits;
+	cs_insn *insn; ///< allocated with handle, filled by cs_disasm_iter()
+} MipsCSDecoder;
 // http://www.mrc.uidaho.edu/mrc/people/jff/digital/MIPSir.html
 
 #define OPERAND(x)  insn->detail->mips.operands[x]
@@ -716,10 +723,12 @@ static void set_opdir(RzAnalysisOp *op) {
 }
 
 static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	int n, ret, opsize = -1;
-	static csh hndl = 0;
-	static int omode = -1;
-	static int obits = 32;
+	int opsize = -1;
+	MipsCSDecoder *ctx = rz_analysis_decoder(analysis);
+	if (!ctx) {
+		return -1;
+	}
+	csh hndl;
 	cs_insn *insn;
 	int mode = analysis->big_endian ? CS_MODE_BIG_ENDIAN : CS_MODE_LITTLE_ENDIAN;
 
@@ -737,11 +746,15 @@ static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *
 		}
 	}
 	mode |= (analysis->bits == 64) ? CS_MODE_MIPS64 : CS_MODE_MIPS32;
-	if (mode != omode || analysis->bits != obits) {
-		cs_close(&hndl);
-		hndl = 0;
-		omode = mode;
-		obits = analysis->bits;
+	if (mode != ctx->omode || analysis->bits != ctx->obits) {
+		if (ctx->handle) {
+			cs_free(ctx->insn, 1);
+			ctx->insn = NULL;
+			cs_close(&ctx->handle);
+		}
+		ctx->handle = 0;
+		ctx->omode = mode;
+		ctx->obits = analysis->bits;
 	}
 	// XXX no arch->cpu ?!?! CS_MODE_MICRO, N64
 	op->addr = addr;
@@ -749,15 +762,28 @@ static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *
 		return -1;
 	}
 	op->size = 4;
-	if (hndl == 0) {
-		ret = cs_open(CS_ARCH_MIPS, mode, &hndl);
-		if (ret != CS_ERR_OK) {
+	if (ctx->handle == 0) {
+		if (cs_open(CS_ARCH_MIPS, mode, &ctx->handle) != CS_ERR_OK) {
+			ctx->handle = 0;
 			goto fin;
 		}
-		cs_option(hndl, CS_OPT_DETAIL, CS_OPT_ON);
+		cs_option(ctx->handle, CS_OPT_DETAIL, CS_OPT_ON);
+		ctx->insn = cs_malloc(ctx->handle);
+		if (!ctx->insn) {
+			cs_close(&ctx->handle);
+			ctx->handle = 0;
+			goto fin;
+		}
+	}
+	hndl = ctx->handle;
+	insn = ctx->insn;
+	const ut8 *code = buf;
+	size_t size = len;
+	ut64 pc = addr;
+	if (!cs_disasm_iter(hndl, &code, &size, &pc, insn)) {
+		insn = NULL;
 	}
-	n = cs_disasm(hndl, (ut8 *)buf, len, addr, 1, &insn);
-	if (n < 1 || insn->size < 1) {
+	if (!insn || insn->size < 1) {
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
 			op->mnemonic = strdup("invalid");
 		}
@@ -1086,8 +1112,6 @@ beach:
 	if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 		op_fillval(analysis, op, &hndl, insn);
 	}
-	cs_free(insn, n);
-	// cs_close (&handle);
 fin:
 	return opsize;
 }
@@ -1209,6 +1233,25 @@ static RzList *analysis_preludes(RzAnalysis *analysis) {
 	return l;
 }
 
+static void *decoder_new(RzAnalysis *analysis) {
+	MipsCSDecoder *ctx = RZ_NEW0(MipsCSDecoder);
+	if (!ctx) {
+		return NULL;
+	}
+	ctx->omode = -1;
+	ctx->obits = 32;
+	return ctx;
+}
+
+static void decoder_free(void *decoder) {
+	MipsCSDecoder *ctx = (MipsCSDecoder *)decoder;
+	if (ctx->handle) {
+		cs_free(ctx->insn, 1);
+		cs_close(&ctx->handle);
+	}
+	free(ctx);
+}
+
 RzAnalysisPlugin rz_analysis_plugin_mips_cs = {
 	.name = "mips",
 	.desc = "Capstone MIPS analyzer",
@@ -1220,6 +1263,8 @@ RzAnalysisPlugin rz_analysis_plugin_mips_cs = {
 	.preludes = analysis_preludes,
 	.bits = 16 | 32 | 64,
 	.op = &analop,
+	.decoder_new = &decoder_new,
+	.decoder_free = &decoder_free,
 };
 
 #ifndef RZ_PLUGIN_INCORE
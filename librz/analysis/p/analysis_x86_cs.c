@@ -55,13 +55,14 @@ call = 4
 typedef struct x86_cs_context_t {
 	csh handle;
 	int omode;
-	cs_insn *insn;
+	cs_insn *insn; ///< allocated with handle, filled by cs_disasm_iter()
 } X86CSContext;
 
 struct Getarg {
 	csh handle;
 	cs_insn *insn;
 	int bits;
+	char buf[AR_DIM][BUF_SZ]; ///< output of getarg(), one per selector
 };
 
 static void hidden_op(cs_insn *insn, cs_x86 *x, int mode) {
@@ -230,12 +231,11 @@ static bool is_xmm_reg(cs_x86_op op) {
  * @param  n       Operand index
  * @param  set     if 1 it adds set (=) to the operand
  * @param  setoper Extra operation for the set (^, -, +, etc...)
- * @param  sel     Selector for output buffer in staic array
- * @return         Pointer to esil operand in static array
+ * @param  sel     Selector for output buffer in gop
+ * @return         Pointer to esil operand in gop
  */
 static char *getarg(struct Getarg *gop, int n, int set, char *setop, int sel, ut32 *bitsize) {
-	static char buf[AR_DIM][BUF_SZ];
-	char *out = buf[sel];
+	char *out = gop->buf[sel];
 	char *setarg = setop ? setop : "";
 	cs_insn *insn = gop->insn;
 	csh handle = gop->handle;
@@ -3148,30 +3148,38 @@ static inline int select_mode(RzAnalysis *a) {
 }
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	X86CSContext *ctx = (X86CSContext *)a->plugin_data;
+	X86CSContext *ctx = rz_analysis_decoder(a);
+	if (!ctx) {
+		return 0;
+	}
 
 	int mode = select_mode(a);
-	int n, ret;
 
 	if (ctx->handle && mode != ctx->omode) {
-		if (ctx->handle != 0) {
-			cs_close(&ctx->handle);
-			ctx->handle = 0;
-		}
+		cs_free(ctx->insn, 1);
+		ctx->insn = NULL;
+		cs_close(&ctx->handle);
+		ctx->handle = 0;
 	}
 	ctx->omode = mode;
 	if (ctx->handle == 0) {
-		ret = cs_open(CS_ARCH_X86, mode, &ctx->handle);
-		if (ret != CS_ERR_OK) {
+		if (cs_open(CS_ARCH_X86, mode, &ctx->handle) != CS_ERR_OK) {
+			ctx->handle = 0;
+			return 0;
+		}
+		cs_option(ctx->handle, CS_OPT_DETAIL, CS_OPT_ON);
+		ctx->insn = cs_malloc(ctx->handle);
+		if (!ctx->insn) {
+			cs_close(&ctx->handle);
 			ctx->handle = 0;
 			return 0;
 		}
 	}
 	op->cycles = 1; // aprox
-	cs_option(ctx->handle, CS_OPT_DETAIL, CS_OPT_ON);
-	// capstone-next
-	n = cs_disasm(ctx->handle, (const ut8 *)buf, len, addr, 1, &ctx->insn);
-	if (n < 1) {
+	const ut8 *code = buf;
+	size_t size = len;
+	ut64 pc = addr;
+	if (!cs_disasm_iter(ctx->handle, &code, &size, &pc, ctx->insn)) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
 			op->mnemonic = strdup("invalid");
@@ -3213,17 +3221,13 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 			op_fillval(a, op, &ctx->handle, ctx->insn, mode);
 		}
-	}
-	//#if X86_GRP_PRIVILEGE>0
-	if (ctx->insn) {
+		//#if X86_GRP_PRIVILEGE>0
 #if HAVE_CSGRP_PRIVILEGE
 		if (cs_insn_group(ctx->handle, ctx->insn, X86_GRP_PRIVILEGE)) {
 			op->family = RZ_ANALYSIS_OP_FAMILY_PRIV;
 		}
 #endif
-		cs_free(ctx->insn, n);
 	}
-	// cs_close (&ctx->handle);
 	return op->size;
 }
 
@@ -3238,21 +3242,22 @@ static int esil_x86_cs_init(RzAnalysisEsil *esil) {
 	return true;
 }
 
-static bool x86_init(void **user) {
+static void *x86_decoder_new(RzAnalysis *analysis) {
 	X86CSContext *ctx = RZ_NEW0(X86CSContext);
 	if (!ctx) {
-		return false;
+		return NULL;
 	}
-	*user = ctx;
-	return true;
+	ctx->omode = -1;
+	return ctx;
 }
 
-static bool x86_fini(void *user) {
-	rz_return_val_if_fail(user, false);
-	X86CSContext *ctx = (X86CSContext *)user;
-	cs_close(&ctx->handle);
+static void x86_decoder_free(void *decoder) {
+	X86CSContext *ctx = (X86CSContext *)decoder;
+	if (ctx->handle) {
+		cs_free(ctx->insn, 1);
+		cs_close(&ctx->handle);
+	}
 	free(ctx);
-	return true;
 }
 
 static int esil_x86_cs_fini(RzAnalysisEsil *esil) {
@@ -3727,6 +3732,7 @@ RzAnalysisPlugin rz_analysis_plugin_x86_cs = {
 	.name = "x86",
 	.desc = "Capstone X86 analysis",
 	.esil = true,
+	.op_stateless = true,
 	.license = "BSD",
 	.arch = "x86",
 	.bits = 16 | 32 | 64,
@@ -3734,8 +3740,8 @@ RzAnalysisPlugin rz_analysis_plugin_x86_cs = {
 	.preludes = analysis_preludes,
 	.archinfo = archinfo,
 	.get_reg_profile = &get_reg_profile,
-	.init = x86_init,
-	.fini = x86_fini,
+	.decoder_new = x86_decoder_new,
+	.decoder_free = x86_decoder_free,
 	.esil_init = esil_x86_cs_init,
 	.esil_fini = esil_x86_cs_fini,
 	//	.esil_intr = esil_x86_cs_intr,
@@ -2215,7 +2215,20 @@ RZ_API bool rz_serialize_analysis_cc_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnaly
 }
 
 RZ_API void rz_serialize_analysis_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
-	rz_serialize_analysis_xrefs_save(sdb_ns(db, "xrefs", true), analysis);
+	rz_serialize_analysis_save_opt(db, analysis, true);
+}
+
+/**
+ * \brief Saves \p analysis into \p db, like rz_serialize_analysis_save()
+ *
+ * \param xrefs if false, the xrefs namespace is created but left empty, for
+ * callers storing the xrefs by themselves
+ */
+RZ_API void rz_serialize_analysis_save_opt(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, bool xrefs) {
+	Sdb *xrefs_db = sdb_ns(db, "xrefs", true);
+	if (xrefs) {
+		rz_serialize_analysis_xrefs_save(xrefs_db, analysis);
+	}
 	rz_serialize_analysis_blocks_save(sdb_ns(db, "blocks", true), analysis);
 	rz_serialize_analysis_functions_save(sdb_ns(db, "functions", true), analysis);
 	rz_serialize_analysis_function_noreturn_save(sdb_ns(db, "noreturn", true), analysis);
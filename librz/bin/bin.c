@@ -809,6 +809,7 @@ RZ_API RzBin *rz_bin_new(void) {
 	bin->cb_printf = (PrintfCallback)printf;
 	bin->plugins = rz_list_newf((RzListFree)rz_bin_plugin_free);
 	bin->minstrlen = 0;
+	bin->str_search_threads = 1;
 	bin->strpurge = NULL;
 	bin->strenc = NULL;
 	bin->want_dbginfo = true;
@@ -964,7 +965,7 @@ RZ_API RzBuffer *rz_bin_create(RzBin *bin, const char *p,
 RZ_API RzList * /*<RzBinClass>*/ rz_bin_get_classes(RzBin *bin) {
 	rz_return_val_if_fail(bin, NULL);
 	RzBinObject *o = rz_bin_cur_object(bin);
-	return o ? o->classes : NULL;
+	return o ? (RzList *)rz_bin_object_get_classes(o) : NULL;
 }
 
 RZ_API ut64 rz_bin_get_size(RzBin *bin) {
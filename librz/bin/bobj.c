@@ -202,7 +202,7 @@ static char *swiftField(const char *dn, const char *cn) {
 	return NULL;
 }
 
-static RzList *classes_from_symbols(RzBinFile *bf) {
+static void classes_from_symbols(RzBinFile *bf) {
 	RzBinSymbol *sym;
 	RzListIter *iter;
 	rz_list_foreach (bf->o->symbols, iter, sym) {
@@ -233,7 +233,6 @@ static RzList *classes_from_symbols(RzBinFile *bf) {
 			}
 		}
 	}
-	return bf->o->classes;
 }
 
 // TODO: kill offset and sz, because those should be inferred from binfile->buf
@@ -352,14 +351,299 @@ static void rz_bin_object_rebuild_classes_ht(RzBinObject *o) {
 	}
 }
 
+static void load_fields(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (p->fields) {
+		o->fields = p->fields(bf);
+		if (o->fields) {
+			rz_warn_if_fail(o->fields->free);
+			REBASE_PADDR(o, o->fields, RzBinField);
+		}
+	}
+}
+
+static void load_imports(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (p->imports) {
+		o->imports = p->imports(bf);
+		if (o->imports) {
+			rz_warn_if_fail(o->imports->free);
+		}
+	}
+}
+
+static void load_symbols(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	// the plugins expect the imports to be parsed before the symbols
+	rz_bin_object_load_item(o, RZ_BIN_OBJECT_ITEM_IMPORTS);
+	if (!p->symbols) {
+		return;
+	}
+	o->symbols = p->symbols(bf);
+	if (!o->symbols) {
+		return;
+	}
+	rz_warn_if_fail(o->symbols->free);
+	REBASE_PADDR(o, o->symbols, RzBinSymbol);
+	if (bf->rbin->filter) {
+		rz_bin_filter_symbols(bf, o->symbols);
+	}
+	o->import_name_symbols = ht_pp_new0();
+	if (o->import_name_symbols) {
+		RzBinSymbol *sym;
+		RzListIter *it;
+		rz_list_foreach (o->symbols, it, sym) {
+			if (!sym->is_imported || !sym->name || !*sym->name) {
+				continue;
+			}
+			ht_pp_insert(o->import_name_symbols, sym->name, sym);
+		}
+	}
+}
+
+static void load_relocs(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	rz_bin_object_load_item(o, RZ_BIN_OBJECT_ITEM_SYMBOLS);
+	if (!(bf->rbin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) || !p->relocs) {
+		return;
+	}
+	RzList *l = p->relocs(bf);
+	if (l) {
+		REBASE_PADDR(o, l, RzBinReloc);
+		o->relocs = rz_bin_reloc_storage_new(l);
+	}
+}
+
+static void load_strings(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	if (!(bin->filter_rules & RZ_BIN_REQ_STRINGS)) {
+		return;
+	}
+	if (p->strings) {
+		o->strings = p->strings(bf);
+	} else {
+		// when a bin plugin does not provide it's own strings
+		// we always take all the strings found in the binary
+		// the method also converts the paddrs to vaddrs
+		int minlen = (bin->minstrlen > 0) ? bin->minstrlen : p->minstrlen;
+		o->strings = rz_bin_file_strings(bf, minlen, true);
+	}
+	if (bin->debase64) {
+		rz_bin_object_filter_strings(o);
+	}
+	REBASE_PADDR(o, o->strings, RzBinString);
+}
+
+static void load_language(RzBinFile *bf, RzBinObject *o) {
+	// the language is guessed from the symbols and imports
+	rz_bin_object_load_item(o, RZ_BIN_OBJECT_ITEM_SYMBOLS);
+	if (o->info && RZ_STR_ISEMPTY(o->info->compiler)) {
+		free(o->info->compiler);
+		o->info->compiler = rz_bin_file_golang_compiler(bf);
+		if (o->info->compiler) {
+			o->info->lang = "go";
+		}
+	}
+	o->lang = rz_bin_language_detect(bf);
+}
+
+/**
+ * Merges into the classes of the plugin the ones of \p added, which the
+ * demangler may have filled before the classes were loaded.
+ */
+static void classes_merge(RzBinFile *bf, RzList /*<RzBinClass *>*/ *added) {
+	RzBinObject *o = bf->o;
+	RzListIter *it, *it2;
+	RzBinClass *klass;
+	RzBinSymbol *method;
+	RzBinField *field;
+	rz_list_foreach (added, it, klass) {
+		RzBinClass *c = rz_bin_file_add_class(bf, klass->name, NULL, klass->visibility);
+		if (!c) {
+			continue;
+		}
+		if (!c->super && klass->super) {
+			c->super = strdup(klass->super);
+		}
+		rz_list_foreach (klass->methods, it2, method) {
+			const char *name = sdb_fmt("%s::%s", c->name, method->name);
+			RzBinSymbol *sym = ht_pp_find(o->methods_ht, name, NULL);
+			if (sym) {
+				if (!sym->vaddr) {
+					sym->vaddr = method->vaddr;
+				}
+				rz_bin_symbol_free(method);
+				continue;
+			}
+			rz_list_append(c->methods, method);
+			ht_pp_insert(o->methods_ht, name, method);
+		}
+		rz_list_foreach (klass->fields, it2, field) {
+			rz_list_append(c->fields, field);
+		}
+	}
+	// the methods and fields were moved, the lists of the classes do not own them
+	rz_list_free(added);
+}
+
+static void load_classes(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	if (!(bin->filter_rules & (RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_CLASSES_SOURCES))) {
+		return;
+	}
+	// some plugins look for the class names in the strings
+	rz_bin_object_load_item(o, RZ_BIN_OBJECT_ITEM_STRINGS);
+	rz_bin_object_load_item(o, RZ_BIN_OBJECT_ITEM_LANGUAGE);
+	if (p->classes) {
+		RzList *classes = p->classes(bf);
+		if (classes) {
+			RzList *added = o->classes;
+			o->classes = classes;
+			rz_bin_object_rebuild_classes_ht(o);
+			classes_merge(bf, added);
+		}
+
+		if (o->lang == RZ_BIN_LANGUAGE_SWIFT) {
+			classes_from_symbols(bf);
+		}
+	} else {
+		classes_from_symbols(bf);
+	}
+
+	if (bin->filter) {
+		filter_classes(bf, o->classes);
+	}
+
+	// cache addr=class+method
+	if (o->classes) {
+		RzList *klasses = o->classes;
+		RzListIter *iter, *iter2;
+		RzBinClass *klass;
+		RzBinSymbol *method;
+		if (!o->addrzklassmethod) {
+			// this is slow. must be optimized, but at least its cached
+			o->addrzklassmethod = ht_up_new0();
+			rz_list_foreach (klasses, iter, klass) {
+				rz_list_foreach (klass->methods, iter2, method) {
+					ht_up_insert(o->addrzklassmethod, method->vaddr, method);
+				}
+			}
+		}
+	}
+}
+
+static void load_mem(RzBinFile *bf, RzBinObject *o) {
+	if (o->plugin->mem) {
+		o->mem = o->plugin->mem(bf);
+	}
+}
+
+static void load_resources(RzBinFile *bf, RzBinObject *o) {
+	if (o->plugin->resources) {
+		o->resources = o->plugin->resources(bf);
+	}
+}
+
+static const struct {
+	const char *name;
+	void (*load)(RzBinFile *bf, RzBinObject *o);
+} object_items[RZ_BIN_OBJECT_ITEM_LAST] = {
+	[RZ_BIN_OBJECT_ITEM_FIELDS] = { "fields", load_fields },
+	[RZ_BIN_OBJECT_ITEM_IMPORTS] = { "imports", load_imports },
+	[RZ_BIN_OBJECT_ITEM_SYMBOLS] = { "symbols", load_symbols },
+	[RZ_BIN_OBJECT_ITEM_RELOCS] = { "relocs", load_relocs },
+	[RZ_BIN_OBJECT_ITEM_STRINGS] = { "strings", load_strings },
+	[RZ_BIN_OBJECT_ITEM_LANGUAGE] = { "language", load_language },
+	[RZ_BIN_OBJECT_ITEM_CLASSES] = { "classes", load_classes },
+	[RZ_BIN_OBJECT_ITEM_MEM] = { "mem", load_mem },
+	[RZ_BIN_OBJECT_ITEM_RESOURCES] = { "resources", load_resources },
+};
+
+/**
+ * \brief Load \p item of \p o if it was not yet
+ *
+ * The items are parsed by the plugin on their first access through the
+ * rz_bin_object_get_*() functions, so that opening a file only pays for
+ * what is queried. The time spent is kept, see rz_bin_object_get_item_load_time().
+ */
+RZ_API void rz_bin_object_load_item(RZ_NONNULL RzBinObject *o, RzBinObjectItem item) {
+	rz_return_if_fail(o && item < RZ_BIN_OBJECT_ITEM_LAST);
+	if (o->items_loaded & (1U << item) || !o->bf || !o->plugin) {
+		return;
+	}
+	// marked first, the loaders may query the item being loaded
+	o->items_loaded |= 1U << item;
+	ut64 start = rz_time_now_mono();
+	object_items[item].load(o->bf, o);
+	o->items_time[item] = rz_time_now_mono() - start;
+	RZ_LOG_DEBUG("bin: %s of %s loaded in %" PFMT64u " us\n",
+		object_items[item].name, rz_str_get(o->bf->file), o->items_time[item]);
+}
+
+/**
+ * \brief Name of \p item, as used in the timing reports
+ */
+RZ_API const char *rz_bin_object_item_name(RzBinObjectItem item) {
+	return item < RZ_BIN_OBJECT_ITEM_LAST ? object_items[item].name : NULL;
+}
+
+/**
+ * \brief Microseconds spent loading \p item of \p o, UT64_MAX if it was not loaded yet
+ */
+RZ_API ut64 rz_bin_object_get_item_load_time(RZ_NONNULL RzBinObject *o, RzBinObjectItem item) {
+	rz_return_val_if_fail(o && item < RZ_BIN_OBJECT_ITEM_LAST, UT64_MAX);
+	return o->items_loaded & (1U << item) ? o->items_time[item] : UT64_MAX;
+}
+
+/// Drop the loaded items, to be loaded again on their next access
+static void object_items_fini(RzBinObject *o) {
+	rz_list_free(o->fields);
+	o->fields = NULL;
+	rz_list_free(o->imports);
+	o->imports = NULL;
+	ht_pp_free(o->import_name_symbols);
+	o->import_name_symbols = NULL;
+	rz_bin_reloc_storage_free(o->relocs);
+	o->relocs = NULL;
+	rz_list_free(o->strings);
+	o->strings = NULL;
+	ht_up_free(o->strings_db);
+	o->strings_db = ht_up_new0();
+	o->lang = RZ_BIN_LANGUAGE_UNKNOWN;
+	rz_list_free(o->classes);
+	o->classes = rz_list_newf((RzListFree)rz_bin_class_free);
+	rz_bin_object_rebuild_classes_ht(o);
+	ht_up_free(o->addrzklassmethod);
+	o->addrzklassmethod = NULL;
+	// the classes may hold the symbols as methods
+	rz_list_free(o->symbols);
+	o->symbols = NULL;
+	rz_list_free(o->mem);
+	o->mem = NULL;
+	rz_list_free(o->resources);
+	o->resources = NULL;
+	o->items_loaded = 0;
+	memset(o->items_time, 0, sizeof(o->items_time));
+}
+
+/**
+ * \brief Load the items of \p o needed to describe the file: maps, sections, info, ...
+ *
+ * The others, listed by RzBinObjectItem, are loaded on their first access.
+ */
 RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail(bf && o && o->plugin, false);
 
 	int i;
 	RzBin *bin = bf->rbin;
 	RzBinPlugin *p = o->plugin;
-	int minlen = (bf->rbin->minstrlen > 0) ? bf->rbin->minstrlen : p->minstrlen;
 	bf->o = o;
+	o->bf = bf;
+	if (o->items_loaded) {
+		object_items_fini(o);
+	}
 
 	if (p->file_type) {
 		int type = p->file_type(bf);
@@ -401,41 +685,6 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			REBASE_PADDR(o, o->maps, RzBinMap);
 		}
 	}
-	if (p->fields) {
-		o->fields = p->fields(bf);
-		if (o->fields) {
-			rz_warn_if_fail(o->fields->free);
-			REBASE_PADDR(o, o->fields, RzBinField);
-		}
-	}
-	if (p->imports) {
-		rz_list_free(o->imports);
-		o->imports = p->imports(bf);
-		if (o->imports) {
-			rz_warn_if_fail(o->imports->free);
-		}
-	}
-	if (p->symbols) {
-		o->symbols = p->symbols(bf);
-		if (o->symbols) {
-			rz_warn_if_fail(o->symbols->free);
-			REBASE_PADDR(o, o->symbols, RzBinSymbol);
-			if (bin->filter) {
-				rz_bin_filter_symbols(bf, o->symbols);
-			}
-			o->import_name_symbols = ht_pp_new0();
-			if (o->import_name_symbols) {
-				RzBinSymbol *sym;
-				RzListIter *it;
-				rz_list_foreach (o->symbols, it, sym) {
-					if (!sym->is_imported || !sym->name || !*sym->name) {
-						continue;
-					}
-					ht_pp_insert(o->import_name_symbols, sym->name, sym);
-				}
-			}
-		}
-	}
 	if (p->libs) {
 		o->libs = p->libs(bf);
 	}
@@ -452,81 +701,6 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 
 	o->info = p->info ? p->info(bf) : NULL;
 
-	if (bin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) {
-		if (p->relocs) {
-			RzList *l = p->relocs(bf);
-			if (l) {
-				REBASE_PADDR(o, l, RzBinReloc);
-				o->relocs = rz_bin_reloc_storage_new(l);
-			}
-		}
-	}
-	if (bin->filter_rules & RZ_BIN_REQ_STRINGS) {
-		if (p->strings) {
-			o->strings = p->strings(bf);
-		} else {
-			// when a bin plugin does not provide it's own strings
-			// we always take all the strings found in the binary
-			// the method also converts the paddrs to vaddrs
-			o->strings = rz_bin_file_strings(bf, minlen, true);
-		}
-		if (bin->debase64) {
-			rz_bin_object_filter_strings(o);
-		}
-		REBASE_PADDR(o, o->strings, RzBinString);
-	}
-
-	if (o->info && RZ_STR_ISEMPTY(o->info->compiler)) {
-		free(o->info->compiler);
-		o->info->compiler = rz_bin_file_golang_compiler(bf);
-		if (o->info->compiler) {
-			o->info->lang = "go";
-		}
-	}
-
-	o->lang = rz_bin_language_detect(bf);
-
-	if (bin->filter_rules & (RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_CLASSES_SOURCES)) {
-		if (p->classes) {
-			RzList *classes = p->classes(bf);
-			if (classes) {
-				// XXX we should probably merge them instead
-				rz_list_free(o->classes);
-				o->classes = classes;
-				rz_bin_object_rebuild_classes_ht(o);
-			}
-
-			if (o->lang == RZ_BIN_LANGUAGE_SWIFT) {
-				o->classes = classes_from_symbols(bf);
-			}
-		} else {
-			RzList *classes = classes_from_symbols(bf);
-			if (classes) {
-				o->classes = classes;
-			}
-		}
-
-		if (bin->filter) {
-			filter_classes(bf, o->classes);
-		}
-
-		// cache addr=class+method
-		if (o->classes) {
-			RzList *klasses = o->classes;
-			RzListIter *iter, *iter2;
-			RzBinClass *klass;
-			RzBinSymbol *method;
-			if (!o->addrzklassmethod) {
-				// this is slow. must be optimized, but at least its cached
-				o->addrzklassmethod = ht_up_new0();
-				rz_list_foreach (klasses, iter, klass) {
-					rz_list_foreach (klass->methods, iter2, method) {
-						ht_up_insert(o->addrzklassmethod, method->vaddr, method);
-					}
-				}
-			}
-		}
-	}
 	if (p->lines) {
 		o->lines = p->lines(bf);
 	}
@@ -537,12 +711,6 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 		}
 		o->kv = new_kv;
 	}
-	if (p->mem) {
-		o->mem = p->mem(bf);
-	}
-	if (p->resources) {
-		o->resources = p->resources(bf);
-	}
 	return true;
 }
 
@@ -550,9 +718,9 @@ RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject
 	rz_return_val_if_fail(bf && o, NULL);
 
 	static bool first = true;
-	// rz_bin_object_set_items set o->relocs but there we don't have access
-	// to io so we need to be run from bin_relocs, free the previous reloc and get
-	// the patched ones
+	rz_bin_object_load_item(o, RZ_BIN_OBJECT_ITEM_RELOCS);
+	// the relocs are loaded without access to io, so we need to be run
+	// from bin_relocs, free the previous reloc and get the patched ones
 	if (first && o->plugin && o->plugin->patch_relocs) {
 		RzList *tmp = o->plugin->patch_relocs(bf);
 		first = false;
@@ -574,6 +742,7 @@ RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject
  */
 RZ_API RzBinSymbol *rz_bin_object_get_symbol_of_import(RzBinObject *o, RzBinImport *imp) {
 	rz_return_val_if_fail(o && imp && imp->name, NULL);
+	rz_bin_object_load_item(o, RZ_BIN_OBJECT_ITEM_SYMBOLS);
 	if (!o->import_name_symbols) {
 		return NULL;
 	}
@@ -709,6 +878,7 @@ RZ_API const RzList *rz_bin_object_get_entries(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_fields(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_FIELDS);
 	return obj->fields;
 }
 
@@ -717,6 +887,7 @@ RZ_API const RzList *rz_bin_object_get_fields(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_imports(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_IMPORTS);
 	return obj->imports;
 }
 
@@ -781,6 +952,7 @@ RZ_API RzList *rz_bin_object_get_segments(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_classes(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_CLASSES);
 	return obj->classes;
 }
 
@@ -789,6 +961,7 @@ RZ_API const RzList *rz_bin_object_get_classes(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_strings(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_STRINGS);
 	return obj->strings;
 }
 
@@ -797,6 +970,7 @@ RZ_API const RzList *rz_bin_object_get_strings(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_mem(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_MEM);
 	return obj->mem;
 }
 
@@ -805,14 +979,27 @@ RZ_API const RzList *rz_bin_object_get_mem(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_symbols(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_SYMBOLS);
 	return obj->symbols;
 }
 
+/**
+ * \brief Get the language the binary object was written in, guessed from its symbols
+ *
+ * The name of the language is also set in its \p RzBinInfo.
+ */
+RZ_API RzBinLanguage rz_bin_object_get_language(RzBinObject *obj) {
+	rz_return_val_if_fail(obj, RZ_BIN_LANGUAGE_UNKNOWN);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_LANGUAGE);
+	return obj->lang;
+}
+
 /**
  * \brief Get a list of \p RzBinResource representing the resources in the binary object.
  */
 RZ_API const RzList *rz_bin_object_get_resources(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_load_item(obj, RZ_BIN_OBJECT_ITEM_RESOURCES);
 	return obj->resources;
 }
 
@@ -821,6 +1008,7 @@ RZ_API const RzList *rz_bin_object_get_resources(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_reset_strings(RzBin *bin, RzBinFile *bf, RzBinObject *obj) {
 	rz_return_val_if_fail(bin && bf && obj, NULL);
+	obj->items_loaded |= 1U << RZ_BIN_OBJECT_ITEM_STRINGS;
 	if (obj->strings) {
 		rz_list_free(obj->strings);
 		obj->strings = NULL;
@@ -8,6 +8,16 @@ RZ_LIB_VERSION(rz_bp);
 
 static struct rz_bp_plugin_t *bp_static_plugins[] = { RZ_BP_STATIC_PLUGINS };
 
+/**
+ * Data of the nodes of bp->bps_tree, to find, index and unlink a breakpoint
+ * without scanning all of them
+ */
+typedef struct {
+	RzBreakpointItem *b;
+	RzListIter /*<RzBreakpointItem *>*/ *iter; ///< in bp->bps
+	int idx; ///< in bp->bps_idx
+} BpEntry;
+
 static void rz_bp_item_free(RzBreakpointItem *b) {
 	free(b->name);
 	free(b->bbytes);
@@ -36,6 +46,7 @@ RZ_API RzBreakpoint *rz_bp_new(RZ_BORROW RZ_NONNULL RzBreakpointContext *ctx) {
 	bp->traces = rz_bp_traptrace_new();
 	bp->cb_printf = (PrintfCallback)printf;
 	bp->bps = rz_list_newf((RzListFree)rz_bp_item_free);
+	rz_interval_tree_init(&bp->bps_tree, free);
 	bp->plugins = rz_list_newf((RzListFree)free);
 	bp->nhwbps = 0;
 	for (i = 0; bp_static_plugins[i]; i++) {
@@ -46,6 +57,9 @@ RZ_API RzBreakpoint *rz_bp_new(RZ_BORROW RZ_NONNULL RzBreakpointContext *ctx) {
 }
 
 RZ_API RzBreakpoint *rz_bp_free(RzBreakpoint *bp) {
+	rz_bp_coverage_reset(bp);
+	free(bp->coverage);
+	rz_interval_tree_fini(&bp->bps_tree);
 	rz_list_free(bp->bps);
 	rz_list_free(bp->plugins);
 	rz_list_free(bp->traces);
@@ -96,19 +110,69 @@ repeat:
 	return b->length;
 }
 
+typedef struct {
+	ut64 addr;
+	int perm;
+	RzBreakpointItem *b; ///< NULL to match any
+	RzIntervalNode *found;
+} BpLookup;
+
+static inline RzBreakpointItem *found_item(BpLookup *lookup) {
+	return lookup->found ? ((BpEntry *)lookup->found->data)->b : NULL;
+}
+
+static bool lookup_at_cb(RzIntervalNode *node, void *user) {
+	BpLookup *lookup = user;
+	BpEntry *e = node->data;
+	if (lookup->b && lookup->b != e->b) {
+		return true;
+	}
+	lookup->found = node;
+	return false;
+}
+
+static RzIntervalNode *node_at(RzBreakpoint *bp, ut64 addr, RzBreakpointItem *b) {
+	BpLookup lookup = { .addr = addr, .b = b };
+	rz_interval_tree_all_at(&bp->bps_tree, addr, lookup_at_cb, &lookup);
+	return lookup.found;
+}
+
+/**
+ * Finds the node of \p b, even if its address was changed without
+ * rz_bp_item_set_addr()
+ */
+static RzIntervalNode *node_of(RzBreakpoint *bp, RzBreakpointItem *b) {
+	RzIntervalNode *node = node_at(bp, b->addr, b);
+	if (node) {
+		return node;
+	}
+	RzIntervalTreeIter it;
+	BpEntry *e;
+	rz_interval_tree_foreach (&bp->bps_tree, it, e) {
+		if (e->b == b) {
+			return rz_interval_tree_iter_get(&it);
+		}
+	}
+	return NULL;
+}
+
 /**
  * \brief Get the breakpoint at exactly \p addr
  */
 RZ_API RZ_BORROW RzBreakpointItem *rz_bp_get_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr) {
 	rz_return_val_if_fail(bp, NULL);
-	RzListIter *iter;
-	RzBreakpointItem *b;
-	rz_list_foreach (bp->bps, iter, b) {
-		if (b->addr == addr) {
-			return b;
-		}
+	RzIntervalNode *node = node_at(bp, addr, NULL);
+	return node ? ((BpEntry *)node->data)->b : NULL;
+}
+
+static bool lookup_ending_at_cb(RzIntervalNode *node, void *user) {
+	BpLookup *lookup = user;
+	BpEntry *e = node->data;
+	if (e->b->hw || e->b->addr + e->b->size != lookup->addr) {
+		return true;
 	}
-	return NULL;
+	lookup->found = node;
+	return false;
 }
 
 /**
@@ -118,35 +182,32 @@ RZ_API RZ_BORROW RzBreakpointItem *rz_bp_get_at(RZ_NONNULL RzBreakpoint *bp, ut6
  */
 RZ_API RZ_BORROW RzBreakpointItem *rz_bp_get_ending_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr) {
 	rz_return_val_if_fail(bp, NULL);
-	RzListIter *iter;
-	RzBreakpointItem *b;
-	rz_list_foreach (bp->bps, iter, b) {
-		if (!b->hw && b->addr + b->size == addr) {
-			return b;
-		}
+	if (!addr) {
+		return NULL;
 	}
-	return NULL;
-}
-
-static inline bool inRange(RzBreakpointItem *b, ut64 addr) {
-	return (addr >= b->addr && addr < (b->addr + b->size));
+	BpLookup lookup = { .addr = addr };
+	rz_interval_tree_all_in(&bp->bps_tree, addr - 1, true, lookup_ending_at_cb, &lookup);
+	return found_item(&lookup);
 }
 
 static inline bool matchProt(RzBreakpointItem *b, int perm) {
 	return (!perm || (perm && b->perm));
 }
 
-RZ_API RzBreakpointItem *rz_bp_get_in(RzBreakpoint *bp, ut64 addr, int perm) {
-	RzBreakpointItem *b;
-	RzListIter *iter;
-	rz_list_foreach (bp->bps, iter, b) {
-		// eprintf ("---ataddr--- 0x%08"PFMT64x" %d %d %x\n", b->addr, b->size, b->recoil, b->perm);
-		// Check addr within range and provided perm matches (or null)
-		if (inRange(b, addr) && matchProt(b, perm)) {
-			return b;
-		}
+static bool lookup_in_cb(RzIntervalNode *node, void *user) {
+	BpLookup *lookup = user;
+	BpEntry *e = node->data;
+	if (!matchProt(e->b, lookup->perm)) {
+		return true;
 	}
-	return NULL;
+	lookup->found = node;
+	return false;
+}
+
+RZ_API RzBreakpointItem *rz_bp_get_in(RzBreakpoint *bp, ut64 addr, int perm) {
+	BpLookup lookup = { .addr = addr, .perm = perm };
+	rz_interval_tree_all_in(&bp->bps_tree, addr, true, lookup_in_cb, &lookup);
+	return found_item(&lookup);
 }
 
 RZ_API RzBreakpointItem *rz_bp_enable(RzBreakpoint *bp, ut64 addr, int set, int count) {
@@ -174,22 +235,33 @@ RZ_API int rz_bp_stepy_continuation(RzBreakpoint *bp) {
 }
 
 static void unlinkBreakpoint(RzBreakpoint *bp, RzBreakpointItem *b) {
-	int i;
-	for (i = 0; i < bp->bps_idx_count; i++) {
-		if (bp->bps_idx[i] == b) {
-			bp->bps_idx[i] = NULL;
-		}
+	RzIntervalNode *node = node_of(bp, b);
+	if (!node) {
+		return;
 	}
-	rz_list_delete_data(bp->bps, b);
+	BpEntry *e = node->data;
+	if (e->idx < bp->bps_idx_count && bp->bps_idx[e->idx] == b) {
+		bp->bps_idx[e->idx] = NULL;
+		bp->bps_idx_free = RZ_MIN(bp->bps_idx_free, e->idx);
+	}
+	RzListIter *iter = e->iter;
+	rz_interval_tree_delete(&bp->bps_tree, node, true);
+	rz_list_delete(bp->bps, iter);
 }
 
 /**
  * Put an allocated RzBreakpointItem into the RzBreakpoint's list and give it an index
+ *
+ * \return false on allocation failure, \p b being left to the caller
  */
-RZ_IPI void rz_bp_item_insert(RzBreakpoint *bp, RzBreakpointItem *b) {
+RZ_IPI bool rz_bp_item_insert(RzBreakpoint *bp, RzBreakpointItem *b) {
 	int i;
+	BpEntry *e = RZ_NEW0(BpEntry);
+	if (!e) {
+		return false;
+	}
 	/* find empty slot */
-	for (i = 0; i < bp->bps_idx_count; i++) {
+	for (i = bp->bps_idx_free; i < bp->bps_idx_count; i++) {
 		if (!bp->bps_idx[i]) {
 			break;
 		}
@@ -198,20 +270,28 @@ RZ_IPI void rz_bp_item_insert(RzBreakpoint *bp, RzBreakpointItem *b) {
 		/* allocate new slot */
 		bp->bps_idx_count += 16; // allocate space for 16 more bps
 		RzBreakpointItem **newbps = realloc(bp->bps_idx, bp->bps_idx_count * sizeof(RzBreakpointItem *));
-		if (newbps) {
-			bp->bps_idx = newbps;
-			for (int j = i; j < bp->bps_idx_count; j++) {
-				bp->bps_idx[j] = NULL;
-			}
-		} else {
-			bp->bps_idx_count -= 16; // allocate space for 16 more bps
-			i = 0; // avoid oob below
+		if (!newbps) {
+			bp->bps_idx_count -= 16;
+			free(e);
+			return false;
 		}
+		bp->bps_idx = newbps;
+		for (int j = i; j < bp->bps_idx_count; j++) {
+			bp->bps_idx[j] = NULL;
+		}
+	}
+	e->b = b;
+	e->idx = i;
+	if (!rz_interval_tree_insert(&bp->bps_tree, b->addr, b->addr + RZ_MAX(b->size, 1) - 1, e)) {
+		free(e);
+		return false;
 	}
 	/* empty slot */
 	bp->bps_idx[i] = b;
+	bp->bps_idx_free = i + 1;
 	bp->nbps++;
-	rz_list_append(bp->bps, b);
+	e->iter = rz_list_append(bp->bps, b);
+	return true;
 }
 
 /* TODO: detect overlapping of breakpoints */
@@ -261,7 +341,9 @@ static RzBreakpointItem *rz_bp_add(RzBreakpoint *bp, const ut8 *obytes, ut64 add
 			goto err;
 		}
 	}
-	rz_bp_item_insert(bp, b);
+	if (!rz_bp_item_insert(bp, b)) {
+		goto err;
+	}
 	return b;
 err:
 	rz_bp_item_free(b);
@@ -303,27 +385,25 @@ RZ_API RzBreakpointItem *rz_bp_add_hw(RzBreakpoint *bp, ut64 addr, int size, int
 RZ_API bool rz_bp_del_all(RzBreakpoint *bp) {
 	int i;
 	if (!rz_list_empty(bp->bps)) {
+		rz_interval_tree_fini(&bp->bps_tree);
+		rz_interval_tree_init(&bp->bps_tree, free);
 		rz_list_purge(bp->bps);
 		for (i = 0; i < bp->bps_idx_count; i++) {
 			bp->bps_idx[i] = NULL;
 		}
+		bp->bps_idx_free = 0;
 		return true;
 	}
 	return false;
 }
 
 RZ_API bool rz_bp_del(RzBreakpoint *bp, ut64 addr) {
-	RzListIter *iter;
-	RzBreakpointItem *b;
-	/* No _safe loop necessary because we return immediately after the delete. */
-	rz_list_foreach (bp->bps, iter, b) {
-		if (b->addr == addr) {
-			unlinkBreakpoint(bp, b);
-			// rz_list_delete (bp->bps, iter);
-			return true;
-		}
+	RzBreakpointItem *b = rz_bp_get_at(bp, addr);
+	if (!b) {
+		return false;
 	}
-	return false;
+	unlinkBreakpoint(bp, b);
+	return true;
 }
 
 RZ_API int rz_bp_set_trace(RzBreakpoint *bp, ut64 addr, int set) {
@@ -352,19 +432,15 @@ RZ_API RzBreakpointItem *rz_bp_get_index(RzBreakpoint *bp, int idx) {
 }
 
 RZ_API int rz_bp_get_index_at(RzBreakpoint *bp, ut64 addr) {
-	int i;
-	for (i = 0; i < bp->bps_idx_count; i++) {
-		if (bp->bps_idx[i] && bp->bps_idx[i]->addr == addr) {
-			return i;
-		}
-	}
-	return -1;
+	RzIntervalNode *node = node_at(bp, addr, NULL);
+	return node ? ((BpEntry *)node->data)->idx : -1;
 }
 
 RZ_API int rz_bp_del_index(RzBreakpoint *bp, int idx) {
 	if (idx >= 0 && idx < bp->bps_idx_count) {
-		rz_list_delete_data(bp->bps, bp->bps_idx[idx]);
-		bp->bps_idx[idx] = 0;
+		if (bp->bps_idx[idx]) {
+			unlinkBreakpoint(bp, bp->bps_idx[idx]);
+		}
 		return true;
 	}
 	return false;
@@ -479,6 +555,27 @@ RZ_API bool rz_bp_item_set_expr(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE c
 	return true;
 }
 
+/**
+ * \brief set the address of a RzBreakpointItem of \p bp, keeping it indexed
+ *
+ * \param bp breakpoints holding \p item
+ * \param item breakpoint item to move
+ * \param addr new address of \p item
+ * \return bool true if succesful; false otherwise
+ */
+RZ_API bool rz_bp_item_set_addr(RZ_NONNULL RzBreakpoint *bp, RZ_NONNULL RzBreakpointItem *item, ut64 addr) {
+	rz_return_val_if_fail(bp && item, false);
+	if (item->addr == addr) {
+		return true;
+	}
+	RzIntervalNode *node = node_of(bp, item);
+	item->addr = addr;
+	if (!node) {
+		return false;
+	}
+	return rz_interval_tree_resize(&bp->bps_tree, node, addr, addr + RZ_MAX(item->size, 1) - 1);
+}
+
 /**
  * \brief set the name for a RzBreakpointItem
  *
@@ -0,0 +1,379 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file bp_coverage.c
+ * One-shot breakpoints to collect basic block coverage.
+ *
+ * They are kept apart from the regular breakpoints in bp->bps, so they are
+ * neither listed nor rewritten on every stop: they are written once, in
+ * batches of a page, and each one is removed as soon as it is hit.
+ */
+
+#include <rz_bp.h>
+
+#define COVERAGE_PAGE      0x1000
+#define COVERAGE_BP_MAXLEN 16
+
+typedef struct {
+	ut64 addr;
+	ut32 size; ///< size of the basic block
+	ut8 bpsize; ///< bytes of the breakpoint, valid while installed
+	bool installed;
+	bool hit;
+	ut8 obytes[COVERAGE_BP_MAXLEN]; ///< original bytes, valid while installed
+} CoverageBlock;
+
+struct rz_bp_coverage_t {
+	RzVector /*<CoverageBlock>*/ blocks;
+	bool sorted; ///< blocks are sorted by address, without duplicates
+	RzVector /*<RzBreakpointCoverageHit>*/ hits;
+};
+
+static RzBreakpointCoverage *coverage_get(RzBreakpoint *bp) {
+	if (!bp->coverage) {
+		RzBreakpointCoverage *cov = RZ_NEW0(RzBreakpointCoverage);
+		if (!cov) {
+			return NULL;
+		}
+		rz_vector_init(&cov->blocks, sizeof(CoverageBlock), NULL, NULL);
+		rz_vector_init(&cov->hits, sizeof(RzBreakpointCoverageHit), NULL, NULL);
+		cov->sorted = true;
+		bp->coverage = cov;
+	}
+	return bp->coverage;
+}
+
+static int block_cmp(const void *a, const void *b) {
+	const CoverageBlock *ba = a;
+	const CoverageBlock *bb = b;
+	if (ba->addr != bb->addr) {
+		return ba->addr < bb->addr ? -1 : 1;
+	}
+	// keep the installed one of duplicates first, it owns the original bytes
+	return (int)bb->installed - (int)ba->installed;
+}
+
+static void coverage_sort(RzBreakpointCoverage *cov) {
+	if (cov->sorted) {
+		return;
+	}
+	rz_vector_sort(&cov->blocks, block_cmp, false);
+	size_t n = 0;
+	CoverageBlock *blocks = cov->blocks.a;
+	for (size_t i = 0; i < cov->blocks.len; i++) {
+		if (n && blocks[n - 1].addr == blocks[i].addr) {
+			blocks[n - 1].hit |= blocks[i].hit;
+			continue;
+		}
+		blocks[n++] = blocks[i];
+	}
+	cov->blocks.len = n;
+	cov->sorted = true;
+}
+
+/**
+ * Index of the first block at or after \p addr
+ */
+static size_t block_lower_bound(RzBreakpointCoverage *cov, ut64 addr) {
+	CoverageBlock *blocks = cov->blocks.a;
+	size_t lo = 0, hi = cov->blocks.len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (blocks[mid].addr < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static CoverageBlock *installed_at(RzBreakpoint *bp, ut64 addr) {
+	RzBreakpointCoverage *cov = bp->coverage;
+	if (!cov) {
+		return NULL;
+	}
+	coverage_sort(cov);
+	size_t i = block_lower_bound(cov, addr);
+	if (i == cov->blocks.len) {
+		return NULL;
+	}
+	CoverageBlock *block = rz_vector_index_ptr(&cov->blocks, i);
+	return block->addr == addr && block->installed ? block : NULL;
+}
+
+/**
+ * \brief Add a one-shot coverage breakpoint at the basic block \p addr
+ *
+ * It is only written to memory by rz_bp_coverage_install().
+ *
+ * \param size size of the basic block, reported back by rz_bp_coverage_hits()
+ */
+RZ_API bool rz_bp_coverage_add(RZ_NONNULL RzBreakpoint *bp, ut64 addr, ut32 size) {
+	rz_return_val_if_fail(bp, false);
+	RzBreakpointCoverage *cov = coverage_get(bp);
+	if (!cov) {
+		return false;
+	}
+	CoverageBlock *block = rz_vector_push(&cov->blocks, NULL);
+	if (!block) {
+		return false;
+	}
+	memset(block, 0, sizeof(*block));
+	block->addr = addr;
+	block->size = size;
+	const CoverageBlock *prev = cov->blocks.len > 1 ? rz_vector_index_ptr(&cov->blocks, cov->blocks.len - 2) : NULL;
+	if (prev && prev->addr >= addr) {
+		cov->sorted = false;
+	}
+	return true;
+}
+
+/**
+ * Writes the breakpoints of the blocks [\p from, \p to), which are all within
+ * one page, with a single read and a single write.
+ */
+static size_t install_window(RzBreakpoint *bp, CoverageBlock *from, CoverageBlock *to) {
+	// pick the blocks to install, without any overlapping breakpoints
+	ut64 start = UT64_MAX, end = 0;
+	ut64 used = 0; // end of the last breakpoint, installed or picked
+	for (CoverageBlock *block = from; block < to; block++) {
+		if (block->installed) {
+			used = RZ_MAX(used, block->addr + block->bpsize);
+			continue;
+		}
+		block->bpsize = 0;
+		if (block->hit || block->addr < used) {
+			continue;
+		}
+		if (rz_bp_get_in(bp, block->addr, 0)) {
+			// a regular breakpoint is already there
+			continue;
+		}
+		int len = rz_bp_size_at(bp, block->addr);
+		if (len < 1 || len > COVERAGE_BP_MAXLEN) {
+			continue;
+		}
+		block->bpsize = len;
+		start = RZ_MIN(start, block->addr);
+		end = used = block->addr + len;
+	}
+	if (start >= end) {
+		return 0;
+	}
+	ut8 *buf = malloc(end - start);
+	if (!buf || !bp->iob.read_at(bp->iob.io, start, buf, (int)(end - start))) {
+		free(buf);
+		return 0;
+	}
+	size_t count = 0;
+	for (CoverageBlock *block = from; block < to; block++) {
+		if (!block->bpsize || block->installed) {
+			continue;
+		}
+		ut8 *at = buf + (block->addr - start);
+		memcpy(block->obytes, at, block->bpsize);
+		if (rz_bp_get_bytes(bp, block->addr, at, block->bpsize) != block->bpsize) {
+			memcpy(at, block->obytes, block->bpsize);
+			continue;
+		}
+		block->installed = true;
+		count++;
+	}
+	if (count) {
+		bp->iob.write_at(bp->iob.io, start, buf, (int)(end - start));
+	}
+	free(buf);
+	return count;
+}
+
+/**
+ * Restores the original bytes of the blocks [\p from, \p to), which are all
+ * within one page, with a single read and a single write.
+ */
+static size_t uninstall_window(RzBreakpoint *bp, CoverageBlock *from, CoverageBlock *to) {
+	ut64 start = UT64_MAX, end = 0;
+	for (CoverageBlock *block = from; block < to; block++) {
+		if (block->installed) {
+			start = RZ_MIN(start, block->addr);
+			end = RZ_MAX(end, block->addr + block->bpsize);
+		}
+	}
+	if (start >= end) {
+		return 0;
+	}
+	ut8 *buf = malloc(end - start);
+	if (!buf || !bp->iob.read_at(bp->iob.io, start, buf, (int)(end - start))) {
+		free(buf);
+		return 0;
+	}
+	size_t count = 0;
+	for (CoverageBlock *block = from; block < to; block++) {
+		if (block->installed) {
+			memcpy(buf + (block->addr - start), block->obytes, block->bpsize);
+			block->installed = false;
+			count++;
+		}
+	}
+	bp->iob.write_at(bp->iob.io, start, buf, (int)(end - start));
+	free(buf);
+	return count;
+}
+
+typedef size_t (*CoverageWindowCb)(RzBreakpoint *bp, CoverageBlock *from, CoverageBlock *to);
+
+static size_t coverage_foreach_page(RzBreakpoint *bp, CoverageWindowCb cb) {
+	RzBreakpointCoverage *cov = bp->coverage;
+	if (!cov || !bp->iob.io) {
+		return 0;
+	}
+	coverage_sort(cov);
+	CoverageBlock *blocks = cov->blocks.a;
+	CoverageBlock *blocks_end = blocks + cov->blocks.len;
+	size_t count = 0;
+	for (CoverageBlock *from = blocks; from < blocks_end;) {
+		ut64 page_end = (from->addr & ~(ut64)(COVERAGE_PAGE - 1)) + COVERAGE_PAGE;
+		CoverageBlock *to = from + 1;
+		while (to < blocks_end && to->addr < page_end) {
+			to++;
+		}
+		count += cb(bp, from, to);
+		from = to;
+	}
+	return count;
+}
+
+/**
+ * \brief Write the coverage breakpoints that were neither hit nor installed yet
+ *
+ * Blocks already holding a regular breakpoint are skipped, and the writes
+ * are grouped so that each page of memory is read and written once.
+ *
+ * \return the number of breakpoints written
+ */
+RZ_API size_t rz_bp_coverage_install(RZ_NONNULL RzBreakpoint *bp) {
+	rz_return_val_if_fail(bp, 0);
+	return coverage_foreach_page(bp, install_window);
+}
+
+/**
+ * \brief Restore the original bytes under all the installed coverage breakpoints
+ *
+ * The blocks not hit yet stay pending and are written again by the next
+ * rz_bp_coverage_install().
+ *
+ * \return the number of breakpoints removed
+ */
+RZ_API size_t rz_bp_coverage_uninstall(RZ_NONNULL RzBreakpoint *bp) {
+	rz_return_val_if_fail(bp, 0);
+	return coverage_foreach_page(bp, uninstall_window);
+}
+
+/**
+ * \brief Remove all the coverage breakpoints from memory and forget them and their hits
+ */
+RZ_API void rz_bp_coverage_reset(RZ_NONNULL RzBreakpoint *bp) {
+	rz_return_if_fail(bp);
+	RzBreakpointCoverage *cov = bp->coverage;
+	if (!cov) {
+		return;
+	}
+	rz_bp_coverage_uninstall(bp);
+	rz_vector_clear(&cov->blocks);
+	rz_vector_clear(&cov->hits);
+	cov->sorted = true;
+}
+
+/**
+ * \brief Check if an installed coverage breakpoint starts at \p addr
+ */
+RZ_API bool rz_bp_coverage_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr) {
+	rz_return_val_if_fail(bp, false);
+	return installed_at(bp, addr) != NULL;
+}
+
+/**
+ * \brief Check if an installed coverage breakpoint ends at \p addr
+ *
+ * This is where the program counter is after hitting it on most targets.
+ *
+ * \param start set to the address of the breakpoint found
+ */
+RZ_API bool rz_bp_coverage_ending_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr, RZ_NULLABLE RZ_OUT ut64 *start) {
+	rz_return_val_if_fail(bp, false);
+	RzBreakpointCoverage *cov = bp->coverage;
+	if (!cov || addr < 1) {
+		return false;
+	}
+	coverage_sort(cov);
+	ut64 from = addr > COVERAGE_BP_MAXLEN ? addr - COVERAGE_BP_MAXLEN : 0;
+	for (size_t i = block_lower_bound(cov, from); i < cov->blocks.len; i++) {
+		CoverageBlock *block = rz_vector_index_ptr(&cov->blocks, i);
+		if (block->addr >= addr) {
+			break;
+		}
+		if (block->installed && block->addr + block->bpsize == addr) {
+			if (start) {
+				*start = block->addr;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * \brief Handle the hit of the coverage breakpoint at \p addr
+ *
+ * The original bytes are restored so it is never hit again, and the block
+ * is added to the hits. Setting the program counter back to \p addr is up
+ * to the caller.
+ *
+ * \return false if no coverage breakpoint is installed at \p addr
+ */
+RZ_API bool rz_bp_coverage_hit(RZ_NONNULL RzBreakpoint *bp, ut64 addr) {
+	rz_return_val_if_fail(bp, false);
+	CoverageBlock *block = installed_at(bp, addr);
+	if (!block) {
+		return false;
+	}
+	bp->iob.write_at(bp->iob.io, block->addr, block->obytes, block->bpsize);
+	block->installed = false;
+	block->hit = true;
+	RzBreakpointCoverageHit *hit = rz_vector_push(&bp->coverage->hits, NULL);
+	if (hit) {
+		hit->addr = block->addr;
+		hit->size = block->size;
+	}
+	return true;
+}
+
+/**
+ * \brief Get the number of coverage blocks not hit yet
+ */
+RZ_API size_t rz_bp_coverage_pending(RZ_NONNULL RzBreakpoint *bp) {
+	rz_return_val_if_fail(bp, 0);
+	RzBreakpointCoverage *cov = bp->coverage;
+	if (!cov) {
+		return 0;
+	}
+	coverage_sort(cov);
+	size_t pending = 0;
+	CoverageBlock *block;
+	rz_vector_foreach(&cov->blocks, block) {
+		if (!block->hit) {
+			pending++;
+		}
+	}
+	return pending;
+}
+
+/**
+ * \brief Get the blocks hit so far, in the order they were hit
+ */
+RZ_API RZ_BORROW const RzVector /*<RzBreakpointCoverageHit>*/ *rz_bp_coverage_hits(RZ_NONNULL RzBreakpoint *bp) {
+	rz_return_val_if_fail(bp, NULL);
+	RzBreakpointCoverage *cov = coverage_get(bp);
+	return cov ? &cov->hits : NULL;
+}
@@ -4,7 +4,7 @@
 
 #include <rz_bp.h>
 
-RZ_IPI void rz_bp_item_insert(RzBreakpoint *bp, RzBreakpointItem *b);
+RZ_IPI bool rz_bp_item_insert(RzBreakpoint *bp, RzBreakpointItem *b);
 
 static void rz_bp_watch_add_hw(RzBreakpoint *bp, RzBreakpointItem *b) {
 	if (bp->breakpoint) {
@@ -30,13 +30,16 @@ RZ_API RZ_BORROW RzBreakpointItem *rz_bp_watch_add(RZ_NONNULL RzBreakpoint *bp,
 	b->enabled = true;
 	b->perm = perm;
 	b->hw = hw;
+	if (!rz_bp_item_insert(bp, b)) {
+		free(b);
+		return NULL;
+	}
 	if (hw) {
 		rz_bp_watch_add_hw(bp, b);
 	} else {
 		RZ_LOG_ERROR("[TODO]: Software watchpoint is not implemented yet (use ESIL)\n");
 		/* TODO */
 	}
-	rz_bp_item_insert(bp, b);
 	return b;
 }
 
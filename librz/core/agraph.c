@@ -815,6 +815,402 @@ static void minimize_crossings(const RzAGraph *g) {
 	} while (cross_changed && max_changes);
 }
 
+/* Barycenter ordering
+ *
+ * Each sweep sorts the layers by the mean position of the neighbours of their
+ * nodes in the layer sorted just before, going down then up, and keeps the
+ * order with the fewest crossings. The crossings between two layers are the
+ * inversions among the lower ends of their edges sorted by the upper ends,
+ * counted with a Fenwick tree in O(E log V) instead of a matrix per layer. */
+
+#define BARYCENTER_MAX_SWEEPS 32
+#define BARYCENTER_MAX_STALE  4 // sweeps without fewer crossings before giving up
+#define SWEEP_MAX_NODES       256 // nodes laid out by the sweep with RZ_AGRAPH_CROSSING_AUTO
+#define LAYOUT_CACHE_MAX      64 // graphs remembered by a RzAGraphLayoutCache
+
+typedef struct {
+	RzGraphNode *gn;
+	double key;
+	int pos;
+} LayerKey;
+
+typedef struct {
+	int up;
+	int down;
+} EdgeEnds;
+
+typedef struct {
+	ut64 sig; ///< layout_signature() of the graph the order was computed for
+	size_t n_nodes;
+	int *order; ///< pos_in_layer of the nodes, in the order of rz_graph_get_nodes()
+	HtPU *pos; ///< layer << 32 | pos_in_layer of the nodes by title
+} LayoutCacheEntry;
+
+struct rz_agraph_layout_cache_t {
+	HtPP *entries; ///< LayoutCacheEntry by title of the first node of the graph
+	size_t n_entries;
+};
+
+static int layer_key_cmp(const void *a, const void *b) {
+	const LayerKey *ka = a, *kb = b;
+	if (ka->key != kb->key) {
+		return ka->key < kb->key ? -1 : 1;
+	}
+	return ka->pos - kb->pos;
+}
+
+static int edge_ends_cmp(const void *a, const void *b) {
+	const EdgeEnds *ea = a, *eb = b;
+	return ea->up != eb->up ? ea->up - eb->up : ea->down - eb->down;
+}
+
+/* sorts the nodes of layer i by the keys already set, updating their positions */
+static void layer_sort_keys(const RzAGraph *g, int i, LayerKey *keys) {
+	struct layer_t *layer = &g->layers[i];
+	int j;
+	qsort(keys, layer->n_nodes, sizeof(LayerKey), layer_key_cmp);
+	for (j = 0; j < layer->n_nodes; j++) {
+		layer->nodes[j] = keys[j].gn;
+		get_anode(keys[j].gn)->pos_in_layer = j;
+	}
+}
+
+/* sorts layer i by the mean position of the neighbours of each node in the
+ * adjacent layer `other`, the nodes without any keeping their position */
+static void barycenter_sort(const RzAGraph *g, int i, int other, LayerKey *keys) {
+	const struct layer_t *layer = &g->layers[i];
+	int j;
+	for (j = 0; j < layer->n_nodes; j++) {
+		RzGraphNode *gn = layer->nodes[j];
+		const RzList *neigh = other > i ? rz_graph_get_neighbours(g->graph, gn) : rz_graph_innodes(g->graph, gn);
+		const RzListIter *it;
+		RzGraphNode *gk;
+		RzANode *ak;
+		double sum = 0;
+		int n = 0;
+		graph_foreach_anode (neigh, it, gk, ak) {
+			if (ak->layer == other) {
+				sum += ak->pos_in_layer;
+				n++;
+			}
+		}
+		keys[j].gn = gn;
+		keys[j].key = n ? sum / n : j;
+		keys[j].pos = j;
+	}
+	layer_sort_keys(g, i, keys);
+}
+
+/* crossings between the edges from layer i to layer i+1 */
+static ut64 layer_crossings(const RzAGraph *g, int i, EdgeEnds *ends, int *tree) {
+	const struct layer_t *layer = &g->layers[i];
+	const int n_down = g->layers[i + 1].n_nodes;
+	size_t j, n = 0;
+	for (j = 0; j < layer->n_nodes; j++) {
+		const RzList *neigh = rz_graph_get_neighbours(g->graph, layer->nodes[j]);
+		const RzListIter *it;
+		RzGraphNode *gk;
+		RzANode *ak;
+		graph_foreach_anode (neigh, it, gk, ak) {
+			if (ak->layer == i + 1) {
+				ends[n].up = j;
+				ends[n].down = ak->pos_in_layer;
+				n++;
+			}
+		}
+	}
+	qsort(ends, n, sizeof(EdgeEnds), edge_ends_cmp);
+	memset(tree, 0, sizeof(int) * (n_down + 1));
+	ut64 crossings = 0;
+	for (j = 0; j < n; j++) {
+		// edges seen so far ending at the left of this one, or at the same node
+		int x, left = 0;
+		for (x = ends[j].down + 1; x > 0; x -= x & -x) {
+			left += tree[x];
+		}
+		crossings += j - left;
+		for (x = ends[j].down + 1; x <= n_down; x += x & -x) {
+			tree[x]++;
+		}
+	}
+	return crossings;
+}
+
+static ut64 graph_crossings(const RzAGraph *g, EdgeEnds *ends, int *tree) {
+	ut64 crossings = 0;
+	int i;
+	for (i = 0; i < (int)g->n_layers - 1; i++) {
+		crossings += layer_crossings(g, i, ends, tree);
+	}
+	return crossings;
+}
+
+static void layers_save(const RzAGraph *g, RzGraphNode **order) {
+	unsigned int i;
+	for (i = 0; i < g->n_layers; i++) {
+		memcpy(order, g->layers[i].nodes, sizeof(RzGraphNode *) * g->layers[i].n_nodes);
+		order += g->layers[i].n_nodes;
+	}
+}
+
+static void layers_restore(const RzAGraph *g, RzGraphNode **order) {
+	unsigned int i;
+	int j;
+	for (i = 0; i < g->n_layers; i++) {
+		for (j = 0; j < g->layers[i].n_nodes; j++) {
+			g->layers[i].nodes[j] = *order++;
+			get_anode(g->layers[i].nodes[j])->pos_in_layer = j;
+		}
+	}
+}
+
+/* starts from the positions the nodes had in the previous layout of the
+ * graph, the new ones keeping their position among them */
+static void layout_cache_seed(const RzAGraph *g, LayoutCacheEntry *entry, LayerKey *keys) {
+	unsigned int i;
+	int j;
+	for (i = 0; i < g->n_layers; i++) {
+		for (j = 0; j < g->layers[i].n_nodes; j++) {
+			RzGraphNode *gn = g->layers[i].nodes[j];
+			RzANode *an = get_anode(gn);
+			bool found = false;
+			ut64 v = *an->title ? ht_pu_find(entry->pos, an->title, &found) : 0;
+			keys[j].gn = gn;
+			keys[j].key = found && (v >> 32) == i ? (double)(ut32)v : j + 0.5;
+			keys[j].pos = j;
+		}
+		layer_sort_keys(g, i, keys);
+	}
+}
+
+static void minimize_crossings_barycenter(const RzAGraph *g, LayoutCacheEntry *seed) {
+	const RzList *nodes = rz_graph_get_nodes(g->graph);
+	const RzListIter *it;
+	RzGraphNode *gn;
+	size_t n_nodes = 0, n_edges = 0;
+	int i, max_len = 0;
+
+	for (i = 0; i < (int)g->n_layers; i++) {
+		n_nodes += g->layers[i].n_nodes;
+		max_len = RZ_MAX(max_len, g->layers[i].n_nodes);
+	}
+	rz_list_foreach (nodes, it, gn) {
+		n_edges += rz_list_length(rz_graph_get_neighbours(g->graph, gn));
+	}
+	LayerKey *keys = RZ_NEWS(LayerKey, max_len + 1);
+	EdgeEnds *ends = RZ_NEWS(EdgeEnds, n_edges + 1);
+	int *tree = RZ_NEWS(int, max_len + 1);
+	RzGraphNode **best_order = RZ_NEWS(RzGraphNode *, n_nodes + 1);
+	if (!keys || !ends || !tree || !best_order) {
+		goto beach;
+	}
+
+	ut64 best = graph_crossings(g, ends, tree);
+	layers_save(g, best_order);
+	if (seed) {
+		layout_cache_seed(g, seed, keys);
+		ut64 crossings = graph_crossings(g, ends, tree);
+		if (crossings <= best) {
+			best = crossings;
+			layers_save(g, best_order);
+		}
+	}
+	int sweep, stale = 0;
+	for (sweep = 0; best && sweep < BARYCENTER_MAX_SWEEPS && stale < BARYCENTER_MAX_STALE; sweep++) {
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		if (sweep % 2) {
+			for (i = (int)g->n_layers - 2; i >= 0; i--) {
+				barycenter_sort(g, i, i + 1, keys);
+			}
+		} else {
+			for (i = 1; i < (int)g->n_layers; i++) {
+				barycenter_sort(g, i, i - 1, keys);
+			}
+		}
+		ut64 crossings = graph_crossings(g, ends, tree);
+		if (crossings < best) {
+			best = crossings;
+			layers_save(g, best_order);
+			stale = 0;
+		} else {
+			stale++;
+		}
+	}
+	layers_restore(g, best_order);
+
+beach:
+	free(keys);
+	free(ends);
+	free(tree);
+	free(best_order);
+}
+
+static void layout_cache_entry_free(LayoutCacheEntry *entry) {
+	if (!entry) {
+		return;
+	}
+	free(entry->order);
+	ht_pu_free(entry->pos);
+	free(entry);
+}
+
+static void layout_cache_kv_free(HtPPKv *kv) {
+	free(kv->key);
+	layout_cache_entry_free(kv->value);
+}
+
+RZ_API RzAGraphLayoutCache *rz_agraph_layout_cache_new(void) {
+	RzAGraphLayoutCache *cache = RZ_NEW0(RzAGraphLayoutCache);
+	if (!cache) {
+		return NULL;
+	}
+	cache->entries = ht_pp_new(NULL, layout_cache_kv_free, NULL);
+	if (!cache->entries) {
+		free(cache);
+		return NULL;
+	}
+	return cache;
+}
+
+RZ_API void rz_agraph_layout_cache_free(RzAGraphLayoutCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_pp_free(cache->entries);
+	free(cache);
+}
+
+/* identifies the layered graph, dummy nodes included */
+static ut64 layout_signature(const RzAGraph *g) {
+	const ut64 prime = 0x100000001b3ULL;
+	const RzList *nodes = rz_graph_get_nodes(g->graph);
+	const RzListIter *it, *itk;
+	RzGraphNode *gn, *gk;
+	RzANode *an;
+	ut64 sig = 0xcbf29ce484222325ULL;
+	graph_foreach_anode (nodes, it, gn, an) {
+		sig = (sig ^ rz_hash_xxhash((const ut8 *)an->title, strlen(an->title))) * prime;
+		sig = (sig ^ (ut32)an->layer) * prime;
+		rz_list_foreach (rz_graph_get_neighbours(g->graph, gn), itk, gk) {
+			sig = (sig ^ gk->idx) * prime;
+		}
+		sig = (sig ^ UT32_MAX) * prime;
+	}
+	return sig;
+}
+
+/* applies the order of the previous layout of the very same graph */
+static bool layout_cache_apply(const RzAGraph *g, LayoutCacheEntry *entry, ut64 sig) {
+	const RzList *nodes = rz_graph_get_nodes(g->graph);
+	if (entry->sig != sig || entry->n_nodes != rz_list_length(nodes)) {
+		return false;
+	}
+	const RzListIter *it;
+	RzGraphNode *gn;
+	RzANode *an;
+	size_t k = 0;
+	unsigned int i;
+	// check that the order is a permutation of each layer before touching them
+	int *base = RZ_NEWS0(int, g->n_layers + 1);
+	bool *used = RZ_NEWS0(bool, entry->n_nodes + 1);
+	bool ok = base && used;
+	for (i = 0; ok && i < g->n_layers; i++) {
+		base[i + 1] = base[i] + g->layers[i].n_nodes;
+	}
+	graph_foreach_anode (nodes, it, gn, an) {
+		if (!ok) {
+			break;
+		}
+		int pos = entry->order[k++];
+		if (an->layer < 0 || an->layer >= (int)g->n_layers || pos < 0 || pos >= g->layers[an->layer].n_nodes || used[base[an->layer] + pos]) {
+			ok = false;
+			break;
+		}
+		used[base[an->layer] + pos] = true;
+	}
+	if (ok) {
+		k = 0;
+		graph_foreach_anode (nodes, it, gn, an) {
+			an->pos_in_layer = entry->order[k++];
+			g->layers[an->layer].nodes[an->pos_in_layer] = gn;
+		}
+	}
+	free(base);
+	free(used);
+	return ok;
+}
+
+static void layout_cache_store(RzAGraphLayoutCache *cache, const char *key, const RzAGraph *g, ut64 sig) {
+	const RzList *nodes = rz_graph_get_nodes(g->graph);
+	const RzListIter *it;
+	RzGraphNode *gn;
+	RzANode *an;
+	LayoutCacheEntry *entry = RZ_NEW0(LayoutCacheEntry);
+	if (!entry) {
+		return;
+	}
+	entry->sig = sig;
+	entry->n_nodes = rz_list_length(nodes);
+	entry->order = RZ_NEWS(int, entry->n_nodes + 1);
+	entry->pos = ht_pu_new0();
+	if (!entry->order || !entry->pos) {
+		layout_cache_entry_free(entry);
+		return;
+	}
+	size_t k = 0;
+	graph_foreach_anode (nodes, it, gn, an) {
+		entry->order[k++] = an->pos_in_layer;
+		if (*an->title) {
+			ht_pu_insert(entry->pos, an->title, ((ut64)(ut32)an->layer << 32) | (ut32)an->pos_in_layer);
+		}
+	}
+	if (ht_pp_delete(cache->entries, key)) {
+		cache->n_entries--;
+	}
+	if (cache->n_entries >= LAYOUT_CACHE_MAX) {
+		ht_pp_free(cache->entries);
+		cache->entries = ht_pp_new(NULL, layout_cache_kv_free, NULL);
+		cache->n_entries = 0;
+		if (!cache->entries) {
+			layout_cache_entry_free(entry);
+			return;
+		}
+	}
+	if (ht_pp_insert(cache->entries, key, entry)) {
+		cache->n_entries++;
+	} else {
+		layout_cache_entry_free(entry);
+	}
+}
+
+/* orders the nodes of each layer with the algorithm picked by g->crossing,
+ * starting from the order of the previous layout of the graph if any */
+static void reduce_crossings(const RzAGraph *g) {
+	RzAGraphCrossing crossing = g->crossing;
+	if (crossing == RZ_AGRAPH_CROSSING_AUTO) {
+		size_t n_nodes = rz_list_length(rz_graph_get_nodes(g->graph));
+		crossing = n_nodes > SWEEP_MAX_NODES ? RZ_AGRAPH_CROSSING_BARYCENTER : RZ_AGRAPH_CROSSING_SWEEP;
+	}
+	if (crossing == RZ_AGRAPH_CROSSING_SWEEP) {
+		minimize_crossings(g);
+		return;
+	}
+	RzAGraphLayoutCache *cache = g->layout_cache;
+	RzANode *first = rz_agraph_get_first_node(g);
+	if (!cache || !cache->entries || !first || !*first->title) {
+		minimize_crossings_barycenter(g, NULL);
+		return;
+	}
+	ut64 sig = layout_signature(g);
+	LayoutCacheEntry *entry = ht_pp_find(cache->entries, first->title, NULL);
+	if (!entry || !layout_cache_apply(g, entry, sig)) {
+		minimize_crossings_barycenter(g, entry);
+		layout_cache_store(cache, first->title, g, sig);
+	}
+}
+
 static int find_dist(const struct dist_t *a, const struct dist_t *b) {
 	return a->from == b->from && a->to == b->to ? 0 : 1;
 }
@@ -1965,7 +2361,7 @@ static void set_layout(RzAGraph *g) {
 	assign_layers(g);
 	create_dummy_nodes(g);
 	create_layers(g);
-	minimize_crossings(g);
+	reduce_crossings(g);
 
 	if (rz_cons_is_breaked()) {
 		rz_cons_break_end();
@@ -4169,6 +4565,8 @@ RZ_API int rz_core_visual_graph(RzCore *core, RzAGraph *g, RzAnalysisFunction *_
 		}
 		g->is_tiny = is_interactive == 2;
 		g->layout = rz_config_get_i(core->config, "graph.layout");
+		g->crossing = core->graph->crossing;
+		g->layout_cache = core->graph_layouts;
 		g->dummy = rz_config_get_i(core->config, "graph.dummy");
 		g->show_node_titles = rz_config_get_i(core->config, "graph.ntitles");
 	} else {
@@ -7,8 +7,17 @@
 #include <rz_util.h>
 #include <ht_uu.h>
 #include <rz_core.h>
+
+#include "core_private.h"
+
 #define LOOP_MAX 10
 
+static bool analysis_emul_stack_initialized(RzReg *reg) {
+	const char *bp = rz_reg_get_name(reg, RZ_REG_NAME_BP);
+	const char *sp = rz_reg_get_name(reg, RZ_REG_NAME_SP);
+	return !((bp && !rz_reg_getv(reg, bp)) && (sp && !rz_reg_getv(reg, sp)));
+}
+
 static bool analysis_emul_init(RzCore *core, RzConfigHold *hc, RzDebugTrace **dt, RzAnalysisEsilTrace **et, RzAnalysisRzilTrace **rt) {
 	if (!core->analysis->esil) {
 		return false;
@@ -25,9 +34,7 @@ static bool analysis_emul_init(RzCore *core, RzConfigHold *hc, RzDebugTrace **dt
 	rz_config_set(core->config, "dbg.trace", "true");
 	rz_config_set(core->config, "esil.nonull", "true");
 	rz_config_set_i(core->config, "dbg.follow", false);
-	const char *bp = rz_reg_get_name(core->analysis->reg, RZ_REG_NAME_BP);
-	const char *sp = rz_reg_get_name(core->analysis->reg, RZ_REG_NAME_SP);
-	if ((bp && !rz_reg_getv(core->analysis->reg, bp)) && (sp && !rz_reg_getv(core->analysis->reg, sp))) {
+	if (!analysis_emul_stack_initialized(core->analysis->reg)) {
 		eprintf("Stack isn't initialized.\n");
 		eprintf("Try running aei and aeim commands before aft for default stack initialization\n");
 		return false;
@@ -44,11 +51,8 @@ static void analysis_emul_restore(RzCore *core, RzConfigHold *hc, RzDebugTrace *
 	core->dbg->trace = dt;
 }
 
-static bool type_pos_hit(RzAnalysis *analysis, RzILTraceInstruction *instr_trace, bool in_stack, int size, const char *place) {
+static bool type_pos_hit(RzILTraceInstruction *instr_trace, bool in_stack, int size, const char *place, ut64 sp) {
 	if (in_stack) {
-		const char *sp_name = rz_reg_get_name(analysis->reg, RZ_REG_NAME_SP);
-		ut64 sp = rz_reg_getv(analysis->reg, sp_name);
-
 		ut64 write_addr = 0LL;
 		if (instr_trace && (instr_trace->stats & RZ_IL_TRACE_INS_HAS_MEM_W)) {
 			// TODO : This assumes an op will only write to memory once
@@ -197,12 +201,11 @@ static void get_src_regname(RzCore *core, ut64 addr, char *regname, int size) {
 	rz_analysis_op_free(op);
 }
 
-static ut64 get_addr(RzAnalysis *analysis, const char *regname, int idx) {
+static ut64 get_addr(RzAnalysisEsilTrace *etrace, const char *regname, int idx) {
 	if (!regname || !*regname) {
 		return UT64_MAX;
 	}
 
-	RzAnalysisEsilTrace *etrace = analysis->esil->trace;
 	RzILTraceInstruction *instruction_trace = rz_analysis_esil_get_instruction_trace(etrace, idx);
 	RzILTraceRegOp *reg_op = rz_analysis_il_get_reg_op_trace(instruction_trace, regname, false);
 
@@ -331,6 +334,21 @@ bool function_argument_type_derive(RZ_NULLABLE const RzCallable *callable, int a
 #define REGNAME_SIZE 10
 #define MAX_INSTR    5
 
+struct ReturnTypeAnalysisCtx {
+	bool resolved;
+	RzType *ret_type;
+	char *ret_reg;
+};
+
+struct TypeAnalysisCtx {
+	struct ReturnTypeAnalysisCtx *retctx;
+	RzAnalysisEsilTrace *etrace; ///< trace of the emulation of the function
+	int cur_idx; ///< index in \p etrace of the current instruction
+	ut64 sp; ///< stack pointer after the emulation of the current instruction
+	const char *prev_dest;
+	bool str_flag;
+};
+
 /**
  * type match at a call instruction inside another function
  *
@@ -341,15 +359,16 @@ bool function_argument_type_derive(RZ_NULLABLE const RzCallable *callable, int a
  * \param prev_idx index in the esil trace
  * \param userfnc whether the callee is a user function (affects propagation direction)
  * \param caddr addr of the callee
+ * \param ctx trace and index of the call instruction
  */
 static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, const char *cc,
-	int prev_idx, bool userfnc, ut64 caddr, HtUP *op_cache) {
-	RzAnalysisEsilTrace *etrace = core->analysis->esil->trace;
+	int prev_idx, bool userfnc, ut64 caddr, HtUP *op_cache, const struct TypeAnalysisCtx *ctx) {
+	RzAnalysisEsilTrace *etrace = ctx->etrace;
 	RzTypeDB *typedb = core->analysis->typedb;
 	RzAnalysis *analysis = core->analysis;
 	RzList *types = NULL;
 
-	int idx = rz_pvector_len(etrace->instructions) - 1;
+	int idx = ctx->cur_idx;
 
 	bool verbose = rz_config_get_i(core->config, "analysis.types.verbose");
 	bool stack_rev = false, in_stack = false, format = false;
@@ -440,7 +459,7 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 				memref = !(!memref && var && (var->kind != RZ_ANALYSIS_VAR_KIND_REG));
 			}
 			// Match type from function param to instr
-			if (type_pos_hit(analysis, instr_trace, in_stack, size, place)) {
+			if (type_pos_hit(instr_trace, in_stack, size, place, ctx->sp)) {
 				if (!cmt_set && type && name) {
 					char *typestr = rz_type_as_string(analysis->typedb, type);
 					const char *maybe_space = type->kind == RZ_TYPE_KIND_POINTER ? "" : " ";
@@ -475,7 +494,7 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 					res = true;
 				} else {
 					get_src_regname(core, instr_addr, regname, sizeof(regname));
-					xaddr = get_addr(analysis, regname, j);
+					xaddr = get_addr(etrace, regname, j);
 				}
 			}
 			// Type propagate by following source reg
@@ -506,7 +525,7 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 			} else if (var && res && xaddr && (xaddr != UT64_MAX)) { // Type progation using value
 				char tmp[REGNAME_SIZE] = { 0 };
 				get_src_regname(core, instr_addr, tmp, sizeof(tmp));
-				ut64 ptr = get_addr(analysis, tmp, j);
+				ut64 ptr = get_addr(etrace, tmp, j);
 				if (ptr == xaddr) {
 					if (type) {
 						var_type_set_resolve_overlaps(analysis, var, type, memref);
@@ -527,19 +546,12 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 	rz_cons_break_pop();
 }
 
-static int bb_cmpaddr(const void *_a, const void *_b) {
-	const RzAnalysisBlock *a = _a, *b = _b;
-	return a->addr > b->addr ? 1 : (a->addr < b->addr ? -1 : 0);
-}
-
 void free_op_cache_kv(HtUPKv *kv) {
 	rz_analysis_op_free(kv->value);
 }
 
-void handle_stack_canary(RzCore *core, RzAnalysisOp *aop, int cur_idx) {
-	RzILTraceInstruction *prev_trace = rz_analysis_esil_get_instruction_trace(
-		core->analysis->esil->trace,
-		cur_idx - 1);
+void handle_stack_canary(RzCore *core, RzAnalysisEsilTrace *etrace, RzAnalysisOp *aop, int cur_idx) {
+	RzILTraceInstruction *prev_trace = rz_analysis_esil_get_instruction_trace(etrace, cur_idx - 1);
 
 	ut64 mov_addr;
 	if (prev_trace) {
@@ -559,12 +571,6 @@ void handle_stack_canary(RzCore *core, RzAnalysisOp *aop, int cur_idx) {
 	rz_analysis_op_free(mop);
 }
 
-struct ReturnTypeAnalysisCtx {
-	bool resolved;
-	RzType *ret_type;
-	char *ret_reg;
-};
-
 static inline bool return_type_analysis_context_unresolved(struct ReturnTypeAnalysisCtx *ctx) {
 	return !ctx->resolved && ctx->ret_type && ctx->ret_reg;
 }
@@ -626,13 +632,6 @@ static void propagate_return_type(RzCore *core, RzAnalysisOp *aop, RzAnalysisOp
 	}
 }
 
-struct TypeAnalysisCtx {
-	struct ReturnTypeAnalysisCtx *retctx;
-	int cur_idx;
-	const char *prev_dest;
-	bool str_flag;
-};
-
 void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalysisFunction *fcn, RzAnalysisBlock *bb, RzAnalysisOp *aop, struct TypeAnalysisCtx *ctx) {
 	RzPVector *used_vars = rz_analysis_function_get_vars_used_at(fcn, aop->addr);
 	bool chk_constraint = rz_config_get_b(core->config, "analysis.types.constraint");
@@ -647,8 +646,7 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 	ut32 type = aop->type & RZ_ANALYSIS_OP_TYPE_MASK;
 	RzAnalysis *analysis = core->analysis;
 
-	RzAnalysisEsilTrace *etrace = core->analysis->esil->trace;
-	RzILTraceInstruction *cur_instr_trace = rz_analysis_esil_get_instruction_trace(etrace, ctx->cur_idx);
+	RzILTraceInstruction *cur_instr_trace = rz_analysis_esil_get_instruction_trace(ctx->etrace, ctx->cur_idx);
 
 	if (aop->type == RZ_ANALYSIS_OP_TYPE_CALL || aop->type & RZ_ANALYSIS_OP_TYPE_UCALL) {
 		char *full_name = NULL;
@@ -681,7 +679,7 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 			const char *Cc = rz_analysis_cc_func(core->analysis, fcn_name);
 			if (Cc && rz_analysis_cc_exist(core->analysis, Cc)) {
 				char *cc = strdup(Cc);
-				type_match(core, fcn_name, aop->addr, bb->addr, cc, prev_idx, userfnc, callee_addr, op_cache);
+				type_match(core, fcn_name, aop->addr, bb->addr, cc, prev_idx, userfnc, callee_addr, op_cache, ctx);
 				prev_idx = ctx->cur_idx;
 				ctx->retctx->ret_type = rz_type_func_ret(core->analysis->typedb, fcn_name);
 				RZ_FREE(ctx->retctx->ret_reg);
@@ -693,7 +691,7 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 				free(cc);
 			}
 			if (!strcmp(fcn_name, "__stack_chk_fail")) {
-				handle_stack_canary(core, aop, ctx->cur_idx);
+				handle_stack_canary(core, ctx->etrace, aop, ctx->cur_idx);
 			}
 			free(fcn_name);
 		}
@@ -813,83 +811,124 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 	}
 }
 
-RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *loop_table) {
-	RzListIter *it;
+/**
+ * Instruction reached by the emulation of a function. The types are
+ * propagated afterwards from the steps, in their order.
+ */
+typedef struct {
+	RzAnalysisBlock *bb;
+	ut64 addr; ///< address of the instruction
+	int trace_idx; ///< index of the last instruction of the esil trace after the step
+	ut64 sp; ///< stack pointer after the step
+} TypeMatchStep;
 
-	rz_return_if_fail(core && core->analysis && fcn);
+/**
+ * Emulation of a function, kept until the types are propagated from it
+ */
+typedef struct {
+	RzAnalysisFunction *fcn;
+	RzAnalysisEsilTrace *trace;
+	HtUP /*<ut64, RzAnalysisOp *>*/ *op_cache;
+	RzVector /*<TypeMatchStep>*/ steps;
+} TypeMatchFcn;
 
-	if (!core->analysis->esil) {
-		eprintf("Please run aeim\n");
-		return;
-	}
+/**
+ * Registers, esil and memory functions are emulated with: the ones of the
+ * core, or the isolated ones of a worker thread when io_lock is set.
+ */
+typedef struct {
+	RzCore *core;
+	RzAnalysis *analysis; ///< core->analysis, or the decoder of the worker
+	RzAnalysisEsil *esil;
+	RzThreadLock *io_lock; ///< held by the workers when reading the io of the core
+	HtUP /*<ut64, ut8 *>*/ *pages; ///< memory written by the function of a worker, by page number
+	bool nonull;
+} TypeMatchEmu;
 
-	RzAnalysis *analysis = core->analysis;
-	RzReg *reg = analysis->reg;
-	const int mininstrsz = rz_analysis_archinfo(analysis, RZ_ANALYSIS_ARCHINFO_MIN_OP_SIZE);
-	const int minopcode = RZ_MAX(1, mininstrsz);
-	RzConfigHold *hc = rz_config_hold_new(core->config);
-	if (!hc) {
-		return;
+#define TYPE_MATCH_PAGE_SIZE 0x1000
+
+static bool type_match_fcn_init(TypeMatchFcn *tm, RzAnalysisFunction *fcn) {
+	tm->fcn = fcn;
+	tm->trace = NULL;
+	rz_vector_init(&tm->steps, sizeof(TypeMatchStep), NULL, NULL);
+	tm->op_cache = ht_up_new(NULL, free_op_cache_kv, NULL);
+	return tm->op_cache != NULL;
+}
+
+static void type_match_fcn_fini(TypeMatchFcn *tm) {
+	rz_analysis_esil_trace_free(tm->trace);
+	ht_up_free(tm->op_cache);
+	rz_vector_fini(&tm->steps);
+}
+
+static RzAnalysisOp *type_match_emu_op(TypeMatchEmu *emu, HtUP *op_cache, ut64 addr) {
+	if (!emu->io_lock) {
+		return op_cache_get(op_cache, emu->core, addr);
 	}
-	RzDebugTrace *dt = NULL;
-	RzAnalysisEsilTrace *et = NULL;
-	RzAnalysisRzilTrace *rt = NULL;
-	if (!analysis_emul_init(core, hc, &dt, &et, &rt) || !fcn) {
-		analysis_emul_restore(core, hc, dt, et, rt);
-		return;
+	RzAnalysisOp *op = ht_up_find(op_cache, addr, NULL);
+	if (op) {
+		return op;
 	}
+	ut8 buf[32];
+	rz_th_lock_enter(emu->io_lock);
+	bool read = rz_io_read_at(emu->core->io, addr, buf, sizeof(buf));
+	rz_th_lock_leave(emu->io_lock);
+	if (!read || !(op = rz_analysis_op_new())) {
+		return NULL;
+	}
+	// the esil is decoded along, as the worker steps from the cached ops
+	if (rz_analysis_op(emu->analysis, op, addr, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_ESIL) < 1 ||
+		!ht_up_insert(op_cache, addr, op)) {
+		rz_analysis_op_free(op);
+		return NULL;
+	}
+	return op;
+}
 
-	// Reserve bigger ht to avoid rehashing
-	HtPPOptions opt;
-	RzDebugTrace *dtrace = core->dbg->trace;
-	opt = dtrace->ht->opt;
-	ht_pp_free(dtrace->ht);
-	dtrace->ht = ht_pp_new_size(fcn->ninstr, opt.dupvalue, opt.freefn, opt.calcsizeV);
-	dtrace->ht->opt = opt;
-
-	// Create a new context to store the return type propagation state
-	struct ReturnTypeAnalysisCtx retctx = {
-		.resolved = false,
-		.ret_type = NULL,
-		.ret_reg = NULL,
-	};
-	struct TypeAnalysisCtx ctx = {
-		.retctx = &retctx,
-		.cur_idx = 0,
-		.prev_dest = NULL,
-		.str_flag = false
-	};
+static void type_match_emu_step(TypeMatchEmu *emu, RzRegItem *pc, RzAnalysisOp *aop) {
+	if (!emu->io_lock) {
+		rz_core_esil_step(emu->core, UT64_MAX, NULL, NULL, false);
+		return;
+	}
+	// same as rz_core_esil_step() with dbg.trace set, without hints nor delay slots
+	emu->esil->trap = 0;
+	rz_reg_set_value(emu->analysis->reg, pc, aop->addr + aop->size);
+	rz_analysis_esil_set_pc(emu->esil, aop->addr);
+	rz_analysis_esil_trace_op(emu->esil, aop);
+}
 
-	HtUP *op_cache = NULL;
+/**
+ * Emulates the blocks of \p tm->fcn in address order, recording the steps
+ * to propagate the types from into \p tm.
+ */
+static bool type_match_emulate(TypeMatchEmu *emu, TypeMatchFcn *tm, HtUU *loop_table) {
+	RzReg *reg = emu->analysis->reg;
+	const int mininstrsz = rz_analysis_archinfo(emu->analysis, RZ_ANALYSIS_ARCHINFO_MIN_OP_SIZE);
+	const int minopcode = RZ_MAX(1, mininstrsz);
+	const char *sp = rz_reg_get_name(reg, RZ_REG_NAME_SP);
 	const char *pc = rz_reg_get_name(reg, RZ_REG_NAME_PC);
 	if (!pc) {
-		goto out_function;
+		return false;
 	}
 	RzRegItem *r = rz_reg_get(reg, pc, -1);
 	if (!r) {
-		goto out_function;
+		return false;
 	}
-	rz_cons_break_push(NULL, NULL);
-	rz_list_sort(fcn->bbs, bb_cmpaddr);
 	// TODO: The algorithm can be more accurate if blocks are followed by their jmp/fail, not just by address
+	RzListIter *it;
 	RzAnalysisBlock *bb;
-	rz_list_foreach (fcn->bbs, it, bb) {
+	rz_list_foreach (tm->fcn->bbs, it, bb) {
 		ut64 addr = bb->addr;
 		rz_reg_set_value(reg, r, addr);
-		ht_up_free(op_cache);
-		op_cache = ht_up_new(NULL, free_op_cache_kv, NULL);
-		if (!op_cache) {
-			break;
-		}
 		while (1) {
 			if (rz_cons_is_breaked()) {
-				goto out_function;
+				return true;
 			}
 			ut64 pcval = rz_reg_getv(reg, pc);
 			if ((addr >= bb->addr + bb->size) || (addr < bb->addr) || pcval != addr) {
 				break;
 			}
-			RzAnalysisOp *aop = op_cache_get(op_cache, core, addr);
+			RzAnalysisOp *aop = type_match_emu_op(emu, tm->op_cache, addr);
 			if (!aop) {
 				break;
 			}
@@ -913,32 +952,73 @@ RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, H
 			if (rz_analysis_op_nonlinear(aop->type)) { // skip the instr
 				rz_reg_set_value(reg, r, addr + aop->size);
 			} else {
-				rz_core_esil_step(core, UT64_MAX, NULL, NULL, false);
+				type_match_emu_step(emu, r, aop);
 			}
 
-			RzPVector *ins_traces = analysis->esil->trace->instructions;
-			ctx.cur_idx = rz_pvector_len(ins_traces) - 1;
-			RzList *fcns = rz_analysis_get_functions_in(analysis, aop->addr);
-			if (!fcns) {
-				break;
-			}
-			RzListIter *it;
-			RzAnalysisFunction *fcn;
-			rz_list_foreach (fcns, it, fcn) {
-				propagate_types_among_used_variables(core, op_cache, fcn, bb, aop, &ctx);
+			TypeMatchStep *step = rz_vector_push(&tm->steps, NULL);
+			if (!step) {
+				return true;
 			}
+			step->bb = bb;
+			step->addr = aop->addr;
+			step->trace_idx = rz_pvector_len(tm->trace->instructions) - 1;
+			step->sp = sp ? rz_reg_getv(reg, sp) : 0;
 			addr += aop->size;
-			rz_list_free(fcns);
 		}
 	}
+	return true;
+}
+
+/**
+ * Propagates the types of the variables from the steps of the emulation
+ * of \p tm->fcn, then between its register based args and local vars.
+ */
+static void type_match_propagate(RzCore *core, TypeMatchFcn *tm) {
+	RzAnalysis *analysis = core->analysis;
+	// Create a new context to store the return type propagation state
+	struct ReturnTypeAnalysisCtx retctx = {
+		.resolved = false,
+		.ret_type = NULL,
+		.ret_reg = NULL,
+	};
+	struct TypeAnalysisCtx ctx = {
+		.retctx = &retctx,
+		.etrace = tm->trace,
+		.cur_idx = 0,
+		.sp = 0,
+		.prev_dest = NULL,
+		.str_flag = false
+	};
+	TypeMatchStep *step;
+	rz_vector_foreach (&tm->steps, step) {
+		if (rz_cons_is_breaked()) {
+			goto out_function;
+		}
+		RzAnalysisOp *aop = op_cache_get(tm->op_cache, core, step->addr);
+		if (!aop) {
+			continue;
+		}
+		ctx.cur_idx = step->trace_idx;
+		ctx.sp = step->sp;
+		RzList *fcns = rz_analysis_get_functions_in(analysis, aop->addr);
+		if (!fcns) {
+			continue;
+		}
+		RzListIter *it;
+		RzAnalysisFunction *fcn;
+		rz_list_foreach (fcns, it, fcn) {
+			propagate_types_among_used_variables(core, tm->op_cache, fcn, step->bb, aop, &ctx);
+		}
+		rz_list_free(fcns);
+	}
 
 	// Type propagation for register based args
 	void **vit;
-	rz_pvector_foreach (&fcn->vars, vit) {
+	rz_pvector_foreach (&tm->fcn->vars, vit) {
 		RzAnalysisVar *rvar = *vit;
 		if (rvar->kind == RZ_ANALYSIS_VAR_KIND_REG) {
 			RzAnalysisVar *lvar = rz_analysis_var_get_dst_var(rvar);
-			RzRegItem *i = rz_reg_index_get(reg, rvar->delta);
+			RzRegItem *i = rz_reg_index_get(analysis->reg, rvar->delta);
 			if (!i) {
 				continue;
 			}
@@ -952,10 +1032,346 @@ RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, H
 			}
 		}
 	}
-	vars_resolve_overlaps(&fcn->vars);
+	vars_resolve_overlaps(&tm->fcn->vars);
 out_function:
 	free(retctx.ret_reg);
-	ht_up_free(op_cache);
-	rz_cons_break_pop();
+}
+
+RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *loop_table) {
+	rz_return_if_fail(core && core->analysis && fcn);
+
+	if (!core->analysis->esil) {
+		eprintf("Please run aeim\n");
+		return;
+	}
+
+	RzConfigHold *hc = rz_config_hold_new(core->config);
+	if (!hc) {
+		return;
+	}
+	RzDebugTrace *dt = NULL;
+	RzAnalysisEsilTrace *et = NULL;
+	RzAnalysisRzilTrace *rt = NULL;
+	if (!analysis_emul_init(core, hc, &dt, &et, &rt) || !fcn) {
+		analysis_emul_restore(core, hc, dt, et, rt);
+		return;
+	}
+
+	// Reserve bigger ht to avoid rehashing
+	RzDebugTrace *dtrace = core->dbg->trace;
+	HtUP *by_addr = ht_up_new_size(fcn->ninstr, NULL, NULL, NULL);
+	if (by_addr && !ht_up_insert(dtrace->ht, dtrace->tag, by_addr)) {
+		ht_up_free(by_addr);
+	}
+
+	TypeMatchEmu emu = {
+		.core = core,
+		.analysis = core->analysis,
+		.esil = core->analysis->esil,
+	};
+	TypeMatchFcn tm;
+	if (type_match_fcn_init(&tm, fcn)) {
+		tm.trace = core->analysis->esil->trace;
+		rz_cons_break_push(NULL, NULL);
+		rz_list_sort(fcn->bbs, bb_cmpaddr);
+		if (type_match_emulate(&emu, &tm, loop_table)) {
+			type_match_propagate(core, &tm);
+		}
+		rz_cons_break_pop();
+		// owned by the esil, freed when restored
+		tm.trace = NULL;
+	}
+	type_match_fcn_fini(&tm);
 	analysis_emul_restore(core, hc, dt, et, rt);
 }
+
+static void page_kv_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+/**
+ * Page of the memory written by the function emulated by \p emu, holding
+ * the bytes of the io until written.
+ */
+static ut8 *type_match_emu_page(TypeMatchEmu *emu, ut64 page) {
+	ut8 *data = ht_up_find(emu->pages, page, NULL);
+	if (data) {
+		return data;
+	}
+	data = malloc(TYPE_MATCH_PAGE_SIZE);
+	if (!data) {
+		return NULL;
+	}
+	rz_th_lock_enter(emu->io_lock);
+	(void)rz_io_read_at(emu->core->io, page * TYPE_MATCH_PAGE_SIZE, data, TYPE_MATCH_PAGE_SIZE);
+	rz_th_lock_leave(emu->io_lock);
+	if (!ht_up_insert(emu->pages, page, data)) {
+		free(data);
+		return NULL;
+	}
+	return data;
+}
+
+static int type_match_emu_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int len) {
+	TypeMatchEmu *emu = esil->user;
+	addr &= esil->addrmask;
+	rz_th_lock_enter(emu->io_lock);
+	(void)rz_io_read_at(emu->core->io, addr, buf, len);
+	bool valid = rz_io_is_valid_offset(emu->core->io, addr, false);
+	rz_th_lock_leave(emu->io_lock);
+	for (int done = 0; done < len;) {
+		const ut64 cur = addr + done;
+		const int chunk = RZ_MIN(TYPE_MATCH_PAGE_SIZE - cur % TYPE_MATCH_PAGE_SIZE, len - done);
+		const ut8 *data = ht_up_find(emu->pages, cur / TYPE_MATCH_PAGE_SIZE, NULL);
+		if (data) {
+			memcpy(buf + done, data + cur % TYPE_MATCH_PAGE_SIZE, chunk);
+		}
+		done += chunk;
+	}
+	if (!valid && esil->iotrap) {
+		esil->trap = RZ_ANALYSIS_TRAP_READ_ERR;
+		esil->trap_code = addr;
+	}
+	return len;
+}
+
+static int type_match_emu_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf, int len) {
+	TypeMatchEmu *emu = esil->user;
+	if (esil->nowrite || (emu->nonull && !addr)) {
+		return 0;
+	}
+	addr &= esil->addrmask;
+	rz_th_lock_enter(emu->io_lock);
+	bool valid = rz_io_is_valid_offset(emu->core->io, addr, false);
+	rz_th_lock_leave(emu->io_lock);
+	if (!valid) {
+		if (esil->iotrap) {
+			esil->trap = RZ_ANALYSIS_TRAP_WRITE_ERR;
+			esil->trap_code = addr;
+		}
+		return 0;
+	}
+	for (int done = 0; done < len;) {
+		const ut64 cur = addr + done;
+		const int chunk = RZ_MIN(TYPE_MATCH_PAGE_SIZE - cur % TYPE_MATCH_PAGE_SIZE, len - done);
+		ut8 *data = type_match_emu_page(emu, cur / TYPE_MATCH_PAGE_SIZE);
+		if (!data) {
+			return done;
+		}
+		memcpy(data + cur % TYPE_MATCH_PAGE_SIZE, buf + done, chunk);
+		done += chunk;
+	}
+	return len;
+}
+
+/**
+ * Sets up \p emu with registers, an esil and a memory of its own, so that
+ * a worker can emulate functions while the others do. The memory reads
+ * the io of the core, the writes being kept in pages until the next
+ * function is emulated.
+ *
+ * Like analysis_emul_init(), esil.nonull is forced and every step is
+ * traced as with dbg.trace. The memory stays writable, as the esil of the
+ * core is: esil.romem is only read when an esil is set up.
+ */
+static bool type_match_emu_init_isolated(TypeMatchEmu *emu, RzCore *core, RzThreadLock *io_lock) {
+	RzAnalysis *analysis = core->analysis;
+	emu->core = core;
+	emu->io_lock = io_lock;
+	emu->nonull = true;
+	emu->pages = ht_up_new(NULL, page_kv_free, NULL);
+	emu->analysis = rz_analysis_new_decoder(analysis);
+	if (!emu->pages || !emu->analysis || !analysis->reg->reg_profile_str ||
+		!rz_reg_set_profile_string(emu->analysis->reg, analysis->reg->reg_profile_str)) {
+		return false;
+	}
+	RzRegSet *a = rz_reg_regset_get(analysis->reg, RZ_REG_TYPE_GPR);
+	RzRegSet *b = rz_reg_regset_get(emu->analysis->reg, RZ_REG_TYPE_GPR);
+	if (!a || !b || !a->arena || !b->arena || a->arena->size != b->arena->size) {
+		return false;
+	}
+	// only read by rz_analysis_esil_trace_new(), with io_lock held
+	emu->analysis->iob = analysis->iob;
+	emu->esil = rz_analysis_esil_new(rz_config_get_i(core->config, "esil.stack.depth"),
+		rz_config_get_i(core->config, "esil.iotrap"), rz_config_get_i(core->config, "esil.addr.size"));
+	if (!emu->esil || !rz_analysis_esil_setup(emu->esil, emu->analysis, false, false, emu->nonull)) {
+		return false;
+	}
+	emu->esil->user = emu;
+	emu->esil->cb.mem_read = type_match_emu_mem_read;
+	emu->esil->cb.mem_write = type_match_emu_mem_write;
+	emu->esil->stack_addr = analysis->esil->stack_addr;
+	emu->esil->stack_size = analysis->esil->stack_size;
+	return true;
+}
+
+static void type_match_emu_fini_isolated(TypeMatchEmu *emu) {
+	rz_analysis_esil_free(emu->esil);
+	rz_analysis_free(emu->analysis);
+	ht_up_free(emu->pages);
+}
+
+/**
+ * Functions emulated by the workers, then propagated from the main thread
+ */
+typedef struct {
+	RzThreadLock *lock; ///< guards next and the io of the core
+	const ut8 *arena; ///< registers every function is emulated from
+	TypeMatchFcn *fcns;
+	size_t count;
+	size_t next; ///< next function to emulate
+} TypeMatchRound;
+
+typedef struct {
+	TypeMatchRound *round;
+	TypeMatchEmu emu;
+} TypeMatchWorker;
+
+static void type_match_emulate_isolated(TypeMatchEmu *emu, TypeMatchFcn *tm, const ut8 *arena) {
+	rz_reg_arena_poke(emu->analysis->reg, arena);
+	rz_analysis_esil_set_pc(emu->esil, tm->fcn->addr);
+	if (!emu->pages || emu->pages->count) {
+		ht_up_free(emu->pages);
+		emu->pages = ht_up_new(NULL, page_kv_free, NULL);
+		if (!emu->pages) {
+			return;
+		}
+	}
+	rz_th_lock_enter(emu->io_lock);
+	tm->trace = rz_analysis_esil_trace_new(emu->esil);
+	rz_th_lock_leave(emu->io_lock);
+	if (!tm->trace) {
+		return;
+	}
+	// the trace is never rewound, its copy of the initial stack is not needed
+	RZ_FREE(tm->trace->stack_data);
+	// the loop counts are not shared with the functions emulated by the other workers
+	HtUU *loop_table = ht_uu_new0();
+	emu->esil->trace = tm->trace;
+	type_match_emulate(emu, tm, loop_table);
+	emu->esil->trace = NULL;
+	ht_uu_free(loop_table);
+}
+
+static void type_match_worker_run(void *user) {
+	TypeMatchWorker *worker = user;
+	TypeMatchRound *round = worker->round;
+	while (!rz_cons_is_breaked()) {
+		rz_th_lock_enter(round->lock);
+		size_t i = round->next++;
+		rz_th_lock_leave(round->lock);
+		if (i >= round->count) {
+			break;
+		}
+		type_match_emulate_isolated(&worker->emu, &round->fcns[i], round->arena);
+	}
+}
+
+/**
+ * Emulates the functions of \p round with \p nworkers threads, then
+ * propagates their types in the order of the round.
+ */
+static bool type_match_round_run(RzCore *core, TypeMatchRound *round, TypeMatchWorker *workers, size_t nworkers) {
+	round->next = 0;
+	// the workers share the functions of the round, a single one emulates them all without pool
+	size_t nshards;
+	RzThreadPool *pool = rz_th_pool_new_shards(nworkers, round->count, 0, &nshards);
+	rz_th_pool_run_shards(pool, workers, sizeof(TypeMatchWorker), nshards, type_match_worker_run);
+
+	for (size_t i = 0; i < round->count; i++) {
+		TypeMatchFcn *tm = &round->fcns[i];
+		if (tm->trace && !rz_cons_is_breaked() && rz_core_seek(core, tm->fcn->addr, true)) {
+			type_match_propagate(core, tm);
+			if (!rz_cons_is_breaked()) {
+				rz_analysis_fcn_vars_add_types(core->analysis, tm->fcn);
+			}
+		}
+		type_match_fcn_fini(tm);
+	}
+	round->count = 0;
+	return !rz_cons_is_breaked();
+}
+
+#define TYPE_MATCH_ROUND_FCNS 16
+
+/**
+ * \brief Propagates the types of all the functions like aaft, emulating
+ * them from several threads
+ *
+ * Each worker emulates the functions with registers, esil, trace and memory
+ * of its own, starting from \p arena. The types are propagated from the main
+ * thread in the same order as the sequential analysis. The emulation of a
+ * function does not see the loop counts nor the memory left by the others.
+ *
+ * \param arena GPR arena every function is emulated from
+ * \param max_threads maximum number of threads, 0 for all the available cores
+ * \return false if the workers could not be set up, nothing being propagated
+ */
+RZ_IPI bool rz_core_analysis_types_propagation_parallel(RzCore *core, const ut8 *arena, size_t max_threads) {
+	rz_return_val_if_fail(core && core->analysis && arena, false);
+	if (!core->analysis->esil || !core->analysis->esil->stack_addr || !core->analysis->esil->stack_size) {
+		return false;
+	}
+	size_t nworkers = rz_th_physical_core_number();
+	if (max_threads) {
+		nworkers = RZ_MIN(nworkers, max_threads);
+	}
+	if (nworkers < 2) {
+		return false;
+	}
+	// the sequential analysis reports it, from the same registers
+	rz_reg_arena_poke(core->analysis->reg, arena);
+	if (!analysis_emul_stack_initialized(core->analysis->reg)) {
+		return false;
+	}
+	bool ret = false;
+	TypeMatchRound round = { 0 };
+	const size_t round_fcns = nworkers * TYPE_MATCH_ROUND_FCNS;
+	round.arena = arena;
+	round.lock = rz_th_lock_new(false);
+	round.fcns = RZ_NEWS0(TypeMatchFcn, round_fcns);
+	TypeMatchWorker *workers = RZ_NEWS0(TypeMatchWorker, nworkers);
+	if (!round.lock || !round.fcns || !workers) {
+		goto beach;
+	}
+	for (size_t t = 0; t < nworkers; t++) {
+		workers[t].round = &round;
+		if (!type_match_emu_init_isolated(&workers[t].emu, core, round.lock)) {
+			RZ_LOG_ERROR("cannot set up the emulation of thread %u\n", (ut32)t);
+			goto beach;
+		}
+	}
+	RZ_LOG_VERBOSE("aaft: using %u threads\n", (ut32)nworkers);
+	ret = true;
+
+	rz_cons_break_push(NULL, NULL);
+	// Iterating Reverse so that we get function in top-bottom call order
+	RzListIter *it;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach_prev(core->analysis->fcns, it, fcn) {
+		TypeMatchFcn *tm = &round.fcns[round.count];
+		if (!type_match_fcn_init(tm, fcn)) {
+			type_match_fcn_fini(tm);
+			break;
+		}
+		rz_list_sort(fcn->bbs, bb_cmpaddr);
+		if (++round.count == round_fcns && !type_match_round_run(core, &round, workers, nworkers)) {
+			break;
+		}
+	}
+	if (round.count) {
+		type_match_round_run(core, &round, workers, nworkers);
+	}
+	rz_cons_break_pop();
+
+beach:
+	if (workers) {
+		for (size_t t = 0; t < nworkers; t++) {
+			type_match_emu_fini_isolated(&workers[t].emu);
+		}
+	}
+	free(workers);
+	free(round.fcns);
+	rz_th_lock_free(round.lock);
+	return ret;
+}
@@ -45,6 +45,7 @@ RZ_IPI int fcn_cmpaddr(const void *_a, const void *_b) {
 static char *getFunctionName(RzCore *core, ut64 addr) {
 	RzBinFile *bf = rz_bin_cur(core->bin);
 	if (bf && bf->o) {
+		rz_bin_object_load_item(bf->o, RZ_BIN_OBJECT_ITEM_CLASSES);
 		RzBinSymbol *sym = ht_up_find(bf->o->addrzklassmethod, addr, NULL);
 		if (sym && sym->classname && sym->name) {
 			return rz_str_newf("method.%s.%s", sym->classname, sym->name);
@@ -2385,7 +2386,8 @@ RZ_API RzGraph *rz_core_analysis_importxrefs(RzCore *core) {
 	if (!graph) {
 		return NULL;
 	}
-	rz_list_foreach (obj->imports, iter, imp) {
+	const RzList *imports = rz_bin_object_get_imports(obj);
+	rz_list_foreach (imports, iter, imp) {
 		RzBinSymbol *sym = rz_bin_object_get_symbol_of_import(obj, imp);
 		ut64 addr = sym ? (va ? rz_bin_object_get_vaddr(obj, sym->paddr, sym->vaddr) : sym->paddr) : UT64_MAX;
 		if (addr && addr != UT64_MAX) {
@@ -3357,9 +3359,350 @@ static void set_new_xref(RzCore *core, ut64 xref_from, ut64 xref_to, RzAnalysisX
 	}
 }
 
+typedef struct {
+	ut64 from; ///< address of the referencing instruction
+	ut64 to; ///< referenced address
+	RzAnalysisXRefType type;
+	bool counted; ///< counted as found even when the referenced address is not valid
+} XRefCandidate;
+
+typedef struct {
+	st64 asm_sub_varmin;
+	bool jmp_cref;
+} XRefScanOptions;
+
+typedef struct {
+	RzAnalysis *decoder; ///< private to the thread
+	RzAnalysis *hints; ///< shared analysis, only read to get the hints
+	const XRefScanOptions *opt;
+	const ut8 *buf; ///< blocks of the current round
+	const bool *skip; ///< blocks that are not worth decoding
+	ut64 at; ///< address of the first block of buf
+	size_t first; ///< first block of the shard
+	size_t last; ///< end of the shard
+	RzVector /*<XRefCandidate>*/ cands;
+	RzThreadSemaphore *start; ///< posted by the main thread when a round can be decoded
+	RzThreadSemaphore *done; ///< shared by the shards, posted when the shard of a round is decoded
+	const bool *quit; ///< set by the main thread before the last post of start
+} XRefScanShard;
+
+#define XREFS_BLOCK_SIZE   8096
+#define XREFS_SHARD_BLOCKS 64
+
+static void xref_candidate_push(RzVector *cands, RzAnalysisOp *op, ut64 to, RzAnalysisXRefType type, bool counted) {
+	XRefCandidate cand = { op->addr, to, type, counted };
+	rz_vector_push(cands, &cand);
+}
+
+static void xref_candidates_from_op(const XRefScanOptions *opt, RzAnalysisOp *op, RzVector *cands) {
+	// find references
+	if ((st64)op->val > opt->asm_sub_varmin && op->val != UT64_MAX && op->val != UT32_MAX) {
+		xref_candidate_push(cands, op, op->val, RZ_ANALYSIS_XREF_TYPE_DATA, false);
+	}
+	for (ut8 i = 0; i < 6; ++i) {
+		st64 aval = op->analysis_vals[i].imm;
+		if (aval > opt->asm_sub_varmin && aval != UT64_MAX && aval != UT32_MAX) {
+			xref_candidate_push(cands, op, aval, RZ_ANALYSIS_XREF_TYPE_DATA, false);
+		}
+	}
+	// find references
+	if (op->ptr && op->ptr != UT64_MAX && op->ptr != UT32_MAX) {
+		xref_candidate_push(cands, op, op->ptr, RZ_ANALYSIS_XREF_TYPE_DATA, false);
+	}
+	// find references
+	if (op->addr > 512 && op->disp > 512 && op->disp && op->disp != UT64_MAX) {
+		xref_candidate_push(cands, op, op->disp, RZ_ANALYSIS_XREF_TYPE_DATA, false);
+	}
+	switch (op->type) {
+	case RZ_ANALYSIS_OP_TYPE_JMP:
+		xref_candidate_push(cands, op, op->jump, RZ_ANALYSIS_XREF_TYPE_CODE, false);
+		break;
+	case RZ_ANALYSIS_OP_TYPE_CJMP:
+		if (opt->jmp_cref) {
+			xref_candidate_push(cands, op, op->jump, RZ_ANALYSIS_XREF_TYPE_CODE, false);
+		}
+		break;
+	case RZ_ANALYSIS_OP_TYPE_CALL:
+	case RZ_ANALYSIS_OP_TYPE_CCALL:
+		xref_candidate_push(cands, op, op->jump, RZ_ANALYSIS_XREF_TYPE_CALL, false);
+		break;
+	case RZ_ANALYSIS_OP_TYPE_UJMP:
+	case RZ_ANALYSIS_OP_TYPE_IJMP:
+	case RZ_ANALYSIS_OP_TYPE_RJMP:
+	case RZ_ANALYSIS_OP_TYPE_IRJMP:
+	case RZ_ANALYSIS_OP_TYPE_MJMP:
+	case RZ_ANALYSIS_OP_TYPE_UCJMP:
+		xref_candidate_push(cands, op, op->ptr, RZ_ANALYSIS_XREF_TYPE_CODE, true);
+		break;
+	case RZ_ANALYSIS_OP_TYPE_UCALL:
+	case RZ_ANALYSIS_OP_TYPE_ICALL:
+	case RZ_ANALYSIS_OP_TYPE_RCALL:
+	case RZ_ANALYSIS_OP_TYPE_IRCALL:
+	case RZ_ANALYSIS_OP_TYPE_UCCALL:
+		xref_candidate_push(cands, op, op->ptr, RZ_ANALYSIS_XREF_TYPE_CALL, false);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Decodes a block at \p at and collects the possible xrefs of its instructions.
+ * Instructions never cross the end of the block.
+ * When \p hints is given, the hints are taken from there instead of \p analysis.
+ */
+static void xref_candidates_from_block(RzAnalysis *analysis, RzAnalysis *hints, const XRefScanOptions *opt, const ut8 *buf, ut64 at, RzVector *cands) {
+	const RzAnalysisOpMask mask = hints ? RZ_ANALYSIS_OP_MASK_BASIC : RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_HINT;
+	RzAnalysisOp op = { 0 };
+	int i = 0;
+	while (i < XREFS_BLOCK_SIZE && !rz_cons_is_breaked()) {
+		int ret = rz_analysis_op(analysis, &op, at + i, buf + i, XREFS_BLOCK_SIZE - i, mask);
+		if (hints) {
+			RzAnalysisHint *hint = rz_analysis_hint_get(hints, at + i);
+			if (hint) {
+				rz_analysis_op_hint(&op, hint);
+				rz_analysis_hint_free(hint);
+			}
+		}
+		i += ret > 0 ? ret : 1;
+		if (i > XREFS_BLOCK_SIZE) {
+			break;
+		}
+		xref_candidates_from_op(opt, &op, cands);
+		rz_analysis_op_fini(&op);
+	}
+	rz_analysis_op_fini(&op);
+}
+
+static bool is_padding_block(const ut8 *buf) {
+	if (buf[0] != 0 && buf[0] != 0xff) {
+		return false;
+	}
+	for (size_t i = 1; i < XREFS_BLOCK_SIZE; i++) {
+		if (buf[i] != buf[0]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Adds the valid candidates to the xrefs in their order, returns how many were counted
+static int xref_candidates_commit(RzCore *core, RzVector *cands, bool cfg_debug, bool decode_str) {
+	int count = 0;
+	XRefCandidate *cand;
+	rz_vector_foreach(cands, cand) {
+		if (cand->counted) {
+			count++;
+		}
+		if (is_valid_xref(core, cand->to, cand->type, cfg_debug)) {
+			set_new_xref(core, cand->from, cand->to, cand->type, decode_str);
+			count++;
+		}
+	}
+	rz_vector_clear(cands);
+	return count;
+}
+
+static void xrefs_shard_decode(XRefScanShard *shard) {
+	for (size_t b = shard->first; b < shard->last && !rz_cons_is_breaked(); b++) {
+		if (!shard->skip[b]) {
+			xref_candidates_from_block(shard->decoder, shard->hints, shard->opt,
+				shard->buf + b * XREFS_BLOCK_SIZE, shard->at + b * XREFS_BLOCK_SIZE, &shard->cands);
+		}
+	}
+}
+
+// Decodes the shard of each round, until the main thread quits
+static RzThreadFunctionRet xrefs_shard_runner(RzThread *th) {
+	XRefScanShard *shard = rz_th_get_user(th);
+	while (true) {
+		rz_th_sem_wait(shard->start);
+		if (*shard->quit) {
+			break;
+		}
+		xrefs_shard_decode(shard);
+		rz_th_sem_post(shard->done);
+	}
+	return RZ_TH_STOP;
+}
+
+/**
+ * The instructions can be decoded from other threads when the plugin supports
+ * it and nothing in the range may switch the arch or the bits being used, as
+ * the sequential analysis would do through rz_core_seek_arch_bits().
+ */
+RZ_IPI bool rz_core_analysis_can_decode_in_parallel(RzCore *core, ut64 from, ut64 to) {
+	RzAnalysis *analysis = core->analysis;
+	if (!analysis->cur || !analysis->cur->op || !analysis->cur->op_stateless) {
+		return false;
+	}
+	if (analysis->arch_hints || analysis->bits_hints) {
+		return false;
+	}
+	RzBinObject *o = rz_bin_cur_object(core->bin);
+	if (!o) {
+		return true;
+	}
+	const char *arch = rz_config_get(core->config, "asm.arch");
+	RzListIter *iter;
+	RzBinSection *section;
+	rz_list_foreach (o->sections, iter, section) {
+		if (section->is_segment) {
+			continue;
+		}
+		ut64 sfrom = core->io->va ? rz_bin_object_addr_with_base(o, section->vaddr) : section->paddr;
+		ut64 sto = sfrom + (core->io->va ? section->vsize : section->size);
+		if (sto <= from || sfrom >= to) {
+			continue;
+		}
+		if (!core->fixedarch && section->arch && (!arch || strcmp(section->arch, arch))) {
+			return false;
+		}
+		if (!core->fixedbits && (section->bits == RZ_SYS_BITS_16 || section->bits == RZ_SYS_BITS_32 || section->bits == RZ_SYS_BITS_64) &&
+			section->bits * 8 != analysis->bits) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Same scan as the sequential one, but rounds of blocks are read from the
+ * main thread, then decoded in parallel by shards of contiguous blocks, each
+ * with its own decoder. The candidates of a round are committed in address
+ * order, so that the results do not depend on the number of threads.
+ *
+ * The threads are started once and wait for each round on the start
+ * semaphore of their shard. The shards without a thread are decoded from
+ * the main thread.
+ */
+static int search_xrefs_parallel(RzCore *core, ut64 from, ut64 to, const XRefScanOptions *opt, size_t max_threads, bool cfg_debug, bool decode_str) {
+	int count = 0;
+	ut8 *buf = NULL;
+	bool *skip = NULL;
+	bool *threaded = NULL;
+	bool quit = false;
+	XRefScanShard *shards = NULL;
+	RzThreadSemaphore *done = NULL;
+	RzThreadPool *pool = rz_th_pool_new(max_threads);
+	if (!pool) {
+		RZ_LOG_ERROR("cannot allocate the thread pool\n");
+		return -1;
+	}
+	const size_t nthreads = pool->size;
+	const size_t round_blocks = nthreads * XREFS_SHARD_BLOCKS;
+	buf = malloc(round_blocks * XREFS_BLOCK_SIZE);
+	skip = RZ_NEWS0(bool, round_blocks);
+	threaded = RZ_NEWS0(bool, nthreads);
+	shards = RZ_NEWS0(XRefScanShard, nthreads);
+	done = rz_th_sem_new(0);
+	if (!buf || !skip || !threaded || !shards || !done) {
+		RZ_LOG_ERROR("cannot allocate the blocks to decode\n");
+		count = -1;
+		goto beach;
+	}
+	for (size_t t = 0; t < nthreads; t++) {
+		XRefScanShard *shard = &shards[t];
+		rz_vector_init(&shard->cands, sizeof(XRefCandidate), NULL, NULL);
+		shard->decoder = rz_analysis_new_decoder(core->analysis);
+		shard->start = rz_th_sem_new(0);
+		if (!shard->decoder || !shard->start) {
+			RZ_LOG_ERROR("cannot create the analysis decoder of thread %u\n", (ut32)t);
+			count = -1;
+			goto beach;
+		}
+		shard->hints = core->analysis;
+		shard->opt = opt;
+		shard->buf = buf;
+		shard->skip = skip;
+		shard->done = done;
+		shard->quit = &quit;
+	}
+	for (size_t t = 0; t < nthreads; t++) {
+		RzThread *th = rz_th_new(xrefs_shard_runner, &shards[t], 0);
+		if (!th || !rz_th_pool_add_thread(pool, th)) {
+			// decode this shard from here instead
+			rz_th_free(th);
+			continue;
+		}
+		threaded[t] = true;
+	}
+	RZ_LOG_VERBOSE("aar: using %u threads\n", (ut32)nthreads);
+
+	ut64 at = from;
+	bool stop = false;
+	while (!stop && at < to && !rz_cons_is_breaked()) {
+		const ut64 round_at = at;
+		size_t nblocks = 0;
+		for (; nblocks < round_blocks && at < to; nblocks++, at += XREFS_BLOCK_SIZE) {
+			if (!rz_io_is_valid_offset(core->io, at, RZ_PERM_X)) {
+				stop = true;
+				break;
+			}
+			ut8 *block = buf + nblocks * XREFS_BLOCK_SIZE;
+			(void)rz_io_read_at(core->io, at, block, XREFS_BLOCK_SIZE);
+			skip[nblocks] = is_padding_block(block);
+		}
+		if (!nblocks) {
+			break;
+		}
+
+		const size_t per_shard = (nblocks + nthreads - 1) / nthreads;
+		for (size_t t = 0; t < nthreads; t++) {
+			XRefScanShard *shard = &shards[t];
+			shard->at = round_at;
+			shard->first = RZ_MIN(nblocks, t * per_shard);
+			shard->last = RZ_MIN(nblocks, shard->first + per_shard);
+			if (threaded[t]) {
+				rz_th_sem_post(shard->start);
+			}
+		}
+		for (size_t t = 0; t < nthreads; t++) {
+			if (!threaded[t]) {
+				xrefs_shard_decode(&shards[t]);
+			}
+		}
+		for (size_t t = 0; t < nthreads; t++) {
+			if (threaded[t]) {
+				rz_th_sem_wait(done);
+			}
+		}
+
+		for (size_t t = 0; t < nthreads; t++) {
+			count += xref_candidates_commit(core, &shards[t].cands, cfg_debug, decode_str);
+		}
+	}
+
+beach:
+	quit = true;
+	for (size_t t = 0; threaded && t < nthreads; t++) {
+		if (threaded[t]) {
+			rz_th_sem_post(shards[t].start);
+		}
+	}
+	rz_th_pool_wait(pool);
+	rz_th_pool_free(pool);
+	if (shards) {
+		for (size_t t = 0; t < nthreads; t++) {
+			rz_analysis_free(shards[t].decoder);
+			rz_vector_fini(&shards[t].cands);
+			rz_th_sem_free(shards[t].start);
+		}
+	}
+	rz_th_sem_free(done);
+	free(shards);
+	free(threaded);
+	free(skip);
+	free(buf);
+	return count;
+}
+
 /**
  * \brief Searches for xrefs in the range of the paramters \p 'from' and \p 'to'.
  *
+ * When analysis.refs.threads is not 1 and the current plugin supports it,
+ * the instructions are decoded by several threads, with the same results.
+ *
  * \param core The Rizin core.
  * \param from Start of search interval.
  * \param to End of search interval.
@@ -3370,10 +3713,9 @@ RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut6
 
 	bool cfg_debug = rz_config_get_b(core->config, "cfg.debug");
 	bool decode_str = rz_config_get_i(core->config, "analysis.strings");
+	size_t max_threads = rz_config_get_i(core->config, "analysis.refs.threads");
 	ut64 at;
 	int count = 0;
-	const int bsz = 8096;
-	RzAnalysisOp op = { 0 };
 
 	if (from == to) {
 		return -1;
@@ -3385,130 +3727,42 @@ RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut6
 		return -1;
 	}
 
-	ut8 *buf = malloc(bsz);
-	if (!buf) {
-		RZ_LOG_ERROR("cannot allocate a block\n");
-		return -1;
+	XRefScanOptions opt = {
+		.asm_sub_varmin = rz_config_get_i(core->config, "asm.sub.varmin"),
+		.jmp_cref = rz_config_get_b(core->config, "analysis.jmp.cref"),
+	};
+
+	rz_cons_break_push(NULL, NULL);
+	if (max_threads != 1 && to - from > XREFS_SHARD_BLOCKS * XREFS_BLOCK_SIZE && rz_core_analysis_can_decode_in_parallel(core, from, to)) {
+		count = search_xrefs_parallel(core, from, to, &opt, max_threads, cfg_debug, decode_str);
+		rz_cons_break_pop();
+		return count;
 	}
 
-	ut8 *block = malloc(bsz);
-	if (!block) {
-		RZ_LOG_ERROR("cannot allocate a temp block\n");
-		free(buf);
+	ut8 *buf = malloc(XREFS_BLOCK_SIZE);
+	if (!buf) {
+		RZ_LOG_ERROR("cannot allocate a block\n");
+		rz_cons_break_pop();
 		return -1;
 	}
-
-	rz_cons_break_push(NULL, NULL);
+	RzVector cands;
+	rz_vector_init(&cands, sizeof(XRefCandidate), NULL, NULL);
 
 	at = from;
-	st64 asm_sub_varmin = rz_config_get_i(core->config, "asm.sub.varmin");
 	while (at < to && !rz_cons_is_breaked()) {
-		int i = 0, ret = bsz;
 		if (!rz_io_is_valid_offset(core->io, at, RZ_PERM_X)) {
 			break;
 		}
-		(void)rz_io_read_at(core->io, at, buf, bsz);
-		memset(block, -1, bsz);
-		if (!memcmp(buf, block, bsz)) {
-			at += ret;
-			continue;
-		}
-		memset(block, 0, bsz);
-		if (!memcmp(buf, block, bsz)) {
-			at += ret;
-			continue;
-		}
-		while (i < bsz && !rz_cons_is_breaked()) {
-			ret = rz_analysis_op(core->analysis, &op, at + i, buf + i, bsz - i, RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_HINT);
-			ret = ret > 0 ? ret : 1;
-			i += ret;
-			if (ret <= 0 || i > bsz) {
-				break;
-			}
-			// find references
-			if ((st64)op.val > asm_sub_varmin && op.val != UT64_MAX && op.val != UT32_MAX) {
-				if (is_valid_xref(core, op.val, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-					set_new_xref(core, op.addr, op.val, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-					count++;
-				}
-			}
-			for (ut8 i = 0; i < 6; ++i) {
-				st64 aval = op.analysis_vals[i].imm;
-				if (aval > asm_sub_varmin && aval != UT64_MAX && aval != UT32_MAX) {
-					if (is_valid_xref(core, aval, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-						set_new_xref(core, op.addr, aval, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-						count++;
-					}
-				}
-			}
-			// find references
-			if (op.ptr && op.ptr != UT64_MAX && op.ptr != UT32_MAX) {
-				if (is_valid_xref(core, op.ptr, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-					set_new_xref(core, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-					count++;
-				}
-			}
-			// find references
-			if (op.addr > 512 && op.disp > 512 && op.disp && op.disp != UT64_MAX) {
-				if (is_valid_xref(core, op.disp, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-					set_new_xref(core, op.addr, op.disp, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-					count++;
-				}
-			}
-			switch (op.type) {
-			case RZ_ANALYSIS_OP_TYPE_JMP:
-				if (is_valid_xref(core, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, cfg_debug)) {
-					set_new_xref(core, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, decode_str);
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_CJMP:
-				if (rz_config_get_b(core->config, "analysis.jmp.cref") &&
-					is_valid_xref(core, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, cfg_debug)) {
-					set_new_xref(core, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, decode_str);
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_CALL:
-			case RZ_ANALYSIS_OP_TYPE_CCALL:
-				if (is_valid_xref(core, op.jump, RZ_ANALYSIS_XREF_TYPE_CALL, cfg_debug)) {
-					set_new_xref(core, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CALL, decode_str);
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_UJMP:
-			case RZ_ANALYSIS_OP_TYPE_IJMP:
-			case RZ_ANALYSIS_OP_TYPE_RJMP:
-			case RZ_ANALYSIS_OP_TYPE_IRJMP:
-			case RZ_ANALYSIS_OP_TYPE_MJMP:
-			case RZ_ANALYSIS_OP_TYPE_UCJMP:
-				count++;
-				if (is_valid_xref(core, op.ptr, RZ_ANALYSIS_XREF_TYPE_CODE, cfg_debug)) {
-					set_new_xref(core, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_CODE, decode_str);
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_UCALL:
-			case RZ_ANALYSIS_OP_TYPE_ICALL:
-			case RZ_ANALYSIS_OP_TYPE_RCALL:
-			case RZ_ANALYSIS_OP_TYPE_IRCALL:
-			case RZ_ANALYSIS_OP_TYPE_UCCALL:
-				if (is_valid_xref(core, op.ptr, RZ_ANALYSIS_XREF_TYPE_CALL, cfg_debug)) {
-					set_new_xref(core, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_CALL, decode_str);
-					count++;
-				}
-				break;
-			default:
-				break;
-			}
-			rz_analysis_op_fini(&op);
+		(void)rz_io_read_at(core->io, at, buf, XREFS_BLOCK_SIZE);
+		if (!is_padding_block(buf)) {
+			xref_candidates_from_block(core->analysis, NULL, &opt, buf, at, &cands);
+			count += xref_candidates_commit(core, &cands, cfg_debug, decode_str);
 		}
-		at += bsz;
-		rz_analysis_op_fini(&op);
+		at += XREFS_BLOCK_SIZE;
 	}
 	rz_cons_break_pop();
+	rz_vector_fini(&cands);
 	free(buf);
-	free(block);
 	return count;
 }
 
@@ -3538,7 +3792,7 @@ static bool isSkippable(RzBinSymbol *s) {
 }
 
 RZ_API int rz_core_analysis_all(RzCore *core) {
-	RzList *list;
+	const RzList *list;
 	RzListIter *iter;
 	RzFlagItem *item;
 	RzAnalysisFunction *fcni;
@@ -3565,7 +3819,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 	RzBinFile *bf = core->bin->cur;
 	RzBinObject *o = bf ? bf->o : NULL;
 	/* Symbols (Imports are already analyzed by rz_bin on init) */
-	if (o && (list = o->symbols) != NULL) {
+	if (o && (list = rz_bin_object_get_symbols(o)) != NULL) {
 		rz_list_foreach (list, iter, symbol) {
 			if (rz_cons_is_breaked()) {
 				break;
@@ -4689,7 +4943,7 @@ RZ_API void rz_core_analysis_esil(RzCore *core, ut64 addr, ut64 size, RZ_NULLABL
 		if (gp_fixed && gp_reg) {
 			rz_reg_setv(core->analysis->reg, gp_reg, gp);
 		}
-		(void)rz_analysis_esil_parse(ESIL, esilstr);
+		(void)rz_analysis_esil_parse_at(ESIL, cur, esilstr);
 #define CHECKREF(x) ((refptr && (x) == refptr) || !refptr)
 		switch (op.type) {
 		case RZ_ANALYSIS_OP_TYPE_LEA:
@@ -6104,6 +6358,12 @@ RZ_API bool rz_core_analysis_sigdb_apply(RZ_NONNULL RzCore *core, RZ_NULLABLE in
 	if (!sigdb) {
 		return false;
 	}
+	// all the files are merged into one index, so that each function is matched once
+	RzFlirtIndex *index = rz_sign_flirt_index_new();
+	if (!index) {
+		rz_list_free(sigdb);
+		return false;
+	}
 
 	n_flags_old = rz_flag_count(core->flags, "flirt");
 	rz_list_foreach (sigdb, iter, sig) {
@@ -6115,8 +6375,8 @@ RZ_API bool rz_core_analysis_sigdb_apply(RZ_NONNULL RzCore *core, RZ_NULLABLE in
 			if (strcmp(bin, sig->bin_name) || strcmp(arch, sig->arch_name) || bits != sig->arch_bits) {
 				continue;
 			} else if (strstr(sig->base_name, "c++") &&
-				obj->lang != RZ_BIN_LANGUAGE_CXX &&
-				obj->lang != RZ_BIN_LANGUAGE_RUST) {
+				rz_bin_object_get_language(obj) != RZ_BIN_LANGUAGE_CXX &&
+				rz_bin_object_get_language(obj) != RZ_BIN_LANGUAGE_RUST) {
 				// C++ libs can create many false positives, especially on C binaries.
 				// So their usage is limited to C++ and RUST lang
 				continue;
@@ -6130,9 +6390,13 @@ RZ_API bool rz_core_analysis_sigdb_apply(RZ_NONNULL RzCore *core, RZ_NULLABLE in
 			rz_cons_printf("Applying %s/%s/%u/%s signature file\n",
 				sig->bin_name, sig->arch_name, sig->arch_bits, sig->base_name);
 		}
-		rz_sign_flirt_apply(core->analysis, sig->file_path, arch_id);
+		rz_sign_flirt_index_add_file(index, sig->file_path, arch_id);
 	}
 	rz_list_free(sigdb);
+	if (!rz_cons_is_breaked() && !rz_sign_flirt_index_apply(index, core->analysis, rz_config_get_i(core->config, "flirt.threads"))) {
+		RZ_LOG_ERROR("FLIRT: Error while scanning the signature files\n");
+	}
+	rz_sign_flirt_index_free(index);
 	n_flags_new = rz_flag_count(core->flags, "flirt");
 
 	if (n_applied) {
@@ -6361,19 +6625,23 @@ RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
 	// HtUU <addr->loop_count>
 	HtUU *loop_table = ht_uu_new0();
 
-	// Iterating Reverse so that we get function in top-bottom call order
-	rz_list_foreach_prev(core->analysis->fcns, it, fcn) {
-		int ret = rz_core_seek(core, fcn->addr, true);
-		if (!ret) {
-			continue;
-		}
-		rz_reg_arena_poke(core->analysis->reg, saved_arena);
-		rz_analysis_esil_set_pc(core->analysis->esil, fcn->addr);
-		rz_core_analysis_type_match(core, fcn, loop_table);
-		if (rz_cons_is_breaked()) {
-			break;
+	size_t max_threads = rz_config_get_i(core->config, "analysis.types.threads");
+	if (max_threads == 1 || !rz_core_analysis_can_decode_in_parallel(core, 0, UT64_MAX) ||
+		!rz_core_analysis_types_propagation_parallel(core, saved_arena, max_threads)) {
+		// Iterating Reverse so that we get function in top-bottom call order
+		rz_list_foreach_prev(core->analysis->fcns, it, fcn) {
+			int ret = rz_core_seek(core, fcn->addr, true);
+			if (!ret) {
+				continue;
+			}
+			rz_reg_arena_poke(core->analysis->reg, saved_arena);
+			rz_analysis_esil_set_pc(core->analysis->esil, fcn->addr);
+			rz_core_analysis_type_match(core, fcn, loop_table);
+			if (rz_cons_is_breaked()) {
+				break;
+			}
+			rz_analysis_fcn_vars_add_types(core->analysis, fcn);
 		}
-		rz_analysis_fcn_vars_add_types(core->analysis, fcn);
 	}
 	if (delete_regs) {
 		rz_core_debug_clear_register_flags(core);
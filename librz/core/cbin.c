@@ -595,6 +595,7 @@ RZ_API bool rz_core_bin_apply_config(RzCore *r, RzBinFile *binfile) {
 	rz_config_set(r->config, "file.type", rz_str_get(info->rclass));
 	rz_config_set(r->config, "cfg.bigendian",
 		info->big_endian ? "true" : "false");
+	rz_bin_object_get_language(obj);
 	if (info->lang) {
 		rz_config_set(r->config, "bin.lang", info->lang);
 	}
@@ -1266,7 +1267,7 @@ RZ_API bool rz_core_bin_apply_imports(RzCore *core, RzBinFile *binfile, bool va)
 	}
 	RzListIter *iter;
 	RzBinImport *import;
-	RzList *imports = o->imports;
+	const RzList *imports = rz_bin_object_get_imports(o);
 	rz_list_foreach (imports, iter, import) {
 		if (!import->libname || !strstr(import->libname, ".dll")) {
 			continue;
@@ -1547,7 +1548,7 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 RZ_API bool rz_core_bin_apply_classes(RzCore *core, RzBinFile *binfile) {
 	rz_return_val_if_fail(core && binfile, false);
 	RzBinObject *o = binfile->o;
-	RzList *cs = o ? o->classes : NULL;
+	RzList *cs = o ? (RzList *)rz_bin_object_get_classes(o) : NULL;
 	if (!cs) {
 		return false;
 	}
@@ -2993,6 +2994,9 @@ RZ_API bool rz_core_bin_info_print(RzCore *core, RzBinFile *bf, RzCmdStateOutput
 	bool havecode;
 	int bits;
 
+	// guessed from the symbols, sets the language and compiler of info
+	rz_bin_object_get_language(obj);
+
 	havecode = is_executable(obj) | (obj->entries != NULL);
 	compiled = get_compile_time(bf->sdb);
 	bits = (plugin && !strcmp(plugin->name, "any")) ? rz_config_get_i(core->config, "asm.bits") : info->bits;
@@ -3695,7 +3699,8 @@ static void bin_class_print_rizin(RzCore *r, RzBinClass *c, ut64 at_min) {
 	}
 
 	// C struct
-	if (bf->o->lang == RZ_BIN_LANGUAGE_C || bf->o->lang == RZ_BIN_LANGUAGE_CXX || bf->o->lang == RZ_BIN_LANGUAGE_OBJC) {
+	RzBinLanguage lang = rz_bin_object_get_language(bf->o);
+	if (lang == RZ_BIN_LANGUAGE_C || lang == RZ_BIN_LANGUAGE_CXX || lang == RZ_BIN_LANGUAGE_OBJC) {
 		rz_cons_printf("td \"struct %s {", c->name);
 		rz_list_foreach (c->fields, iter2, f) {
 			char *n = objc_name_toc(f->name);
@@ -3725,7 +3730,7 @@ RZ_API bool rz_core_bin_class_as_source_print(RzCore *core, RzBinFile *bf, const
 			continue;
 		}
 		found = true;
-		switch (bf->o->lang & (~RZ_BIN_LANGUAGE_BLOCKS)) {
+		switch (rz_bin_object_get_language(bf->o) & (~RZ_BIN_LANGUAGE_BLOCKS)) {
 		case RZ_BIN_LANGUAGE_KOTLIN:
 		case RZ_BIN_LANGUAGE_GROOVY:
 		case RZ_BIN_LANGUAGE_DART:
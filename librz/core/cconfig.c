@@ -112,6 +112,24 @@ fail:
 	return false;
 }
 
+static bool cb_diff_candidates(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (node->i_value > 4096) {
+		eprintf("diff.candidates: cannot compare with more than 4096 functions\n");
+		return false;
+	}
+	core->analysis->diff_candidates = node->i_value;
+	return true;
+}
+
+static bool cb_diff_threads(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->analysis->diff_threads = node->i_value;
+	return true;
+}
+
 static inline void __setsegoff(RzConfig *cfg, const char *asmarch, int asmbits) {
 	int autoseg = (!strncmp(asmarch, "x86", 3) && asmbits == 16);
 	rz_config_set(cfg, "asm.segoff", rz_str_bool(autoseg));
@@ -216,6 +234,12 @@ static bool cb_analysis_ignbithints(void *user, void *data) {
 	return true;
 }
 
+static bool cb_analysis_opcache(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	return rz_analysis_op_cache_set_size(core->analysis, node->i_value);
+}
+
 static bool cb_analysis_sleep(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2009,6 +2033,24 @@ static bool cb_io_oxff(void *user, void *data) {
 	return true;
 }
 
+static bool cb_io_remote_pagesize(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (node->i_value > 0x100000) {
+		eprintf("io.remote.pagesize: cannot be greater than 0x100000\n");
+		return false;
+	}
+	core->io->remote_page_size = node->i_value;
+	return true;
+}
+
+static bool cb_io_remote_readahead(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->io->remote_readahead = node->i_value;
+	return true;
+}
+
 static bool cb_filepath(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2205,6 +2247,30 @@ static bool cb_scrstrconv(void *user, void *data) {
 	return true;
 }
 
+static bool cb_graphcrossing(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (*node->value == '?') {
+		print_node_options(node);
+		return false;
+	}
+	RzAGraphCrossing crossing;
+	if (!strcmp(node->value, "auto")) {
+		crossing = RZ_AGRAPH_CROSSING_AUTO;
+	} else if (!strcmp(node->value, "sweep")) {
+		crossing = RZ_AGRAPH_CROSSING_SWEEP;
+	} else if (!strcmp(node->value, "barycenter")) {
+		crossing = RZ_AGRAPH_CROSSING_BARYCENTER;
+	} else {
+		eprintf("graph.crossing: cannot find '%s'\n", node->value);
+		return false;
+	}
+	if (core->graph) {
+		core->graph->crossing = crossing;
+	}
+	return true;
+}
+
 static bool cb_graphformat(void *user, void *data) {
 	RzConfigNode *node = (RzConfigNode *)data;
 	if (!strcmp(node->value, "?")) {
@@ -2223,6 +2289,25 @@ static bool cb_exectrap(void *user, void *data) {
 	return true;
 }
 
+static bool cb_rzilcompile(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	RzCore *core = (RzCore *)user;
+	core->analysis->opt.il_compile = node->i_value;
+	if (core->analysis->il_vm) {
+		rz_analysis_il_vm_code_cache_enable(core->analysis->il_vm, node->i_value);
+	}
+	return true;
+}
+
+static bool cb_esilbytecode(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	RzCore *core = (RzCore *)user;
+	if (core->analysis && core->analysis->esil) {
+		rz_analysis_esil_bytecode_enable(core->analysis->esil, node->i_value);
+	}
+	return true;
+}
+
 static bool cb_iotrap(void *user, void *data) {
 	RzConfigNode *node = (RzConfigNode *)data;
 	RzCore *core = (RzCore *)user;
@@ -2364,6 +2449,21 @@ static bool cb_tracetag(void *user, void *data) {
 	return true;
 }
 
+static bool cb_trace_compact(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->dbg->trace_compact = node->i_value;
+	return true;
+}
+
+static bool cb_trace_spill(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	free(core->dbg->trace_spill);
+	core->dbg->trace_spill = RZ_STR_ISNOTEMPTY(node->value) ? strdup(node->value) : NULL;
+	return true;
+}
+
 static bool cb_utf8(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2496,6 +2596,15 @@ static bool cb_binmaxstrbuf(void *user, void *data) {
 	return true;
 }
 
+static bool cb_binstrthreads(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (core->bin) {
+		core->bin->str_search_threads = node->i_value;
+	}
+	return true;
+}
+
 static bool cb_binmaxstr(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2901,6 +3010,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("analysis.delay", "true", &cb_analysis_delay, "Enable delay slot analysis if supported by the architecture");
 	SETICB("analysis.depth", 64, &cb_analysis_depth, "Max depth at code analysis"); // XXX: warn if depth is > 50 .. can be problematic
 	SETICB("analysis.graph_depth", 256, &cb_analysis_graphdepth, "Max depth for path search");
+	SETICB("analysis.opcache", 0, &cb_analysis_opcache, "Number of decoded instructions to cache, for the plugins supporting it (0 disables)");
 	SETICB("analysis.sleep", 0, &cb_analysis_sleep, "Sleep N usecs every so often during analysis. Avoid 100% CPU usage");
 	SETCB("analysis.ignbithints", "false", &cb_analysis_ignbithints, "Ignore the ahb hints (only obey asm.bits)");
 	SETBPREF("analysis.calls", "false", "Make basic af analysis walk into calls");
@@ -2942,6 +3052,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("analysis.jmp.mid", "true", &cb_analysis_jmpmid, "Continue analysis after jump to middle of instruction (x86 only)");
 
 	SETCB("analysis.refstr", "false", &cb_analysis_searchstringrefs, "Search string references in data references");
+	SETI("analysis.refs.threads", 1, "Threads decoding the instructions when searching for references (0 uses all available cores, 1 disables)");
+	SETI("analysis.types.threads", 1, "Threads emulating the functions when propagating their types (0 uses all available cores, 1 disables)");
 	SETCB("analysis.trycatch", "false", &cb_analysis_trycatch, "Honor try.X.Y.{from,to,catch} flags");
 	SETCB("analysis.bb.maxsize", "512K", &cb_analysis_bb_max_size, "Maximum basic block size");
 	SETCB("analysis.pushret", "false", &cb_analysis_pushret, "Analyze push+ret as jmp");
@@ -3180,6 +3292,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB("bin.minstr", 0, &cb_binminstr, "Minimum string length for rz_bin");
 	SETICB("bin.maxstr", 0, &cb_binmaxstr, "Maximum string length for rz_bin");
 	SETICB("bin.maxstrbuf", 1024 * 1024 * 10, &cb_binmaxstrbuf, "Maximum size of range to load strings from");
+	SETICB("bin.str.threads", 1, &cb_binstrthreads, "Threads looking for strings in large ranges (0 uses all available cores, 1 disables)");
 	n = NODECB("bin.str.enc", "guess", &cb_binstrenc);
 	SETDESC(n, "Default string encoding of binary");
 	SETOPTIONS(n, "ascii", "8bit", "utf8", "utf16le", "utf32le", "utf16be", "utf32be", "guess", NULL);
@@ -3192,6 +3305,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	/* prj */
 	SETPREF("prj.file", "", "Path of the currently opened project");
 	SETBPREF("prj.compress", "false", "Compress the project file while saving");
+	SETBPREF("prj.binary", "false", "Save the project in the binary format, with xrefs in columns and updated in place");
 
 	/* cfg */
 	SETBPREF("cfg.plugins", "true", "Load plugins at startup");
@@ -3249,6 +3363,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETI("zign.maxsz", 500, "Maximum zignature length");
 	SETI("zign.minsz", 16, "Minimum zignature length for matching");
 	SETI("zign.mincc", 10, "Minimum cyclomatic complexity for matching");
+	SETI("zign.threads", 0, "Threads computing the graph metrics of the functions for matching (0 uses all available cores)");
 	SETBPREF("zign.match.graph", "true", "Use graph metrics for matching");
 	SETBPREF("zign.match.bytes", "true", "Use bytes patterns for matching");
 	SETBPREF("zign.match.offset", "false", "Use original offset for matching");
@@ -3269,6 +3384,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETI("diff.from", 0, "Set source diffing address for px (uses cc command)");
 	SETI("diff.to", 0, "Set destination diffing address for px (uses cc command)");
 	SETBPREF("diff.bare", "false", "Never show function names in diff output");
+	SETICB("diff.candidates", RZ_ANALYSIS_DIFF_CANDIDATES, &cb_diff_candidates, "Functions compared with each unmatched function when diffing, twice as many at most (0 compares with all)");
+	SETICB("diff.threads", 0, &cb_diff_threads, "Threads comparing the functions when diffing (0 uses all available cores)");
 	SETBPREF("diff.levenstein", "false", "Use faster (and buggy) levenstein algorithm for buffer distance diffing");
 
 	/* dir */
@@ -3364,6 +3481,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB("dbg.btdepth", 128, &cb_dbgbtdepth, "Depth of backtrace");
 	SETCB("dbg.trace", "false", &cb_trace, "Trace program execution (see asm.trace)");
 	SETICB("dbg.trace.tag", 0, &cb_tracetag, "Trace tag");
+	SETCB("dbg.trace.compact", "false", &cb_trace_compact, "Record the traced steps to a compact store, with a single tracepoint by address counting its hits");
+	SETCB("dbg.trace.spill", "", &cb_trace_spill, "File to write the compact trace to instead of keeping it in memory, removed when the trace is");
 
 	/* cmd */
 	SETICB("cmd.depth", 10, &cb_cmddepth, "Maximum command depth");
@@ -3479,6 +3598,9 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF("graph.json.usenames", "true", "Use names instead of addresses in Global Call Graph (agCj)");
 	SETI("graph.edges", 2, "0=no edges, 1=simple edges, 2=avoid collisions");
 	SETI("graph.layout", 0, "Graph layout (0=vertical, 1=horizontal)");
+	n = NODECB("graph.crossing", "auto", &cb_graphcrossing);
+	SETDESC(n, "Ordering of the nodes reducing the crossing edges (auto picks barycenter for large graphs)");
+	SETOPTIONS(n, "auto", "sweep", "barycenter", NULL);
 	SETI("graph.linemode", 1, "Graph edges (0=diagonal, 1=square)");
 	SETPREF("graph.font", "Courier", "Font for dot graphs");
 	SETBPREF("graph.offset", "false", "Show offsets in graphs");
@@ -3506,6 +3628,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("esil.iotrap", "true", &cb_iotrap, "invalid read or writes produce a trap exception");
 	SETBPREF("esil.romem", "false", "Set memory as read-only for ESIL");
 	SETBPREF("esil.stats", "false", "Statistics from ESIL emulation stored in sdb");
+	SETCB("esil.bytecode", "false", &cb_esilbytecode, "Compile the ESIL of each emulated instruction once and run it from a cache");
 	SETBPREF("esil.nonull", "false", "Prevent memory read, memory write at null pointer");
 	SETCB("esil.mdev.range", "", &cb_mdevrange, "Specify a range of memory to be handled by cmd.esil.mdev");
 
@@ -3611,6 +3734,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB("search.kwidx", 0, &cb_search_kwidx, "Store last search index count");
 	SETPREF("search.prefix", "hit", "Prefix name in search hits label");
 	SETBPREF("search.show", "true", "Show search results");
+	SETI("search.threads", 0, "Threads carving the blocks of /h and finding the end gadgets of /R (0 uses all available cores)");
 	SETI("search.to", -1, "Search end address");
 
 	/* rop */
@@ -3638,6 +3762,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("io.autofd", "true", &cb_ioautofd, "Change fd when opening a new file");
 	SETCB("io.unalloc", "false", &cb_io_unalloc, "Check each byte if it's allocated");
 	SETCB("io.unalloc.ch", ".", &cb_io_unalloc_ch, "Char to display if byte is unallocated");
+	SETICB("io.remote.pagesize", 0, &cb_io_remote_pagesize, "Page size of the memory cache of remote targets like gdb:// and rap:// (0 to disable)");
+	SETICB("io.remote.readahead", 4, &cb_io_remote_readahead, "Pages read ahead by remote targets after a read missing their memory cache");
 
 	/* file */
 	SETBPREF("file.info", "true", "RzBin info loaded");
@@ -3694,6 +3820,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	/* RzIL config */
 	SETB("rzil.step.events.read", false, "enables/disables printing aezse read event");
 	SETB("rzil.step.events.write", true, "enables/disables printing aezse write event");
+	SETCB("rzil.compile", "false", &cb_rzilcompile, "Compile the IL of each stepped instruction once and run it from a cache");
 
 	/* FLIRT config */
 	SETBPREF("flirt.sig.library", RZ_FLIRT_LIBRARY_NAME_DFL, "FLIRT library name for sig format");
@@ -3710,6 +3837,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETB("flirt.sig.deflate", false, "enables/disables FLIRT zlib compression when creating a signature file (available only for .sig files)");
 	SETI("flirt.node.optimize", RZ_FLIRT_NODE_OPTIMIZE_MAX, "FLIRT optimization option when creating a signature file (none: 0, normal: 1, smallest: 2)");
 	SETPREF("flirt.sigdb.path", "", "Additional user defined rizin sigdb location to load on the filesystem.");
+	SETI("flirt.threads", 0, "Threads matching the functions against the FLIRT signatures (0 uses all available cores)");
 
 	rz_config_lock(cfg, true);
 	return true;
@@ -650,6 +650,89 @@ RZ_API void rz_debug_traces_ascii(RzDebug *dbg, ut64 offset) {
 	rz_list_free(info_list);
 }
 
+static bool trace_compact_hit_print(void *user, ut64 addr, ut64 hits) {
+	RzCmdStateOutput *state = user;
+	switch (state->mode) {
+	case RZ_OUTPUT_MODE_JSON:
+		pj_o(state->d.pj);
+		pj_kn(state->d.pj, "addr", addr);
+		pj_kn(state->d.pj, "hits", hits);
+		pj_end(state->d.pj);
+		break;
+	case RZ_OUTPUT_MODE_QUIET:
+		rz_cons_printf("0x%" PFMT64x "\n", addr);
+		break;
+	case RZ_OUTPUT_MODE_STANDARD:
+	default:
+		rz_cons_printf("0x%08" PFMT64x " hits=%" PFMT64u "\n", addr, hits);
+		break;
+	}
+	return true;
+}
+
+/**
+ * \brief Prints the addresses executed in the compact trace of \p dbg
+ * (dbg.trace.compact) and their hits, in increasing address order
+ */
+RZ_API void rz_debug_trace_compact_print(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzCmdStateOutput *state) {
+	rz_return_if_fail(dbg && dbg->trace && state);
+	rz_cmd_state_output_array_start(state);
+	if (dbg->trace->store) {
+		rz_trace_store_coverage(dbg->trace->store, trace_compact_hit_print, state);
+	}
+	rz_cmd_state_output_array_end(state);
+}
+
+/* pc executed at \p step of \p store, false if it executed less steps */
+static bool trace_compact_pc_at(const RzTraceStore *store, ut64 step, ut64 *pc) {
+	RzTraceStoreReader reader;
+	RzTraceStoreRecord record;
+	rz_trace_store_reader_init(&reader, store);
+	while (rz_trace_store_reader_next(&reader, &record)) {
+		if (record.type != RZ_TRACE_STORE_PC) {
+			continue;
+		}
+		if (!step--) {
+			*pc = record.addr;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * \brief Prints the first step executing another instruction in the compact
+ * trace of \p dbg than in its baseline, kept by rz_debug_trace_compact_baseline()
+ *
+ * \return false if there is no baseline or no compact trace to compare
+ */
+RZ_API bool rz_debug_trace_compact_diff_print(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg && dbg->trace, false);
+	RzDebugTrace *t = dbg->trace;
+	if (!t->baseline || !t->store) {
+		return false;
+	}
+	ut64 step = rz_trace_store_diff(t->baseline, t->store);
+	if (step == UT64_MAX) {
+		rz_cons_printf("same %" PFMT64u " steps\n", rz_trace_store_steps(t->store));
+		return true;
+	}
+	ut64 pa, pb;
+	rz_cons_printf("step %" PFMT64u ": ", step);
+	if (trace_compact_pc_at(t->baseline, step, &pa)) {
+		rz_cons_printf("0x%08" PFMT64x, pa);
+	} else {
+		rz_cons_print("end");
+	}
+	rz_cons_print(" -> ");
+	if (trace_compact_pc_at(t->store, step, &pb)) {
+		rz_cons_printf("0x%08" PFMT64x "\n", pb);
+	} else {
+		rz_cons_print("end\n");
+	}
+	return true;
+}
+
 /**
  * \brief Close debug process (Kill debugee and all child processes)
  * \param core The RzCore instance
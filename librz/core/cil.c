@@ -30,6 +30,7 @@ static void core_esil_init(RzCore *core) {
 	rz_analysis_esil_setup(esil, core->analysis, romem, stats, noNULL); // setup io
 	core->analysis->esil = esil;
 	esil->verbose = verbose;
+	rz_analysis_esil_bytecode_enable(esil, rz_config_get_b(core->config, "esil.bytecode"));
 	const char *s = rz_config_get(core->config, "cmd.esil.intr");
 	if (s) {
 		char *my = strdup(s);
@@ -339,7 +340,7 @@ RZ_IPI void rz_core_analysis_esil_emulate(RzCore *core, ut64 addr, ut64 until_ad
 			const char *e = RZ_STRBUF_SAFEGET(&aop.esil);
 			if (e && *e) {
 				// eprintf ("   0x%08llx %d  %s\n", aop.addr, ret, aop.mnemonic);
-				(void)rz_analysis_esil_parse(esil, e);
+				(void)rz_analysis_esil_parse_at(esil, aop.addr, e);
 			}
 		}
 		int inc = (core->search->align > 0) ? core->search->align - 1 : ret - 1;
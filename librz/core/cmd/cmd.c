@@ -5242,14 +5242,149 @@ RZ_API RzCmd *rz_core_cmd_new(bool has_cons) {
 	return res;
 }
 
+/**
+ * Inputs whose parsed tree is kept at most by the parser of the commands
+ */
+#define CMD_PARSER_CACHE_SIZE 128
+
+/**
+ * Longest input whose parsed tree is kept, scripts are seldom run again
+ */
+#define CMD_PARSER_CACHE_MAX_INPUT 512
+
+typedef struct cmd_parsed_t {
+	char *input;
+	TSTree *tree;
+	struct cmd_parsed_t *prev; ///< more recently used
+	struct cmd_parsed_t *next; ///< less recently used
+} CmdParsed;
+
+struct rz_core_cmd_parser_t {
+	TSParser *parser;
+	HtPP /*<char *, CmdParsed *>*/ *ht; ///< recently parsed inputs, by input
+	CmdParsed *head; ///< most recently used
+	CmdParsed *tail; ///< least recently used
+	ut32 count;
+};
+
+static void cmd_parsed_free(CmdParsed *parsed) {
+	ts_tree_delete(parsed->tree);
+	free(parsed->input);
+	free(parsed);
+}
+
+static void cmd_parsed_kv_free(HtPPKv *kv) {
+	free(kv->key);
+}
+
+RZ_IPI void rz_core_cmd_parser_free(RzCoreCmdParser *p) {
+	if (!p) {
+		return;
+	}
+	CmdParsed *parsed = p->head;
+	while (parsed) {
+		CmdParsed *next = parsed->next;
+		cmd_parsed_free(parsed);
+		parsed = next;
+	}
+	ht_pp_free(p->ht);
+	if (p->parser) {
+		ts_parser_delete(p->parser);
+	}
+	free(p);
+}
+
+static RzCoreCmdParser *cmd_parser_get(RzCore *core) {
+	if (core->cmd_parser) {
+		return core->cmd_parser;
+	}
+	RzCoreCmdParser *p = RZ_NEW0(RzCoreCmdParser);
+	if (!p) {
+		return NULL;
+	}
+	p->parser = ts_parser_new();
+	p->ht = ht_pp_new(NULL, cmd_parsed_kv_free, NULL);
+	if (!p->parser || !p->ht || !ts_parser_set_language(p->parser, (TSLanguage *)core->rcmd->language)) {
+		rz_core_cmd_parser_free(p);
+		return NULL;
+	}
+	core->cmd_parser = p;
+	return p;
+}
+
+static void cmd_parsed_unlink(RzCoreCmdParser *p, CmdParsed *parsed) {
+	if (parsed->prev) {
+		parsed->prev->next = parsed->next;
+	} else {
+		p->head = parsed->next;
+	}
+	if (parsed->next) {
+		parsed->next->prev = parsed->prev;
+	} else {
+		p->tail = parsed->prev;
+	}
+	parsed->prev = parsed->next = NULL;
+}
+
+static void cmd_parsed_link_head(RzCoreCmdParser *p, CmdParsed *parsed) {
+	parsed->next = p->head;
+	if (p->head) {
+		p->head->prev = parsed;
+	} else {
+		p->tail = parsed;
+	}
+	p->head = parsed;
+}
+
+/**
+ * Parses \p input, reusing the tree of the same input parsed recently.
+ * The returned tree is owned by the caller.
+ */
+static TSTree *cmd_parser_parse(RzCoreCmdParser *p, const char *input) {
+	size_t len = strlen(input);
+	if (len > CMD_PARSER_CACHE_MAX_INPUT) {
+		return ts_parser_parse_string(p->parser, NULL, input, len);
+	}
+	CmdParsed *parsed = ht_pp_find(p->ht, input, NULL);
+	if (parsed) {
+		if (parsed != p->head) {
+			cmd_parsed_unlink(p, parsed);
+			cmd_parsed_link_head(p, parsed);
+		}
+		return ts_tree_copy(parsed->tree);
+	}
+	TSTree *tree = ts_parser_parse_string(p->parser, NULL, input, len);
+	if (!tree) {
+		return NULL;
+	}
+	parsed = RZ_NEW0(CmdParsed);
+	if (!parsed) {
+		return tree;
+	}
+	parsed->input = strdup(input);
+	parsed->tree = ts_tree_copy(tree);
+	if (!parsed->input || !ht_pp_insert(p->ht, input, parsed)) {
+		cmd_parsed_free(parsed);
+		return tree;
+	}
+	cmd_parsed_link_head(p, parsed);
+	if (++p->count > CMD_PARSER_CACHE_SIZE) {
+		CmdParsed *old = p->tail;
+		cmd_parsed_unlink(p, old);
+		ht_pp_delete(p->ht, old->input);
+		cmd_parsed_free(old);
+		p->count--;
+	}
+	return tree;
+}
+
 static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_lines, bool log) {
-	TSParser *parser = ts_parser_new();
-	bool language_ok = ts_parser_set_language(parser, (TSLanguage *)core->rcmd->language);
-	rz_return_val_if_fail(language_ok, RZ_CMD_STATUS_INVALID);
+	RzCoreCmdParser *parser = cmd_parser_get(core);
+	rz_return_val_if_fail(parser, RZ_CMD_STATUS_INVALID);
 
 	char *input = strdup(rz_str_trim_head_ro(cstr));
 
-	TSTree *tree = ts_parser_parse_string(parser, NULL, input, strlen(input));
+	TSTree *tree = cmd_parser_parse(parser, input);
 	if (!tree) {
 		rz_warn_if_reached();
 		free(input);
@@ -5260,7 +5395,7 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 
 	RzCmdStatus res = RZ_CMD_STATUS_INVALID;
 	struct tsr2cmd_state state;
-	state.parser = parser;
+	state.parser = parser->parser;
 	state.core = core;
 	state.input = input;
 	state.tree = tree;
@@ -5273,9 +5408,13 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 		rz_line_hist_add(state.input);
 	}
 
-	char *ts_str = ts_node_string(root);
-	RZ_LOG_DEBUG("s-expr %s\n", ts_str);
-	free(ts_str);
+#if RZ_BUILD_DEBUG
+	if (rz_log_level_enabled(RZ_LOGLVL_DEBUG)) {
+		char *ts_str = ts_node_string(root);
+		RZ_LOG_DEBUG("s-expr %s\n", ts_str);
+		free(ts_str);
+	}
+#endif
 
 	if (is_ts_statements(root) && !ts_node_has_error(root)) {
 		res = handle_ts_statements(&state, root);
@@ -5286,7 +5425,6 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 	}
 
 	ts_tree_delete(tree);
-	ts_parser_delete(parser);
 	free(input);
 	rz_pvector_fini(&state.saved_input);
 	rz_pvector_fini(&state.saved_tree);
@@ -5515,6 +5653,82 @@ RZ_API char *rz_core_cmd_str(RzCore *core, const char *cmd) {
 	return (char *)core_cmd_raw(core, cmd, NULL);
 }
 
+struct rz_core_prepared_cmd_t {
+	char *name;
+};
+
+/**
+ * \brief Prepares the command \p name to be called many times with different
+ * arguments, without parsing them with the rest of the command line
+ *
+ * The arguments given to rz_core_prepared_cmd_call() are passed as they are,
+ * no quoting, substitution nor redirection is applied to them.
+ *
+ * \param name Name of an existing command, e.g. "pd" or "afij"
+ * \return the prepared command or NULL if \p name is not a command
+ */
+RZ_API RZ_OWN RzCorePreparedCmd *rz_core_cmd_prepare(RZ_NONNULL RzCore *core, RZ_NONNULL const char *name) {
+	rz_return_val_if_fail(core && name, NULL);
+	if (!rz_cmd_get_desc(core->rcmd, name)) {
+		return NULL;
+	}
+	RzCorePreparedCmd *pcmd = RZ_NEW0(RzCorePreparedCmd);
+	if (!pcmd) {
+		return NULL;
+	}
+	pcmd->name = strdup(name);
+	if (!pcmd->name) {
+		free(pcmd);
+		return NULL;
+	}
+	return pcmd;
+}
+
+RZ_API void rz_core_prepared_cmd_free(RZ_NULLABLE RzCorePreparedCmd *pcmd) {
+	if (!pcmd) {
+		return;
+	}
+	free(pcmd->name);
+	free(pcmd);
+}
+
+/**
+ * \brief Calls the prepared command \p pcmd with the \p argc arguments in \p argv
+ */
+RZ_API RzCmdStatus rz_core_prepared_cmd_call(RZ_NONNULL RzCore *core, RZ_NONNULL RzCorePreparedCmd *pcmd, int argc, RZ_NULLABLE const char **argv) {
+	rz_return_val_if_fail(core && pcmd && argc >= 0 && (!argc || argv), RZ_CMD_STATUS_INVALID);
+	RzCmdParsedArgs *args = rz_cmd_parsed_args_new(pcmd->name, argc, (char **)argv);
+	if (!args) {
+		return RZ_CMD_STATUS_INVALID;
+	}
+	args->has_space_after_cmd = argc > 0;
+	RzCmdStatus res = rz_cmd_call_parsed_args(core->rcmd, args);
+	rz_cmd_parsed_args_free(args);
+	return res;
+}
+
+/**
+ * \brief Calls the prepared command \p pcmd with the \p argc arguments in
+ * \p argv and returns its stdout as a string
+ */
+RZ_API RZ_OWN char *rz_core_prepared_cmd_str(RZ_NONNULL RzCore *core, RZ_NONNULL RzCorePreparedCmd *pcmd, int argc, RZ_NULLABLE const char **argv) {
+	rz_return_val_if_fail(core && pcmd && argc >= 0 && (!argc || argv), NULL);
+	rz_cons_push();
+	bool is_pipe = core->is_pipe;
+	core->is_pipe = true;
+	RzCmdStatus res = rz_core_prepared_cmd_call(core, pcmd, argc, argv);
+	core->is_pipe = is_pipe;
+	if (res != RZ_CMD_STATUS_OK) {
+		rz_cons_pop();
+		return NULL;
+	}
+	rz_cons_filter();
+	char *retstr = strdup(rz_str_get(rz_cons_get_buffer()));
+	rz_cons_pop();
+	rz_cons_echo(NULL);
+	return retstr;
+}
+
 /**
  * \brief Executes a rizin command and returns the raw stdout and its length
  */
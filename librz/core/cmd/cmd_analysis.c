@@ -1011,6 +1011,7 @@ static ut64 initializeEsil(RzCore *core) {
 	esil->verbose = rz_config_get_i(core->config, "esil.verbose");
 	esil->cmd = rz_core_esil_cmd;
 	rz_analysis_esil_setup(esil, core->analysis, romem, stats, noNULL); // setup io
+	rz_analysis_esil_bytecode_enable(esil, rz_config_get_b(core->config, "esil.bytecode"));
 	{
 		const char *cmd_esil_step = rz_config_get(core->config, "cmd.esil.step");
 		if (cmd_esil_step && *cmd_esil_step) {
@@ -1164,7 +1165,7 @@ repeat:
 			rz_debug_trace_op(core->dbg, &op);
 			core->dbg->reg = reg;
 		} else if (RZ_STR_ISNOTEMPTY(e)) {
-			rz_analysis_esil_parse(esil, e);
+			rz_analysis_esil_parse_at(esil, addr, e);
 			if (core->analysis->cur && core->analysis->cur->esil_post_loop) {
 				core->analysis->cur->esil_post_loop(esil, &op);
 			}
@@ -1203,7 +1204,7 @@ repeat:
 				}
 				const char *e = RZ_STRBUF_SAFEGET(&op2.esil);
 				if (RZ_STR_ISNOTEMPTY(e)) {
-					rz_analysis_esil_parse(esil, e);
+					rz_analysis_esil_parse_at(esil, naddr, e);
 				}
 			} else {
 				eprintf("Invalid instruction at 0x%08" PFMT64x "\n", naddr);
@@ -2253,6 +2253,30 @@ RZ_IPI RzCmdStatus rz_cmd_debug_trace_tag_handler(RzCore *core, int argc, const
 	return RZ_CMD_STATUS_OK;
 }
 
+// dtv
+RZ_IPI RzCmdStatus rz_cmd_debug_trace_compact_coverage_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	rz_debug_trace_compact_print(core->dbg, state);
+	return RZ_CMD_STATUS_OK;
+}
+
+// dtvb
+RZ_IPI RzCmdStatus rz_cmd_debug_trace_compact_baseline_handler(RzCore *core, int argc, const char **argv) {
+	if (!rz_debug_trace_compact_baseline(core->dbg)) {
+		RZ_LOG_ERROR("No compact trace recorded, see dbg.trace.compact\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+// dtvd
+RZ_IPI RzCmdStatus rz_cmd_debug_trace_compact_diff_handler(RzCore *core, int argc, const char **argv) {
+	if (!rz_debug_trace_compact_diff_print(core->dbg)) {
+		RZ_LOG_ERROR("No baseline or compact trace to compare, see dtvb\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 static char *get_corefile_name(const char *raw_name, int pid) {
 	return (!*raw_name) ? rz_str_newf("core.%u", pid) : rz_str_trim_dup(raw_name);
 }
@@ -3232,6 +3256,100 @@ RZ_IPI RzCmdStatus rz_cmd_debug_set_cond_bp_win_handler(RzCore *core, int argc,
 	return RZ_CMD_STATUS_OK;
 }
 
+static size_t coverage_bp_add_function(RzCore *core, RzAnalysisFunction *fcn) {
+	size_t count = 0;
+	RzListIter *iter;
+	RzAnalysisBlock *bb;
+	rz_list_foreach (fcn->bbs, iter, bb) {
+		if (bb->size && rz_bp_coverage_add(core->dbg->bp, bb->addr, (ut32)bb->size)) {
+			count++;
+		}
+	}
+	return count;
+}
+
+// dbk
+RZ_IPI RzCmdStatus rz_cmd_debug_add_coverage_bp_handler(RzCore *core, int argc, const char **argv) {
+	RzAnalysisFunction *fcn = rz_analysis_get_fcn_in(core->analysis, core->offset, 0);
+	if (!fcn) {
+		RZ_LOG_ERROR("No function found at 0x%08" PFMT64x "\n", core->offset);
+		return RZ_CMD_STATUS_ERROR;
+	}
+	coverage_bp_add_function(core, fcn);
+	return RZ_CMD_STATUS_OK;
+}
+
+// dbka
+RZ_IPI RzCmdStatus rz_cmd_debug_add_coverage_bp_all_handler(RzCore *core, int argc, const char **argv) {
+	size_t count = 0;
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach (core->analysis->fcns, iter, fcn) {
+		count += coverage_bp_add_function(core, fcn);
+	}
+	RZ_LOG_INFO("Added %" PFMTSZu " coverage breakpoints\n", count);
+	return RZ_CMD_STATUS_OK;
+}
+
+// dbkl
+RZ_IPI RzCmdStatus rz_cmd_debug_list_coverage_bp_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	const RzVector *hits = rz_bp_coverage_hits(core->dbg->bp);
+	if (!hits) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	PJ *pj = state->d.pj;
+	rz_cmd_state_output_array_start(state);
+	RzBreakpointCoverageHit *hit;
+	rz_vector_foreach(hits, hit) {
+		switch (state->mode) {
+		case RZ_OUTPUT_MODE_STANDARD:
+			rz_cons_printf("0x%08" PFMT64x " %" PFMT32u "\n", hit->addr, hit->size);
+			break;
+		case RZ_OUTPUT_MODE_JSON:
+			pj_o(pj);
+			pj_kN(pj, "addr", hit->addr);
+			pj_kn(pj, "size", hit->size);
+			pj_end(pj);
+			break;
+		case RZ_OUTPUT_MODE_QUIET:
+			rz_cons_printf("0x%08" PFMT64x "\n", hit->addr);
+			break;
+		default:
+			rz_warn_if_reached();
+			break;
+		}
+	}
+	rz_cmd_state_output_array_end(state);
+	if (state->mode == RZ_OUTPUT_MODE_STANDARD) {
+		rz_cons_printf("%" PFMTSZu " blocks hit, %" PFMTSZu " pending\n",
+			rz_vector_len(hits), rz_bp_coverage_pending(core->dbg->bp));
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+// dbk-
+RZ_IPI RzCmdStatus rz_cmd_debug_remove_coverage_bp_handler(RzCore *core, int argc, const char **argv) {
+	rz_bp_coverage_reset(core->dbg->bp);
+	return RZ_CMD_STATUS_OK;
+}
+
+// dbkd
+RZ_IPI RzCmdStatus rz_cmd_debug_save_coverage_bp_drcov_handler(RzCore *core, int argc, const char **argv) {
+	rz_debug_map_sync(core->dbg);
+	RzBuffer *buf = rz_buf_new_file(argv[1], O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (!buf) {
+		RZ_LOG_ERROR("Cannot open %s for writing\n", argv[1]);
+		return RZ_CMD_STATUS_ERROR;
+	}
+	bool ret = rz_debug_coverage_drcov(core->dbg, buf);
+	rz_buf_free(buf);
+	if (!ret) {
+		RZ_LOG_ERROR("Cannot write the coverage to %s\n", argv[1]);
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 // dc
 RZ_IPI RzCmdStatus rz_cmd_debug_continue_execution_handler(RzCore *core, int argc, const char **argv) {
 	CMD_CHECK_DEBUG_DEAD(core);
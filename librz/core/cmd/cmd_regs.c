@@ -754,6 +754,7 @@ RZ_IPI RzCmdStatus rz_reg_profile_comments_handler(RzCore *core, RzReg *reg, int
 
 RZ_IPI RzCmdStatus rz_reg_profile_open_handler(RzCore *core, RzReg *reg, int argc, const char **argv) {
 	rz_return_val_if_fail(argc > 1, RZ_CMD_STATUS_WRONG_ARGS);
+	rz_analysis_op_cache_clear(core->analysis);
 	rz_reg_set_profile(reg, argv[1]);
 	return RZ_CMD_STATUS_OK;
 }
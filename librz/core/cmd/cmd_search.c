@@ -167,16 +167,131 @@ struct search_parameters {
 	bool privkey_search;
 };
 
-struct endlist_pair {
-	int instr_offset;
-	int delay_size;
-};
+/**
+ * Offsets carved by each thread in a round of /h
+ */
+#define HASH_CARVE_ROUND 0x100000
+
+/**
+ * Expected digest of /h, compared to the raw digest of each block
+ */
+typedef struct {
+	const RzMsgDigestPlugin *plugin;
+	ut8 *digest;
+	RzMsgDigestSize digest_size;
+	const char *string; ///< expected entropy, whose digest is compared as a string
+	ut32 len; ///< bytes of a block
+} HashCarve;
+
+typedef struct {
+	const HashCarve *hc;
+	void *context;
+	ut8 *digest;
+	const ut8 *buf; ///< bytes of the round, from the first offset
+	size_t first;
+	size_t last;
+	size_t found; ///< first matching offset of [first, last), or last
+} HashCarveShard;
+
+static bool hash_carve_digest_eq(const HashCarve *hc, const ut8 *digest) {
+	if (!hc->string) {
+		return !memcmp(digest, hc->digest, hc->digest_size);
+	}
+	char s[64];
+	rz_strf(s, "%.8f", rz_read_be_double(digest));
+	return !strcmp(s, hc->string);
+}
+
+/**
+ * Looks for the first block of the shard matching the expected digest. The
+ * rolling digests are slid from one offset to the next one instead of hashing
+ * the whole block again.
+ */
+static void hash_carve_shard(HashCarveShard *shard) {
+	const HashCarve *hc = shard->hc;
+	const RzMsgDigestPlugin *plugin = hc->plugin;
+	shard->found = shard->last;
+	for (size_t i = shard->first; i < shard->last; i++) {
+		if (plugin->roll && i > shard->first) {
+			plugin->roll(shard->context, shard->buf[i - 1], shard->buf[i + hc->len - 1], hc->len);
+		} else {
+			plugin->init(shard->context);
+			plugin->update(shard->context, shard->buf + i, hc->len);
+		}
+		if (!plugin->final(shard->context, shard->digest)) {
+			break;
+		}
+		if (hash_carve_digest_eq(hc, shard->digest)) {
+			shard->found = i;
+			break;
+		}
+	}
+}
+
+static RzThreadFunctionRet hash_carve_shard_runner(RzThread *th) {
+	hash_carve_shard(rz_th_get_user(th));
+	return RZ_TH_STOP;
+}
+
+/**
+ * Carves the blocks of [from, to), read by rounds split between the shards.
+ * Returns the address of the first matching block, or UT64_MAX.
+ */
+static ut64 hash_carve_range(RzCore *core, HashCarve *hc, HashCarveShard *shards, size_t nshards, ut8 *buf, ut64 from, ut64 to) {
+	const ut64 end = to - hc->len + 1; // after the last block
+	ut64 at = from;
+	while (at < end && !rz_cons_is_breaked()) {
+		const size_t noffsets = RZ_MIN(end - at, nshards * HASH_CARVE_ROUND);
+		(void)rz_io_read_at(core->io, at, buf, noffsets + hc->len - 1);
+		const size_t per_shard = (noffsets + nshards - 1) / nshards;
+		for (size_t t = 0; t < nshards; t++) {
+			HashCarveShard *shard = &shards[t];
+			shard->buf = buf;
+			shard->first = RZ_MIN(noffsets, t * per_shard);
+			shard->last = RZ_MIN(noffsets, shard->first + per_shard);
+		}
+		if (nshards == 1) {
+			hash_carve_shard(&shards[0]);
+		} else {
+			RzThreadPool *pool = rz_th_pool_new(nshards);
+			if (!pool) {
+				RZ_LOG_ERROR("cannot allocate the thread pool\n");
+				break;
+			}
+			for (size_t t = 0; t < nshards; t++) {
+				HashCarveShard *shard = &shards[t];
+				if (shard->first == shard->last) {
+					shard->found = shard->last;
+					continue;
+				}
+				RzThread *th = rz_th_new(hash_carve_shard_runner, shard, 0);
+				if (!th || !rz_th_pool_add_thread(pool, th)) {
+					// carve this shard from here instead
+					rz_th_free(th);
+					hash_carve_shard(shard);
+				}
+			}
+			rz_th_pool_wait(pool);
+			rz_th_pool_free(pool);
+		}
+		for (size_t t = 0; t < nshards; t++) {
+			if (shards[t].found < shards[t].last) {
+				return at + shards[t].found;
+			}
+		}
+		at += noffsets;
+	}
+	return UT64_MAX;
+}
 
+/**
+ * Looks for the first block of each length in [minlen, maxlen] whose digest
+ * is \p hashstr, streaming the maps and comparing the raw digests.
+ */
 static int search_hash(RzCore *core, const char *hashname, const char *hashstr, ut32 minlen, ut32 maxlen, struct search_parameters *param) {
 	RzIOMap *map;
-	ut8 *buf;
-	int i, j;
 	RzListIter *iter;
+	int ret = 0;
 
 	if (!minlen || minlen == UT32_MAX) {
 		minlen = core->blocksize;
@@ -185,61 +300,102 @@ static int search_hash(RzCore *core, const char *hashname, const char *hashstr,
 		maxlen = minlen;
 	}
 
+	HashCarve hc = { 0 };
+	hc.plugin = rz_msg_digest_plugin_by_name(hashname);
+	if (!hc.plugin) {
+		RZ_LOG_ERROR("/h: unknown hash '%s'\n", hashname);
+		return -1;
+	}
+	size_t nshards = rz_th_physical_core_number();
+	size_t max_threads = rz_config_get_i(core->config, "search.threads");
+	if (max_threads) {
+		nshards = RZ_MIN(nshards, max_threads);
+	}
+	nshards = RZ_MAX(nshards, 1);
+	HashCarveShard *shards = RZ_NEWS0(HashCarveShard, nshards);
+	ut8 *buf = NULL;
+	if (!shards) {
+		return -1;
+	}
+	for (size_t t = 0; t < nshards; t++) {
+		HashCarveShard *shard = &shards[t];
+		shard->hc = &hc;
+		shard->context = hc.plugin->context_new();
+		if (!shard->context) {
+			ret = -1;
+			goto beach;
+		}
+		hc.digest_size = hc.plugin->digest_size(shard->context);
+		shard->digest = malloc(hc.digest_size);
+		if (!shard->digest) {
+			ret = -1;
+			goto beach;
+		}
+	}
+	if (!strncmp(hashname, "entropy", 7)) {
+		hc.string = hashstr;
+	} else {
+		hc.digest = calloc(1, strlen(hashstr) / 2 + 1);
+		if (!hc.digest) {
+			ret = -1;
+			goto beach;
+		}
+		if (rz_hex_str2bin(hashstr, hc.digest) != hc.digest_size) {
+			RZ_LOG_ERROR("/h: '%s' is not a %u bytes %s digest\n", hashstr, hc.digest_size, hashname);
+			ret = -1;
+			goto beach;
+		}
+	}
+	buf = malloc(nshards * HASH_CARVE_ROUND + maxlen);
+	if (!buf) {
+		RZ_LOG_ERROR("/h: cannot allocate the blocks to carve\n");
+		ret = -1;
+		goto beach;
+	}
+
 	rz_cons_break_push(NULL, NULL);
-	for (j = minlen; j <= maxlen; j++) {
-		ut32 len = j;
-		eprintf("Searching %s for %d byte length.\n", hashname, j);
+	for (ut32 len = minlen; len <= maxlen && !rz_cons_is_breaked(); len++) {
+		hc.len = len;
+		eprintf("Searching %s for %u byte length.\n", hashname, len);
 		rz_list_foreach (param->boundaries, iter, map) {
 			if (rz_cons_is_breaked()) {
 				break;
 			}
 			ut64 from = map->itv.addr, to = rz_itv_end(map->itv);
-			st64 bufsz;
-			bufsz = to - from;
-			if (len > bufsz) {
+			if (len > to - from) {
 				eprintf("Hash length is bigger than range 0x%" PFMT64x "\n", from);
 				continue;
 			}
-			buf = malloc(bufsz);
-			if (!buf) {
-				eprintf("Cannot allocate %" PFMT64d " bytes\n", bufsz);
-				goto fail;
-			}
 			eprintf("Search in range 0x%08" PFMT64x " and 0x%08" PFMT64x "\n", from, to);
-			int blocks = (int)(to - from - len);
-			eprintf("Carving %d blocks...\n", blocks);
-			(void)rz_io_read_at(core->io, from, buf, bufsz);
-			for (i = 0; (from + i + len) < to; i++) {
-				if (rz_cons_is_breaked()) {
-					break;
-				}
-				char *s = rz_msg_digest_calculate_small_block_string(hashname, buf + i, len, NULL, false);
-				if (!s) {
-					eprintf("Hash fail\n");
-					break;
-				}
-				if (!(i % 5)) {
-					eprintf("%d\r", i);
-				}
-				// eprintf ("0x%08"PFMT64x" %s\n", from+i, s);
-				if (!strcmp(s, hashstr)) {
-					eprintf("Found at 0x%" PFMT64x "\n", from + i);
-					rz_cons_printf("f hash.%s.%s @ 0x%" PFMT64x "\n",
-						hashname, hashstr, from + i);
-					free(s);
-					free(buf);
-					return 1;
-				}
-				free(s);
+			eprintf("Carving %" PFMT64u " blocks...\n", to - from - len + 1);
+			ut64 found = hash_carve_range(core, &hc, shards, nshards, buf, from, to);
+			if (found != UT64_MAX) {
+				eprintf("Found at 0x%" PFMT64x "\n", found);
+				rz_cons_printf("f hash.%s.%s @ 0x%" PFMT64x "\n", hashname, hashstr, found);
+				ret = 1;
+				break;
 			}
-			free(buf);
+		}
+		if (ret) {
+			break;
 		}
 	}
 	rz_cons_break_pop();
-	eprintf("No hashes found\n");
-	return 0;
-fail:
-	return -1;
+	if (!ret) {
+		eprintf("No hashes found\n");
+	}
+
+beach:
+	for (size_t t = 0; t < nshards; t++) {
+		if (shards[t].context) {
+			hc.plugin->context_free(shards[t].context);
+		}
+		free(shards[t].digest);
+	}
+	free(shards);
+	free(hc.digest);
+	free(buf);
+	return ret;
 }
 
 static void cmd_search_bin(RzCore *core, RzInterval itv) {
@@ -947,179 +1103,6 @@ RZ_API RZ_OWN RzList *rz_core_get_boundaries_prot(RzCore *core, int perm, const
 	return list;
 }
 
-static bool is_end_gadget(const RzAnalysisOp *aop, const ut8 crop) {
-	if (aop->family == RZ_ANALYSIS_OP_FAMILY_SECURITY) {
-		return false;
-	}
-	switch (aop->type) {
-	case RZ_ANALYSIS_OP_TYPE_TRAP:
-	case RZ_ANALYSIS_OP_TYPE_RET:
-	case RZ_ANALYSIS_OP_TYPE_UCALL:
-	case RZ_ANALYSIS_OP_TYPE_RCALL:
-	case RZ_ANALYSIS_OP_TYPE_ICALL:
-	case RZ_ANALYSIS_OP_TYPE_IRCALL:
-	case RZ_ANALYSIS_OP_TYPE_UJMP:
-	case RZ_ANALYSIS_OP_TYPE_RJMP:
-	case RZ_ANALYSIS_OP_TYPE_IJMP:
-	case RZ_ANALYSIS_OP_TYPE_IRJMP:
-	case RZ_ANALYSIS_OP_TYPE_JMP:
-	case RZ_ANALYSIS_OP_TYPE_CALL:
-		return true;
-	}
-	if (crop) { // if conditional jumps, calls and returns should be used for the gadget-search too
-		switch (aop->type) {
-		case RZ_ANALYSIS_OP_TYPE_CJMP:
-		case RZ_ANALYSIS_OP_TYPE_UCJMP:
-		case RZ_ANALYSIS_OP_TYPE_CCALL:
-		case RZ_ANALYSIS_OP_TYPE_UCCALL:
-		case RZ_ANALYSIS_OP_TYPE_CRET:
-			return true;
-		}
-	}
-	return false;
-}
-
-static bool insert_into(void *user, const ut64 k, const ut64 v) {
-	HtUU *ht = (HtUU *)user;
-	ht_uu_insert(ht, k, v);
-	return true;
-}
-
-// TODO: follow unconditional jumps
-static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int buflen, int idx, const char *grep, int regex, RzList *rx_list, struct endlist_pair *end_gadget, HtUU *badstart) {
-	int endaddr = end_gadget->instr_offset;
-	int branch_delay = end_gadget->delay_size;
-	RzAnalysisOp aop = { 0 };
-	const char *start = NULL, *end = NULL;
-	char *grep_str = NULL;
-	RzCoreAsmHit *hit = NULL;
-	RzList *hitlist = rz_core_asm_hit_list_new();
-	ut8 nb_instr = 0;
-	const ut8 max_instr = rz_config_get_i(core->config, "rop.len");
-	bool valid = false;
-	int grep_find;
-	int search_hit;
-	char *rx = NULL;
-	HtUUOptions opt = { 0 };
-	HtUU *localbadstart = ht_uu_new_opt(&opt);
-	int count = 0;
-
-	if (grep) {
-		start = grep;
-		end = strchr(grep, ';');
-		if (!end) { // We filter on a single opcode, so no ";"
-			end = start + strlen(grep);
-		}
-		grep_str = calloc(1, end - start + 1);
-		strncpy(grep_str, start, end - start);
-		if (regex) {
-			// get the first regexp.
-			if (rz_list_length(rx_list) > 0) {
-				rx = rz_list_get_n(rx_list, count++);
-			}
-		}
-	}
-
-	bool found;
-	ht_uu_find(badstart, idx, &found);
-	if (found) {
-		valid = false;
-		goto ret;
-	}
-	while (nb_instr < max_instr) {
-		ht_uu_insert(localbadstart, idx, 1);
-
-		int error = rz_analysis_op(core->analysis, &aop, addr, buf + idx, buflen - idx, RZ_ANALYSIS_OP_MASK_DISASM);
-		if (error < 0 || (nb_instr == 0 && (is_end_gadget(&aop, 0) || aop.type == RZ_ANALYSIS_OP_TYPE_NOP))) {
-			valid = false;
-			goto ret;
-		}
-
-		const int opsz = aop.size;
-		// opsz = rz_strbuf_length (asmop.buf);
-		char *opst = aop.mnemonic;
-		if (!opst) {
-			RZ_LOG_WARN("Analysis plugin %s did not return disassembly\n", core->analysis->cur->name);
-			RzAsmOp asmop;
-			rz_asm_set_pc(core->rasm, addr);
-			if (rz_asm_disassemble(core->rasm, &asmop, buf + idx, buflen - idx) < 0) {
-				valid = false;
-				goto ret;
-			}
-			opst = strdup(rz_asm_op_get_asm(&asmop));
-			rz_asm_op_fini(&asmop);
-		}
-		if (!rz_str_ncasecmp(opst, "invalid", strlen("invalid")) ||
-			!rz_str_ncasecmp(opst, ".byte", strlen(".byte"))) {
-			valid = false;
-			goto ret;
-		}
-
-		hit = rz_core_asm_hit_new();
-		if (hit) {
-			hit->addr = addr;
-			hit->len = opsz;
-			rz_list_append(hitlist, hit);
-		}
-
-		// Move on to the next instruction
-		idx += opsz;
-		addr += opsz;
-		if (rx) {
-			grep_find = !rz_regex_match(rx, "e", opst);
-			search_hit = (end && grep && (grep_find < 1));
-		} else {
-			search_hit = (end && grep && strstr(opst, grep_str));
-		}
-
-		// Handle (possible) grep
-		if (search_hit) {
-			if (end[0] == ';') { // fields are semicolon-separated
-				start = end + 1; // skip the ;
-				end = strchr(start, ';');
-				end = end ? end : start + strlen(start); // latest field?
-				free(grep_str);
-				grep_str = calloc(1, end - start + 1);
-				if (grep_str) {
-					strncpy(grep_str, start, end - start);
-				}
-			} else {
-				end = NULL;
-			}
-			if (regex) {
-				rx = rz_list_get_n(rx_list, count++);
-			}
-		}
-		if (endaddr <= (idx - opsz)) {
-			valid = (endaddr == idx - opsz);
-			goto ret;
-		}
-		rz_analysis_op_fini(&aop);
-		nb_instr++;
-	}
-ret:
-	rz_analysis_op_fini(&aop);
-	free(grep_str);
-	if (regex && rx) {
-		rz_list_free(hitlist);
-		ht_uu_free(localbadstart);
-		return NULL;
-	}
-	if (!valid || (grep && end)) {
-		rz_list_free(hitlist);
-		ht_uu_free(localbadstart);
-		return NULL;
-	}
-	ht_uu_foreach(localbadstart, insert_into, badstart);
-	ht_uu_free(localbadstart);
-	// If our arch has bds then we better be including them
-	if (branch_delay && rz_list_length(hitlist) < (1 + branch_delay)) {
-		rz_list_free(hitlist);
-		return NULL;
-	}
-	return hitlist;
-}
-
 static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 	const char *otype;
 	RzCoreAsmHit *hit = NULL;
@@ -1288,9 +1271,10 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 	const ut8 max_instr = rz_config_get_i(core->config, "rop.len");
 	const char *arch = rz_config_get(core->config, "asm.arch");
 	int max_count = rz_config_get_i(core->config, "search.maxhits");
-	int i = 0, end = 0, mode = 0, increment = 1, ret, result = true;
-	RzList /*<endlist_pair>*/ *end_list = rz_list_newf(free);
+	int i = 0, mode = 0, increment = 1, result = true;
 	RzList /*<RzRegex>*/ *rx_list = NULL;
+	RzCoreRopIndex *index;
+	RopQuery query;
 	int align = core->search->align;
 	RzListIter *itermap = NULL;
 	char *tok, *gregexp = NULL;
@@ -1299,7 +1283,6 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 	int delta = 0;
 	ut8 *buf;
 	RzIOMap *map;
-	RzAsmOp asmop;
 
 	Sdb *gadgetSdb = NULL;
 	if (rz_config_get_i(core->config, "rop.sdb")) {
@@ -1311,7 +1294,6 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 		max_count = -1;
 	}
 	if (max_instr <= 1) {
-		rz_list_free(end_list);
 		eprintf("ROP length (rop.len) must be greater than 1.\n");
 		if (max_instr == 1) {
 			eprintf("For rop.len = 1, use /c to search for single "
@@ -1365,14 +1347,20 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 			tok = strtok(NULL, ";");
 		}
 	}
+	index = rop_index_get(core, increment, crop);
+	if (!index) {
+		free(grep_arg);
+		free(gregexp);
+		rz_list_free(rx_list);
+		return false;
+	}
+	rop_query_init(&query, index, grep, regexp, rx_list);
 	if (param->outmode == RZ_MODE_JSON) {
 		pj_a(param->pj);
 	}
 	rz_cons_break_push(NULL, NULL);
 
 	rz_list_foreach (param->boundaries, itermap, map) {
-		HtUUOptions opt = { 0 };
-		HtUU *badstart = ht_uu_new_opt(&opt);
 		if (!rz_itv_overlap(search_itv, map->itv)) {
 			continue;
 		}
@@ -1389,56 +1377,33 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 		}
 		(void)rz_io_read_at(core->io, from, buf, delta);
 
-		// Find the end gadgets.
-		for (i = 0; i + 32 < delta; i += increment) {
-			RzAnalysisOp end_gadget = RZ_EMPTY;
-			// Disassemble one.
-			if (rz_analysis_op(core->analysis, &end_gadget, from + i, buf + i,
-				    delta - i, RZ_ANALYSIS_OP_MASK_BASIC) < 1) {
-				rz_analysis_op_fini(&end_gadget);
-				continue;
-			}
-			if (is_end_gadget(&end_gadget, crop)) {
-#if 0
-				if (search->maxhits && rz_list_length (end_list) >= search->maxhits) {
-					// limit number of high level rop gadget results
-					rz_analysis_op_fini (&end_gadget);
-					break;
-				}
-#endif
-				struct endlist_pair *epair = RZ_NEW0(struct endlist_pair);
-				if (epair) {
-					// If this arch has branch delay slots, add the next instr as well
-					if (end_gadget.delay) {
-						epair->instr_offset = i + increment;
-						epair->delay_size = end_gadget.delay;
-					} else {
-						epair->instr_offset = (intptr_t)i;
-						epair->delay_size = end_gadget.delay;
-					}
-					rz_list_append(end_list, (void *)(intptr_t)epair);
-				}
-			}
-			rz_analysis_op_fini(&end_gadget);
+		// Find the end gadgets, or take them from the index.
+		RopMap *rop_map = rop_index_map(core, index, from, buf, delta, increment, crop);
+		if (!rop_map) {
+			free(buf);
 			if (rz_cons_is_breaked()) {
 				break;
 			}
-			// Right now we have a list of all of the end/stop gadgets.
-			// We can just construct gadgets from a little bit before them.
+			result = false;
+			goto bad;
 		}
-		rz_list_reverse(end_list);
+		HtUUOptions opt = { 0 };
+		HtUU *badstart = ht_uu_new_opt(&opt);
 		// If we have no end gadgets, just skip all of this search nonsense.
-		if (!rz_list_empty(end_list)) {
+		if (!rz_vector_empty(&rop_map->ends)) {
 			int prev, next, ropdepth;
+			size_t end_idx = 0;
 			const int max_inst_size_x86 = 15;
 			// Get the depth of rop search, should just be max_instr
 			// instructions, x86 and friends are weird length instructions, so
 			// we'll just assume 15 byte instructions.
 			ropdepth = increment == 1 ? max_instr * max_inst_size_x86 /* wow, x86 is long */ : max_instr * increment;
 			if (rz_cons_is_breaked()) {
+				ht_uu_free(badstart);
+				free(buf);
 				break;
 			}
-			struct endlist_pair *end_gadget = (struct endlist_pair *)rz_list_pop(end_list);
+			struct endlist_pair *end_gadget = rz_vector_index_ptr(&rop_map->ends, end_idx++);
 			next = end_gadget->instr_offset;
 			prev = 0;
 			// Start at just before the first end gadget.
@@ -1462,10 +1427,9 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 				if (i >= next) {
 					// We've exhausted the first end-gadget section,
 					// move to the next one.
-					free(end_gadget);
-					if (rz_list_get_n(end_list, 0)) {
+					if (end_idx < rz_vector_len(&rop_map->ends)) {
 						prev = i;
-						end_gadget = (struct endlist_pair *)rz_list_pop(end_list);
+						end_gadget = rz_vector_index_ptr(&rop_map->ends, end_idx++);
 						next = end_gadget->instr_offset;
 						i = next - ropdepth;
 						if (i < 0) {
@@ -1475,21 +1439,18 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 						break;
 					}
 				}
-				if (i >= end) { // read by chunk of 4k
-					rz_io_read_at(core->io, from + i, buf + i,
-						RZ_MIN((delta - i), 4096));
-					end = i + 2048;
-				}
-				ret = rz_asm_disassemble(core->rasm, &asmop, buf + i, delta - i);
-				if (ret) {
-					rz_asm_set_pc(core->rasm, from + i);
-					RzList *hitlist = construct_rop_gadget(core,
-						from + i, buf, delta, i, grep, regexp,
-						rx_list, end_gadget, badstart);
+				RopCandidate *cand = rop_index_candidate(core, index, rop_map, buf, i, end_gadget);
+				if (!cand) {
+					result = false;
+					break;
+				}
+				if (cand->asm_ok) {
+					RzList *hitlist = rop_candidate_hits(&query, cand, from, i, badstart);
 					if (!hitlist) {
 						continue;
 					}
 					if (align && (0 != ((from + i) % align))) {
+						rz_list_free(hitlist);
 						continue;
 					}
 					if (gadgetSdb) {
@@ -1539,6 +1500,7 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 				}
 			}
 		}
+		ht_uu_free(badstart);
 		free(buf);
 	}
 	if (rz_cons_is_breaked()) {
@@ -1550,8 +1512,8 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 		pj_end(param->pj);
 	}
 bad:
+	rop_query_fini(&query);
 	rz_list_free(rx_list);
-	rz_list_free(end_list);
 	free(grep_arg);
 	free(gregexp);
 	return result;
@@ -2364,6 +2326,7 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 				   from1 = search->bckwrds ? to : from,
 				   to1 = search->bckwrds ? from : to;
 			ut64 len;
+			RzIOView view;
 			for (at = from1; at != to1; at = search->bckwrds ? at - len : at + len) {
 				print_search_progress(at, to1, search->nhits, param);
 				if (rz_cons_is_breaked()) {
@@ -2376,15 +2339,17 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 					if (!rz_io_is_valid_offset(core->io, at - len, 0)) {
 						break;
 					}
+					// backward search reverses the block in place, so it always needs a copy
 					(void)rz_io_read_at(core->io, at - len, buf, len);
+					view.data = buf;
 				} else {
 					len = RZ_MIN(core->blocksize, to - at);
 					if (!rz_io_is_valid_offset(core->io, at, 0)) {
 						break;
 					}
-					(void)rz_io_read_at(core->io, at, buf, len);
+					(void)rz_io_view_at(core->io, at, buf, len, &view);
 				}
-				rz_search_update(core->search, at, buf, len);
+				rz_search_update(core->search, at, view.data, len);
 				if (param->aes_search) {
 					// Adjust length to search between blocks.
 					if (len == core->blocksize) {
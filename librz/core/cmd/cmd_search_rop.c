@@ -727,3 +727,662 @@ static void rop_classify(RzCore *core, Sdb *db, RzList *ropList, const char *key
 
 	free(str);
 }
+
+/**
+ * \name ROP gadget index
+ *
+ * The end gadgets of a map and the decoding of the gadgets ending there do
+ * not depend on the grep of /R, so they are kept in core->rop_index, by the
+ * bytes of the map and the options they were found with. Each /R replays the
+ * search over them, decoding only the candidates not tried yet. The end
+ * gadgets are found by several threads when the analysis plugin can decode
+ * from other threads.
+ *
+ * Each distinct instruction sequence is kept once, and the gadgets using an
+ * instruction are indexed by it. A grep field is matched once per distinct
+ * instruction, and the gadgets without any instruction matching the first
+ * field are skipped by a lookup.
+ */
+
+/**
+ * Bytes of a map scanned by a thread at least when looking for end gadgets
+ */
+#define ROP_INDEX_SHARD_MIN 0x10000
+
+struct endlist_pair {
+	int instr_offset;
+	int delay_size;
+};
+
+typedef struct {
+	int len;
+	const char *opstr; ///< interned in RzCoreRopIndex.opstrs
+} RopInsn;
+
+/**
+ * Instruction sequence of the gadgets, kept once for all the places it is found at
+ */
+typedef struct {
+	ut32 id; ///< in indexing order
+	RzVector /*<RopInsn>*/ insns;
+} RopGadget;
+
+/**
+ * Gadget starting at an offset of a map and ending at one of its end gadgets
+ */
+typedef struct {
+	bool asm_ok; ///< the first instruction can be disassembled
+	bool valid; ///< the instructions reach the end gadget, whatever the grep
+	bool short_delay; ///< valid, but without all the delay slots of the end gadget
+	RopGadget *gadget; ///< NULL without any instruction
+} RopCandidate;
+
+typedef struct {
+	ut64 from;
+	ut64 size;
+	ut32 checksum; ///< rz_hash_xxhash() of the bytes
+	RzVector /*<struct endlist_pair>*/ ends; ///< in address order
+	HtUP /*<ut64, RopCandidate *>*/ *cands; ///< by start offset and end gadget offset
+} RopMap;
+
+struct rz_core_rop_index_t {
+	char *options; ///< what the gadgets were found with
+	RzList /*<RopMap *>*/ *maps;
+	RzStrConstPool opstrs;
+	HtPP /*<char *, RopGadget *>*/ *gadgets; ///< by their instructions
+	HtUP /*<const char *, RzPVector<RopGadget *> *>*/ *by_insn; ///< gadgets using each interned instruction
+	ut32 ngadgets;
+};
+
+/**
+ * The grep of a /R query, with the matches of its fields on each instruction
+ */
+typedef struct {
+	const char *grep; ///< NULL without grep
+	bool regex;
+	RzList /*<char *>*/ *rx_list; ///< the regexes, when regex is set
+	RzPVector /*<char *>*/ fields; ///< grep split at each ';'
+	RzPVector /*<HtUP *>*/ field_matches; ///< by field, then by interned instruction
+	RzPVector /*<HtUP *>*/ rx_matches; ///< by regex, then by interned instruction
+	HtUP /*<RopGadget *, bool>*/ *gadget_matches; ///< whether each gadget matches the grep
+	HtUP /*<RopGadget *, bool>*/ *first_matches; ///< gadgets with an instruction matching the first field
+	ut32 ngadgets; ///< gadgets indexed before the query, all in first_matches when they may match
+} RopQuery;
+
+static bool is_end_gadget(const RzAnalysisOp *aop, const ut8 crop) {
+	if (aop->family == RZ_ANALYSIS_OP_FAMILY_SECURITY) {
+		return false;
+	}
+	switch (aop->type) {
+	case RZ_ANALYSIS_OP_TYPE_TRAP:
+	case RZ_ANALYSIS_OP_TYPE_RET:
+	case RZ_ANALYSIS_OP_TYPE_UCALL:
+	case RZ_ANALYSIS_OP_TYPE_RCALL:
+	case RZ_ANALYSIS_OP_TYPE_ICALL:
+	case RZ_ANALYSIS_OP_TYPE_IRCALL:
+	case RZ_ANALYSIS_OP_TYPE_UJMP:
+	case RZ_ANALYSIS_OP_TYPE_RJMP:
+	case RZ_ANALYSIS_OP_TYPE_IJMP:
+	case RZ_ANALYSIS_OP_TYPE_IRJMP:
+	case RZ_ANALYSIS_OP_TYPE_JMP:
+	case RZ_ANALYSIS_OP_TYPE_CALL:
+		return true;
+	}
+	if (crop) { // if conditional jumps, calls and returns should be used for the gadget-search too
+		switch (aop->type) {
+		case RZ_ANALYSIS_OP_TYPE_CJMP:
+		case RZ_ANALYSIS_OP_TYPE_UCJMP:
+		case RZ_ANALYSIS_OP_TYPE_CCALL:
+		case RZ_ANALYSIS_OP_TYPE_UCCALL:
+		case RZ_ANALYSIS_OP_TYPE_CRET:
+			return true;
+		}
+	}
+	return false;
+}
+
+static void rop_candidate_kv_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+static void rop_gadget_kv_free(HtPPKv *kv) {
+	RopGadget *gadget = kv->value;
+	free(kv->key);
+	rz_vector_fini(&gadget->insns);
+	free(gadget);
+}
+
+static void rop_gadgets_kv_free(HtUPKv *kv) {
+	rz_pvector_free(kv->value);
+}
+
+static void rop_map_free(RopMap *map) {
+	if (!map) {
+		return;
+	}
+	rz_vector_fini(&map->ends);
+	ht_up_free(map->cands);
+	free(map);
+}
+
+RZ_IPI void rz_core_rop_index_free(RzCoreRopIndex *index) {
+	if (!index) {
+		return;
+	}
+	free(index->options);
+	rz_list_free(index->maps);
+	ht_up_free(index->by_insn);
+	ht_pp_free(index->gadgets);
+	rz_str_constpool_fini(&index->opstrs);
+	free(index);
+}
+
+static char *rop_index_options(RzCore *core, int increment, ut8 crop) {
+	RzAnalysis *analysis = core->analysis;
+	return rz_str_newf("%s %s %d %d %s %u %u %d",
+		analysis->cur ? analysis->cur->name : "", rz_str_get(analysis->cpu), analysis->bits, analysis->big_endian,
+		rz_config_get(core->config, "asm.syntax"), (ut32)rz_config_get_i(core->config, "rop.len"), crop, increment);
+}
+
+/**
+ * Returns the index of the gadgets found with the current options, dropping
+ * the one found with other options.
+ */
+static RzCoreRopIndex *rop_index_get(RzCore *core, int increment, ut8 crop) {
+	char *options = rop_index_options(core, increment, crop);
+	if (!options) {
+		return NULL;
+	}
+	RzCoreRopIndex *index = core->rop_index;
+	if (index && !strcmp(index->options, options)) {
+		free(options);
+		return index;
+	}
+	rz_core_rop_index_free(index);
+	core->rop_index = index = RZ_NEW0(RzCoreRopIndex);
+	if (!index) {
+		free(options);
+		return NULL;
+	}
+	index->options = options;
+	index->maps = rz_list_newf((RzListFree)rop_map_free);
+	index->gadgets = ht_pp_new(NULL, rop_gadget_kv_free, NULL);
+	index->by_insn = ht_up_new(NULL, rop_gadgets_kv_free, NULL);
+	if (!index->maps || !index->gadgets || !index->by_insn || !rz_str_constpool_init(&index->opstrs)) {
+		rz_list_free(index->maps);
+		ht_pp_free(index->gadgets);
+		ht_up_free(index->by_insn);
+		free(index->options);
+		free(index);
+		core->rop_index = NULL;
+		return NULL;
+	}
+	return index;
+}
+
+typedef struct {
+	RzAnalysis *decoder;
+	const ut8 *buf;
+	ut64 from;
+	int size;
+	int first; ///< first offset scanned
+	int last; ///< offsets scanned are before it
+	int increment;
+	ut8 crop;
+	RzVector /*<struct endlist_pair>*/ ends;
+} RopEndShard;
+
+static void rop_end_shard_scan(RopEndShard *shard) {
+	for (int i = shard->first; i < shard->last; i += shard->increment) {
+		RzAnalysisOp end_gadget = RZ_EMPTY;
+		// Disassemble one.
+		if (rz_analysis_op(shard->decoder, &end_gadget, shard->from + i, shard->buf + i,
+			    shard->size - i, RZ_ANALYSIS_OP_MASK_BASIC) < 1) {
+			rz_analysis_op_fini(&end_gadget);
+			continue;
+		}
+		if (is_end_gadget(&end_gadget, shard->crop)) {
+			struct endlist_pair epair;
+			// If this arch has branch delay slots, add the next instr as well
+			epair.instr_offset = end_gadget.delay ? i + shard->increment : i;
+			epair.delay_size = end_gadget.delay;
+			rz_vector_push(&shard->ends, &epair);
+		}
+		rz_analysis_op_fini(&end_gadget);
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+	}
+}
+
+static RzThreadFunctionRet rop_end_shard_runner(RzThread *th) {
+	rop_end_shard_scan(rz_th_get_user(th));
+	return RZ_TH_STOP;
+}
+
+/**
+ * Finds the end gadgets of \p map, split between threads each with its own
+ * decoder when the analysis plugin supports it.
+ */
+static bool rop_map_find_ends(RzCore *core, RopMap *map, const ut8 *buf, int increment, ut8 crop) {
+	RzAnalysis *analysis = core->analysis;
+	const int npos = map->size > 32 ? (map->size - 32 + increment - 1) / increment : 0;
+	size_t nshards = 1;
+	if (analysis->cur && analysis->cur->op && analysis->cur->op_stateless) {
+		size_t max_threads = rz_config_get_i(core->config, "search.threads");
+		nshards = rz_th_physical_core_number();
+		if (max_threads) {
+			nshards = RZ_MIN(nshards, max_threads);
+		}
+		nshards = RZ_MAX(RZ_MIN(nshards, map->size / ROP_INDEX_SHARD_MIN), 1);
+	}
+	RopEndShard *shards = RZ_NEWS0(RopEndShard, nshards);
+	if (!shards) {
+		return false;
+	}
+	bool ok = true;
+	const int per_shard = (npos + nshards - 1) / nshards;
+	for (size_t t = 0; t < nshards; t++) {
+		RopEndShard *shard = &shards[t];
+		shard->decoder = nshards > 1 ? rz_analysis_new_decoder(analysis) : analysis;
+		shard->buf = buf;
+		shard->from = map->from;
+		shard->size = map->size;
+		shard->first = RZ_MIN(npos, t * per_shard) * increment;
+		shard->last = RZ_MIN(npos, (t + 1) * per_shard) * increment;
+		shard->increment = increment;
+		shard->crop = crop;
+		rz_vector_init(&shard->ends, sizeof(struct endlist_pair), NULL, NULL);
+		if (!shard->decoder) {
+			RZ_LOG_ERROR("cannot create the analysis decoder of thread %u\n", (ut32)t);
+			ok = false;
+		}
+	}
+	if (!ok) {
+		goto beach;
+	}
+	if (nshards == 1) {
+		rop_end_shard_scan(&shards[0]);
+	} else {
+		RzThreadPool *pool = rz_th_pool_new(nshards);
+		if (!pool) {
+			RZ_LOG_ERROR("cannot allocate the thread pool\n");
+			ok = false;
+			goto beach;
+		}
+		for (size_t t = 0; t < nshards; t++) {
+			RzThread *th = rz_th_new(rop_end_shard_runner, &shards[t], 0);
+			if (!th || !rz_th_pool_add_thread(pool, th)) {
+				// scan this shard from here instead
+				rz_th_free(th);
+				rop_end_shard_scan(&shards[t]);
+			}
+		}
+		rz_th_pool_wait(pool);
+		rz_th_pool_free(pool);
+	}
+	for (size_t t = 0; t < nshards; t++) {
+		struct endlist_pair *epair;
+		rz_vector_foreach (&shards[t].ends, epair) {
+			rz_vector_push(&map->ends, epair);
+		}
+	}
+
+beach:
+	for (size_t t = 0; t < nshards; t++) {
+		if (shards[t].decoder != analysis) {
+			rz_analysis_free(shards[t].decoder);
+		}
+		rz_vector_fini(&shards[t].ends);
+	}
+	free(shards);
+	return ok;
+}
+
+/**
+ * Returns the gadgets of the \p size bytes \p buf at \p from, found again
+ * only when they are not indexed or when the bytes changed.
+ */
+static RopMap *rop_index_map(RzCore *core, RzCoreRopIndex *index, ut64 from, const ut8 *buf, int size, int increment, ut8 crop) {
+	const ut32 checksum = rz_hash_xxhash(buf, size);
+	RzListIter *it;
+	RopMap *map;
+	rz_list_foreach (index->maps, it, map) {
+		if (map->from == from && map->size == size) {
+			if (map->checksum == checksum) {
+				return map;
+			}
+			rz_list_delete(index->maps, it);
+			break;
+		}
+	}
+	map = RZ_NEW0(RopMap);
+	if (!map) {
+		return NULL;
+	}
+	map->from = from;
+	map->size = size;
+	map->checksum = checksum;
+	rz_vector_init(&map->ends, sizeof(struct endlist_pair), NULL, NULL);
+	map->cands = ht_up_new(NULL, rop_candidate_kv_free, NULL);
+	if (!map->cands || !rop_map_find_ends(core, map, buf, increment, crop)) {
+		rop_map_free(map);
+		return NULL;
+	}
+	if (rz_cons_is_breaked()) {
+		// the end gadgets found are not all of them
+		rop_map_free(map);
+		return NULL;
+	}
+	rz_list_append(index->maps, map);
+	return map;
+}
+
+/**
+ * Returns the gadget made of \p insns, which are moved to the index when the
+ * gadget is not found there yet.
+ */
+static RopGadget *rop_index_gadget(RzCoreRopIndex *index, RzVector /*<RopInsn>*/ *insns) {
+	RzStrBuf key;
+	rz_strbuf_init(&key);
+	RopInsn *insn;
+	rz_vector_foreach (insns, insn) {
+		rz_strbuf_appendf(&key, "%d %s\n", insn->len, insn->opstr);
+	}
+	RopGadget *gadget = ht_pp_find(index->gadgets, rz_strbuf_get(&key), NULL);
+	if (gadget) {
+		rz_strbuf_fini(&key);
+		rz_vector_fini(insns);
+		return gadget;
+	}
+	gadget = RZ_NEW0(RopGadget);
+	if (!gadget || !ht_pp_insert(index->gadgets, rz_strbuf_get(&key), gadget)) {
+		free(gadget);
+		rz_strbuf_fini(&key);
+		rz_vector_fini(insns);
+		return NULL;
+	}
+	rz_strbuf_fini(&key);
+	gadget->id = index->ngadgets++;
+	gadget->insns = *insns;
+	rz_vector_foreach (&gadget->insns, insn) {
+		RzPVector *gadgets = ht_up_find(index->by_insn, (ut64)(size_t)insn->opstr, NULL);
+		if (!gadgets) {
+			gadgets = rz_pvector_new(NULL);
+			if (!gadgets || !ht_up_insert(index->by_insn, (ut64)(size_t)insn->opstr, gadgets)) {
+				rz_pvector_free(gadgets);
+				continue;
+			}
+		}
+		// an instruction repeated in the gadget is indexed once
+		if (rz_pvector_empty(gadgets) || rz_pvector_tail(gadgets) != gadget) {
+			rz_pvector_push(gadgets, gadget);
+		}
+	}
+	return gadget;
+}
+
+/**
+ * Decodes the gadget at \p idx of \p map ending at \p end_gadget, whatever
+ * the grep of the query.
+ */
+static RopCandidate *rop_candidate_decode(RzCore *core, RzCoreRopIndex *index, RopMap *map, const ut8 *buf, int idx, const struct endlist_pair *end_gadget) {
+	RopCandidate *cand = RZ_NEW0(RopCandidate);
+	if (!cand) {
+		return NULL;
+	}
+	RzVector insns;
+	rz_vector_init(&insns, sizeof(RopInsn), NULL, NULL);
+	const int buflen = map->size;
+	RzAsmOp asmop;
+	cand->asm_ok = rz_asm_disassemble(core->rasm, &asmop, buf + idx, buflen - idx) != 0;
+	rz_asm_op_fini(&asmop);
+	if (!cand->asm_ok) {
+		rz_vector_fini(&insns);
+		return cand;
+	}
+	ut64 addr = map->from + idx;
+	rz_asm_set_pc(core->rasm, addr);
+
+	const int endaddr = end_gadget->instr_offset;
+	const ut8 max_instr = rz_config_get_i(core->config, "rop.len");
+	RzAnalysisOp aop = { 0 };
+	for (ut8 nb_instr = 0; nb_instr < max_instr; nb_instr++) {
+		int error = rz_analysis_op(core->analysis, &aop, addr, buf + idx, buflen - idx, RZ_ANALYSIS_OP_MASK_DISASM);
+		if (error < 0 || (nb_instr == 0 && (is_end_gadget(&aop, 0) || aop.type == RZ_ANALYSIS_OP_TYPE_NOP))) {
+			break;
+		}
+
+		const int opsz = aop.size;
+		char *opst = aop.mnemonic ? strdup(aop.mnemonic) : NULL;
+		if (!aop.mnemonic) {
+			RZ_LOG_WARN("Analysis plugin %s did not return disassembly\n", core->analysis->cur->name);
+			rz_asm_set_pc(core->rasm, addr);
+			if (rz_asm_disassemble(core->rasm, &asmop, buf + idx, buflen - idx) < 0) {
+				break;
+			}
+			opst = strdup(rz_asm_op_get_asm(&asmop));
+			rz_asm_op_fini(&asmop);
+		}
+		if (!opst || !rz_str_ncasecmp(opst, "invalid", strlen("invalid")) ||
+			!rz_str_ncasecmp(opst, ".byte", strlen(".byte"))) {
+			free(opst);
+			break;
+		}
+		RopInsn insn = { opsz, rz_str_constpool_get(&index->opstrs, opst) };
+		free(opst);
+		rz_vector_push(&insns, &insn);
+
+		// Move on to the next instruction
+		idx += opsz;
+		addr += opsz;
+		if (endaddr <= (idx - opsz)) {
+			cand->valid = (endaddr == idx - opsz);
+			break;
+		}
+		rz_analysis_op_fini(&aop);
+	}
+	rz_analysis_op_fini(&aop);
+	// If our arch has bds then we better be including them
+	cand->short_delay = cand->valid && end_gadget->delay_size && rz_vector_len(&insns) < 1 + end_gadget->delay_size;
+	if (rz_vector_empty(&insns)) {
+		rz_vector_fini(&insns);
+		return cand;
+	}
+	cand->gadget = rop_index_gadget(index, &insns);
+	if (!cand->gadget) {
+		free(cand);
+		return NULL;
+	}
+	return cand;
+}
+
+static RopCandidate *rop_index_candidate(RzCore *core, RzCoreRopIndex *index, RopMap *map, const ut8 *buf, int idx, const struct endlist_pair *end_gadget) {
+	const ut64 key = ((ut64)(ut32)idx << 32) | (ut32)end_gadget->instr_offset;
+	RopCandidate *cand = ht_up_find(map->cands, key, NULL);
+	if (!cand) {
+		cand = rop_candidate_decode(core, index, map, buf, idx, end_gadget);
+		if (cand && !ht_up_insert(map->cands, key, cand)) {
+			free(cand);
+			cand = NULL;
+		}
+	}
+	return cand;
+}
+
+/**
+ * Whether the interned instruction \p opstr matches the field or regex
+ * \p n of \p q, each one being tested once per instruction.
+ */
+static bool rop_query_match(RopQuery *q, bool regex, size_t n, const char *opstr) {
+	RzPVector *matches = regex ? &q->rx_matches : &q->field_matches;
+	while (rz_pvector_len(matches) <= n) {
+		rz_pvector_push(matches, ht_up_new0());
+	}
+	HtUP *ht = rz_pvector_at(matches, n);
+	if (!ht) {
+		return false;
+	}
+	const ut64 key = (ut64)(size_t)opstr;
+	bool found = false;
+	size_t match = (size_t)ht_up_find(ht, key, &found);
+	if (!found) {
+		if (regex) {
+			match = rz_regex_match(rz_list_get_n(q->rx_list, n), "e", opstr) ? 1 : 0;
+		} else {
+			match = strstr(opstr, rz_pvector_at(&q->fields, n)) ? 1 : 0;
+		}
+		ht_up_insert(ht, key, (void *)match);
+	}
+	return match;
+}
+
+static bool rop_query_has_rx(RopQuery *q) {
+	return q->grep && q->regex && rz_list_length(q->rx_list) > 0;
+}
+
+static bool rop_query_first_cb(void *user, const ut64 key, const void *value) {
+	RopQuery *q = user;
+	RzPVector *gadgets = (RzPVector *)value;
+	if (!rop_query_match(q, rop_query_has_rx(q), 0, (const char *)(size_t)key)) {
+		return true;
+	}
+	void **it;
+	rz_pvector_foreach (gadgets, it) {
+		ht_up_insert(q->first_matches, (ut64)(size_t)*it, (void *)1);
+	}
+	return true;
+}
+
+static void rop_query_init(RopQuery *q, RzCoreRopIndex *index, const char *grep, bool regex, RzList *rx_list) {
+	memset(q, 0, sizeof(*q));
+	q->grep = grep;
+	q->regex = regex;
+	q->rx_list = rx_list;
+	rz_pvector_init(&q->fields, free);
+	rz_pvector_init(&q->field_matches, (RzPVectorFree)ht_up_free);
+	rz_pvector_init(&q->rx_matches, (RzPVectorFree)ht_up_free);
+	if (!grep) {
+		return;
+	}
+	const char *start = grep;
+	for (;;) {
+		const char *end = strchr(start, ';');
+		if (!end) {
+			end = start + strlen(start);
+		}
+		rz_pvector_push(&q->fields, rz_str_ndup(start, end - start));
+		if (*end != ';') {
+			break;
+		}
+		start = end + 1;
+	}
+	q->gadget_matches = ht_up_new0();
+	// a gadget matches only with an instruction matching the first field,
+	// so the indexed gadgets without any are ruled out by the inverted index
+	q->first_matches = ht_up_new0();
+	if (q->first_matches) {
+		ht_up_foreach(index->by_insn, rop_query_first_cb, q);
+		q->ngadgets = index->ngadgets;
+	}
+}
+
+static void rop_query_fini(RopQuery *q) {
+	rz_pvector_fini(&q->fields);
+	rz_pvector_fini(&q->field_matches);
+	rz_pvector_fini(&q->rx_matches);
+	ht_up_free(q->gadget_matches);
+	ht_up_free(q->first_matches);
+}
+
+/**
+ * Whether \p gadget matches the grep of \p q: each field of the grep has to
+ * match one of the instructions, in order.
+ */
+static bool rop_gadget_match(RopQuery *q, RopGadget *gadget) {
+	const ut64 key = (ut64)(size_t)gadget;
+	bool found = false;
+	if (q->first_matches && gadget->id < q->ngadgets) {
+		ht_up_find(q->first_matches, key, &found);
+		if (!found) {
+			return false;
+		}
+	}
+	size_t match = q->gadget_matches ? (size_t)ht_up_find(q->gadget_matches, key, &found) : 0;
+	if (found) {
+		return match;
+	}
+	size_t field = 0;
+	bool has_end = true;
+	size_t count = 0;
+	bool has_rx = false;
+	if (rop_query_has_rx(q)) {
+		// get the first regexp.
+		has_rx = true;
+		count++;
+	}
+	RopInsn *insn;
+	rz_vector_foreach (&gadget->insns, insn) {
+		bool search_hit;
+		if (has_rx) {
+			search_hit = has_end && rop_query_match(q, true, count - 1, insn->opstr);
+		} else {
+			search_hit = has_end && rop_query_match(q, false, field, insn->opstr);
+		}
+		if (search_hit) {
+			if (field + 1 < rz_pvector_len(&q->fields)) { // fields are semicolon-separated
+				field++;
+			} else {
+				has_end = false;
+			}
+			if (q->regex) {
+				has_rx = count < (size_t)rz_list_length(q->rx_list);
+				count++;
+			}
+		}
+	}
+	match = !((q->regex && has_rx) || has_end);
+	if (q->gadget_matches) {
+		ht_up_insert(q->gadget_matches, key, (void *)match);
+	}
+	return match;
+}
+
+/**
+ * Returns the hits of \p cand at \p idx when it matches the grep of \p q and
+ * does not start at one of \p badstart.
+ */
+static RzList *rop_candidate_hits(RopQuery *q, const RopCandidate *cand, ut64 from, int idx, HtUU *badstart) {
+	bool found;
+	ht_uu_find(badstart, idx, &found);
+	if (found || !cand->valid) {
+		return NULL;
+	}
+	if (q->grep && !rop_gadget_match(q, cand->gadget)) {
+		return NULL;
+	}
+	RopInsn *insn;
+	ut64 addr = from + idx;
+	rz_vector_foreach (&cand->gadget->insns, insn) {
+		ht_uu_insert(badstart, addr - from, 1);
+		addr += insn->len;
+	}
+	if (cand->short_delay) {
+		return NULL;
+	}
+	RzList *hitlist = rz_core_asm_hit_list_new();
+	if (!hitlist) {
+		return NULL;
+	}
+	addr = from + idx;
+	rz_vector_foreach (&cand->gadget->insns, insn) {
+		RzCoreAsmHit *hit = rz_core_asm_hit_new();
+		if (hit) {
+			hit->addr = addr;
+			hit->len = insn->len;
+			rz_list_append(hitlist, hit);
+		}
+		addr += insn->len;
+	}
+	return hitlist;
+}
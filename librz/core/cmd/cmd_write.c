@@ -585,6 +585,27 @@ RZ_IPI RzCmdStatus rz_write_cache_commit_all_handler(RzCore *core, int argc, con
 	return RZ_CMD_STATUS_OK;
 }
 
+RZ_IPI RzCmdStatus rz_write_cache_mem_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	RzIOCacheStats stats;
+	rz_io_cache_stats(core->io, &stats);
+	switch (state->mode) {
+	case RZ_OUTPUT_MODE_STANDARD:
+		rz_cons_printf("pages=%" PFMT64u " bytes=%" PFMT64u " mem=%" PFMT64u "\n", stats.pages, stats.bytes, stats.mem);
+		break;
+	case RZ_OUTPUT_MODE_JSON:
+		pj_o(state->d.pj);
+		pj_kn(state->d.pj, "pages", stats.pages);
+		pj_kn(state->d.pj, "bytes", stats.bytes);
+		pj_kn(state->d.pj, "mem", stats.mem);
+		pj_end(state->d.pj);
+		break;
+	default:
+		rz_warn_if_reached();
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 RZ_IPI RzCmdStatus rz_write_pcache_list_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
 	RzIODesc *desc = NULL;
 	if (argc > 1) {
@@ -507,6 +507,12 @@ static bool search(RzCore *core, bool rad, bool only_func) {
 		int count = 0;
 
 		RzSignSearch *ss = NULL;
+		RzSignStore *store = rz_sign_store_new(core->analysis);
+		if (!store) {
+			rz_cons_break_pop();
+			return false;
+		}
+		rz_sign_store_prepare(store, core->analysis->fcns, rz_config_get_i(core->config, "zign.threads"));
 
 		if (useBytes && only_func) {
 			ss = rz_sign_search_new();
@@ -526,13 +532,14 @@ static bool search(RzCore *core, bool rad, bool only_func) {
 				retval &= searchRange2(core, ss, fcni->addr, fcni->addr + len, rad, &bytes_search_ctx);
 			}
 			sm.fcn = fcni;
-			hits += rz_sign_fcn_match_metrics(&sm);
+			hits += rz_sign_store_match_metrics(store, &sm);
 			sm.fcn = NULL;
 			count++;
 			// TODO: add useXRefs, useName
 		}
 		rz_cons_break_pop();
 		rz_sign_search_free(ss);
+		rz_sign_store_free(store);
 	}
 
 	if (rad) {
@@ -287,6 +287,7 @@ static const RzCmdDescArg cmd_debug_display_bt_oneline_args[2];
 static const RzCmdDescArg cmd_debug_bp_set_expr_cur_offset_args[2];
 static const RzCmdDescArg cmd_debug_add_watchpoint_args[2];
 static const RzCmdDescArg cmd_debug_set_cond_bp_win_args[3];
+static const RzCmdDescArg cmd_debug_save_coverage_bp_drcov_args[2];
 static const RzCmdDescArg cmd_debug_continue_execution_args[2];
 static const RzCmdDescArg cmd_debug_continue_send_signal_args[3];
 static const RzCmdDescArg cmd_debug_continue_traptrace_args[2];
@@ -6342,6 +6343,54 @@ static const RzCmdDescHelp cmd_debug_set_cond_bp_win_help = {
 	.args = cmd_debug_set_cond_bp_win_args,
 };
 
+static const RzCmdDescHelp dbk_help = {
+	.summary = "One-shot coverage breakpoints commands",
+};
+static const RzCmdDescArg cmd_debug_add_coverage_bp_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_add_coverage_bp_help = {
+	.summary = "Add coverage breakpoints at the basic blocks of the function at current offset",
+	.args = cmd_debug_add_coverage_bp_args,
+};
+
+static const RzCmdDescArg cmd_debug_add_coverage_bp_all_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_add_coverage_bp_all_help = {
+	.summary = "Add coverage breakpoints at the basic blocks of all the functions",
+	.args = cmd_debug_add_coverage_bp_all_args,
+};
+
+static const RzCmdDescArg cmd_debug_list_coverage_bp_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_list_coverage_bp_help = {
+	.summary = "List the basic blocks hit by coverage breakpoints",
+	.args = cmd_debug_list_coverage_bp_args,
+};
+
+static const RzCmdDescArg cmd_debug_remove_coverage_bp_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_remove_coverage_bp_help = {
+	.summary = "Remove all the coverage breakpoints and their hits",
+	.args = cmd_debug_remove_coverage_bp_args,
+};
+
+static const RzCmdDescArg cmd_debug_save_coverage_bp_drcov_args[] = {
+	{
+		.name = "file",
+		.type = RZ_CMD_ARG_TYPE_FILE,
+
+	},
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_save_coverage_bp_drcov_help = {
+	.summary = "Save the basic blocks hit by coverage breakpoints to a drcov file",
+	.args = cmd_debug_save_coverage_bp_drcov_args,
+};
+
 static const RzCmdDescHelp dc_help = {
 	.summary = "Continue execution",
 };
@@ -6909,6 +6958,33 @@ static const RzCmdDescHelp cmd_debug_trace_tag_help = {
 	.args = cmd_debug_trace_tag_args,
 };
 
+static const RzCmdDescHelp dtv_help = {
+	.summary = "Compact trace commands (dbg.trace.compact)",
+};
+static const RzCmdDescArg cmd_debug_trace_compact_coverage_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_trace_compact_coverage_help = {
+	.summary = "List the addresses executed in the compact trace and their hits",
+	.args = cmd_debug_trace_compact_coverage_args,
+};
+
+static const RzCmdDescArg cmd_debug_trace_compact_baseline_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_trace_compact_baseline_help = {
+	.summary = "Keep the compact trace as the baseline of dtvd and start a new one",
+	.args = cmd_debug_trace_compact_baseline_args,
+};
+
+static const RzCmdDescArg cmd_debug_trace_compact_diff_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_trace_compact_diff_help = {
+	.summary = "Show the first step differing between the baseline and the compact trace",
+	.args = cmd_debug_trace_compact_diff_args,
+};
+
 static const RzCmdDescHelp dl_help = {
 	.summary = "Debug handler",
 };
@@ -12565,6 +12641,14 @@ static const RzCmdDescHelp write_cache_commit_all_help = {
 	.args = write_cache_commit_all_args,
 };
 
+static const RzCmdDescArg write_cache_mem_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp write_cache_mem_help = {
+	.summary = "Show number of patched bytes and memory used by the cache",
+	.args = write_cache_mem_args,
+};
+
 static const RzCmdDescArg write_pcache_list_args[] = {
 	{
 		.name = "fd",
@@ -15501,6 +15585,21 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *cmd_debug_set_cond_bp_win_cd = rz_cmd_desc_argv_new(core->rcmd, db_cd, "dbW", rz_cmd_debug_set_cond_bp_win_handler, &cmd_debug_set_cond_bp_win_help);
 	rz_warn_if_fail(cmd_debug_set_cond_bp_win_cd);
 
+	RzCmdDesc *dbk_cd = rz_cmd_desc_group_new(core->rcmd, db_cd, "dbk", rz_cmd_debug_add_coverage_bp_handler, &cmd_debug_add_coverage_bp_help, &dbk_help);
+	rz_warn_if_fail(dbk_cd);
+	RzCmdDesc *cmd_debug_add_coverage_bp_all_cd = rz_cmd_desc_argv_new(core->rcmd, dbk_cd, "dbka", rz_cmd_debug_add_coverage_bp_all_handler, &cmd_debug_add_coverage_bp_all_help);
+	rz_warn_if_fail(cmd_debug_add_coverage_bp_all_cd);
+
+	RzCmdDesc *cmd_debug_list_coverage_bp_cd = rz_cmd_desc_argv_state_new(core->rcmd, dbk_cd, "dbkl", RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_cmd_debug_list_coverage_bp_handler, &cmd_debug_list_coverage_bp_help);
+	rz_warn_if_fail(cmd_debug_list_coverage_bp_cd);
+	rz_cmd_desc_set_default_mode(cmd_debug_list_coverage_bp_cd, RZ_OUTPUT_MODE_STANDARD);
+
+	RzCmdDesc *cmd_debug_remove_coverage_bp_cd = rz_cmd_desc_argv_new(core->rcmd, dbk_cd, "dbk-", rz_cmd_debug_remove_coverage_bp_handler, &cmd_debug_remove_coverage_bp_help);
+	rz_warn_if_fail(cmd_debug_remove_coverage_bp_cd);
+
+	RzCmdDesc *cmd_debug_save_coverage_bp_drcov_cd = rz_cmd_desc_argv_new(core->rcmd, dbk_cd, "dbkd", rz_cmd_debug_save_coverage_bp_drcov_handler, &cmd_debug_save_coverage_bp_drcov_help);
+	rz_warn_if_fail(cmd_debug_save_coverage_bp_drcov_cd);
+
 	RzCmdDesc *dc_cd = rz_cmd_desc_group_new(core->rcmd, cmd_debug_cd, "dc", rz_cmd_debug_continue_execution_handler, &cmd_debug_continue_execution_help, &dc_help);
 	rz_warn_if_fail(dc_cd);
 	RzCmdDesc *cmd_debug_continue_back_cd = rz_cmd_desc_argv_new(core->rcmd, dc_cd, "dcb", rz_cmd_debug_continue_back_handler, &cmd_debug_continue_back_help);
@@ -15646,6 +15745,14 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *cmd_debug_trace_tag_cd = rz_cmd_desc_argv_new(core->rcmd, dt_cd, "dtt", rz_cmd_debug_trace_tag_handler, &cmd_debug_trace_tag_help);
 	rz_warn_if_fail(cmd_debug_trace_tag_cd);
 
+	RzCmdDesc *dtv_cd = rz_cmd_desc_group_state_new(core->rcmd, dt_cd, "dtv", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_cmd_debug_trace_compact_coverage_handler, &cmd_debug_trace_compact_coverage_help, &dtv_help);
+	rz_warn_if_fail(dtv_cd);
+	RzCmdDesc *cmd_debug_trace_compact_baseline_cd = rz_cmd_desc_argv_new(core->rcmd, dtv_cd, "dtvb", rz_cmd_debug_trace_compact_baseline_handler, &cmd_debug_trace_compact_baseline_help);
+	rz_warn_if_fail(cmd_debug_trace_compact_baseline_cd);
+
+	RzCmdDesc *cmd_debug_trace_compact_diff_cd = rz_cmd_desc_argv_new(core->rcmd, dtv_cd, "dtvd", rz_cmd_debug_trace_compact_diff_handler, &cmd_debug_trace_compact_diff_help);
+	rz_warn_if_fail(cmd_debug_trace_compact_diff_cd);
+
 	RzCmdDesc *dl_cd = rz_cmd_desc_group_new(core->rcmd, cmd_debug_cd, "dl", rz_cmd_debug_handler_set_handler, &cmd_debug_handler_set_help, &dl_help);
 	rz_warn_if_fail(dl_cd);
 	RzCmdDesc *cmd_debug_handler_list_cd = rz_cmd_desc_argv_state_new(core->rcmd, dl_cd, "dll", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_cmd_debug_handler_list_handler, &cmd_debug_handler_list_help);
@@ -16912,6 +17019,9 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *write_cache_commit_all_cd = rz_cmd_desc_argv_new(core->rcmd, wc_cd, "wci", rz_write_cache_commit_all_handler, &write_cache_commit_all_help);
 	rz_warn_if_fail(write_cache_commit_all_cd);
 
+	RzCmdDesc *write_cache_mem_cd = rz_cmd_desc_argv_state_new(core->rcmd, wc_cd, "wcm", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON, rz_write_cache_mem_handler, &write_cache_mem_help);
+	rz_warn_if_fail(write_cache_mem_cd);
+
 	RzCmdDesc *write_pcache_list_cd = rz_cmd_desc_argv_state_new(core->rcmd, wc_cd, "wcp", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_RIZIN, rz_write_pcache_list_handler, &write_pcache_list_help);
 	rz_warn_if_fail(write_pcache_list_cd);
 
@@ -180,7 +180,11 @@ RZ_API RzBinReloc *rz_core_getreloc(RzCore *core, ut64 addr, int size) {
 		return NULL;
 	}
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	if (!bf || !bf->o) {
+		return NULL;
+	}
+	rz_bin_object_load_item(bf->o, RZ_BIN_OBJECT_ITEM_RELOCS);
+	if (!bf->o->relocs) {
 		return NULL;
 	}
 	return rz_bin_reloc_storage_get_reloc_in(bf->o->relocs, addr, size);
@@ -189,7 +193,11 @@ RZ_API RzBinReloc *rz_core_getreloc(RzCore *core, ut64 addr, int size) {
 RZ_API RzBinReloc *rz_core_get_reloc_to(RzCore *core, ut64 addr) {
 	rz_return_val_if_fail(core, NULL);
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	if (!bf || !bf->o) {
+		return NULL;
+	}
+	rz_bin_object_load_item(bf->o, RZ_BIN_OBJECT_ITEM_RELOCS);
+	if (!bf->o->relocs) {
 		return NULL;
 	}
 	return rz_bin_reloc_storage_get_reloc_to(bf->o->relocs, addr);
@@ -2373,6 +2381,9 @@ static int bp_bits_at(ut64 addr, void *user) {
 static void ev_iowrite_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzCore *core = user;
 	RzEventIOWrite *iow = data;
+	if (iow->len > 0) {
+		rz_analysis_op_cache_invalidate(core->analysis, iow->addr, iow->len);
+	}
 	if (rz_config_get_i(core->config, "analysis.detectwrites")) {
 		rz_analysis_update_analysis_range(core->analysis, iow->addr, iow->len);
 		if (core->cons->event_resize && core->cons->event_data) {
@@ -2540,6 +2551,8 @@ RZ_API bool rz_core_init(RzCore *core) {
 	core->flags = rz_flag_new();
 	core->graph = rz_agraph_new(rz_cons_canvas_new(1, 1));
 	core->graph->need_reload_nodes = false;
+	core->graph_layouts = rz_agraph_layout_cache_new();
+	core->graph->layout_cache = core->graph_layouts;
 	core->asmqjmps_size = RZ_CORE_ASMQJMPS_NUM;
 	if (sizeof(ut64) * core->asmqjmps_size < core->asmqjmps_size) {
 		core->asmqjmps_size = 0;
@@ -2659,6 +2672,7 @@ RZ_API void rz_core_fini(RzCore *c) {
 	rz_core_wait(c);
 	//  avoid double free
 	RZ_FREE_CUSTOM(c->ropchain, rz_list_free);
+	RZ_FREE_CUSTOM(c->rop_index, rz_core_rop_index_free);
 	RZ_FREE_CUSTOM(c->ev, rz_event_free);
 	RZ_FREE(c->cmdlog);
 	RZ_FREE(c->lastsearch);
@@ -2679,6 +2693,7 @@ RZ_API void rz_core_fini(RzCore *c) {
 	RZ_FREE_CUSTOM(c->scriptstack, rz_list_free);
 	rz_core_task_scheduler_fini(&c->tasks);
 	RZ_FREE_CUSTOM(c->rcmd, rz_cmd_free);
+	RZ_FREE_CUSTOM(c->cmd_parser, rz_core_cmd_parser_free);
 	RZ_FREE_CUSTOM(c->cmd_descriptors, rz_list_free);
 	RZ_FREE_CUSTOM(c->analysis, rz_analysis_free);
 	RZ_FREE_CUSTOM(c->rasm, rz_asm_free);
@@ -2698,6 +2713,7 @@ RZ_API void rz_core_fini(RzCore *c) {
 	RZ_FREE_CUSTOM(c->lib, rz_lib_free);
 	RZ_FREE_CUSTOM(c->yank_buf, rz_buf_free);
 	RZ_FREE_CUSTOM(c->graph, rz_agraph_free);
+	RZ_FREE_CUSTOM(c->graph_layouts, rz_agraph_layout_cache_free);
 	RZ_FREE(c->asmqjmps);
 	RZ_FREE_CUSTOM(c->sdb, sdb_free);
 	RZ_FREE_CUSTOM(c->parser, rz_parse_free);
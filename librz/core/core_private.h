@@ -38,6 +38,8 @@ RZ_IPI char *rz_core_analysis_var_display(RzCore *core, RzAnalysisVar *var, bool
 RZ_IPI char *rz_core_analysis_all_vars_display(RzCore *core, RzAnalysisFunction *fcn, bool add_name);
 RZ_IPI bool rz_analysis_var_global_list_show(RzAnalysis *analysis, RzCmdStateOutput *state, RZ_NULLABLE const char *name);
 RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core);
+RZ_IPI bool rz_core_analysis_types_propagation_parallel(RzCore *core, const ut8 *arena, size_t max_threads);
+RZ_IPI bool rz_core_analysis_can_decode_in_parallel(RzCore *core, ut64 from, ut64 to);
 RZ_IPI bool rz_core_analysis_function_set_signature(RzCore *core, RzAnalysisFunction *fcn, const char *newsig);
 RZ_IPI void rz_core_analysis_function_signature_editor(RzCore *core, ut64 addr);
 RZ_IPI void rz_core_analysis_bbs_asciiart(RzCore *core, RzAnalysisFunction *fcn);
@@ -194,6 +196,12 @@ RZ_IPI void rz_heap_list_w32(RzCore *core, RzOutputMode mode);
 
 RZ_IPI bool rz_core_cmd_lastcmd_repeat(RzCore *core, bool next);
 
+/* cmd.c */
+RZ_IPI void rz_core_cmd_parser_free(RzCoreCmdParser *p);
+
+/* cmd_search_rop.c */
+RZ_IPI void rz_core_rop_index_free(RzCoreRopIndex *index);
+
 static inline RzCmdStatus bool2status(bool val) {
 	return val ? RZ_CMD_STATUS_OK : RZ_CMD_STATUS_ERROR;
 }
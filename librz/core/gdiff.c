@@ -116,7 +116,13 @@ RZ_API bool rz_core_gdiff_2_files(RzCore *c, RzCore *c2) {
 		}
 	}
 	/* Diff functions */
-	rz_analysis_diff_fcn(cores[0]->analysis, cores[0]->analysis->fcns, cores[1]->analysis->fcns);
+	RzAnalysisDiffStats stats;
+	if (!rz_analysis_diff_functions(cores[0]->analysis, cores[0]->analysis->fcns, cores[1]->analysis->fcns, &stats)) {
+		return false;
+	}
+	RZ_LOG_INFO("diff: paired %" PFMTSZu " functions by name, %" PFMTSZu " identical and %" PFMTSZu " similar "
+		    "with %" PFMT64u " comparisons in %" PFMT64u " us\n",
+		stats.by_name, stats.exact, stats.similar, stats.compared, stats.usecs);
 
 	return true;
 }
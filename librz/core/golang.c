@@ -135,7 +135,7 @@ static bool is_pclntab_valid(GoPcLnTab *pclntab) {
 
 static void add_new_func_symbol(RzCore *core, const char *name, ut64 vaddr) {
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->symbols) {
+	if (!bf || !bf->o || !rz_bin_object_get_symbols(bf->o)) {
 		return;
 	}
 	ut64 paddr = rz_io_v2p(core->io, vaddr);
@@ -487,7 +487,7 @@ static bool add_new_bin_string(RzCore *core, char *string, ut64 vaddr, ut32 size
 	RzListIter *it;
 	RzBinString *bstr;
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->strings) {
+	if (!bf || !bf->o || !rz_bin_object_get_strings(bf->o)) {
 		free(string);
 		return false;
 	}
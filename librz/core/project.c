@@ -33,13 +33,31 @@ RZ_API RZ_NONNULL const char *rz_project_err_message(RzProjectErr err) {
 }
 
 RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *file) {
+	return rz_project_save_opt(core, prj, file, true);
+}
+
+/**
+ * \brief Saves the project of \p core into \p prj, like rz_project_save()
+ *
+ * \param xrefs if false, the xrefs namespace of the analysis is left empty
+ */
+RZ_API RzProjectErr rz_project_save_opt(RzCore *core, RzProject *prj, const char *file, bool xrefs) {
 	sdb_set(prj, RZ_PROJECT_KEY_TYPE, RZ_PROJECT_TYPE, 0);
 	sdb_set(prj, RZ_PROJECT_KEY_VERSION, sdb_fmt("%u", RZ_PROJECT_VERSION), 0);
-	rz_serialize_core_save(sdb_ns(prj, "core", true), core, file);
+	rz_serialize_core_save_opt(sdb_ns(prj, "core", true), core, file, xrefs);
 	return RZ_PROJECT_ERR_SUCCESS;
 }
 
+/**
+ * \brief Saves the project of \p core into \p file
+ *
+ * With prj.binary set, the project is saved in the binary format and
+ * \p compress is ignored, see rz_project_bin_save_file().
+ */
 RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file, bool compress) {
+	if (rz_config_get_b(core->config, "prj.binary")) {
+		return rz_project_bin_save_file(core, file);
+	}
 	char *tmp_file = NULL;
 
 	if (compress) {
@@ -86,6 +104,15 @@ tmp_file_err:
 
 /// Load a file into an RzProject but don't actually migrate anything or load it into an RzCore
 RZ_API RzProject *rz_project_load_file_raw(const char *file) {
+	if (rz_project_is_bin_file(file)) {
+		RzProjectBin *bin = rz_project_bin_open(file);
+		if (!bin) {
+			return NULL;
+		}
+		RzProject *prj = rz_project_bin_sdb(bin);
+		rz_project_bin_close(bin);
+		return prj;
+	}
 	RzProject *prj = sdb_new0();
 	if (!prj) {
 		return NULL;
@@ -166,6 +193,9 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
 }
 
 RZ_API RzProjectErr rz_project_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res) {
+	if (rz_project_is_bin_file(file)) {
+		return rz_project_bin_load_file(core, file, load_bin_io, res);
+	}
 	RzProject *prj = rz_project_load_file_raw(file);
 	if (!prj) {
 		RZ_SERIALIZE_ERR(res, "failed to read database file");
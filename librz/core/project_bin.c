@@ -0,0 +1,696 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file project_bin.c
+ * Binary project files, holding the same namespaces as the sdb ones.
+ *
+ * The file starts with a header pointing to a table of sections. Each
+ * namespace of the project is a key/value section with its keys sorted, so
+ * single values can be looked up in the mapped file without loading the
+ * rest through rz_project_bin_get(). Only the xrefs of the analysis are
+ * stored as sorted columns of addresses; functions, blocks, flags, meta and
+ * the other namespaces keep their JSON values.
+ *
+ * Loading a project into a core is not lazy: every key/value section is
+ * copied into an sdb for rz_project_load() and the migrations, only the
+ * xrefs being added from their columns without going through JSON.
+ *
+ * Saving over an existing binary project keeps the sections whose contents
+ * did not change where they are, only appending the others and a new table.
+ *
+ * Layout, all integers being little endian:
+ *
+ *   header:  magic[8] version:32 count:32 table_offset:64 table_size:64
+ *   table:   count * { kind:32 hash:32 offset:64 size:64 name_len:32 name[name_len] }
+ *   kv:      count:32 count * { key_offset:32 value_offset:32 } strings...
+ *   xrefs:   count:64 from[count]:64 to[count]:64 type[count]:8
+ */
+
+#include <rz_project.h>
+
+#define PRJ_BIN_VERSION     1
+#define PRJ_BIN_HEADER_SIZE 32
+#define PRJ_BIN_ENTRY_SIZE  28
+#define PRJ_BIN_ALIGN       8
+
+/**
+ * Namespace whose contents are stored as a xrefs section when saving the
+ * project of an analysis
+ */
+#define PRJ_BIN_XREFS_NS "core/analysis/xrefs"
+
+typedef enum {
+	PRJ_SECTION_KV,
+	PRJ_SECTION_XREFS
+} PrjSectionKind;
+
+typedef struct {
+	ut32 kind; ///< PrjSectionKind
+	ut32 hash; ///< rz_hash_xxhash() of the contents
+	ut64 offset;
+	ut64 size;
+	char *name; ///< path of the namespace, "" for the root one
+} PrjSection;
+
+struct rz_project_bin_t {
+	RzMmap *map;
+	PrjSection *sections;
+	ut32 count;
+};
+
+static ut64 align_up(ut64 x) {
+	return (x + PRJ_BIN_ALIGN - 1) & ~(ut64)(PRJ_BIN_ALIGN - 1);
+}
+
+static bool section_check(const PrjSection *s, const ut8 *data) {
+	switch (s->kind) {
+	case PRJ_SECTION_KV: {
+		if (s->size < 4) {
+			return false;
+		}
+		ut32 count = rz_read_le32(data);
+		// strings may start anywhere, the last one ending the section
+		return count <= (s->size - 4) / 8 && (!count || !data[s->size - 1]);
+	}
+	case PRJ_SECTION_XREFS: {
+		if (s->size < 8) {
+			return false;
+		}
+		ut64 count = rz_read_le64(data);
+		return count <= (s->size - 8) / 17 && s->size == 8 + count * 17;
+	}
+	default:
+		return false;
+	}
+}
+
+static bool bin_parse(RzProjectBin *bin) {
+	const ut8 *buf = bin->map->buf;
+	const ut64 len = bin->map->len;
+	if (!buf || len < PRJ_BIN_HEADER_SIZE || memcmp(buf, RZ_PROJECT_BIN_MAGIC, 8) ||
+		rz_read_le32(buf + 8) != PRJ_BIN_VERSION) {
+		return false;
+	}
+	ut32 count = rz_read_le32(buf + 12);
+	ut64 table = rz_read_le64(buf + 16);
+	ut64 table_size = rz_read_le64(buf + 24);
+	if (!count || table > len || table_size > len - table || count > table_size / PRJ_BIN_ENTRY_SIZE) {
+		return false;
+	}
+	bin->sections = RZ_NEWS0(PrjSection, count);
+	if (!bin->sections) {
+		return false;
+	}
+	const ut8 *p = buf + table;
+	const ut8 *end = p + table_size;
+	for (ut32 i = 0; i < count; i++) {
+		if (end - p < PRJ_BIN_ENTRY_SIZE) {
+			return false;
+		}
+		PrjSection *s = &bin->sections[i];
+		s->kind = rz_read_le32(p);
+		s->hash = rz_read_le32(p + 4);
+		s->offset = rz_read_le64(p + 8);
+		s->size = rz_read_le64(p + 16);
+		ut32 name_len = rz_read_le32(p + 24);
+		p += PRJ_BIN_ENTRY_SIZE;
+		if (name_len > end - p || s->offset > len || s->size > len - s->offset) {
+			return false;
+		}
+		s->name = rz_str_ndup((const char *)p, name_len);
+		if (!s->name) {
+			return false;
+		}
+		bin->count++;
+		p += name_len;
+		if (!section_check(s, buf + s->offset)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Tells whether \p file is a binary project, as written by rz_project_bin_save()
+ */
+RZ_API bool rz_project_is_bin_file(RZ_NONNULL const char *file) {
+	rz_return_val_if_fail(file, false);
+	FILE *f = rz_sys_fopen(file, "rb");
+	if (!f) {
+		return false;
+	}
+	char magic[8];
+	bool ret = fread(magic, 1, sizeof(magic), f) == sizeof(magic) && !memcmp(magic, RZ_PROJECT_BIN_MAGIC, sizeof(magic));
+	fclose(f);
+	return ret;
+}
+
+/**
+ * \brief Maps the binary project \p file, checking its layout without reading the namespaces
+ */
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_open(RZ_NONNULL const char *file) {
+	rz_return_val_if_fail(file, NULL);
+	RzProjectBin *bin = RZ_NEW0(RzProjectBin);
+	if (!bin) {
+		return NULL;
+	}
+	bin->map = rz_file_mmap(file, O_RDONLY, 0, 0);
+	if (!bin->map || !bin_parse(bin)) {
+		rz_project_bin_close(bin);
+		return NULL;
+	}
+	return bin;
+}
+
+RZ_API void rz_project_bin_close(RZ_NULLABLE RzProjectBin *bin) {
+	if (!bin) {
+		return;
+	}
+	for (ut32 i = 0; i < bin->count; i++) {
+		free(bin->sections[i].name);
+	}
+	free(bin->sections);
+	rz_file_mmap_free(bin->map);
+	free(bin);
+}
+
+static const PrjSection *bin_section(RzProjectBin *bin, const char *name) {
+	for (ut32 i = 0; i < bin->count; i++) {
+		if (!strcmp(bin->sections[i].name, name)) {
+			return &bin->sections[i];
+		}
+	}
+	return NULL;
+}
+
+static const ut8 *section_data(RzProjectBin *bin, const PrjSection *s) {
+	return bin->map->buf + s->offset;
+}
+
+static const char *kv_str(const PrjSection *s, const ut8 *data, ut32 offset) {
+	return offset < s->size ? (const char *)data + offset : NULL;
+}
+
+/**
+ * \brief Looks up \p key in the namespace \p ns of \p bin, reading only the
+ * entries visited by a binary search
+ *
+ * \param ns path of the namespace, separated by '/', "" for the root one
+ * \return the value, pointing into the mapped file, or NULL if missing
+ */
+RZ_API RZ_BORROW const char *rz_project_bin_get(RZ_NONNULL RzProjectBin *bin, RZ_NONNULL const char *ns, RZ_NONNULL const char *key) {
+	rz_return_val_if_fail(bin && ns && key, NULL);
+	const PrjSection *s = bin_section(bin, ns);
+	if (!s || s->kind != PRJ_SECTION_KV) {
+		return NULL;
+	}
+	const ut8 *data = section_data(bin, s);
+	ut32 lo = 0;
+	ut32 hi = rz_read_le32(data);
+	while (lo < hi) {
+		ut32 mid = lo + (hi - lo) / 2;
+		const ut8 *entry = data + 4 + (ut64)mid * 8;
+		const char *k = kv_str(s, data, rz_read_le32(entry));
+		if (!k) {
+			return NULL;
+		}
+		int cmp = strcmp(k, key);
+		if (!cmp) {
+			return kv_str(s, data, rz_read_le32(entry + 4));
+		}
+		if (cmp < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return NULL;
+}
+
+static bool kv_section_load(RzProjectBin *bin, const PrjSection *s, Sdb *db) {
+	const ut8 *data = section_data(bin, s);
+	ut32 count = rz_read_le32(data);
+	for (ut32 i = 0; i < count; i++) {
+		const ut8 *entry = data + 4 + (ut64)i * 8;
+		const char *k = kv_str(s, data, rz_read_le32(entry));
+		const char *v = kv_str(s, data, rz_read_le32(entry + 4));
+		if (!k || !v) {
+			return false;
+		}
+		sdb_set(db, k, v, 0);
+	}
+	return true;
+}
+
+static bool xref_type_valid(ut8 type) {
+	switch (type) {
+	case RZ_ANALYSIS_XREF_TYPE_NULL:
+	case RZ_ANALYSIS_XREF_TYPE_CODE:
+	case RZ_ANALYSIS_XREF_TYPE_CALL:
+	case RZ_ANALYSIS_XREF_TYPE_DATA:
+	case RZ_ANALYSIS_XREF_TYPE_STRING:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool xrefs_flush_json(Sdb *db, ut64 from, PJ *j) {
+	char key[0x20];
+	pj_end(j);
+	if (snprintf(key, sizeof(key), "0x%" PFMT64x, from) < 0) {
+		return false;
+	}
+	sdb_set(db, key, pj_string(j), 0);
+	pj_reset(j);
+	return true;
+}
+
+/**
+ * Writes the xrefs as the JSON arrays of rz_serialize_analysis_xrefs_save()
+ */
+static bool xrefs_section_load_json(RzProjectBin *bin, const PrjSection *s, Sdb *db) {
+	const ut8 *data = section_data(bin, s);
+	const ut64 count = rz_read_le64(data);
+	const ut8 *from = data + 8;
+	const ut8 *to = from + count * 8;
+	const ut8 *type = to + count * 8;
+	PJ *j = pj_new();
+	if (!j) {
+		return false;
+	}
+	bool ret = true;
+	for (ut64 i = 0; i < count && ret; i++) {
+		ut64 addr = rz_read_le64(from + i * 8);
+		if (!i) {
+			pj_a(j);
+		} else if (addr != rz_read_le64(from + (i - 1) * 8)) {
+			ret = xrefs_flush_json(db, rz_read_le64(from + (i - 1) * 8), j);
+			pj_a(j);
+		}
+		if (!xref_type_valid(type[i])) {
+			ret = false;
+			break;
+		}
+		pj_o(j);
+		pj_kn(j, "to", rz_read_le64(to + i * 8));
+		if (type[i] != RZ_ANALYSIS_XREF_TYPE_NULL) {
+			char t[2] = { type[i], '\0' };
+			pj_ks(j, "type", t);
+		}
+		pj_end(j);
+	}
+	if (ret && count) {
+		ret = xrefs_flush_json(db, rz_read_le64(from + (count - 1) * 8), j);
+	}
+	pj_free(j);
+	return ret;
+}
+
+static RzProject *bin_sdb(RzProjectBin *bin, bool xrefs) {
+	RzProject *prj = sdb_new0();
+	if (!prj) {
+		return NULL;
+	}
+	for (ut32 i = 0; i < bin->count; i++) {
+		const PrjSection *s = &bin->sections[i];
+		Sdb *db = *s->name ? sdb_ns_path(prj, s->name, true) : prj;
+		if (!db) {
+			goto error;
+		}
+		switch (s->kind) {
+		case PRJ_SECTION_KV:
+			if (!kv_section_load(bin, s, db)) {
+				goto error;
+			}
+			break;
+		case PRJ_SECTION_XREFS:
+			if (xrefs && !xrefs_section_load_json(bin, s, db)) {
+				goto error;
+			}
+			break;
+		}
+	}
+	return prj;
+error:
+	sdb_free(prj);
+	return NULL;
+}
+
+/**
+ * \brief Loads all the namespaces of \p bin into a project, as read from an sdb file
+ *
+ * This is the way to export a binary project back to the sdb format.
+ */
+RZ_API RZ_OWN RzProject *rz_project_bin_sdb(RZ_NONNULL RzProjectBin *bin) {
+	rz_return_val_if_fail(bin, NULL);
+	return bin_sdb(bin, true);
+}
+
+/**
+ * \brief Adds the xrefs of \p bin to \p analysis, straight from their columns
+ */
+RZ_API bool rz_project_bin_load_xrefs(RZ_NONNULL RzProjectBin *bin, RZ_NONNULL RzAnalysis *analysis) {
+	rz_return_val_if_fail(bin && analysis, false);
+	const PrjSection *s = bin_section(bin, PRJ_BIN_XREFS_NS);
+	if (!s || s->kind != PRJ_SECTION_XREFS) {
+		return true;
+	}
+	const ut8 *data = section_data(bin, s);
+	const ut64 count = rz_read_le64(data);
+	const ut8 *from = data + 8;
+	const ut8 *to = from + count * 8;
+	const ut8 *type = to + count * 8;
+	for (ut64 i = 0; i < count; i++) {
+		if (!xref_type_valid(type[i])) {
+			return false;
+		}
+		rz_analysis_xrefs_set(analysis, rz_read_le64(from + i * 8), rz_read_le64(to + i * 8), type[i]);
+	}
+	return true;
+}
+
+/**
+ * \brief Loads the binary project \p file into \p core
+ *
+ * The namespaces are all copied into an sdb first, since rz_project_load()
+ * and the migrations work on one, so loading is not lazy. Only the xrefs
+ * are added from their columns after the other namespaces went through
+ * rz_project_load(), without building their JSON.
+ */
+RZ_API RzProjectErr rz_project_bin_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res) {
+	rz_return_val_if_fail(core && file, RZ_PROJECT_ERR_UNKNOWN);
+	RzProjectBin *bin = rz_project_bin_open(file);
+	if (!bin) {
+		RZ_SERIALIZE_ERR(res, "failed to read binary project file");
+		return RZ_PROJECT_ERR_FILE;
+	}
+	RzProject *prj = bin_sdb(bin, false);
+	if (!prj) {
+		rz_project_bin_close(bin);
+		RZ_SERIALIZE_ERR(res, "invalid binary project file");
+		return RZ_PROJECT_ERR_INVALID_CONTENTS;
+	}
+	RzProjectErr ret = rz_project_load(core, prj, load_bin_io, file, res);
+	if (ret == RZ_PROJECT_ERR_SUCCESS && !rz_project_bin_load_xrefs(bin, core->analysis)) {
+		RZ_SERIALIZE_ERR(res, "xrefs parsing failed");
+		ret = RZ_PROJECT_ERR_INVALID_CONTENTS;
+	}
+	sdb_free(prj);
+	rz_project_bin_close(bin);
+	return ret;
+}
+
+/* saving */
+
+typedef struct {
+	PrjSection s;
+	ut8 *data;
+	bool kept; ///< already in the file at s.offset
+} PrjSectionData;
+
+static void section_data_fini(void *e, void *user) {
+	PrjSectionData *sd = e;
+	free(sd->s.name);
+	free(sd->data);
+}
+
+static bool kv_section_build(Sdb *db, PrjSectionData *sd) {
+	SdbList *l = sdb_foreach_list(db, true);
+	if (!l) {
+		return false;
+	}
+	const ut64 count = ls_length(l);
+	ut64 size = 4 + count * 8;
+	SdbListIter *it;
+	SdbKv *kv;
+	ls_foreach (l, it, kv) {
+		size += strlen(sdbkv_key(kv)) + strlen(sdbkv_value(kv)) + 2;
+	}
+	if (size > UT32_MAX || !(sd->data = malloc(size))) {
+		ls_free(l);
+		return false;
+	}
+	ut8 *entry = sd->data + 4;
+	ut32 offset = 4 + count * 8;
+	rz_write_le32(sd->data, count);
+	ls_foreach (l, it, kv) {
+		const char *strs[] = { sdbkv_key(kv), sdbkv_value(kv) };
+		for (size_t i = 0; i < RZ_ARRAY_SIZE(strs); i++) {
+			size_t len = strlen(strs[i]) + 1;
+			memcpy(sd->data + offset, strs[i], len);
+			rz_write_le32(entry + i * 4, offset);
+			offset += len;
+		}
+		entry += 8;
+	}
+	ls_free(l);
+	sd->s.kind = PRJ_SECTION_KV;
+	sd->s.size = size;
+	return true;
+}
+
+static bool collect_xrefs_to_cb(void *user, const ut64 k, const void *v) {
+	const RzAnalysisXRef *xref = v;
+	RzVector *xrefs = user;
+	return rz_vector_push(xrefs, (void *)xref);
+}
+
+static bool collect_xrefs_cb(void *user, const ut64 k, const void *v) {
+	ht_up_foreach((HtUP *)v, collect_xrefs_to_cb, user);
+	return true;
+}
+
+static int xref_cmp(const void *a, const void *b) {
+	const RzAnalysisXRef *xa = a;
+	const RzAnalysisXRef *xb = b;
+	if (xa->from != xb->from) {
+		return xa->from < xb->from ? -1 : 1;
+	}
+	return xa->to < xb->to ? -1 : xa->to > xb->to;
+}
+
+static bool xrefs_section_build(RzAnalysis *analysis, PrjSectionData *sd) {
+	RzVector xrefs;
+	rz_vector_init(&xrefs, sizeof(RzAnalysisXRef), NULL, NULL);
+	ht_up_foreach(analysis->ht_xrefs_from, collect_xrefs_cb, &xrefs);
+	rz_vector_sort(&xrefs, xref_cmp, false);
+	const ut64 count = rz_vector_len(&xrefs);
+	sd->s.kind = PRJ_SECTION_XREFS;
+	sd->s.size = 8 + count * 17;
+	sd->data = malloc(sd->s.size);
+	if (!sd->data) {
+		rz_vector_fini(&xrefs);
+		return false;
+	}
+	ut8 *from = sd->data + 8;
+	ut8 *to = from + count * 8;
+	ut8 *type = to + count * 8;
+	rz_write_le64(sd->data, count);
+	RzAnalysisXRef *xref;
+	ut64 i = 0;
+	rz_vector_foreach(&xrefs, xref) {
+		rz_write_le64(from + i * 8, xref->from);
+		rz_write_le64(to + i * 8, xref->to);
+		type[i] = xref->type;
+		i++;
+	}
+	rz_vector_fini(&xrefs);
+	return true;
+}
+
+static bool collect_sections(Sdb *db, const char *name, RzAnalysis *analysis, RzVector *sections) {
+	PrjSectionData *sd = rz_vector_push(sections, NULL);
+	if (!sd) {
+		return false;
+	}
+	memset(sd, 0, sizeof(*sd));
+	sd->s.name = strdup(name);
+	if (!sd->s.name) {
+		return false;
+	}
+	bool ok = analysis && !strcmp(name, PRJ_BIN_XREFS_NS)
+		? xrefs_section_build(analysis, sd)
+		: kv_section_build(db, sd);
+	if (!ok) {
+		return false;
+	}
+	SdbListIter *it;
+	SdbNs *ns;
+	ls_foreach (db->ns, it, ns) {
+		char *path = *name ? rz_str_newf("%s/%s", name, ns->name) : strdup(ns->name);
+		if (!path) {
+			return false;
+		}
+		ok = collect_sections(ns->sdb, path, analysis, sections);
+		free(path);
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Marks the sections whose contents are already in \p old, returning the
+ * offset in the file at which the other ones can be appended.
+ */
+static ut64 keep_sections(RzProjectBin *old, RzVector *sections) {
+	PrjSectionData *sd;
+	rz_vector_foreach(sections, sd) {
+		const PrjSection *os = bin_section(old, sd->s.name);
+		if (os && os->kind == sd->s.kind && os->size == sd->s.size && os->hash == sd->s.hash &&
+			!memcmp(section_data(old, os), sd->data, sd->s.size)) {
+			sd->s.offset = os->offset;
+			sd->kept = true;
+		}
+	}
+	return align_up(old->map->len);
+}
+
+static bool write_at(FILE *f, ut64 offset, const void *data, ut64 size) {
+	return !fseek(f, offset, SEEK_SET) && fwrite(data, 1, size, f) == size;
+}
+
+static ut8 *table_build(RzVector *sections, ut64 size) {
+	ut8 *table = malloc(size);
+	if (!table) {
+		return NULL;
+	}
+	ut8 *p = table;
+	PrjSectionData *sd;
+	rz_vector_foreach(sections, sd) {
+		ut32 name_len = strlen(sd->s.name);
+		rz_write_le32(p, sd->s.kind);
+		rz_write_le32(p + 4, sd->s.hash);
+		rz_write_le64(p + 8, sd->s.offset);
+		rz_write_le64(p + 16, sd->s.size);
+		rz_write_le32(p + 24, name_len);
+		memcpy(p + PRJ_BIN_ENTRY_SIZE, sd->s.name, name_len);
+		p += PRJ_BIN_ENTRY_SIZE + name_len;
+	}
+	return table;
+}
+
+/**
+ * \brief Saves the namespaces of \p prj into the binary project \p file
+ *
+ * When \p file already is a binary project, the sections that did not
+ * change are kept in place and only the others are appended, together with
+ * a new table. The file is rewritten from scratch once the space lost by
+ * the replaced sections gets larger than the live one.
+ *
+ * \param analysis if not NULL, the xrefs are taken from it and stored as
+ * columns, ignoring their namespace in \p prj
+ * \param written if not NULL, set to the bytes actually written
+ */
+RZ_API RzProjectErr rz_project_bin_save(RZ_NONNULL RzProject *prj, RZ_NULLABLE RzAnalysis *analysis, RZ_NONNULL const char *file, RZ_NULLABLE RZ_OUT ut64 *written) {
+	rz_return_val_if_fail(prj && file, RZ_PROJECT_ERR_UNKNOWN);
+	RzProjectErr err = RZ_PROJECT_ERR_UNKNOWN;
+	ut8 *table = NULL;
+	FILE *f = NULL;
+	RzVector sections;
+	rz_vector_init(&sections, sizeof(PrjSectionData), section_data_fini, NULL);
+	if (!collect_sections(prj, "", analysis, &sections) || rz_vector_len(&sections) > UT32_MAX) {
+		goto beach;
+	}
+
+	ut64 table_size = 0;
+	ut64 live = PRJ_BIN_HEADER_SIZE;
+	PrjSectionData *sd;
+	rz_vector_foreach(&sections, sd) {
+		sd->s.hash = rz_hash_xxhash(sd->data, sd->s.size);
+		table_size += PRJ_BIN_ENTRY_SIZE + strlen(sd->s.name);
+		live += align_up(sd->s.size);
+	}
+	live += table_size;
+
+	ut64 end = PRJ_BIN_HEADER_SIZE;
+	RzProjectBin *old = rz_project_is_bin_file(file) ? rz_project_bin_open(file) : NULL;
+	bool in_place = old;
+	if (old) {
+		end = keep_sections(old, &sections);
+		// unmapped before writing, the file may be truncated
+		rz_project_bin_close(old);
+		ut64 appended = table_size;
+		rz_vector_foreach(&sections, sd) {
+			appended += sd->kept ? 0 : align_up(sd->s.size);
+		}
+		if (end + appended > 2 * live) {
+			// rewrite everything rather than growing the file forever
+			rz_vector_foreach(&sections, sd) {
+				sd->kept = false;
+			}
+			in_place = false;
+			end = PRJ_BIN_HEADER_SIZE;
+		}
+	}
+
+	f = rz_sys_fopen(file, in_place ? "r+b" : "wb");
+	if (!f) {
+		err = RZ_PROJECT_ERR_FILE;
+		goto beach;
+	}
+	err = RZ_PROJECT_ERR_FILE;
+	ut64 total = PRJ_BIN_HEADER_SIZE + table_size;
+	rz_vector_foreach(&sections, sd) {
+		if (sd->kept) {
+			continue;
+		}
+		sd->s.offset = end;
+		if (!write_at(f, end, sd->data, sd->s.size)) {
+			goto beach;
+		}
+		end += align_up(sd->s.size);
+		total += sd->s.size;
+	}
+	table = table_build(&sections, table_size);
+	if (!table || !write_at(f, end, table, table_size)) {
+		goto beach;
+	}
+	// the header goes last, the previous table staying valid until then
+	ut8 header[PRJ_BIN_HEADER_SIZE];
+	memcpy(header, RZ_PROJECT_BIN_MAGIC, 8);
+	rz_write_le32(header + 8, PRJ_BIN_VERSION);
+	rz_write_le32(header + 12, rz_vector_len(&sections));
+	rz_write_le64(header + 16, end);
+	rz_write_le64(header + 24, table_size);
+	if (fflush(f) || !write_at(f, 0, header, sizeof(header))) {
+		goto beach;
+	}
+	if (written) {
+		*written = total;
+	}
+	err = RZ_PROJECT_ERR_SUCCESS;
+beach:
+	if (f && fclose(f) && err == RZ_PROJECT_ERR_SUCCESS) {
+		err = RZ_PROJECT_ERR_FILE;
+	}
+	free(table);
+	rz_vector_fini(&sections);
+	return err;
+}
+
+/**
+ * \brief Saves the project of \p core into the binary project \p file
+ *
+ * The xrefs are written as columns straight from the analysis, so
+ * rz_project_save_opt() is told to skip their JSON.
+ */
+RZ_API RzProjectErr rz_project_bin_save_file(RzCore *core, const char *file) {
+	rz_return_val_if_fail(core && file, RZ_PROJECT_ERR_UNKNOWN);
+	RzProject *prj = sdb_new0();
+	if (!prj) {
+		return RZ_PROJECT_ERR_UNKNOWN;
+	}
+	RzProjectErr err = rz_project_save_opt(core, prj, file, false);
+	if (err == RZ_PROJECT_ERR_SUCCESS) {
+		err = rz_project_bin_save(prj, core->analysis, file, NULL);
+	}
+	sdb_free(prj);
+	if (err == RZ_PROJECT_ERR_SUCCESS) {
+		rz_config_set(core->config, "prj.file", file);
+	}
+	return err;
+}
@@ -21,10 +21,19 @@ static bool file_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, RZ_NULLABLE c
 	RZ_NULLABLE RzSerializeResultInfo *res);
 
 RZ_API void rz_serialize_core_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, RZ_NULLABLE const char *prj_file) {
+	rz_serialize_core_save_opt(db, core, prj_file, true);
+}
+
+/**
+ * \brief Saves \p core into \p db, like rz_serialize_core_save()
+ *
+ * \param xrefs if false, the xrefs of the analysis are not serialized, see rz_serialize_analysis_save_opt()
+ */
+RZ_API void rz_serialize_core_save_opt(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, RZ_NULLABLE const char *prj_file, bool xrefs) {
 	file_save(sdb_ns(db, "file", true), core, prj_file);
 	rz_serialize_config_save(sdb_ns(db, "config", true), core->config);
 	rz_serialize_flag_save(sdb_ns(db, "flags", true), core->flags);
-	rz_serialize_analysis_save(sdb_ns(db, "analysis", true), core->analysis);
+	rz_serialize_analysis_save_opt(sdb_ns(db, "analysis", true), core->analysis, xrefs);
 	rz_serialize_debug_save(sdb_ns(db, "debug", true), core->dbg);
 
 	char buf[0x20];
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_debug.h>
+
+typedef struct {
+	ut64 base;
+	ut64 end;
+	const char *path;
+} DrcovModule;
+
+/**
+ * Gathers the maps of \p dbg backed by the same file into modules, ordered
+ * by address.
+ */
+static bool drcov_modules(RzDebug *dbg, RzVector /*<DrcovModule>*/ *modules) {
+	RzListIter *iter;
+	RzDebugMap *map;
+	rz_list_foreach (dbg->maps, iter, map) {
+		if (RZ_STR_ISEMPTY(map->file)) {
+			continue;
+		}
+		DrcovModule *mod = NULL;
+		DrcovModule *m;
+		rz_vector_foreach(modules, m) {
+			if (!strcmp(m->path, map->file)) {
+				mod = m;
+				break;
+			}
+		}
+		if (mod) {
+			mod->base = RZ_MIN(mod->base, map->addr);
+			mod->end = RZ_MAX(mod->end, map->addr_end);
+			continue;
+		}
+		mod = rz_vector_push(modules, NULL);
+		if (!mod) {
+			return false;
+		}
+		mod->base = map->addr;
+		mod->end = map->addr_end;
+		mod->path = map->file;
+	}
+	return true;
+}
+
+static st64 drcov_module_at(RzVector /*<DrcovModule>*/ *modules, ut64 addr) {
+	DrcovModule *m;
+	rz_vector_foreach(modules, m) {
+		if (addr >= m->base && addr < m->end) {
+			return m - (DrcovModule *)modules->a;
+		}
+	}
+	return -1;
+}
+
+/**
+ * \brief Write the blocks hit by the coverage breakpoints of \p dbg in the drcov format
+ *
+ * The modules are made of the maps of the process backed by a file, so they
+ * should be synchronized before. Blocks outside of them are left out.
+ *
+ * \param out buffer to append the drcov (version 2) data to
+ * \return false if writing failed
+ */
+RZ_API bool rz_debug_coverage_drcov(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzBuffer *out) {
+	rz_return_val_if_fail(dbg && dbg->bp && out, false);
+	const RzVector *hits = rz_bp_coverage_hits(dbg->bp);
+	if (!hits) {
+		return false;
+	}
+	RzVector modules;
+	rz_vector_init(&modules, sizeof(DrcovModule), NULL, NULL);
+	bool ret = false;
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	ut8 *entries = NULL;
+	if (!sb || !drcov_modules(dbg, &modules)) {
+		goto beach;
+	}
+	size_t count = 0;
+	entries = malloc(RZ_MAX(rz_vector_len(hits), 1) * 8);
+	if (!entries) {
+		goto beach;
+	}
+	RzBreakpointCoverageHit *hit;
+	rz_vector_foreach(hits, hit) {
+		st64 id = drcov_module_at(&modules, hit->addr);
+		if (id < 0) {
+			continue;
+		}
+		const DrcovModule *mod = rz_vector_index_ptr(&modules, id);
+		ut8 *entry = entries + count * 8;
+		rz_write_le32(entry, (ut32)(hit->addr - mod->base));
+		rz_write_le16(entry + 4, (ut16)RZ_MIN(hit->size, UT16_MAX));
+		rz_write_le16(entry + 6, (ut16)id);
+		count++;
+	}
+
+	rz_strbuf_appendf(sb, "DRCOV VERSION: 2\nDRCOV FLAVOR: drcov\n"
+			      "Module Table: version 2, count %" PFMTSZu "\n"
+			      "Columns: id, base, end, entry, checksum, timestamp, path\n",
+		rz_vector_len(&modules));
+	DrcovModule *mod;
+	size_t id = 0;
+	rz_vector_foreach(&modules, mod) {
+		rz_strbuf_appendf(sb, "%" PFMTSZu ", 0x%" PFMT64x ", 0x%" PFMT64x ", 0x0, 0x0, 0x0, %s\n",
+			id++, mod->base, mod->end, mod->path);
+	}
+	rz_strbuf_appendf(sb, "BB Table: %" PFMTSZu " bbs\n", count);
+	ret = rz_buf_append_bytes(out, (const ut8 *)rz_strbuf_get(sb), rz_strbuf_length(sb)) &&
+		(!count || rz_buf_append_bytes(out, entries, count * 8));
+beach:
+	free(entries);
+	rz_strbuf_free(sb);
+	rz_vector_fini(&modules);
+	return ret;
+}
@@ -42,7 +42,7 @@ RZ_API void rz_debug_bp_update(RzDebug *dbg) {
 	RzListIter *iter;
 	rz_list_foreach (dbg->bp->bps, iter, bp) {
 		if (bp->expr) {
-			bp->addr = dbg->corebind.numGet(dbg->corebind.core, bp->expr);
+			rz_bp_item_set_addr(dbg->bp, bp, dbg->corebind.numGet(dbg->corebind.core, bp->expr));
 		}
 	}
 }
@@ -196,6 +196,34 @@ static int rz_debug_bp_hit(RzDebug *dbg, RzRegItem *pc_ri, ut64 pc, RzBreakpoint
 	return true;
 }
 
+/*
+ * one-shot coverage breakpoints are handled apart from the others: they are
+ * removed on their first hit, the pc is set back to them and no recoil is
+ * needed.
+ */
+static bool rz_debug_coverage_hit(RzDebug *dbg, RzRegItem *pc_ri, ut64 pc) {
+	ut64 addr = pc;
+#if !__mips__
+	bool at_bp = dbg->pc_at_bp_set && dbg->pc_at_bp;
+	if (at_bp || !rz_bp_coverage_ending_at(dbg->bp, pc, &addr)) {
+		addr = pc;
+	}
+#endif
+	if (!rz_bp_coverage_hit(dbg->bp, addr)) {
+		return false;
+	}
+	if (addr != pc) {
+		if (!rz_reg_set_value(dbg->reg, pc_ri, addr) || !rz_debug_reg_sync(dbg, RZ_REG_TYPE_GPR, true)) {
+			eprintf("failed to set PC!\n");
+		}
+	}
+	if (dbg->trace->enabled) {
+		rz_debug_trace_pc(dbg, addr);
+	}
+	dbg->reason.bp_addr = 0;
+	return true;
+}
+
 /* enable all software breakpoints */
 static int rz_debug_bps_enable(RzDebug *dbg) {
 	/* restore all sw breakpoints. we are about to step/continue so these need
@@ -416,6 +444,7 @@ RZ_API RzDebug *rz_debug_free(RzDebug *dbg) {
 	if (dbg) {
 		rz_bp_free(dbg->bp);
 		free(dbg->snap_path);
+		free(dbg->trace_spill);
 		rz_list_free(dbg->maps);
 		rz_list_free(dbg->maps_user);
 		rz_list_free(dbg->threads);
@@ -661,6 +690,7 @@ RZ_API const char *rz_debug_reason_to_string(int type) {
 	case RZ_DEBUG_REASON_FPU: return "fpu";
 	case RZ_DEBUG_REASON_STEP: return "step";
 	case RZ_DEBUG_REASON_USERSUSP: return "suspended-by-user";
+	case RZ_DEBUG_REASON_COVERAGE: return "coverage";
 	}
 	return "unhandled";
 }
@@ -747,6 +777,11 @@ RZ_API RzDebugReasonType rz_debug_wait(RzDebug *dbg, RzBreakpointItem **bp) {
 			/* get the value */
 			pc = rz_reg_get_value(dbg->reg, pc_ri);
 
+			if (reason == RZ_DEBUG_REASON_BREAKPOINT && dbg->bp->coverage && rz_debug_coverage_hit(dbg, pc_ri, pc)) {
+				dbg->reason.type = RZ_DEBUG_REASON_COVERAGE;
+				return RZ_DEBUG_REASON_COVERAGE;
+			}
+
 			if (!rz_debug_bp_hit(dbg, pc_ri, pc, &b)) {
 				return RZ_DEBUG_REASON_ERROR;
 			}
@@ -1188,6 +1223,7 @@ repeat:
 		if (!rz_debug_recoil(dbg, RZ_DBG_RECOIL_CONTINUE)) {
 			return 0;
 		}
+		rz_bp_coverage_install(dbg->bp);
 		/* tell the inferior to go! */
 		ret = dbg->cur->cont(dbg, dbg->pid, dbg->tid, sig);
 		// XXX(jjd): why? //dbg->reason.signum = 0;
@@ -1208,6 +1244,9 @@ repeat:
 			}
 		}
 	}
+	if (reason == RZ_DEBUG_REASON_COVERAGE && !rz_cons_is_breaked()) {
+		goto repeat;
+	}
 	if (reason == RZ_DEBUG_REASON_BREAKPOINT &&
 		((bp && !bp->enabled) || (!bp && !rz_cons_is_breaked() && dbg->corebind.core && dbg->corebind.cfggeti(dbg->corebind.core, "dbg.bpsysign")))) {
 		goto repeat;
@@ -1316,6 +1355,7 @@ repeat:
 	if (reason != RZ_DEBUG_REASON_BREAKPOINT) {
 		rz_bp_restore(dbg->bp, false);
 	}
+	rz_bp_coverage_uninstall(dbg->bp);
 
 	// Add a checkpoint at stops
 	if (dbg->session && !dbg->trace_continue) {
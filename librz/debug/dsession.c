@@ -3,16 +3,31 @@
 
 #include <rz_debug.h>
 #include <rz_util/rz_json.h>
+#if __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #define CMP_CNUM_REG(x, y)   ((x) >= ((RzDebugChangeReg *)y)->cnum ? 1 : -1)
 #define CMP_CNUM_MEM(x, y)   ((x) >= ((RzDebugChangeMem *)y)->cnum ? 1 : -1)
 #define CMP_CNUM_CHKPT(x, y) ((x) >= ((RzDebugCheckpoint *)y)->cnum ? 1 : -1)
 
+/**
+ * Size of the pages of the checkpoints when the target does not tell it
+ */
+#define CHECKPOINT_PAGE_SIZE 0x1000
+
+#define PAGEMAP_SOFT_DIRTY (1ULL << 55)
+#define PAGEMAP_SWAPPED    (1ULL << 62)
+#define PAGEMAP_PRESENT    (1ULL << 63)
+
 RZ_API void rz_debug_session_free(RzDebugSession *session) {
 	if (session) {
 		rz_vector_free(session->checkpoints);
 		ht_up_free(session->registers);
-		ht_up_free(session->memory);
+		rz_vector_free(session->memory);
+		// the pages left the table when the checkpoints were freed
+		ht_up_free(session->pages);
 		RZ_FREE(session);
 	}
 }
@@ -30,6 +45,11 @@ static void htup_vector_free(HtUPKv *kv) {
 	rz_vector_free(kv->value);
 }
 
+static void mem_change_fini(void *element, void *user) {
+	RzDebugChangeMem *mem = element;
+	free(mem->data);
+}
+
 RZ_API RzDebugSession *rz_debug_session_new(void) {
 	RzDebugSession *session = RZ_NEW0(RzDebugSession);
 	if (!session) {
@@ -46,17 +66,201 @@ RZ_API RzDebugSession *rz_debug_session_new(void) {
 		rz_debug_session_free(session);
 		return NULL;
 	}
-	session->memory = ht_up_new(NULL, htup_vector_free, NULL);
+	session->memory = rz_vector_new(sizeof(RzDebugChangeMem), mem_change_fini, NULL);
 	if (!session->memory) {
 		rz_debug_session_free(session);
 		return NULL;
 	}
+	session->pages = ht_up_new0();
+	if (!session->pages) {
+		rz_debug_session_free(session);
+		return NULL;
+	}
 
 	return session;
 }
 
+/*
+ * Soft-dirty bits of native Linux targets
+ *
+ * After writing 4 to /proc/<pid>/clear_refs, the kernel sets the soft-dirty
+ * bit of /proc/<pid>/pagemap for each page written by the process (or by us).
+ * Clearing them right after taking a checkpoint, the pages still clean hold
+ * the bytes of that checkpoint and do not need to be read again.
+ */
+
+static bool softdirty_target(RzDebug *dbg) {
+#if __linux__
+	return dbg->pid > 0 && dbg->cur && !strcmp(dbg->cur->name, "native") && !dbg->session->dirty_unsupported;
+#else
+	return false;
+#endif
+}
+
+static ut32 checkpoint_page_size(RzDebug *dbg) {
+#if __linux__
+	if (softdirty_target(dbg)) {
+		long size = sysconf(_SC_PAGESIZE);
+		if (size > 0) {
+			return size;
+		}
+	}
+#endif
+	return CHECKPOINT_PAGE_SIZE;
+}
+
+/**
+ * Opens the pagemap of the target, -1 if its soft-dirty bits cannot be used
+ */
+static int softdirty_open(RzDebug *dbg) {
+#if __linux__
+	if (softdirty_target(dbg)) {
+		char path[64];
+		snprintf(path, sizeof(path), "/proc/%d/pagemap", dbg->pid);
+		return open(path, O_RDONLY);
+	}
+#endif
+	return -1;
+}
+
+static void softdirty_close(int pagemap) {
+#if __linux__
+	if (pagemap >= 0) {
+		close(pagemap);
+	}
+#endif
+}
+
+/**
+ * Reads the pagemap entries of the \p count pages at \p addr
+ */
+static ut64 *softdirty_entries(int pagemap, ut64 addr, size_t count, ut32 page_size) {
+#if __linux__
+	if (pagemap < 0 || addr % page_size) {
+		return NULL;
+	}
+	ut64 *entries = RZ_NEWS(ut64, count);
+	if (!entries) {
+		return NULL;
+	}
+	const size_t len = count * sizeof(ut64);
+	if (pread(pagemap, entries, len, (addr / page_size) * sizeof(ut64)) != (ssize_t)len) {
+		free(entries);
+		return NULL;
+	}
+	return entries;
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * Tells for each page of the \p size bytes at \p addr whether it may have
+ * been written since the soft-dirty bits were cleared. The pages neither present nor swapped are
+ * counted as written, as they may have been discarded.
+ */
+static ut8 *softdirty_pages(int pagemap, ut64 addr, ut32 size, ut32 page_size) {
+	const size_t count = ((ut64)size + page_size - 1) / page_size;
+	ut64 *entries = softdirty_entries(pagemap, addr, count, page_size);
+	ut8 *dirty = entries ? malloc(count) : NULL;
+	if (!dirty) {
+		free(entries);
+		return NULL;
+	}
+	size_t i;
+	for (i = 0; i < count; i++) {
+		const ut64 e = entries[i];
+		dirty[i] = (e & PAGEMAP_SOFT_DIRTY) || !(e & (PAGEMAP_PRESENT | PAGEMAP_SWAPPED));
+	}
+	free(entries);
+	return dirty;
+}
+
+/**
+ * Returns the checkpoint whose bytes are still held by the pages that are
+ * not soft-dirty, if any
+ */
+static RzDebugCheckpoint *softdirty_base(RzDebug *dbg) {
+	RzDebugSession *session = dbg->session;
+	if (session->dirty_pid != dbg->pid || session->dirty_chkpt >= session->checkpoints->len) {
+		return NULL;
+	}
+	return rz_vector_index_ptr(session->checkpoints, session->dirty_chkpt);
+}
+
+#if __linux__
+/**
+ * Tells whether the kernel tracks the soft-dirty bits, by looking for them
+ * in the pages of \p snaps, never cleared since the process started:
+ * 1 if it does, 0 if it does not, -1 if no page is present to tell.
+ */
+static int softdirty_probe(int pagemap, RzList /*<RzDebugSnap *>*/ *snaps) {
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	bool present = false;
+	rz_list_foreach (snaps, iter, snap) {
+		const size_t count = ((ut64)snap->size + snap->page_size - 1) / snap->page_size;
+		ut64 *entries = softdirty_entries(pagemap, snap->addr, count, snap->page_size);
+		if (!entries) {
+			continue;
+		}
+		size_t i;
+		for (i = 0; i < count; i++) {
+			if (entries[i] & PAGEMAP_SOFT_DIRTY) {
+				free(entries);
+				return 1;
+			}
+			present |= !!(entries[i] & PAGEMAP_PRESENT);
+		}
+		free(entries);
+	}
+	return present ? 0 : -1;
+}
+#endif
+
+/**
+ * Clears the soft-dirty bits of the target, right after taking the
+ * checkpoint at \p index
+ */
+static void softdirty_clear(RzDebug *dbg, int pagemap, size_t index) {
+#if __linux__
+	RzDebugSession *session = dbg->session;
+	RzDebugCheckpoint *chkpt = rz_vector_index_ptr(session->checkpoints, index);
+	if (session->dirty_pid != dbg->pid) {
+		int supported = softdirty_probe(pagemap, chkpt->snaps);
+		if (supported < 1) {
+			session->dirty_unsupported = !supported;
+			return;
+		}
+	}
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/clear_refs", dbg->pid);
+	int fd = open(path, O_WRONLY);
+	if (fd < 0) {
+		session->dirty_pid = 0;
+		return;
+	}
+	bool ok = write(fd, "4", 1) == 1;
+	close(fd);
+	session->dirty_pid = ok ? dbg->pid : 0;
+	session->dirty_chkpt = index;
+#endif
+}
+
+static RzDebugSnap *checkpoint_snap(RzDebugCheckpoint *chkpt, ut64 addr, ut32 size) {
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	rz_list_foreach (chkpt->snaps, iter, snap) {
+		if (snap->addr == addr && snap->size == size) {
+			return snap;
+		}
+	}
+	return NULL;
+}
+
 RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
 	rz_return_val_if_fail(dbg->session, false);
+	RzDebugSession *session = dbg->session;
 	size_t i;
 	RzDebugCheckpoint checkpoint = { 0 };
 
@@ -69,7 +273,7 @@ RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
 		checkpoint.arena[i] = b;
 	}
 
-	// Save current memory maps
+	// Save current memory maps, sharing the pages unchanged since the other checkpoints
 	checkpoint.snaps = rz_list_newf((RzListFree)rz_debug_snap_free);
 	if (!checkpoint.snaps) {
 		return false;
@@ -77,22 +281,32 @@ RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
 	RzListIter *iter;
 	RzDebugMap *map;
 	rz_debug_map_sync(dbg);
+	const ut32 page_size = checkpoint_page_size(dbg);
+	int pagemap = softdirty_open(dbg);
+	RzDebugCheckpoint *base = pagemap >= 0 ? softdirty_base(dbg) : NULL;
 	rz_list_foreach (dbg->maps, iter, map) {
 		if ((map->perm & RZ_PERM_RW) == RZ_PERM_RW) {
-			RzDebugSnap *snap = rz_debug_snap_map(dbg, map);
+			RzDebugSnap *prev = base ? checkpoint_snap(base, map->addr, map->size) : NULL;
+			ut8 *dirty = prev ? softdirty_pages(pagemap, map->addr, map->size, page_size) : NULL;
+			RzDebugSnap *snap = rz_debug_snap_map_pages(dbg, map, page_size, session->pages, prev, dirty);
+			free(dirty);
 			if (snap) {
 				rz_list_append(checkpoint.snaps, snap);
 			}
 		}
 	}
 
-	checkpoint.cnum = dbg->session->cnum;
-	rz_vector_push(dbg->session->checkpoints, &checkpoint);
+	checkpoint.cnum = session->cnum;
+	rz_vector_push(session->checkpoints, &checkpoint);
+	if (pagemap >= 0) {
+		softdirty_clear(dbg, pagemap, session->checkpoints->len - 1);
+		softdirty_close(pagemap);
+	}
 
 	// Add PC register change so we can check for breakpoints when continue [back]
 	RzRegItem *ripc = rz_reg_get(dbg->reg, dbg->reg->name[RZ_REG_NAME_PC], RZ_REG_TYPE_GPR);
 	ut64 data = rz_reg_get_value(dbg->reg, ripc);
-	rz_debug_session_add_reg_change(dbg->session, ripc->arena, ripc->offset, data);
+	rz_debug_session_add_reg_change(session, ripc->arena, ripc->offset, data);
 
 	return true;
 }
@@ -132,32 +346,82 @@ RZ_API void _restore_registers(RzDebug *dbg, ut32 cnum) {
 	}
 }
 
-static void _set_initial_memory(RzDebug *dbg) {
-	RzListIter *iter;
-	RzDebugSnap *snap;
-	rz_list_foreach (dbg->session->cur_chkpt->snaps, iter, snap) {
+/**
+ * Writes back the pages of \p snap differing from the memory of the target.
+ * When \p dirty is given, the pages that are not dirty are known to hold
+ * the bytes of \p base, and are written only if \p snap holds other pages.
+ */
+static void snap_restore(RzDebug *dbg, RzDebugSnap *snap, RzDebugSnap *base, const ut8 *dirty, ut8 *buf, ut32 buf_size) {
+	if (!snap->pages) {
 		dbg->iob.write_at(dbg->iob.io, snap->addr, snap->data, snap->size);
+		return;
+	}
+	if (!base || !base->pages || base->addr != snap->addr || base->size != snap->size || base->page_size != snap->page_size) {
+		dirty = NULL;
+	}
+	const ut32 page_size = snap->page_size;
+	const size_t count = ((ut64)snap->size + page_size - 1) / page_size;
+	const size_t chunk_pages = RZ_MAX(buf_size / page_size, 1);
+	size_t i = 0;
+	while (i < count) {
+		RzDebugSnapPage *page = snap->pages[i];
+		if (dirty && !dirty[i]) {
+			if (base->pages[i] != page) {
+				dbg->iob.write_at(dbg->iob.io, snap->addr + (ut64)i * page_size, page->data, page->size);
+			}
+			i++;
+			continue;
+		}
+		// compare the run of dirty pages from i with the target
+		size_t n = 1;
+		while (n < chunk_pages && i + n < count && (!dirty || dirty[i + n])) {
+			n++;
+		}
+		const ut64 off = (ut64)i * page_size;
+		const ut32 len = RZ_MIN((ut64)n * page_size, snap->size - off);
+		bool read = dbg->iob.read_at(dbg->iob.io, snap->addr + off, buf, len);
+		size_t j;
+		for (j = 0; j < n; j++) {
+			page = snap->pages[i + j];
+			if (!read || memcmp(buf + j * page_size, page->data, page->size)) {
+				dbg->iob.write_at(dbg->iob.io, snap->addr + off + j * page_size, page->data, page->size);
+			}
+		}
+		i += n;
 	}
 }
 
-static bool _restore_memory_cb(void *user, const ut64 key, const void *value) {
-	size_t index;
-	RzDebug *dbg = user;
-	RzVector *vmem = (RzVector *)value;
-
-	rz_vector_upper_bound(vmem, dbg->session->cnum, index, CMP_CNUM_MEM);
-	if (index > 0 && index <= vmem->len) {
-		RzDebugChangeMem *mem = rz_vector_index_ptr(vmem, index - 1);
-		if (mem->cnum > dbg->session->cur_chkpt->cnum) {
-			dbg->iob.write_at(dbg->iob.io, key, &mem->data, 1);
-		}
+static void _set_initial_memory(RzDebug *dbg) {
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	const ut32 buf_size = 0x100000;
+	ut8 *buf = malloc(buf_size);
+	if (!buf) {
+		return;
 	}
-	return true;
+	int pagemap = softdirty_open(dbg);
+	RzDebugCheckpoint *base = pagemap >= 0 ? softdirty_base(dbg) : NULL;
+	rz_list_foreach (dbg->session->cur_chkpt->snaps, iter, snap) {
+		RzDebugSnap *prev = base && snap->pages ? checkpoint_snap(base, snap->addr, snap->size) : NULL;
+		ut8 *dirty = prev ? softdirty_pages(pagemap, snap->addr, snap->size, snap->page_size) : NULL;
+		snap_restore(dbg, snap, prev, dirty, buf, buf_size);
+		free(dirty);
+	}
+	softdirty_close(pagemap);
+	free(buf);
 }
 
 static void _restore_memory(RzDebug *dbg, ut32 cnum) {
 	_set_initial_memory(dbg);
-	ht_up_foreach(dbg->session->memory, _restore_memory_cb, dbg);
+	// replay in order the writes done after the checkpoint, the last one of each byte wins
+	RzVector *vmem = dbg->session->memory;
+	size_t i, end;
+	rz_vector_upper_bound(vmem, dbg->session->cur_chkpt->cnum, i, CMP_CNUM_MEM);
+	rz_vector_upper_bound(vmem, dbg->session->cnum, end, CMP_CNUM_MEM);
+	for (; i < end; i++) {
+		RzDebugChangeMem *mem = rz_vector_index_ptr(vmem, i);
+		dbg->iob.write_at(dbg->iob.io, mem->addr, mem->data, mem->size);
+	}
 }
 
 static RzDebugCheckpoint *_get_checkpoint_before(RzDebugSession *session, ut32 cnum) {
@@ -230,21 +494,52 @@ RZ_API bool rz_debug_session_add_reg_change(RzDebugSession *session, int arena,
 	return true;
 }
 
-RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data) {
-	RzVector *vmem = ht_up_find(session->memory, addr, NULL);
-	if (!vmem) {
-		vmem = rz_vector_new(sizeof(RzDebugChangeMem), NULL, NULL);
-		if (!vmem) {
-			eprintf("Error: creating a memory vector.\n");
+/**
+ * Append the write of \p size bytes at \p addr to \p memory, extending the
+ * last change when it belongs to the same step and ends at \p addr.
+ */
+static bool mem_change_push(RzVector *memory, int cnum, ut64 addr, const ut8 *data, ut32 size) {
+	RzDebugChangeMem *last = rz_vector_empty(memory) ? NULL : rz_vector_tail(memory);
+	if (last && last->cnum == cnum && last->addr + last->size == addr && last->size <= UT32_MAX - size) {
+		ut8 *buf = realloc(last->data, last->size + size);
+		if (!buf) {
 			return false;
 		}
-		ht_up_insert(session->memory, addr, vmem);
+		memcpy(buf + last->size, data, size);
+		last->data = buf;
+		last->size += size;
+		return true;
+	}
+	RzDebugChangeMem mem = { cnum, addr, size, rz_mem_dup(data, size) };
+	if (!mem.data) {
+		return false;
+	}
+	if (!rz_vector_push(memory, &mem)) {
+		free(mem.data);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Record the write of \p size bytes at \p addr in the current step of the session
+ */
+RZ_API bool rz_debug_session_add_mem_range(RzDebugSession *session, ut64 addr, const ut8 *data, ut32 size) {
+	rz_return_val_if_fail(session && data, false);
+	if (!size) {
+		return true;
+	}
+	if (!mem_change_push(session->memory, session->cnum, addr, data, size)) {
+		eprintf("Error: recording a memory change.\n");
+		return false;
 	}
-	RzDebugChangeMem mem = { session->cnum, data };
-	rz_vector_push(vmem, &mem);
 	return true;
 }
 
+RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data) {
+	return rz_debug_session_add_mem_range(session, addr, &data, 1);
+}
+
 /* Save and Load Session */
 
 // 0x<addr>=[<RzDebugChangeReg>]
@@ -274,9 +569,17 @@ static void serialize_registers(Sdb *db, HtUP *registers) {
 	ht_up_foreach(registers, serialize_register_cb, db);
 }
 
+/**
+ * Change of a single byte, as the memory changes are saved
+ */
+typedef struct {
+	int cnum;
+	ut8 data;
+} MemByteChange;
+
 // 0x<addr>={"size":<size_t>, "a":[<RzDebugChangeMem>]}},
 static bool serialize_memory_cb(void *db, const ut64 k, const void *v) {
-	RzDebugChangeMem *mem;
+	MemByteChange *mem;
 	RzVector *vmem = (RzVector *)v;
 	PJ *j = pj_new();
 	if (!j) {
@@ -297,8 +600,31 @@ static bool serialize_memory_cb(void *db, const ut64 k, const void *v) {
 	return true;
 }
 
-static void serialize_memory(Sdb *db, HtUP *memory) {
-	ht_up_foreach(memory, serialize_memory_cb, db);
+static void serialize_memory(Sdb *db, RzVector *memory) {
+	// saved sessions keep the history of each byte, so split the ranges
+	HtUP *bytes = ht_up_new(NULL, htup_vector_free, NULL);
+	if (!bytes) {
+		return;
+	}
+	RzDebugChangeMem *mem;
+	rz_vector_foreach(memory, mem) {
+		ut32 i;
+		for (i = 0; i < mem->size; i++) {
+			RzVector *vmem = ht_up_find(bytes, mem->addr + i, NULL);
+			if (!vmem) {
+				vmem = rz_vector_new(sizeof(MemByteChange), NULL, NULL);
+				if (!vmem) {
+					goto beach;
+				}
+				ht_up_insert(bytes, mem->addr + i, vmem);
+			}
+			MemByteChange byte = { mem->cnum, mem->data[i] };
+			rz_vector_push(vmem, &byte);
+		}
+	}
+	ht_up_foreach(bytes, serialize_memory_cb, db);
+beach:
+	ht_up_free(bytes);
 }
 
 static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
@@ -345,7 +671,11 @@ static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
 			pj_kn(j, "addr", snap->addr);
 			pj_kn(j, "addr_end", snap->addr_end);
 			pj_kn(j, "size", snap->size);
-			char *edata = sdb_encode((const void *)snap->data, snap->size);
+			ut8 *data = snap->pages ? rz_debug_snap_data(snap) : snap->data;
+			char *edata = data ? sdb_encode((const void *)data, snap->size) : NULL;
+			if (data != snap->data) {
+				free(data);
+			}
 			if (!edata) {
 				pj_free(j);
 				return;
@@ -461,6 +791,28 @@ RZ_API bool rz_debug_session_save(RzDebugSession *session, const char *path) {
 	if (!v || v->type != t) \
 	continue
 
+/**
+ * Change of a single byte read from a saved session, with its position in
+ * the history of the byte
+ */
+typedef struct {
+	int cnum;
+	ut64 addr;
+	size_t idx;
+	ut8 data;
+} MemByteLoad;
+
+static int mem_byte_load_cmp(const void *a, const void *b) {
+	const MemByteLoad *x = a, *y = b;
+	if (x->cnum != y->cnum) {
+		return x->cnum < y->cnum ? -1 : 1;
+	}
+	if (x->addr != y->addr) {
+		return x->addr < y->addr ? -1 : 1;
+	}
+	return x->idx < y->idx ? -1 : x->idx > y->idx;
+}
+
 static bool deserialize_memory_cb(void *user, const char *addr, const char *v) {
 	RzJson *child;
 	char *json_str = strdup(v);
@@ -473,18 +825,11 @@ static bool deserialize_memory_cb(void *user, const char *addr, const char *v) {
 		return true;
 	}
 
-	HtUP *memory = user;
-	// Insert a new vector into `memory` HtUP at `addr`
-	RzVector *vmem = rz_vector_new(sizeof(RzDebugChangeMem), NULL, NULL);
-	if (!vmem) {
-		eprintf("Error: failed to allocate RzVector vmem.\n");
-		free(json_str);
-		rz_json_free(reg_json);
-		return false;
-	}
-	ht_up_insert(memory, sdb_atoi(addr), vmem);
+	RzVector *bytes = user;
+	ut64 at = sdb_atoi(addr);
+	size_t idx = 0;
 
-	// Extract <RzDebugChangeMem>'s into the new vector
+	// Extract <RzDebugChangeMem>'s of the byte at `addr`
 	for (child = reg_json->children.first; child; child = child->next) {
 		if (child->type != RZ_JSON_OBJECT) {
 			continue;
@@ -495,10 +840,10 @@ static bool deserialize_memory_cb(void *user, const char *addr, const char *v) {
 
 		baby = rz_json_get(child, "data");
 		CHECK_TYPE(baby, RZ_JSON_INTEGER);
-		ut64 data = baby->num.u_value;
+		ut8 data = baby->num.u_value;
 
-		RzDebugChangeMem mem = { cnum, data };
-		rz_vector_push(vmem, &mem);
+		MemByteLoad byte = { cnum, at, idx++, data };
+		rz_vector_push(bytes, &byte);
 	}
 
 	free(json_str);
@@ -506,8 +851,21 @@ static bool deserialize_memory_cb(void *user, const char *addr, const char *v) {
 	return true;
 }
 
-static void deserialize_memory(Sdb *db, HtUP *memory) {
-	sdb_foreach(db, deserialize_memory_cb, memory);
+static void deserialize_memory(Sdb *db, RzVector *memory) {
+	RzVector bytes;
+	rz_vector_init(&bytes, sizeof(MemByteLoad), NULL, NULL);
+	sdb_foreach(db, deserialize_memory_cb, &bytes);
+	// sort the bytes by step and address, so that the writes of a step are
+	// merged back into ranges and the history of each byte keeps its order
+	rz_vector_sort(&bytes, mem_byte_load_cmp, false);
+	MemByteLoad *byte;
+	rz_vector_foreach(&bytes, byte) {
+		if (!mem_change_push(memory, byte->cnum, byte->addr, &byte->data, 1)) {
+			eprintf("Error: failed to load a memory change.\n");
+			break;
+		}
+	}
+	rz_vector_fini(&bytes);
 }
 
 static bool deserialize_registers_cb(void *user, const char *addr, const char *v) {
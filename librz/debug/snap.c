@@ -4,26 +4,75 @@
 
 #include <rz_debug.h>
 
+/**
+ * Bytes read from the target at most at once when snapping pages
+ */
+#define SNAP_READ_MAX 0x100000
+
+static size_t snap_page_count(RzDebugSnap *snap) {
+	return snap->page_size ? ((ut64)snap->size + snap->page_size - 1) / snap->page_size : 0;
+}
+
 RZ_API void rz_debug_snap_free(RzDebugSnap *snap) {
 	if (snap) {
 		free(snap->name);
 		free(snap->data);
+		if (snap->pages) {
+			size_t i, count = snap_page_count(snap);
+			for (i = 0; i < count; i++) {
+				rz_debug_snap_page_unref(snap->pages[i]);
+			}
+			free(snap->pages);
+		}
 		RZ_FREE(snap);
 	}
 }
 
-RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
-	rz_return_val_if_fail(dbg && map, NULL);
-	if (map->size < 1) {
-		eprintf("Invalid map size\n");
+/**
+ * \brief Returns a page holding the \p size bytes of \p buf
+ *
+ * When \p store already interns a page with the same bytes, it is shared
+ * instead of allocating a new one.
+ */
+RZ_API RzDebugSnapPage *rz_debug_snap_page_new(RZ_NULLABLE HtUP *store, RZ_NONNULL const ut8 *buf, ut32 size) {
+	rz_return_val_if_fail(buf, NULL);
+	const ut32 hash = rz_hash_xxhash(buf, size);
+	RzDebugSnapPage *page = store ? ht_up_find(store, hash, NULL) : NULL;
+	if (page) {
+		if (page->size == size && !memcmp(page->data, buf, size)) {
+			page->refs++;
+			return page;
+		}
+		// another page has the same hash, keep this one private
+		store = NULL;
+	}
+	page = malloc(sizeof(RzDebugSnapPage) + size);
+	if (!page) {
 		return NULL;
 	}
+	page->refs = 1;
+	page->size = size;
+	page->hash = hash;
+	page->store = store && ht_up_insert(store, hash, page) ? store : NULL;
+	memcpy(page->data, buf, size);
+	return page;
+}
 
+RZ_API void rz_debug_snap_page_unref(RzDebugSnapPage *page) {
+	if (!page || --page->refs) {
+		return;
+	}
+	if (page->store) {
+		ht_up_delete(page->store, page->hash);
+	}
+	free(page);
+}
+
+static RzDebugSnap *snap_new(RzDebugMap *map) {
 	RzDebugSnap *snap = RZ_NEW0(RzDebugSnap);
 	if (!snap) {
 		return NULL;
 	}
-
 	snap->name = strdup(map->name);
 	snap->addr = map->addr;
 	snap->addr_end = map->addr_end;
@@ -31,6 +80,20 @@ RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
 	snap->perm = map->perm;
 	snap->user = map->user;
 	snap->shared = map->shared;
+	return snap;
+}
+
+RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
+	rz_return_val_if_fail(dbg && map, NULL);
+	if (map->size < 1) {
+		eprintf("Invalid map size\n");
+		return NULL;
+	}
+
+	RzDebugSnap *snap = snap_new(map);
+	if (!snap) {
+		return NULL;
+	}
 
 	snap->data = malloc(map->size);
 	if (!snap->data) {
@@ -43,12 +106,107 @@ RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
 	return snap;
 }
 
+/**
+ * \brief Snaps \p map in pages of \p page_size bytes
+ *
+ * The pages are interned into \p store, being shared with the ones holding
+ * the same bytes in the other snaps. When \p dirty is given, it tells for
+ * each page of \p map whether it may have changed since \p base, a snap
+ * of the same map, was taken: the pages that did not are taken from \p base
+ * without reading them.
+ */
+RZ_API RzDebugSnap *rz_debug_snap_map_pages(RzDebug *dbg, RzDebugMap *map, ut32 page_size, RZ_NULLABLE HtUP *store, RZ_NULLABLE RzDebugSnap *base, RZ_NULLABLE const ut8 *dirty) {
+	rz_return_val_if_fail(dbg && map && page_size, NULL);
+	if (map->size < 1) {
+		eprintf("Invalid map size\n");
+		return NULL;
+	}
+	if (base && (!base->pages || base->addr != map->addr || base->size != map->size || base->page_size != page_size)) {
+		base = NULL;
+	}
+	if (!base) {
+		dirty = NULL;
+	}
+
+	RzDebugSnap *snap = snap_new(map);
+	if (!snap) {
+		return NULL;
+	}
+	snap->page_size = page_size;
+	const size_t count = snap_page_count(snap);
+	snap->pages = RZ_NEWS0(RzDebugSnapPage *, count);
+	const ut32 chunk_pages = RZ_MAX(SNAP_READ_MAX / page_size, 1);
+	ut8 *buf = malloc((size_t)chunk_pages * page_size);
+	if (!snap->pages || !buf) {
+		free(buf);
+		rz_debug_snap_free(snap);
+		return NULL;
+	}
+	size_t i = 0;
+	while (i < count) {
+		if (dirty && !dirty[i]) {
+			snap->pages[i] = base->pages[i];
+			snap->pages[i]->refs++;
+			i++;
+			continue;
+		}
+		// read the run of dirty pages from i at once
+		size_t n = 1;
+		while (n < chunk_pages && i + n < count && (!dirty || dirty[i + n])) {
+			n++;
+		}
+		const ut64 off = (ut64)i * page_size;
+		const ut32 len = RZ_MIN((ut64)n * page_size, snap->size - off);
+		memset(buf, 0xff, len);
+		dbg->iob.read_at(dbg->iob.io, snap->addr + off, buf, len);
+		size_t j;
+		for (j = 0; j < n; j++) {
+			const ut32 psize = RZ_MIN(page_size, len - j * page_size);
+			snap->pages[i + j] = rz_debug_snap_page_new(store, buf + j * page_size, psize);
+			if (!snap->pages[i + j]) {
+				free(buf);
+				rz_debug_snap_free(snap);
+				return NULL;
+			}
+		}
+		i += n;
+	}
+	free(buf);
+	return snap;
+}
+
+/**
+ * \brief Returns a copy of the bytes of \p snap, however they are held
+ */
+RZ_API ut8 *rz_debug_snap_data(RZ_NONNULL RzDebugSnap *snap) {
+	rz_return_val_if_fail(snap, NULL);
+	if (!snap->pages) {
+		return snap->data ? rz_mem_dup(snap->data, snap->size) : NULL;
+	}
+	ut8 *data = malloc(snap->size);
+	if (!data) {
+		return NULL;
+	}
+	size_t i, count = snap_page_count(snap);
+	for (i = 0; i < count; i++) {
+		memcpy(data + i * snap->page_size, snap->pages[i]->data, snap->pages[i]->size);
+	}
+	return data;
+}
+
 RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr) {
 	return (snap->addr <= addr && addr >= snap->addr_end);
 }
 
 RZ_API ut8 *rz_debug_snap_get_hash(RzDebugSnap *snap, RzMsgDigestSize *size) {
-	ut8 *digest = rz_msg_digest_calculate_small_block("sha256", snap->data, snap->size, size);
+	ut8 *data = snap->pages ? rz_debug_snap_data(snap) : snap->data;
+	if (!data) {
+		return NULL;
+	}
+	ut8 *digest = rz_msg_digest_calculate_small_block("sha256", data, snap->size, size);
+	if (data != snap->data) {
+		free(data);
+	}
 	if (!digest) {
 		return NULL;
 	}
@@ -3,6 +3,10 @@
 
 #include <rz_debug.h>
 
+static void trace_tag_kv_free(HtUPKv *kv) {
+	ht_up_free(kv->value);
+}
+
 /* Old debug trace implementation */
 RZ_API RzDebugTrace *rz_debug_trace_new(void) {
 	RzDebugTrace *t = RZ_NEW0(RzDebugTrace);
@@ -18,7 +22,7 @@ RZ_API RzDebugTrace *rz_debug_trace_new(void) {
 		return NULL;
 	}
 	t->traces->free = free;
-	t->ht = ht_pp_new0();
+	t->ht = ht_up_new(NULL, trace_tag_kv_free, NULL);
 	if (!t->ht) {
 		rz_debug_trace_free(t);
 		return NULL;
@@ -32,7 +36,9 @@ RZ_API void rz_debug_trace_free(RzDebugTrace *trace) {
 	}
 	rz_list_purge(trace->traces);
 	free(trace->traces);
-	ht_pp_free(trace->ht);
+	ht_up_free(trace->ht);
+	rz_trace_store_free(trace->store);
+	rz_trace_store_free(trace->baseline);
 	RZ_FREE(trace);
 }
 
@@ -139,10 +145,7 @@ RZ_API bool rz_debug_trace_ins_after(RzDebug *dbg) {
 			}
 
 			// add mem write
-			size_t i;
-			for (i = 0; i < val->memref; i++) {
-				rz_debug_session_add_mem_change(dbg->session, val->base + i, buf[i]);
-			}
+			rz_debug_session_add_mem_range(dbg->session, val->base, buf, val->memref);
 			break;
 		}
 		default:
@@ -174,8 +177,39 @@ RZ_API int rz_debug_trace_pc(RzDebug *dbg, ut64 pc) {
 	return true;
 }
 
+/*
+ * In compact mode, the op is traced right away with the writes of its esil,
+ * all of them being appended to the trace store.
+ */
+static void trace_op_compact(RzDebug *dbg, RzAnalysisOp *op) {
+	bool traced = rz_debug_trace_add(dbg, op->addr, op->size);
+	if (!dbg->trace->enabled) {
+		return;
+	}
+	RzAnalysisEsil *esil = dbg->analysis->esil;
+	if (!esil) {
+		if (dbg->verbose) {
+			eprintf("Run aeim to get dbg->analysis->esil initialized\n");
+		}
+		return;
+	}
+	if (traced) {
+		rz_analysis_esil_trace_op_store(esil, op, dbg->trace->store);
+		return;
+	}
+	const char *expr = rz_strbuf_get(&op->esil);
+	if (RZ_STR_ISNOTEMPTY(expr)) {
+		rz_analysis_esil_parse(esil, expr);
+		rz_analysis_esil_stack_free(esil);
+	}
+}
+
 RZ_API void rz_debug_trace_op(RzDebug *dbg, RzAnalysisOp *op) {
 	static ut64 oldpc = UT64_MAX; // Must trace the previously traced instruction
+	if (dbg->trace_compact) {
+		trace_op_compact(dbg, op);
+		return;
+	}
 	if (dbg->trace->enabled) {
 		if (dbg->analysis->esil) {
 			rz_analysis_esil_trace_op(dbg->analysis->esil, op);
@@ -198,9 +232,8 @@ RZ_API void rz_debug_trace_at(RzDebug *dbg, const char *str) {
 }
 
 RZ_API RzDebugTracepoint *rz_debug_trace_get(RzDebug *dbg, ut64 addr) {
-	int tag = dbg->trace->tag;
-	return ht_pp_find(dbg->trace->ht,
-		sdb_fmt("trace.%d.%" PFMT64x, tag, addr), NULL);
+	HtUP *by_addr = ht_up_find(dbg->trace->ht, dbg->trace->tag, NULL);
+	return by_addr ? ht_up_find(by_addr, addr, NULL) : NULL;
 }
 
 static int cmpaddr(const void *_a, const void *_b) {
@@ -258,13 +291,44 @@ static int rz_debug_trace_is_traceable(RzDebug *dbg, ut64 addr) {
 	return true;
 }
 
+static bool trace_store_add(RzDebug *dbg, ut64 addr) {
+	RzDebugTrace *trace = dbg->trace;
+	if (!trace->store) {
+		trace->store = rz_trace_store_new(dbg->trace_spill);
+		if (!trace->store) {
+			return false;
+		}
+	}
+	return rz_trace_store_add_pc(trace->store, addr);
+}
+
 RZ_API RzDebugTracepoint *rz_debug_trace_add(RzDebug *dbg, ut64 addr, int size) {
 	RzDebugTracepoint *tp;
 	int tag = dbg->trace->tag;
 	if (!rz_debug_trace_is_traceable(dbg, addr)) {
 		return NULL;
 	}
+	HtUP *by_addr = ht_up_find(dbg->trace->ht, tag, NULL);
+	if (!by_addr) {
+		by_addr = ht_up_new0();
+		if (!by_addr || !ht_up_insert(dbg->trace->ht, tag, by_addr)) {
+			ht_up_free(by_addr);
+			return NULL;
+		}
+	}
 	rz_analysis_trace_bb(dbg->analysis, addr);
+	if (dbg->trace_compact) {
+		// a single tracepoint by address, counting its hits
+		if (!trace_store_add(dbg, addr)) {
+			return NULL;
+		}
+		tp = ht_up_find(by_addr, addr, NULL);
+		if (tp) {
+			tp->count = ++dbg->trace->count;
+			tp->times++;
+			return tp;
+		}
+	}
 	tp = RZ_NEW0(RzDebugTracepoint);
 	if (!tp) {
 		return NULL;
@@ -276,16 +340,37 @@ RZ_API RzDebugTracepoint *rz_debug_trace_add(RzDebug *dbg, ut64 addr, int size)
 	tp->count = ++dbg->trace->count;
 	tp->times = 1;
 	rz_list_append(dbg->trace->traces, tp);
-	ht_pp_update(dbg->trace->ht,
-		sdb_fmt("trace.%d.%" PFMT64x, tag, addr), tp);
+	ht_up_update(by_addr, addr, tp);
 	return tp;
 }
 
+/**
+ * \brief Keeps the compact trace of \p dbg as its baseline, the next steps
+ * being recorded to a new one
+ *
+ * The previous baseline is freed, rz_debug_trace_reset() keeps it.
+ *
+ * \return false if nothing was recorded to the compact trace
+ */
+RZ_API bool rz_debug_trace_compact_baseline(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg && dbg->trace, false);
+	RzDebugTrace *t = dbg->trace;
+	if (!t->store) {
+		return false;
+	}
+	rz_trace_store_free(t->baseline);
+	t->baseline = t->store;
+	t->store = NULL;
+	return true;
+}
+
 RZ_API void rz_debug_trace_reset(RzDebug *dbg) {
 	RzDebugTrace *t = dbg->trace;
 	rz_list_purge(t->traces);
-	ht_pp_free(t->ht);
-	t->ht = ht_pp_new0();
+	ht_up_free(t->ht);
+	t->ht = ht_up_new(NULL, trace_tag_kv_free, NULL);
+	rz_trace_store_free(t->store);
+	t->store = NULL;
 	t->traces = rz_list_new();
 	t->traces->free = free;
 }
@@ -20,6 +20,17 @@ bool rz_adler32_update(RzAdler32 *ctx, const ut8 *data, size_t len) {
 	return true;
 }
 
+/**
+ * Slides the \p len bytes hashed by \p ctx by one byte, removing \p out
+ * and appending \p in.
+ */
+bool rz_adler32_roll(RzAdler32 *ctx, ut8 out, ut8 in, size_t len) {
+	rz_return_val_if_fail(ctx, false);
+	ctx->low = (ctx->low + 65521 - out + in) % 65521;
+	ctx->high = (ctx->high + ctx->low + 65521 - 1 + 65521 - (ut32)((len % 65521) * out % 65521)) % 65521;
+	return true;
+}
+
 bool rz_adler32_final(ut8 *digest, RzAdler32 *ctx) {
 	rz_return_val_if_fail(digest && ctx, false);
 	rz_write_le32(digest, ctx->high << 16 | ctx->low);
@@ -16,5 +16,6 @@ typedef struct adler32_t {
 bool rz_adler32_init(RzAdler32 *ctx);
 bool rz_adler32_update(RzAdler32 *ctx, const ut8 *data, size_t len);
 bool rz_adler32_final(ut8 *digest, RzAdler32 *ctx);
+bool rz_adler32_roll(RzAdler32 *ctx, ut8 out, ut8 in, size_t len);
 
 #endif /* RZ_ADLER32_H */
@@ -25,3 +25,9 @@ bool rz_mod255_final(ut8 *digest, RzMod255 *ctx) {
 	*digest = (*ctx) % 255;
 	return true;
 }
+
+bool rz_mod255_roll(RzMod255 *ctx, ut8 out, ut8 in) {
+	rz_return_val_if_fail(ctx, false);
+	*ctx = (ut8)(*ctx - out + in);
+	return true;
+}
@@ -14,5 +14,6 @@ typedef ut32 RzMod255;
 bool rz_mod255_init(RzMod255 *ctx);
 bool rz_mod255_update(RzMod255 *ctx, const ut8 *data, size_t len);
 bool rz_mod255_final(ut8 *digest, RzMod255 *ctx);
+bool rz_mod255_roll(RzMod255 *ctx, ut8 out, ut8 in);
 
 #endif /* RZ_MOD255_H */
@@ -27,3 +27,12 @@ bool rz_parity_final(ut8 *digest, RzParity *ctx) {
 	*digest = (*ctx) & 1;
 	return true;
 }
+
+bool rz_parity_roll(RzParity *ctx, ut8 out, ut8 in) {
+	rz_return_val_if_fail(ctx, false);
+	RzParity out_ones = 0, in_ones = 0;
+	rz_parity_update(&out_ones, &out, 1);
+	rz_parity_update(&in_ones, &in, 1);
+	*ctx = *ctx - out_ones + in_ones;
+	return true;
+}
@@ -14,5 +14,6 @@ typedef ut32 RzParity;
 bool rz_parity_init(RzParity *ctx);
 bool rz_parity_update(RzParity *ctx, const ut8 *data, size_t len);
 bool rz_parity_final(ut8 *digest, RzParity *ctx);
+bool rz_parity_roll(RzParity *ctx, ut8 out, ut8 in);
 
 #endif /* RZ_PARITY_H */
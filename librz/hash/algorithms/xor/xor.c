@@ -26,6 +26,12 @@ bool rz_xor8_final(ut8 *digest, RzXor8 *ctx) {
 	return true;
 }
 
+bool rz_xor8_roll(RzXor8 *ctx, ut8 out, ut8 in) {
+	rz_return_val_if_fail(ctx, false);
+	*ctx ^= out ^ in;
+	return true;
+}
+
 bool rz_xor16_init(RzXor16 *ctx) {
 	rz_return_val_if_fail(ctx, false);
 	*ctx = 0;
@@ -14,6 +14,7 @@ typedef ut8 RzXor8;
 bool rz_xor8_init(RzXor8 *ctx);
 bool rz_xor8_update(RzXor8 *ctx, const ut8 *data, size_t len);
 bool rz_xor8_final(ut8 *digest, RzXor8 *ctx);
+bool rz_xor8_roll(RzXor8 *ctx, ut8 out, ut8 in);
 
 #define RZ_HASH_XOR16_DIGEST_SIZE 2
 
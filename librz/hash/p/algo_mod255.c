@@ -43,6 +43,13 @@ static bool plugin_mod255_final(void *context, ut8 *digest) {
 	return true;
 }
 
+static bool plugin_mod255_roll(void *context, ut8 out, ut8 in, ut64 size) {
+	rz_return_val_if_fail(context, false);
+
+	rz_mod255_roll((RzMod255 *)context, out, in);
+	return true;
+}
+
 static bool plugin_mod255_small_block(const ut8 *data, ut64 size, ut8 **digest, RzMsgDigestSize *digest_size) {
 	rz_return_val_if_fail(data && digest, false);
 	ut8 *dgst = malloc(RZ_HASH_MOD255_DIGEST_SIZE);
@@ -75,6 +82,7 @@ RzMsgDigestPlugin rz_msg_digest_plugin_mod255 = {
 	.update = plugin_mod255_update,
 	.final = plugin_mod255_final,
 	.small_block = plugin_mod255_small_block,
+	.roll = plugin_mod255_roll,
 };
 
 #ifndef RZ_PLUGIN_INCORE
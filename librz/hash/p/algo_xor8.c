@@ -43,6 +43,13 @@ static bool plugin_xor8_final(void *context, ut8 *digest) {
 	return true;
 }
 
+static bool plugin_xor8_roll(void *context, ut8 out, ut8 in, ut64 size) {
+	rz_return_val_if_fail(context, false);
+
+	rz_xor8_roll((RzXor8 *)context, out, in);
+	return true;
+}
+
 static bool plugin_xor8_small_block(const ut8 *data, ut64 size, ut8 **digest, RzMsgDigestSize *digest_size) {
 	rz_return_val_if_fail(data && digest, false);
 	ut8 *dgst = malloc(RZ_HASH_XOR8_DIGEST_SIZE);
@@ -75,6 +82,7 @@ RzMsgDigestPlugin rz_msg_digest_plugin_xor8 = {
 	.update = plugin_xor8_update,
 	.final = plugin_xor8_final,
 	.small_block = plugin_xor8_small_block,
+	.roll = plugin_xor8_roll,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -0,0 +1,1011 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file
+ * RzIL compiled to a linear code, as an alternative to walking the op trees.
+ *
+ * rz_il_vm_step() evaluates the op tree of an instruction recursively, with a
+ * new RzBitVector for every intermediate value and variables looked up by
+ * name. When the IL of an instruction is run many times, it can be compiled
+ * once with rz_il_vm_compile() and run with rz_il_vm_step_code():
+ *
+ * - every value is held in a numbered slot of the code, a ut64 for bitvectors
+ *   of up to 64 bits and a 0/1 for bools, so that nothing is allocated but the
+ *   events.
+ * - global variables are resolved once per step, let bindings and local
+ *   variables are given a slot at compile time.
+ * - ite, branch and repeat become jumps in the code.
+ *
+ * The code behaves like rz_il_vm_step(), which stays the reference: same
+ * events in the same order, same state afterwards. What cannot be compiled
+ * this way, for example bitvectors larger than 64 bits, ill-sorted ops or a
+ * vm with custom op handlers, is left to rz_il_vm_step().
+ */
+
+#include <rz_il/rz_il_vm.h>
+
+#define SLOTS_MAX  UT16_MAX
+#define LOCALS_MAX 64
+
+extern RZ_IPI RzILOpPureHandler rz_il_op_handler_pure_table_default[RZ_IL_OP_PURE_MAX];
+extern RZ_IPI RzILOpEffectHandler rz_il_op_handler_effect_table_default[RZ_IL_OP_EFFECT_MAX];
+
+typedef enum {
+	INSN_CONST, ///< dst = imm
+	INSN_MOV, ///< dst = a
+	INSN_VAR, ///< dst = global var imm, with a var read event
+	INSN_LOCAL, ///< dst = a, the slot of local var imm, which must be set
+	INSN_SET, ///< global var imm = a, with a var write event
+	INSN_SET_LOCAL, ///< dst = a, dst being the slot of local var imm
+	INSN_NEG,
+	INSN_NOT, ///< also bool inv
+	INSN_MSB,
+	INSN_LSB,
+	INSN_IS_ZERO,
+	INSN_ADD,
+	INSN_SUB,
+	INSN_MUL,
+	INSN_DIV,
+	INSN_SDIV,
+	INSN_MOD,
+	INSN_SMOD,
+	INSN_AND, ///< also bool and
+	INSN_OR, ///< also bool or
+	INSN_XOR, ///< also bool xor
+	INSN_SHIFTL, ///< dst = a shifted by b, filled with c
+	INSN_SHIFTR, ///< dst = a shifted by b, filled with c
+	INSN_EQ,
+	INSN_SLE,
+	INSN_ULE,
+	INSN_CAST, ///< dst = a of w2 bits cast to w bits, filled with b
+	INSN_APPEND, ///< dst = a:b, b being of w2 bits
+	INSN_LOAD, ///< dst = load from mem imm at a of w2 bits
+	INSN_LOADW, ///< dst = loadw of w bits from mem imm at a of w2 bits
+	INSN_STORE, ///< store b of w bits to mem imm at a of w2 bits
+	INSN_STOREW, ///< storew b of w bits to mem imm at a of w2 bits
+	INSN_JMP, ///< pc = a of w bits
+	INSN_GOTO, ///< goto op
+	INSN_LABEL, ///< label of the blk op = pc
+	INSN_BRANCH, ///< continue at imm if a is false
+	INSN_JUMP, ///< continue at imm
+} InsnCode;
+
+typedef struct {
+	ut8 code; ///< InsnCode
+	ut8 w; ///< bits of the result, or of the operands for comparisons and stores
+	ut8 w2; ///< bits of a second operand, see InsnCode
+	ut16 dst, a, b, c; ///< slots
+	ut64 imm;
+	const void *ref; ///< the op of INSN_GOTO and INSN_LABEL, the var name of INSN_LOCAL
+} Insn;
+
+typedef struct {
+	char *name;
+	RzILSortPure sort;
+	RzILVal *val; ///< bound by code_bind() for the current step
+} Global;
+
+struct rz_il_code_t {
+	RzILOpEffect *op; ///< compiled op, borrowed
+	Insn *insns;
+	size_t count;
+	Global *globals;
+	size_t globals_count;
+	ut64 *slots;
+};
+
+typedef struct {
+	const char *name;
+	RzILSortPure sort;
+	ut16 slot;
+} Binding;
+
+typedef struct {
+	RzILVM *vm;
+	RzVector /*<Insn>*/ insns;
+	RzVector /*<Global>*/ globals;
+	RzVector /*<Binding>*/ locals; ///< set by local set ops
+	RzVector /*<Binding>*/ lets; ///< bound by the let ops being compiled, innermost last
+	ut32 slots;
+} Compiler;
+
+typedef struct {
+	ut16 slot;
+	RzILSortPure sort;
+} Value;
+
+static bool compile_pure(Compiler *c, RzILOpPure *op, Value *out);
+static bool compile_effect(Compiler *c, RzILOpEffect *op);
+
+static inline ut64 mask_of(ut32 bits) {
+	return bits < 64 ? (1ULL << bits) - 1 : UT64_MAX;
+}
+
+static inline ut32 bits_of(RzILSortPure sort) {
+	return sort.type == RZ_IL_TYPE_PURE_BOOL ? 1 : sort.props.bv.length;
+}
+
+static inline bool is_small_bv(RzILSortPure sort) {
+	return sort.type == RZ_IL_TYPE_PURE_BITVECTOR && sort.props.bv.length && sort.props.bv.length <= 64;
+}
+
+static inline bool is_bool(RzILSortPure sort) {
+	return sort.type == RZ_IL_TYPE_PURE_BOOL;
+}
+
+static bool new_slot(Compiler *c, ut16 *slot) {
+	if (c->slots >= SLOTS_MAX) {
+		return false;
+	}
+	*slot = c->slots++;
+	return true;
+}
+
+static Insn *emit(Compiler *c, InsnCode code) {
+	Insn *insn = rz_vector_push(&c->insns, NULL);
+	if (insn) {
+		memset(insn, 0, sizeof(*insn));
+		insn->code = code;
+	}
+	return insn;
+}
+
+/// Emit \p code computing a new value of \p sort into \p out
+static Insn *emit_value(Compiler *c, InsnCode code, RzILSortPure sort, Value *out) {
+	if (!new_slot(c, &out->slot)) {
+		return NULL;
+	}
+	out->sort = sort;
+	Insn *insn = emit(c, code);
+	if (insn) {
+		insn->dst = out->slot;
+		insn->w = bits_of(sort);
+	}
+	return insn;
+}
+
+static bool global_index(Compiler *c, const char *name, size_t *index) {
+	for (size_t i = 0; i < rz_vector_len(&c->globals); i++) {
+		Global *g = rz_vector_index_ptr(&c->globals, i);
+		if (!strcmp(g->name, name)) {
+			*index = i;
+			return true;
+		}
+	}
+	RzILVar *var = rz_il_vm_get_var(c->vm, RZ_IL_VAR_KIND_GLOBAL, name);
+	if (!var || !(is_bool(var->sort) || is_small_bv(var->sort))) {
+		return false;
+	}
+	Global global = { strdup(name), var->sort, NULL };
+	if (!global.name || !rz_vector_push(&c->globals, &global)) {
+		free(global.name);
+		return false;
+	}
+	*index = rz_vector_len(&c->globals) - 1;
+	return true;
+}
+
+static Binding *find_binding(RzVector *bindings, const char *name, size_t *index) {
+	for (size_t i = rz_vector_len(bindings); i; i--) {
+		Binding *b = rz_vector_index_ptr(bindings, i - 1);
+		if (!strcmp(b->name, name)) {
+			if (index) {
+				*index = i - 1;
+			}
+			return b;
+		}
+	}
+	return NULL;
+}
+
+static bool compile_bv(Compiler *c, RzILOpBitVector *op, Value *out) {
+	return compile_pure(c, op, out) && is_small_bv(out->sort);
+}
+
+static bool compile_bool(Compiler *c, RzILOpBool *op, Value *out) {
+	return compile_pure(c, op, out) && is_bool(out->sort);
+}
+
+static bool compile_var(Compiler *c, RzILOpArgsVar *args, Value *out) {
+	size_t index;
+	Binding *b;
+	Insn *insn;
+	switch (args->kind) {
+	case RZ_IL_VAR_KIND_GLOBAL:
+		if (!global_index(c, args->v, &index)) {
+			return false;
+		}
+		insn = emit_value(c, INSN_VAR, ((Global *)rz_vector_index_ptr(&c->globals, index))->sort, out);
+		if (!insn) {
+			return false;
+		}
+		insn->imm = index;
+		return true;
+	case RZ_IL_VAR_KIND_LOCAL:
+		// a local must have been set before, in the order of the code
+		b = find_binding(&c->locals, args->v, &index);
+		if (!b || !(insn = emit_value(c, INSN_LOCAL, b->sort, out))) {
+			return false;
+		}
+		insn->a = b->slot;
+		insn->imm = index;
+		insn->ref = b->name;
+		return true;
+	case RZ_IL_VAR_KIND_LOCAL_PURE:
+		// immutable, the slot of the let binding is used directly
+		b = find_binding(&c->lets, args->v, NULL);
+		if (!b) {
+			return false;
+		}
+		out->slot = b->slot;
+		out->sort = b->sort;
+		return true;
+	}
+	return false;
+}
+
+static bool compile_ite(Compiler *c, RzILOpArgsIte *args, Value *out) {
+	Value cond, x, y;
+	if (!compile_bool(c, args->condition, &cond) || !new_slot(c, &out->slot)) {
+		return false;
+	}
+	size_t branch = rz_vector_len(&c->insns);
+	Insn *insn = emit(c, INSN_BRANCH);
+	if (!insn) {
+		return false;
+	}
+	insn->a = cond.slot;
+	if (!compile_pure(c, args->x, &x) || !(insn = emit(c, INSN_MOV))) {
+		return false;
+	}
+	insn->dst = out->slot;
+	insn->a = x.slot;
+	size_t jump = rz_vector_len(&c->insns);
+	if (!emit(c, INSN_JUMP)) {
+		return false;
+	}
+	((Insn *)rz_vector_index_ptr(&c->insns, branch))->imm = rz_vector_len(&c->insns);
+	if (!compile_pure(c, args->y, &y) || !rz_il_sort_pure_eq(x.sort, y.sort) || !(insn = emit(c, INSN_MOV))) {
+		return false;
+	}
+	insn->dst = out->slot;
+	insn->a = y.slot;
+	((Insn *)rz_vector_index_ptr(&c->insns, jump))->imm = rz_vector_len(&c->insns);
+	out->sort = x.sort;
+	return true;
+}
+
+static bool compile_let(Compiler *c, RzILOpArgsLet *args, Value *out) {
+	Value v;
+	if (!compile_pure(c, args->exp, &v)) {
+		return false;
+	}
+	Binding b = { args->name, v.sort, v.slot };
+	if (!rz_vector_push(&c->lets, &b)) {
+		return false;
+	}
+	bool ret = compile_pure(c, args->body, out);
+	rz_vector_pop(&c->lets, NULL);
+	return ret;
+}
+
+static bool compile_unop(Compiler *c, InsnCode code, RzILOpPure *x, bool result_bool, Value *out) {
+	Value vx;
+	if (!(code == INSN_NOT && result_bool ? compile_bool(c, x, &vx) : compile_bv(c, x, &vx))) {
+		return false;
+	}
+	Insn *insn = emit_value(c, code, result_bool ? rz_il_sort_pure_bool() : vx.sort, out);
+	if (!insn) {
+		return false;
+	}
+	insn->a = vx.slot;
+	insn->w = bits_of(vx.sort);
+	return true;
+}
+
+static bool compile_binop(Compiler *c, InsnCode code, RzILOpPure *x, RzILOpPure *y, bool bools, bool result_bool, Value *out) {
+	Value vx, vy;
+	if (bools) {
+		if (!compile_bool(c, x, &vx) || !compile_bool(c, y, &vy)) {
+			return false;
+		}
+	} else if (!compile_bv(c, x, &vx) || !compile_bv(c, y, &vy) || !rz_il_sort_pure_eq(vx.sort, vy.sort)) {
+		return false;
+	}
+	Insn *insn = emit_value(c, code, result_bool ? rz_il_sort_pure_bool() : vx.sort, out);
+	if (!insn) {
+		return false;
+	}
+	insn->a = vx.slot;
+	insn->b = vy.slot;
+	insn->w = bits_of(vx.sort);
+	return true;
+}
+
+static bool compile_shift(Compiler *c, InsnCode code, struct rz_il_op_args_shift_t *args, Value *out) {
+	Value x, y, fill;
+	if (!compile_bv(c, args->x, &x) || !compile_bv(c, args->y, &y) || !compile_bool(c, args->fill_bit, &fill)) {
+		return false;
+	}
+	Insn *insn = emit_value(c, code, x.sort, out);
+	if (!insn) {
+		return false;
+	}
+	insn->a = x.slot;
+	insn->b = y.slot;
+	insn->c = fill.slot;
+	return true;
+}
+
+static bool compile_cast(Compiler *c, RzILOpArgsCast *args, Value *out) {
+	Value fill, val;
+	if (!args->length || args->length > 64 || !compile_bool(c, args->fill, &fill) || !compile_bv(c, args->val, &val)) {
+		return false;
+	}
+	Insn *insn = emit_value(c, INSN_CAST, rz_il_sort_pure_bv(args->length), out);
+	if (!insn) {
+		return false;
+	}
+	insn->a = val.slot;
+	insn->b = fill.slot;
+	insn->w2 = bits_of(val.sort);
+	return true;
+}
+
+static bool compile_append(Compiler *c, RzILOpArgsAppend *args, Value *out) {
+	Value high, low;
+	if (!compile_bv(c, args->high, &high) || !compile_bv(c, args->low, &low) ||
+		bits_of(high.sort) + bits_of(low.sort) > 64) {
+		return false;
+	}
+	Insn *insn = emit_value(c, INSN_APPEND, rz_il_sort_pure_bv(bits_of(high.sort) + bits_of(low.sort)), out);
+	if (!insn) {
+		return false;
+	}
+	insn->a = high.slot;
+	insn->b = low.slot;
+	insn->w2 = bits_of(low.sort);
+	return true;
+}
+
+static bool compile_load(Compiler *c, InsnCode code, RzILMemIndex index, RzILOpBitVector *key, ut32 n_bits, Value *out) {
+	RzILMem *mem = rz_il_vm_get_mem(c->vm, index);
+	Value k;
+	if (!mem || !compile_bv(c, key, &k)) {
+		return false;
+	}
+	ut32 bits = code == INSN_LOAD ? rz_il_mem_value_len(mem) : n_bits;
+	if (!bits || bits > 64) {
+		return false;
+	}
+	Insn *insn = emit_value(c, code, rz_il_sort_pure_bv(bits), out);
+	if (!insn) {
+		return false;
+	}
+	insn->a = k.slot;
+	insn->w2 = bits_of(k.sort);
+	insn->imm = index;
+	return true;
+}
+
+static bool compile_pure(Compiler *c, RzILOpPure *op, Value *out) {
+	if (!op) {
+		return false;
+	}
+	Insn *insn;
+	switch (op->code) {
+	case RZ_IL_OP_VAR:
+		return compile_var(c, &op->op.var, out);
+	case RZ_IL_OP_ITE:
+		return compile_ite(c, &op->op.ite, out);
+	case RZ_IL_OP_LET:
+		return compile_let(c, &op->op.let, out);
+	case RZ_IL_OP_B0:
+	case RZ_IL_OP_B1:
+		insn = emit_value(c, INSN_CONST, rz_il_sort_pure_bool(), out);
+		if (!insn) {
+			return false;
+		}
+		insn->imm = op->code == RZ_IL_OP_B1;
+		return true;
+	case RZ_IL_OP_INV:
+		return compile_unop(c, INSN_NOT, op->op.boolinv.x, true, out);
+	case RZ_IL_OP_AND:
+		return compile_binop(c, INSN_AND, op->op.booland.x, op->op.booland.y, true, true, out);
+	case RZ_IL_OP_OR:
+		return compile_binop(c, INSN_OR, op->op.boolor.x, op->op.boolor.y, true, true, out);
+	case RZ_IL_OP_XOR:
+		return compile_binop(c, INSN_XOR, op->op.boolxor.x, op->op.boolxor.y, true, true, out);
+	case RZ_IL_OP_BITV: {
+		RzBitVector *bv = op->op.bitv.value;
+		if (!bv || !bv->len || bv->len > 64 || !(insn = emit_value(c, INSN_CONST, rz_il_sort_pure_bv(bv->len), out))) {
+			return false;
+		}
+		insn->imm = rz_bv_to_ut64(bv);
+		return true;
+	}
+	case RZ_IL_OP_MSB:
+		return compile_unop(c, INSN_MSB, op->op.msb.bv, true, out);
+	case RZ_IL_OP_LSB:
+		return compile_unop(c, INSN_LSB, op->op.lsb.bv, true, out);
+	case RZ_IL_OP_IS_ZERO:
+		return compile_unop(c, INSN_IS_ZERO, op->op.is_zero.bv, true, out);
+	case RZ_IL_OP_NEG:
+		return compile_unop(c, INSN_NEG, op->op.neg.bv, false, out);
+	case RZ_IL_OP_LOGNOT:
+		return compile_unop(c, INSN_NOT, op->op.lognot.bv, false, out);
+	case RZ_IL_OP_ADD:
+		return compile_binop(c, INSN_ADD, op->op.add.x, op->op.add.y, false, false, out);
+	case RZ_IL_OP_SUB:
+		return compile_binop(c, INSN_SUB, op->op.sub.x, op->op.sub.y, false, false, out);
+	case RZ_IL_OP_MUL:
+		return compile_binop(c, INSN_MUL, op->op.mul.x, op->op.mul.y, false, false, out);
+	case RZ_IL_OP_DIV:
+		return compile_binop(c, INSN_DIV, op->op.div.x, op->op.div.y, false, false, out);
+	case RZ_IL_OP_SDIV:
+		return compile_binop(c, INSN_SDIV, op->op.sdiv.x, op->op.sdiv.y, false, false, out);
+	case RZ_IL_OP_MOD:
+		return compile_binop(c, INSN_MOD, op->op.mod.x, op->op.mod.y, false, false, out);
+	case RZ_IL_OP_SMOD:
+		return compile_binop(c, INSN_SMOD, op->op.smod.x, op->op.smod.y, false, false, out);
+	case RZ_IL_OP_LOGAND:
+		return compile_binop(c, INSN_AND, op->op.logand.x, op->op.logand.y, false, false, out);
+	case RZ_IL_OP_LOGOR:
+		return compile_binop(c, INSN_OR, op->op.logor.x, op->op.logor.y, false, false, out);
+	case RZ_IL_OP_LOGXOR:
+		return compile_binop(c, INSN_XOR, op->op.logxor.x, op->op.logxor.y, false, false, out);
+	case RZ_IL_OP_SHIFTR:
+		return compile_shift(c, INSN_SHIFTR, &op->op.shiftr, out);
+	case RZ_IL_OP_SHIFTL:
+		return compile_shift(c, INSN_SHIFTL, &op->op.shiftl, out);
+	case RZ_IL_OP_EQ:
+		return compile_binop(c, INSN_EQ, op->op.eq.x, op->op.eq.y, false, true, out);
+	case RZ_IL_OP_SLE:
+		return compile_binop(c, INSN_SLE, op->op.sle.x, op->op.sle.y, false, true, out);
+	case RZ_IL_OP_ULE:
+		return compile_binop(c, INSN_ULE, op->op.ule.x, op->op.ule.y, false, true, out);
+	case RZ_IL_OP_CAST:
+		return compile_cast(c, &op->op.cast, out);
+	case RZ_IL_OP_APPEND:
+		return compile_append(c, &op->op.append, out);
+	case RZ_IL_OP_LOAD:
+		return compile_load(c, INSN_LOAD, op->op.load.mem, op->op.load.key, 0, out);
+	case RZ_IL_OP_LOADW:
+		return compile_load(c, INSN_LOADW, op->op.loadw.mem, op->op.loadw.key, op->op.loadw.n_bits, out);
+	default:
+		return false;
+	}
+}
+
+static bool compile_set(Compiler *c, RzILOpArgsSet *args) {
+	Value v;
+	size_t index;
+	if (!compile_pure(c, args->x, &v)) {
+		return false;
+	}
+	Insn *insn;
+	if (!args->is_local) {
+		if (!global_index(c, args->v, &index) ||
+			!rz_il_sort_pure_eq(((Global *)rz_vector_index_ptr(&c->globals, index))->sort, v.sort) ||
+			!(insn = emit(c, INSN_SET))) {
+			return false;
+		}
+		insn->a = v.slot;
+		insn->w = bits_of(v.sort);
+		insn->imm = index;
+		return true;
+	}
+	Binding *b = find_binding(&c->locals, args->v, &index);
+	if (!b) {
+		Binding local = { args->v, v.sort, 0 };
+		if (rz_vector_len(&c->locals) >= LOCALS_MAX || !new_slot(c, &local.slot) ||
+			!(b = rz_vector_push(&c->locals, &local))) {
+			return false;
+		}
+		index = rz_vector_len(&c->locals) - 1;
+	}
+	if (!rz_il_sort_pure_eq(b->sort, v.sort)) {
+		// the var keeps the sort it was first set with
+		return false;
+	}
+	ut16 slot = b->slot;
+	if (!(insn = emit(c, INSN_SET_LOCAL))) {
+		return false;
+	}
+	insn->dst = slot;
+	insn->a = v.slot;
+	insn->imm = index;
+	return true;
+}
+
+static bool compile_store(Compiler *c, InsnCode code, RzILMemIndex index, RzILOpBitVector *key, RzILOpBitVector *value) {
+	Value k, v;
+	if (!rz_il_vm_get_mem(c->vm, index) || !compile_bv(c, key, &k) || !compile_bv(c, value, &v)) {
+		return false;
+	}
+	Insn *insn = emit(c, code);
+	if (!insn) {
+		return false;
+	}
+	insn->a = k.slot;
+	insn->b = v.slot;
+	insn->w = bits_of(v.sort);
+	insn->w2 = bits_of(k.sort);
+	insn->imm = index;
+	return true;
+}
+
+static bool compile_effect(Compiler *c, RzILOpEffect *op) {
+	if (!op) {
+		return false;
+	}
+	Value v;
+	Insn *insn;
+	size_t start, branch, jump;
+	switch (op->code) {
+	case RZ_IL_OP_NOP:
+		return true;
+	case RZ_IL_OP_STORE:
+		return compile_store(c, INSN_STORE, op->op.store.mem, op->op.store.key, op->op.store.value);
+	case RZ_IL_OP_STOREW:
+		return compile_store(c, INSN_STOREW, op->op.storew.mem, op->op.storew.key, op->op.storew.value);
+	case RZ_IL_OP_SET:
+		return compile_set(c, &op->op.set);
+	case RZ_IL_OP_JMP:
+		if (!compile_bv(c, op->op.jmp.dst, &v) || !(insn = emit(c, INSN_JMP))) {
+			return false;
+		}
+		insn->a = v.slot;
+		insn->w = bits_of(v.sort);
+		return true;
+	case RZ_IL_OP_GOTO:
+		if (!op->op.goto_.lbl || !(insn = emit(c, INSN_GOTO))) {
+			return false;
+		}
+		insn->ref = op;
+		return true;
+	case RZ_IL_OP_SEQ:
+		return compile_effect(c, op->op.seq.x) && compile_effect(c, op->op.seq.y);
+	case RZ_IL_OP_BLK:
+		if (op->op.blk.label) {
+			if (!(insn = emit(c, INSN_LABEL))) {
+				return false;
+			}
+			insn->ref = op;
+		}
+		return compile_effect(c, op->op.blk.data_eff) && compile_effect(c, op->op.blk.ctrl_eff);
+	case RZ_IL_OP_REPEAT:
+		start = rz_vector_len(&c->insns);
+		if (!compile_bool(c, op->op.repeat.condition, &v)) {
+			return false;
+		}
+		branch = rz_vector_len(&c->insns);
+		if (!(insn = emit(c, INSN_BRANCH))) {
+			return false;
+		}
+		insn->a = v.slot;
+		if (!compile_effect(c, op->op.repeat.data_eff) || !(insn = emit(c, INSN_JUMP))) {
+			return false;
+		}
+		insn->imm = start;
+		((Insn *)rz_vector_index_ptr(&c->insns, branch))->imm = rz_vector_len(&c->insns);
+		return true;
+	case RZ_IL_OP_BRANCH:
+		if (!compile_bool(c, op->op.branch.condition, &v)) {
+			return false;
+		}
+		branch = rz_vector_len(&c->insns);
+		if (!(insn = emit(c, INSN_BRANCH))) {
+			return false;
+		}
+		insn->a = v.slot;
+		if (!compile_effect(c, op->op.branch.true_eff)) {
+			return false;
+		}
+		jump = rz_vector_len(&c->insns);
+		if (!emit(c, INSN_JUMP)) {
+			return false;
+		}
+		((Insn *)rz_vector_index_ptr(&c->insns, branch))->imm = rz_vector_len(&c->insns);
+		if (!compile_effect(c, op->op.branch.false_eff)) {
+			return false;
+		}
+		((Insn *)rz_vector_index_ptr(&c->insns, jump))->imm = rz_vector_len(&c->insns);
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void global_fini(void *e, void *user) {
+	Global *g = e;
+	free(g->name);
+}
+
+/**
+ * \brief Compile \p op to be run by rz_il_vm_step_code() on \p vm
+ *
+ * The variables and memories are resolved from the ones of \p vm at this time,
+ * the code must not be run on another vm. \p op is borrowed by the code and
+ * must outlive it.
+ *
+ * \return the code, or NULL if \p op has to be run by rz_il_vm_step()
+ */
+RZ_API RZ_OWN RzILCode *rz_il_vm_compile(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpEffect *op) {
+	rz_return_val_if_fail(vm && op, NULL);
+	// the code implements the default handlers only
+	if (memcmp(vm->op_handler_pure_table, rz_il_op_handler_pure_table_default, sizeof(rz_il_op_handler_pure_table_default)) ||
+		memcmp(vm->op_handler_effect_table, rz_il_op_handler_effect_table_default, sizeof(rz_il_op_handler_effect_table_default))) {
+		return NULL;
+	}
+	Compiler c = { .vm = vm };
+	rz_vector_init(&c.insns, sizeof(Insn), NULL, NULL);
+	rz_vector_init(&c.globals, sizeof(Global), global_fini, NULL);
+	rz_vector_init(&c.locals, sizeof(Binding), NULL, NULL);
+	rz_vector_init(&c.lets, sizeof(Binding), NULL, NULL);
+	RzILCode *code = NULL;
+	if (!compile_effect(&c, op)) {
+		goto beach;
+	}
+	code = RZ_NEW0(RzILCode);
+	if (!code) {
+		goto beach;
+	}
+	code->op = op;
+	code->slots = RZ_NEWS0(ut64, RZ_MAX(c.slots, 1));
+	code->count = rz_vector_len(&c.insns);
+	code->insns = rz_vector_flush(&c.insns);
+	code->globals_count = rz_vector_len(&c.globals);
+	code->globals = rz_vector_flush(&c.globals);
+	if (!code->slots || (code->count && !code->insns) || (code->globals_count && !code->globals)) {
+		rz_il_code_free(code);
+		code = NULL;
+	}
+beach:
+	rz_vector_fini(&c.insns);
+	rz_vector_fini(&c.globals);
+	rz_vector_fini(&c.locals);
+	rz_vector_fini(&c.lets);
+	return code;
+}
+
+RZ_API void rz_il_code_free(RZ_NULLABLE RzILCode *code) {
+	if (!code) {
+		return;
+	}
+	for (size_t i = 0; i < code->globals_count; i++) {
+		free(code->globals[i].name);
+	}
+	free(code->globals);
+	free(code->insns);
+	free(code->slots);
+	free(code);
+}
+
+/// Get the current values of the globals used by \p code, false if one is missing or of another sort
+static bool code_bind(RzILVM *vm, RzILCode *code) {
+	for (size_t i = 0; i < code->globals_count; i++) {
+		Global *g = &code->globals[i];
+		g->val = rz_il_vm_get_var_value(vm, RZ_IL_VAR_KIND_GLOBAL, g->name);
+		if (!g->val || !rz_il_sort_pure_eq(rz_il_value_get_sort(g->val), g->sort)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static inline ut64 val_get(const RzILVal *val) {
+	return val->type == RZ_IL_TYPE_PURE_BOOL ? val->data.b->b : rz_bv_to_ut64(val->data.bv);
+}
+
+static void perform_jump(RzILVM *vm, ut32 bits, ut64 dst) {
+	RzBitVector bv;
+	rz_bv_init(&bv, bits);
+	rz_bv_set_from_ut64(&bv, dst);
+	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, &bv));
+	if (rz_bv_len(vm->pc) == bits) {
+		rz_bv_copy(&bv, vm->pc);
+	} else {
+		rz_bv_free(vm->pc);
+		vm->pc = rz_bv_dup(&bv);
+	}
+}
+
+static bool do_set(RzILVM *vm, Global *g, ut64 v) {
+	RzILBool b = { v != 0 };
+	RzBitVector bv;
+	RzILVal val = { g->sort.type, { 0 } };
+	if (is_bool(g->sort)) {
+		val.data.b = &b;
+	} else {
+		rz_bv_init(&bv, g->sort.props.bv.length);
+		rz_bv_set_from_ut64(&bv, v);
+		val.data.bv = &bv;
+	}
+	rz_il_vm_event_add(vm, rz_il_event_var_write_new(g->name, g->val, &val));
+	// the value is owned by the var set and replaced in place, as its sort does not change
+	if (is_bool(g->sort)) {
+		g->val->data.b->b = b.b;
+	} else {
+		rz_bv_copy(&bv, g->val->data.bv);
+	}
+	return true;
+}
+
+static ut64 do_load(RzILVM *vm, const Insn *insn, ut64 key, bool *ok) {
+	RzBitVector k;
+	rz_bv_init(&k, insn->w2);
+	rz_bv_set_from_ut64(&k, key);
+	RzBitVector *v = insn->code == INSN_LOAD
+		? rz_il_vm_mem_load(vm, (RzILMemIndex)insn->imm, &k)
+		: rz_il_vm_mem_loadw(vm, (RzILMemIndex)insn->imm, &k, insn->w);
+	if (!v) {
+		*ok = false;
+		return 0;
+	}
+	ut64 r = rz_bv_to_ut64(v);
+	rz_bv_free(v);
+	return r;
+}
+
+static void do_store(RzILVM *vm, const Insn *insn, ut64 key, ut64 value) {
+	RzBitVector k, v;
+	rz_bv_init(&k, insn->w2);
+	rz_bv_set_from_ut64(&k, key);
+	rz_bv_init(&v, insn->w);
+	rz_bv_set_from_ut64(&v, value);
+	if (insn->code == INSN_STORE) {
+		rz_il_vm_mem_store(vm, (RzILMemIndex)insn->imm, &k, &v);
+	} else {
+		rz_il_vm_mem_storew(vm, (RzILMemIndex)insn->imm, &k, &v);
+	}
+}
+
+static bool do_goto(RzILVM *vm, RzILCode *code, RzILOpEffect *op) {
+	RzILEffectLabel *label = rz_il_vm_find_label_by_name(vm, op->op.goto_.lbl);
+	if (!label) {
+		return false;
+	}
+	if (label->type == EFFECT_LABEL_SYSCALL || label->type == EFFECT_LABEL_HOOK) {
+		RzILVmHook internal_hook = (RzILVmHook)label->hook;
+		internal_hook(vm, op);
+		// the hook may have replaced the values of the vars
+		return code_bind(vm, code);
+	}
+	if (!label->addr) {
+		return false;
+	}
+	RzBitVector *dst = rz_bv_dup(label->addr);
+	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, dst));
+	rz_bv_free(vm->pc);
+	vm->pc = dst;
+	return true;
+}
+
+static inline ut64 udiv(ut64 x, ut64 y, ut64 m) {
+	return y ? x / y : m;
+}
+
+static inline ut64 umod(ut64 x, ut64 y) {
+	return y ? x % y : x;
+}
+
+/// Signed division, as rz_bv_sdiv()
+static ut64 sdiv(ut64 x, ut64 y, ut32 bits, ut64 m) {
+	bool mx = (x >> (bits - 1)) & 1;
+	bool my = (y >> (bits - 1)) & 1;
+	if (!mx && !my) {
+		return udiv(x, y, m);
+	}
+	if (mx && !my) {
+		return -udiv(-x & m, y, m) & m;
+	}
+	if (!mx && my) {
+		return -udiv(x, -y & m, m) & m;
+	}
+	return udiv(-x & m, -y & m, m);
+}
+
+/// Signed modulo, as rz_bv_smod()
+static ut64 smod(ut64 x, ut64 y, ut32 bits, ut64 m) {
+	bool mx = (x >> (bits - 1)) & 1;
+	bool my = (y >> (bits - 1)) & 1;
+	if (!mx && !my) {
+		return umod(x, y);
+	}
+	if (mx && !my) {
+		return -umod(-x & m, y) & m;
+	}
+	if (!mx && my) {
+		return -umod(x, -y & m) & m;
+	}
+	return -umod(-x & m, -y & m) & m;
+}
+
+static inline st64 sign_extend(ut64 x, ut32 bits) {
+	return bits < 64 ? (st64)(x << (64 - bits)) >> (64 - bits) : (st64)x;
+}
+
+static bool code_run(RzILVM *vm, RzILCode *code) {
+	ut64 *s = code->slots;
+	ut64 locals = 0; ///< bit i set when local i is
+	const Insn *insns = code->insns;
+	size_t pc = 0;
+	bool ok = true;
+	while (pc < code->count) {
+		const Insn *insn = &insns[pc++];
+		ut64 m = mask_of(insn->w);
+		ut64 a = s[insn->a];
+		ut64 b = s[insn->b];
+		ut32 shift;
+		switch (insn->code) {
+		case INSN_CONST:
+			s[insn->dst] = insn->imm;
+			break;
+		case INSN_MOV:
+			s[insn->dst] = a;
+			break;
+		case INSN_VAR: {
+			Global *g = &code->globals[insn->imm];
+			rz_il_vm_event_add(vm, rz_il_event_var_read_new(g->name, g->val));
+			s[insn->dst] = val_get(g->val);
+			break;
+		}
+		case INSN_LOCAL:
+			if (!(locals & (1ULL << insn->imm))) {
+				RZ_LOG_ERROR("RzIL: reading value of variable \"%s\" of kind %s failed.\n",
+					(const char *)insn->ref, rz_il_var_kind_name(RZ_IL_VAR_KIND_LOCAL));
+				return false;
+			}
+			s[insn->dst] = a;
+			break;
+		case INSN_SET:
+			do_set(vm, &code->globals[insn->imm], a);
+			break;
+		case INSN_SET_LOCAL:
+			s[insn->dst] = a;
+			locals |= 1ULL << insn->imm;
+			break;
+		case INSN_NEG:
+			s[insn->dst] = -a & m;
+			break;
+		case INSN_NOT:
+			s[insn->dst] = ~a & m;
+			break;
+		case INSN_MSB:
+			s[insn->dst] = (a >> (insn->w - 1)) & 1;
+			break;
+		case INSN_LSB:
+			s[insn->dst] = a & 1;
+			break;
+		case INSN_IS_ZERO:
+			s[insn->dst] = !a;
+			break;
+		case INSN_ADD:
+			s[insn->dst] = (a + b) & m;
+			break;
+		case INSN_SUB:
+			s[insn->dst] = (a - b) & m;
+			break;
+		case INSN_MUL:
+			s[insn->dst] = (a * b) & m;
+			break;
+		case INSN_DIV:
+			if (!b) {
+				rz_il_vm_event_add(vm, rz_il_event_exception_new("division by zero"));
+			}
+			s[insn->dst] = udiv(a, b, m);
+			break;
+		case INSN_SDIV:
+			s[insn->dst] = sdiv(a, b, insn->w, m);
+			break;
+		case INSN_MOD:
+			s[insn->dst] = umod(a, b);
+			break;
+		case INSN_SMOD:
+			s[insn->dst] = smod(a, b, insn->w, m);
+			break;
+		case INSN_AND:
+			s[insn->dst] = a & b;
+			break;
+		case INSN_OR:
+			s[insn->dst] = a | b;
+			break;
+		case INSN_XOR:
+			s[insn->dst] = a ^ b;
+			break;
+		case INSN_SHIFTL:
+			shift = (ut32)b;
+			if (shift >= insn->w) {
+				s[insn->dst] = s[insn->c] ? m : 0;
+			} else {
+				s[insn->dst] = ((a << shift) | (s[insn->c] ? mask_of(shift) : 0)) & m;
+			}
+			break;
+		case INSN_SHIFTR:
+			shift = (ut32)b;
+			if (shift >= insn->w) {
+				s[insn->dst] = s[insn->c] ? m : 0;
+			} else {
+				s[insn->dst] = (a >> shift) | (s[insn->c] ? m & ~(m >> shift) : 0);
+			}
+			break;
+		case INSN_EQ:
+			s[insn->dst] = a == b;
+			break;
+		case INSN_SLE:
+			s[insn->dst] = sign_extend(a, insn->w) <= sign_extend(b, insn->w);
+			break;
+		case INSN_ULE:
+			s[insn->dst] = a <= b;
+			break;
+		case INSN_CAST: {
+			ut64 keep = mask_of(RZ_MIN(insn->w, insn->w2));
+			s[insn->dst] = (a & keep) | (b ? m & ~keep : 0);
+			break;
+		}
+		case INSN_APPEND:
+			s[insn->dst] = (a << insn->w2) | b;
+			break;
+		case INSN_LOAD:
+		case INSN_LOADW:
+			s[insn->dst] = do_load(vm, insn, a, &ok);
+			if (!ok) {
+				return false;
+			}
+			break;
+		case INSN_STORE:
+		case INSN_STOREW:
+			do_store(vm, insn, a, b);
+			break;
+		case INSN_JMP:
+			perform_jump(vm, insn->w, a);
+			break;
+		case INSN_GOTO:
+			if (!do_goto(vm, code, (RzILOpEffect *)insn->ref)) {
+				return false;
+			}
+			break;
+		case INSN_LABEL:
+			rz_il_vm_create_label(vm, ((const RzILOpEffect *)insn->ref)->op.blk.label, vm->pc);
+			break;
+		case INSN_BRANCH:
+			if (!a) {
+				pc = insn->imm;
+			}
+			break;
+		case INSN_JUMP:
+			pc = insn->imm;
+			break;
+		default:
+			rz_warn_if_reached();
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Same as rz_il_vm_step() for the op compiled into \p code
+ *
+ * \p code must have been compiled by rz_il_vm_compile() for \p vm. If the
+ * variables it uses changed in the meantime, the op is run by rz_il_vm_step().
+ */
+RZ_API bool rz_il_vm_step_code(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILCode *code, ut64 fallthrough_addr) {
+	rz_return_val_if_fail(vm && code, false);
+	if (!code_bind(vm, code)) {
+		return rz_il_vm_step(vm, code->op, fallthrough_addr);
+	}
+
+	rz_il_vm_clear_events(vm);
+
+	// Set the successor pc **before** evaluating. Any jmp/goto may then overwrite it again.
+	RzBitVector *next_pc = rz_bv_new_from_ut64(vm->pc->len, fallthrough_addr);
+	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, next_pc));
+	rz_bv_free(vm->pc);
+	vm->pc = next_pc;
+
+	// locals only live in the slots of the code, vm->local_vars is untouched
+	return code_run(vm, code);
+}
@@ -40,6 +40,20 @@ typedef struct rz_core_graph_hits_t {
 #define RZ_AGRAPH_MODE_COMMENTS 5
 #define RZ_AGRAPH_MODE_MAX      6
 
+/**
+ * \brief Algorithms ordering the nodes of each layer to reduce the crossing edges
+ */
+typedef enum {
+	RZ_AGRAPH_CROSSING_AUTO = 0, ///< sweep for small graphs, barycenter for the others
+	RZ_AGRAPH_CROSSING_SWEEP, ///< swaps adjacent nodes after counting the crossings of each pair
+	RZ_AGRAPH_CROSSING_BARYCENTER, ///< sorts the nodes by the mean position of their neighbours
+} RzAGraphCrossing;
+
+/**
+ * Orders of the layers computed by the previous layouts, by graph
+ */
+typedef struct rz_agraph_layout_cache_t RzAGraphLayoutCache;
+
 typedef void (*RzANodeCallback)(RzANode *n, void *user);
 typedef void (*RAEdgeCallback)(RzANode *from, RzANode *to, void *user);
 
@@ -53,6 +67,8 @@ typedef struct rz_ascii_graph_t {
 	RzList *dummy_nodes;
 
 	int layout;
+	RzAGraphCrossing crossing;
+	RzAGraphLayoutCache *layout_cache; ///< orders of the previous layouts to start from, not owned
 	int is_instep;
 	bool is_tiny;
 	bool is_dis;
@@ -109,6 +125,8 @@ RZ_API Sdb *rz_agraph_get_sdb(RzAGraph *g);
 RZ_API void rz_agraph_foreach(RzAGraph *g, RzANodeCallback cb, void *user);
 RZ_API void rz_agraph_foreach_edge(RzAGraph *g, RAEdgeCallback cb, void *user);
 RZ_API void rz_agraph_set_curnode(RzAGraph *g, RzANode *node);
+RZ_API RzAGraphLayoutCache *rz_agraph_layout_cache_new(void);
+RZ_API void rz_agraph_layout_cache_free(RzAGraphLayoutCache *cache);
 RZ_API RzAGraph *create_agraph_from_graph(const RzGraph /*<RzGraphNodeInfo>*/ *graph);
 #endif
 
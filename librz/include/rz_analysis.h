@@ -201,7 +201,8 @@ enum {
 	RZ_ANALYSIS_FCN_TYPE_ANY = -1 /* all the bits set */
 };
 
-#define RZ_ANALYSIS_DIFF_THRESHOLD (0.5)
+#define RZ_ANALYSIS_DIFF_THRESHOLD  (0.5)
+#define RZ_ANALYSIS_DIFF_CANDIDATES 8
 
 #define RzAnalysisBlock struct rz_analysis_bb_t
 
@@ -219,6 +220,17 @@ typedef struct rz_analysis_diff_t {
 	ut32 size;
 } RzAnalysisDiff;
 
+/**
+ * \brief Counts of the pairs of functions made while diffing, by the way they were paired
+ */
+typedef struct rz_analysis_diff_stats_t {
+	size_t by_name; ///< pairs of functions with the same name
+	size_t exact; ///< pairs of functions with identical fingerprints
+	size_t similar; ///< pairs of the most similar functions among the remaining ones
+	ut64 compared; ///< count of fingerprints compared
+	ut64 usecs; ///< time spent pairing
+} RzAnalysisDiffStats;
+
 typedef struct rz_analysis_attr_t RzAnalysisAttr;
 
 struct rz_analysis_attr_t {
@@ -538,6 +550,7 @@ typedef struct rz_analysis_options_t {
 	bool delay;
 	int tailcall;
 	bool retpoline;
+	bool il_compile; // rzil.compile, compile the IL of the instructions stepped by the user-faced vm
 } RzAnalysisOptions;
 
 typedef enum {
@@ -552,6 +565,9 @@ typedef struct rz_analysis_hint_cb_t {
 
 typedef struct rz_analysis_il_vm_t RzAnalysisILVM;
 
+typedef struct rz_analysis_decoders_t RzAnalysisDecoders;
+typedef struct rz_analysis_op_cache_t RzAnalysisOpCache;
+
 typedef struct rz_analysis_t {
 	char *cpu; // analysis.cpu
 	char *os; // asm.os
@@ -561,6 +577,8 @@ typedef struct rz_analysis_t {
 	int sleep; // analysis.sleep, sleep some usecs before analyzing more (avoid 100% cpu usages)
 	RzAnalysisCPPABI cpp_abi; // analysis.cpp.abi
 	void *plugin_data;
+	RzAnalysisDecoders *decoders; ///< per-thread decoding contexts of the current plugin, see rz_analysis_decoder()
+	RzAnalysisOpCache *op_cache; ///< ops decoded by rz_analysis_op(), NULL when disabled
 	void *core;
 	ut64 gp; // analysis.gp, global pointer. used for mips. but can be used by other arches too in the future
 	RBTree bb_tree; // all basic blocks by address. They can overlap each other, but must never start at the same address.
@@ -573,6 +591,8 @@ typedef struct rz_analysis_t {
 	int diff_ops;
 	double diff_thbb;
 	double diff_thfcn;
+	int diff_candidates; ///< max count of candidates to compare each function with, 0 to compare with all
+	int diff_threads; ///< threads comparing the candidates, 0 for all the cores
 	RzIOBind iob;
 	RzFlagBind flb;
 	RzFlagSet flg_class_set;
@@ -1014,19 +1034,6 @@ typedef struct rz_analysis_esil_change_mem_t {
 	ut8 data;
 } RzAnalysisEsilMemChange;
 
-typedef struct rz_analysis_esil_trace_t {
-	int idx;
-	int end_idx;
-	HtUP *registers;
-	HtUP *memory;
-	RzRegArena *arena[RZ_REG_TYPE_LAST];
-	ut64 stack_addr;
-	ut64 stack_size;
-	ut8 *stack_data;
-	// RzVector<RzILTraceInstruction>
-	RzPVector *instructions;
-} RzAnalysisEsilTrace;
-
 typedef int (*RzAnalysisEsilHookRegWriteCB)(ANALYSIS_ESIL *esil, const char *name, ut64 *val);
 
 typedef struct rz_analysis_esil_callbacks_t {
@@ -1044,6 +1051,21 @@ typedef struct rz_analysis_esil_callbacks_t {
 	int (*reg_write)(ANALYSIS_ESIL *esil, const char *name, ut64 val);
 } RzAnalysisEsilCallbacks;
 
+typedef struct rz_analysis_esil_trace_t {
+	int idx;
+	int end_idx;
+	HtUP *registers;
+	HtUP *memory;
+	RzRegArena *arena[RZ_REG_TYPE_LAST];
+	ut64 stack_addr;
+	ut64 stack_size;
+	ut8 *stack_data;
+	// RzVector<RzILTraceInstruction>
+	RzPVector *instructions;
+	RzAnalysisEsilCallbacks ocbs; ///< callbacks of the esil, saved while an op is traced
+	bool ocbs_set;
+} RzAnalysisEsilTrace;
+
 typedef struct rz_analysis_esil_t {
 	RzAnalysis *analysis;
 	char **stack;
@@ -1074,12 +1096,15 @@ typedef struct rz_analysis_esil_t {
 	ut8 lastsz; // in bits //used for signature-flag
 	/* native ops and custom ops */
 	HtPP *ops;
+	HtUP /*<RzAnalysisEsilCode *>*/ *bytecode; ///< compiled expressions by address, NULL when disabled
 	RzStrBuf current_opstr;
 	RzIDStorage *sources;
 	HtUP *interrupts;
 	/* deep esil parsing fills this */
 	Sdb *stats;
 	RzAnalysisEsilTrace *trace;
+	RzTraceStore *trace_store; ///< store of the op being traced by rz_analysis_esil_trace_op_store()
+	RzAnalysisEsilCallbacks trace_store_ocbs; ///< callbacks of the esil, saved while an op is traced to trace_store
 	RzAnalysisEsilCallbacks cb;
 	// this is so cursed, can we please remove external commands from esil internals.
 	// Function pointers are fine, but not commands
@@ -1161,6 +1186,7 @@ struct rz_analysis_il_vm_t {
 	RZ_NONNULL RzILVM *vm; ///< low-level vm to execute IL code
 	RZ_NONNULL RzBuffer *io_buf; ///< buffer to use for memory 0 (io)
 	RZ_NONNULL RzILRegBinding *reg_binding; ///< specifies which (global) variables are bound to registers
+	RZ_NULLABLE HtUP *code_cache; ///< IL of the instructions stepped by address, compiled when possible, NULL when disabled
 } /* RzAnalysisILVM */;
 
 typedef enum {
@@ -1191,6 +1217,8 @@ enum {
 
 typedef bool (*RzAnalysisEsilOpCb)(RzAnalysisEsil *esil);
 
+typedef struct rz_analysis_esil_code_t RzAnalysisEsilCode;
+
 typedef struct rz_analysis_esil_operation_t {
 	RzAnalysisEsilOpCb code;
 	ut32 push; // amount of operands pushed
@@ -1244,9 +1272,12 @@ typedef struct rz_analysis_plugin_t {
 	const char *version;
 	int bits;
 	int esil; // can do esil or not
+	bool op_stateless; ///< op() only reads the RzAnalysis it gets and keeps no state between instructions
 	int fileformat_type;
 	bool (*init)(void **user);
 	bool (*fini)(void *user);
+	void *(*decoder_new)(RzAnalysis *analysis); ///< create the context op() decodes with in one thread, see rz_analysis_decoder()
+	void (*decoder_free)(void *decoder);
 	// int (*reset_counter) (RzAnalysis *analysis, ut64 start_addr);
 	int (*archinfo)(RzAnalysis *analysis, int query);
 	ut8 *(*analysis_mask)(RzAnalysis *analysis, int size, const ut8 *data, ut64 at);
@@ -1476,6 +1507,8 @@ RZ_API RZ_OWN char *rz_analysis_function_name_guess(RzTypeDB *typedb, RZ_NONNULL
 
 /* analysis.c */
 RZ_API RzAnalysis *rz_analysis_new(void);
+RZ_API RZ_OWN RzAnalysis *rz_analysis_new_decoder(RZ_NONNULL RzAnalysis *a);
+RZ_API RZ_BORROW void *rz_analysis_decoder(RZ_NONNULL RzAnalysis *analysis);
 RZ_API void rz_analysis_purge(RzAnalysis *analysis);
 RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *r);
 RZ_API int rz_analysis_add(RzAnalysis *analysis, RzAnalysisPlugin *foo);
@@ -1510,6 +1543,11 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 RZ_API RzAnalysisOp *rz_analysis_op_hexstr(RzAnalysis *analysis, ut64 addr, const char *hexstr);
 RZ_API char *rz_analysis_op_to_string(RzAnalysis *analysis, RzAnalysisOp *op);
 
+/* op_cache.c */
+RZ_API bool rz_analysis_op_cache_set_size(RZ_NONNULL RzAnalysis *analysis, size_t size);
+RZ_API void rz_analysis_op_cache_invalidate(RZ_NONNULL RzAnalysis *analysis, ut64 addr, ut64 size);
+RZ_API void rz_analysis_op_cache_clear(RZ_NONNULL RzAnalysis *analysis);
+
 RZ_API RzAnalysisEsil *rz_analysis_esil_new(int stacksize, int iotrap, unsigned int addrsize);
 RZ_API bool rz_analysis_esil_set_pc(RzAnalysisEsil *esil, ut64 addr);
 RZ_API bool rz_analysis_esil_setup(RzAnalysisEsil *esil, RzAnalysis *analysis, int romem, int stats, int nonull);
@@ -1530,6 +1568,14 @@ RZ_API int rz_analysis_esil_get_parm_type(RzAnalysisEsil *esil, const char *str)
 RZ_API int rz_analysis_esil_get_parm(RzAnalysisEsil *esil, const char *str, ut64 *num);
 RZ_API int rz_analysis_esil_condition(RzAnalysisEsil *esil, const char *str);
 
+// esil_bytecode.c
+RZ_API RZ_OWN RzAnalysisEsilCode *rz_analysis_esil_compile(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL const char *str);
+RZ_API void rz_analysis_esil_code_free(RZ_NULLABLE RzAnalysisEsilCode *code);
+RZ_API bool rz_analysis_esil_run(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL const RzAnalysisEsilCode *code);
+RZ_API void rz_analysis_esil_bytecode_enable(RZ_NONNULL RzAnalysisEsil *esil, bool enable);
+RZ_API void rz_analysis_esil_bytecode_clear(RZ_NONNULL RzAnalysisEsil *esil);
+RZ_API bool rz_analysis_esil_parse_at(RZ_NONNULL RzAnalysisEsil *esil, ut64 addr, RZ_NONNULL const char *str);
+
 // esil_interrupt.c
 RZ_API void rz_analysis_esil_interrupts_init(RzAnalysisEsil *esil);
 RZ_API RzAnalysisEsilInterrupt *rz_analysis_esil_interrupt_new(RzAnalysisEsil *esil, ut32 src_id, RzAnalysisEsilInterruptHandler *ih);
@@ -1595,6 +1641,7 @@ RZ_API RZ_BORROW RzILTraceInstruction *rz_analysis_esil_get_instruction_trace(RZ
 RZ_API RzAnalysisEsilTrace *rz_analysis_esil_trace_new(RzAnalysisEsil *esil);
 RZ_API void rz_analysis_esil_trace_free(RzAnalysisEsilTrace *trace);
 RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysisOp *op);
+RZ_API void rz_analysis_esil_trace_op_store(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL RzAnalysisOp *op, RZ_NONNULL RzTraceStore *store);
 RZ_API void rz_analysis_esil_trace_list(RzAnalysisEsil *esil);
 RZ_API void rz_analysis_esil_trace_show(RzAnalysisEsil *esil, int idx);
 RZ_API void rz_analysis_esil_trace_restore(RzAnalysisEsil *esil, int idx);
@@ -1613,6 +1660,8 @@ RZ_API void rz_analysis_il_vm_free(RZ_NULLABLE RzAnalysisILVM *vm);
 RZ_API void rz_analysis_il_vm_sync_from_reg(RzAnalysisILVM *vm, RZ_NONNULL RzReg *reg);
 RZ_API bool rz_analysis_il_vm_sync_to_reg(RzAnalysisILVM *vm, RZ_NONNULL RzReg *reg);
 RZ_API RzAnalysisILStepResult rz_analysis_il_vm_step(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisILVM *vm, RZ_NULLABLE RzReg *reg);
+RZ_API void rz_analysis_il_vm_code_cache_enable(RZ_NONNULL RzAnalysisILVM *vm, bool enable);
+RZ_API void rz_analysis_il_vm_code_cache_invalidate(RZ_NONNULL RzAnalysisILVM *vm, ut64 addr, ut64 size);
 RZ_API bool rz_analysis_il_vm_setup(RzAnalysis *analysis);
 RZ_API void rz_analysis_il_vm_cleanup(RzAnalysis *analysis);
 
@@ -1788,6 +1837,8 @@ RZ_API int rz_analysis_diff_fingerprint_bb(RzAnalysis *analysis, RzAnalysisBlock
 RZ_API size_t rz_analysis_diff_fingerprint_fcn(RzAnalysis *analysis, RzAnalysisFunction *fcn);
 RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2);
 RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns, RzList *fcns2);
+RZ_API bool rz_analysis_diff_functions(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzList /*<RzAnalysisFunction *>*/ *fcns1,
+	RZ_NONNULL RzList /*<RzAnalysisFunction *>*/ *fcns2, RZ_NULLABLE RZ_OUT RzAnalysisDiffStats *stats);
 RZ_API int rz_analysis_diff_eval(RzAnalysis *analysis);
 
 /* value.c */
@@ -2241,6 +2292,7 @@ RZ_API void rz_serialize_analysis_cc_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnaly
 RZ_API bool rz_serialize_analysis_cc_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 
 RZ_API void rz_serialize_analysis_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
+RZ_API void rz_serialize_analysis_save_opt(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, bool xrefs);
 RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 
 /* plugin pointers */
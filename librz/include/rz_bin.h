@@ -140,6 +140,22 @@ typedef enum {
 	RZ_BIN_SPECIAL_SYMBOL_LAST
 } RzBinSpecialSymbol;
 
+/**
+ * \brief Items of a RzBinObject loaded on their first access
+ */
+typedef enum {
+	RZ_BIN_OBJECT_ITEM_FIELDS,
+	RZ_BIN_OBJECT_ITEM_IMPORTS,
+	RZ_BIN_OBJECT_ITEM_SYMBOLS,
+	RZ_BIN_OBJECT_ITEM_RELOCS,
+	RZ_BIN_OBJECT_ITEM_STRINGS,
+	RZ_BIN_OBJECT_ITEM_LANGUAGE, ///< also the compiler in RzBinInfo
+	RZ_BIN_OBJECT_ITEM_CLASSES,
+	RZ_BIN_OBJECT_ITEM_MEM,
+	RZ_BIN_OBJECT_ITEM_RESOURCES,
+	RZ_BIN_OBJECT_ITEM_LAST
+} RzBinObjectItem;
+
 // name mangling types
 typedef enum {
 	RZ_BIN_LANGUAGE_UNKNOWN = 0,
@@ -306,6 +322,9 @@ typedef struct rz_bin_object_t {
 	RZ_DEPRECATE RZ_BORROW Sdb *kv; ///< deprecated, put info in C structures instead of this (holds a copy of another pointer.)
 	HtUP *addrzklassmethod;
 	void *bin_obj; // internal pointer used by formats
+	RzBinFile *bf; ///< file the items are loaded from
+	ut32 items_loaded; ///< bit mask of the RzBinObjectItem loaded
+	ut64 items_time[RZ_BIN_OBJECT_ITEM_LAST]; ///< microseconds spent loading each item
 } RzBinObject;
 
 // XXX: RbinFile may hold more than one RzBinObject
@@ -351,6 +370,7 @@ struct rz_bin_t {
 	int minstrlen;
 	int maxstrlen; //< <= 0 means no limit
 	ut64 maxstrbuf;
+	size_t str_search_threads; ///< threads looking for strings in large ranges, 0 uses all the cores
 	int rawstr;
 	RZ_DEPRECATE Sdb *sdb;
 	RzIDStorage *ids;
@@ -1010,6 +1030,10 @@ RZ_API void rz_bin_file_hash_free(RzBinFileHash *fhash);
 
 // binobject functions
 RZ_API int rz_bin_object_set_items(RzBinFile *binfile, RzBinObject *o);
+RZ_API void rz_bin_object_load_item(RZ_NONNULL RzBinObject *o, RzBinObjectItem item);
+RZ_API const char *rz_bin_object_item_name(RzBinObjectItem item);
+RZ_API ut64 rz_bin_object_get_item_load_time(RZ_NONNULL RzBinObject *o, RzBinObjectItem item);
+RZ_API RzBinLanguage rz_bin_object_get_language(RZ_NONNULL RzBinObject *o);
 RZ_API ut64 rz_bin_object_addr_with_base(RzBinObject *o, ut64 addr);
 RZ_API ut64 rz_bin_object_get_vaddr(RzBinObject *o, ut64 paddr, ut64 vaddr);
 RZ_API const RzBinAddr *rz_bin_object_get_special_symbol(RzBinObject *o, RzBinSpecialSymbol sym);
@@ -62,6 +62,16 @@ typedef struct rz_bp_item_t {
 	char *expr; /* to be used for named breakpoints (see rz_debug_bp_update) */
 } RzBreakpointItem;
 
+/**
+ * \brief Basic block hit by a one-shot coverage breakpoint
+ */
+typedef struct rz_bp_coverage_hit_t {
+	ut64 addr;
+	ut32 size; ///< size of the basic block
+} RzBreakpointCoverageHit;
+
+typedef struct rz_bp_coverage_t RzBreakpointCoverage;
+
 struct rz_bp_t;
 typedef int (*RzBreakpointCallback)(struct rz_bp_t *bp, RzBreakpointItem *b, bool set);
 
@@ -92,9 +102,12 @@ typedef struct rz_bp_t {
 	int nbps;
 	int nhwbps;
 	RzList *bps; // list of breakpoints
+	RzIntervalTree bps_tree; ///< entries of bps by their [addr, addr + size) range
 	RzBreakpointItem **bps_idx;
 	int bps_idx_count;
+	int bps_idx_free; ///< lowest slot of bps_idx that may be free
 	ut64 baddr;
+	RzBreakpointCoverage *coverage; ///< one-shot coverage breakpoints, kept out of bps
 } RzBreakpoint;
 
 typedef struct rz_bp_trace_t {
@@ -144,6 +157,7 @@ RZ_API bool rz_bp_item_set_cond(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE c
 RZ_API bool rz_bp_item_set_data(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE const char *data);
 RZ_API bool rz_bp_item_set_expr(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE const char *expr);
 RZ_API bool rz_bp_item_set_name(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE const char *name);
+RZ_API bool rz_bp_item_set_addr(RZ_NONNULL RzBreakpoint *bp, RZ_NONNULL RzBreakpointItem *item, ut64 addr);
 
 RZ_API int rz_bp_add_cond(RzBreakpoint *bp, const char *cond);
 RZ_API int rz_bp_del_cond(RzBreakpoint *bp, int idx);
@@ -167,6 +181,17 @@ RZ_API int rz_bp_traptrace_at(RzBreakpoint *bp, ut64 from, int len);
 RZ_API RzList *rz_bp_traptrace_new(void);
 RZ_API void rz_bp_traptrace_enable(RzBreakpoint *bp, int enable);
 
+/* coverage */
+RZ_API bool rz_bp_coverage_add(RZ_NONNULL RzBreakpoint *bp, ut64 addr, ut32 size);
+RZ_API size_t rz_bp_coverage_install(RZ_NONNULL RzBreakpoint *bp);
+RZ_API size_t rz_bp_coverage_uninstall(RZ_NONNULL RzBreakpoint *bp);
+RZ_API void rz_bp_coverage_reset(RZ_NONNULL RzBreakpoint *bp);
+RZ_API bool rz_bp_coverage_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr);
+RZ_API bool rz_bp_coverage_ending_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr, RZ_NULLABLE RZ_OUT ut64 *start);
+RZ_API bool rz_bp_coverage_hit(RZ_NONNULL RzBreakpoint *bp, ut64 addr);
+RZ_API size_t rz_bp_coverage_pending(RZ_NONNULL RzBreakpoint *bp);
+RZ_API RZ_BORROW const RzVector /*<RzBreakpointCoverageHit>*/ *rz_bp_coverage_hits(RZ_NONNULL RzBreakpoint *bp);
+
 /* watchpoint */
 RZ_API RZ_BORROW RzBreakpointItem *rz_bp_watch_add(RZ_NONNULL RzBreakpoint *bp, ut64 addr, int size, int hw, int perm);
 
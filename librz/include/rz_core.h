@@ -131,6 +131,9 @@ typedef struct rz_core_plugin_t {
 } RzCorePlugin;
 
 typedef struct rz_core_rtr_host_t RzCoreRtrHost;
+typedef struct rz_core_rop_index_t RzCoreRopIndex;
+typedef struct rz_core_cmd_parser_t RzCoreCmdParser;
+typedef struct rz_core_prepared_cmd_t RzCorePreparedCmd;
 
 typedef enum {
 	AUTOCOMPLETE_DEFAULT,
@@ -318,6 +321,7 @@ struct rz_core_t {
 	ut64 rc; // command's return code .. related to num->value;
 	RzLib *lib;
 	RzCmd *rcmd;
+	RzCoreCmdParser *cmd_parser; ///< parser and recently parsed trees of the commands, see cmd.c
 	RzCmdDescriptor root_cmd_descriptor;
 	RzList /*<RzCmdDescriptor>*/ *cmd_descriptors;
 	RzAnalysis *analysis;
@@ -332,6 +336,7 @@ struct rz_core_t {
 	RzSearch *search;
 	RzEgg *egg;
 	RzAGraph *graph;
+	RzAGraphLayoutCache *graph_layouts; ///< orders of the layers of the graphs laid out so far
 	RzPanelsRoot *panels_root;
 	RzPanels *panels;
 	char *cmdqueue;
@@ -384,6 +389,7 @@ struct rz_core_t {
 	bool scr_gadgets;
 	bool log_events; // core.c:cb_event_handler : log actions from events if cfg.log.events is set
 	RzList *ropchain;
+	RzCoreRopIndex *rop_index; ///< gadgets found by /R, see cmd_search_rop.c
 	RzCoreSeekHistory seek_history;
 
 	bool marks_init;
@@ -692,6 +698,10 @@ RZ_API int rz_core_cmdf(RzCore *core, const char *fmt, ...) RZ_PRINTF_CHECK(2, 3
 RZ_API int rz_core_cmd0(RzCore *core, const char *cmd);
 RZ_API RzCmdStatus rz_core_cmd0_rzshell(RzCore *core, const char *cmd);
 RZ_API char *rz_core_cmd_str(RzCore *core, const char *cmd);
+RZ_API RZ_OWN RzCorePreparedCmd *rz_core_cmd_prepare(RZ_NONNULL RzCore *core, RZ_NONNULL const char *name);
+RZ_API void rz_core_prepared_cmd_free(RZ_NULLABLE RzCorePreparedCmd *pcmd);
+RZ_API RzCmdStatus rz_core_prepared_cmd_call(RZ_NONNULL RzCore *core, RZ_NONNULL RzCorePreparedCmd *pcmd, int argc, RZ_NULLABLE const char **argv);
+RZ_API RZ_OWN char *rz_core_prepared_cmd_str(RZ_NONNULL RzCore *core, RZ_NONNULL RzCorePreparedCmd *pcmd, int argc, RZ_NULLABLE const char **argv);
 RZ_API int rz_core_cmd_foreach(RzCore *core, const char *cmd, char *each);
 RZ_API int rz_core_cmd_foreach3(RzCore *core, const char *cmd, char *each);
 RZ_API char *rz_core_op_str(RzCore *core, ut64 addr);
@@ -1209,6 +1219,7 @@ RZ_API void rz_core_annotated_code_print_comment_cmds(RzAnnotatedCode *code);
  * @param prj_file filename of the project that db will be saved to later. This is only used to re-locate the loaded RIO descs, the project file itself is not touched by this function.
  */
 RZ_API void rz_serialize_core_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, RZ_NULLABLE const char *prj_file);
+RZ_API void rz_serialize_core_save_opt(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, RZ_NULLABLE const char *prj_file, bool xrefs);
 
 /**
  * @param load_bin_io whether to also load the underlying RIO and RBin state from the project. If false, the current state will be kept and the project loaded on top.
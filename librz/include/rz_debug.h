@@ -113,6 +113,7 @@ typedef enum {
 	RZ_DEBUG_REASON_INT,
 	RZ_DEBUG_REASON_FPU,
 	RZ_DEBUG_REASON_USERSUSP,
+	RZ_DEBUG_REASON_COVERAGE, ///< a one-shot coverage breakpoint was hit and removed
 } RzDebugReasonType;
 
 /* TODO: move to rz_analysis */
@@ -159,15 +160,31 @@ typedef struct rz_debug_desc_t {
 	ut64 off;
 } RzDebugDesc;
 
+/**
+ * \brief Page of the memory held by the snaps of the checkpoints
+ *
+ * Pages with the same bytes are shared by the snaps through their reference
+ * count, so that a checkpoint only adds the pages changed since the others.
+ */
+typedef struct rz_debug_snap_page_t {
+	ut32 refs;
+	ut32 size;
+	ut32 hash; ///< rz_hash_xxhash() of data
+	HtUP /*<ut64, RzDebugSnapPage *>*/ *store; ///< table interning the page by hash, NULL if not interned
+	ut8 data[];
+} RzDebugSnapPage;
+
 typedef struct rz_debug_snap_t {
 	char *name;
 	ut64 addr;
 	ut64 addr_end;
 	ut32 size;
-	ut8 *data;
+	ut8 *data; ///< bytes of the snap, NULL if held by pages
 	int perm;
 	int user;
 	bool shared;
+	RzDebugSnapPage **pages; ///< bytes of the snap split in pages of page_size bytes, if data is NULL
+	ut32 page_size;
 } RzDebugSnap;
 
 typedef struct {
@@ -175,9 +192,14 @@ typedef struct {
 	ut64 data;
 } RzDebugChangeReg;
 
+/**
+ * \brief Bytes written to the memory at a step of the session
+ */
 typedef struct {
 	int cnum;
-	ut8 data;
+	ut64 addr;
+	ut32 size;
+	ut8 *data; ///< size bytes written at addr
 } RzDebugChangeMem;
 
 typedef struct rz_debug_checkpoint_t {
@@ -191,10 +213,14 @@ typedef struct rz_debug_session_t {
 	ut32 maxcnum;
 	RzDebugCheckpoint *cur_chkpt;
 	RzVector *checkpoints; /* RzVector<RzDebugCheckpoint> */
-	HtUP *memory; /* RzVector<RzDebugChangeMem> */
+	RzVector *memory; /* RzVector<RzDebugChangeMem>, sorted by cnum */
 	HtUP *registers; /* RzVector<RzDebugChangeReg> */
 	int reasontype /*RzDebugReasonType*/;
 	RzBreakpointItem *bp;
+	HtUP /*<ut64, RzDebugSnapPage *>*/ *pages; ///< pages of the checkpoints by hash, for sharing them
+	int dirty_pid; ///< process whose soft-dirty bits were cleared when taking the checkpoint dirty_chkpt, 0 if none
+	size_t dirty_chkpt; ///< index of the checkpoint whose memory is held by the pages not soft-dirty
+	bool dirty_unsupported; ///< soft-dirty bits are not tracked by the kernel
 } RzDebugSession;
 
 /* Session file format */
@@ -225,7 +251,9 @@ typedef struct rz_debug_trace_t {
 	int dup;
 	char *addresses;
 	// TODO: add range here
-	HtPP *ht;
+	HtUP /*<int, HtUP<ut64, RzDebugTracepoint *> *>*/ *ht; ///< last tracepoint by tag, then by address
+	RzTraceStore *store; ///< executed instructions and their writes, when dbg.trace.compact is set
+	RzTraceStore *baseline; ///< store kept by rz_debug_trace_compact_baseline(), to compare the next one with
 } RzDebugTrace;
 
 typedef struct rz_debug_tracepoint_t {
@@ -306,6 +334,8 @@ typedef struct rz_debug_t {
 	RzList *maps_user; // <RzDebugMap>
 
 	bool trace_continue;
+	bool trace_compact; ///< dbg.trace.compact, recording the steps to trace->store
+	char *trace_spill; ///< dbg.trace.spill, file to write the full chunks of trace->store to
 	RzAnalysisOp *cur_op;
 	RzDebugSession *session;
 
@@ -527,6 +557,9 @@ RZ_API ut64 rz_debug_reg_get(RzDebug *dbg, const char *name);
 RZ_API ut64 rz_debug_execute(RzDebug *dbg, const ut8 *buf, int len, int restore);
 RZ_API bool rz_debug_map_sync(RzDebug *dbg);
 
+/* coverage */
+RZ_API bool rz_debug_coverage_drcov(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzBuffer *out);
+
 RZ_API int rz_debug_stop(RzDebug *dbg);
 
 /* backtrace */
@@ -557,6 +590,9 @@ RZ_API RzDebugTracepoint *rz_debug_trace_add(RzDebug *dbg, ut64 addr, int size);
 RZ_API RzDebugTrace *rz_debug_trace_new(void);
 RZ_API void rz_debug_trace_free(RzDebugTrace *dbg);
 RZ_API int rz_debug_trace_tag(RzDebug *dbg, int tag);
+RZ_API bool rz_debug_trace_compact_baseline(RZ_NONNULL RzDebug *dbg);
+RZ_API void rz_debug_trace_compact_print(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzCmdStateOutput *state);
+RZ_API bool rz_debug_trace_compact_diff_print(RZ_NONNULL RzDebug *dbg);
 RZ_API int rz_debug_child_fork(RzDebug *dbg);
 RZ_API int rz_debug_child_clone(RzDebug *dbg);
 
@@ -580,6 +616,7 @@ RZ_API void rz_debug_esil_prestep(RzDebug *d, int p);
 RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg);
 RZ_API bool rz_debug_session_add_reg_change(RzDebugSession *session, int arena, ut64 offset, ut64 data);
 RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data);
+RZ_API bool rz_debug_session_add_mem_range(RzDebugSession *session, ut64 addr, const ut8 *data, ut32 size);
 RZ_API void rz_debug_session_restore_reg_mem(RzDebug *dbg, ut32 cnum);
 RZ_API void rz_debug_session_list_memory(RzDebug *dbg);
 RZ_API void rz_debug_session_serialize(RzDebugSession *session, Sdb *db);
@@ -593,6 +630,10 @@ RZ_API RzDebugSession *rz_debug_session_new(void);
 RZ_API void rz_debug_session_free(RzDebugSession *session);
 
 RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map);
+RZ_API RzDebugSnap *rz_debug_snap_map_pages(RzDebug *dbg, RzDebugMap *map, ut32 page_size, RZ_NULLABLE HtUP *store, RZ_NULLABLE RzDebugSnap *base, RZ_NULLABLE const ut8 *dirty);
+RZ_API ut8 *rz_debug_snap_data(RZ_NONNULL RzDebugSnap *snap);
+RZ_API RzDebugSnapPage *rz_debug_snap_page_new(RZ_NULLABLE HtUP *store, RZ_NONNULL const ut8 *buf, ut32 size);
+RZ_API void rz_debug_snap_page_unref(RzDebugSnapPage *page);
 RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr);
 RZ_API ut8 *rz_debug_snap_get_hash(RzDebugSnap *snap, RzMsgDigestSize *size);
 RZ_API bool rz_debug_snap_is_equal(RzDebugSnap *a, RzDebugSnap *b);
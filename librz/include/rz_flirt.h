@@ -219,6 +219,14 @@ RZ_API void rz_sign_flirt_info_fini(RZ_NULLABLE RzFlirtInfo *info);
 
 RZ_API bool rz_sign_flirt_apply(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *flirt_file, ut8 expected_arch);
 
+typedef struct rz_flirt_index_t RzFlirtIndex;
+
+RZ_API RZ_OWN RzFlirtIndex *rz_sign_flirt_index_new(void);
+RZ_API void rz_sign_flirt_index_free(RZ_NULLABLE RzFlirtIndex *index);
+RZ_API bool rz_sign_flirt_index_add(RZ_NONNULL RzFlirtIndex *index, RZ_NONNULL RZ_OWN RzFlirtNode *root);
+RZ_API bool rz_sign_flirt_index_add_file(RZ_NONNULL RzFlirtIndex *index, RZ_NONNULL const char *flirt_file, ut8 expected_arch);
+RZ_API bool rz_sign_flirt_index_apply(RZ_NONNULL RzFlirtIndex *index, RZ_NONNULL RzAnalysis *analysis, size_t max_threads);
+
 typedef struct rz_flirt_compressed_options_t {
 	ut8 version; ///< FLIRT version (supported only from v5 to v10)
 	ut8 arch; ///< FLIRT arch type (RZ_FLIRT_SIG_ARCH_*)
@@ -99,6 +99,12 @@ RZ_API bool rz_il_evaluate_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpEffect
 
 RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr);
 
+// Compiled code
+typedef struct rz_il_code_t RzILCode;
+RZ_API RZ_OWN RzILCode *rz_il_vm_compile(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpEffect *op);
+RZ_API void rz_il_code_free(RZ_NULLABLE RzILCode *code);
+RZ_API bool rz_il_vm_step_code(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILCode *code, ut64 fallthrough_addr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -73,8 +73,10 @@ typedef struct rz_io_t {
 	RzPVector maps; // from tail backwards maps with higher priority are found
 	RzSkyline map_skyline; // map parts that are not covered by others
 	RzIDStorage *files;
-	RzPVector cache;
-	RzSkyline cache_skyline;
+	RBTree cache; ///< RzIOCachePage sorted by address, the write cache overlay
+	ut64 cache_seq; ///< count of the writes done to the cache
+	ut64 cache_mem; ///< bytes of memory held by the pages of the write cache and their logs
+	RzList /*<void *>*/ *cache_stack; ///< saved copies of the write cache, see rz_io_cache_push()
 	ut8 *write_mask;
 	int write_mask_len;
 	RzList *plugins;
@@ -90,6 +92,9 @@ typedef struct rz_io_t {
 	RzEvent *event;
 	PrintfCallback cb_printf;
 	RzCoreBind corebind;
+	ut64 generation; ///< Bumped whenever bytes or layout of the io space may have changed, see RzIOView
+	ut32 remote_page_size; ///< Page size of the RzIORemoteCache of the remote plugins, 0 disables them
+	ut32 remote_readahead; ///< Pages read by the remote plugins after the end of a read missing the cache
 } RzIO;
 
 typedef struct rz_io_desc_t {
@@ -140,6 +145,7 @@ typedef struct rz_io_plugin_t {
 	int (*create)(RzIO *io, const char *file, int mode, int type);
 	bool (*check)(RzIO *io, const char *, bool many);
 	ut8 *(*get_buf)(RzIODesc *desc, ut64 *size);
+	const ut8 *(*get_view)(RzIODesc *desc, ut64 addr, ut64 *size); ///< Borrow already resident bytes at addr without copying, NULL if not possible
 } RzIOPlugin;
 
 typedef struct rz_io_map_t {
@@ -159,6 +165,9 @@ typedef struct rz_io_map_t {
 	void *user;
 } RzIOMap;
 
+/**
+ * \brief A contiguous range of cached changes, as returned by rz_io_cache_list()
+ */
 typedef struct rz_io_cache_t {
 	RzInterval itv;
 	ut8 *data;
@@ -166,12 +175,70 @@ typedef struct rz_io_cache_t {
 	int written;
 } RzIOCache;
 
+#define RZ_IO_CACHE_PAGE_SIZE 0x1000
+
+/**
+ * \brief Copy-on-write page of the write cache
+ *
+ * Only the bytes whose bit is set in \p dirty are patched, the others are
+ * read from the underlying io.
+ */
+typedef struct rz_io_cache_page_t {
+	RBNode rb;
+	ut64 addr; ///< Address of the first byte, aligned to RZ_IO_CACHE_PAGE_SIZE
+	ut32 ndirty; ///< Number of bits set in dirty
+	ut8 dirty[RZ_IO_CACHE_PAGE_SIZE / 8]; ///< Bitmap of patched bytes
+	ut8 written[RZ_IO_CACHE_PAGE_SIZE / 8]; ///< Bitmap of patched bytes already committed
+	ut8 data[RZ_IO_CACHE_PAGE_SIZE]; ///< Patched bytes
+	ut8 odata[RZ_IO_CACHE_PAGE_SIZE]; ///< Bytes of the underlying io before they were patched
+	ut8 *log; ///< Parts of the writes that patched the page, oldest first, to drop them one by one
+	ut32 log_size; ///< Bytes used in log
+	ut32 log_cap; ///< Bytes allocated for log
+} RzIOCachePage;
+
+typedef struct rz_io_cache_stats_t {
+	ut64 pages; ///< Number of allocated pages
+	ut64 bytes; ///< Number of patched bytes
+	ut64 mem; ///< Bytes allocated for the pages, including the logs of the writes they hold
+} RzIOCacheStats;
+
 #define RZ_IO_DESC_CACHE_SIZE (sizeof(ut64) * 8)
 typedef struct rz_io_desc_cache_t {
 	ut64 cached;
 	ut8 cdata[RZ_IO_DESC_CACHE_SIZE];
 } RzIODescCache;
 
+/**
+ * \brief Read-only view over a range of the io space
+ *
+ * The bytes are either borrowed directly from the memory of the underlying
+ * descriptor or, when that is not possible, copied into a caller-provided buffer.
+ */
+typedef struct rz_io_view_t {
+	const ut8 *data; ///< First byte of the view
+	int len; ///< Number of bytes available at data
+	ut64 generation; ///< Value of RzIO.generation when the view was taken
+	bool borrowed; ///< True if data points into descriptor memory instead of the fallback buffer
+} RzIOView;
+
+/**
+ * \brief Reads \p len bytes at \p addr of a remote target, for RzIORemoteCache
+ * \return the bytes read, or a negative value on error
+ */
+typedef int (*RzIORemoteReadCallback)(void *user, ut64 addr, RZ_OUT ut8 *buf, int len);
+
+/**
+ * \brief Pages of the memory of a remote target, fetched in batches
+ */
+typedef struct rz_io_remote_cache_t RzIORemoteCache;
+
+typedef struct rz_io_remote_cache_stats_t {
+	ut64 reads; ///< Reads done through the cache
+	ut64 hits; ///< Pages found in the cache
+	ut64 requests; ///< Reads sent to the target
+	ut64 bytes; ///< Bytes asked to the target
+} RzIORemoteCacheStats;
+
 typedef struct rz_event_io_write_t {
 	ut64 addr;
 	const ut8 *buf;
@@ -328,6 +395,8 @@ RZ_API bool rz_io_vread_at_mapped(RzIO *io, ut64 vaddr, ut8 *buf, int len);
 RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, int len);
 RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, int len);
 RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API bool rz_io_view_at(RzIO *io, ut64 addr, RZ_NONNULL ut8 *buf, int len, RZ_NONNULL RZ_OUT RzIOView *view);
+RZ_API bool rz_io_view_is_valid(RZ_NONNULL RzIO *io, RZ_NONNULL const RzIOView *view);
 RZ_API void rz_io_alprint(RzList *ls);
 RZ_API bool rz_io_write_at(RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_read(RzIO *io, ut8 *buf, int len);
@@ -390,12 +459,26 @@ RZ_IPI bool rz_io_desc_fini(RzIO *io);
 /* io/cache.c */
 RZ_API int rz_io_cache_invalidate(RzIO *io, ut64 from, ut64 to);
 RZ_API bool rz_io_cache_at(RzIO *io, ut64 addr);
+RZ_API bool rz_io_cache_overlaps(RzIO *io, ut64 addr, ut64 len);
 RZ_API void rz_io_cache_commit(RzIO *io, ut64 from, ut64 to);
 RZ_API void rz_io_cache_init(RzIO *io);
 RZ_API void rz_io_cache_fini(RzIO *io);
 RZ_API void rz_io_cache_reset(RzIO *io, int set);
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API RZ_OWN RzList /*<RzIOCache *>*/ *rz_io_cache_list(RzIO *io);
+RZ_API void rz_io_cache_stats(RzIO *io, RZ_NONNULL RZ_OUT RzIOCacheStats *stats);
+RZ_API bool rz_io_cache_push(RzIO *io);
+RZ_API bool rz_io_cache_pop(RzIO *io);
+
+/* io/io_remote_cache.c */
+RZ_API RZ_OWN RzIORemoteCache *rz_io_remote_cache_new(RZ_NONNULL RzIORemoteReadCallback read, void *user);
+RZ_API void rz_io_remote_cache_free(RzIORemoteCache *cache);
+RZ_API void rz_io_remote_cache_setup(RZ_NONNULL RzIORemoteCache *cache, ut32 page_size, ut32 readahead);
+RZ_API int rz_io_remote_cache_read(RZ_NONNULL RzIORemoteCache *cache, ut64 addr, RZ_NONNULL RZ_OUT ut8 *buf, int len);
+RZ_API void rz_io_remote_cache_invalidate(RZ_NONNULL RzIORemoteCache *cache, ut64 addr, ut64 size);
+RZ_API void rz_io_remote_cache_invalidate_all(RZ_NONNULL RzIORemoteCache *cache);
+RZ_API void rz_io_remote_cache_stats(RZ_NONNULL RzIORemoteCache *cache, RZ_NONNULL RZ_OUT RzIORemoteCacheStats *stats);
 
 /* io/p_cache.c */
 RZ_API bool rz_io_desc_cache_init(RzIODesc *desc);
@@ -36,6 +36,11 @@ typedef struct rz_msg_digest_plugin_t {
 	bool (*update)(void *context, const ut8 *data, ut64 size);
 	bool (*final)(void *context, ut8 *digest);
 	bool (*small_block)(const ut8 *data, ut64 size, ut8 **digest, RzMsgDigestSize *digest_size);
+	/**
+	 * Optional, slides the \p size bytes hashed by \p context by one byte,
+	 * removing \p out and appending \p in. final does not alter the context.
+	 */
+	bool (*roll)(void *context, ut8 out, ut8 in, ut64 size);
 } RzMsgDigestPlugin;
 
 typedef struct rz_msg_digest_t {
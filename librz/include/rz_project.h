@@ -16,6 +16,13 @@ extern "C" {
 
 typedef Sdb RzProject;
 
+#define RZ_PROJECT_BIN_MAGIC "RZPRJBIN"
+
+/**
+ * \brief Mapped binary project file, see project_bin.c
+ */
+typedef struct rz_project_bin_t RzProjectBin;
+
 typedef enum rz_project_err {
 	RZ_PROJECT_ERR_SUCCESS,
 	RZ_PROJECT_ERR_FILE,
@@ -30,6 +37,7 @@ typedef enum rz_project_err {
 
 RZ_API RZ_NONNULL const char *rz_project_err_message(RzProjectErr err);
 RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *file);
+RZ_API RzProjectErr rz_project_save_opt(RzCore *core, RzProject *prj, const char *file, bool xrefs);
 RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file, bool compress);
 RZ_API RzProject *rz_project_load_file_raw(const char *file);
 RZ_API void rz_project_free(RzProject *prj);
@@ -46,6 +54,16 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
  */
 RZ_API RzProjectErr rz_project_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res);
 
+RZ_API bool rz_project_is_bin_file(RZ_NONNULL const char *file);
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_open(RZ_NONNULL const char *file);
+RZ_API void rz_project_bin_close(RZ_NULLABLE RzProjectBin *bin);
+RZ_API RZ_BORROW const char *rz_project_bin_get(RZ_NONNULL RzProjectBin *bin, RZ_NONNULL const char *ns, RZ_NONNULL const char *key);
+RZ_API RZ_OWN RzProject *rz_project_bin_sdb(RZ_NONNULL RzProjectBin *bin);
+RZ_API bool rz_project_bin_load_xrefs(RZ_NONNULL RzProjectBin *bin, RZ_NONNULL RzAnalysis *analysis);
+RZ_API RzProjectErr rz_project_bin_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res);
+RZ_API RzProjectErr rz_project_bin_save(RZ_NONNULL RzProject *prj, RZ_NULLABLE RzAnalysis *analysis, RZ_NONNULL const char *file, RZ_NULLABLE RZ_OUT ut64 *written);
+RZ_API RzProjectErr rz_project_bin_save_file(RzCore *core, const char *file);
+
 RZ_API bool rz_project_migrate_v1_v2(RzProject *prj, RzSerializeResultInfo *res);
 RZ_API bool rz_project_migrate_v2_v3(RzProject *prj, RzSerializeResultInfo *res);
 RZ_API bool rz_project_migrate_v3_v4(RzProject *prj, RzSerializeResultInfo *res);
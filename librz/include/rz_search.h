@@ -58,6 +58,7 @@ typedef struct rz_search_t {
 	ut32 string_min; // max length of strings for RZ_SEARCH_STRING
 	ut32 string_max; // min length of strings for RZ_SEARCH_STRING
 	void *data; // data used by search algorithm
+	struct rz_search_matcher_t *matcher; // keywords compiled for RZ_SEARCH_KEYWORD
 	void *user; // user data passed to callback
 	RzSearchCallback callback;
 	ut64 nhits;
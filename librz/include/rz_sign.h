@@ -84,6 +84,8 @@ typedef struct rz_sign_search_met {
 	RzAnalysisFunction *fcn;
 } RzSignSearchMetrics;
 
+typedef struct rz_sign_store_t RzSignStore;
+
 typedef struct rz_sign_search_t {
 	RzSearch *search;
 	RzList *items;
@@ -136,6 +138,12 @@ RZ_API void rz_sign_search_init(RzAnalysis *a, RzSignSearch *ss, int minsz, RzSi
 RZ_API int rz_sign_search_update(RzAnalysis *a, RzSignSearch *ss, ut64 *at, const ut8 *buf, int len);
 RZ_API int rz_sign_fcn_match_metrics(RzSignSearchMetrics *sm);
 
+RZ_API RZ_OWN RzSignStore *rz_sign_store_new(RZ_NONNULL RzAnalysis *a);
+RZ_API void rz_sign_store_free(RZ_NULLABLE RzSignStore *store);
+RZ_API size_t rz_sign_store_len(RZ_NONNULL RzSignStore *store);
+RZ_API bool rz_sign_store_prepare(RZ_NONNULL RzSignStore *store, RZ_NONNULL RzList /*<RzAnalysisFunction *>*/ *fcns, size_t max_threads);
+RZ_API int rz_sign_store_match_metrics(RZ_NONNULL RzSignStore *store, RZ_NONNULL RzSignSearchMetrics *sm);
+
 RZ_API bool rz_sign_load(RzAnalysis *a, const char *file);
 RZ_API bool rz_sign_load_gz(RzAnalysis *a, const char *filename);
 RZ_API char *rz_sign_path(RzAnalysis *a, const char *file);
@@ -22,6 +22,9 @@ typedef struct rz_th_sem_t RzThreadSemaphore;
 typedef struct rz_th_lock_t RzThreadLock;
 typedef struct rz_th_cond_t RzThreadCond;
 typedef struct rz_th_t RzThread;
+typedef struct rz_th_local_t RzThreadLocal;
+typedef void (*RzThreadLocalFree)(void *value);
+typedef void (*RzThreadShardFunction)(void *shard);
 
 #define RZ_THREAD_POOL_ALL_CORES (0)
 
@@ -62,6 +65,11 @@ RZ_API void rz_th_cond_signal_all(RzThreadCond *cond);
 RZ_API void rz_th_cond_wait(RzThreadCond *cond, RzThreadLock *lock);
 RZ_API void rz_th_cond_free(RzThreadCond *cond);
 
+RZ_API RZ_OWN RzThreadLocal *rz_th_local_new(RZ_NULLABLE RzThreadLocalFree destructor);
+RZ_API void rz_th_local_free(RZ_NULLABLE RzThreadLocal *tl);
+RZ_API void *rz_th_local_get(RZ_NONNULL RzThreadLocal *tl);
+RZ_API bool rz_th_local_set(RZ_NONNULL RzThreadLocal *tl, RZ_NULLABLE void *value);
+
 RZ_API size_t rz_th_physical_core_number();
 RZ_API RZ_OWN RzThreadPool *rz_th_pool_new(size_t max_threads);
 RZ_API void rz_th_pool_free(RZ_NULLABLE RzThreadPool *pool);
@@ -71,6 +79,8 @@ RZ_API bool rz_th_pool_wait(RZ_NONNULL RzThreadPool *pool);
 RZ_API bool rz_th_pool_wait_async(RZ_NONNULL RzThreadPool *pool);
 RZ_API bool rz_th_pool_kill(RZ_NONNULL RzThreadPool *pool, bool force);
 RZ_API bool rz_th_pool_kill_free(RZ_NONNULL RzThreadPool *pool);
+RZ_API RZ_OWN RzThreadPool *rz_th_pool_new_shards(size_t max_threads, size_t n_jobs, size_t min_parallel, RZ_NONNULL RZ_OUT size_t *n_shards);
+RZ_API void rz_th_pool_run_shards(RZ_NULLABLE RZ_OWN RzThreadPool *pool, RZ_NONNULL void *shards, size_t shard_size, size_t n_shards, RZ_NONNULL RzThreadShardFunction fcn);
 
 #endif
 
@@ -65,6 +65,7 @@ extern "C" {
 
 // Called by rz_core to set the configuration variables
 RZ_API void rz_log_set_level(RzLogLevel level);
+RZ_API bool rz_log_level_enabled(RzLogLevel level);
 RZ_API void rz_log_set_file(const char *filename);
 RZ_API void rz_log_set_srcinfo(bool show_info);
 RZ_API void rz_log_set_colors(bool show_colors);
@@ -29,6 +29,7 @@ typedef struct {
 	size_t max_uni_blocks; ///< Maximum number of unicode blocks
 	size_t min_str_length; ///< Minimum string length
 	bool prefer_big_endian; //< True if the preferred endianess for UTF strings is big-endian
+	size_t max_threads; ///< Maximum number of threads scanning large ranges, 0 or 1 to scan them sequentially
 } RzUtilStrScanOptions;
 
 RZ_API void rz_detected_string_free(RzDetectedString *str);
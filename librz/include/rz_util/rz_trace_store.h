@@ -0,0 +1,58 @@
+#ifndef RZ_TRACE_STORE_H
+#define RZ_TRACE_STORE_H
+
+#include <rz_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	RZ_TRACE_STORE_PC, ///< an instruction was executed at addr
+	RZ_TRACE_STORE_REG, ///< the register reg was set to value
+	RZ_TRACE_STORE_MEM, ///< the size bytes at addr were written with data
+} RzTraceStoreRecordType;
+
+typedef struct rz_trace_store_record_t {
+	RzTraceStoreRecordType type;
+	ut64 addr; ///< pc of RZ_TRACE_STORE_PC, address of RZ_TRACE_STORE_MEM
+	ut64 reg; ///< register of RZ_TRACE_STORE_REG, as given to rz_trace_store_add_reg()
+	ut64 value; ///< value of RZ_TRACE_STORE_REG
+	ut32 size; ///< bytes written by RZ_TRACE_STORE_MEM
+	const ut8 *data; ///< bytes written by RZ_TRACE_STORE_MEM, owned by the store
+} RzTraceStoreRecord;
+
+typedef struct rz_trace_store_t RzTraceStore;
+
+/**
+ * Reads the records of a store in the order they were added, being valid
+ * as long as nothing is added to the store.
+ */
+typedef struct rz_trace_store_reader_t {
+	const RzTraceStore *store;
+	ut64 chunk; ///< chunk being read
+	ut32 off; ///< offset of the next record in the chunk
+	ut64 pc; ///< last pc read, the next one being encoded relative to it
+} RzTraceStoreReader;
+
+typedef bool (*RzTraceStoreHitCb)(void *user, ut64 addr, ut64 hits);
+
+RZ_API RZ_OWN RzTraceStore *rz_trace_store_new(RZ_NULLABLE const char *spill);
+RZ_API void rz_trace_store_free(RZ_NULLABLE RzTraceStore *store);
+RZ_API bool rz_trace_store_add_pc(RZ_NONNULL RzTraceStore *store, ut64 pc);
+RZ_API bool rz_trace_store_add_reg(RZ_NONNULL RzTraceStore *store, ut64 reg, ut64 value);
+RZ_API bool rz_trace_store_add_mem(RZ_NONNULL RzTraceStore *store, ut64 addr, RZ_NONNULL const ut8 *data, ut32 size);
+RZ_API ut64 rz_trace_store_steps(RZ_NONNULL const RzTraceStore *store);
+RZ_API ut64 rz_trace_store_size(RZ_NONNULL const RzTraceStore *store);
+RZ_API ut64 rz_trace_store_hits(RZ_NONNULL const RzTraceStore *store, ut64 pc);
+RZ_API bool rz_trace_store_coverage(RZ_NONNULL const RzTraceStore *store, RZ_NONNULL RzTraceStoreHitCb cb, void *user);
+RZ_API ut64 rz_trace_store_diff(RZ_NONNULL const RzTraceStore *a, RZ_NONNULL const RzTraceStore *b);
+
+RZ_API void rz_trace_store_reader_init(RZ_NONNULL RzTraceStoreReader *reader, RZ_NONNULL const RzTraceStore *store);
+RZ_API bool rz_trace_store_reader_next(RZ_NONNULL RzTraceStoreReader *reader, RZ_NONNULL RZ_OUT RzTraceStoreRecord *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //  RZ_TRACE_STORE_H
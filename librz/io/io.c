@@ -114,6 +114,8 @@ RZ_API RzIO *rz_io_new(void) {
 RZ_API RzIO *rz_io_init(RzIO *io) {
 	rz_return_val_if_fail(io, NULL);
 	io->addrbytes = 1;
+	io->remote_page_size = 0;
+	io->remote_readahead = 4;
 	rz_io_desc_init(io);
 	rz_skyline_init(&io->map_skyline);
 	rz_io_map_init(io);
@@ -355,6 +357,80 @@ RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	return ret;
 }
 
+// Returns a pointer to the bytes of [addr, addr + len) if they are entirely
+// backed by resident memory of a single descriptor and nothing may shadow them.
+static const ut8 *io_view_borrow(RzIO *io, ut64 addr, int len) {
+	if (io->p_cache || io->cachemode || addr + len - 1 < addr) {
+		return NULL;
+	}
+	if ((io->cached & RZ_PERM_R) && rz_io_cache_overlaps(io, addr, len)) {
+		return NULL;
+	}
+	RzIODesc *desc;
+	ut64 paddr;
+	if (io->va) {
+		const RzSkylineItem *part = rz_skyline_get_item(&io->map_skyline, addr);
+		if (!part || addr + len - 1 > rz_itv_end(part->itv) - 1) {
+			return NULL;
+		}
+		RzIOMap *map = part->user;
+		if (!(map->perm & RZ_PERM_R)) {
+			return NULL;
+		}
+		desc = rz_io_desc_get(io, map->fd);
+		paddr = map->delta + addr - map->itv.addr;
+	} else {
+		desc = io->desc;
+		paddr = addr;
+	}
+	if (!desc || !desc->plugin || !desc->plugin->get_view || !(desc->perm & RZ_PERM_R)) {
+		return NULL;
+	}
+	ut64 size = 0;
+	const ut8 *data = desc->plugin->get_view(desc, paddr, &size);
+	return data && size >= len ? data : NULL;
+}
+
+/**
+ * \brief Get a read-only view of \p len bytes at \p addr, avoiding a copy when possible
+ *
+ * If the whole range is covered by a single map over a descriptor whose bytes
+ * already live in memory (e.g. an mmap'd file) and no io cache may patch it,
+ * the view borrows the bytes directly. Otherwise they are read into \p buf
+ * exactly as rz_io_read_at() would do.
+ *
+ * A borrowed view must not be written to and must be considered stale once
+ * rz_io_view_is_valid() returns false.
+ *
+ * \param buf fallback buffer of at least \p len bytes
+ * \param view filled with the resulting view, view->data is always usable for \p len bytes
+ * \return same semantics as rz_io_read_at(), always true for a borrowed view
+ */
+RZ_API bool rz_io_view_at(RzIO *io, ut64 addr, RZ_NONNULL ut8 *buf, int len, RZ_NONNULL RZ_OUT RzIOView *view) {
+	rz_return_val_if_fail(io && buf && view && len >= 0, false);
+	view->len = len;
+	const ut8 *data = len ? io_view_borrow(io, addr, len) : NULL;
+	if (data) {
+		view->data = data;
+		view->borrowed = true;
+		view->generation = io->generation;
+		return true;
+	}
+	bool ret = rz_io_read_at(io, addr, buf, len);
+	view->data = buf;
+	view->borrowed = false;
+	view->generation = io->generation;
+	return ret;
+}
+
+/**
+ * \brief Check whether the contents of \p view still reflect the current io state
+ */
+RZ_API bool rz_io_view_is_valid(RZ_NONNULL RzIO *io, RZ_NONNULL const RzIOView *view) {
+	rz_return_val_if_fail(io && view, false);
+	return view->data && view->generation == io->generation;
+}
+
 RZ_API bool rz_io_write_at(RzIO *io, ut64 addr, const ut8 *buf, int len) {
 	int i;
 	bool ret = false;
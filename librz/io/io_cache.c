@@ -2,7 +2,60 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_io.h>
-#include <rz_skyline.h>
+
+#define PAGE_MASK (~(ut64)(RZ_IO_CACHE_PAGE_SIZE - 1))
+
+#define BIT_GET(bm, i) ((bm)[(i) >> 3] & (1 << ((i)&7)))
+#define BIT_SET(bm, i) ((bm)[(i) >> 3] |= (1 << ((i)&7)))
+#define BIT_CLR(bm, i) ((bm)[(i) >> 3] &= ~(1 << ((i)&7)))
+
+/**
+ * Part of a write to the cache falling in a page. The pages hold the bytes
+ * of all the writes merged, and log the parts of the writes that patched
+ * them, followed by their bytes, to drop the writes as a whole and reveal
+ * the older ones. The logs grow like vectors, so that writes do not
+ * allocate one by one.
+ *
+ * A write is known by its range: writing again the range of a logged write
+ * replaces it, since both would always be dropped together.
+ */
+typedef struct io_cache_piece_t {
+	ut64 seq; ///< order of the write, the newest one wins
+	RzInterval itv; ///< range of the whole write
+	ut32 off; ///< offset in the page of the bytes of this part
+	ut32 len; ///< number of bytes of this part, following it in the log
+} IOCachePiece;
+
+#define PIECE_SIZE(len) ((sizeof(IOCachePiece) + (len) + 7) & ~(size_t)7)
+
+#define piece_data(p) ((ut8 *)((p) + 1))
+
+#define page_log_foreach(page, p) \
+	for (IOCachePiece *p = (IOCachePiece *)(page)->log; \
+		(page)->log && (ut8 *)p < (page)->log + (page)->log_size; \
+		p = (IOCachePiece *)((ut8 *)p + PIECE_SIZE(p->len)))
+
+typedef struct io_cache_snapshot_t {
+	RBTree pages;
+	ut64 mem;
+} IOCacheSnapshot;
+
+static int page_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	ut64 addr = *(const ut64 *)incoming;
+	const RzIOCachePage *page = container_of(in_tree, const RzIOCachePage, rb);
+	if (addr < page->addr) {
+		return -1;
+	} else if (addr > page->addr) {
+		return 1;
+	}
+	return 0;
+}
+
+static void page_free_rb(RBNode *node, void *user) {
+	RzIOCachePage *page = container_of(node, RzIOCachePage, rb);
+	free(page->log);
+	free(page);
+}
 
 static void cache_item_free(RzIOCache *cache) {
 	if (!cache) {
@@ -13,116 +66,400 @@ static void cache_item_free(RzIOCache *cache) {
 	free(cache);
 }
 
+// The range [from, to) used by commit and invalidate, as inclusive end.
+// to <= from or to == UT64_MAX means "up to the end of the address space".
+static inline ut64 range_last(ut64 from, ut64 to) {
+	return (to <= from || to == UT64_MAX) ? UT64_MAX : to - 1;
+}
+
+static RzIOCachePage *page_get(RzIO *io, ut64 page_addr) {
+	RBNode *node = rz_rbtree_find(io->cache, &page_addr, page_cmp, NULL);
+	return node ? container_of(node, RzIOCachePage, rb) : NULL;
+}
+
+static RzIOCachePage *page_ensure(RzIO *io, ut64 page_addr) {
+	RzIOCachePage *page = page_get(io, page_addr);
+	if (page) {
+		return page;
+	}
+	page = RZ_NEW0(RzIOCachePage);
+	if (!page) {
+		return NULL;
+	}
+	page->addr = page_addr;
+	rz_rbtree_insert(&io->cache, &page_addr, &page->rb, page_cmp, NULL);
+	io->cache_mem += sizeof(RzIOCachePage);
+	return page;
+}
+
+static void page_delete(RzIO *io, RzIOCachePage *page) {
+	ut64 page_addr = page->addr;
+	io->cache_mem -= sizeof(RzIOCachePage) + page->log_cap;
+	rz_rbtree_delete(&io->cache, &page_addr, page_cmp, NULL, page_free_rb, NULL);
+}
+
+// Removes from the log of page the parts of the write of range itv
+static void page_log_remove(RzIOCachePage *page, RzInterval itv) {
+	ut32 src = 0, dst = 0;
+	while (src < page->log_size) {
+		const IOCachePiece *p = (IOCachePiece *)(page->log + src);
+		const size_t n = PIECE_SIZE(p->len);
+		if (!rz_itv_eq(p->itv, itv)) {
+			if (dst != src) {
+				memmove(page->log + dst, p, n);
+			}
+			dst += n;
+		}
+		src += n;
+	}
+	page->log_size = dst;
+}
+
+// Logs the len bytes written at offset off of page, as part of the write w
+static bool page_log_append(RzIO *io, RzIOCachePage *page, const IOCachePiece *w, ut32 off, const ut8 *buf, ut32 len) {
+	const size_t n = PIECE_SIZE(len);
+	if (n > page->log_cap - page->log_size) {
+		if (n > UT32_MAX - page->log_size) {
+			return false;
+		}
+		ut64 cap = RZ_MAX(RZ_MAX((ut64)page->log_cap * 2, 0x100), (ut64)page->log_size + n);
+		cap = RZ_MIN(cap, UT32_MAX);
+		ut8 *log = realloc(page->log, cap);
+		if (!log) {
+			return false;
+		}
+		io->cache_mem += cap - page->log_cap;
+		page->log = log;
+		page->log_cap = cap;
+	}
+	IOCachePiece *p = (IOCachePiece *)(page->log + page->log_size);
+	*p = *w;
+	p->off = off;
+	p->len = len;
+	memcpy(piece_data(p), buf, len);
+	page->log_size += n;
+	return true;
+}
+
+// Returns the first page whose address is >= page_addr, if any.
+static RzIOCachePage *page_lower_bound(RzIO *io, ut64 page_addr) {
+	RBNode *node = rz_rbtree_lower_bound(io->cache, &page_addr, page_cmp, NULL);
+	return node ? container_of(node, RzIOCachePage, rb) : NULL;
+}
+
+// Reads the bytes below the cache, i.e. as they would be read with io.cache disabled.
+static void read_below_cache(RzIO *io, ut64 addr, ut8 *buf, int len) {
+	const int cached = io->cached;
+	const bool cm = io->cachemode;
+	io->cached = 0;
+	io->cachemode = false;
+	memset(buf, io->Oxff, len);
+	rz_io_read_at(io, addr, buf, len);
+	io->cachemode = cm;
+	io->cached = cached;
+}
+
+static bool write_below_cache(RzIO *io, ut64 addr, const ut8 *buf, int len) {
+	const int cached = io->cached;
+	io->cached = 0;
+	bool ret = rz_io_write_at(io, addr, buf, len);
+	io->cached = cached;
+	return ret;
+}
+
 RZ_API bool rz_io_cache_at(RzIO *io, ut64 addr) {
 	rz_return_val_if_fail(io, false);
-	return rz_skyline_contains(&io->cache_skyline, addr);
+	RzIOCachePage *page = page_get(io, addr & PAGE_MASK);
+	return page && BIT_GET(page->dirty, addr - page->addr);
+}
+
+/**
+ * \brief Check whether any byte in [addr, addr + len) is patched by the write cache
+ */
+RZ_API bool rz_io_cache_overlaps(RzIO *io, ut64 addr, ut64 len) {
+	rz_return_val_if_fail(io, false);
+	if (!len || !io->cache) {
+		return false;
+	}
+	const ut64 last = addr + len - 1 < addr ? UT64_MAX : addr + len - 1;
+	RzIOCachePage *page = page_lower_bound(io, addr & PAGE_MASK);
+	while (page && page->addr <= last) {
+		ut64 lo = RZ_MAX(addr, page->addr) - page->addr;
+		ut64 hi = RZ_MIN(last, page->addr + RZ_IO_CACHE_PAGE_SIZE - 1) - page->addr;
+		if (page->ndirty == RZ_IO_CACHE_PAGE_SIZE) {
+			return true;
+		}
+		for (ut64 i = lo; i <= hi; i++) {
+			if (BIT_GET(page->dirty, i)) {
+				return true;
+			}
+		}
+		if (page->addr + RZ_IO_CACHE_PAGE_SIZE == 0) {
+			break;
+		}
+		page = page_lower_bound(io, page->addr + RZ_IO_CACHE_PAGE_SIZE);
+	}
+	return false;
 }
 
 RZ_API void rz_io_cache_init(RzIO *io) {
 	rz_return_if_fail(io);
-	rz_pvector_init(&io->cache, (RzPVectorFree)cache_item_free);
-	rz_skyline_init(&io->cache_skyline);
+	io->cache = NULL;
+	io->cache_seq = 0;
+	io->cache_mem = 0;
+	io->cache_stack = NULL;
 	io->cached = 0;
 }
 
 RZ_API void rz_io_cache_fini(RzIO *io) {
 	rz_return_if_fail(io);
-	rz_pvector_fini(&io->cache);
-	rz_skyline_fini(&io->cache_skyline);
+	rz_rbtree_free(io->cache, page_free_rb, NULL);
+	io->cache = NULL;
+	io->cache_mem = 0;
+	rz_list_free(io->cache_stack);
+	io->cache_stack = NULL;
 	io->cached = 0;
 }
 
 RZ_API void rz_io_cache_commit(RzIO *io, ut64 from, ut64 to) {
-	void **iter;
-	RzIOCache *c;
-	RzInterval range = (RzInterval){ from, to - from };
 	rz_return_if_fail(io);
-	rz_pvector_foreach (&io->cache, iter) {
-		// if (from <= c->to - 1 && c->from <= to - 1) {
-		c = *iter;
-		if (rz_itv_overlap(c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			if (rz_io_write_at(io, rz_itv_begin(c->itv), c->data, rz_itv_size(c->itv))) {
-				c->written = true;
+	const ut64 last = range_last(from, to);
+	RzIOCachePage *page = page_lower_bound(io, from & PAGE_MASK);
+	while (page && page->addr <= last) {
+		ut64 lo = RZ_MAX(from, page->addr) - page->addr;
+		ut64 hi = RZ_MIN(last, page->addr + RZ_IO_CACHE_PAGE_SIZE - 1) - page->addr;
+		ut64 i = lo;
+		while (i <= hi) {
+			if (!BIT_GET(page->dirty, i) || BIT_GET(page->written, i)) {
+				i++;
+				continue;
+			}
+			// coalesce a run of pending bytes into a single write
+			ut64 run = i;
+			while (run <= hi && BIT_GET(page->dirty, run) && !BIT_GET(page->written, run)) {
+				run++;
+			}
+			if (write_below_cache(io, page->addr + i, page->data + i, run - i)) {
+				for (ut64 j = i; j < run; j++) {
+					BIT_SET(page->written, j);
+				}
 			} else {
-				eprintf("Error writing change at 0x%08" PFMT64x "\n", rz_itv_begin(c->itv));
+				eprintf("Error writing change at 0x%08" PFMT64x "\n", page->addr + i);
 			}
-			io->cached = cached;
-			// break; // XXX old behavior, revisit this
+			i = run;
+		}
+		if (page->addr + RZ_IO_CACHE_PAGE_SIZE == 0) {
+			break;
 		}
+		page = page_lower_bound(io, page->addr + RZ_IO_CACHE_PAGE_SIZE);
 	}
 }
 
 RZ_API void rz_io_cache_reset(RzIO *io, int set) {
 	rz_return_if_fail(io);
 	io->cached = set;
-	rz_pvector_clear(&io->cache);
-	rz_skyline_clear(&io->cache_skyline);
+	io->generation++;
+	rz_rbtree_free(io->cache, page_free_rb, NULL);
+	io->cache = NULL;
+	io->cache_mem = 0;
+}
+
+// Drops the patches of [from, last] from the pages, restoring the bytes already committed
+static void pages_clear(RzIO *io, ut64 from, ut64 last) {
+	RzIOCachePage *page = page_lower_bound(io, from & PAGE_MASK);
+	while (page && page->addr <= last) {
+		ut64 lo = RZ_MAX(from, page->addr) - page->addr;
+		ut64 hi = RZ_MIN(last, page->addr + RZ_IO_CACHE_PAGE_SIZE - 1) - page->addr;
+		ut64 i = lo;
+		while (i <= hi) {
+			if (!BIT_GET(page->dirty, i)) {
+				i++;
+				continue;
+			}
+			if (BIT_GET(page->written, i)) {
+				// the patch already reached the underlying io, restore the original bytes
+				ut64 run = i;
+				while (run <= hi && BIT_GET(page->written, run)) {
+					run++;
+				}
+				write_below_cache(io, page->addr + i, page->odata + i, run - i);
+				for (ut64 j = i; j < run; j++) {
+					BIT_CLR(page->written, j);
+				}
+			}
+			BIT_CLR(page->dirty, i);
+			page->ndirty--;
+			i++;
+		}
+		if (page->addr + RZ_IO_CACHE_PAGE_SIZE == 0) {
+			break;
+		}
+		page = page_lower_bound(io, page->addr + RZ_IO_CACHE_PAGE_SIZE);
+	}
+}
+
+// Patches again the bytes of [from, last] written by the writes still logged in the pages, in their order
+static void pages_replay(RzIO *io, ut64 from, ut64 last) {
+	RzIOCachePage *page = page_lower_bound(io, from & PAGE_MASK);
+	while (page && page->addr <= last) {
+		const ut64 lo = RZ_MAX(from, page->addr) - page->addr;
+		const ut64 hi = RZ_MIN(last, page->addr + RZ_IO_CACHE_PAGE_SIZE - 1) - page->addr;
+		page_log_foreach(page, p) {
+			const ut64 plo = RZ_MAX(lo, p->off);
+			const ut64 phi = RZ_MIN(hi, (ut64)p->off + p->len - 1);
+			if (plo > phi) {
+				continue;
+			}
+			for (ut64 i = plo; i <= phi; i++) {
+				if (!BIT_GET(page->dirty, i)) {
+					BIT_SET(page->dirty, i);
+					page->ndirty++;
+				}
+			}
+			memcpy(page->data + plo, piece_data(p) + (plo - p->off), phi - plo + 1);
+		}
+		if (page->addr + RZ_IO_CACHE_PAGE_SIZE == 0) {
+			break;
+		}
+		page = page_lower_bound(io, page->addr + RZ_IO_CACHE_PAGE_SIZE);
+	}
+}
+
+// Removes the parts of the write of range itv from the logs of its pages
+static void pages_log_remove(RzIO *io, RzInterval itv) {
+	const ut64 last = rz_itv_end(itv) - 1;
+	RzIOCachePage *page = page_lower_bound(io, itv.addr & PAGE_MASK);
+	while (page && page->addr <= last) {
+		page_log_remove(page, itv);
+		if (page->addr + RZ_IO_CACHE_PAGE_SIZE == 0) {
+			break;
+		}
+		page = page_lower_bound(io, page->addr + RZ_IO_CACHE_PAGE_SIZE);
+	}
+}
+
+// Releases the pages of [from, last] left without patches
+static void pages_gc(RzIO *io, ut64 from, ut64 last) {
+	RzIOCachePage *page = page_lower_bound(io, from & PAGE_MASK);
+	while (page && page->addr <= last) {
+		const ut64 next = page->addr + RZ_IO_CACHE_PAGE_SIZE;
+		if (!page->ndirty) {
+			page_delete(io, page);
+		}
+		if (!next) {
+			break;
+		}
+		page = page_lower_bound(io, next);
+	}
 }
 
+static int itv_cmp(const void *a, const void *b) {
+	const RzInterval *x = a, *y = b;
+	if (x->addr != y->addr) {
+		return x->addr < y->addr ? -1 : 1;
+	}
+	return x->size < y->size ? -1 : x->size > y->size;
+}
+
+/**
+ * \brief Drop the cached writes overlapping [from, to), reverting any of them that were already committed
+ *
+ * The writes are dropped as a whole, and the older writes below them become
+ * visible again.
+ *
+ * \return number of writes that were invalidated
+ */
 RZ_API int rz_io_cache_invalidate(RzIO *io, ut64 from, ut64 to) {
 	rz_return_val_if_fail(io, 0);
-	int invalidated = 0;
-	void **iter;
-	RzIOCache *c;
-	RzInterval range = (RzInterval){ from, to - from };
-	rz_pvector_foreach_prev(&io->cache, iter) {
-		c = *iter;
-		if (rz_itv_overlap(c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			rz_io_write_at(io, rz_itv_begin(c->itv), c->odata, rz_itv_size(c->itv));
-			io->cached = cached;
-			c->written = false;
-			rz_pvector_remove_data(&io->cache, c);
-			free(c->data);
-			free(c->odata);
-			free(c);
-			invalidated++;
-		}
-	}
-	rz_skyline_clear(&io->cache_skyline);
-	rz_pvector_foreach (&io->cache, iter) {
-		c = *iter;
-		rz_skyline_add(&io->cache_skyline, c->itv, c);
-	}
-	return invalidated;
+	const RzInterval range = { from, to - from };
+	// the ranges of the dropped writes, each write being logged by all of its pages
+	RzVector dropped;
+	rz_vector_init(&dropped, sizeof(RzInterval), NULL, NULL);
+	const bool all = !range.size || to <= from; // empty or wrapping ranges
+	const ut64 last = all ? UT64_MAX : to - 1;
+	RzIOCachePage *page = page_lower_bound(io, all ? 0 : from & PAGE_MASK);
+	while (page && page->addr <= last) {
+		page_log_foreach(page, p) {
+			if (rz_itv_overlap(p->itv, range)) {
+				rz_vector_push(&dropped, &p->itv);
+			}
+		}
+		if (page->addr + RZ_IO_CACHE_PAGE_SIZE == 0) {
+			break;
+		}
+		page = page_lower_bound(io, page->addr + RZ_IO_CACHE_PAGE_SIZE);
+	}
+	rz_vector_sort(&dropped, itv_cmp, false);
+	size_t n = 0;
+	RzInterval *itv;
+	rz_vector_foreach(&dropped, itv) {
+		if (!n || !rz_itv_eq(*itv, *(RzInterval *)rz_vector_index_ptr(&dropped, n - 1))) {
+			*(RzInterval *)rz_vector_index_ptr(&dropped, n++) = *itv;
+		}
+	}
+	dropped.len = n;
+	rz_vector_foreach(&dropped, itv) {
+		pages_log_remove(io, *itv);
+		pages_clear(io, rz_itv_begin(*itv), rz_itv_end(*itv) - 1);
+	}
+	rz_vector_foreach(&dropped, itv) {
+		// reveal the writes below, in their order
+		pages_replay(io, rz_itv_begin(*itv), rz_itv_end(*itv) - 1);
+	}
+	rz_vector_foreach(&dropped, itv) {
+		pages_gc(io, rz_itv_begin(*itv), rz_itv_end(*itv) - 1);
+	}
+	rz_vector_fini(&dropped);
+	io->generation++;
+	return n;
 }
 
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len) {
 	rz_return_val_if_fail(io && buf, false);
-	RzIOCache *ch = RZ_NEW0(RzIOCache);
-	if (!ch) {
-		return false;
+	if (len <= 0) {
+		return true;
 	}
 	if (UT64_ADD_OVFCHK(addr, len)) {
 		const ut64 first_len = UT64_MAX - addr;
 		rz_io_cache_write(io, 0, buf + first_len, len - first_len);
 		len = first_len;
 	}
-	ch->itv = (RzInterval){ addr, len };
-	ch->odata = (ut8 *)calloc(1, len + 1);
-	if (!ch->odata) {
-		free(ch);
-		return false;
-	}
-	ch->data = (ut8 *)calloc(1, len + 1);
-	if (!ch->data) {
-		free(ch->odata);
-		free(ch);
-		return false;
-	}
-	ch->written = false;
-	{
-		const bool cm = io->cachemode;
-		io->cachemode = false;
-		rz_io_read_at(io, addr, ch->odata, len);
-		io->cachemode = cm;
+	const IOCachePiece w = { .seq = io->cache_seq, .itv = { addr, len } };
+	ut8 orig[RZ_IO_CACHE_PAGE_SIZE];
+	ut64 cur = addr;
+	int done = 0;
+	while (done < len) {
+		const ut64 page_addr = cur & PAGE_MASK;
+		const ut64 off = cur - page_addr;
+		const int n = RZ_MIN(len - done, (int)(RZ_IO_CACHE_PAGE_SIZE - off));
+		RzIOCachePage *page = page_ensure(io, page_addr);
+		if (!page) {
+			return false;
+		}
+		if (page->ndirty != RZ_IO_CACHE_PAGE_SIZE) {
+			// remember the original bytes the first time they get patched
+			read_below_cache(io, cur, orig, n);
+			for (int i = 0; i < n; i++) {
+				if (!BIT_GET(page->dirty, off + i)) {
+					BIT_SET(page->dirty, off + i);
+					page->odata[off + i] = orig[i];
+					page->ndirty++;
+				}
+			}
+		}
+		for (int i = 0; i < n; i++) {
+			BIT_CLR(page->written, off + i);
+		}
+		memcpy(page->data + off, buf + done, n);
+		page_log_remove(page, w.itv);
+		if (!page_log_append(io, page, &w, off, buf + done, n)) {
+			return false;
+		}
+		done += n;
+		cur += n;
 	}
-	memcpy(ch->data, buf, len);
-	rz_pvector_push(&io->cache, ch);
-	rz_skyline_add(&io->cache_skyline, ch->itv, ch);
+	io->cache_seq++;
+	io->generation++;
 	RzEventIOWrite iow = { addr, buf, len };
 	rz_event_send(io->event, RZ_EVENT_IO_WRITE, &iow);
 	return true;
@@ -130,7 +467,6 @@ RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len) {
 
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	rz_return_val_if_fail(io && buf, false);
-	RzSkyline *skyline = &io->cache_skyline;
 	if (!len) {
 		return true;
 	}
@@ -139,31 +475,177 @@ RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len) {
 		rz_io_cache_read(io, 0, buf + first_len, len - first_len);
 		len = first_len;
 	}
-	const RzSkylineItem *iter = rz_skyline_get_item_intersect(skyline, addr, len);
-	if (!iter) {
-		return false;
-	}
-	const RzSkylineItem *last = (RzSkylineItem *)skyline->v.a + skyline->v.len;
 	bool covered = false;
-	while (iter != last) {
-		const ut64 begin = rz_itv_begin(iter->itv);
-		const st64 addr_offset = begin - addr;
-		const ut64 buf_offset = addr_offset > 0 ? addr_offset : 0;
-		const ut64 cur_addr = addr + buf_offset;
-		const ut64 left = len - buf_offset;
-		if (begin > cur_addr + left) {
-			break;
+	const ut64 last = addr + len - 1;
+	RzIOCachePage *page = page_lower_bound(io, addr & PAGE_MASK);
+	while (page && page->addr <= last) {
+		const ut64 lo = RZ_MAX(addr, page->addr) - page->addr;
+		const ut64 hi = RZ_MIN(last, page->addr + RZ_IO_CACHE_PAGE_SIZE - 1) - page->addr;
+		ut8 *dst = buf + (page->addr + lo - addr);
+		if (page->ndirty == RZ_IO_CACHE_PAGE_SIZE) {
+			memcpy(dst, page->data + lo, hi - lo + 1);
+			covered = true;
+		} else {
+			for (ut64 i = lo; i <= hi; i++) {
+				if (!page->dirty[i >> 3]) {
+					// skip the whole clean bitmap byte
+					i |= 7;
+					continue;
+				}
+				if (BIT_GET(page->dirty, i)) {
+					dst[i - lo] = page->data[i];
+					covered = true;
+				}
+			}
 		}
-		RzIOCache *cache = iter->user;
-		const ut64 cache_shift = addr_offset < 0 ? -addr_offset : 0;
-		const ut64 cache_offset = begin - rz_itv_begin(cache->itv) + cache_shift;
-		const ut64 read = RZ_MIN(left, rz_itv_size(iter->itv) - cache_shift);
-		memcpy(buf + buf_offset, cache->data + cache_offset, read);
-		covered = true;
-		if (left - read <= 0) {
+		if (page->addr + RZ_IO_CACHE_PAGE_SIZE == 0) {
 			break;
 		}
-		iter++;
+		page = page_lower_bound(io, page->addr + RZ_IO_CACHE_PAGE_SIZE);
 	}
 	return covered;
 }
+
+static bool cache_item_append(RzIOCache *c, ut8 data, ut8 odata, size_t *cap) {
+	size_t size = rz_itv_size(c->itv);
+	if (size == *cap) {
+		size_t ncap = *cap ? *cap * 2 : 64;
+		ut8 *d = realloc(c->data, ncap);
+		if (!d) {
+			return false;
+		}
+		c->data = d;
+		ut8 *od = realloc(c->odata, ncap);
+		if (!od) {
+			return false;
+		}
+		c->odata = od;
+		*cap = ncap;
+	}
+	c->data[size] = data;
+	c->odata[size] = odata;
+	c->itv.size++;
+	return true;
+}
+
+/**
+ * \brief List the contents of the write cache
+ *
+ * Adjacent patched bytes sharing the same written state are coalesced
+ * into a single RzIOCache item, regardless of how many writes created them.
+ */
+RZ_API RZ_OWN RzList /*<RzIOCache *>*/ *rz_io_cache_list(RzIO *io) {
+	rz_return_val_if_fail(io, NULL);
+	RzList *list = rz_list_newf((RzListFree)cache_item_free);
+	if (!list) {
+		return NULL;
+	}
+	RzIOCache *cur = NULL;
+	size_t cap = 0;
+	RBIter it;
+	RzIOCachePage *page;
+	rz_rbtree_foreach (io->cache, it, page, RzIOCachePage, rb) {
+		for (ut64 i = 0; i < RZ_IO_CACHE_PAGE_SIZE; i++) {
+			if (!BIT_GET(page->dirty, i)) {
+				cur = NULL;
+				continue;
+			}
+			const bool written = BIT_GET(page->written, i);
+			if (cur && (rz_itv_end(cur->itv) != page->addr + i || cur->written != written)) {
+				cur = NULL;
+			}
+			if (!cur) {
+				cur = RZ_NEW0(RzIOCache);
+				if (!cur) {
+					goto err;
+				}
+				cur->itv.addr = page->addr + i;
+				cur->written = written;
+				cap = 0;
+				rz_list_append(list, cur);
+			}
+			if (!cache_item_append(cur, page->data[i], page->odata[i], &cap)) {
+				goto err;
+			}
+		}
+	}
+	return list;
+err:
+	rz_list_free(list);
+	return NULL;
+}
+
+/**
+ * \brief Get statistics about the write cache
+ */
+RZ_API void rz_io_cache_stats(RzIO *io, RZ_NONNULL RZ_OUT RzIOCacheStats *stats) {
+	rz_return_if_fail(io && stats);
+	memset(stats, 0, sizeof(*stats));
+	RBIter it;
+	RzIOCachePage *page;
+	rz_rbtree_foreach (io->cache, it, page, RzIOCachePage, rb) {
+		stats->pages++;
+		stats->bytes += page->ndirty;
+	}
+	stats->mem = io->cache_mem;
+}
+
+static void snapshot_free(IOCacheSnapshot *snap) {
+	if (!snap) {
+		return;
+	}
+	rz_rbtree_free(snap->pages, page_free_rb, NULL);
+	free(snap);
+}
+
+/**
+ * \brief Save a copy of the current write cache, to be restored with rz_io_cache_pop()
+ */
+RZ_API bool rz_io_cache_push(RzIO *io) {
+	rz_return_val_if_fail(io, false);
+	if (!io->cache_stack && !(io->cache_stack = rz_list_newf((RzListFree)snapshot_free))) {
+		return false;
+	}
+	IOCacheSnapshot *snap = RZ_NEW0(IOCacheSnapshot);
+	if (!snap) {
+		return false;
+	}
+	RBIter it;
+	RzIOCachePage *page;
+	rz_rbtree_foreach (io->cache, it, page, RzIOCachePage, rb) {
+		RzIOCachePage *copy = rz_mem_dup(page, sizeof(*page));
+		if (!copy) {
+			snapshot_free(snap);
+			return false;
+		}
+		copy->log = page->log_size ? rz_mem_dup(page->log, page->log_size) : NULL;
+		copy->log_cap = copy->log ? page->log_size : 0;
+		if (page->log_size && !copy->log) {
+			free(copy);
+			snapshot_free(snap);
+			return false;
+		}
+		memset(&copy->rb, 0, sizeof(copy->rb));
+		rz_rbtree_insert(&snap->pages, &copy->addr, &copy->rb, page_cmp, NULL);
+		snap->mem += sizeof(RzIOCachePage) + copy->log_cap;
+	}
+	rz_list_push(io->cache_stack, snap);
+	return true;
+}
+
+/**
+ * \brief Discard the current write cache and restore the one saved by the last rz_io_cache_push()
+ */
+RZ_API bool rz_io_cache_pop(RzIO *io) {
+	rz_return_val_if_fail(io, false);
+	IOCacheSnapshot *snap = io->cache_stack ? rz_list_pop(io->cache_stack) : NULL;
+	if (!snap) {
+		return false;
+	}
+	rz_rbtree_free(io->cache, page_free_rb, NULL);
+	io->cache = snap->pages;
+	io->cache_mem = snap->mem;
+	io->generation++;
+	free(snap);
+	return true;
+}
@@ -169,6 +169,7 @@ RZ_API bool rz_io_desc_close(RzIODesc *desc) {
 	RzIO *io = desc->io;
 	RzEventIODescClose ev = { desc };
 	rz_event_send(io->event, RZ_EVENT_IO_DESC_CLOSE, &ev);
+	io->generation++;
 	if (desc->plugin->close && desc->plugin->close(desc)) {
 		return false;
 	}
@@ -250,6 +251,9 @@ RZ_API ut8 *rz_io_desc_get_buf(RzIODesc *desc, RZ_OUT RZ_NONNULL ut64 *size) {
 RZ_API bool rz_io_desc_resize(RzIODesc *desc, ut64 newsize) {
 	if (desc && desc->plugin && desc->plugin->resize) {
 		bool ret = desc->plugin->resize(desc->io, desc, newsize);
+		if (desc->io) {
+			desc->io->generation++;
+		}
 		if (desc->io && desc->io->p_cache) {
 			rz_io_desc_cache_cleanup(desc);
 		}
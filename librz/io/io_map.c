@@ -12,6 +12,7 @@
 
 // Store map parts that are not covered by others into io->map_skyline
 void io_map_calculate_skyline(RzIO *io) {
+	io->generation++;
 	rz_skyline_clear(&io->map_skyline);
 	// Last map has highest priority (it shadows previous maps)
 	void **it;
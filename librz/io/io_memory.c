@@ -142,3 +142,16 @@ ut64 io_memory_lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
 	_io_malloc_set_off(fd, rz_offset);
 	return rz_offset;
 }
+
+const ut8 *io_memory_get_view(RzIODesc *fd, ut64 addr, ut64 *size) {
+	if (!fd || !fd->data || !size) {
+		return NULL;
+	}
+	ut32 mallocsz = _io_malloc_sz(fd);
+	ut8 *buf = _io_malloc_buf(fd);
+	if (!buf || addr >= mallocsz) {
+		return NULL;
+	}
+	*size = mallocsz - addr;
+	return buf + addr;
+}
@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file io_remote_cache.c
+ * Page cache for the memory of remote targets (gdb://, rap://, ...).
+ *
+ * Each miss fetches all the missing pages of the read, plus the read-ahead
+ * pages after it, with a single request to the target. The plugins owning
+ * the cache drop the pages that may have changed when writing or when the
+ * target runs.
+ */
+
+#include <rz_io.h>
+
+/**
+ * Bytes asked to the target at most by a single request
+ */
+#define REMOTE_CACHE_MAX_REQUEST 0x100000
+
+/**
+ * Bytes held by the pages of a cache at most, all of them being dropped
+ * when reached
+ */
+#define REMOTE_CACHE_MAX_MEM 0x1000000
+
+struct rz_io_remote_cache_t {
+	RzIORemoteReadCallback read;
+	void *user;
+	ut32 page_size; ///< 0 when the cache is disabled
+	ut32 readahead; ///< pages fetched after the end of a missed read
+	HtUP /*<ut64, ut8 *>*/ *pages; ///< by page number
+	ut64 mem; ///< bytes held by pages
+	RzIORemoteCacheStats stats;
+};
+
+static void page_kv_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+/**
+ * \brief Creates a cache reading the target through \p read
+ *
+ * The cache is disabled until rz_io_remote_cache_setup() gives it a page size.
+ */
+RZ_API RZ_OWN RzIORemoteCache *rz_io_remote_cache_new(RZ_NONNULL RzIORemoteReadCallback read, void *user) {
+	rz_return_val_if_fail(read, NULL);
+	RzIORemoteCache *cache = RZ_NEW0(RzIORemoteCache);
+	if (!cache) {
+		return NULL;
+	}
+	cache->pages = ht_up_new(NULL, page_kv_free, NULL);
+	if (!cache->pages) {
+		free(cache);
+		return NULL;
+	}
+	cache->read = read;
+	cache->user = user;
+	return cache;
+}
+
+RZ_API void rz_io_remote_cache_free(RzIORemoteCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_up_free(cache->pages);
+	free(cache);
+}
+
+/**
+ * \brief Drops all the pages of \p cache
+ */
+RZ_API void rz_io_remote_cache_invalidate_all(RZ_NONNULL RzIORemoteCache *cache) {
+	rz_return_if_fail(cache);
+	if (!cache->mem) {
+		return;
+	}
+	ht_up_free(cache->pages);
+	cache->pages = ht_up_new(NULL, page_kv_free, NULL);
+	cache->mem = 0;
+}
+
+/**
+ * \brief Drops the pages of \p cache holding any of the \p size bytes at \p addr
+ */
+RZ_API void rz_io_remote_cache_invalidate(RZ_NONNULL RzIORemoteCache *cache, ut64 addr, ut64 size) {
+	rz_return_if_fail(cache);
+	if (!size || !cache->mem) {
+		return;
+	}
+	const ut64 psize = cache->page_size;
+	const ut64 first = addr / psize;
+	const ut64 last = (size > UT64_MAX - addr ? UT64_MAX : addr + size - 1) / psize;
+	if (last - first >= cache->mem / psize) {
+		rz_io_remote_cache_invalidate_all(cache);
+		return;
+	}
+	for (ut64 page = first; page <= last; page++) {
+		if (ht_up_delete(cache->pages, page)) {
+			cache->mem -= psize;
+		}
+	}
+}
+
+/**
+ * \brief Sets the \p page_size and the \p readahead pages of \p cache,
+ * dropping its pages when they change
+ *
+ * A \p page_size of 0 disables the cache, every read going to the target.
+ */
+RZ_API void rz_io_remote_cache_setup(RZ_NONNULL RzIORemoteCache *cache, ut32 page_size, ut32 readahead) {
+	rz_return_if_fail(cache);
+	page_size = RZ_MIN(page_size, REMOTE_CACHE_MAX_REQUEST);
+	if (cache->page_size == page_size && cache->readahead == readahead) {
+		return;
+	}
+	rz_io_remote_cache_invalidate_all(cache);
+	cache->page_size = page_size;
+	cache->readahead = readahead;
+}
+
+RZ_API void rz_io_remote_cache_stats(RZ_NONNULL RzIORemoteCache *cache, RZ_NONNULL RZ_OUT RzIORemoteCacheStats *stats) {
+	rz_return_if_fail(cache && stats);
+	*stats = cache->stats;
+}
+
+static int remote_read(RzIORemoteCache *cache, ut64 addr, ut8 *buf, int len) {
+	cache->stats.requests++;
+	cache->stats.bytes += len;
+	return cache->read(cache->user, addr, buf, len);
+}
+
+static bool page_cached(RzIORemoteCache *cache, ut64 page) {
+	bool found = false;
+	ht_up_find(cache->pages, page, &found);
+	return found;
+}
+
+/**
+ * Fetches the \p count pages from \p page with one request, returning how
+ * many of them, from the first one, were read whole and cached.
+ */
+static ut64 fetch_pages(RzIORemoteCache *cache, ut64 page, ut64 count) {
+	const ut64 psize = cache->page_size;
+	ut8 *data = malloc(count * psize);
+	if (!data) {
+		return 0;
+	}
+	int ret = remote_read(cache, page * psize, data, count * psize);
+	ut64 got = ret > 0 ? RZ_MIN((ut64)ret / psize, count) : 0;
+	if (cache->mem + got * psize > REMOTE_CACHE_MAX_MEM) {
+		rz_io_remote_cache_invalidate_all(cache);
+	}
+	for (ut64 i = 0; i < got; i++) {
+		ut8 *p = rz_mem_dup(data + i * psize, psize);
+		if (!p || !ht_up_insert(cache->pages, page + i, p)) {
+			free(p);
+			got = i;
+			break;
+		}
+		cache->mem += psize;
+	}
+	free(data);
+	return got;
+}
+
+/**
+ * \brief Reads \p len bytes at \p addr of the target into \p buf, through
+ * the pages of \p cache
+ *
+ * The parts that cannot be read as whole pages are asked to the target as
+ * they are, without being cached.
+ *
+ * \return the bytes read, or the negative value of the target on error
+ */
+RZ_API int rz_io_remote_cache_read(RZ_NONNULL RzIORemoteCache *cache, ut64 addr, RZ_NONNULL RZ_OUT ut8 *buf, int len) {
+	rz_return_val_if_fail(cache && buf, -1);
+	if (len < 1) {
+		return len;
+	}
+	cache->stats.reads++;
+	const ut64 psize = cache->page_size;
+	if (!psize || addr > UT64_MAX - len) {
+		return remote_read(cache, addr, buf, len);
+	}
+	const ut64 last = (addr + len - 1) / psize;
+	const ut64 max_count = RZ_MAX(REMOTE_CACHE_MAX_REQUEST / psize, 1);
+	int done = 0;
+	while (done < len) {
+		const ut64 cur = addr + done;
+		const ut64 page = cur / psize;
+		ut8 *data = ht_up_find(cache->pages, page, NULL);
+		if (data) {
+			const int chunk = RZ_MIN(psize - cur % psize, len - done);
+			memcpy(buf + done, data + cur % psize, chunk);
+			done += chunk;
+			cache->stats.hits++;
+			continue;
+		}
+		// the missing pages up to the end of the read, then the ones ahead
+		ut64 count = 1;
+		while (count < max_count && page + count <= last && !page_cached(cache, page + count)) {
+			count++;
+		}
+		const ut64 needed = count;
+		if (page + count > last) {
+			for (ut32 i = 0; i < cache->readahead && count < max_count &&
+			     page + count < UT64_MAX / psize && !page_cached(cache, page + count);
+			     i++) {
+				count++;
+			}
+		}
+		ut64 got = fetch_pages(cache, page, count);
+		if (!got && count > needed) {
+			// the pages ahead may not be readable, do without them
+			got = fetch_pages(cache, page, needed);
+		}
+		if (!got) {
+			int ret = remote_read(cache, cur, buf + done, len - done);
+			if (ret < 0) {
+				return done ? done : ret;
+			}
+			return done + RZ_MIN(ret, len - done);
+		}
+	}
+	return len;
+}
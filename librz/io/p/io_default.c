@@ -11,6 +11,7 @@ typedef struct rz_io_mmo_t {
 	int mode;
 	int perm;
 	bool nocache;
+	bool mmapped;
 	ut8 modified;
 	RzBuffer *buf;
 } RzIOMMapFileObj;
@@ -74,6 +75,7 @@ RzIOMMapFileObj *rz_io_def_mmap_create_new_file(RzIO *io, const char *filename,
 	mmo->mode = mode;
 	if (!mmo->nocache) {
 		mmo->buf = rz_buf_new_mmap(mmo->filename, mmo->perm, mmo->mode);
+		mmo->mmapped = mmo->buf != NULL;
 	}
 	if (!mmo->buf) {
 		mmo->buf = rz_buf_new_file(mmo->filename, mmo->perm, mmo->mode);
@@ -197,6 +199,24 @@ static ut8 *io_default_get_buf(RzIODesc *desc, ut64 *size) {
 	return rz_buf_data(mmo->buf, size);
 }
 
+static const ut8 *io_default_get_view(RzIODesc *desc, ut64 addr, ut64 *size) {
+	rz_return_val_if_fail(desc && size, NULL);
+	RzIOMMapFileObj *mmo = desc->data;
+	// only mmap'd files have their bytes resident without copying them first
+	if (!mmo || !mmo->mmapped) {
+		return NULL;
+	}
+	ut64 buf_size = rz_buf_size(mmo->buf);
+	ut64 mmap_size;
+	const ut8 *data = rz_buf_data(mmo->buf, &mmap_size);
+	buf_size = RZ_MIN(buf_size, mmap_size);
+	if (!data || addr >= buf_size) {
+		return NULL;
+	}
+	*size = buf_size - addr;
+	return data + addr;
+}
+
 RzIOPlugin rz_io_plugin_default = {
 	.name = "default",
 	.desc = "Open local files",
@@ -212,7 +232,8 @@ RzIOPlugin rz_io_plugin_default = {
 #if __UNIX__
 	.is_blockdevice = __is_blockdevice,
 #endif
-	.get_buf = io_default_get_buf
+	.get_buf = io_default_get_buf,
+	.get_view = io_default_get_view
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -12,7 +12,9 @@
 #include <gdbclient/responses.h>
 
 typedef struct {
-	libgdbr_t desc;
+	libgdbr_t desc; ///< first member, the desc global and debug_gdb.c point at it
+	RzIORemoteCache *cache;
+	ut32 cache_epoch; ///< value of desc.mem_epoch the pages of cache are valid for
 } RzIOGdb;
 
 #define RZ_GDB_MAGIC rz_str_djb2_hash("gdb")
@@ -31,6 +33,27 @@ static int debug_gdb_read_at(ut8 *buf, int sz, ut64 addr) {
 	return gdbr_read_memory(desc, addr, buf, sz);
 }
 
+static int gdb_cache_read(void *user, ut64 addr, ut8 *buf, int len) {
+	return debug_gdb_read_at(buf, len, addr);
+}
+
+/**
+ * Drops the cached pages when the target ran or its memory changed since
+ * they were read.
+ */
+static RzIORemoteCache *gdb_cache_sync(RzIO *io) {
+	RzIOGdb *riog = (RzIOGdb *)desc;
+	if (!riog->cache) {
+		return NULL;
+	}
+	if (riog->cache_epoch != desc->mem_epoch) {
+		rz_io_remote_cache_invalidate_all(riog->cache);
+		riog->cache_epoch = desc->mem_epoch;
+	}
+	rz_io_remote_cache_setup(riog->cache, io->remote_page_size, io->remote_readahead);
+	return riog->cache;
+}
+
 static int debug_gdb_write_at(const ut8 *buf, int sz, ut64 addr) {
 	ut32 x, size_max;
 	ut32 packets;
@@ -107,6 +130,8 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 
 	if (gdbr_connect(&riog->desc, host, i_port) == 0) {
 		__close(NULL);
+		riog->cache = rz_io_remote_cache_new(gdb_cache_read, NULL);
+		riog->cache_epoch = riog->desc.mem_epoch;
 		// RZ_FREE (desc);
 		desc = &riog->desc;
 		if (pid > 0) { // FIXME this is here for now because RzDebug's pid and libgdbr's aren't properly synced.
@@ -135,7 +160,14 @@ static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int count) {
 	if (!desc || !desc->data) {
 		return -1;
 	}
-	return debug_gdb_write_at(buf, count, addr);
+	RzIORemoteCache *cache = gdb_cache_sync(io);
+	int ret = debug_gdb_write_at(buf, count, addr);
+	if (cache) {
+		// only the written pages changed since the sync
+		rz_io_remote_cache_invalidate(cache, addr, count);
+		((RzIOGdb *)desc)->cache_epoch = desc->mem_epoch;
+	}
+	return ret;
 }
 
 static ut64 __lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
@@ -161,6 +193,10 @@ static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	if (!desc || !desc->data) {
 		return -1;
 	}
+	RzIORemoteCache *cache = gdb_cache_sync(io);
+	if (cache) {
+		return rz_io_remote_cache_read(cache, addr, buf, count);
+	}
 	return debug_gdb_read_at(buf, count, addr);
 }
 
@@ -168,6 +204,9 @@ static int __close(RzIODesc *fd) {
 	if (fd) {
 		RZ_FREE(fd->name);
 	}
+	if (desc) {
+		rz_io_remote_cache_free(((RzIOGdb *)desc)->cache);
+	}
 	gdbr_disconnect(desc);
 	gdbr_cleanup(desc);
 	RZ_FREE(desc);
@@ -220,6 +259,8 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 			" R!inv.reg         - invalidate reg cache\n"
 			" R!pktsz           - get max packet size used\n"
 			" R!pktsz bytes     - set max. packet size as 'bytes' bytes\n"
+			" R!cache           - show the stats of the memory cache\n"
+			" R!cache-          - drop the pages of the memory cache\n"
 			" R!exec_file [pid] - get file which was executed for"
 			" current/specified pid\n");
 		return NULL;
@@ -239,6 +280,21 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 		desc->stub_features.pkt_sz = RZ_MAX(pktsz, 8); // min = 64
 		return NULL;
 	}
+	if (rz_str_startswith(cmd, "cache")) {
+		RzIOGdb *riog = (RzIOGdb *)desc;
+		if (!riog->cache) {
+			return NULL;
+		}
+		if (cmd[5] == '-') {
+			rz_io_remote_cache_invalidate_all(riog->cache);
+			return NULL;
+		}
+		RzIORemoteCacheStats stats;
+		rz_io_remote_cache_stats(riog->cache, &stats);
+		io->cb_printf("reads: %" PFMT64u "\nhits: %" PFMT64u "\nrequests: %" PFMT64u "\nbytes: %" PFMT64u "\n",
+			stats.reads, stats.hits, stats.requests, stats.bytes);
+		return NULL;
+	}
 	if (rz_str_startswith(cmd, "detach")) {
 		int res;
 		if (!isspace((ut8)cmd[6]) || !desc->stub_features.multiprocess) {
@@ -259,6 +315,7 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 		if (!gdbr_lock_enter(desc)) {
 			goto gdb_lock_leave;
 		}
+		desc->mem_epoch++;
 		if (send_msg(desc, cmd + 4) >= 0) {
 			(void)read_packet(desc, false);
 			desc->data[desc->data_len] = '\0';
@@ -300,6 +357,7 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 				}
 			}
 			gdbr_invalidate_reg_cache();
+			desc->mem_epoch++;
 		}
 		goto gdb_lock_leave;
 	}
@@ -324,6 +382,7 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 				}
 			}
 			gdbr_invalidate_reg_cache();
+			desc->mem_epoch++;
 		}
 		goto gdb_lock_leave;
 	}
@@ -14,17 +14,31 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if __linux__
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#if __linux__ && defined(SYS_process_vm_readv) && defined(SYS_process_vm_writev)
+#define USE_PROCESS_VM 1
+#else
+#define USE_PROCESS_VM 0
+#endif
 
 typedef struct {
 	int pid;
 	int tid;
-	int fd;
+	int fd; ///< /proc/pid/mem of opid, or -1
 	int opid;
+	bool no_process_vm; ///< process_vm_readv/writev cannot be used with pid
 } RzIOPtrace;
 #define RzIOPTRACE_OPID(x) (((RzIOPtrace *)(x)->data)->opid)
 #define RzIOPTRACE_PID(x)  (((RzIOPtrace *)(x)->data)->pid)
 #define RzIOPTRACE_FD(x)   (((RzIOPtrace *)(x)->data)->fd)
 static void open_pidmem(RzIOPtrace *iop);
+static void close_pidmem(RzIOPtrace *iop);
 
 #undef RZ_IO_NFDS
 #define RZ_IO_NFDS 2
@@ -41,12 +55,16 @@ extern int errno;
 #endif
 #endif
 
-#if 0
-procpidmem is buggy.. running this sometimes results in ffff
-
-	while : ; do rizin -qc 'oo;x' -d ls ; done
-#endif
+/*
+ * /proc/pid/mem keeps pointing to the memory the process had when it was
+ * opened, reading nothing once the process executed another program (as
+ * right after `rizin -d ls`), so it is opened again in that case.
+ */
+#if __linux__
+#define USE_PROC_PID_MEM 1
+#else
 #define USE_PROC_PID_MEM 0
+#endif
 
 static int __waitpid(int pid) {
 	int st = 0;
@@ -81,45 +99,96 @@ static int debug_os_read_at(RzIO *io, int pid, ut32 *buf, int sz, ut64 addr) {
 	return sz;
 }
 
-static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
+static ut64 page_end(ut64 addr) {
+	static ut64 page_size = 0;
+	if (!page_size) {
+		long sz = sysconf(_SC_PAGESIZE);
+		page_size = sz > 0 ? sz : 0x1000;
+	}
+	return (addr | (page_size - 1)) + 1;
+}
+
+static void sync_pidmem(RzIOPtrace *iop) {
 #if USE_PROC_PID_MEM
-	int ret, fd;
+	if (iop->pid != iop->opid) {
+		close_pidmem(iop);
+		open_pidmem(iop);
+		iop->opid = iop->pid;
+		iop->no_process_vm = false;
+	}
 #endif
-	ut64 addr = io->off;
-	if (!desc || !desc->data) {
-		return -1;
+}
+
+/**
+ * Reads from the start of the \p len bytes at \p addr without ptrace.
+ *
+ * \return the bytes read, 0 when the page at \p addr cannot be read at
+ * all, or -1 when it has to be read with ptrace.
+ */
+static int read_fast(RzIOPtrace *iop, ut8 *buf, int len, ut64 addr) {
+	bool fault = false;
+#if USE_PROCESS_VM
+	if (!iop->no_process_vm) {
+		struct iovec local = { buf, len };
+		struct iovec remote = { (void *)(size_t)addr, len };
+		ssize_t ret = syscall(SYS_process_vm_readv, iop->pid, &local, 1, &remote, 1, 0);
+		if (ret > 0) {
+			return ret;
+		}
+		if (ret < 0 && errno != EFAULT) {
+			iop->no_process_vm = true;
+		}
+		// unmapped or not readable: /proc/pid/mem and ptrace may ignore the protection
 	}
-	memset(buf, '\xff', len); // TODO: only memset the non-readed bytes
-	/* reopen procpidmem if necessary */
+#endif
 #if USE_PROC_PID_MEM
-	fd = RzIOPTRACE_FD(desc);
-	if (RzIOPTRACE_PID(desc) != RzIOPTRACE_OPID(desc)) {
-		if (fd != -1) {
-			close(fd);
+	if (iop->fd != -1 && addr <= ST64_MAX) {
+		ssize_t ret = pread(iop->fd, buf, len, (off_t)addr);
+		if (!ret) {
+			// the process executed another program since the open
+			close_pidmem(iop);
+			open_pidmem(iop);
+			ret = iop->fd != -1 ? pread(iop->fd, buf, len, (off_t)addr) : -1;
 		}
-		open_pidmem((RzIOPtrace *)desc->data);
-		fd = RzIOPTRACE_FD(desc);
-		RzIOPTRACE_OPID(desc) = RzIOPTRACE_PID(desc);
-	}
-	// /proc/pid/mem fails on latest linux
-	if (fd != -1) {
-		ret = lseek(fd, addr, SEEK_SET);
-		if (ret >= 0) {
-			// Workaround for the buggy Debian Wheeze's /proc/pid/mem
-			if (read(fd, buf, len) != -1) {
-				return ret;
-			}
+		if (ret > 0) {
+			return ret;
 		}
+		fault = ret < 0 && errno == EIO;
 	}
 #endif
-	ut32 *aligned_buf = (ut32 *)rz_malloc_aligned(len, sizeof(ut32));
-	if (aligned_buf) {
-		int res = debug_os_read_at(io, RzIOPTRACE_PID(desc), (ut32 *)aligned_buf, len, addr);
-		memcpy(buf, aligned_buf, len);
-		rz_free_aligned(aligned_buf);
-		return res;
+	return fault ? 0 : -1;
+}
+
+static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
+	ut64 addr = io->off;
+	if (!desc || !desc->data || len < 1 || addr == UT64_MAX) {
+		return -1;
 	}
-	return -1;
+	memset(buf, '\xff', len);
+	RzIOPtrace *iop = desc->data;
+	sync_pidmem(iop);
+	int done = 0;
+	while (done < len) {
+		ut64 at = addr + done;
+		int ret = read_fast(iop, buf + done, len - done, at);
+		if (ret > 0) {
+			done += ret;
+			continue;
+		}
+		// the page at `at` is skipped when it cannot be read at all, or read word by word
+		int chunk = RZ_MIN(len - done, page_end(at) - at);
+		if (ret < 0) {
+			ut32 *aligned_buf = (ut32 *)rz_malloc_aligned(chunk, sizeof(ut32));
+			if (!aligned_buf) {
+				return done ? done : -1;
+			}
+			debug_os_read_at(io, iop->pid, aligned_buf, chunk, at);
+			memcpy(buf + done, aligned_buf, chunk);
+			rz_free_aligned(aligned_buf);
+		}
+		done += chunk;
+	}
+	return len;
 }
 
 static int ptrace_write_at(RzIO *io, int pid, const ut8 *pbuf, int sz, ut64 addr) {
@@ -147,11 +216,61 @@ static int ptrace_write_at(RzIO *io, int pid, const ut8 *pbuf, int sz, ut64 addr
 	return sz;
 }
 
+/**
+ * Writes from the start of the \p len bytes at \p addr without ptrace,
+ * through /proc/pid/mem first as it can write the read-only pages.
+ *
+ * \return the bytes written, or -1 when the page at \p addr has to be
+ * written with ptrace.
+ */
+static int write_fast(RzIOPtrace *iop, const ut8 *buf, int len, ut64 addr) {
+#if USE_PROC_PID_MEM
+	if (iop->fd != -1 && addr <= ST64_MAX) {
+		ssize_t ret = pwrite(iop->fd, buf, len, (off_t)addr);
+		if (ret > 0) {
+			return ret;
+		}
+	}
+#endif
+#if USE_PROCESS_VM
+	if (!iop->no_process_vm) {
+		struct iovec local = { (void *)buf, len };
+		struct iovec remote = { (void *)(size_t)addr, len };
+		ssize_t ret = syscall(SYS_process_vm_writev, iop->pid, &local, 1, &remote, 1, 0);
+		if (ret > 0) {
+			return ret;
+		}
+		if (ret < 0 && errno != EFAULT) {
+			iop->no_process_vm = true;
+		}
+	}
+#endif
+	return -1;
+}
+
 static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int len) {
-	if (!fd || !fd->data) {
+	ut64 addr = io->off;
+	if (!fd || !fd->data || len < 1 || addr == UT64_MAX) {
 		return -1;
 	}
-	return ptrace_write_at(io, RzIOPTRACE_PID(fd), buf, len, io->off);
+	RzIOPtrace *iop = fd->data;
+	sync_pidmem(iop);
+	int done = 0;
+	while (done < len) {
+		ut64 at = addr + done;
+		int ret = write_fast(iop, buf + done, len - done, at);
+		if (ret > 0) {
+			done += ret;
+			continue;
+		}
+		int chunk = RZ_MIN(len - done, page_end(at) - at);
+		ret = ptrace_write_at(io, iop->pid, buf + done, chunk, at);
+		if (ret < chunk) {
+			return done + ret > 0 ? done + RZ_MAX(ret, 0) : -1;
+		}
+		done += chunk;
+	}
+	return len;
 }
 
 static void open_pidmem(RzIOPtrace *iop) {
@@ -247,7 +366,7 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 		return NULL;
 	}
 
-	riop->pid = riop->tid = pid;
+	riop->pid = riop->tid = riop->opid = pid;
 	open_pidmem(riop);
 	desc = rz_io_desc_new(io, &rz_io_plugin_ptrace, file, rw | RZ_PERM_X, mode, riop);
 	desc->name = rz_sys_pid_to_path(pid);
@@ -300,13 +419,17 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 	if (!strcmp(cmd, "help")) {
 		eprintf("Usage: R!cmd args\n"
 			" R!ptrace   - use ptrace io\n"
-			" R!mem      - use /proc/pid/mem io if possible\n"
+			" R!mem      - use process_vm_readv and /proc/pid/mem io if possible\n"
 			" R!pid      - show targeted pid\n"
 			" R!pid <#>  - select new pid\n");
 	} else if (!strcmp(cmd, "ptrace")) {
 		close_pidmem(iop);
+		iop->no_process_vm = true;
 	} else if (!strcmp(cmd, "mem")) {
+		close_pidmem(iop);
 		open_pidmem(iop);
+		iop->opid = iop->pid;
+		iop->no_process_vm = false;
 	} else if (!strncmp(cmd, "pid", 3)) {
 		if (iop) {
 			if (cmd[3] == ' ') {
@@ -11,15 +11,48 @@ typedef struct {
 	RzSocket *fd;
 	RzSocket *client;
 	bool listener;
+	ut64 offset; ///< seek of the io, sent to the remote only when needed
+	RzIORemoteCache *cache;
 } RzIORap;
 
 #define RzIORAP_FD(x)        (((x)->data) ? (((RzIORap *)((x)->data))->client) : NULL)
 #define RzIORAP_IS_LISTEN(x) (((RzIORap *)((x)->data))->listener)
 #define RzIORAP_IS_VALID(x)  ((x) && ((x)->data) && ((x)->plugin == &rz_io_plugin_rap))
 
+static int rap_cache_read(void *user, ut64 addr, ut8 *buf, int len) {
+	RzSocket *s = user;
+	int done = 0;
+	while (done < len) {
+		int chunk = RZ_MIN(len - done, RAP_PACKET_MAX);
+		rz_socket_rap_client_seek(s, addr + done, RZ_IO_SEEK_SET);
+		int ret = rz_socket_rap_client_read(s, buf + done, chunk);
+		if (ret < 1) {
+			break;
+		}
+		done += ret;
+	}
+	return done ? done : -1;
+}
+
+static RzIORemoteCache *rap_cache(RzIO *io, RzIODesc *fd) {
+	RzIORap *rap = fd->data;
+	if (!rap->cache) {
+		return NULL;
+	}
+	rz_io_remote_cache_setup(rap->cache, io->remote_page_size, io->remote_readahead);
+	return rap->cache;
+}
+
 static int __rap_write(RzIO *io, RzIODesc *fd, const ut8 *buf, int count) {
 	RzSocket *s = RzIORAP_FD(fd);
-	return rz_socket_rap_client_write(s, buf, count);
+	RzIORap *rap = fd->data;
+	rz_socket_rap_client_seek(s, rap->offset, RZ_IO_SEEK_SET);
+	int ret = rz_socket_rap_client_write(s, buf, count);
+	RzIORemoteCache *cache = rap_cache(io, fd);
+	if (cache) {
+		rz_io_remote_cache_invalidate(cache, rap->offset, count);
+	}
+	return ret;
 }
 
 static bool __rap_accept(RzIO *io, RzIODesc *desc, int fd) {
@@ -33,6 +66,12 @@ static bool __rap_accept(RzIO *io, RzIODesc *desc, int fd) {
 
 static int __rap_read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	RzSocket *s = RzIORAP_FD(fd);
+	RzIORap *rap = fd->data;
+	RzIORemoteCache *cache = rap_cache(io, fd);
+	if (cache) {
+		return rz_io_remote_cache_read(cache, rap->offset, buf, count);
+	}
+	rz_socket_rap_client_seek(s, rap->offset, RZ_IO_SEEK_SET);
 	return rz_socket_rap_client_read(s, buf, count);
 }
 
@@ -48,6 +87,7 @@ static int __rap_close(RzIODesc *fd) {
 				if (r->client) {
 					ret = rz_socket_close(r->client);
 				}
+				rz_io_remote_cache_free(r->cache);
 				RZ_FREE(r);
 			}
 		}
@@ -58,8 +98,20 @@ static int __rap_close(RzIODesc *fd) {
 }
 
 static ut64 __rap_lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
-	RzSocket *s = RzIORAP_FD(fd);
-	return rz_socket_rap_client_seek(s, offset, whence);
+	RzIORap *rap = fd->data;
+	switch (whence) {
+	case RZ_IO_SEEK_SET:
+		rap->offset = offset;
+		break;
+	case RZ_IO_SEEK_CUR:
+		rap->offset += offset;
+		break;
+	default:
+		// only the remote knows where its end is
+		rap->offset = rz_socket_rap_client_seek(RzIORAP_FD(fd), offset, whence);
+		break;
+	}
+	return rap->offset;
 }
 
 static bool __rap_plugin_open(RzIO *io, const char *pathname, bool many) {
@@ -143,9 +195,11 @@ static RzIODesc *__rap_open(RzIO *io, const char *pathname, int rw, int mode) {
 	}
 	rior->listener = false;
 	rior->client = rior->fd = s;
+	rior->cache = rz_io_remote_cache_new(rap_cache_read, s);
 	if (file && *file) {
 		i = rz_socket_rap_client_open(s, file, rw);
 		if (i == -1) {
+			rz_io_remote_cache_free(rior->cache);
 			free(rior);
 			rz_socket_free(s);
 			return NULL;
@@ -168,8 +222,14 @@ static int __rap_listener(RzIODesc *fd) {
 
 static char *__rap_system(RzIO *io, RzIODesc *fd, const char *command) {
 	RzSocket *s = RzIORAP_FD(fd);
+	RzIORap *rap = fd->data;
 	// TODO: bind core into RzSocket instead of pass the one from io?
-	return rz_socket_rap_client_command(s, command, &io->corebind);
+	char *res = rz_socket_rap_client_command(s, command, &io->corebind);
+	if (rap->cache) {
+		// the command may have changed anything on the remote side
+		rz_io_remote_cache_invalidate_all(rap->cache);
+	}
+	return res;
 #if 0
 	int ret, reslen = 0, cmdlen = 0;
 	unsigned int i;
@@ -0,0 +1,390 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file ahocorasick.c
+ * Multi-pattern matcher used by the keyword search.
+ *
+ * Every keyword contributes one pattern to an Aho-Corasick automaton: the
+ * whole keyword when it has no binmask, otherwise its longest run of fully
+ * unmasked bytes (its anchor). A single pass over a block then yields the
+ * candidate offsets of all the keywords at once, instead of one pass per
+ * keyword. Candidates found through an anchor still have to be verified
+ * against the whole keyword by the caller.
+ */
+
+#include <ctype.h>
+#include "search_private.h"
+
+#define AC_ROOT 0
+#define AC_NONE UT32_MAX
+
+#define STATE(m, i) ((ACState *)rz_vector_index_ptr(&(m)->states, (i)))
+#define PATTERN(m, i) ((ACPattern *)rz_vector_index_ptr(&(m)->pats, (i)))
+
+typedef struct {
+	ut32 child; ///< first child, children are sorted by byte (only used while building)
+	ut32 sibling; ///< next child of the same parent (only used while building)
+	ut32 edges; ///< index of the first outgoing edge in edges
+	ut32 nedges; ///< number of outgoing edges
+	ut32 fail; ///< state of the longest proper suffix that is also in the trie
+	ut32 dict; ///< closest state on the failure chain where a pattern ends, AC_ROOT if none
+	ut32 out; ///< first pattern ending in this state, AC_NONE if none
+	ut8 byte; ///< byte on the edge leading to this state
+} ACState;
+
+typedef struct {
+	ut8 byte;
+	ut32 next;
+} ACEdge;
+
+typedef struct {
+	ut32 kw; ///< position of the keyword in RzSearch.kws
+	ut32 off; ///< offset of the anchor inside the keyword
+	ut32 len; ///< anchor length
+	ut32 kwlen; ///< keyword length
+	ut32 next; ///< next pattern ending in the same state, AC_NONE if none
+} ACPattern;
+
+typedef struct {
+	ut32 kw;
+	ut32 pos;
+} ACCandidate;
+
+struct rz_search_matcher_t {
+	RzVector /*<ACState>*/ states;
+	RzVector /*<ACPattern>*/ pats;
+	ACEdge *edges;
+	ut32 root[256]; ///< dense transitions out of the root state
+	ut8 fold[256]; ///< translation applied to every input byte
+	bool folded; ///< whether fold lowercases the input
+	int first; ///< the only byte leaving the root state, -1 if there are more or fold is not the identity
+	ut32 nkws;
+	ut32 *kw_pat; ///< pattern of every keyword, AC_NONE if it has no anchor
+	bool *kw_verify; ///< whether the candidates of every keyword must be verified
+	RzVector /*<ACCandidate>*/ cands;
+	ut32 *bucket; ///< nkws + 1 offsets in sorted, one range per keyword
+	ut32 *sorted; ///< candidate offsets grouped by keyword
+	size_t sorted_cap;
+};
+
+static ut32 state_new(SearchMatcher *m, ut8 byte) {
+	ACState st = {
+		.child = AC_NONE,
+		.sibling = AC_NONE,
+		.fail = AC_ROOT,
+		.dict = AC_ROOT,
+		.out = AC_NONE,
+		.byte = byte
+	};
+	if (!rz_vector_push(&m->states, &st)) {
+		return AC_NONE;
+	}
+	return rz_vector_len(&m->states) - 1;
+}
+
+static ut32 trie_insert(SearchMatcher *m, const ut8 *pat, ut32 len) {
+	ut32 cur = AC_ROOT;
+	for (ut32 i = 0; i < len; i++) {
+		const ut8 c = m->fold[pat[i]];
+		ut32 prev = AC_NONE;
+		ut32 it = STATE(m, cur)->child;
+		while (it != AC_NONE && STATE(m, it)->byte < c) {
+			prev = it;
+			it = STATE(m, it)->sibling;
+		}
+		if (it != AC_NONE && STATE(m, it)->byte == c) {
+			cur = it;
+			continue;
+		}
+		ut32 n = state_new(m, c);
+		if (n == AC_NONE) {
+			return AC_NONE;
+		}
+		STATE(m, n)->sibling = it;
+		if (prev == AC_NONE) {
+			STATE(m, cur)->child = n;
+		} else {
+			STATE(m, prev)->sibling = n;
+		}
+		cur = n;
+	}
+	return cur;
+}
+
+static inline ut32 edge_find(SearchMatcher *m, const ACState *st, ut8 c) {
+	const ACEdge *e = m->edges + st->edges;
+	ut32 lo = 0, hi = st->nedges;
+	while (lo < hi) {
+		ut32 mid = lo + (hi - lo) / 2;
+		if (e[mid].byte < c) {
+			lo = mid + 1;
+		} else if (e[mid].byte > c) {
+			hi = mid;
+		} else {
+			return e[mid].next;
+		}
+	}
+	return AC_ROOT;
+}
+
+static inline ut32 ac_step(SearchMatcher *m, ut32 cur, ut8 c) {
+	while (cur != AC_ROOT) {
+		const ACState *st = STATE(m, cur);
+		ut32 next = edge_find(m, st, c);
+		if (next != AC_ROOT) {
+			return next;
+		}
+		cur = st->fail;
+	}
+	return m->root[c];
+}
+
+// Turns the sibling lists into sorted edge arrays and computes the failure links
+static bool automaton_build(SearchMatcher *m) {
+	const ut32 nstates = rz_vector_len(&m->states);
+	m->edges = RZ_NEWS(ACEdge, nstates);
+	ut32 *queue = RZ_NEWS(ut32, nstates);
+	if (!m->edges || !queue) {
+		free(queue);
+		return false;
+	}
+	ut32 nedges = 0;
+	for (ut32 i = 0; i < nstates; i++) {
+		ACState *st = STATE(m, i);
+		st->edges = nedges;
+		for (ut32 it = st->child; it != AC_NONE; it = STATE(m, it)->sibling) {
+			m->edges[nedges].byte = STATE(m, it)->byte;
+			m->edges[nedges].next = it;
+			nedges++;
+		}
+		st->nedges = nedges - st->edges;
+	}
+	ACState *root = STATE(m, AC_ROOT);
+	ut32 head = 0, tail = 0;
+	for (ut32 i = 0; i < root->nedges; i++) {
+		const ACEdge *e = m->edges + root->edges + i;
+		m->root[e->byte] = e->next;
+		queue[tail++] = e->next;
+	}
+	m->first = root->nedges == 1 && !m->folded ? m->edges[root->edges].byte : -1;
+	while (head < tail) {
+		const ut32 u = queue[head++];
+		const ACState *su = STATE(m, u);
+		for (ut32 i = 0; i < su->nedges; i++) {
+			const ACEdge *e = m->edges + su->edges + i;
+			const ut32 f = ac_step(m, su->fail, e->byte);
+			ACState *sv = STATE(m, e->next);
+			const ACState *sf = STATE(m, f);
+			sv->fail = f;
+			sv->dict = sf->out != AC_NONE ? f : sf->dict;
+			queue[tail++] = e->next;
+		}
+	}
+	free(queue);
+	return true;
+}
+
+// Longest run of bytes of kw that are not affected by its binmask
+static ut32 kw_anchor(const RzSearchKeyword *kw, ut32 *off) {
+	*off = 0;
+	if (!kw->binmask_length) {
+		return kw->keyword_length;
+	}
+	ut32 best = 0, run = 0;
+	for (ut32 j = 0; j < kw->keyword_length; j++) {
+		if (kw->bin_binmask[j % kw->binmask_length] != 0xff) {
+			run = 0;
+			continue;
+		}
+		if (++run > best) {
+			best = run;
+			*off = j + 1 - run;
+		}
+	}
+	return best;
+}
+
+/**
+ * \brief Compile the keywords of \p s into a single automaton
+ *
+ * Keywords without any fully unmasked byte are not part of the automaton,
+ * search_matcher_hits() returns NULL for them.
+ */
+RZ_IPI SearchMatcher *search_matcher_new(RzSearch *s) {
+	rz_return_val_if_fail(s, NULL);
+	SearchMatcher *m = RZ_NEW0(SearchMatcher);
+	if (!m) {
+		return NULL;
+	}
+	rz_vector_init(&m->states, sizeof(ACState), NULL, NULL);
+	rz_vector_init(&m->pats, sizeof(ACPattern), NULL, NULL);
+	rz_vector_init(&m->cands, sizeof(ACCandidate), NULL, NULL);
+	m->nkws = rz_list_length(s->kws);
+	m->kw_pat = RZ_NEWS(ut32, m->nkws + 1);
+	m->kw_verify = RZ_NEWS0(bool, m->nkws + 1);
+	m->bucket = RZ_NEWS0(ut32, m->nkws + 1);
+	m->sorted_cap = 64;
+	m->sorted = RZ_NEWS(ut32, m->sorted_cap);
+	if (!m->kw_pat || !m->kw_verify || !m->bucket || !m->sorted || state_new(m, 0) == AC_NONE) {
+		goto err;
+	}
+
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	rz_list_foreach (s->kws, iter, kw) {
+		m->folded |= !!kw->icase;
+	}
+	for (int c = 0; c < 256; c++) {
+		// with any case insensitive keyword, the automaton runs on lowercased input
+		m->fold[c] = m->folded ? tolower(c) : c;
+	}
+
+	ut32 n = 0;
+	rz_list_foreach (s->kws, iter, kw) {
+		ut32 off, len = kw_anchor(kw, &off);
+		m->kw_pat[n] = AC_NONE;
+		if (len) {
+			ut32 st = trie_insert(m, kw->bin_keyword + off, len);
+			if (st == AC_NONE) {
+				goto err;
+			}
+			ACPattern pat = {
+				.kw = n,
+				.off = off,
+				.len = len,
+				.kwlen = kw->keyword_length,
+				.next = STATE(m, st)->out
+			};
+			if (!rz_vector_push(&m->pats, &pat)) {
+				goto err;
+			}
+			STATE(m, st)->out = m->kw_pat[n] = rz_vector_len(&m->pats) - 1;
+			m->kw_verify[n] = len != kw->keyword_length || (m->folded && !kw->icase);
+		}
+		n++;
+	}
+	if (!automaton_build(m)) {
+		goto err;
+	}
+	return m;
+err:
+	search_matcher_free(m);
+	return NULL;
+}
+
+RZ_IPI void search_matcher_free(SearchMatcher *m) {
+	if (!m) {
+		return;
+	}
+	rz_vector_fini(&m->states);
+	rz_vector_fini(&m->pats);
+	rz_vector_fini(&m->cands);
+	free(m->edges);
+	free(m->kw_pat);
+	free(m->kw_verify);
+	free(m->bucket);
+	free(m->sorted);
+	free(m);
+}
+
+static bool scan_chunk(SearchMatcher *m, ut32 *state, const ut8 *buf, int len, ut32 base, ut32 total) {
+	ut32 cur = *state;
+	for (int i = 0; i < len; i++) {
+		if (cur == AC_ROOT) {
+			// skip ahead to the next byte that can start a pattern
+			if (m->first >= 0) {
+				const ut8 *p = memchr(buf + i, m->first, len - i);
+				if (!p) {
+					break;
+				}
+				i = p - buf;
+			} else {
+				while (i < len && !m->root[m->fold[buf[i]]]) {
+					i++;
+				}
+				if (i == len) {
+					break;
+				}
+			}
+		}
+		cur = ac_step(m, cur, m->fold[buf[i]]);
+		ut32 st = STATE(m, cur)->out != AC_NONE ? cur : STATE(m, cur)->dict;
+		for (; st != AC_ROOT; st = STATE(m, st)->dict) {
+			for (ut32 p = STATE(m, st)->out; p != AC_NONE; p = PATTERN(m, p)->next) {
+				const ACPattern *pat = PATTERN(m, p);
+				const ut32 end = base + i + 1;
+				if (end < pat->off + pat->len || end - pat->off - pat->len + pat->kwlen > total) {
+					// the keyword around the anchor does not fit in the data
+					continue;
+				}
+				ACCandidate cand = { pat->kw, end - pat->off - pat->len };
+				if (!rz_vector_push(&m->cands, &cand)) {
+					return false;
+				}
+			}
+		}
+	}
+	*state = cur;
+	return true;
+}
+
+// Groups the candidates by keyword, keeping them sorted by offset
+static bool bucket_candidates(SearchMatcher *m) {
+	const size_t n = rz_vector_len(&m->cands);
+	if (n > m->sorted_cap) {
+		size_t cap = RZ_MAX(n, m->sorted_cap * 2);
+		ut32 *sorted = realloc(m->sorted, cap * sizeof(ut32));
+		if (!sorted) {
+			return false;
+		}
+		m->sorted = sorted;
+		m->sorted_cap = cap;
+	}
+	memset(m->bucket, 0, (m->nkws + 1) * sizeof(ut32));
+	ACCandidate *cand;
+	rz_vector_foreach(&m->cands, cand) {
+		m->bucket[cand->kw + 1]++;
+	}
+	for (ut32 i = 0; i < m->nkws; i++) {
+		m->bucket[i + 1] += m->bucket[i];
+	}
+	rz_vector_foreach(&m->cands, cand) {
+		m->sorted[m->bucket[cand->kw]++] = cand->pos;
+	}
+	memmove(m->bucket + 1, m->bucket, m->nkws * sizeof(ut32));
+	m->bucket[0] = 0;
+	return true;
+}
+
+/**
+ * \brief Find the candidates of all keywords in the concatenation of \p head and \p buf
+ *
+ * Only candidates where the whole keyword fits in the concatenation are kept.
+ */
+RZ_IPI bool search_matcher_scan(SearchMatcher *m, const ut8 *head, int head_len, const ut8 *buf, int len) {
+	rz_return_val_if_fail(m && (head || !head_len) && (buf || !len), false);
+	rz_vector_clear(&m->cands);
+	ut32 cur = AC_ROOT;
+	const ut32 total = head_len + len;
+	if (!scan_chunk(m, &cur, head, head_len, 0, total) || !scan_chunk(m, &cur, buf, len, head_len, total)) {
+		return false;
+	}
+	return bucket_candidates(m);
+}
+
+/**
+ * \brief Candidate offsets of the keyword at position \p kw of RzSearch.kws, from the last scan
+ * \param count number of returned offsets, sorted in ascending order
+ * \param verify set to true if the candidates must be checked against the whole keyword
+ * \return NULL if the keyword is not handled by the matcher and must be searched at every offset
+ */
+RZ_IPI const ut32 *search_matcher_hits(SearchMatcher *m, ut32 kw, ut32 *count, bool *verify) {
+	rz_return_val_if_fail(m && count && verify, NULL);
+	if (kw >= m->nkws || m->kw_pat[kw] == AC_NONE) {
+		return NULL;
+	}
+	*count = m->bucket[kw + 1] - m->bucket[kw];
+	*verify = m->kw_verify[kw];
+	return m->sorted + m->bucket[kw];
+}
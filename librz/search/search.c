@@ -4,6 +4,7 @@
 #include <rz_search.h>
 #include <rz_list.h>
 #include <ctype.h>
+#include "search_private.h"
 
 // Experimental search engine (fails, because stops at first hit of every block read
 #define USE_BMH 0
@@ -57,6 +58,7 @@ RZ_API RzSearch *rz_search_free(RzSearch *s) {
 	rz_list_free(s->kws);
 	// rz_io_free(s->iob.io); this is supposed to be a weak reference
 	free(s->data);
+	search_matcher_free(s->matcher);
 	free(s);
 	return NULL;
 }
@@ -100,6 +102,8 @@ RZ_API int rz_search_begin(RzSearch *s) {
 		kw->count = 0;
 		kw->last = 0;
 	}
+	search_matcher_free(s->matcher);
+	s->matcher = s->mode == RZ_SEARCH_KEYWORD ? search_matcher_new(s) : NULL;
 	return true;
 }
 
@@ -355,12 +359,47 @@ static bool brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf,
 	return j == kw->keyword_length;
 }
 
+typedef struct {
+	const ut32 *pos; // candidate offsets from the matcher, NULL to try every offset
+	ut32 count;
+	bool verify;
+} KeywordCandidates;
+
+// Returns the first offset in [i, end) of data where kw matches, or -1.
+// base is the offset of data in the matcher candidates.
+static int next_match(RzSearch *s, RzSearchKeyword *kw, KeywordCandidates *c, const ut8 *data, int i, int end, ut32 base) {
+	if (i >= end) {
+		return -1;
+	}
+	if (!c->pos) {
+		for (; i < end; i++) {
+			if (brute_force_match(s, kw, data, i) != s->inverse) {
+				return i;
+			}
+		}
+		return -1;
+	}
+	while (c->count) {
+		const ut32 p = *c->pos;
+		if (p >= base + end) {
+			return -1;
+		}
+		c->pos++;
+		c->count--;
+		if (p >= base + i && (!c->verify || brute_force_match(s, kw, data, p - base))) {
+			return p - base;
+		}
+	}
+	return -1;
+}
+
 // Supported search variants: backward, binmask, icase, inverse, overlap
 RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
 	RzSearchKeyword *kw;
 	RzListIter *iter;
 	RzSearchLeftover *left;
 	int longest = 0, i;
+	ut32 n = 0;
 	const int old_nhits = s->nhits;
 
 	rz_list_foreach (s->kws, iter, kw) {
@@ -394,39 +433,51 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 
 	ut64 len1 = left->len + RZ_MIN(longest - 1, len);
 	memcpy(left->data + left->len, buf, len1 - left->len);
+
+	// Exact keywords are all located in a single pass over the data, the
+	// fuzzy and inverse searches need every offset to be tried instead.
+	bool use_matcher = false;
+	if (!s->inverse && !s->distance) {
+		if (!s->matcher) {
+			s->matcher = search_matcher_new(s);
+		}
+		use_matcher = s->matcher && search_matcher_scan(s->matcher, left->data, left->len, buf, len);
+	}
 	rz_list_foreach (s->kws, iter, kw) {
+		KeywordCandidates cands = { 0 };
+		if (use_matcher) {
+			cands.pos = search_matcher_hits(s->matcher, n, &cands.count, &cands.verify);
+		}
+		n++;
+		const int kwlen = kw->keyword_length;
 		i = s->overlap || !kw->count ? 0 : s->bckwrds ? kw->last - from < left->len ? from + left->len - kw->last : 0
 			: from - kw->last < left->len         ? kw->last + left->len - from
 							      : 0;
-		for (; i + kw->keyword_length <= len1 && i < left->len; i++) {
-			if (brute_force_match(s, kw, left->data, i) != s->inverse) {
-				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i + left->len : from + i - left->len);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
+		for (; (i = next_match(s, kw, &cands, left->data, i, RZ_MIN(left->len, (int)len1 - kwlen + 1), 0)) >= 0; i++) {
+			int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i + left->len : from + i - left->len);
+			if (!t) {
+				return -1;
+			}
+			if (t > 1) {
+				return s->nhits - old_nhits;
+			}
+			if (!s->overlap) {
+				i += kw->keyword_length - 1;
 			}
 		}
 		i = s->overlap || !kw->count ? 0 : s->bckwrds ? from > kw->last ? from - kw->last : 0
 			: from < kw->last                     ? kw->last - from
 							      : 0;
-		for (; i + kw->keyword_length <= len; i++) {
-			if (brute_force_match(s, kw, buf, i) != s->inverse) {
-				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
+		for (; (i = next_match(s, kw, &cands, buf, i, len - kwlen + 1, left->len)) >= 0; i++) {
+			int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
+			if (!t) {
+				return -1;
+			}
+			if (t > 1) {
+				return s->nhits - old_nhits;
+			}
+			if (!s->overlap) {
+				i += kw->keyword_length - 1;
 			}
 		}
 	}
@@ -509,6 +560,7 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 	}
 	kw->kwidx = s->n_kws++;
 	rz_list_append(s->kws, kw);
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 	return true;
 }
 
@@ -532,6 +584,7 @@ RZ_API void rz_search_string_prepare_backward(RzSearch *s) {
 			*j = t;
 		}
 	}
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 }
 
 RZ_API void rz_search_reset(RzSearch *s, int mode) {
@@ -545,4 +598,5 @@ RZ_API void rz_search_kw_reset(RzSearch *s) {
 	rz_list_purge(s->kws);
 	rz_list_purge(s->hits);
 	RZ_FREE(s->data);
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 }
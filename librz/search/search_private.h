@@ -0,0 +1,16 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef _SEARCH_PRIVATE_H_
+#define _SEARCH_PRIVATE_H_
+
+#include <rz_search.h>
+
+typedef struct rz_search_matcher_t SearchMatcher;
+
+RZ_IPI SearchMatcher *search_matcher_new(RzSearch *s);
+RZ_IPI void search_matcher_free(SearchMatcher *m);
+RZ_IPI bool search_matcher_scan(SearchMatcher *m, const ut8 *head, int head_len, const ut8 *buf, int len);
+RZ_IPI const ut32 *search_matcher_hits(SearchMatcher *m, ut32 kw, ut32 *count, bool *verify);
+
+#endif
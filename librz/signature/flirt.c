@@ -346,22 +346,17 @@ static bool is_pattern_matching(ut32 p_size, const ut8 *pattern, const ut8 *mask
 }
 
 /**
- * \brief Checks if the module matches the buffer and renames the matched functions
+ * \brief Checks if the crc16 and the tail bytes of the module match the buffer
  *
- * \param analysis  The RzAnalysis struct from where to fetch and modify the functions
  * \param module    The FLIRT module to match against the buffer
  * \param b         Buffer to check
- * \param address   Function address
  * \param buf_size  Size of the buffer to check
  *
- * \return True if pattern does match, false otherwise.
+ * \return True if the module does match, false otherwise.
  */
-static int module_match_buffer(RzAnalysis *analysis, const RzFlirtModule *module, ut8 *b, ut64 address, ut32 buf_size) {
-	RzFlirtFunction *flirt_func;
-	RzAnalysisFunction *next_module_function;
-	RzListIter *tail_byte_it, *flirt_func_it;
+static bool module_match_buffer(const RzFlirtModule *module, const ut8 *b, ut32 buf_size) {
+	RzListIter *tail_byte_it;
 	RzFlirtTailByte *tail_byte;
-	ut32 name_index = 0;
 
 	if (32 + module->crc_length < buf_size &&
 		module->crc16 != flirt_crc16(b + 32, module->crc_length)) {
@@ -375,6 +370,23 @@ static int module_match_buffer(RzAnalysis *analysis, const RzFlirtModule *module
 			}
 		}
 	}
+	return true;
+}
+
+/**
+ * \brief Renames the functions of a module matched at the given address
+ *
+ * \param analysis  The RzAnalysis struct from where to fetch and modify the functions
+ * \param module    The FLIRT module matching the function at address
+ * \param address   Function address
+ *
+ * \return False on error, otherwise true
+ */
+static bool module_apply(RzAnalysis *analysis, const RzFlirtModule *module, ut64 address) {
+	RzFlirtFunction *flirt_func;
+	RzAnalysisFunction *next_module_function;
+	RzListIter *flirt_func_it;
+	ut32 name_index = 0;
 
 	rz_list_foreach (module->public_functions, flirt_func_it, flirt_func) {
 		// Once the first module function is found, we need to go through the module->public_functions
@@ -455,77 +467,449 @@ static int module_match_buffer(RzAnalysis *analysis, const RzFlirtModule *module
 	return true;
 }
 
-static int node_match_buffer(RzAnalysis *analysis, const RzFlirtNode *node, ut8 *b, ut64 address, ut32 buf_size, ut32 buf_idx) {
-	RzListIter *node_child_it, *module_it;
-	RzFlirtNode *child;
-	RzFlirtModule *module;
+/**
+ * Children of a node from which a first-bytes jump table is built
+ */
+#define FLIRT_JUMP_MIN_CHILDREN 16
+
+/**
+ * Bytes of a function read at most, which is more than any pattern, crc and
+ * tail byte of a module can reach
+ */
+#define FLIRT_MAX_FUNCTION_READ 0x20000
+
+/**
+ * Bytes of functions read per round, the functions of a round being matched
+ * in parallel
+ */
+#define FLIRT_ROUND_SIZE 0x800000
+
+/**
+ * Functions of a round below which they are matched without threads
+ */
+#define FLIRT_MIN_PARALLEL_FUNCTIONS 64
+
+/**
+ * Node of the tree of an RzFlirtIndex, in the array form used for matching
+ */
+typedef struct flirt_flat_node_t {
+	ut32 length; ///< length of the pattern
+	ut32 pattern; ///< offset of the pattern in RzFlirtIndex.bytes and RzFlirtIndex.mask
+	ut32 children; ///< index of the first child, the children being contiguous
+	ut32 n_children;
+	ut32 modules; ///< index of the first module in RzFlirtIndex.modules
+	ut32 n_modules;
+	ut32 jump; ///< offset of the 257 bounds in RzFlirtIndex.jumps, UT32_MAX without table
+} FlirtFlatNode;
+
+struct rz_flirt_index_t {
+	RzList /*<RzFlirtNode *>*/ *roots; ///< trees added to the index
+	bool compiled;
+	RzVector /*<FlirtFlatNode>*/ nodes; ///< breadth first, nodes[0] having the children of all roots
+	RzVector /*<ut8>*/ bytes;
+	RzVector /*<ut8>*/ mask;
+	RzPVector /*<const RzFlirtModule *>*/ modules;
+	RzVector /*<ut32>*/ jumps; ///< for each first byte, the bounds of its candidates in cands
+	RzVector /*<ut32>*/ cands; ///< children indexes, in their original order
+};
+
+/**
+ * \brief Creates an empty index of FLIRT signatures
+ *
+ * The trees of all the signature files added are merged under a single root,
+ * compiled into arrays the first time the index is applied.
+ */
+RZ_API RZ_OWN RzFlirtIndex *rz_sign_flirt_index_new(void) {
+	RzFlirtIndex *index = RZ_NEW0(RzFlirtIndex);
+	if (!index) {
+		return NULL;
+	}
+	index->roots = rz_list_newf((RzListFree)rz_sign_flirt_node_free);
+	if (!index->roots) {
+		free(index);
+		return NULL;
+	}
+	rz_vector_init(&index->nodes, sizeof(FlirtFlatNode), NULL, NULL);
+	rz_vector_init(&index->bytes, sizeof(ut8), NULL, NULL);
+	rz_vector_init(&index->mask, sizeof(ut8), NULL, NULL);
+	rz_pvector_init(&index->modules, NULL);
+	rz_vector_init(&index->jumps, sizeof(ut32), NULL, NULL);
+	rz_vector_init(&index->cands, sizeof(ut32), NULL, NULL);
+	return index;
+}
+
+static void index_flat_clear(RzFlirtIndex *index) {
+	rz_vector_clear(&index->nodes);
+	rz_vector_clear(&index->bytes);
+	rz_vector_clear(&index->mask);
+	rz_pvector_clear(&index->modules);
+	rz_vector_clear(&index->jumps);
+	rz_vector_clear(&index->cands);
+	index->compiled = false;
+}
+
+RZ_API void rz_sign_flirt_index_free(RZ_NULLABLE RzFlirtIndex *index) {
+	if (!index) {
+		return;
+	}
+	index_flat_clear(index);
+	rz_list_free(index->roots);
+	free(index);
+}
 
-	if (is_pattern_matching(node->length, node->pattern_bytes, node->pattern_mask, b + buf_idx, buf_size - buf_idx)) {
+/**
+ * \brief Adds the signatures of the tree \p root to \p index, which takes its ownership
+ *
+ * When several trees match a function, the first one added wins.
+ */
+RZ_API bool rz_sign_flirt_index_add(RZ_NONNULL RzFlirtIndex *index, RZ_NONNULL RZ_OWN RzFlirtNode *root) {
+	rz_return_val_if_fail(index && root, false);
+	if (!rz_list_append(index->roots, root)) {
+		rz_sign_flirt_node_free(root);
+		return false;
+	}
+	if (index->compiled) {
+		index_flat_clear(index);
+	}
+	return true;
+}
+
+/**
+ * \brief Parses the FLIRT file and adds its signatures to \p index
+ *
+ * \param  index       The index to add the signatures to
+ * \param  flirt_file  The FLIRT file to parse, either .sig or .pat
+ * \return true if the file was parsed and added
+ */
+RZ_API bool rz_sign_flirt_index_add_file(RZ_NONNULL RzFlirtIndex *index, RZ_NONNULL const char *flirt_file, ut8 expected_arch) {
+	rz_return_val_if_fail(index && RZ_STR_ISNOTEMPTY(flirt_file), false);
+	RzBuffer *flirt_buf = NULL;
+	RzFlirtNode *node = NULL;
+
+	if (expected_arch > RZ_FLIRT_SIG_ARCH_ANY) {
+		RZ_LOG_ERROR("FLIRT: unknown architecture %u\n", expected_arch);
+		return false;
+	}
+
+	const char *extension = rz_str_lchr(flirt_file, '.');
+	if (RZ_STR_ISEMPTY(extension) || (strcmp(extension, ".sig") != 0 && strcmp(extension, ".pat") != 0)) {
+		RZ_LOG_ERROR("FLIRT: unknown extension '%s'\n", extension);
+		return false;
+	}
+
+	if (!(flirt_buf = rz_buf_new_slurp(flirt_file))) {
+		RZ_LOG_ERROR("FLIRT: Can't open %s\n", flirt_file);
+		return false;
+	}
+
+	if (!strcmp(extension, ".pat")) {
+		node = rz_sign_flirt_parse_string_pattern_from_buffer(flirt_buf, RZ_FLIRT_NODE_OPTIMIZE_MAX, NULL);
+	} else {
+		node = rz_sign_flirt_parse_compressed_pattern_from_buffer(flirt_buf, expected_arch, NULL);
+	}
+
+	rz_buf_free(flirt_buf);
+	if (!node) {
+		RZ_LOG_ERROR("FLIRT: We encountered an error while parsing the file %s. Sorry.\n", flirt_file);
+		return false;
+	}
+	return rz_sign_flirt_index_add(index, node);
+}
+
+static bool index_add_pattern(RzFlirtIndex *index, FlirtFlatNode *flat, const RzFlirtNode *node) {
+	flat->length = node->length;
+	flat->pattern = rz_vector_len(&index->bytes);
+	if (!node->length) {
+		return true;
+	}
+	ut8 *bytes = rz_vector_insert_range(&index->bytes, flat->pattern, node->pattern_bytes, node->length);
+	ut8 *mask = rz_vector_insert_range(&index->mask, flat->pattern, node->pattern_mask, node->length);
+	return bytes && mask;
+}
+
+/**
+ * Builds the jump table of \p flat, which for each byte lists the children
+ * whose pattern starts with it or with a variant byte, in their original order.
+ */
+static bool index_add_jump_table(RzFlirtIndex *index, FlirtFlatNode *flat) {
+	ut32 counts[256] = { 0 };
+	ut32 n_variant = 0;
+	const FlirtFlatNode *nodes = rz_vector_index_ptr(&index->nodes, 0);
+	const ut8 *bytes = rz_vector_index_ptr(&index->bytes, 0);
+	const ut8 *mask = rz_vector_index_ptr(&index->mask, 0);
+	for (ut32 i = 0; i < flat->n_children; i++) {
+		const FlirtFlatNode *child = &nodes[flat->children + i];
+		if (!child->length || mask[child->pattern] != 0xFF) {
+			n_variant++;
+		} else {
+			counts[bytes[child->pattern]]++;
+		}
+	}
+	if (n_variant > flat->n_children / 4) {
+		// most of the children would be in every entry
+		return true;
+	}
+	ut32 bounds[257];
+	ut32 start = rz_vector_len(&index->cands);
+	for (ut32 b = 0; b < 256; b++) {
+		bounds[b] = start;
+		start += counts[b] + n_variant;
+	}
+	bounds[256] = start;
+	flat->jump = rz_vector_len(&index->jumps);
+	const ut32 first = rz_vector_len(&index->cands);
+	if (!rz_vector_insert_range(&index->jumps, flat->jump, bounds, RZ_ARRAY_SIZE(bounds)) ||
+		!rz_vector_insert_range(&index->cands, first, NULL, start - first)) {
+		return false;
+	}
+	ut32 *cands = rz_vector_index_ptr(&index->cands, 0);
+	for (ut32 i = 0; i < flat->n_children; i++) {
+		const FlirtFlatNode *child = &nodes[flat->children + i];
+		const ut32 idx = flat->children + i;
+		if (!child->length || mask[child->pattern] != 0xFF) {
+			for (ut32 b = 0; b < 256; b++) {
+				cands[bounds[b]++] = idx;
+			}
+		} else {
+			cands[bounds[bytes[child->pattern]]++] = idx;
+		}
+	}
+	return true;
+}
+
+/**
+ * Lays the trees of \p index out breadth first, so that the children of each
+ * node are contiguous, then builds the jump tables of the nodes with many
+ * children, like the root merging all the trees.
+ */
+static bool index_compile(RzFlirtIndex *index) {
+	bool ret = false;
+	RzFlirtNode root = { 0 };
+	RzPVector queue;
+	rz_pvector_init(&queue, NULL);
+	root.child_list = rz_list_new();
+	if (!root.child_list) {
+		goto beach;
+	}
+	RzListIter *it;
+	RzFlirtNode *tree;
+	rz_list_foreach (index->roots, it, tree) {
+		RzListIter *it2;
+		RzFlirtNode *child;
+		rz_list_foreach (tree->child_list, it2, child) {
+			if (!rz_list_append(root.child_list, child)) {
+				goto beach;
+			}
+		}
+	}
+	if (!rz_pvector_push(&queue, &root)) {
+		goto beach;
+	}
+	for (size_t i = 0; i < rz_pvector_len(&queue); i++) {
+		const RzFlirtNode *node = rz_pvector_at(&queue, i);
+		FlirtFlatNode *flat = rz_vector_push(&index->nodes, NULL);
+		if (!flat) {
+			goto beach;
+		}
+		memset(flat, 0, sizeof(*flat));
+		flat->jump = UT32_MAX;
+		if (!index_add_pattern(index, flat, node)) {
+			goto beach;
+		}
+		RzFlirtNode *child;
+		RzFlirtModule *module;
 		if (node->child_list) {
-			rz_list_foreach (node->child_list, node_child_it, child) {
-				if (node_match_buffer(analysis, child, b, address, buf_size, buf_idx + node->length)) {
-					return true;
+			flat->children = rz_pvector_len(&queue);
+			flat->n_children = rz_list_length(node->child_list);
+			rz_list_foreach (node->child_list, it, child) {
+				if (!rz_pvector_push(&queue, child)) {
+					goto beach;
 				}
 			}
 		} else if (node->module_list) {
-			rz_list_foreach (node->module_list, module_it, module) {
-				if (module_match_buffer(analysis, module, b, address, buf_size)) {
-					return true;
+			flat->modules = rz_pvector_len(&index->modules);
+			flat->n_modules = rz_list_length(node->module_list);
+			rz_list_foreach (node->module_list, it, module) {
+				if (!rz_pvector_push(&index->modules, module)) {
+					goto beach;
 				}
 			}
 		}
 	}
+	for (size_t i = 0; i < rz_vector_len(&index->nodes); i++) {
+		FlirtFlatNode *flat = rz_vector_index_ptr(&index->nodes, i);
+		if (flat->n_children >= FLIRT_JUMP_MIN_CHILDREN && !index_add_jump_table(index, flat)) {
+			goto beach;
+		}
+	}
+	index->compiled = true;
+	ret = true;
 
-	return false;
+beach:
+	rz_list_free(root.child_list);
+	rz_pvector_fini(&queue);
+	if (!ret) {
+		index_flat_clear(index);
+	}
+	return ret;
+}
+
+static const RzFlirtModule *index_match_node(const RzFlirtIndex *index, ut32 node_idx, const ut8 *b, ut32 buf_size, ut32 buf_idx) {
+	const FlirtFlatNode *node = rz_vector_index_ptr((RzVector *)&index->nodes, node_idx);
+	if (buf_idx > buf_size || !is_pattern_matching(node->length,
+					  (ut8 *)index->bytes.a + node->pattern, (ut8 *)index->mask.a + node->pattern,
+					  b + buf_idx, buf_size - buf_idx)) {
+		return NULL;
+	}
+	buf_idx += node->length;
+	if (node->n_children) {
+		const ut32 *cands = index->cands.a;
+		const ut32 *jumps = index->jumps.a;
+		const RzFlirtModule *module = NULL;
+		if (node->jump != UT32_MAX && buf_idx < buf_size) {
+			const ut32 *bounds = jumps + node->jump + b[buf_idx];
+			for (ut32 i = bounds[0]; i < bounds[1] && !module; i++) {
+				module = index_match_node(index, cands[i], b, buf_size, buf_idx);
+			}
+			return module;
+		}
+		for (ut32 i = 0; i < node->n_children && !module; i++) {
+			module = index_match_node(index, node->children + i, b, buf_size, buf_idx);
+		}
+		return module;
+	}
+	for (ut32 i = 0; i < node->n_modules; i++) {
+		const RzFlirtModule *module = rz_pvector_at((RzPVector *)&index->modules, node->modules + i);
+		if (module_match_buffer(module, b, buf_size)) {
+			return module;
+		}
+	}
+	return NULL;
+}
+
+typedef struct flirt_function_t {
+	ut64 addr;
+	ut32 size; ///< bytes read, at most FLIRT_MAX_FUNCTION_READ
+	ut32 offset; ///< in the buffer of the round
+	const RzFlirtModule *module; ///< matching the function, if any
+} FlirtFunction;
+
+typedef struct flirt_shard_t {
+	const RzFlirtIndex *index;
+	const ut8 *buf;
+	FlirtFunction *funcs;
+	size_t first;
+	size_t last;
+} FlirtShard;
+
+static void flirt_shard_match(void *user) {
+	FlirtShard *shard = user;
+	for (size_t i = shard->first; i < shard->last; i++) {
+		FlirtFunction *func = &shard->funcs[i];
+		func->module = index_match_node(shard->index, 0, shard->buf + func->offset, func->size, 0);
+	}
+}
+
+static void index_match_round(const RzFlirtIndex *index, const ut8 *buf, FlirtFunction *funcs, size_t n_funcs, FlirtShard *shards, size_t nthreads) {
+	size_t nshards;
+	RzThreadPool *pool = rz_th_pool_new_shards(nthreads, n_funcs, FLIRT_MIN_PARALLEL_FUNCTIONS, &nshards);
+	const size_t per_shard = (n_funcs + nshards - 1) / nshards;
+	for (size_t t = 0; t < nshards; t++) {
+		FlirtShard *shard = &shards[t];
+		shard->index = index;
+		shard->buf = buf;
+		shard->funcs = funcs;
+		shard->first = RZ_MIN(n_funcs, t * per_shard);
+		shard->last = RZ_MIN(n_funcs, shard->first + per_shard);
+	}
+	rz_th_pool_run_shards(pool, shards, sizeof(FlirtShard), nshards, flirt_shard_match);
 }
 
 /**
- * \brief Tries to find matching functions between the signature infos in root_node and the analyzed functions in analysis
+ * \brief Tries to find matching functions between the signatures of \p index
+ * and the analyzed functions in \p analysis, renaming the matched ones
+ *
+ * The functions are read by rounds into the same buffer, then matched in
+ * parallel, and the matches are applied in the order of the functions.
  *
- * \param analysis   The analysis
- * \param root_node  The root node
+ * \param index        The index of the signatures
+ * \param analysis     The analysis
+ * \param max_threads  Threads matching the functions, 0 to use all the available cores
  *
  * \return False on error, otherwise true
  */
-static bool node_match_functions(RzAnalysis *analysis, const RzFlirtNode *root_node) {
+RZ_API bool rz_sign_flirt_index_apply(RZ_NONNULL RzFlirtIndex *index, RZ_NONNULL RzAnalysis *analysis, size_t max_threads) {
+	rz_return_val_if_fail(index && analysis, false);
 	bool ret = true;
 
 	if (rz_list_length(analysis->fcns) == 0) {
 		RZ_LOG_ERROR("FLIRT: There are no analyzed functions. Have you run 'aa'?\n");
 		return ret;
 	}
+	if (!index->compiled && !index_compile(index)) {
+		RZ_LOG_ERROR("FLIRT: cannot compile the signatures\n");
+		return false;
+	}
 
-	analysis->flb.push_fs(analysis->flb.f, "flirt");
+	RzVector funcs;
+	rz_vector_init(&funcs, sizeof(FlirtFunction), NULL, NULL);
 	RzListIter *it_func;
 	RzAnalysisFunction *func;
 	rz_list_foreach (analysis->fcns, it_func, func) {
 		if (func->type != RZ_ANALYSIS_FCN_TYPE_FCN && func->type != RZ_ANALYSIS_FCN_TYPE_LOC) { // scan only for unknown functions
 			continue;
 		}
-
-		ut64 func_size = rz_analysis_function_linear_size(func);
-		ut8 *func_buf = malloc(func_size);
-		if (!func_buf) {
-			ret = false;
-			break;
+		FlirtFunction *f = rz_vector_push(&funcs, NULL);
+		if (!f) {
+			rz_vector_fini(&funcs);
+			return false;
 		}
-		if (!analysis->iob.read_at(analysis->iob.io, func->addr, func_buf, (int)func_size)) {
-			RZ_LOG_ERROR("FLIRT: Couldn't read function %s at 0x%" PFMT64x "\n", func->name, func->addr);
-			RZ_FREE(func_buf);
-			ret = false;
-			break;
+		f->addr = func->addr;
+		f->size = RZ_MIN(rz_analysis_function_linear_size(func), FLIRT_MAX_FUNCTION_READ);
+	}
+
+	size_t nthreads = rz_th_physical_core_number();
+	if (max_threads) {
+		nthreads = RZ_MIN(nthreads, max_threads);
+	}
+	ut8 *buf = malloc(FLIRT_ROUND_SIZE);
+	FlirtShard *shards = RZ_NEWS0(FlirtShard, RZ_MAX(nthreads, 1));
+	if (!buf || !shards) {
+		ret = false;
+		goto beach;
+	}
+
+	analysis->flb.push_fs(analysis->flb.f, "flirt");
+	FlirtFunction *all = rz_vector_index_ptr(&funcs, 0);
+	const size_t n_funcs = rz_vector_len(&funcs);
+	for (size_t first = 0, last = 0; ret && first < n_funcs; first = last) {
+		ut32 used = 0;
+		for (last = first; last < n_funcs && used + all[last].size <= FLIRT_ROUND_SIZE; last++) {
+			FlirtFunction *f = &all[last];
+			if (!analysis->iob.read_at(analysis->iob.io, f->addr, buf + used, (int)f->size)) {
+				RZ_LOG_ERROR("FLIRT: Couldn't read function at 0x%" PFMT64x "\n", f->addr);
+				ret = false;
+				break;
+			}
+			f->offset = used;
+			used += f->size;
 		}
-		RzListIter *node_child_it;
-		RzFlirtNode *child;
-		rz_list_foreach (root_node->child_list, node_child_it, child) {
-			if (node_match_buffer(analysis, child, func_buf, func->addr, func_size, 0)) {
+		index_match_round(index, buf, all + first, last - first, shards, nthreads);
+		for (size_t i = first; i < last; i++) {
+			// the function may have been merged into a previously matched one
+			if (all[i].module && rz_analysis_get_function_at(analysis, all[i].addr) &&
+				!module_apply(analysis, all[i].module, all[i].addr)) {
+				ret = false;
 				break;
 			}
 		}
-		RZ_FREE(func_buf);
 	}
 	analysis->flb.pop_fs(analysis->flb.f);
 
+beach:
+	free(shards);
+	free(buf);
+	rz_vector_fini(&funcs);
 	return ret;
 }
 
@@ -1288,41 +1672,19 @@ exit:
  */
 RZ_API bool rz_sign_flirt_apply(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *flirt_file, ut8 expected_arch) {
 	rz_return_val_if_fail(analysis && RZ_STR_ISNOTEMPTY(flirt_file), false);
-	RzBuffer *flirt_buf = NULL;
-	RzFlirtNode *node = NULL;
-
-	if (expected_arch > RZ_FLIRT_SIG_ARCH_ANY) {
-		RZ_LOG_ERROR("FLIRT: unknown architecture %u\n", expected_arch);
+	RzFlirtIndex *index = rz_sign_flirt_index_new();
+	if (!index) {
 		return false;
 	}
-
-	const char *extension = rz_str_lchr(flirt_file, '.');
-	if (RZ_STR_ISEMPTY(extension) || (strcmp(extension, ".sig") != 0 && strcmp(extension, ".pat") != 0)) {
-		RZ_LOG_ERROR("FLIRT: unknown extension '%s'\n", extension);
+	if (!rz_sign_flirt_index_add_file(index, flirt_file, expected_arch)) {
+		rz_sign_flirt_index_free(index);
 		return false;
 	}
-
-	if (!(flirt_buf = rz_buf_new_slurp(flirt_file))) {
-		RZ_LOG_ERROR("FLIRT: Can't open %s\n", flirt_file);
-		return false;
-	}
-
-	if (!strcmp(extension, ".pat")) {
-		node = rz_sign_flirt_parse_string_pattern_from_buffer(flirt_buf, RZ_FLIRT_NODE_OPTIMIZE_MAX, NULL);
-	} else {
-		node = rz_sign_flirt_parse_compressed_pattern_from_buffer(flirt_buf, expected_arch, NULL);
-	}
-
-	rz_buf_free(flirt_buf);
-	if (node) {
-		if (!node_match_functions(analysis, node)) {
-			RZ_LOG_ERROR("FLIRT: Error while scanning the file %s\n", flirt_file);
-		}
-		rz_sign_flirt_node_free(node);
-		return true;
+	if (!rz_sign_flirt_index_apply(index, analysis, 0)) {
+		RZ_LOG_ERROR("FLIRT: Error while scanning the file %s\n", flirt_file);
 	}
-	RZ_LOG_ERROR("FLIRT: We encountered an error while parsing the file %s. Sorry.\n", flirt_file);
-	return false;
+	rz_sign_flirt_index_free(index);
+	return true;
 }
 
 /**
@@ -2329,29 +2329,50 @@ static int matchCount(int a, int b) {
 	return RZ_ABS(c) < m;
 }
 
-static bool fcnMetricsCmp(RzSignItem *it, RzAnalysisFunction *fcn) {
+/**
+ * Graph metrics of a function, compared to the ones of the signatures
+ */
+typedef struct {
+	RzAnalysisFunction *fcn;
+	int cc;
+	int nbbs;
+	int edges;
+	int ebbs;
+	ut64 size;
+} SignFcnMetrics;
+
+static void fcn_metrics(RzAnalysisFunction *fcn, SignFcnMetrics *m) {
+	m->fcn = fcn;
+	m->cc = rz_analysis_function_complexity(fcn);
+	m->nbbs = rz_list_length(fcn->bbs);
+	m->edges = rz_analysis_function_count_edges(fcn, &m->ebbs);
+	m->size = rz_analysis_function_linear_size(fcn);
+}
+
+static bool fcnMetricsCmp(RzSignItem *it, const SignFcnMetrics *m) {
 	RzSignGraph *graph = it->graph;
-	int ebbs = -1;
+	// the exit blocks are only counted along with the edges
+	int ebbs = graph->edges != -1 ? m->ebbs : -1;
 
-	if (graph->cc != -1 && graph->cc != rz_analysis_function_complexity(fcn)) {
+	if (graph->cc != -1 && graph->cc != m->cc) {
 		return false;
 	}
-	if (graph->nbbs != -1 && graph->nbbs != rz_list_length(fcn->bbs)) {
+	if (graph->nbbs != -1 && graph->nbbs != m->nbbs) {
 		return false;
 	}
-	if (graph->edges != -1 && graph->edges != rz_analysis_function_count_edges(fcn, &ebbs)) {
+	if (graph->edges != -1 && graph->edges != m->edges) {
 		return false;
 	}
 	if (graph->ebbs != -1 && graph->ebbs != ebbs) {
 		return false;
 	}
-	if (graph->bbsum > 0 && matchCount(graph->bbsum, rz_analysis_function_linear_size(fcn))) {
+	if (graph->bbsum > 0 && matchCount(graph->bbsum, m->size)) {
 		return false;
 	}
 	return true;
 }
 
-static bool graph_match(RzSignItem *it, RzSignSearchMetrics *sm) {
+static bool graph_match(RzSignItem *it, const SignFcnMetrics *metrics, RzSignSearchMetrics *sm) {
 	RzSignGraph *graph = it->graph;
 
 	if (!graph) {
@@ -2362,7 +2383,7 @@ static bool graph_match(RzSignItem *it, RzSignSearchMetrics *sm) {
 		return false;
 	}
 
-	if (!fcnMetricsCmp(it, sm->fcn)) {
+	if (!fcnMetricsCmp(it, metrics)) {
 		return false;
 	}
 
@@ -2469,6 +2490,7 @@ static bool types_match(RzSignItem *it, RzList **types, RzSignSearchMetrics *sm)
 struct metric_ctx {
 	int matched;
 	RzSignSearchMetrics *sm;
+	const SignFcnMetrics *metrics;
 	RzList *xrefs_from;
 	RzList *types;
 	RzList *vars;
@@ -2485,7 +2507,7 @@ static int match_metrics(RzSignItem *it, void *user) {
 		bool found = false;
 		switch (type) {
 		case RZ_SIGN_GRAPH:
-			found = graph_match(it, sm);
+			found = graph_match(it, ctx->metrics, sm);
 			break;
 		case RZ_SIGN_OFFSET:
 			found = addr_match(it, sm);
@@ -2514,10 +2536,361 @@ static int match_metrics(RzSignItem *it, void *user) {
 	return count ? 0 : 1;
 }
 
-RZ_API int rz_sign_fcn_match_metrics(RzSignSearchMetrics *sm) {
-	rz_return_val_if_fail(sm && sm->mincc >= 0 && sm->analysis && sm->fcn, false);
-	struct metric_ctx ctx = { 0, sm, NULL, NULL, NULL, NULL };
-	rz_sign_foreach(sm->analysis, match_metrics, (void *)&ctx);
+/**
+ * Functions to get the graph metrics of at least, in parallel
+ */
+#define SIGN_MIN_PARALLEL_FUNCTIONS 256
+
+struct rz_sign_store_t {
+	RzAnalysis *analysis;
+	RzPVector /*<RzSignItem *>*/ items; ///< of the current zign space, in the order of rz_sign_foreach()
+	HtUP /*<int, RzVector<ut32> *>*/ *by_nbbs; ///< indexes of the items with a graph, by its count of blocks
+	RzVector /*<ut32>*/ any_nbbs; ///< indexes of the items with a graph of any count of blocks
+	HtUP /*<ut64, RzVector<ut32> *>*/ *by_addr; ///< indexes of the items by their address
+	HtPP /*<char *, RzVector<ut32> *>*/ *by_bbhash; ///< indexes of the items by their bbhash
+	HtPP /*<char *, RzVector<ut32> *>*/ *by_refs; ///< indexes of the items by their joined xrefs_from
+	HtPP /*<char *, RzVector<ut32> *>*/ *by_types; ///< indexes of the items by their joined types
+	HtPP /*<char *, RzVector<ut32> *>*/ *by_vars; ///< indexes of the items by their joined vars
+	SignFcnMetrics *metrics; ///< of the functions given to rz_sign_store_prepare()
+	HtUP /*<ut64, SignFcnMetrics *>*/ *metrics_by_addr;
+};
+
+static void index_up_kv_free(HtUPKv *kv) {
+	rz_vector_free(kv->value);
+}
+
+static void index_pp_kv_free(HtPPKv *kv) {
+	free(kv->key);
+	rz_vector_free(kv->value);
+}
+
+static bool index_up_add(HtUP *ht, ut64 key, ut32 idx) {
+	RzVector *v = ht_up_find(ht, key, NULL);
+	if (!v) {
+		v = rz_vector_new(sizeof(ut32), NULL, NULL);
+		if (!v || !ht_up_insert(ht, key, v)) {
+			rz_vector_free(v);
+			return false;
+		}
+	}
+	return rz_vector_push(v, &idx);
+}
+
+static bool index_pp_add(HtPP *ht, const char *key, ut32 idx) {
+	RzVector *v = ht_pp_find(ht, key, NULL);
+	if (!v) {
+		v = rz_vector_new(sizeof(ut32), NULL, NULL);
+		if (!v || !ht_pp_insert(ht, key, v)) {
+			rz_vector_free(v);
+			return false;
+		}
+	}
+	return rz_vector_push(v, &idx);
+}
+
+static bool index_list_add(HtPP *ht, RzList *list, ut32 idx) {
+	if (!list) {
+		return true;
+	}
+	// a key only selects candidates, their lists are compared afterwards
+	char *key = rz_str_list_join(list, ",");
+	bool ret = key && index_pp_add(ht, key, idx);
+	free(key);
+	return ret;
+}
+
+static bool store_add(RzSignStore *store, RzSignItem *it) {
+	ut32 idx = rz_pvector_len(&store->items);
+	if (!rz_pvector_push(&store->items, it)) {
+		return false;
+	}
+	if (it->graph) {
+		if (it->graph->nbbs != -1) {
+			if (!index_up_add(store->by_nbbs, it->graph->nbbs, idx)) {
+				return false;
+			}
+		} else if (!rz_vector_push(&store->any_nbbs, &idx)) {
+			return false;
+		}
+	}
+	if (it->addr != UT64_MAX && !index_up_add(store->by_addr, it->addr, idx)) {
+		return false;
+	}
+	if (it->hash && RZ_STR_ISNOTEMPTY(it->hash->bbhash) && !index_pp_add(store->by_bbhash, it->hash->bbhash, idx)) {
+		return false;
+	}
+	return index_list_add(store->by_refs, it->xrefs_from, idx) &&
+		index_list_add(store->by_types, it->types, idx) &&
+		index_list_add(store->by_vars, it->vars, idx);
+}
+
+struct ctxStoreCB {
+	RzSignStore *store;
+	bool failed;
+};
+
+static bool storeCB(void *user, const char *k, const char *v) {
+	struct ctxStoreCB *ctx = (struct ctxStoreCB *)user;
+	RzAnalysis *a = ctx->store->analysis;
+	RzSignItem *it = rz_sign_item_new();
+	if (!it) {
+		ctx->failed = true;
+		return false;
+	}
+	if (!rz_sign_deserialize(a, it, k, v)) {
+		RZ_LOG_ERROR("zignature: cannot deserialize zign\n");
+		rz_sign_item_free(it);
+		return true;
+	}
+	if (it->space != rz_spaces_current(&a->zign_spaces)) {
+		rz_sign_item_free(it);
+		return true;
+	}
+	if (!store_add(ctx->store, it)) {
+		if (rz_pvector_tail(&ctx->store->items) != it) {
+			rz_sign_item_free(it);
+		}
+		ctx->failed = true;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Decodes once the zignatures of the current zign space of \p a
+ * and indexes them by their metrics, for rz_sign_store_match_metrics()
+ *
+ * The store is a snapshot: the zignatures added or removed afterwards
+ * are not seen by it.
+ */
+RZ_API RZ_OWN RzSignStore *rz_sign_store_new(RZ_NONNULL RzAnalysis *a) {
+	rz_return_val_if_fail(a, NULL);
+	RzSignStore *store = RZ_NEW0(RzSignStore);
+	if (!store) {
+		return NULL;
+	}
+	store->analysis = a;
+	rz_pvector_init(&store->items, (RzPVectorFree)rz_sign_item_free);
+	rz_vector_init(&store->any_nbbs, sizeof(ut32), NULL, NULL);
+	store->by_nbbs = ht_up_new(NULL, index_up_kv_free, NULL);
+	store->by_addr = ht_up_new(NULL, index_up_kv_free, NULL);
+	store->by_bbhash = ht_pp_new(NULL, index_pp_kv_free, NULL);
+	store->by_refs = ht_pp_new(NULL, index_pp_kv_free, NULL);
+	store->by_types = ht_pp_new(NULL, index_pp_kv_free, NULL);
+	store->by_vars = ht_pp_new(NULL, index_pp_kv_free, NULL);
+	if (!store->by_nbbs || !store->by_addr || !store->by_bbhash ||
+		!store->by_refs || !store->by_types || !store->by_vars) {
+		rz_sign_store_free(store);
+		return NULL;
+	}
+	struct ctxStoreCB ctx = { store, false };
+	sdb_foreach(a->sdb_zigns, storeCB, &ctx);
+	if (ctx.failed) {
+		rz_sign_store_free(store);
+		return NULL;
+	}
+	return store;
+}
+
+RZ_API void rz_sign_store_free(RZ_NULLABLE RzSignStore *store) {
+	if (!store) {
+		return;
+	}
+	rz_pvector_fini(&store->items);
+	rz_vector_fini(&store->any_nbbs);
+	ht_up_free(store->by_nbbs);
+	ht_up_free(store->by_addr);
+	ht_pp_free(store->by_bbhash);
+	ht_pp_free(store->by_refs);
+	ht_pp_free(store->by_types);
+	ht_pp_free(store->by_vars);
+	ht_up_free(store->metrics_by_addr);
+	free(store->metrics);
+	free(store);
+}
+
+/**
+ * \brief Returns the count of zignatures decoded by \p store
+ */
+RZ_API size_t rz_sign_store_len(RZ_NONNULL RzSignStore *store) {
+	rz_return_val_if_fail(store, 0);
+	return rz_pvector_len(&store->items);
+}
+
+typedef struct {
+	SignFcnMetrics *metrics;
+	size_t first;
+	size_t last;
+} SignMetricsShard;
+
+static void metrics_shard_compute(void *user) {
+	SignMetricsShard *shard = user;
+	for (size_t i = shard->first; i < shard->last; i++) {
+		fcn_metrics(shard->metrics[i].fcn, &shard->metrics[i]);
+	}
+}
+
+/**
+ * \brief Computes ahead the graph metrics of all the \p fcns to be matched
+ * against \p store, with up to \p max_threads threads (0 for all the cores)
+ *
+ * Only the blocks of the functions are read, each function by a single
+ * thread; they must not change until the matching is done.
+ */
+RZ_API bool rz_sign_store_prepare(RZ_NONNULL RzSignStore *store, RZ_NONNULL RzList /*<RzAnalysisFunction *>*/ *fcns, size_t max_threads) {
+	rz_return_val_if_fail(store && fcns, false);
+	ht_up_free(store->metrics_by_addr);
+	RZ_FREE(store->metrics);
+	store->metrics_by_addr = NULL;
+
+	size_t n_fcns = rz_list_length(fcns);
+	if (!n_fcns) {
+		return true;
+	}
+	store->metrics = RZ_NEWS0(SignFcnMetrics, n_fcns);
+	store->metrics_by_addr = ht_up_new(NULL, NULL, NULL);
+	if (!store->metrics || !store->metrics_by_addr) {
+		goto fail;
+	}
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	size_t i = 0;
+	rz_list_foreach (fcns, iter, fcn) {
+		store->metrics[i++].fcn = fcn;
+	}
+
+	size_t nshards;
+	RzThreadPool *pool = rz_th_pool_new_shards(max_threads, n_fcns, SIGN_MIN_PARALLEL_FUNCTIONS, &nshards);
+	const size_t per_shard = (n_fcns + nshards - 1) / nshards;
+	SignMetricsShard *shards = RZ_NEWS0(SignMetricsShard, nshards);
+	if (!shards) {
+		rz_th_pool_free(pool);
+		goto fail;
+	}
+	for (size_t t = 0; t < nshards; t++) {
+		SignMetricsShard *shard = &shards[t];
+		shard->metrics = store->metrics;
+		shard->first = RZ_MIN(n_fcns, t * per_shard);
+		shard->last = RZ_MIN(n_fcns, shard->first + per_shard);
+	}
+	rz_th_pool_run_shards(pool, shards, sizeof(SignMetricsShard), nshards, metrics_shard_compute);
+	free(shards);
+
+	for (i = 0; i < n_fcns; i++) {
+		if (!ht_up_update(store->metrics_by_addr, store->metrics[i].fcn->addr, &store->metrics[i])) {
+			goto fail;
+		}
+	}
+	return true;
+
+fail:
+	ht_up_free(store->metrics_by_addr);
+	RZ_FREE(store->metrics);
+	store->metrics_by_addr = NULL;
+	return false;
+}
+
+static void cands_add(RzVector *cands, RzVector *idxs) {
+	if (idxs && !rz_vector_empty(idxs)) {
+		rz_vector_insert_range(cands, rz_vector_len(cands), idxs->a, rz_vector_len(idxs));
+	}
+}
+
+static void cands_add_list(RzVector *cands, HtPP *ht, RzList *list) {
+	if (!list) {
+		return;
+	}
+	char *key = rz_str_list_join(list, ",");
+	if (key) {
+		cands_add(cands, ht_pp_find(ht, key, NULL));
+		free(key);
+	}
+}
+
+static int cand_cmp(const void *a, const void *b) {
+	ut32 x = *(const ut32 *)a;
+	ut32 y = *(const ut32 *)b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * \brief Matches the function of \p sm against the zignatures of \p store
+ *
+ * Only the zignatures sharing a metric with the function are compared,
+ * in the order of rz_sign_foreach(), calling \p sm->cb for each match.
+ *
+ * \return the count of matches
+ */
+RZ_API int rz_sign_store_match_metrics(RZ_NONNULL RzSignStore *store, RZ_NONNULL RzSignSearchMetrics *sm) {
+	rz_return_val_if_fail(store && sm && sm->mincc >= 0 && sm->analysis && sm->fcn, 0);
+	RzAnalysisFunction *fcn = sm->fcn;
+	SignFcnMetrics own;
+	struct metric_ctx ctx = { 0, sm, NULL, NULL, NULL, NULL, NULL };
+	RzVector cands;
+	rz_vector_init(&cands, sizeof(ut32), NULL, NULL);
+
+	RzSignType type;
+	int i = 0;
+	while ((type = sm->types[i++])) {
+		switch (type) {
+		case RZ_SIGN_GRAPH:
+			if (!ctx.metrics) {
+				SignFcnMetrics *m = store->metrics_by_addr ? ht_up_find(store->metrics_by_addr, fcn->addr, NULL) : NULL;
+				if (!m || m->fcn != fcn) {
+					fcn_metrics(fcn, &own);
+					m = &own;
+				}
+				ctx.metrics = m;
+			}
+			cands_add(&cands, ht_up_find(store->by_nbbs, ctx.metrics->nbbs, NULL));
+			cands_add(&cands, &store->any_nbbs);
+			break;
+		case RZ_SIGN_OFFSET:
+			cands_add(&cands, ht_up_find(store->by_addr, fcn->addr, NULL));
+			break;
+		case RZ_SIGN_BBHASH:
+			if (store->by_bbhash->count && !ctx.digest_hex) {
+				ctx.digest_hex = rz_sign_calc_bbhash(sm->analysis, fcn);
+				if (ctx.digest_hex) {
+					cands_add(&cands, ht_pp_find(store->by_bbhash, ctx.digest_hex, NULL));
+				}
+			}
+			break;
+		case RZ_SIGN_REFS:
+			if (store->by_refs->count && !ctx.xrefs_from) {
+				ctx.xrefs_from = rz_sign_fcn_xrefs_from(sm->analysis, fcn);
+				cands_add_list(&cands, store->by_refs, ctx.xrefs_from);
+			}
+			break;
+		case RZ_SIGN_TYPES:
+			if (store->by_types->count && !ctx.types) {
+				ctx.types = rz_sign_fcn_types(sm->analysis, fcn);
+				cands_add_list(&cands, store->by_types, ctx.types);
+			}
+			break;
+		case RZ_SIGN_VARS:
+			if (store->by_vars->count && !ctx.vars) {
+				ctx.vars = rz_sign_fcn_vars(sm->analysis, fcn);
+				cands_add_list(&cands, store->by_vars, ctx.vars);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	rz_vector_sort(&cands, cand_cmp, false);
+	ut32 *idx;
+	ut32 prev = UT32_MAX;
+	rz_vector_foreach (&cands, idx) {
+		if (*idx == prev) {
+			continue;
+		}
+		prev = *idx;
+		match_metrics(rz_pvector_at(&store->items, *idx), &ctx);
+	}
+
+	rz_vector_fini(&cands);
 	rz_list_free(ctx.xrefs_from);
 	rz_list_free(ctx.types);
 	rz_list_free(ctx.vars);
@@ -2525,6 +2898,17 @@ RZ_API int rz_sign_fcn_match_metrics(RzSignSearchMetrics *sm) {
 	return ctx.matched;
 }
 
+RZ_API int rz_sign_fcn_match_metrics(RzSignSearchMetrics *sm) {
+	rz_return_val_if_fail(sm && sm->mincc >= 0 && sm->analysis && sm->fcn, false);
+	RzSignStore *store = rz_sign_store_new(sm->analysis);
+	if (!store) {
+		return 0;
+	}
+	int matched = rz_sign_store_match_metrics(store, sm);
+	rz_sign_store_free(store);
+	return matched;
+}
+
 RZ_API RzSignItem *rz_sign_item_new(void) {
 	RzSignItem *ret = RZ_NEW0(RzSignItem);
 	if (ret) {
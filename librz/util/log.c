@@ -34,6 +34,14 @@ RZ_API void rz_log_set_traplevel(RzLogLevel level) {
 	cfg_logtraplvl = level;
 }
 
+/**
+ * \brief Returns true if the messages of \p level are output, so that
+ * callers can skip building costly messages otherwise
+ */
+RZ_API bool rz_log_level_enabled(RzLogLevel level) {
+	return level >= cfg_loglvl || level >= cfg_logtraplvl;
+}
+
 RZ_API void rz_log_set_file(const char *filename) {
 	int value_len = rz_str_nlen(filename, LOG_CONFIGSTR_SIZE) + 1;
 	strncpy(cfg_logfile, filename, value_len);
@@ -6,6 +6,19 @@
 #include <rz_util/rz_utf16.h>
 #include <rz_util/rz_utf32.h>
 #include <rz_util/rz_ebcdic.h>
+#include <rz_vector.h>
+#include <rz_th.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SCAN_SIMD_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SCAN_SIMD_NEON 1
+#endif
 
 typedef enum {
 	SKIP_STRING,
@@ -95,7 +108,8 @@ static FalsePositiveResult reduce_false_positives(const RzUtilStrScanOptions *op
 	case RZ_STRING_ENC_UTF16LE:
 	case RZ_STRING_ENC_UTF32LE:
 		num_blocks = 0;
-		block_list = rz_utf_block_list((const ut8 *)str, size - 1,
+		// a negative length would read the string up to a NUL
+		block_list = rz_utf_block_list((const ut8 *)str, RZ_MAX(size - 1, 0),
 			str_type == RZ_STRING_ENC_UTF16LE ? &freq_list : NULL);
 		if (block_list) {
 			for (i = 0; block_list[i] != -1; i++) {
@@ -256,7 +270,7 @@ static RzDetectedString *process_one_string(const ut8 *buf, const ut64 from, ut6
 		FalsePositiveResult false_positive_result = reduce_false_positives(opt, strbuf, i - 1, str_type);
 		if (false_positive_result == SKIP_STRING) {
 			return NULL;
-		} else if (false_positive_result == RETRY_ASCII) {
+		} else if (false_positive_result == RETRY_ASCII && !ascii_only) {
 			return process_one_string(buf, from, str_addr, to, str_type, true, opt, strbuf);
 		}
 
@@ -325,54 +339,306 @@ static inline bool can_be_ebcdic(ut8 *buf, ut64 size) {
 }
 
 /**
- * \brief Look for strings in an RzBuffer.
- * \param buf_to_scan Pointer to a RzBuffer to scan
- * \param list Pointer to a list that will be populated with the found strings
- * \param opt Pointer to a RzUtilStrScanOptions that specifies search parameters
- * \param from Minimum address to scan
- * \param to Maximum address to scan
- * \param type Type of strings to search
- * \return Number of strings found
+ * State of the scan between two strings: the strings found from the same state
+ * are the same, whatever the thread scanning them.
+ */
+typedef struct {
+	ut64 needle; ///< next address to look at
+	int skip_ibm037; ///< number of steps not trying IBM037, <= 0 when none
+} ScanState;
+
+static inline bool scan_state_eq(const ScanState *a, const ScanState *b) {
+	return a->needle == b->needle && RZ_MAX(a->skip_ibm037, 0) == RZ_MAX(b->skip_ibm037, 0);
+}
+
+/**
+ * \name Dead positions
  *
- * Used to look for strings in a give RzBuffer. The function can also automatically detect string types.
+ * At most of the positions of a binary no string can start, and the scan only
+ * moves to the next byte: on the control bytes, or in runs of zeros. They are
+ * found in bulk, with SSE2, AVX2 or NEON when available, before looking at the
+ * next candidate. The bytes are classified by the functions used by the scan
+ * itself, so that skipping a dead position always has the same effect.
  */
-RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrScanOptions *opt,
-	const ut64 from, const ut64 to, RzStrEnc type) {
-	rz_return_val_if_fail(opt && list && buf_to_scan, -1);
 
-	if (from == to) {
-		return 0;
+#define SCAN_CLASS_RANGES 8
+
+/**
+ * Zeros that have to follow a zero for it to be dead in RZ_STRING_ENC_GUESS:
+ * the UTF-16/32 predicates look at 7 bytes.
+ */
+#define ZERO_RUN_MIN 7
+
+/**
+ * Positions of the runes whose bytes are zero but the one at \p rune_at,
+ * which is one of \p dead.
+ */
+typedef struct {
+	bool dead[256];
+	ut8 width; ///< bytes of a rune
+	ut8 rune_at; ///< byte holding the rune
+	ut8 nranges; ///< ranges of \p dead, 0 when there are more than SCAN_CLASS_RANGES
+	ut8 lo[SCAN_CLASS_RANGES];
+	ut8 span[SCAN_CLASS_RANGES]; ///< hi - lo of each range
+} ScanClass;
+
+typedef struct {
+	ScanClass dead; ///< positions where no string starts
+	bool zero_runs; ///< the zeros followed by ZERO_RUN_MIN - 1 zeros are dead too
+	ScanClass zero;
+} ScanFilter;
+
+static bool rune_can_start_string(RzRune r) {
+	return (rz_rune_is_printable(r) && r != '\\') || (r && r < 0x100 && is_c_escape_sequence((char)r));
+}
+
+static bool utf8_byte_can_start_string(ut8 b) {
+	if (b < 0x80) {
+		return rune_can_start_string(b);
 	}
-	if (from > to) {
-		RZ_LOG_ERROR("Invalid range to find strings 0x%" PFMT64x " .. 0x%" PFMT64x "\n", from, to);
-		return -1;
+	// only the leading bytes may be decoded, as the start of a multi-byte rune
+	return (b & 0xc0) != 0x80 && b < 0xf8;
+}
+
+static void scan_class_init(ScanClass *c, ut8 width, ut8 rune_at) {
+	c->width = width;
+	c->rune_at = rune_at;
+	c->nranges = 0;
+	int b = 0;
+	while (b < 256) {
+		if (!c->dead[b]) {
+			b++;
+			continue;
+		}
+		int lo = b;
+		while (b < 256 && c->dead[b]) {
+			b++;
+		}
+		if (c->nranges == SCAN_CLASS_RANGES) {
+			c->nranges = 0;
+			return;
+		}
+		c->lo[c->nranges] = lo;
+		c->span[c->nranges] = b - 1 - lo;
+		c->nranges++;
 	}
+}
 
-	ut64 needle;
-	int count = 0;
-	RzStrEnc str_type = type;
+static bool scan_class_init_runes(ScanClass *c, int (*decode)(const ut8 *ptr, int ptrlen, RzRune *ch), ut8 width, ut8 rune_at) {
+	for (int b = 0; b < 256; b++) {
+		ut8 rune[4] = { 0 };
+		rune[rune_at] = b;
+		RzRune r = 0;
+		c->dead[b] = !decode(rune, width, &r) || !rune_can_start_string(r);
+	}
+	scan_class_init(c, width, rune_at);
+	return true;
+}
 
-	int len = to - from;
-	ut8 *buf = calloc(len, 1);
-	if (!buf) {
-		return -1;
+static bool scan_class_init_ebcdic(ScanClass *c, int (*to_unicode)(const ut8 src, RzRune *dst)) {
+	for (int b = 0; b < 256; b++) {
+		RzRune r = 0;
+		c->dead[b] = !to_unicode(b, &r) || !rune_can_start_string(r);
 	}
-	ut8 *strbuf = malloc(opt->buf_size);
-	if (!strbuf) {
-		free(buf);
-		return -1;
+	scan_class_init(c, 1, 0);
+	return true;
+}
+
+/**
+ * Fills \p f for the strings of \p type, returns false when the positions are
+ * not filtered.
+ */
+static bool scan_filter_init(ScanFilter *f, RzStrEnc type, const RzUtilStrScanOptions *opt) {
+	memset(f, 0, sizeof(*f));
+	if (!opt->min_str_length) {
+		// even the positions without rune are strings
+		return false;
 	}
+	switch (type) {
+	case RZ_STRING_ENC_GUESS:
+		// the UTF-16/32 candidates start with a zero or decode to the first byte
+		for (int b = 1; b < 256; b++) {
+			RzRune r = 0;
+			rz_str_ibm037_to_unicode(b, &r);
+			f->dead.dead[b] = !utf8_byte_can_start_string(b) && !rz_rune_is_printable(r);
+		}
+		scan_class_init(&f->dead, 1, 0);
+		f->zero_runs = true;
+		f->zero.dead[0] = true;
+		scan_class_init(&f->zero, 1, 0);
+		return true;
+	case RZ_STRING_ENC_8BIT:
+	case RZ_STRING_ENC_UTF8:
+		for (int b = 0; b < 256; b++) {
+			f->dead.dead[b] = !utf8_byte_can_start_string(b);
+		}
+		scan_class_init(&f->dead, 1, 0);
+		return true;
+	case RZ_STRING_ENC_UTF16LE:
+		return scan_class_init_runes(&f->dead, rz_utf16le_decode, 2, 0);
+	case RZ_STRING_ENC_UTF16BE:
+		return scan_class_init_runes(&f->dead, rz_utf16be_decode, 2, 1);
+	case RZ_STRING_ENC_UTF32LE:
+		return scan_class_init_runes(&f->dead, rz_utf32le_decode, 4, 0);
+	case RZ_STRING_ENC_UTF32BE:
+		return scan_class_init_runes(&f->dead, rz_utf32be_decode, 4, 3);
+	case RZ_STRING_ENC_IBM037:
+		return scan_class_init_ebcdic(&f->dead, rz_str_ibm037_to_unicode);
+	case RZ_STRING_ENC_IBM290:
+		return scan_class_init_ebcdic(&f->dead, rz_str_ibm290_to_unicode);
+	case RZ_STRING_ENC_EBCDIC_ES:
+		return scan_class_init_ebcdic(&f->dead, rz_str_ebcdic_es_to_unicode);
+	case RZ_STRING_ENC_EBCDIC_UK:
+		return scan_class_init_ebcdic(&f->dead, rz_str_ebcdic_uk_to_unicode);
+	case RZ_STRING_ENC_EBCDIC_US:
+		return scan_class_init_ebcdic(&f->dead, rz_str_ebcdic_us_to_unicode);
+	default:
+		return false;
+	}
+}
+
+static inline bool scan_class_has(const ScanClass *c, const ut8 *p) {
+	for (ut8 j = 0; j < c->width; j++) {
+		if (j != c->rune_at && p[j]) {
+			return false;
+		}
+	}
+	return c->dead[p[c->rune_at]];
+}
+
+/**
+ * Number of positions of \p c from \p p, among the \p n first ones, whose
+ * bytes are read up to p + n + c->width - 1.
+ */
+static size_t scan_class_prefix(const ScanClass *c, const ut8 *p, size_t n) {
+	size_t i = 0;
+	if (c->nranges) {
+#if SCAN_SIMD_AVX2
+		const __m256i zero = _mm256_setzero_si256();
+		for (; i + 32 <= n; i += 32) {
+			__m256i v = _mm256_loadu_si256((const __m256i *)(p + i + c->rune_at));
+			__m256i m = zero;
+			for (ut8 r = 0; r < c->nranges; r++) {
+				__m256i x = _mm256_sub_epi8(v, _mm256_set1_epi8((char)c->lo[r]));
+				m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8((char)c->span[r])), x));
+			}
+			for (ut8 j = 0; j < c->width; j++) {
+				if (j != c->rune_at) {
+					m = _mm256_and_si256(m, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + i + j)), zero));
+				}
+			}
+			if (_mm256_movemask_epi8(m) != -1) {
+				break;
+			}
+		}
+#elif SCAN_SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= n; i += 16) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(p + i + c->rune_at));
+			__m128i m = zero;
+			for (ut8 r = 0; r < c->nranges; r++) {
+				__m128i x = _mm_sub_epi8(v, _mm_set1_epi8((char)c->lo[r]));
+				m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8((char)c->span[r])), x));
+			}
+			for (ut8 j = 0; j < c->width; j++) {
+				if (j != c->rune_at) {
+					m = _mm_and_si128(m, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + j)), zero));
+				}
+			}
+			if (_mm_movemask_epi8(m) != 0xffff) {
+				break;
+			}
+		}
+#elif SCAN_SIMD_NEON
+		const uint8x16_t zero = vdupq_n_u8(0);
+		for (; i + 16 <= n; i += 16) {
+			uint8x16_t v = vld1q_u8(p + i + c->rune_at);
+			uint8x16_t m = zero;
+			for (ut8 r = 0; r < c->nranges; r++) {
+				m = vorrq_u8(m, vcleq_u8(vsubq_u8(v, vdupq_n_u8(c->lo[r])), vdupq_n_u8(c->span[r])));
+			}
+			for (ut8 j = 0; j < c->width; j++) {
+				if (j != c->rune_at) {
+					m = vandq_u8(m, vceqq_u8(vld1q_u8(p + i + j), zero));
+				}
+			}
+			if (vminvq_u8(m) != 0xff) {
+				break;
+			}
+		}
+#endif
+	}
+	// the block with a live position, or without vector instructions
+	while (i < n && scan_class_has(c, p + i)) {
+		i++;
+	}
+	return i;
+}
 
-	rz_buf_read_at(buf_to_scan, from, buf, len);
+/**
+ * Number of dead positions from \p p, among the \p n ones before the stop of
+ * the scan, \p avail bytes being readable from \p p.
+ */
+static size_t scan_filter_skip(const ScanFilter *f, const ut8 *p, size_t n, size_t avail) {
+	size_t skipped = 0;
+	while (skipped < n && avail - skipped >= f->dead.width) {
+		skipped += scan_class_prefix(&f->dead, p + skipped, RZ_MIN(n - skipped, avail - skipped - (f->dead.width - 1)));
+		if (!f->zero_runs || skipped >= n) {
+			break;
+		}
+		size_t zeros = scan_class_prefix(&f->zero, p + skipped, avail - skipped);
+		if (zeros < ZERO_RUN_MIN) {
+			break;
+		}
+		skipped += RZ_MIN(zeros - (ZERO_RUN_MIN - 1), n - skipped);
+	}
+	return skipped;
+}
 
-	needle = from;
+/**
+ * Bytes of the range being scanned, read from \p from to \p to.
+ */
+typedef struct {
+	const ut8 *buf;
+	ut64 from;
+	ut64 to;
+	RzStrEnc type;
+	const RzUtilStrScanOptions *opt;
+	const ScanFilter *filter; ///< NULL to look at every position
+} ScanWindow;
+
+/**
+ * Finds the next string starting before \p stop, from the state \p st, in
+ * the window \p w. The strings may end after \p stop, their bytes being read
+ * up to the end of the window.
+ */
+static RzDetectedString *scan_next_string(const ScanWindow *w, const ut64 stop, ut8 *strbuf, ScanState *st) {
+	const ut8 *buf = w->buf;
+	const ut64 from = w->from;
+	const ut64 to = w->to;
+	const RzStrEnc type = w->type;
+	const RzUtilStrScanOptions *opt = w->opt;
+	RzStrEnc str_type = type;
 	ut8 *ptr;
 	ut64 size;
-	int skip_ibm037 = 0;
-	while (needle < to) {
-		ptr = buf + needle - from;
+	while (st->needle < stop) {
+		if (w->filter) {
+			size_t dead = scan_filter_skip(w->filter, buf + st->needle - from, stop - st->needle, to - st->needle);
+			if (dead) {
+				// the same as looking at each of them
+				st->needle += dead;
+				if (st->skip_ibm037 > 0) {
+					st->skip_ibm037 = dead < (size_t)st->skip_ibm037 ? st->skip_ibm037 - (int)dead : 0;
+				}
+				if (st->needle >= stop) {
+					break;
+				}
+			}
+		}
+		ut64 needle = st->needle;
+		ptr = (ut8 *)buf + needle - from;
 		size = to - needle;
-		--skip_ibm037;
+		--st->skip_ibm037;
 		if (type == RZ_STRING_ENC_GUESS) {
 			if (can_be_utf32_le(ptr, size)) {
 				str_type = RZ_STRING_ENC_UTF32LE;
@@ -389,7 +655,7 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 					ut64 needle_offset = 0;
 
 					if (!ds_le && !ds_be) {
-						needle++;
+						st->needle++;
 						continue;
 					} else if (!ds_be) {
 						to_add = ds_le;
@@ -407,11 +673,9 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 						needle_offset = ds_le->size;
 					}
 
-					count++;
-					needle += needle_offset;
-					rz_list_append(list, to_add);
+					st->needle += needle_offset;
 					rz_detected_string_free(to_delete);
-					continue;
+					return to_add;
 				}
 				str_type = RZ_STRING_ENC_UTF32BE;
 			} else if (can_be_utf16_be(ptr, size)) {
@@ -425,7 +689,7 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 					ut64 needle_offset = 0;
 
 					if (!ds_le && !ds_be) {
-						needle++;
+						st->needle++;
 						continue;
 					} else if (!ds_be) {
 						to_add = ds_le;
@@ -443,14 +707,12 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 						needle_offset = ds_le->size;
 					}
 
-					count++;
-					needle += needle_offset;
-					rz_list_append(list, to_add);
+					st->needle += needle_offset;
 					rz_detected_string_free(to_delete);
-					continue;
+					return to_add;
 				}
 				str_type = RZ_STRING_ENC_UTF16BE;
-			} else if (can_be_ebcdic(ptr, size) && skip_ibm037 < 0) {
+			} else if (can_be_ebcdic(ptr, size) && st->skip_ibm037 < 0) {
 				ut8 sz = RZ_MIN(size, 15);
 				RzRune runes[15];
 				int i = 0;
@@ -464,13 +726,13 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 				if (s >= 36) {
 					str_type = RZ_STRING_ENC_IBM037;
 				} else {
-					skip_ibm037 = i + 1;
+					st->skip_ibm037 = i + 1;
 					continue;
 				}
 			} else {
 				int rc = rz_utf8_decode(ptr, size, NULL);
 				if (!rc) {
-					needle++;
+					st->needle++;
 					continue;
 				} else {
 					str_type = RZ_STRING_ENC_8BIT;
@@ -482,16 +744,280 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 
 		RzDetectedString *ds = process_one_string(buf, from, needle, to, str_type, false, opt, strbuf);
 		if (!ds) {
-			needle++;
+			st->needle++;
 			continue;
 		}
 		if (str_type == RZ_STRING_ENC_IBM037) {
-			skip_ibm037 = 0;
+			st->skip_ibm037 = 0;
 		}
 
+		st->needle += ds->size;
+		return ds;
+	}
+	return NULL;
+}
+
+/**
+ * Ranges smaller than this are not worth splitting between threads
+ */
+#define SCAN_CHUNK_MIN_SIZE 0x40000
+
+typedef struct {
+	RzDetectedString *ds;
+	ScanState after; ///< state of the scan right after the string
+} ScanHit;
+
+typedef struct {
+	const ScanWindow *win;
+	ut64 start; ///< first address of the chunk
+	ut64 stop; ///< the strings of the chunk start before it
+	RzVector /*<ScanHit>*/ hits;
+	ScanState end; ///< state of the scan leaving the chunk
+	bool failed;
+} ScanChunk;
+
+static void scan_hit_fini(void *e, void *user) {
+	ScanHit *hit = e;
+	rz_detected_string_free(hit->ds);
+}
+
+static void scan_chunk(ScanChunk *chunk) {
+	ut8 *strbuf = malloc(chunk->win->opt->buf_size);
+	if (!strbuf) {
+		chunk->failed = true;
+		return;
+	}
+	ScanState st = { chunk->start, 0 };
+	RzDetectedString *ds;
+	while ((ds = scan_next_string(chunk->win, chunk->stop, strbuf, &st))) {
+		ScanHit hit = { ds, st };
+		if (!rz_vector_push(&chunk->hits, &hit)) {
+			rz_detected_string_free(ds);
+			chunk->failed = true;
+			break;
+		}
+	}
+	chunk->end = st;
+	free(strbuf);
+}
+
+typedef struct {
+	ScanChunk *chunks;
+	size_t nchunks;
+	size_t first; ///< index of the first chunk scanned by the thread
+	size_t step; ///< number of threads
+} ScanWorker;
+
+static void scan_chunks(ScanWorker *worker) {
+	for (size_t i = worker->first; i < worker->nchunks; i += worker->step) {
+		scan_chunk(&worker->chunks[i]);
+	}
+}
+
+static RzThreadFunctionRet scan_chunks_runner(RzThread *th) {
+	scan_chunks(rz_th_get_user(th));
+	return RZ_TH_STOP;
+}
+
+/**
+ * Appends the strings of \p chunk to \p list, given \p st, the state of the
+ * sequential scan entering the chunk.
+ *
+ * A chunk is scanned from its first address, while the sequential scan may
+ * enter it in the middle of a string straddling the previous chunk. In this
+ * case the chunk is scanned again from \p st until one of its strings is found
+ * leaving the scan in the same state, from which the strings are the same.
+ */
+static int scan_chunk_merge(ScanChunk *chunk, RzList *list, ScanState *st, ut8 *strbuf) {
+	int count = 0;
+	size_t first = 0;
+	const size_t nhits = rz_vector_len(&chunk->hits);
+	const ScanState start = { chunk->start, 0 };
+	if (!scan_state_eq(st, &start)) {
+		bool synced = false;
+		size_t i = 0;
+		RzDetectedString *ds;
+		while (!synced && (ds = scan_next_string(chunk->win, chunk->stop, strbuf, st))) {
+			rz_list_append(list, ds);
+			count++;
+			ScanHit *hit = NULL;
+			while (i < nhits && (hit = rz_vector_index_ptr(&chunk->hits, i))->after.needle < st->needle) {
+				i++;
+			}
+			if (i < nhits && scan_state_eq(&hit->after, st)) {
+				first = i + 1;
+				synced = true;
+			}
+		}
+		if (!synced) {
+			// scanned again up to the end of the chunk
+			return count;
+		}
+	}
+	for (size_t i = first; i < nhits; i++) {
+		ScanHit *hit = rz_vector_index_ptr(&chunk->hits, i);
+		rz_list_append(list, hit->ds);
+		hit->ds = NULL;
 		count++;
-		rz_list_append(list, ds);
-		needle += ds->size;
+	}
+	*st = chunk->end;
+	return count;
+}
+
+/**
+ * Appends the strings starting in [st->needle, \p stop) to \p list, scanning
+ * chunks of the window in parallel. The number of chunks only depends on the
+ * options, the threads of the pool scanning them in turn.
+ */
+static int scan_window_parallel(const ScanWindow *win, const ut64 stop, RzList *list, ScanState *st, ut8 *strbuf) {
+	int count = 0;
+	const ut64 start = st->needle;
+	const size_t nchunks = RZ_MIN(win->opt->max_threads, (stop - start) / SCAN_CHUNK_MIN_SIZE);
+	ScanChunk *chunks = RZ_NEWS0(ScanChunk, nchunks);
+	ScanWorker *workers = NULL;
+	RzThreadPool *pool = rz_th_pool_new(nchunks);
+	if (!chunks || !pool) {
+		count = -1;
+		goto beach;
+	}
+	workers = RZ_NEWS0(ScanWorker, pool->size);
+	if (!workers) {
+		count = -1;
+		goto beach;
+	}
+	const ut64 chunk_size = (stop - start + nchunks - 1) / nchunks;
+	for (size_t i = 0; i < nchunks; i++) {
+		ScanChunk *chunk = &chunks[i];
+		chunk->win = win;
+		chunk->start = RZ_MIN(stop, start + i * chunk_size);
+		chunk->stop = RZ_MIN(stop, chunk->start + chunk_size);
+		rz_vector_init(&chunk->hits, sizeof(ScanHit), scan_hit_fini, NULL);
+	}
+	for (size_t t = 0; t < pool->size; t++) {
+		ScanWorker *worker = &workers[t];
+		worker->chunks = chunks;
+		worker->nchunks = nchunks;
+		worker->first = t;
+		worker->step = pool->size;
+		RzThread *th = rz_th_new(scan_chunks_runner, worker, 0);
+		if (!th || !rz_th_pool_add_thread(pool, th)) {
+			// scan these chunks from here instead
+			rz_th_free(th);
+			scan_chunks(worker);
+		}
+	}
+	rz_th_pool_wait(pool);
+
+	for (size_t i = 0; i < nchunks; i++) {
+		if (chunks[i].failed) {
+			count = -1;
+			goto beach;
+		}
+	}
+	for (size_t i = 0; i < nchunks; i++) {
+		count += scan_chunk_merge(&chunks[i], list, st, strbuf);
+	}
+
+beach:
+	rz_th_pool_free(pool);
+	if (chunks) {
+		for (size_t i = 0; i < nchunks; i++) {
+			rz_vector_fini(&chunks[i].hits);
+		}
+	}
+	free(chunks);
+	free(workers);
+	return count;
+}
+
+/**
+ * Bytes scanned at once, per thread
+ */
+#define SCAN_WINDOW_SIZE 0x100000
+
+/**
+ * Bytes read before a window, for the byte order marks
+ */
+#define SCAN_WINDOW_BEHIND 4
+
+/**
+ * Bytes read after a window, enough for the strings starting in it: the first
+ * rune may be 3 bytes after the needle, and each rune takes at most 4 bytes.
+ */
+static inline ut64 scan_window_ahead(const RzUtilStrScanOptions *opt) {
+	return 4 * (ut64)opt->buf_size + 32;
+}
+
+/**
+ * \brief Look for strings in an RzBuffer.
+ * \param buf_to_scan Pointer to a RzBuffer to scan
+ * \param list Pointer to a list that will be populated with the found strings
+ * \param opt Pointer to a RzUtilStrScanOptions that specifies search parameters
+ * \param from Minimum address to scan
+ * \param to Maximum address to scan
+ * \param type Type of strings to search
+ * \return Number of strings found
+ *
+ * Used to look for strings in a give RzBuffer. The function can also automatically detect string types.
+ * The range is read by windows, the strings starting in one of them being read after its end.
+ * When \p opt allows several threads, the windows are split in chunks scanned in parallel,
+ * the strings found being the same, in the same order, as when scanning the range sequentially.
+ */
+RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrScanOptions *opt,
+	const ut64 from, const ut64 to, RzStrEnc type) {
+	rz_return_val_if_fail(opt && list && buf_to_scan, -1);
+
+	if (from == to) {
+		return 0;
+	}
+	if (from > to) {
+		RZ_LOG_ERROR("Invalid range to find strings 0x%" PFMT64x " .. 0x%" PFMT64x "\n", from, to);
+		return -1;
+	}
+
+	const size_t nthreads = RZ_MAX(opt->max_threads, 1);
+	const ut64 window_size = nthreads * SCAN_WINDOW_SIZE;
+	const ut64 ahead = scan_window_ahead(opt);
+	const ut64 buf_size = RZ_MIN(to - from, SCAN_WINDOW_BEHIND + window_size + ahead);
+	ut8 *buf = malloc(buf_size);
+	ut8 *strbuf = malloc(opt->buf_size);
+	if (!buf || !strbuf) {
+		free(buf);
+		free(strbuf);
+		return -1;
+	}
+
+	ScanFilter filter;
+	ScanWindow win = {
+		.buf = buf,
+		.type = type,
+		.opt = opt,
+		.filter = scan_filter_init(&filter, type, opt) ? &filter : NULL
+	};
+	int count = 0;
+	ScanState st = { from, 0 };
+	while (st.needle < to) {
+		const ut64 stop = st.needle + RZ_MIN(to - st.needle, window_size);
+		win.from = st.needle - RZ_MIN(st.needle - from, SCAN_WINDOW_BEHIND);
+		win.to = stop + RZ_MIN(to - stop, ahead);
+		st64 read = rz_buf_read_at(buf_to_scan, win.from, buf, win.to - win.from);
+		// the bytes that cannot be read are zeros
+		read = RZ_MAX(read, 0);
+		memset(buf + read, 0, win.to - win.from - read);
+		if (nthreads > 1 && stop - st.needle >= 2 * SCAN_CHUNK_MIN_SIZE) {
+			int n = scan_window_parallel(&win, stop, list, &st, strbuf);
+			if (n < 0) {
+				count = -1;
+				break;
+			}
+			count += n;
+			continue;
+		}
+		RzDetectedString *ds;
+		while ((ds = scan_next_string(&win, stop, strbuf, &st))) {
+			count++;
+			rz_list_append(list, ds);
+		}
 	}
 	free(buf);
 	free(strbuf);
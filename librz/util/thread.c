@@ -514,6 +514,73 @@ RZ_API bool rz_th_pool_kill_free(RZ_NONNULL RzThreadPool *pool) {
 	return has_exited;
 }
 
+/**
+ * \brief Returns a pool to split \p n_jobs jobs between, with up to
+ * \p max_threads threads (0 for all the cores)
+ *
+ * \param min_parallel jobs below which they are not worth a thread,
+ * NULL being returned
+ * \param n_shards set to the count of shards to split the jobs in: the
+ * size of the pool, or 1 to run them from the calling thread
+ * \return the pool, to give to rz_th_pool_run_shards()
+ */
+RZ_API RZ_OWN RzThreadPool *rz_th_pool_new_shards(size_t max_threads, size_t n_jobs, size_t min_parallel, RZ_NONNULL RZ_OUT size_t *n_shards) {
+	rz_return_val_if_fail(n_shards, NULL);
+	size_t nthreads = rz_th_physical_core_number();
+	if (max_threads) {
+		nthreads = RZ_MIN(nthreads, max_threads);
+	}
+	RzThreadPool *pool = NULL;
+	if (nthreads > 1 && n_jobs >= min_parallel) {
+		pool = rz_th_pool_new(nthreads);
+	}
+	*n_shards = pool ? pool->size : 1;
+	return pool;
+}
+
+typedef struct {
+	RzThreadShardFunction fcn;
+	void *shard;
+} ThreadShard;
+
+static RzThreadFunctionRet thread_shard_runner(RzThread *th) {
+	ThreadShard *ts = rz_th_get_user(th);
+	ts->fcn(ts->shard);
+	return RZ_TH_STOP;
+}
+
+/**
+ * \brief Calls \p fcn with each of the \p n_shards shards of
+ * \p shard_size bytes at \p shards, each from a thread of \p pool, then
+ * waits for them and frees \p pool
+ *
+ * The shards left without a thread, all of them without \p pool, are run
+ * from the calling thread.
+ */
+RZ_API void rz_th_pool_run_shards(RZ_NULLABLE RZ_OWN RzThreadPool *pool, RZ_NONNULL void *shards, size_t shard_size, size_t n_shards, RZ_NONNULL RzThreadShardFunction fcn) {
+	rz_return_if_fail(shards && fcn);
+	ThreadShard *ts = pool ? RZ_NEWS(ThreadShard, n_shards) : NULL;
+	for (size_t t = 0; t < n_shards; t++) {
+		void *shard = (ut8 *)shards + t * shard_size;
+		RzThread *th = NULL;
+		if (ts) {
+			ts[t].fcn = fcn;
+			ts[t].shard = shard;
+			th = rz_th_new(thread_shard_runner, &ts[t], 0);
+		}
+		if (!th || !rz_th_pool_add_thread(pool, th)) {
+			// run this shard from here instead
+			rz_th_free(th);
+			fcn(shard);
+		}
+	}
+	if (pool) {
+		rz_th_pool_wait(pool);
+		rz_th_pool_free(pool);
+	}
+	free(ts);
+}
+
 /**
  * \brief Returns user pointer of thread
  *
@@ -16,6 +16,7 @@
 #define RZ_TH_LOCK_T CRITICAL_SECTION
 #define RZ_TH_COND_T CONDITION_VARIABLE
 #define RZ_TH_SEM_T  HANDLE
+#define RZ_TH_KEY_T  DWORD
 // HANDLE
 
 #elif HAVE_PTHREAD
@@ -43,6 +44,7 @@
 #define RZ_TH_LOCK_T pthread_mutex_t
 #define RZ_TH_COND_T pthread_cond_t
 #define RZ_TH_SEM_T  sem_t *
+#define RZ_TH_KEY_T  pthread_key_t
 
 #else
 #error Threading library only supported for pthread and w32
@@ -64,6 +66,10 @@ struct rz_th_cond_t {
 	RZ_TH_COND_T cond;
 };
 
+struct rz_th_local_t {
+	RZ_TH_KEY_T key;
+};
+
 struct rz_th_t {
 	RZ_TH_TID tid;
 	RzThreadLock *lock;
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "thread.h"
+
+/* thread local storage */
+
+/**
+ * \brief Creates a new slot holding one value for each thread
+ *
+ * \p destructor, when given, is called on the value of a thread when the
+ * thread exits. It is never called by rz_th_local_free() and it is not
+ * called at all on Windows, so the owner of the values must also be able
+ * to release them on its own.
+ */
+RZ_API RZ_OWN RzThreadLocal *rz_th_local_new(RZ_NULLABLE RzThreadLocalFree destructor) {
+	RzThreadLocal *tl = RZ_NEW0(RzThreadLocal);
+	if (!tl) {
+		return NULL;
+	}
+#if __WINDOWS__
+	tl->key = TlsAlloc();
+	if (tl->key == TLS_OUT_OF_INDEXES) {
+		free(tl);
+		return NULL;
+	}
+#elif HAVE_PTHREAD
+	if (pthread_key_create(&tl->key, destructor)) {
+		free(tl);
+		return NULL;
+	}
+#endif
+	return tl;
+}
+
+/**
+ * \brief Frees the slot, the values of the threads are left untouched
+ */
+RZ_API void rz_th_local_free(RZ_NULLABLE RzThreadLocal *tl) {
+	if (!tl) {
+		return;
+	}
+#if __WINDOWS__
+	TlsFree(tl->key);
+#elif HAVE_PTHREAD
+	pthread_key_delete(tl->key);
+#endif
+	free(tl);
+}
+
+/**
+ * \brief Returns the value of the calling thread, NULL when it was never set
+ */
+RZ_API void *rz_th_local_get(RZ_NONNULL RzThreadLocal *tl) {
+	rz_return_val_if_fail(tl, NULL);
+#if __WINDOWS__
+	return TlsGetValue(tl->key);
+#elif HAVE_PTHREAD
+	return pthread_getspecific(tl->key);
+#endif
+}
+
+/**
+ * \brief Sets the value of the calling thread
+ */
+RZ_API bool rz_th_local_set(RZ_NONNULL RzThreadLocal *tl, RZ_NULLABLE void *value) {
+	rz_return_val_if_fail(tl, false);
+#if __WINDOWS__
+	return TlsSetValue(tl->key, value);
+#elif HAVE_PTHREAD
+	return !pthread_setspecific(tl->key, value);
+#endif
+}
@@ -0,0 +1,428 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file trace_store.c
+ * Compact, append-only store of execution traces.
+ *
+ * The records are appended to chunks of TRACE_STORE_CHUNK_SIZE bytes, each
+ * one starting with the little endian ut32 count of its bytes used and being
+ * decodable on its own. A record starts with a byte telling its kind:
+ *
+ * - 0x80 | d: pc, being the previous one plus d (0 <= d < 0x80)
+ * - TRACE_STORE_PC, zigzag uleb128 delta: pc, being the previous one plus delta
+ * - TRACE_STORE_REG, uleb128 reg, uleb128 value: register write
+ * - TRACE_STORE_MEM, uleb128 addr, uleb128 size, size bytes: memory write
+ *
+ * The pc is relative to the previous one of the same chunk, or to 0 for the
+ * first one. The full chunks are either kept in memory or written to a
+ * mmapped spill file, which is removed when the store is freed.
+ */
+
+#include <rz_util.h>
+#include <ht_uu.h>
+
+#define TRACE_STORE_CHUNK_SIZE 0x10000
+#define TRACE_STORE_HEADER_SIZE 4
+#define TRACE_STORE_MAX_MEM    0x100 ///< bytes of a single memory record at most
+#define TRACE_STORE_MAX_LEB    10
+#define TRACE_STORE_MAX_RECORD (1 + 2 * TRACE_STORE_MAX_LEB + TRACE_STORE_MAX_MEM)
+
+enum {
+	TRACE_STORE_PC = 1,
+	TRACE_STORE_REG,
+	TRACE_STORE_MEM,
+};
+
+struct rz_trace_store_t {
+	ut8 *chunk; ///< chunk being filled
+	ut32 used; ///< bytes used by the chunk being filled, header included
+	ut64 pc; ///< last pc added to the chunk being filled
+	RzPVector /*<ut8 *>*/ chunks; ///< full chunks kept in memory, after the spilled ones
+	char *spill; ///< path of the spill file, NULL when not spilling
+	RzMmap *map; ///< spill file
+	ut64 spilled; ///< full chunks in the spill file
+	HtUU /*<ut64, ut64>*/ *hits; ///< by pc
+	ut64 steps; ///< pc records
+	ut64 size; ///< bytes of the records
+};
+
+/**
+ * \brief Creates an empty trace store
+ *
+ * \param spill path of a file to write the full chunks to instead of keeping
+ * them in memory, being truncated now and removed by rz_trace_store_free()
+ */
+RZ_API RZ_OWN RzTraceStore *rz_trace_store_new(RZ_NULLABLE const char *spill) {
+	RzTraceStore *store = RZ_NEW0(RzTraceStore);
+	if (!store) {
+		return NULL;
+	}
+	rz_pvector_init(&store->chunks, free);
+	store->chunk = malloc(TRACE_STORE_CHUNK_SIZE);
+	store->hits = ht_uu_new0();
+	if (!store->chunk || !store->hits) {
+		rz_trace_store_free(store);
+		return NULL;
+	}
+	store->used = TRACE_STORE_HEADER_SIZE;
+	if (RZ_STR_ISNOTEMPTY(spill)) {
+		if (!rz_file_dump(spill, NULL, 0, false)) {
+			RZ_LOG_ERROR("Cannot create the trace spill file %s, keeping the trace in memory\n", spill);
+		} else {
+			store->spill = strdup(spill);
+		}
+	}
+	return store;
+}
+
+RZ_API void rz_trace_store_free(RZ_NULLABLE RzTraceStore *store) {
+	if (!store) {
+		return;
+	}
+	rz_file_mmap_free(store->map);
+	if (store->spill) {
+		rz_file_rm(store->spill);
+		free(store->spill);
+	}
+	rz_pvector_fini(&store->chunks);
+	ht_uu_free(store->hits);
+	free(store->chunk);
+	free(store);
+}
+
+/**
+ * Maps the spill file of \p store with at least \p need bytes, doubling it
+ * to keep the remaps few. The spilled chunks are lost if it cannot be mapped
+ * again.
+ */
+static bool spill_reserve(RzTraceStore *store, ut64 need) {
+	if (store->map && store->map->len >= need) {
+		return true;
+	}
+	ut64 len = store->map ? store->map->len : 0;
+	rz_file_mmap_free(store->map);
+	store->map = NULL;
+	ut64 newlen = RZ_MAX(len * 2, need);
+	if (rz_file_truncate(store->spill, newlen)) {
+		store->map = rz_file_mmap(store->spill, O_RDWR, 0644, 0);
+		if (store->map && store->map->len >= need) {
+			return true;
+		}
+		rz_file_mmap_free(store->map);
+		store->map = NULL;
+	}
+	RZ_LOG_ERROR("Cannot grow the trace spill file %s, keeping the trace in memory\n", store->spill);
+	if (len) {
+		store->map = rz_file_mmap(store->spill, O_RDWR, 0644, 0);
+		if (!store->map) {
+			RZ_LOG_ERROR("Cannot map the trace spill file %s again, its chunks are lost\n", store->spill);
+		}
+	}
+	return false;
+}
+
+/**
+ * Closes the chunk being filled, either spilling it or keeping it in the
+ * memory, and starts a new one.
+ */
+static bool chunk_flush(RzTraceStore *store) {
+	rz_write_le32(store->chunk, store->used);
+	if (store->spill && rz_pvector_empty(&store->chunks) &&
+		spill_reserve(store, (store->spilled + 1) * TRACE_STORE_CHUNK_SIZE)) {
+		memcpy(store->map->buf + store->spilled * TRACE_STORE_CHUNK_SIZE, store->chunk, store->used);
+		store->spilled++;
+	} else {
+		if (!rz_pvector_push(&store->chunks, store->chunk)) {
+			return false;
+		}
+		store->chunk = malloc(TRACE_STORE_CHUNK_SIZE);
+		if (!store->chunk) {
+			store->chunk = rz_pvector_pop(&store->chunks);
+			return false;
+		}
+	}
+	store->used = TRACE_STORE_HEADER_SIZE;
+	store->pc = 0;
+	return true;
+}
+
+/**
+ * Returns where \p size more bytes can be written in the chunk being filled
+ */
+static ut8 *chunk_reserve(RzTraceStore *store, ut32 size) {
+	if (store->used + size > TRACE_STORE_CHUNK_SIZE && !chunk_flush(store)) {
+		return NULL;
+	}
+	return store->chunk + store->used;
+}
+
+static ut32 write_uleb(ut8 *p, ut64 v) {
+	ut32 n = 0;
+	do {
+		ut8 b = v & 0x7f;
+		v >>= 7;
+		p[n++] = b | (v ? 0x80 : 0);
+	} while (v);
+	return n;
+}
+
+static void commit(RzTraceStore *store, ut32 size) {
+	store->used += size;
+	store->size += size;
+}
+
+/**
+ * \brief Appends to \p store the execution of the instruction at \p pc
+ */
+RZ_API bool rz_trace_store_add_pc(RZ_NONNULL RzTraceStore *store, ut64 pc) {
+	rz_return_val_if_fail(store, false);
+	ut8 *p = chunk_reserve(store, 1 + TRACE_STORE_MAX_LEB);
+	if (!p) {
+		return false;
+	}
+	ut64 delta = pc - store->pc;
+	ut32 n;
+	if (delta < 0x80) {
+		p[0] = 0x80 | delta;
+		n = 1;
+	} else {
+		st64 sdelta = (st64)delta;
+		p[0] = TRACE_STORE_PC;
+		n = 1 + write_uleb(p + 1, ((ut64)sdelta << 1) ^ (ut64)(sdelta >> 63));
+	}
+	commit(store, n);
+	store->pc = pc;
+	store->steps++;
+	bool found = false;
+	ut64 hits = ht_uu_find(store->hits, pc, &found);
+	ht_uu_update(store->hits, pc, found ? hits + 1 : 1);
+	return true;
+}
+
+/**
+ * \brief Appends to \p store the write of \p value to the register \p reg,
+ * its meaning being up to the caller
+ */
+RZ_API bool rz_trace_store_add_reg(RZ_NONNULL RzTraceStore *store, ut64 reg, ut64 value) {
+	rz_return_val_if_fail(store, false);
+	ut8 *p = chunk_reserve(store, 1 + 2 * TRACE_STORE_MAX_LEB);
+	if (!p) {
+		return false;
+	}
+	p[0] = TRACE_STORE_REG;
+	ut32 n = 1 + write_uleb(p + 1, reg);
+	n += write_uleb(p + n, value);
+	commit(store, n);
+	return true;
+}
+
+/**
+ * \brief Appends to \p store the write of the \p size bytes of \p data at \p addr,
+ * being split in several records when large
+ */
+RZ_API bool rz_trace_store_add_mem(RZ_NONNULL RzTraceStore *store, ut64 addr, RZ_NONNULL const ut8 *data, ut32 size) {
+	rz_return_val_if_fail(store && data, false);
+	do {
+		ut32 len = RZ_MIN(size, TRACE_STORE_MAX_MEM);
+		ut8 *p = chunk_reserve(store, TRACE_STORE_MAX_RECORD);
+		if (!p) {
+			return false;
+		}
+		p[0] = TRACE_STORE_MEM;
+		ut32 n = 1 + write_uleb(p + 1, addr);
+		n += write_uleb(p + n, len);
+		memcpy(p + n, data, len);
+		commit(store, n + len);
+		addr += len;
+		data += len;
+		size -= len;
+	} while (size);
+	return true;
+}
+
+/**
+ * \brief Returns the instructions executed in \p store
+ */
+RZ_API ut64 rz_trace_store_steps(RZ_NONNULL const RzTraceStore *store) {
+	rz_return_val_if_fail(store, 0);
+	return store->steps;
+}
+
+/**
+ * \brief Returns the bytes taken by the records of \p store
+ */
+RZ_API ut64 rz_trace_store_size(RZ_NONNULL const RzTraceStore *store) {
+	rz_return_val_if_fail(store, 0);
+	return store->size;
+}
+
+/**
+ * \brief Returns how many times the instruction at \p pc was executed in \p store
+ */
+RZ_API ut64 rz_trace_store_hits(RZ_NONNULL const RzTraceStore *store, ut64 pc) {
+	rz_return_val_if_fail(store, 0);
+	return ht_uu_find(store->hits, pc, NULL);
+}
+
+typedef struct {
+	ut64 addr;
+	ut64 hits;
+} TraceStoreHit;
+
+static bool collect_hit(void *user, const ut64 addr, const ut64 hits) {
+	TraceStoreHit hit = { addr, hits };
+	rz_vector_push(user, &hit);
+	return true;
+}
+
+static int hit_cmp(const void *a, const void *b) {
+	const TraceStoreHit *ha = a, *hb = b;
+	return ha->addr < hb->addr ? -1 : ha->addr > hb->addr;
+}
+
+/**
+ * \brief Calls \p cb with every address executed in \p store and its hits,
+ * in increasing address order, until it returns false
+ *
+ * \return false if \p cb stopped the iteration or on allocation failure
+ */
+RZ_API bool rz_trace_store_coverage(RZ_NONNULL const RzTraceStore *store, RZ_NONNULL RzTraceStoreHitCb cb, void *user) {
+	rz_return_val_if_fail(store && cb, false);
+	RzVector hits;
+	rz_vector_init(&hits, sizeof(TraceStoreHit), NULL, NULL);
+	if (!rz_vector_reserve(&hits, store->hits->count)) {
+		return false;
+	}
+	ht_uu_foreach(store->hits, collect_hit, &hits);
+	rz_vector_sort(&hits, hit_cmp, false);
+	bool ret = true;
+	TraceStoreHit *hit;
+	rz_vector_foreach(&hits, hit) {
+		if (!cb(user, hit->addr, hit->hits)) {
+			ret = false;
+			break;
+		}
+	}
+	rz_vector_fini(&hits);
+	return ret;
+}
+
+static bool next_pc(RzTraceStoreReader *reader, ut64 *pc) {
+	RzTraceStoreRecord record;
+	while (rz_trace_store_reader_next(reader, &record)) {
+		if (record.type == RZ_TRACE_STORE_PC) {
+			*pc = record.addr;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * \brief Compares the instructions executed in \p a and \p b
+ *
+ * \return the index of the first instruction differing, or being executed in
+ * only one of them, UT64_MAX if they executed the same ones
+ */
+RZ_API ut64 rz_trace_store_diff(RZ_NONNULL const RzTraceStore *a, RZ_NONNULL const RzTraceStore *b) {
+	rz_return_val_if_fail(a && b, UT64_MAX);
+	RzTraceStoreReader ra, rb;
+	rz_trace_store_reader_init(&ra, a);
+	rz_trace_store_reader_init(&rb, b);
+	for (ut64 step = 0;; step++) {
+		ut64 pa, pb;
+		bool ha = next_pc(&ra, &pa);
+		bool hb = next_pc(&rb, &pb);
+		if (!ha && !hb) {
+			return UT64_MAX;
+		}
+		if (ha != hb || pa != pb) {
+			return step;
+		}
+	}
+}
+
+/**
+ * \brief Starts reading the records of \p store from the first one
+ */
+RZ_API void rz_trace_store_reader_init(RZ_NONNULL RzTraceStoreReader *reader, RZ_NONNULL const RzTraceStore *store) {
+	rz_return_if_fail(reader && store);
+	reader->store = store;
+	reader->chunk = 0;
+	reader->off = TRACE_STORE_HEADER_SIZE;
+	reader->pc = 0;
+}
+
+/**
+ * Returns the chunk \p idx of \p store and the bytes it uses in \p used,
+ * NULL past the chunk being filled
+ */
+static const ut8 *chunk_at(const RzTraceStore *store, ut64 idx, ut32 *used) {
+	const ut8 *chunk;
+	if (idx < store->spilled) {
+		if (!store->map) {
+			return NULL;
+		}
+		chunk = store->map->buf + idx * TRACE_STORE_CHUNK_SIZE;
+	} else if (idx - store->spilled < rz_pvector_len(&store->chunks)) {
+		chunk = rz_pvector_at(&store->chunks, idx - store->spilled);
+	} else if (idx - store->spilled == rz_pvector_len(&store->chunks)) {
+		*used = store->used;
+		return store->chunk;
+	} else {
+		return NULL;
+	}
+	*used = rz_read_le32(chunk);
+	return chunk;
+}
+
+/**
+ * \brief Reads the next record of \p reader into \p record
+ *
+ * \return false once all the records were read
+ */
+RZ_API bool rz_trace_store_reader_next(RZ_NONNULL RzTraceStoreReader *reader, RZ_NONNULL RZ_OUT RzTraceStoreRecord *record) {
+	rz_return_val_if_fail(reader && record, false);
+	ut32 used;
+	const ut8 *chunk = chunk_at(reader->store, reader->chunk, &used);
+	while (chunk && reader->off >= used) {
+		reader->chunk++;
+		reader->off = TRACE_STORE_HEADER_SIZE;
+		reader->pc = 0;
+		chunk = chunk_at(reader->store, reader->chunk, &used);
+	}
+	if (!chunk) {
+		return false;
+	}
+	const ut8 *p = chunk + reader->off;
+	const ut8 *end = chunk + used;
+	memset(record, 0, sizeof(*record));
+	ut8 kind = *p++;
+	ut64 v;
+	if (kind & 0x80) {
+		record->type = RZ_TRACE_STORE_PC;
+		record->addr = reader->pc += kind & 0x7f;
+	} else if (kind == TRACE_STORE_PC) {
+		p += read_u64_leb128(p, end, &v);
+		record->type = RZ_TRACE_STORE_PC;
+		record->addr = reader->pc += (v >> 1) ^ -(v & 1);
+	} else if (kind == TRACE_STORE_REG) {
+		record->type = RZ_TRACE_STORE_REG;
+		p += read_u64_leb128(p, end, &record->reg);
+		p += read_u64_leb128(p, end, &record->value);
+	} else if (kind == TRACE_STORE_MEM) {
+		record->type = RZ_TRACE_STORE_MEM;
+		p += read_u64_leb128(p, end, &record->addr);
+		p += read_u64_leb128(p, end, &v);
+		record->size = RZ_MIN(v, end - p);
+		record->data = p;
+		p += record->size;
+	} else {
+		// corrupted, e.g. a truncated spill file
+		reader->chunk = UT64_MAX;
+		return false;
+	}
+	reader->off = p - chunk;
+	return true;
+}
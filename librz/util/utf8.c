@@ -759,7 +759,7 @@ RZ_API int *rz_utf_block_list(const ut8 *str, int len, int **freq_list) {
 	if (len < 0) {
 		len = strlen((const char *)str);
 	}
-	static int block_freq[rz_utf_blocks_count] = { 0 };
+	int block_freq[rz_utf_blocks_count] = { 0 };
 	int *list = RZ_NEWS(int, len + 1);
 	if (!list) {
 		return NULL;
@@ -801,9 +801,6 @@ RZ_API int *rz_utf_block_list(const ut8 *str, int len, int **freq_list) {
 		}
 		*freq_list_ptr = -1;
 	}
-	for (list_ptr = list; *list_ptr != -1; list_ptr++) {
-		block_freq[*list_ptr] = 0;
-	}
 	return list;
 }
 
@@ -188,6 +188,7 @@ typedef struct libgdbr_t {
 	bool server_debug;
 	bool get_baddr;
 	libgdbr_stop_reason_t stop_reason;
+	ut32 mem_epoch; // bumped whenever the memory of the target may have changed
 
 	RzThreadLock *gdbr_lock;
 	int gdbr_lock_depth; // current depth inside the recursive lock
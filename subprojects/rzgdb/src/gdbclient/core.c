@@ -290,6 +290,7 @@ int gdbr_disconnect(libgdbr_t *g) {
 	}
 	reg_cache.valid = false;
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	free(reg_cache.buf);
 	if (g->target.valid) {
 		free(g->target.regprofile);
@@ -317,6 +318,7 @@ int gdbr_select(libgdbr_t *g, int pid, int tid) {
 		goto end;
 	}
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	if (send_msg(g, cmd) < 0 || read_packet(g, false) < 0 || send_ack(g) < 0) {
 		ret = -1;
 		goto end;
@@ -410,6 +412,7 @@ int gdbr_check_extended_mode(libgdbr_t *g) {
 		goto end;
 	}
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	reg_cache.valid = false;
 	// Activate extended mode if possible.
 	ret = send_msg(g, "!");
@@ -449,6 +452,7 @@ int gdbr_attach(libgdbr_t *g, int pid) {
 		goto end;
 	}
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	reg_cache.valid = false;
 
 	if (g->stub_features.extended_mode == -1) {
@@ -505,6 +509,7 @@ int gdbr_detach(libgdbr_t *g) {
 
 	reg_cache.valid = false;
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	ret = send_msg(g, "D");
 	if (ret < 0) {
 		ret = -1;
@@ -532,6 +537,7 @@ int gdbr_detach_pid(libgdbr_t *g, int pid) {
 
 	reg_cache.valid = false;
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 
 	buffer_size = strlen(CMD_DETACH_MP) + (sizeof(pid) * 2) + 1;
 	cmd = calloc(buffer_size, sizeof(char));
@@ -582,6 +588,7 @@ int gdbr_kill(libgdbr_t *g) {
 
 	reg_cache.valid = false;
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 
 	if (g->stub_features.multiprocess) {
 		if (g->pid <= 0) {
@@ -617,6 +624,7 @@ int gdbr_kill_pid(libgdbr_t *g, int pid) {
 
 	reg_cache.valid = false;
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 
 	buffer_size = strlen(CMD_KILL_MP) + (sizeof(pid) * 2) + 1;
 	cmd = calloc(buffer_size, sizeof(char));
@@ -879,6 +887,7 @@ int gdbr_write_memory(libgdbr_t *g, ut64 address, const uint8_t *data, ut64 len)
 	if (!gdbr_lock_enter(g)) {
 		goto end;
 	}
+	g->mem_epoch++;
 
 	for (pkt = num_pkts - 1; pkt >= 0; pkt--) {
 		if ((command_len = snprintf(tmp, max_cmd_len,
@@ -1273,6 +1282,7 @@ int send_vcont(libgdbr_t *g, const char *command, const char *thread_id) {
 	}
 	reg_cache.valid = false;
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	ret = send_msg(g, tmp);
 	if (ret < 0) {
 		goto end;
@@ -1340,6 +1350,7 @@ int set_bp(libgdbr_t *g, ut64 address, const char *conditions, enum Breakpoint t
 	}
 
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	if ((ret = send_msg(g, tmp)) < 0) {
 		goto end;
 	}
@@ -1429,6 +1440,7 @@ int remove_bp(libgdbr_t *g, ut64 address, enum Breakpoint type, int sizebp) {
 	}
 
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	if ((ret = send_msg(g, tmp)) < 0) {
 		goto end;
 	}
@@ -1589,6 +1601,7 @@ int gdbr_send_qRcmd(libgdbr_t *g, const char *cmd, PrintfCallback cb_printf) {
 		goto end;
 	}
 	g->stop_reason.is_valid = false;
+	g->mem_epoch++;
 	reg_cache.valid = false;
 	pack_hex(cmd, strlen(cmd), buf + 6);
 	if ((ret = send_msg(g, buf)) < 0) {
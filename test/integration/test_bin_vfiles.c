@@ -26,6 +26,7 @@ bool test_bin_vfiles() {
 	mu_assert_notnull(patched, "patched vfile");
 
 	// 3. Find an interesting reloc by an import name
+	rz_bin_object_load_item(bf->o, RZ_BIN_OBJECT_ITEM_RELOCS);
 	mu_assert_notnull(bf->o->relocs, "relocs");
 	RzBinReloc *reloc = NULL;
 	for (size_t i = 0; i < bf->o->relocs->relocs_count; i++) {
@@ -70,8 +70,66 @@ bool test_open_analyse_save() {
 	mu_end;
 }
 
+bool test_open_analyse_save_binary() {
+	RzCore *core = rz_core_new();
+	mu_assert_notnull(core, "new RzCore instance");
+	const char *fpath = "bins/elf/ls";
+	RzCoreFile *file = rz_core_file_open(core, fpath, RZ_PERM_R, 0);
+	mu_assert_notnull(file, "open file");
+	rz_core_bin_load(core, fpath, 0);
+	rz_core_analysis_all(core);
+
+	RzList *functions = rz_analysis_function_list(core->analysis);
+	mu_assert_notnull(functions, "export functions list");
+	size_t functions_count_expect = rz_list_length(functions);
+	ut64 xrefs_count_expect = rz_analysis_xrefs_count(core->analysis);
+	mu_assert_true(xrefs_count_expect > 0, "xrefs");
+
+	if (!rz_file_is_directory(".tmp" RZ_SYS_DIR)) {
+		mu_assert_true(rz_sys_mkdir(".tmp/"), "create tmp directory");
+	}
+	const char *prj_file = ".tmp/test_open_analyse_bin.rzdb";
+	rz_file_rm(prj_file);
+	rz_config_set_b(core->config, "prj.binary", true);
+	RzProjectErr err = rz_project_save_file(core, prj_file, false);
+	mu_assert_eq(err, RZ_PROJECT_ERR_SUCCESS, "project save err");
+	mu_assert_true(rz_project_is_bin_file(prj_file), "binary project");
+
+	// saving again without changes only writes a new table
+	ut64 size = rz_file_size(prj_file);
+	err = rz_project_save_file(core, prj_file, false);
+	mu_assert_eq(err, RZ_PROJECT_ERR_SUCCESS, "project save again err");
+	mu_assert_true(rz_file_size(prj_file) < size * 2, "unchanged sections kept");
+
+	rz_core_file_close(file);
+	rz_core_free(core);
+
+	core = rz_core_new();
+	mu_assert_notnull(core, "new RzCore instance");
+	RzSerializeResultInfo *res = rz_serialize_result_info_new();
+	mu_assert_notnull(res, "result info new");
+	err = rz_project_load_file(core, prj_file, true, res);
+	mu_assert_eq(err, RZ_PROJECT_ERR_SUCCESS, "project load err");
+	RzList *functions_load = rz_analysis_function_list(core->analysis);
+	mu_assert_notnull(functions_load, "export functions list");
+	mu_assert_eq(rz_list_length(functions_load), functions_count_expect, "compare functions list");
+	mu_assert_eq(rz_analysis_xrefs_count(core->analysis), xrefs_count_expect, "compare xrefs");
+	rz_serialize_result_info_free(res);
+	rz_core_free(core);
+
+	// exported back to sdb, the xrefs are JSON again
+	RzProject *prj = rz_project_load_file_raw(prj_file);
+	mu_assert_notnull(prj, "load raw");
+	Sdb *xrefs_db = sdb_ns_path(prj, "core/analysis/xrefs", false);
+	mu_assert_notnull(xrefs_db, "xrefs namespace");
+	mu_assert_true(sdb_count(xrefs_db) > 0, "xrefs in sdb");
+	rz_project_free(prj);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_open_analyse_save);
+	mu_run_test(test_open_analyse_save_binary);
 	return tests_passed != tests_run;
 }
 
@@ -287,6 +287,12 @@ int tests_run = 0;
 int tests_passed = 0;
 int mu_test_status = MU_TEST_UNBROKEN;
 
+// Advances \p seed and returns it, giving the same data on every run to reproduce the failures
+static inline ut32 mu_rand(ut32 *seed) {
+	*seed = *seed * 1103515245 + 12345;
+	return *seed;
+}
+
 #define mu_main(fcn) \
 	int main(int argc, char **argv) { \
 		return fcn(); \
@@ -102,8 +102,81 @@ bool test_graph_to_agraph() {
 	mu_end;
 }
 
+/**
+ * Synthetic control flow graph of \p n_blocks blocks, with fallthroughs,
+ * forward jumps and loops
+ */
+static RzAGraph *synthetic_cfg(RzAGraphLayoutCache *cache, int n_blocks) {
+	RzAGraph *g = rz_agraph_new(rz_cons_canvas_new(1, 1));
+	if (!g) {
+		return NULL;
+	}
+	g->crossing = RZ_AGRAPH_CROSSING_BARYCENTER;
+	g->layout_cache = cache;
+	RzANode **blocks = RZ_NEWS0(RzANode *, n_blocks);
+	int i;
+	for (i = 0; i < n_blocks; i++) {
+		char title[32];
+		snprintf(title, sizeof(title), "0x%x", 0x1000 + i * 0x10);
+		blocks[i] = rz_agraph_add_node(g, title, "mov eax, ebx\njmp 0x1000");
+	}
+	ut32 seed = 1;
+	for (i = 0; i < n_blocks; i++) {
+		mu_rand(&seed);
+		if (i + 1 < n_blocks && seed % 7) {
+			rz_agraph_add_edge(g, blocks[i], blocks[i + 1]);
+		}
+		if (seed % 3 == 0) {
+			rz_agraph_add_edge(g, blocks[i], blocks[RZ_MIN(n_blocks - 1, i + 2 + (seed >> 8) % 64)]);
+		}
+		if (seed % 17 == 0) {
+			rz_agraph_add_edge(g, blocks[i], blocks[RZ_MAX(0, i - 1 - (int)((seed >> 8) % 32))]);
+		}
+	}
+	free(blocks);
+	return g;
+}
+
+bool test_agraph_large_layout() {
+	const int n_blocks = 1000;
+	RzCore *core = rz_core_new();
+	RzAGraphLayoutCache *cache = rz_agraph_layout_cache_new();
+	mu_assert_notnull(cache, "layout cache");
+
+	RzAGraph *a = synthetic_cfg(cache, n_blocks);
+	rz_agraph_get_sdb(a);
+
+	// the same graph again takes the order of the first layout
+	RzAGraph *b = synthetic_cfg(cache, n_blocks);
+	rz_agraph_get_sdb(b);
+
+	int i;
+	for (i = 0; i < n_blocks; i += 97) {
+		char title[32];
+		snprintf(title, sizeof(title), "0x%x", 0x1000 + i * 0x10);
+		RzANode *na = rz_agraph_get_node(a, title);
+		RzANode *nb = rz_agraph_get_node(b, title);
+		mu_assert("nodes laid out", na && nb);
+		mu_assert_eq(nb->x, na->x, "same x from the cache");
+		mu_assert_eq(nb->y, na->y, "same y from the cache");
+	}
+
+	// a changed graph starts from the previous order
+	RzANode *extra = rz_agraph_add_node(b, "0xdead", "nop");
+	rz_agraph_add_edge(b, rz_agraph_get_node(b, "0x1000"), extra);
+	rz_agraph_get_sdb(b);
+	mu_assert("new node laid out", extra->layer >= 0);
+
+	rz_agraph_free(a);
+	rz_agraph_free(b);
+	rz_agraph_layout_cache_free(cache);
+	rz_core_free(core);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_graph_to_agraph);
+	mu_run_test(test_agraph_large_layout);
 	return tests_passed != tests_run;
 }
 
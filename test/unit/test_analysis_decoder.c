@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include <rz_th.h>
+#include "minunit.h"
+
+#define CODE_SIZE 0x10000
+#define THREADS   4
+
+typedef struct {
+	RzAnalysis *analysis;
+	const ut8 *code;
+	ut64 *sizes; ///< size and type of the op at each offset
+} DecodeJob;
+
+static ut8 code[CODE_SIZE];
+
+static void code_init(void) {
+	// push rbp; mov rbp, rsp; mov eax, [rbp-4]; call $+5; jmp $+2; lea rax, [rip+0x10]; ret; nop
+	static const ut8 pattern[] = {
+		0x55, 0x48, 0x89, 0xe5, 0x8b, 0x45, 0xfc, 0xe8, 0x00, 0x00, 0x00, 0x00,
+		0xeb, 0x00, 0x48, 0x8d, 0x05, 0x10, 0x00, 0x00, 0x00, 0xc3, 0x90
+	};
+	ut32 seed = 0x1337;
+	for (size_t i = 0; i < sizeof(code); i++) {
+		mu_rand(&seed);
+		// mostly valid code, with some noise to hit invalid and odd instructions
+		code[i] = (seed >> 16) % 7 ? pattern[i % sizeof(pattern)] : seed >> 24;
+	}
+}
+
+static void decode_all(RzAnalysis *analysis, const ut8 *buf, ut64 *sizes) {
+	RzAnalysisOp op = { 0 };
+	for (int i = 0; i < CODE_SIZE; i++) {
+		int ret = rz_analysis_op(analysis, &op, 0x1000 + i, buf + i, CODE_SIZE - i, RZ_ANALYSIS_OP_MASK_BASIC);
+		sizes[i] = ((ut64)op.type << 32) | (ut32)ret;
+		rz_analysis_op_fini(&op);
+	}
+}
+
+static RzThreadFunctionRet decode_th(RzThread *th) {
+	DecodeJob *job = rz_th_get_user(th);
+	decode_all(job->analysis, job->code, job->sizes);
+	return RZ_TH_STOP;
+}
+
+bool test_analysis_decoder_threads(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	rz_analysis_use(analysis, "x86");
+	rz_analysis_set_bits(analysis, 64);
+	mu_assert_notnull(rz_analysis_decoder(analysis), "x86 decodes with per-thread contexts");
+	mu_assert_ptreq(rz_analysis_decoder(analysis), rz_analysis_decoder(analysis), "same context in the same thread");
+
+	ut64 *expect = RZ_NEWS0(ut64, CODE_SIZE);
+	decode_all(analysis, code, expect);
+
+	DecodeJob jobs[THREADS] = { 0 };
+	RzThread *threads[THREADS] = { 0 };
+	for (int t = 0; t < THREADS; t++) {
+		jobs[t].analysis = analysis;
+		jobs[t].code = code;
+		jobs[t].sizes = RZ_NEWS0(ut64, CODE_SIZE);
+		threads[t] = rz_th_new(decode_th, &jobs[t], 0);
+		mu_assert_notnull(threads[t], "thread");
+	}
+	for (int t = 0; t < THREADS; t++) {
+		rz_th_wait(threads[t]);
+		rz_th_free(threads[t]);
+	}
+
+	for (int t = 0; t < THREADS; t++) {
+		mu_assert_memeq((ut8 *)jobs[t].sizes, (ut8 *)expect, CODE_SIZE * sizeof(ut64), "same ops from every thread");
+		free(jobs[t].sizes);
+	}
+
+	// switching plugin drops the contexts of all the threads
+	rz_analysis_use(analysis, "arm");
+	rz_analysis_set_bits(analysis, 32);
+	mu_assert_notnull(rz_analysis_decoder(analysis), "arm decodes with per-thread contexts");
+	free(expect);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_analysis_decoder_none(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	mu_assert_null(rz_analysis_decoder(analysis), "no plugin, no context");
+	rz_analysis_use(analysis, "null");
+	mu_assert_null(rz_analysis_decoder(analysis), "plugin without decoding contexts");
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+int all_tests() {
+	code_init();
+	mu_run_test(test_analysis_decoder_threads);
+	mu_run_test(test_analysis_decoder_none);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include "minunit.h"
+
+#define FUNCTIONS 200
+
+static RzAnalysisFunction *fcn_new(RzAnalysis *analysis, const char *name, ut64 addr, const ut8 *fingerprint, size_t size) {
+	RzAnalysisFunction *fcn = rz_analysis_function_new(analysis);
+	fcn->name = strdup(name);
+	fcn->addr = addr;
+	fcn->type = RZ_ANALYSIS_FCN_TYPE_FCN;
+	fcn->fingerprint = rz_mem_dup(fingerprint, size);
+	fcn->fingerprint_size = size;
+	return fcn;
+}
+
+/**
+ * Makes \p fcns1 with random fingerprints and \p fcns2 with mutated copies of
+ * them in another order, all with different names but for the first one.
+ */
+static void fcns_setup(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
+	ut32 seed = 0x1337;
+	size_t order[FUNCTIONS];
+	for (size_t i = 0; i < FUNCTIONS; i++) {
+		order[i] = i;
+	}
+	for (size_t i = FUNCTIONS - 1; i > 0; i--) {
+		size_t j = (mu_rand(&seed) >> 8) % (i + 1);
+		size_t tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+	RzAnalysisFunction *copies[FUNCTIONS];
+	ut8 buf[256];
+	char name[32];
+	for (size_t i = 0; i < FUNCTIONS; i++) {
+		size_t size = 64 + (mu_rand(&seed) >> 8) % (sizeof(buf) - 64);
+		for (size_t j = 0; j < size; j++) {
+			buf[j] = mu_rand(&seed) >> 8;
+		}
+		snprintf(name, sizeof(name), i ? "fcn.a%" PFMTSZu : "main", i);
+		rz_list_append(fcns1, fcn_new(analysis, name, 0x1000 + i * 0x100, buf, size));
+		// a third of the copies are identical, the other ones have some bytes changed
+		for (size_t j = 0; i % 3 && j < size / 16; j++) {
+			buf[(mu_rand(&seed) >> 8) % size] = mu_rand(&seed) >> 8;
+		}
+		snprintf(name, sizeof(name), i ? "fcn.b%" PFMTSZu : "main", i);
+		copies[i] = fcn_new(analysis, name, 0x100000 + i * 0x100, buf, size);
+	}
+	for (size_t i = 0; i < FUNCTIONS; i++) {
+		rz_list_append(fcns2, copies[order[i]]);
+	}
+}
+
+static bool fcns_diff(RzAnalysis *analysis, int candidates, RzAnalysisDiffStats *stats, ut64 *pairs) {
+	RzList *fcns1 = rz_list_newf(rz_analysis_function_free);
+	RzList *fcns2 = rz_list_newf(rz_analysis_function_free);
+	fcns_setup(analysis, fcns1, fcns2);
+	analysis->diff_candidates = candidates;
+	mu_assert_true(rz_analysis_diff_functions(analysis, fcns1, fcns2, stats), "diff");
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	size_t i = 0;
+	rz_list_foreach (fcns1, iter, fcn) {
+		pairs[i++] = fcn->diff->addr;
+	}
+	rz_list_free(fcns1);
+	rz_list_free(fcns2);
+	mu_end;
+}
+
+bool test_analysis_diff_functions(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisDiffStats exhaustive, indexed;
+	ut64 pairs[FUNCTIONS], indexed_pairs[FUNCTIONS];
+	mu_assert_true(fcns_diff(analysis, 0, &exhaustive, pairs), "exhaustive diff");
+	mu_assert_true(fcns_diff(analysis, RZ_ANALYSIS_DIFF_CANDIDATES, &indexed, indexed_pairs), "indexed diff");
+
+	for (size_t i = 0; i < FUNCTIONS; i++) {
+		mu_assert_eq(pairs[i], 0x100000 + i * 0x100, "exhaustive pair");
+	}
+	mu_assert_memeq((ut8 *)indexed_pairs, (ut8 *)pairs, sizeof(pairs), "same pairs");
+	mu_assert_eq(exhaustive.by_name, 1, "paired by name");
+	mu_assert_eq(exhaustive.similar, FUNCTIONS - 1, "paired by similarity");
+	mu_assert_eq(indexed.by_name, 1, "paired by name");
+	mu_assert_eq(indexed.exact, (FUNCTIONS - 1) / 3, "identical pairs");
+	mu_assert_eq(indexed.similar, FUNCTIONS - 1 - (FUNCTIONS - 1) / 3, "paired by similarity");
+	mu_assert_true(indexed.compared * 4 < exhaustive.compared, "fewer comparisons");
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_analysis_diff_functions);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -0,0 +1,262 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include "minunit.h"
+
+#define MEM_SIZE 0x100
+
+static const char *reg_profile =
+	"=PC	pc\n"
+	"=SP	sp\n"
+	"=BP	bp\n"
+	"gpr	pc	.64	0	0\n"
+	"gpr	sp	.64	8	0\n"
+	"gpr	bp	.64	16	0\n"
+	"gpr	a	.64	24	0\n"
+	"gpr	b	.64	32	0\n"
+	"gpr	c	.32	40	0\n"
+	"gpr	d	.8	44	0\n"
+	"gpr	zf	.1	.368	0\n"
+	"gpr	cf	.1	.369	0\n"
+	"gpr	sf	.1	.370	0\n"
+	"gpr	of	.1	.371	0\n";
+
+static const char *regs[] = { "pc", "sp", "bp", "a", "b", "c", "d", "zf", "cf", "sf", "of" };
+
+// Expressions run by both the string path and the bytecode
+static const char *exprs[] = {
+	"a,b,=",
+	"0x10,a,+=,a,b,-=",
+	"1,a,+,b,=,0xff,b,&,c,=",
+	"a,b,^,$z,zf,:=",
+	"3,a,-=,64,$c,cf,:=,63,$b,cf,:=,63,$s,sf,:=,64,$o,of,:=",
+	"c,d,=,d,c,*=,2,c,/=,7,c,%=",
+	"1,a,<<,b,=,3,b,>>,c,=,2,a,>>>>,d,=",
+	"b,a,==,$z,?{,1,c,=,}{,2,c,=,}",
+	"a,a,==,$z,?{,1,c,=,}{,2,c,=,}",
+	"0,?{,0,?{,5,c,=,}{,6,c,=,},}{,7,c,=,},8,d,=",
+	"1,?{,0,?{,5,c,=,}{,6,c,=,},}{,7,c,=,},8,d,=",
+	"a,8,*,0x20,+,[8],b,=",
+	"b,0x40,=[4],0x40,[4],c,=,0x42,[1],d,=",
+	"0x1122334455667788,0x80,=[8],0x80,[2],c,=",
+	"a,DUP,+,b,=,1,2,SWAP,-,c,=",
+	"1,2,3,POP,+,d,=",
+	"a,b,c,CLEAR,1,d,=",
+	"1,a,=,BREAK,2,a,=",
+	"5,c,=,TODO,6,c,=",
+	"0,c,=,c,1,+,c,=,c,4,>,?{,10,GOTO,},0,GOTO,d,=",
+	"0,c,=,c,2,+,c,=,c,9,>,?{,BREAK,},3,GOTO",
+	"1,c,+=,5,c,<,?{,0,GOTO,}",
+	"0,GOTO",
+	"42,GOTO,1,a,=",
+	"unknown,a,=",
+	"a,unknownreg,=",
+	",1,a,=",
+	"1,a,=,",
+	"a,!,b,=,a,~,c,=",
+	"$$,a,=,$$,4,+,pc,=",
+	"0x80,a,=,a,[8],b,=,1,a,-=,a,[1],c,=",
+	"4,a,=,1,a,-=,a,?{,1,b,+=,0,GOTO,}",
+	"-1,a,=,a,b,<,c,=,a,b,<=,d,=",
+	"0,b,=,a,b,/,c,=",
+	"0,c,=,1,c,+=,c,5,>,?{,3,GOTO,}",
+	"3,c,=,a,b,+=,1,c,-=,c,?{,3,GOTO,}",
+};
+
+typedef struct {
+	ut8 mem[MEM_SIZE];
+	RzStrBuf log; ///< every register and memory write
+} EsilState;
+
+static int mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int len) {
+	EsilState *st = esil->user;
+	for (int i = 0; i < len; i++) {
+		buf[i] = st->mem[(addr + i) % MEM_SIZE];
+	}
+	return len;
+}
+
+static int mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf, int len) {
+	EsilState *st = esil->user;
+	rz_strbuf_appendf(&st->log, "[0x%" PFMT64x "]%d ", addr, len);
+	for (int i = 0; i < len; i++) {
+		st->mem[(addr + i) % MEM_SIZE] = buf[i];
+	}
+	return len;
+}
+
+static int reg_write(RzAnalysisEsil *esil, const char *name, ut64 *val) {
+	EsilState *st = esil->user;
+	rz_strbuf_appendf(&st->log, "%s=0x%" PFMT64x " ", name, *val);
+	return 0;
+}
+
+static void state_reset(RzAnalysisEsil *esil, EsilState *st) {
+	rz_analysis_esil_stack_free(esil);
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(regs); i++) {
+		rz_reg_setv(esil->analysis->reg, regs[i], 0x1234567890ull * (i + 1));
+	}
+	rz_reg_setv(esil->analysis->reg, "a", 0x11);
+	rz_reg_setv(esil->analysis->reg, "b", 0x22);
+	rz_reg_setv(esil->analysis->reg, "zf", 0);
+	rz_reg_setv(esil->analysis->reg, "cf", 0);
+	for (size_t i = 0; i < MEM_SIZE; i++) {
+		st->mem[i] = i * 7;
+	}
+	rz_strbuf_fini(&st->log);
+	rz_strbuf_init(&st->log);
+	esil->trap = esil->trap_code = 0;
+	esil->address = 0x1000;
+}
+
+// Everything the expression can change
+static char *state_dump(RzAnalysisEsil *esil, EsilState *st, bool ret) {
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	rz_strbuf_appendf(sb, "ret=%d trap=%d/%u log=%s\n", ret, esil->trap, esil->trap_code, rz_strbuf_get(&st->log));
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(regs); i++) {
+		rz_strbuf_appendf(sb, "%s=0x%" PFMT64x " ", regs[i], rz_reg_getv(esil->analysis->reg, regs[i]));
+	}
+	rz_strbuf_appendf(sb, "\nstack:");
+	for (int i = 0; i < esil->stackptr; i++) {
+		rz_strbuf_appendf(sb, " %s", esil->stack[i]);
+	}
+	rz_strbuf_append(sb, "\nmem: ");
+	char *hex = rz_hex_bin2strdup(st->mem, MEM_SIZE);
+	rz_strbuf_append(sb, hex);
+	free(hex);
+	return rz_strbuf_drain(sb);
+}
+
+static RzAnalysisEsil *esil_new(RzAnalysis *analysis, EsilState *st) {
+	rz_reg_set_profile_string(analysis->reg, reg_profile);
+	RzAnalysisEsil *esil = rz_analysis_esil_new(32, 0, 64);
+	rz_analysis_esil_setup(esil, analysis, 0, 0, 0);
+	esil->cb.mem_read = mem_read;
+	esil->cb.mem_write = mem_write;
+	esil->cb.hook_reg_write = reg_write;
+	esil->user = st;
+	rz_strbuf_init(&st->log);
+	return esil;
+}
+
+bool test_analysis_esil_bytecode_same_as_string(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	EsilState st = { 0 };
+	RzAnalysisEsil *esil = esil_new(analysis, &st);
+	rz_analysis_esil_bytecode_enable(esil, true);
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(exprs); i++) {
+		state_reset(esil, &st);
+		bool ret = rz_analysis_esil_parse(esil, exprs[i]);
+		char *expect = state_dump(esil, &st, ret);
+
+		RzAnalysisEsilCode *code = rz_analysis_esil_compile(esil, exprs[i]);
+		mu_assert_notnull(code, exprs[i]);
+		state_reset(esil, &st);
+		ret = rz_analysis_esil_run(esil, code);
+		char *actual = state_dump(esil, &st, ret);
+		mu_assert_streq(actual, expect, exprs[i]);
+		free(actual);
+		rz_analysis_esil_code_free(code);
+
+		// twice from the cache
+		for (int j = 0; j < 2; j++) {
+			state_reset(esil, &st);
+			ret = rz_analysis_esil_parse_at(esil, 0x1000 + i, exprs[i]);
+			actual = state_dump(esil, &st, ret);
+			mu_assert_streq(actual, expect, exprs[i]);
+			free(actual);
+		}
+		free(expect);
+	}
+	rz_analysis_esil_stack_free(esil);
+	rz_strbuf_fini(&st.log);
+	rz_analysis_esil_free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_analysis_esil_bytecode_fallback(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	EsilState st = { 0 };
+	RzAnalysisEsil *esil = esil_new(analysis, &st);
+	mu_assert_null(rz_analysis_esil_compile(esil, "1,a,=;2,b,="), "';' is left to the string path");
+	mu_assert_null(rz_analysis_esil_compile(esil, "1,,a,="), "empty words are left to the string path");
+	mu_assert_null(rz_analysis_esil_compile(esil, "1,a,=,#!pd 1"), "commands are left to the string path");
+
+	rz_analysis_esil_bytecode_enable(esil, true);
+	state_reset(esil, &st);
+	mu_assert_true(rz_analysis_esil_parse_at(esil, 0x1000, "3,a,="), "parse");
+	mu_assert_eq(rz_reg_getv(analysis->reg, "a"), 3, "compiled");
+	mu_assert_false(rz_analysis_esil_parse_at(esil, 0x1000, "4,a,=;5,a,="), "parse");
+	mu_assert_eq(rz_reg_getv(analysis->reg, "a"), 4, "same address, other expression, string path");
+	mu_assert_true(rz_analysis_esil_parse_at(esil, 0x1000, "6,a,="), "parse");
+	mu_assert_eq(rz_reg_getv(analysis->reg, "a"), 6, "same address, other expression, compiled");
+	rz_analysis_esil_stack_free(esil);
+	rz_strbuf_fini(&st.log);
+	rz_analysis_esil_free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+static bool esil_answer(RzAnalysisEsil *esil) {
+	return rz_analysis_esil_pushnum(esil, 42);
+}
+
+bool test_analysis_esil_bytecode_new_op(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	EsilState st = { 0 };
+	RzAnalysisEsil *esil = esil_new(analysis, &st);
+	rz_analysis_esil_bytecode_enable(esil, true);
+	state_reset(esil, &st);
+	rz_analysis_esil_parse_at(esil, 0x1000, "ANSWER,a,=");
+	mu_assert_eq(rz_reg_getv(analysis->reg, "a"), 0x11, "ANSWER is not a register");
+	rz_analysis_esil_set_op(esil, "ANSWER", esil_answer, 1, 0, RZ_ANALYSIS_ESIL_OP_TYPE_UNKNOWN);
+	state_reset(esil, &st);
+	rz_analysis_esil_parse_at(esil, 0x1000, "ANSWER,a,=");
+	mu_assert_eq(rz_reg_getv(analysis->reg, "a"), 42, "compiled again with the new operation");
+	rz_analysis_esil_stack_free(esil);
+	rz_strbuf_fini(&st.log);
+	rz_analysis_esil_free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_analysis_esil_bytecode_speed(void) {
+	static const char *expr = "0x10,sp,-=,bp,sp,=[8],sp,bp,=,0x20,bp,-,[4],a,=,a,b,^=,$z,zf,:=,63,$c,cf,:=";
+	RzAnalysis *analysis = rz_analysis_new();
+	EsilState st = { 0 };
+	RzAnalysisEsil *esil = esil_new(analysis, &st);
+	esil->cb.hook_reg_write = NULL;
+	RzAnalysisEsilCode *code = rz_analysis_esil_compile(esil, expr);
+	mu_assert_notnull(code, "compiled");
+	const int rounds = 20000;
+	ut64 start = rz_time_now_mono();
+	for (int i = 0; i < rounds; i++) {
+		rz_analysis_esil_parse(esil, expr);
+		rz_analysis_esil_stack_free(esil);
+	}
+	ut64 string_time = rz_time_now_mono() - start;
+	start = rz_time_now_mono();
+	for (int i = 0; i < rounds; i++) {
+		rz_analysis_esil_run(esil, code);
+		rz_analysis_esil_stack_free(esil);
+	}
+	ut64 code_time = rz_time_now_mono() - start;
+	printf("esil: %" PFMT64u " us parsing, %" PFMT64u " us running the bytecode for %d expressions\n", string_time, code_time, rounds);
+	rz_analysis_esil_code_free(code);
+	rz_strbuf_fini(&st.log);
+	rz_analysis_esil_free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_analysis_esil_bytecode_same_as_string);
+	mu_run_test(test_analysis_esil_bytecode_fallback);
+	mu_run_test(test_analysis_esil_bytecode_new_op);
+	mu_run_test(test_analysis_esil_bytecode_speed);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
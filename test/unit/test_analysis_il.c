@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include "minunit.h"
+
+static bool bf_step(RzCore *core, ut64 pc) {
+	RzAnalysisILVM *vm = core->analysis->il_vm;
+	rz_bv_set_from_ut64(vm->vm->pc, pc);
+	mu_assert_eq(rz_analysis_il_vm_step(core->analysis, vm, NULL), RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS, "stepped");
+	mu_assert_eq(rz_bv_to_ut64(vm->vm->pc), pc + 1, "next instruction");
+	mu_end;
+}
+
+bool test_analysis_il_code_cache_self_write(void) {
+	RzCore *core = rz_core_new();
+	rz_config_set_b(core->config, "rzil.compile", true);
+	rz_config_set(core->config, "asm.arch", "bf");
+	rz_io_open(core->io, "malloc://0x100", RZ_PERM_RW, 0);
+	rz_io_write_at(core->io, 0, (const ut8 *)"+", 1);
+	mu_assert_true(rz_analysis_il_vm_setup(core->analysis), "vm");
+	RzAnalysisILVM *vm = core->analysis->il_vm;
+	mu_assert_notnull(vm->code_cache, "code cache");
+	rz_il_vm_set_global_var(vm->vm, "ptr", rz_il_value_new_bitv(rz_bv_new_from_ut64(64, 0x80)));
+	mu_assert_true(bf_step(core, 0), "data write");
+	mu_assert_eq(vm->code_cache->count, 1, "cached");
+
+	// the cached `+` increments itself into a `,`, dropping its own code from the cache while it runs
+	rz_il_vm_set_global_var(vm->vm, "ptr", rz_il_value_new_bitv(rz_bv_new_from_ut64(64, 0)));
+	mu_assert_true(bf_step(core, 0), "self write");
+	ut8 b = 0;
+	rz_io_read_at(core->io, 0, &b, 1);
+	mu_assert_eq(b, ',', "overwritten");
+	mu_assert_eq(vm->code_cache->count, 0, "dropped");
+
+	// and the same right after it is lifted
+	rz_io_write_at(core->io, 0, (const ut8 *)"+", 1);
+	mu_assert_true(bf_step(core, 0), "self write");
+	rz_io_read_at(core->io, 0, &b, 1);
+	mu_assert_eq(b, ',', "overwritten");
+	mu_assert_eq(vm->code_cache->count, 0, "dropped");
+	rz_core_free(core);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_analysis_il_code_cache_self_write);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -96,8 +96,64 @@ bool test_rz_analysis_op_val() {
 	mu_end;
 }
 
+bool test_rz_analysis_op_cache() {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisOp op;
+	SWITCH_TO_ARCH_BITS("x86", 64);
+	const RzAnalysisOpMask mask = RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_ESIL | RZ_ANALYSIS_OP_MASK_DISASM | RZ_ANALYSIS_OP_MASK_HINT;
+	// mov rax, [rbx+rcx+4]
+	ut8 code[] = { 0x48, 0x8b, 0x44, 0x0b, 0x04, 0x90, 0x90 };
+	rz_analysis_op(analysis, &op, 0x100, code, sizeof(code), mask);
+	char *mnemonic = strdup(op.mnemonic);
+	char *esil = strdup(rz_strbuf_get(&op.esil));
+	rz_analysis_op_fini(&op);
+
+	mu_assert_true(rz_analysis_op_cache_set_size(analysis, 64), "cache enabled");
+	for (int i = 0; i < 2; i++) {
+		// decoded, then from the cache
+		int len = rz_analysis_op(analysis, &op, 0x100, code, sizeof(code), mask);
+		mu_assert_eq(len, 5, "Op is of size 5");
+		mu_assert_streq(op.mnemonic, mnemonic, "mnemonic");
+		mu_assert_streq(rz_strbuf_get(&op.esil), esil, "esil");
+		mu_assert_eq(op.src[0]->type, RZ_ANALYSIS_VAL_MEM, "Source should be mem");
+		mu_assert_streq(op.src[0]->regdelta->name, "rcx", "Source reg delta should be rcx");
+		mu_assert_eq(op.addr, 0x100, "addr");
+		rz_analysis_op_fini(&op);
+	}
+	free(mnemonic);
+	free(esil);
+
+	// the hints of the address are honored
+	rz_analysis_hint_set_type(analysis, 0x100, RZ_ANALYSIS_OP_TYPE_NOP);
+	rz_analysis_op(analysis, &op, 0x100, code, sizeof(code), mask);
+	mu_assert_eq(op.type, RZ_ANALYSIS_OP_TYPE_NOP, "hinted type");
+	rz_analysis_op_fini(&op);
+	rz_analysis_hint_unset_type(analysis, 0x100);
+	rz_analysis_op(analysis, &op, 0x100, code, sizeof(code), mask);
+	mu_assert_eq(op.type, RZ_ANALYSIS_OP_TYPE_MOV, "type without hint");
+	rz_analysis_op_fini(&op);
+
+	// so are the bytes and the bits
+	code[0] = 0x90;
+	int len = rz_analysis_op(analysis, &op, 0x100, code, sizeof(code), mask);
+	mu_assert_eq(len, 1, "nop after a write");
+	mu_assert_eq(op.type, RZ_ANALYSIS_OP_TYPE_NOP, "nop after a write");
+	rz_analysis_op_fini(&op);
+	code[0] = 0x48;
+	rz_analysis_set_bits(analysis, 32);
+	len = rz_analysis_op(analysis, &op, 0x100, code, sizeof(code), mask);
+	mu_assert_eq(len, 1, "dec eax in 32 bits");
+	rz_analysis_op_fini(&op);
+
+	mu_assert_true(rz_analysis_op_cache_set_size(analysis, 0), "cache disabled");
+	mu_assert_null(analysis->op_cache, "cache disabled");
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_analysis_op_val);
+	mu_run_test(test_rz_analysis_op_cache);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_bin.h>
+#include "minunit.h"
+
+static int imports_calls;
+static int symbols_calls;
+static int strings_calls;
+
+static bool check_buffer(RzBuffer *b) {
+	return true;
+}
+
+static bool load_buffer(RzBinFile *bf, RzBinObject *obj, RzBuffer *buf, Sdb *sdb) {
+	return true;
+}
+
+static RzBinInfo *info(RzBinFile *bf) {
+	RzBinInfo *ret = RZ_NEW0(RzBinInfo);
+	if (!ret) {
+		return NULL;
+	}
+	ret->file = strdup(bf->file);
+	ret->has_va = 1;
+	return ret;
+}
+
+static RzList *imports(RzBinFile *bf) {
+	imports_calls++;
+	RzList *ret = rz_list_newf((RzListFree)rz_bin_import_free);
+	RzBinImport *imp = RZ_NEW0(RzBinImport);
+	imp->name = strdup("puts");
+	rz_list_push(ret, imp);
+	return ret;
+}
+
+static RzList *symbols(RzBinFile *bf) {
+	symbols_calls++;
+	RzList *ret = rz_list_newf((RzListFree)rz_bin_symbol_free);
+	RzBinSymbol *sym = rz_bin_symbol_new("main", 0x10, 0x1010);
+	rz_list_push(ret, sym);
+	sym = rz_bin_symbol_new("puts", 0x20, 0x1020);
+	sym->is_imported = true;
+	rz_list_push(ret, sym);
+	return ret;
+}
+
+static RzList *strings(RzBinFile *bf) {
+	strings_calls++;
+	RzList *ret = rz_list_newf(rz_bin_string_free);
+	RzBinString *str = RZ_NEW0(RzBinString);
+	str->string = strdup("Hello");
+	str->paddr = 0x30;
+	str->vaddr = 0x1030;
+	rz_list_push(ret, str);
+	return ret;
+}
+
+static void class_free(RzBinClass *c) {
+	free(c->name);
+	free(c->super);
+	rz_list_free(c->methods);
+	rz_list_free(c->fields);
+	free(c);
+}
+
+static RzList *classes(RzBinFile *bf) {
+	RzList *ret = rz_list_newf((RzListFree)class_free);
+	RzBinClass *c = RZ_NEW0(RzBinClass);
+	c->name = strdup("Foo");
+	c->methods = rz_list_newf((RzListFree)rz_bin_symbol_free);
+	c->fields = rz_list_newf((RzListFree)rz_bin_field_free);
+	rz_list_push(c->methods, rz_bin_symbol_new("bar", 0x40, 0x1040));
+	rz_list_push(ret, c);
+	return ret;
+}
+
+static RzBinPlugin mock_plugin = {
+	.name = "mock",
+	.desc = "Testing Plugin",
+	.license = "LGPL3",
+	.load_buffer = load_buffer,
+	.check_buffer = check_buffer,
+	.info = info,
+	.imports = imports,
+	.symbols = symbols,
+	.strings = strings,
+	.classes = classes,
+};
+
+bool test_bin_object_lazy_items(void) {
+	imports_calls = symbols_calls = strings_calls = 0;
+	RzBin *bin = rz_bin_new();
+	rz_bin_plugin_add(bin, &mock_plugin);
+	RzBuffer *buf = rz_buf_new_with_bytes((const ut8 *)"\x42\x42\x13\x37", 4);
+	RzBinOptions opts = { 0 };
+	opts.pluginname = "mock";
+	opts.filename = "<mock>";
+	RzBinFile *bf = rz_bin_open_buf(bin, buf, &opts);
+	mu_assert_notnull(bf, "load bin file");
+	RzBinObject *o = bf->o;
+	mu_assert_notnull(rz_bin_object_get_info(o), "info loaded with the object");
+	mu_assert_eq(imports_calls + symbols_calls + strings_calls, 0, "nothing else loaded");
+	mu_assert_eq(rz_bin_object_get_item_load_time(o, RZ_BIN_OBJECT_ITEM_SYMBOLS), UT64_MAX, "symbols not loaded");
+
+	const RzList *syms = rz_bin_object_get_symbols(o);
+	mu_assert_eq(rz_list_length(syms), 2, "symbols");
+	mu_assert_eq(symbols_calls, 1, "symbols loaded");
+	mu_assert_eq(imports_calls, 1, "imports loaded before the symbols");
+	mu_assert_eq(strings_calls, 0, "strings not loaded");
+	mu_assert_neq(rz_bin_object_get_item_load_time(o, RZ_BIN_OBJECT_ITEM_SYMBOLS), UT64_MAX, "symbols load time");
+	mu_assert_ptreq(rz_bin_object_get_symbols(o), syms, "loaded once");
+	mu_assert_eq(symbols_calls, 1, "loaded once");
+
+	RzBinImport *imp = rz_list_first(rz_bin_object_get_imports(o));
+	RzBinSymbol *sym = rz_bin_object_get_symbol_of_import(o, imp);
+	mu_assert_notnull(sym, "symbol of import");
+	mu_assert_eq(sym->vaddr, 0x1020, "symbol of import");
+
+	mu_assert_eq(rz_list_length(rz_bin_object_get_strings(o)), 1, "strings");
+	mu_assert_eq(strings_calls, 1, "strings loaded");
+	mu_assert_true(rz_bin_object_is_string(o, 0x1030), "is string");
+
+	// loading the items again, as when rebasing, drops the loaded ones
+	rz_bin_object_set_items(bf, o);
+	mu_assert_eq(rz_bin_object_get_item_load_time(o, RZ_BIN_OBJECT_ITEM_SYMBOLS), UT64_MAX, "symbols dropped");
+	mu_assert_eq(rz_list_length(rz_bin_object_get_symbols(o)), 2, "symbols");
+	mu_assert_eq(symbols_calls, 2, "symbols loaded again");
+	mu_assert_streq(rz_bin_object_item_name(RZ_BIN_OBJECT_ITEM_RELOCS), "relocs", "item name");
+
+	rz_buf_free(buf);
+	rz_bin_free(bin);
+	mu_end;
+}
+
+bool test_bin_object_classes_merge(void) {
+	RzBin *bin = rz_bin_new();
+	rz_bin_plugin_add(bin, &mock_plugin);
+	RzBuffer *buf = rz_buf_new_with_bytes((const ut8 *)"\x42\x42\x13\x37", 4);
+	RzBinOptions opts = { 0 };
+	opts.pluginname = "mock";
+	opts.filename = "<mock>";
+	RzBinFile *bf = rz_bin_open_buf(bin, buf, &opts);
+	mu_assert_notnull(bf, "load bin file");
+	RzBinObject *o = bf->o;
+
+	// as the demangler does, before the classes of the plugin are loaded
+	RzBinSymbol *sym = rz_bin_file_add_method(bf, "Foo", "bar", 0);
+	mu_assert_notnull(sym, "method");
+	sym->vaddr = 0x2000;
+	sym = rz_bin_file_add_method(bf, "Baz", "qux", 0);
+	mu_assert_notnull(sym, "method");
+	sym->vaddr = 0x2010;
+	mu_assert_eq(rz_bin_object_get_item_load_time(o, RZ_BIN_OBJECT_ITEM_CLASSES), UT64_MAX, "classes not loaded");
+
+	const RzList *cls = rz_bin_object_get_classes(o);
+	mu_assert_eq(rz_list_length(cls), 2, "classes of the plugin and of the demangler");
+	RzBinClass *c = rz_list_get_n(cls, 0);
+	mu_assert_streq(c->name, "Foo", "class of the plugin");
+	mu_assert_eq(rz_list_length(c->methods), 1, "merged method");
+	sym = rz_list_first(c->methods);
+	mu_assert_eq(sym->vaddr, 0x1040, "method of the plugin");
+	c = rz_list_get_n(cls, 1);
+	mu_assert_streq(c->name, "Baz", "class of the demangler");
+	mu_assert_eq(rz_list_length(c->methods), 1, "method");
+	sym = rz_list_first(c->methods);
+	mu_assert_streq(sym->name, "qux", "method of the demangler");
+	mu_assert_eq(sym->vaddr, 0x2010, "method of the demangler");
+	mu_assert_ptreq(rz_bin_file_add_method(bf, "Baz", "qux", 0), sym, "known method");
+
+	rz_buf_free(buf);
+	rz_bin_free(bin);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_bin_object_lazy_items);
+	mu_run_test(test_bin_object_classes_merge);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include "minunit.h"
+
+// more than a round of blocks of a thread, so that the scan can go parallel
+#define CODE_SIZE 0x100000
+
+static RzCore *core_with_code(void) {
+	RzCore *core = rz_core_new();
+	rz_config_set(core->config, "asm.arch", "x86");
+	rz_config_set_i(core->config, "asm.bits", 64);
+	rz_io_open(core->io, "malloc://0x100000", RZ_PERM_RWX, 0);
+	ut8 *code = calloc(1, CODE_SIZE);
+	for (size_t i = 0; i + 16 <= CODE_SIZE; i += 16) {
+		if (i >= 0x40000 && i < 0x48000) {
+			// padding, which is not decoded
+			continue;
+		}
+		const st32 rel = (st32)((i * 0x45) % 0x8000) - 0x4000;
+		// call rel; lea rax, [rip+rel]; jmp $+2; ret; nop; nop
+		ut8 *p = code + i;
+		p[0] = 0xe8;
+		rz_write_le32(p + 1, rel);
+		p[5] = 0x48;
+		p[6] = 0x8d;
+		p[7] = 0x05;
+		rz_write_le32(p + 8, -rel);
+		p[12] = 0xeb;
+		p[13] = 0x00;
+		p[14] = 0xc3;
+		p[15] = 0x90;
+	}
+	rz_io_write_at(core->io, 0, code, CODE_SIZE);
+	free(code);
+	return core;
+}
+
+static void search_xrefs(int threads, int *count, RzList **xrefs) {
+	RzCore *core = core_with_code();
+	rz_config_set_i(core->config, "analysis.refs.threads", threads);
+	*count = rz_core_analysis_search_xrefs(core, 0, CODE_SIZE);
+	*xrefs = rz_analysis_xrefs_list(core->analysis);
+	rz_core_free(core);
+}
+
+bool test_search_xrefs_threads(void) {
+	int expect_count, count;
+	RzList *expect, *xrefs;
+	search_xrefs(1, &expect_count, &expect);
+	mu_assert_true(expect_count > 0, "xrefs found");
+
+	const int threads[] = { 0, 2, 3 };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(threads); i++) {
+		search_xrefs(threads[i], &count, &xrefs);
+		mu_assert_eq(count, expect_count, "same count as the sequential search");
+		mu_assert_eq(rz_list_length(xrefs), rz_list_length(expect), "same number of xrefs");
+		RzListIter *it = rz_list_iterator(xrefs), *eit = rz_list_iterator(expect);
+		while (it && eit) {
+			RzAnalysisXRef *x = rz_list_iter_get(it);
+			RzAnalysisXRef *e = rz_list_iter_get(eit);
+			mu_assert_eq(x->from, e->from, "xref from");
+			mu_assert_eq(x->to, e->to, "xref to");
+			mu_assert_eq(x->type, e->type, "xref type");
+		}
+		rz_list_free(xrefs);
+	}
+	rz_list_free(expect);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_search_xrefs_threads);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
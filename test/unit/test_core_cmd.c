@@ -116,11 +116,93 @@ static bool test_arg_cmd_last_opt(void) {
 	mu_end;
 }
 
+static bool test_parsed_cmd_cache(void) {
+	RzCore *core = rz_core_new();
+	char *out = rz_core_cmd_str(core, "echo hello");
+	mu_assert_streq_free(out, "hello\n", "first parse");
+	out = rz_core_cmd_str(core, "echo hello");
+	mu_assert_streq_free(out, "hello\n", "parsed tree reused");
+	for (int i = 0; i < 300; i++) {
+		char *cmd = rz_str_newf("echo %d", i);
+		char *exp = rz_str_newf("%d\n", i);
+		out = rz_core_cmd_str(core, cmd);
+		mu_assert_streq_free(out, exp, "distinct commands");
+		free(exp);
+		free(cmd);
+	}
+	out = rz_core_cmd_str(core, "echo hello");
+	mu_assert_streq_free(out, "hello\n", "parsed again after eviction");
+	out = rz_core_cmd_str(core, "echo $(echo nested)");
+	mu_assert_streq_free(out, "nested\n", "substitution");
+	out = rz_core_cmd_str(core, "echo $(echo nested)");
+	mu_assert_streq_free(out, "nested\n", "substitution from a reused tree");
+	rz_core_free(core);
+	mu_end;
+}
+
+static bool test_prepared_cmd(void) {
+	RzCore *core = rz_core_new();
+	mu_assert_null(rz_core_cmd_prepare(core, "nonexistingcmd"), "not a command");
+	RzCorePreparedCmd *pcmd = rz_core_cmd_prepare(core, "echo");
+	mu_assert_notnull(pcmd, "prepared");
+	const char *argv[] = { "hello", "$(world)", "@ 0x10" };
+	char *out = rz_core_prepared_cmd_str(core, pcmd, RZ_ARRAY_SIZE(argv), argv);
+	mu_assert_streq_free(out, "hello $(world) @ 0x10\n", "arguments passed as they are");
+	out = rz_core_prepared_cmd_str(core, pcmd, 1, argv);
+	mu_assert_streq_free(out, "hello\n", "arguments bound again");
+	mu_assert_eq(rz_core_prepared_cmd_call(core, pcmd, 0, NULL), RZ_CMD_STATUS_ERROR, "echo without arguments");
+	rz_core_prepared_cmd_free(pcmd);
+	rz_core_free(core);
+	mu_end;
+}
+
+static bool test_parsed_cmd_cache_fresh(void) {
+	const char *cmds[] = {
+		"echo hello",
+		"echo a; echo b",
+		"echo \"quoted ; text\" 'and @ more'",
+		"?v 1+2",
+		"?v $$ @ 0x20",
+		"s 0x10; s",
+		"echo $(echo nested) $(?v 3)",
+		"?e hello world~world",
+	};
+	RzCore *core = rz_core_new();
+	for (size_t round = 0; round < 2; round++) {
+		for (size_t i = 0; i < RZ_ARRAY_SIZE(cmds); i++) {
+			// a new core parses the command with a new parser and no cached tree
+			RzCore *fresh = rz_core_new();
+			char *exp = rz_core_cmd_str(fresh, cmds[i]);
+			rz_core_free(fresh);
+			char *out = rz_core_cmd_str(core, cmds[i]);
+			mu_assert_notnull(exp, "fresh output");
+			mu_assert_streq(out, exp, round ? "same output from a reused tree" : "same output from the reused parser");
+			free(out);
+			free(exp);
+		}
+	}
+	RzCore *fresh = rz_core_new();
+	char *exp = rz_core_cmd_str(fresh, "echo hello");
+	rz_core_free(fresh);
+	RzCorePreparedCmd *pcmd = rz_core_cmd_prepare(core, "echo");
+	const char *argv[] = { "hello" };
+	char *out = rz_core_prepared_cmd_str(core, pcmd, 1, argv);
+	mu_assert_streq(out, exp, "same output from a prepared command");
+	free(out);
+	free(exp);
+	rz_core_prepared_cmd_free(pcmd);
+	rz_core_free(core);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_arg_cmd);
 	mu_run_test(test_arg_cmd_last);
 	mu_run_test(test_arg_cmd_last_with_at);
 	mu_run_test(test_arg_cmd_last_opt);
+	mu_run_test(test_parsed_cmd_cache);
+	mu_run_test(test_prepared_cmd);
+	mu_run_test(test_parsed_cmd_cache_fresh);
 	return tests_passed != tests_run;
 }
 
@@ -563,12 +563,158 @@ static bool test_debug_sw_bp_multibits(void) {
 }
 /// @}
 
+/**
+ * \brief One-shot coverage breakpoints test
+ * Set coverage breakpoints at 0x50, 0x58 and 0x80 with a real break at 0x70 and
+ * check that each one is hit once, without stopping and with the code restored.
+ */
+static bool test_debug_coverage_bp(void) {
+	RzDebug *dbg;
+	RzIO *io;
+	SETUP_DEBUG(&dbg_mock_plugin, &bp_mock_plugin, &bp_ctx);
+
+	rz_io_open_at(io, "malloc://0x1000", RZ_PERM_RW, 0644, 0x0, NULL);
+	rz_io_write_at(io, 0x50, (const ut8 *)"PRNT", 4);
+	rz_io_write_at(io, 0x70, (const ut8 *)"STOP", 4);
+	ut8 code[0x100];
+	rz_io_read_at(io, 0, code, sizeof(code));
+
+	int r = rz_debug_attach(dbg, 42);
+	mu_assert_false(dbg_mock_failed, "global failure");
+	mu_assert_true(r, "attach");
+
+	mu_assert_true(rz_bp_coverage_add(dbg->bp, 0x80, 0x10), "add coverage bp");
+	mu_assert_true(rz_bp_coverage_add(dbg->bp, 0x58, 0x18), "add coverage bp");
+	mu_assert_true(rz_bp_coverage_add(dbg->bp, 0x50, 0x8), "add coverage bp");
+	mu_assert_true(rz_bp_coverage_add(dbg->bp, 0x50, 0x8), "add duplicate coverage bp");
+	mu_assert_eq(rz_bp_coverage_pending(dbg->bp), 3, "pending");
+	mu_assert_eq(rz_list_length(dbg->bp->bps), 0, "kept apart from the regular bps");
+
+	r = rz_debug_continue(dbg);
+	mu_assert_false(dbg_mock_failed, "global failure");
+	mu_assert_true(r, "continue");
+	rz_debug_reg_sync(dbg, RZ_REG_TYPE_ANY, false);
+	ut64 pc = rz_reg_get_value_by_role(dbg->reg, RZ_REG_NAME_PC);
+	mu_assert_eq(pc, 0x74, "continued through the coverage bps until the real break");
+	DebugMockCtx *ctx = dbg->plugin_data;
+	mu_assert_streq(rz_strbuf_get(&ctx->output), "PRNT with next pc = 0x54\n", "original code run once");
+
+	const RzVector *hits = rz_bp_coverage_hits(dbg->bp);
+	mu_assert_eq(rz_vector_len(hits), 2, "hits");
+	RzBreakpointCoverageHit *hit = rz_vector_index_ptr((RzVector *)hits, 0);
+	mu_assert_eq(hit->addr, 0x50, "hit addr");
+	mu_assert_eq(hit->size, 0x8, "hit size");
+	hit = rz_vector_index_ptr((RzVector *)hits, 1);
+	mu_assert_eq(hit->addr, 0x58, "hit addr");
+	mu_assert_eq(rz_bp_coverage_pending(dbg->bp), 1, "pending");
+	ut8 data[sizeof(code)];
+	rz_io_read_at(io, 0, data, sizeof(data));
+	mu_assert_memeq(data, code, sizeof(code), "restored original bytes while stopped");
+
+	r = rz_debug_continue(dbg);
+	mu_assert_false(dbg_mock_failed, "global failure");
+	mu_assert_eq(rz_vector_len(hits), 3, "hits");
+	hit = rz_vector_index_ptr((RzVector *)hits, 2);
+	mu_assert_eq(hit->addr, 0x80, "hit addr");
+	mu_assert_eq(rz_bp_coverage_pending(dbg->bp), 0, "pending");
+	rz_io_read_at(io, 0, data, sizeof(data));
+	mu_assert_memeq(data, code, sizeof(code), "restored original bytes while stopped");
+
+	RzDebugMap *map = rz_debug_map_new("mock", 0x40, 0x100, RZ_PERM_RX, 0);
+	map->file = strdup("/bin/mock");
+	rz_list_append(dbg->maps, map);
+	RzBuffer *buf = rz_buf_new_empty(0);
+	mu_assert_true(rz_debug_coverage_drcov(dbg, buf), "drcov");
+	const char drcov_header[] = "DRCOV VERSION: 2\n"
+				    "DRCOV FLAVOR: drcov\n"
+				    "Module Table: version 2, count 1\n"
+				    "Columns: id, base, end, entry, checksum, timestamp, path\n"
+				    "0, 0x40, 0x100, 0x0, 0x0, 0x0, /bin/mock\n"
+				    "BB Table: 3 bbs\n";
+	const ut8 drcov_bbs[] = {
+		0x10, 0, 0, 0, 0x08, 0, 0, 0,
+		0x18, 0, 0, 0, 0x18, 0, 0, 0,
+		0x40, 0, 0, 0, 0x10, 0, 0, 0
+	};
+	mu_assert_eq(rz_buf_size(buf), sizeof(drcov_header) - 1 + sizeof(drcov_bbs), "drcov size");
+	ut8 drcov[sizeof(drcov_header) - 1 + sizeof(drcov_bbs)];
+	rz_buf_read_at(buf, 0, drcov, sizeof(drcov));
+	mu_assert_memeq(drcov, (const ut8 *)drcov_header, sizeof(drcov_header) - 1, "drcov header");
+	mu_assert_memeq(drcov + sizeof(drcov_header) - 1, drcov_bbs, sizeof(drcov_bbs), "drcov bbs");
+	rz_buf_free(buf);
+
+	rz_debug_free(dbg);
+	rz_io_free(io);
+	mu_end;
+}
+
+static bool test_debug_trace_tags(void) {
+	RzBreakpointContext bp_ctx = { 0 };
+	RzDebug *dbg = rz_debug_new(&bp_ctx);
+	RzAnalysis *analysis = rz_analysis_new();
+	dbg->analysis = analysis;
+
+	rz_debug_trace_tag(dbg, 1);
+	RzDebugTracepoint *tp1 = rz_debug_trace_add(dbg, 0x100, 4);
+	mu_assert_notnull(tp1, "traced");
+	mu_assert_ptreq(rz_debug_trace_get(dbg, 0x100), tp1, "traced with tag 1");
+	rz_debug_trace_tag(dbg, 2);
+	mu_assert_null(rz_debug_trace_get(dbg, 0x100), "not traced with tag 2");
+	RzDebugTracepoint *tp2 = rz_debug_trace_add(dbg, 0x100, 4);
+	mu_assert_notnull(tp2, "traced");
+	mu_assert_ptrneq(tp2, tp1, "other tracepoint");
+	mu_assert_ptreq(rz_debug_trace_get(dbg, 0x100), tp2, "traced with tag 2");
+	rz_debug_trace_tag(dbg, 1);
+	mu_assert_ptreq(rz_debug_trace_get(dbg, 0x100), tp1, "kept with tag 1");
+	mu_assert_null(rz_debug_trace_get(dbg, 0x104), "not traced");
+
+	rz_debug_trace_reset(dbg);
+	mu_assert_null(rz_debug_trace_get(dbg, 0x100), "reset");
+	rz_debug_free(dbg);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+static bool test_debug_trace_compact_baseline(void) {
+	RzBreakpointContext bp_ctx = { 0 };
+	RzDebug *dbg = rz_debug_new(&bp_ctx);
+	RzAnalysis *analysis = rz_analysis_new();
+	dbg->analysis = analysis;
+	dbg->trace_compact = true;
+
+	mu_assert_false(rz_debug_trace_compact_baseline(dbg), "nothing traced");
+	rz_debug_trace_add(dbg, 0x100, 4);
+	rz_debug_trace_add(dbg, 0x104, 4);
+	rz_debug_trace_add(dbg, 0x108, 4);
+	mu_assert_true(rz_debug_trace_compact_baseline(dbg), "baseline");
+	RzTraceStore *baseline = dbg->trace->baseline;
+	mu_assert_notnull(baseline, "baseline");
+	mu_assert_null(dbg->trace->store, "new trace");
+	mu_assert_eq(rz_trace_store_steps(baseline), 3, "baseline steps");
+
+	rz_debug_trace_add(dbg, 0x100, 4);
+	rz_debug_trace_add(dbg, 0x104, 4);
+	rz_debug_trace_add(dbg, 0x10c, 4);
+	mu_assert_notnull(dbg->trace->store, "traced");
+	mu_assert_eq(rz_trace_store_diff(baseline, dbg->trace->store), 2, "first differing step");
+	mu_assert_eq(rz_trace_store_hits(dbg->trace->store, 0x10c), 1, "hits");
+
+	rz_debug_trace_reset(dbg);
+	mu_assert_ptreq(dbg->trace->baseline, baseline, "baseline kept");
+	rz_debug_free(dbg);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 int all_tests() {
 	rz_cons_new(); // there is some windows-specific code in debug that accesses the cons singleton
 	mu_run_test(test_rz_debug_use);
 	mu_run_test(test_rz_debug_reg_offset);
 	mu_run_test(test_debug_sw_bp);
 	mu_run_test(test_debug_sw_bp_multibits);
+	mu_run_test(test_debug_coverage_bp);
+	mu_run_test(test_debug_trace_tags);
+	mu_run_test(test_debug_trace_compact_baseline);
 	rz_cons_free();
 	return tests_passed != tests_run;
 }
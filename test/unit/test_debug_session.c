@@ -123,20 +123,17 @@ static bool compare_registers_cb(void *user, const ut64 key, const void *value)
 	return true;
 }
 
-static bool compare_memory_cb(void *user, const ut64 key, const void *value) {
+static bool memory_eq(RzVector *actual, RzVector *expected) {
 	RzDebugChangeMem *actual_mem, *expected_mem;
-	HtUP *ref = user;
-	RzVector *actual_vmem = (RzVector *)value;
-
-	RzVector *expected_vmem = ht_up_find(ref, key, NULL);
-	mu_assert("vmem not found", expected_vmem);
-	mu_assert_eq(actual_vmem->len, expected_vmem->len, "vmem length");
+	mu_assert_eq(actual->len, expected->len, "memory length");
 
 	size_t i;
-	rz_vector_enumerate(actual_vmem, actual_mem, i) {
-		expected_mem = rz_vector_index_ptr(expected_vmem, i);
+	rz_vector_enumerate(actual, actual_mem, i) {
+		expected_mem = rz_vector_index_ptr(expected, i);
 		mu_assert_eq(actual_mem->cnum, expected_mem->cnum, "cnum");
-		mu_assert_eq(actual_mem->data, expected_mem->data, "data");
+		mu_assert_eq(actual_mem->addr, expected_mem->addr, "addr");
+		mu_assert_eq(actual_mem->size, expected_mem->size, "size");
+		mu_assert_memeq(actual_mem->data, expected_mem->data, expected_mem->size, "data");
 	}
 	return true;
 }
@@ -171,7 +168,8 @@ static bool test_session_load(void) {
 	// Registers
 	ht_up_foreach(s->registers, compare_registers_cb, ref->registers);
 	// Memory
-	ht_up_foreach(s->memory, compare_memory_cb, ref->memory);
+	mu_assert_eq(ref->memory->len, 2, "adjacent writes of a step merged");
+	mu_assert_true(memory_eq(s->memory, ref->memory), "memory");
 	// Checkpoints
 	size_t i, chkpt_idx;
 	RzDebugCheckpoint *chkpt, *ref_chkpt;
@@ -198,9 +196,92 @@ static bool test_session_load(void) {
 	mu_end;
 }
 
+static bool test_snap_pages(void) {
+	HtUP *store = ht_up_new0();
+	ut8 buf[0x80];
+	memset(buf, 0xf0, sizeof(buf));
+	RzDebugSnapPage *a = rz_debug_snap_page_new(store, buf, sizeof(buf));
+	RzDebugSnapPage *b = rz_debug_snap_page_new(store, buf, sizeof(buf));
+	mu_assert_notnull(a, "page");
+	mu_assert_ptreq(b, a, "same bytes, same page");
+	mu_assert_eq(a->refs, 2, "page refs");
+	buf[0] = 0x0f;
+	RzDebugSnapPage *c = rz_debug_snap_page_new(store, buf, 0x40);
+	mu_assert_notnull(c, "page");
+	mu_assert("other bytes, other page", c != a);
+
+	RzDebugSnap *snap = RZ_NEW0(RzDebugSnap);
+	snap->name = strdup("[heap]");
+	snap->addr = 0x1000;
+	snap->addr_end = 0x1140;
+	snap->size = 0x140;
+	snap->page_size = 0x80;
+	snap->pages = RZ_NEWS0(RzDebugSnapPage *, 3);
+	snap->pages[0] = a;
+	snap->pages[1] = b;
+	snap->pages[2] = c;
+	ut8 *data = rz_debug_snap_data(snap);
+	mu_assert_notnull(data, "snap data");
+	mu_assert_eq(data[0x7f], 0xf0, "first page");
+	mu_assert_eq(data[0x100], 0x0f, "last page");
+	mu_assert_eq(data[0x13f], 0xf0, "last page end");
+	free(data);
+
+	rz_debug_snap_free(snap);
+	mu_assert_null(ht_up_find(store, rz_hash_xxhash(buf, 0x40), NULL), "unused page left the store");
+	ht_up_free(store);
+	mu_end;
+}
+
+static void memory_replay(RzVector *memory, ut64 addr, ut8 *buf, size_t size) {
+	RzDebugChangeMem *mem;
+	rz_vector_foreach(memory, mem) {
+		ut32 i;
+		for (i = 0; i < mem->size; i++) {
+			if (mem->addr + i >= addr && mem->addr + i < addr + size) {
+				buf[mem->addr + i - addr] = mem->data[i];
+			}
+		}
+	}
+}
+
+static bool test_session_mem_ranges(void) {
+	RzDebugSession *s = rz_debug_session_new();
+	const ut8 a[] = { 1, 2, 3, 4 };
+	const ut8 b[] = { 5, 6 };
+	s->cnum = 1;
+	rz_debug_session_add_mem_range(s, 0x1000, a, 2);
+	rz_debug_session_add_mem_range(s, 0x1002, a + 2, 2);
+	rz_debug_session_add_mem_range(s, 0x1001, b, 2);
+	s->cnum = 2;
+	rz_debug_session_add_mem_change(s, 0x1004, 7);
+	mu_assert_eq(s->memory->len, 3, "memory changes");
+	RzDebugChangeMem *mem = rz_vector_index_ptr(s->memory, 0);
+	mu_assert_eq(mem->size, 4, "adjacent writes merged");
+
+	Sdb *db = sdb_new0();
+	rz_debug_session_serialize(s, db);
+	Sdb *memory_sdb = sdb_ns(db, "memory", false);
+	mu_assert_streq(sdb_const_get(memory_sdb, "0x1001", 0), "[{\"cnum\":1,\"data\":2},{\"cnum\":1,\"data\":5}]", "byte history");
+	RzDebugSession *loaded = rz_debug_session_new();
+	rz_debug_session_deserialize(loaded, db);
+	ut8 expected[5] = { 0 }, actual[5] = { 0 };
+	memory_replay(s->memory, 0x1000, expected, sizeof(expected));
+	memory_replay(loaded->memory, 0x1000, actual, sizeof(actual));
+	mu_assert_memeq(actual, (const ut8 *)"\x01\x05\x06\x04\x07", 5, "replayed memory");
+	mu_assert_memeq(actual, expected, sizeof(expected), "loaded memory");
+
+	sdb_free(db);
+	rz_debug_session_free(loaded);
+	rz_debug_session_free(s);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_session_save);
 	mu_run_test(test_session_load);
+	mu_run_test(test_session_mem_ranges);
+	mu_run_test(test_snap_pages);
 	return tests_passed != tests_run;
 }
 
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <math.h>
+#include <rz_core.h>
 #include <rz_flirt.h>
 #include <rz_util.h>
 #include "minunit.h"
@@ -48,6 +49,136 @@ test_flirt_pat_def(parse_multiline, 5,
 	"31C04885D2741F488D4417FF4839C77610EB1D0F1F4400004883E8014839C777 13 9867 0033 :0000 Curl_memrchr \n"
 	"---\n");
 
+#define FLIRT_SIGNATURES 64
+#define FLIRT_FUNCTIONS  96
+#define FLIRT_FCN_SIZE   0x40
+
+/**
+ * Makes the pat of \p patterns sharing their first bytes, with some variant
+ * bytes, so that the tree has nodes with and without a jump table.
+ * A variant byte is marked by a 0 in \p masks.
+ */
+static char *flirt_patterns_setup(ut32 *seed, ut8 patterns[][32], ut8 masks[][32]) {
+	static const ut8 bytes[] = { 0x90, 0xc3 };
+	RzStrBuf *sb = rz_strbuf_new("");
+	for (size_t i = 0; i < FLIRT_SIGNATURES; i++) {
+		for (size_t j = 0; j < 32; j++) {
+			patterns[i][j] = j ? bytes[(mu_rand(seed) >> 8) % RZ_ARRAY_SIZE(bytes)] : (mu_rand(seed) >> 8) % 24;
+			masks[i][j] = (j == 0 && i % 7 == 6) || (mu_rand(seed) >> 8) % 8 == 0 ? 0 : 0xff;
+			if (masks[i][j]) {
+				rz_strbuf_appendf(sb, "%02X", patterns[i][j]);
+			} else {
+				rz_strbuf_append(sb, "..");
+			}
+		}
+		rz_strbuf_appendf(sb, " 00 0000 %04X :0000 sig_%" PFMTSZu "\n", FLIRT_FCN_SIZE, i);
+	}
+	rz_strbuf_append(sb, "---\n");
+	return rz_strbuf_drain(sb);
+}
+
+/**
+ * Matches the buffer against the tree the same way the linear matcher did
+ * before the index: children in order and the first match wins.
+ */
+static const RzFlirtModule *flirt_linear_match(const RzFlirtNode *node, const ut8 *b, ut32 size, ut32 idx) {
+	if (idx + node->length > size) {
+		return NULL;
+	}
+	for (ut32 i = 0; i < node->length; i++) {
+		if (node->pattern_mask[i] == 0xFF && node->pattern_bytes[i] != b[idx + i]) {
+			return NULL;
+		}
+	}
+	idx += node->length;
+	RzListIter *it;
+	if (node->child_list) {
+		RzFlirtNode *child;
+		rz_list_foreach (node->child_list, it, child) {
+			const RzFlirtModule *module = flirt_linear_match(child, b, size, idx);
+			if (module) {
+				return module;
+			}
+		}
+		return NULL;
+	}
+	// all the modules have no crc nor tail bytes
+	return rz_list_first(node->module_list);
+}
+
+static bool flirt_name_is(const char *fcn_name, const RzFlirtModule *module) {
+	const RzFlirtFunction *flirt_func = rz_list_first(module->public_functions);
+	char *name = rz_str_newf("flirt.%s", flirt_func->name);
+	size_t len = strlen(name);
+	// a module matching several functions names the next ones flirt.<name>_<n>
+	bool ret = !strncmp(fcn_name, name, len) && (!fcn_name[len] || fcn_name[len] == '_');
+	free(name);
+	return ret;
+}
+
+bool test_flirt_index_apply(void) {
+	ut32 seed = 0x1337;
+	ut8 patterns[FLIRT_SIGNATURES][32], masks[FLIRT_SIGNATURES][32];
+	char *pat = flirt_patterns_setup(&seed, patterns, masks);
+	RzBuffer *buffer = rz_buf_new_with_string(pat);
+	RzFlirtNode *index_root = rz_sign_flirt_parse_string_pattern_from_buffer(buffer, RZ_FLIRT_NODE_OPTIMIZE_NORMAL, NULL);
+	mu_assert_notnull(index_root, "parsed for the index");
+	rz_buf_seek(buffer, 0, RZ_BUF_SET);
+	RzFlirtNode *root = rz_sign_flirt_parse_string_pattern_from_buffer(buffer, RZ_FLIRT_NODE_OPTIMIZE_NORMAL, NULL);
+	mu_assert_notnull(root, "parsed for the linear matcher");
+	rz_buf_free(buffer);
+	free(pat);
+	mu_assert_true(rz_list_length(root->child_list) >= 16, "jump table at the root");
+
+	RzFlirtIndex *index = rz_sign_flirt_index_new();
+	mu_assert_true(rz_sign_flirt_index_add(index, index_root), "added");
+
+	// copies of the signatures, some with a fixed byte changed, then random functions
+	RzCore *core = rz_core_new();
+	rz_io_open(core->io, "malloc://0x10000", RZ_PERM_RW, 0);
+	const RzFlirtModule *expected[FLIRT_FUNCTIONS];
+	size_t matched = 0;
+	for (size_t i = 0; i < FLIRT_FUNCTIONS; i++) {
+		ut8 b[FLIRT_FCN_SIZE];
+		for (size_t j = 0; j < sizeof(b); j++) {
+			b[j] = i < FLIRT_SIGNATURES && j < 32 && masks[i][j] ? patterns[i][j] : mu_rand(&seed) >> 8;
+		}
+		if (i < FLIRT_SIGNATURES && i % 4 == 3) {
+			b[1 + (mu_rand(&seed) >> 8) % 31] = 0xcc;
+		}
+		expected[i] = flirt_linear_match(root, b, sizeof(b), 0);
+		matched += expected[i] != NULL;
+
+		ut64 addr = 0x1000 + i * FLIRT_FCN_SIZE;
+		rz_io_write_at(core->io, addr, b, sizeof(b));
+		char name[32];
+		snprintf(name, sizeof(name), "fcn.%" PFMTSZu, i);
+		RzAnalysisFunction *fcn = rz_analysis_create_function(core->analysis, name, addr, RZ_ANALYSIS_FCN_TYPE_FCN, NULL);
+		mu_assert_notnull(fcn, "function");
+		RzAnalysisBlock *block = rz_analysis_create_block(core->analysis, addr, FLIRT_FCN_SIZE);
+		rz_analysis_function_add_block(fcn, block);
+		rz_analysis_block_unref(block);
+	}
+	mu_assert_true(matched > FLIRT_SIGNATURES / 2 && matched < FLIRT_FUNCTIONS, "some functions match");
+
+	mu_assert_true(rz_sign_flirt_index_apply(index, core->analysis, 4), "applied");
+	for (size_t i = 0; i < FLIRT_FUNCTIONS; i++) {
+		RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, 0x1000 + i * FLIRT_FCN_SIZE);
+		mu_assert_notnull(fcn, "function kept");
+		if (expected[i]) {
+			mu_assert_true(flirt_name_is(fcn->name, expected[i]), "same module as the linear matcher");
+		} else {
+			char name[32];
+			snprintf(name, sizeof(name), "fcn.%" PFMTSZu, i);
+			mu_assert_streq(fcn->name, name, "no match");
+		}
+	}
+	rz_core_free(core);
+	rz_sign_flirt_index_free(index);
+	rz_sign_flirt_node_free(root);
+	mu_end;
+}
+
 int all_tests() {
 	test_flirt_pat_run(parse_signature);
 	test_flirt_pat_run(parse_comment);
@@ -55,6 +186,7 @@ int all_tests() {
 	test_flirt_pat_run(parse_large_function);
 	test_flirt_pat_run(parse_large_offset);
 	test_flirt_pat_run(parse_multiline);
+	mu_run_test(test_flirt_index_apply);
 	return tests_passed != tests_run;
 }
 
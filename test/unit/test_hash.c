@@ -229,11 +229,43 @@ bool test_message_digest_small_block_stringified() {
 	mu_end;
 }
 
+bool test_message_digest_roll() {
+	char message[256];
+	const ut8 *data = (const ut8 *)"The quick brown fox jumps over the lazy dog";
+	const size_t size = strlen((const char *)data);
+	const size_t window = 16;
+	const char *algos[] = { "adler32", "xor8", "mod255", "parity" };
+
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(algos); ++i) {
+		const RzMsgDigestPlugin *plugin = rz_msg_digest_plugin_by_name(algos[i]);
+		snprintf(message, sizeof(message), "%s can roll", algos[i]);
+		mu_assert_notnull(plugin && plugin->roll, message);
+		void *context = plugin->context_new();
+		RzMsgDigestSize digest_size = plugin->digest_size(context);
+		ut8 rolled[8], expected[8];
+		plugin->init(context);
+		plugin->update(context, data, window);
+		for (size_t at = 1; at + window <= size; at++) {
+			plugin->roll(context, data[at - 1], data[at + window - 1], window);
+			plugin->final(context, rolled);
+			ut8 *digest = rz_msg_digest_calculate_small_block(algos[i], data + at, window, NULL);
+			memcpy(expected, digest, digest_size);
+			free(digest);
+			snprintf(message, sizeof(message), "%s rolled digest at %u", algos[i], (ut32)at);
+			mu_assert_memeq(rolled, expected, digest_size, message);
+		}
+		plugin->context_free(context);
+	}
+
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_message_digest_configure);
 	mu_run_test(test_message_digest_api_stringified);
 	mu_run_test(test_message_digest_hmac_stringified);
 	mu_run_test(test_message_digest_small_block_stringified);
+	mu_run_test(test_message_digest_roll);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,265 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_il.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+#include <rz_il/rz_il_opbuilder_begin.h>
+
+#define MEM_SIZE 0x20
+
+typedef struct {
+	RzILVM *vm;
+	RzBuffer *mem;
+} Machine;
+
+static void hook_called(RzILVM *vm, RzILOpEffect *op) {
+	// replaces the value, the compiled code must not keep the old one
+	rz_il_vm_set_global_var(vm, "r0", rz_il_value_new_bitv(rz_bv_new_from_ut64(32, 0xc0ffee)));
+}
+
+static void machine_init(Machine *m, ut32 seed) {
+	m->vm = rz_il_vm_new(0x100, 32, false);
+	ut8 data[MEM_SIZE];
+	for (size_t i = 0; i < sizeof(data); i++) {
+		mu_rand(&seed);
+		data[i] = seed >> 16;
+	}
+	m->mem = rz_buf_new_with_bytes(data, sizeof(data));
+	rz_il_vm_add_mem(m->vm, 0, rz_il_mem_new(m->mem, 32));
+	const char *bv32[] = { "r0", "r1", "r2" };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(bv32); i++) {
+		mu_rand(&seed);
+		rz_il_vm_create_global_var(m->vm, bv32[i], rz_il_sort_pure_bv(32));
+		rz_il_vm_set_global_var(m->vm, bv32[i], rz_il_value_new_bitv(rz_bv_new_from_ut64(32, seed)));
+	}
+	rz_il_vm_create_global_var(m->vm, "r8", rz_il_sort_pure_bv(8));
+	rz_il_vm_set_global_var(m->vm, "r8", rz_il_value_new_bitv(rz_bv_new_from_ut64(8, seed >> 8)));
+	rz_il_vm_create_global_var(m->vm, "x", rz_il_sort_pure_bv(64));
+	rz_il_vm_set_global_var(m->vm, "x", rz_il_value_new_bitv(rz_bv_new_from_ut64(64, ((ut64)seed << 32) | ~seed)));
+	rz_il_vm_create_global_var(m->vm, "f", rz_il_sort_pure_bool());
+	rz_il_vm_set_global_var(m->vm, "f", rz_il_value_new_bool(rz_il_bool_new(seed & 1)));
+	RzBitVector *addr = rz_bv_new_from_ut64(32, 0x200);
+	rz_il_vm_create_label(m->vm, "there", addr);
+	rz_bv_free(addr);
+	RzILEffectLabel *hook = rz_il_vm_create_label_lazy(m->vm, "hook");
+	hook->type = EFFECT_LABEL_HOOK;
+	hook->hook = hook_called;
+}
+
+static void machine_fini(Machine *m) {
+	rz_il_vm_free(m->vm);
+	rz_buf_free(m->mem);
+}
+
+static char *machine_state(Machine *m, bool ret) {
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	rz_strbuf_appendf(&sb, "ret=%d pc=0x%" PFMT64x "\n", ret, rz_bv_to_ut64(m->vm->pc));
+	RzListIter *it;
+	RzILEvent *evt;
+	rz_list_foreach (m->vm->events, it, evt) {
+		rz_il_event_stringify(evt, &sb);
+		rz_strbuf_append(&sb, "\n");
+	}
+	const char *vars[] = { "r0", "r1", "r2", "r8", "x", "f" };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(vars); i++) {
+		RzILVal *val = rz_il_vm_get_var_value(m->vm, RZ_IL_VAR_KIND_GLOBAL, vars[i]);
+		char *s = rz_il_value_stringify(val);
+		rz_strbuf_appendf(&sb, "%s=%s\n", vars[i], s);
+		free(s);
+	}
+	ut8 data[MEM_SIZE];
+	rz_buf_read_at(m->mem, 0, data, sizeof(data));
+	for (size_t i = 0; i < sizeof(data); i++) {
+		rz_strbuf_appendf(&sb, "%02x", data[i]);
+	}
+	return rz_strbuf_drain_nofree(&sb);
+}
+
+/**
+ * Step \p op three times from the same state, with the tree-walker and compiled,
+ * and check that the return values, events, variables and memory are the same.
+ */
+static bool check_same(RzILOpEffect *op, ut32 seed, bool compilable) {
+	Machine ref, cmp;
+	machine_init(&ref, seed);
+	machine_init(&cmp, seed);
+	RzILCode *code = rz_il_vm_compile(cmp.vm, op);
+	if (compilable) {
+		mu_assert_notnull(code, "compiled");
+	} else {
+		mu_assert_null(code, "not compiled");
+	}
+	char *expect = NULL;
+	char *actual = NULL;
+	for (int i = 0; i < 3; i++) {
+		bool ref_ret = rz_il_vm_step(ref.vm, op, 0x104 + i);
+		bool cmp_ret = code ? rz_il_vm_step_code(cmp.vm, code, 0x104 + i) : rz_il_vm_step(cmp.vm, op, 0x104 + i);
+		expect = machine_state(&ref, ref_ret);
+		actual = machine_state(&cmp, cmp_ret);
+		if (strcmp(expect, actual)) {
+			break;
+		}
+		free(expect);
+		free(actual);
+		expect = actual = NULL;
+	}
+	rz_il_code_free(code);
+	machine_fini(&ref);
+	machine_fini(&cmp);
+	rz_il_op_effect_free(op);
+	if (expect) {
+		mu_assert_streq_free(actual, expect, "same state after stepping");
+	}
+	free(expect);
+	return true;
+}
+
+bool test_il_compile_pure(void) {
+	for (ut32 seed = 0; seed < 32; seed++) {
+		RzILOpEffect *op = SEQ9(
+			SETG("r0", ADD(VARG("r0"), MUL(VARG("r1"), U32(seed)))),
+			SETG("r1", SUB(LOGXOR(VARG("r1"), VARG("r2")), NEG(VARG("r0")))),
+			SETG("r2", LOGOR(LOGAND(VARG("r2"), U32(0xff00ff)), LOGNOT(VARG("r1")))),
+			SETG("f", XOR(AND(VARG("f"), MSB(VARG("r0"))), OR(LSB(VARG("r1")), INV(IS_ZERO(VARG("r2")))))),
+			SETG("r8", UNSIGNED(8, SHIFTRA(VARG("r0"), U8(seed)))),
+			SETG("x", APPEND(SHIFTL(VARG("f"), VARG("r1"), VARG("r8")), SHIFTR(INV(VARG("f")), VARG("r2"), U32(seed * 3)))),
+			SETG("r0", ITE(ULE(VARG("r0"), VARG("r1")), SIGNED(32, VARG("r8")), UNSIGNED(32, VARG("x")))),
+			SETG("f", AND(SLE(VARG("r1"), VARG("r2")), INV(XOR(NON_ZERO(VARG("r8")), VARG("f"))))),
+			NOP);
+		if (!check_same(op, seed, true)) {
+			return false;
+		}
+	}
+	mu_end;
+}
+
+bool test_il_compile_div(void) {
+	for (ut32 seed = 0; seed < 32; seed++) {
+		// r8 is sometimes 0
+		RzILOpEffect *op = SEQ5(
+			SETG("r8", LOGAND(VARG("r8"), U8(seed & 1 ? 0xff : 0x3))),
+			SETG("r0", DIV(VARG("r0"), UNSIGNED(32, VARG("r8")))),
+			SETG("r1", SDIV(VARG("r1"), SIGNED(32, VARG("r8")))),
+			SETG("r2", rz_il_op_new_mod(VARG("r2"), UNSIGNED(32, VARG("r8")))),
+			SETG("x", rz_il_op_new_smod(VARG("x"), SIGNED(64, NEG(VARG("r8"))))));
+		if (!check_same(op, seed, true)) {
+			return false;
+		}
+	}
+	mu_end;
+}
+
+bool test_il_compile_locals(void) {
+	for (ut32 seed = 0; seed < 8; seed++) {
+		RzILOpEffect *op = SEQ5(
+			SETL("a", VARG("r0")),
+			SETL("b", LET("t", ADD(VARL("a"), U32(1)), MUL(VARLP("t"), VARLP("t")))),
+			BRANCH(VARG("f"), SETL("a", VARL("b")), NOP),
+			REPEAT(INV(IS_ZERO(UNSIGNED(4, VARL("a")))), SEQ2(SETL("a", SUB(VARL("a"), U32(1))), SETG("r1", ADD(VARG("r1"), VARL("a"))))),
+			SETG("r2", VARL("a")));
+		if (!check_same(op, seed, true)) {
+			return false;
+		}
+	}
+	// local read before being set
+	if (!check_same(BRANCH(VARG("f"), SETL("a", U32(1)), SETG("r0", VARL("a"))), 3, true)) {
+		return false;
+	}
+	mu_end;
+}
+
+bool test_il_compile_mem(void) {
+	for (ut32 seed = 0; seed < 8; seed++) {
+		RzILOpEffect *op = SEQ4(
+			SETG("r8", LOAD(U32(seed))),
+			STORE(U32(seed * 2), ADD(VARG("r8"), U8(1))),
+			SETG("r0", LOADW(32, U32(seed + 3))),
+			STOREW(U32(MEM_SIZE - 8), APPEND(VARG("r0"), VARG("r1"))));
+		if (!check_same(op, seed, true)) {
+			return false;
+		}
+	}
+	mu_end;
+}
+
+bool test_il_compile_jumps(void) {
+	for (ut32 seed = 0; seed < 4; seed++) {
+		if (!check_same(SEQ2(SETG("r0", U32(1)), JMP(VARG("r1"))), seed, true) ||
+			!check_same(BRANCH(VARG("f"), GOTO("there"), NOP), seed, true) ||
+			!check_same(SEQ2(GOTO("hook"), SETG("r0", U32(seed))), seed, true) ||
+			!check_same(rz_il_op_new_blk("here", SETG("r1", U32(seed)), BRANCH(VARG("f"), GOTO("here"), NOP)), seed, true)) {
+			return false;
+		}
+	}
+	mu_end;
+}
+
+bool test_il_compile_fallback(void) {
+	Machine m;
+	machine_init(&m, 0);
+	rz_il_vm_create_global_var(m.vm, "wide", rz_il_sort_pure_bv(128));
+	RzILOpEffect *op = SETG("wide", UN(128, 1));
+	mu_assert_null(rz_il_vm_compile(m.vm, op), "values over 64 bits are not compiled");
+	rz_il_op_effect_free(op);
+	op = SETG("r0", ADD(VARG("r0"), VARG("r8")));
+	mu_assert_null(rz_il_vm_compile(m.vm, op), "ill-sorted ops are not compiled");
+	rz_il_op_effect_free(op);
+	op = SETG("r0", U32(1));
+	RzILCode *code = rz_il_vm_compile(m.vm, op);
+	mu_assert_notnull(code, "compiled");
+	// the global changed sort after compilation
+	rz_il_value_free(rz_il_var_set_remove_var(&m.vm->global_vars, "r0"));
+	rz_il_vm_create_global_var(m.vm, "r0", rz_il_sort_pure_bv(8));
+	rz_il_vm_step_code(m.vm, code, 0x104);
+	RzILVal *val = rz_il_vm_get_var_value(m.vm, RZ_IL_VAR_KIND_GLOBAL, "r0");
+	mu_assert_eq(rz_bv_len(val->data.bv), 8, "run by the tree-walker, which does not bind the mis-sorted value");
+	rz_il_code_free(code);
+	rz_il_op_effect_free(op);
+	machine_fini(&m);
+	mu_end;
+}
+
+bool test_il_compile_steps(void) {
+	Machine ref, cmp;
+	machine_init(&ref, 1);
+	machine_init(&cmp, 1);
+	RzILOpEffect *op = SEQ5(
+		SETL("a", ADD(VARG("r0"), VARG("r1"))),
+		SETG("f", ULE(VARL("a"), VARG("r2"))),
+		SETG("r2", LOGXOR(VARG("r2"), SHIFTL0(VARL("a"), U8(3)))),
+		SETG("r8", LOAD(LOGAND(VARL("a"), U32(MEM_SIZE - 1)))),
+		BRANCH(VARG("f"), SETG("r0", VARL("a")), SETG("r1", VARL("a"))));
+	RzILCode *code = rz_il_vm_compile(cmp.vm, op);
+	mu_assert_notnull(code, "compiled");
+	// the same code run again and again, on the state it left
+	for (int i = 0; i < 1000; i++) {
+		rz_il_vm_step(ref.vm, op, 0x104);
+		rz_il_vm_step_code(cmp.vm, code, 0x104);
+	}
+	char *expect = machine_state(&ref, true);
+	char *actual = machine_state(&cmp, true);
+	mu_assert_streq(actual, expect, "same state");
+	free(expect);
+	free(actual);
+	rz_il_code_free(code);
+	rz_il_op_effect_free(op);
+	machine_fini(&ref);
+	machine_fini(&cmp);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_il_compile_pure);
+	mu_run_test(test_il_compile_div);
+	mu_run_test(test_il_compile_locals);
+	mu_run_test(test_il_compile_mem);
+	mu_run_test(test_il_compile_jumps);
+	mu_run_test(test_il_compile_fallback);
+	mu_run_test(test_il_compile_steps);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -58,6 +58,109 @@ bool test_rz_io_cache(void) {
 	mu_end;
 }
 
+bool test_rz_io_cache_pages(void) {
+	RzIO *io = rz_io_new();
+	rz_io_open(io, "malloc://0x3000", RZ_PERM_RW, 0);
+	io->cached = RZ_PERM_RW;
+	// adjacent writes crossing a page boundary get coalesced
+	mu_assert_true(rz_io_write_at(io, 0xffe, (ut8 *)"AB", 2), "write");
+	mu_assert_true(rz_io_write_at(io, 0x1000, (ut8 *)"CD", 2), "write");
+	mu_assert_true(rz_io_write_at(io, 0x2000, (ut8 *)"EF", 2), "write");
+	RzIOCacheStats stats;
+	rz_io_cache_stats(io, &stats);
+	mu_assert_eq(stats.pages, 3, "pages");
+	mu_assert_eq(stats.bytes, 6, "patched bytes");
+	mu_assert_true(stats.mem > 3 * sizeof(RzIOCachePage), "memory usage");
+
+	RzList *caches = rz_io_cache_list(io);
+	mu_assert_eq(rz_list_length(caches), 2, "coalesced cache ranges");
+	RzIOCache *c = rz_list_first(caches);
+	mu_assert_eq(c->itv.addr, 0xffe, "coalesced range addr");
+	mu_assert_eq(c->itv.size, 4, "coalesced range size");
+	mu_assert_memeq(c->data, (ut8 *)"ABCD", 4, "coalesced range data");
+	mu_assert_memeq(c->odata, (ut8 *)"\x00\x00\x00\x00", 4, "coalesced range original data");
+	rz_list_free(caches);
+
+	// writes are invalidated as a whole, pages are released once all of their bytes are
+	mu_assert_eq(rz_io_cache_invalidate(io, 0x1001, 0x1002), 1, "invalidated writes");
+	rz_io_cache_stats(io, &stats);
+	mu_assert_eq(stats.pages, 2, "pages after invalidate");
+	mu_assert_eq(stats.bytes, 4, "patched bytes after invalidate");
+	mu_assert_false(rz_io_cache_at(io, 0x1000), "no cache at 0x1000");
+	mu_assert_true(rz_io_cache_at(io, 0x2001), "cache at 0x2001");
+
+	// the older writes below an invalidated one are visible again
+	rz_io_write_at(io, 0x2000, (ut8 *)"GHIJ", 4);
+	mu_assert_eq(rz_io_cache_invalidate(io, 0x2002, 0x2003), 1, "invalidated writes");
+	ut8 buf[4];
+	rz_io_read_at(io, 0x2000, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"EF\x00\x00", sizeof(buf), "older write revealed");
+
+	// rewriting the range of a write replaces it in the log
+	rz_io_write_at(io, 0x2800, (ut8 *)"KL", 2);
+	rz_io_cache_stats(io, &stats);
+	const ut64 mem = stats.mem;
+	for (int i = 0; i < 0x100; i++) {
+		rz_io_write_at(io, 0x2800, (ut8 *)&i, 2);
+	}
+	rz_io_cache_stats(io, &stats);
+	mu_assert_eq(stats.mem, mem, "log of rewritten range");
+	mu_assert_eq(rz_io_cache_invalidate(io, 0x2800, 0x2801), 1, "invalidated writes");
+	mu_assert_false(rz_io_cache_at(io, 0x2800), "no cache at 0x2800");
+
+	// push/pop restores the previous state of the cache
+	mu_assert_true(rz_io_cache_push(io), "push");
+	rz_io_write_at(io, 0x10, (ut8 *)"XX", 2);
+	mu_assert_true(rz_io_cache_at(io, 0x10), "cache at 0x10");
+	mu_assert_true(rz_io_cache_pop(io), "pop");
+	mu_assert_false(rz_io_cache_at(io, 0x10), "no cache at 0x10 after pop");
+	mu_assert_true(rz_io_cache_at(io, 0xfff), "cache at 0xfff after pop");
+
+	rz_io_cache_reset(io, io->cached);
+	rz_io_cache_stats(io, &stats);
+	mu_assert_eq(stats.mem, 0, "memory usage after reset");
+	rz_io_free(io);
+	mu_end;
+}
+
+bool test_rz_io_view(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	RzIODesc *desc = rz_io_open_at(io, "malloc://8", RZ_PERM_RW, 0644, 0x100, NULL);
+	mu_assert_notnull(desc, "open malloc");
+	rz_io_write_at(io, 0x100, (const ut8 *)"ABCDEFGH", 8);
+
+	ut8 buf[8] = { 0 };
+	RzIOView view;
+	mu_assert_true(rz_io_view_at(io, 0x102, buf, 4, &view), "view");
+	mu_assert_true(view.borrowed, "view over malloc should be borrowed");
+	mu_assert_ptrneq(view.data, buf, "borrowed view must not use the fallback buffer");
+	mu_assert_memeq(view.data, (const ut8 *)"CDEF", 4, "view contents");
+	mu_assert_true(rz_io_view_is_valid(io, &view), "fresh view is valid");
+
+	rz_io_write_at(io, 0x102, (const ut8 *)"cd", 2);
+	mu_assert_false(rz_io_view_is_valid(io, &view), "view is stale after a write");
+
+	// partially unmapped range falls back to a copy
+	memset(buf, 0, sizeof(buf));
+	rz_io_view_at(io, 0xfe, buf, 8, &view);
+	mu_assert_false(view.borrowed, "view crossing a gap must be copied");
+	mu_assert_ptreq(view.data, buf, "copied view uses the fallback buffer");
+	mu_assert_memeq(view.data + 2, (const ut8 *)"ABcdEF", 6, "copied view contents");
+
+	// cached patches are never borrowed
+	io->cached = RZ_PERM_RW;
+	rz_io_cache_write(io, 0x104, (const ut8 *)"ZZ", 2);
+	mu_assert_true(rz_io_view_at(io, 0x100, buf, 8, &view), "view");
+	mu_assert_false(view.borrowed, "view over a cached patch must be copied");
+	mu_assert_memeq(view.data, (const ut8 *)"ABcdZZGH", 8, "copied view with cache contents");
+	mu_assert_true(rz_io_view_at(io, 0x100, buf, 4, &view), "view");
+	mu_assert_true(view.borrowed, "view next to a cached patch can be borrowed");
+
+	rz_io_free(io);
+	mu_end;
+}
+
 bool test_rz_io_mapsplit(void) {
 	RzIO *io = rz_io_new();
 	io->va = true;
@@ -630,8 +733,70 @@ bool test_rz_io_map_del_on_close_all(void) {
 	mu_end;
 }
 
+typedef struct {
+	ut8 mem[0x2000];
+	ut64 readable; ///< bytes readable from 0
+	int requests;
+} FakeRemote;
+
+static int fake_remote_read(void *user, ut64 addr, ut8 *buf, int len) {
+	FakeRemote *remote = user;
+	remote->requests++;
+	if (addr >= remote->readable) {
+		return -1;
+	}
+	len = RZ_MIN(len, remote->readable - addr);
+	memcpy(buf, remote->mem + addr, len);
+	return len;
+}
+
+bool test_rz_io_remote_cache(void) {
+	FakeRemote remote = { .readable = 0x1800 };
+	for (size_t i = 0; i < sizeof(remote.mem); i++) {
+		remote.mem[i] = i * 7;
+	}
+	RzIORemoteCache *cache = rz_io_remote_cache_new(fake_remote_read, &remote);
+	rz_io_remote_cache_setup(cache, 0x100, 2);
+
+	ut8 buf[0x300];
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x10, buf, 0x20), 0x20, "first read");
+	mu_assert_memeq(buf, remote.mem + 0x10, 0x20, "first read bytes");
+	mu_assert_eq(remote.requests, 1, "page and read-ahead fetched at once");
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0xf0, buf, 0x300), 0x300, "read ahead");
+	mu_assert_memeq(buf, remote.mem + 0xf0, 0x300, "read ahead bytes");
+	mu_assert_eq(remote.requests, 2, "only the page after the read-ahead fetched");
+
+	remote.mem[0x20] = 0x42;
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x20, buf, 1), 1, "cached read");
+	mu_assert_eq(buf[0], (ut8)(0x20 * 7), "stale until invalidated");
+	rz_io_remote_cache_invalidate(cache, 0x20, 1);
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x20, buf, 1), 1, "read after invalidate");
+	mu_assert_eq(buf[0], 0x42, "fetched again");
+
+	// the pages after 0x1800 cannot be read
+	remote.requests = 0;
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x1780, buf, 0x80), 0x80, "read before the end");
+	mu_assert_memeq(buf, remote.mem + 0x1780, 0x80, "read before the end bytes");
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x17f0, buf, 0x20), 0x10, "read across the end");
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x1900, buf, 0x20), -1, "read after the end");
+
+	RzIORemoteCacheStats stats;
+	rz_io_remote_cache_stats(cache, &stats);
+	mu_assert_eq(stats.reads, 7, "reads");
+
+	rz_io_remote_cache_setup(cache, 0, 0);
+	remote.requests = 0;
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x10, buf, 0x20), 0x20, "disabled cache");
+	mu_assert_eq(rz_io_remote_cache_read(cache, 0x10, buf, 0x20), 0x20, "disabled cache");
+	mu_assert_eq(remote.requests, 2, "every read sent");
+	rz_io_remote_cache_free(cache);
+	mu_end;
+}
+
 bool all_tests(void) {
 	mu_run_test(test_rz_io_cache);
+	mu_run_test(test_rz_io_cache_pages);
+	mu_run_test(test_rz_io_view);
 	mu_run_test(test_rz_io_mapsplit);
 	mu_run_test(test_rz_io_mapsplit2);
 	mu_run_test(test_rz_io_mapsplit3);
@@ -647,6 +812,7 @@ bool all_tests(void) {
 	mu_run_test(test_rz_io_map_del_for_fd);
 	mu_run_test(test_rz_io_map_del_on_close);
 	mu_run_test(test_rz_io_map_del_on_close_all);
+	mu_run_test(test_rz_io_remote_cache);
 	return tests_passed != tests_run;
 }
 
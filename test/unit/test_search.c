@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_search.h>
+#include <ctype.h>
+#include "minunit.h"
+
+#define DATA_SIZE 0x4000
+
+typedef struct {
+	ut64 addr;
+	int kw;
+} Hit;
+
+static ut8 data[DATA_SIZE];
+
+static void data_init(void) {
+	ut32 seed = 0x1337;
+	for (size_t i = 0; i < sizeof(data); i++) {
+		mu_rand(&seed);
+		// small alphabet, so that the keywords share prefixes and suffixes
+		data[i] = "abcdABCD\x00\xff"[(seed >> 16) % 10];
+	}
+}
+
+static bool kw_matches(const RzSearchKeyword *kw, const ut8 *buf) {
+	for (ut32 j = 0; j < kw->keyword_length; j++) {
+		ut8 a = buf[j], b = kw->bin_keyword[j];
+		ut8 mask = kw->binmask_length ? kw->bin_binmask[j % kw->binmask_length] : 0xff;
+		if (kw->icase) {
+			a = tolower(a);
+			b = tolower(b);
+		}
+		if ((a & mask) != (b & mask)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Reference search: every keyword on its own, non overlapping hits
+static RzList *naive_hits(RzSearch *s, ut64 from) {
+	RzList *hits = rz_list_newf(free);
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	int n = 0;
+	rz_list_foreach (s->kws, iter, kw) {
+		for (ut32 i = 0; i + kw->keyword_length <= sizeof(data); i++) {
+			if (kw_matches(kw, data + i)) {
+				Hit *hit = RZ_NEW0(Hit);
+				hit->addr = from + i;
+				hit->kw = n;
+				rz_list_append(hits, hit);
+				i += kw->keyword_length - 1;
+			}
+		}
+		n++;
+	}
+	return hits;
+}
+
+static int hit_cb(RzSearchKeyword *kw, void *user, ut64 addr) {
+	Hit *hit = RZ_NEW0(Hit);
+	hit->addr = addr;
+	hit->kw = kw->kwidx;
+	rz_list_append(user, hit);
+	return 1;
+}
+
+static int hit_cmp(const void *a, const void *b) {
+	const Hit *ha = a, *hb = b;
+	if (ha->kw != hb->kw) {
+		return ha->kw - hb->kw;
+	}
+	return ha->addr < hb->addr ? -1 : ha->addr > hb->addr;
+}
+
+/**
+ * With \p per_offset every keyword gets a mask with no fully unmasked byte,
+ * which keeps it out of the Aho-Corasick matcher, so that it is searched at
+ * every offset like before. Bit 0x08 is never the only difference between
+ * two bytes of the data, so the hits stay the same.
+ */
+static RzSearch *search_new(bool per_offset) {
+	static const ut8 mask[] = { 0xf7, 0xf7, 0xf7, 0xf7, 0xf7, 0xf7, 0xf7, 0xf7, 0xf7, 0xf7 };
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	s->contiguous = true;
+	// slices of the data, with and without hits elsewhere
+	for (int i = 0; i < 64; i++) {
+		int off = (i * 797) % (DATA_SIZE - 16);
+		int len = 2 + i % 9;
+		rz_search_kw_add(s, rz_search_keyword_new(data + off, len, per_offset ? mask : NULL, per_offset ? len : 0, NULL));
+	}
+	rz_search_kw_add(s, rz_search_keyword_new_str("AbCd", per_offset ? "f7f7f7f7" : NULL, NULL, true));
+	rz_search_kw_add(s, rz_search_keyword_new_str("ab", per_offset ? "f7f7" : NULL, NULL, false));
+	// masked, with an anchor of 2 bytes
+	rz_search_kw_add(s, rz_search_keyword_new_hex("61ff0062", per_offset ? "f7f700f7" : "ffff00ff", NULL));
+	// masked, without any fully unmasked byte
+	rz_search_kw_add(s, rz_search_keyword_new_hex("41424344", per_offset ? "d7d7d7d7" : "dfdfdfdf", NULL));
+	rz_search_kw_add(s, per_offset ? rz_search_keyword_new_hex("0000ff", "f700f7", NULL) : rz_search_keyword_new_hexmask("00..ff", NULL));
+	return s;
+}
+
+static bool search_blocks(RzSearch *s, ut64 from, int bsize, RzList *hits) {
+	rz_search_set_callback(s, hit_cb, hits);
+	rz_search_begin(s);
+	for (int i = 0; i < DATA_SIZE; i += bsize) {
+		if (rz_search_update(s, from + i, data + i, RZ_MIN(bsize, DATA_SIZE - i)) < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool hits_equal(RzList *a, RzList *b) {
+	mu_assert_eq(rz_list_length(a), rz_list_length(b), "hit count");
+	RzListIter *ia = rz_list_iterator(a), *ib = rz_list_iterator(b);
+	while (ia && ib) {
+		Hit *ha = rz_list_iter_get_data(ia), *hb = rz_list_iter_get_data(ib);
+		mu_assert_eq(ha->kw, hb->kw, "hit keyword");
+		mu_assert_eq(ha->addr, hb->addr, "hit address");
+		ia = rz_list_iter_get_next(ia);
+		ib = rz_list_iter_get_next(ib);
+	}
+	return true;
+}
+
+bool test_search_keywords_single_block(void) {
+	RzSearch *s = search_new(false);
+	RzList *expect = naive_hits(s, 0x1000);
+	RzList *hits = rz_list_newf(free);
+	mu_assert_true(search_blocks(s, 0x1000, DATA_SIZE, hits), "search");
+	mu_assert_true(rz_list_length(hits) > 64, "enough hits");
+	// a single block reports the hits keyword by keyword
+	mu_assert_true(hits_equal(expect, hits), "same hits as the reference");
+	rz_list_free(hits);
+	rz_list_free(expect);
+	rz_search_free(s);
+	mu_end;
+}
+
+bool test_search_keywords_blocks(void) {
+	static const int bsizes[] = { 1, 3, 7, 64, 1000 };
+	RzSearch *s = search_new(false);
+	RzList *expect = naive_hits(s, 0);
+	rz_list_sort(expect, hit_cmp);
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(bsizes); i++) {
+		RzList *hits = rz_list_newf(free);
+		mu_assert_true(search_blocks(s, 0, bsizes[i], hits), "search");
+		// hits crossing the block boundaries are found once
+		rz_list_sort(hits, hit_cmp);
+		mu_assert_true(hits_equal(expect, hits), "same hits as the reference");
+		rz_list_free(hits);
+	}
+	rz_list_free(expect);
+	rz_search_free(s);
+	mu_end;
+}
+
+bool test_search_keywords_per_offset(void) {
+	static const int bsizes[] = { 1, 7, 1000, DATA_SIZE };
+	RzSearch *s = search_new(false);
+	RzSearch *ref = search_new(true);
+	for (int overlap = 0; overlap < 2; overlap++) {
+		s->overlap = ref->overlap = overlap;
+		for (size_t i = 0; i < RZ_ARRAY_SIZE(bsizes); i++) {
+			RzList *hits = rz_list_newf(free);
+			RzList *expect = rz_list_newf(free);
+			// the keywords found by the matcher and the ones tried at every offset
+			mu_assert_true(search_blocks(s, 0x1000, bsizes[i], hits), "search");
+			mu_assert_true(search_blocks(ref, 0x1000, bsizes[i], expect), "per offset search");
+			mu_assert_true(rz_list_length(hits) > 64, "enough hits");
+			mu_assert_true(hits_equal(expect, hits), "same hits as every offset");
+			rz_list_free(hits);
+			rz_list_free(expect);
+		}
+	}
+	rz_search_free(ref);
+	rz_search_free(s);
+	mu_end;
+}
+
+bool test_search_keywords_overlap(void) {
+	static const ut8 buf[] = "aaaaaXaaa";
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	s->contiguous = true;
+	rz_search_kw_add(s, rz_search_keyword_new_str("aa", NULL, NULL, false));
+	rz_search_kw_add(s, rz_search_keyword_new_str("aaX", NULL, NULL, false));
+	RzList *hits = rz_list_newf(free);
+	rz_search_set_callback(s, hit_cb, hits);
+	rz_search_begin(s);
+	rz_search_update(s, 0, buf, sizeof(buf) - 1);
+	mu_assert_eq(rz_list_length(hits), 4, "non overlapping hits");
+	rz_list_purge(hits);
+
+	s->overlap = true;
+	rz_search_begin(s);
+	rz_search_update(s, 0x100, buf, sizeof(buf) - 1);
+	mu_assert_eq(rz_list_length(hits), 7, "overlapping hits");
+	Hit *hit = rz_list_last(hits);
+	mu_assert_eq(hit->kw, 1, "last keyword");
+	mu_assert_eq(hit->addr, 0x103, "last hit");
+	rz_list_free(hits);
+	rz_search_free(s);
+	mu_end;
+}
+
+int all_tests() {
+	data_init();
+	mu_run_test(test_search_keywords_single_block);
+	mu_run_test(test_search_keywords_blocks);
+	mu_run_test(test_search_keywords_per_offset);
+	mu_run_test(test_search_keywords_overlap);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
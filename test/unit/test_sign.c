@@ -111,8 +111,157 @@ static bool test_analysis_sign_get_set(void) {
 	mu_end;
 }
 
+#define SIGN_FUNCTIONS 32
+
+typedef struct {
+	RzAnalysisFunction *fcn;
+	RzSignGraph *graph;
+	RzList /*<char *>*/ *matches;
+} SignLinearSearch;
+
+/**
+ * Matches the addresses and the graphs the same way as the search through
+ * every zignature did before the store.
+ */
+static int sign_linear_match(RzSignItem *it, void *user) {
+	SignLinearSearch *ls = user;
+	if (it->addr != UT64_MAX && it->addr == ls->fcn->addr) {
+		rz_list_append(ls->matches, rz_str_newf("%s:%c", it->name, RZ_SIGN_OFFSET));
+	}
+	RzSignGraph *g = it->graph;
+	if (!g) {
+		return 1;
+	}
+	// -1 matches any value and a close size does not match, as in fcnMetricsCmp()
+	ut64 size = rz_analysis_function_linear_size(ls->fcn);
+	int ebbs = g->edges != -1 ? ls->graph->ebbs : -1;
+	if ((g->cc == -1 || g->cc == ls->graph->cc) &&
+		(g->nbbs == -1 || g->nbbs == ls->graph->nbbs) &&
+		(g->edges == -1 || g->edges == ls->graph->edges) &&
+		(g->ebbs == -1 || g->ebbs == ebbs) &&
+		(g->bbsum <= 0 || RZ_ABS(g->bbsum - (int)size) >= g->bbsum / 10)) {
+		rz_list_append(ls->matches, rz_str_newf("%s:%c", it->name, RZ_SIGN_GRAPH));
+	}
+	return 1;
+}
+
+static int sign_store_match(RzSignItem *it, RzAnalysisFunction *fcn, RzSignType type, bool seen, void *user) {
+	rz_list_append(user, rz_str_newf("%s:%c", it->name, type));
+	return 1;
+}
+
+static bool sign_matches_eq(RzAnalysis *analysis, RzSignStore *store, RzAnalysisFunction *fcn) {
+	RzSignItem *it = rz_sign_item_new();
+	rz_sign_addto_item(analysis, it, fcn, RZ_SIGN_GRAPH);
+	SignLinearSearch ls = { fcn, it->graph, rz_list_newf(free) };
+	rz_sign_foreach(analysis, sign_linear_match, &ls);
+
+	RzList *matches = rz_list_newf(free);
+	RzSignSearchMetrics sm = {
+		.types = { RZ_SIGN_OFFSET, RZ_SIGN_GRAPH, 0 },
+		.analysis = analysis,
+		.user = matches,
+		.cb = sign_store_match,
+		.fcn = fcn,
+	};
+	int matched = rz_sign_store_match_metrics(store, &sm);
+	mu_assert_eq(matched, rz_list_length(ls.matches), "match count");
+	rz_list_sort(matches, (RzListComparator)strcmp);
+	rz_list_sort(ls.matches, (RzListComparator)strcmp);
+	RzListIter *it_a, *it_b;
+	for (it_a = rz_list_iterator(matches), it_b = rz_list_iterator(ls.matches); it_a && it_b; it_a = it_a->n, it_b = it_b->n) {
+		mu_assert_streq(it_a->data, it_b->data, "same match");
+	}
+	rz_list_free(matches);
+	rz_list_free(ls.matches);
+	rz_sign_item_free(it);
+	mu_end;
+}
+
+static bool test_sign_store(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	rz_sign_analysis_set_hooks(analysis);
+
+	// functions of 1 to 3 blocks, so that the graphs of every third one are the same
+	RzAnalysisFunction *fcns[SIGN_FUNCTIONS];
+	char name[32];
+	for (size_t i = 0; i < SIGN_FUNCTIONS; i++) {
+		ut64 addr = 0x1000 + i * 0x100;
+		snprintf(name, sizeof(name), "fcn.%" PFMTSZu, i);
+		fcns[i] = rz_analysis_create_function(analysis, name, addr, RZ_ANALYSIS_FCN_TYPE_FCN, NULL);
+		mu_assert_notnull(fcns[i], "function");
+		for (size_t j = 0; j <= i % 3; j++) {
+			RzAnalysisBlock *block = rz_analysis_create_block(analysis, addr + j * 0x20, 0x10);
+			rz_analysis_function_add_block(fcns[i], block);
+			rz_analysis_block_unref(block);
+		}
+	}
+
+	// zignatures by address, some sharing one or without a function there
+	for (size_t i = 0; i < 48; i++) {
+		snprintf(name, sizeof(name), "sym.addr.%" PFMTSZu, i);
+		mu_assert_true(rz_sign_add_addr(analysis, name, 0x1000 + (i % 40) * 0x100), "add addr");
+	}
+	for (size_t i = 0; i < 6; i++) {
+		RzSignItem *it = rz_sign_item_new();
+		snprintf(name, sizeof(name), "sym.graph.%" PFMTSZu, i);
+		it->name = strdup(name);
+		mu_assert_true(rz_sign_addto_item(analysis, it, fcns[i], RZ_SIGN_GRAPH), "graph");
+		mu_assert_true(rz_sign_add_item(analysis, it), "add graph");
+		rz_sign_item_free(it);
+	}
+	rz_spaces_set(&analysis->zign_spaces, "other");
+	mu_assert_true(rz_sign_add_addr(analysis, "sym.other", 0x1000), "add in another space");
+	rz_spaces_set(&analysis->zign_spaces, NULL);
+
+	RzSignStore *store = rz_sign_store_new(analysis);
+	mu_assert_notnull(store, "store");
+	mu_assert_eq(rz_sign_store_len(store), 48 + 6, "zignatures of the current space");
+	mu_assert_true(rz_sign_store_prepare(store, analysis->fcns, 2), "prepare");
+	for (size_t i = 0; i < SIGN_FUNCTIONS; i++) {
+		mu_assert_true(sign_matches_eq(analysis, store, fcns[i]), "same matches as the linear search");
+	}
+	rz_sign_store_free(store);
+
+	// adding again a name merges into its zignature, and removed ones are not seen anymore
+	mu_assert_true(rz_sign_add_addr(analysis, "sym.addr.0", 0x1000 + 20 * 0x100), "add duplicate");
+	mu_assert_true(rz_sign_delete(analysis, "sym.addr.1"), "delete");
+	mu_assert_true(rz_sign_delete(analysis, "sym.graph.2"), "delete");
+	store = rz_sign_store_new(analysis);
+	mu_assert_notnull(store, "store");
+	mu_assert_eq(rz_sign_store_len(store), 48 + 6 - 2, "zignatures of the current space");
+	for (size_t i = 0; i < SIGN_FUNCTIONS; i++) {
+		mu_assert_true(sign_matches_eq(analysis, store, fcns[i]), "same matches as the linear search");
+	}
+	RzList *matches = rz_list_newf(free);
+	RzSignSearchMetrics sm = {
+		.types = { RZ_SIGN_OFFSET, 0 },
+		.analysis = analysis,
+		.user = matches,
+		.cb = sign_store_match,
+		.fcn = fcns[20],
+	};
+	mu_assert_eq(rz_sign_store_match_metrics(store, &sm), 2, "duplicate name at its new address");
+	rz_list_sort(matches, (RzListComparator)strcmp);
+	mu_assert_streq(rz_list_get_n(matches, 0), "sym.addr.0:o", "merged");
+	mu_assert_streq(rz_list_get_n(matches, 1), "sym.addr.20:o", "own address");
+	rz_list_purge(matches);
+	sm.fcn = fcns[0];
+	mu_assert_eq(rz_sign_store_match_metrics(store, &sm), 1, "not at its old address");
+	mu_assert_streq(rz_list_first(matches), "sym.addr.40:o", "other zignature at the address");
+	rz_list_purge(matches);
+	sm.fcn = fcns[1];
+	mu_assert_eq(rz_sign_store_match_metrics(store, &sm), 1, "removed");
+	mu_assert_streq(rz_list_first(matches), "sym.addr.41:o", "other zignature at the address");
+	rz_list_free(matches);
+	rz_sign_store_free(store);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 int all_tests(void) {
 	mu_run_test(test_analysis_sign_get_set);
+	mu_run_test(test_sign_store);
 	return tests_passed != tests_run;
 }
 
@@ -308,6 +308,145 @@ bool test_rz_scan_strings_utf16_be(void) {
 	mu_end;
 }
 
+bool test_rz_scan_strings_windows(void) {
+	RzUtilStrScanOptions opt = {
+		.buf_size = 2048,
+		.max_uni_blocks = 4,
+		.min_str_length = 4,
+		.prefer_big_endian = false,
+		.max_threads = 1
+	};
+	const size_t size = 0x180000;
+	ut8 *blob = calloc(size, 1);
+	// straddling the end of the first window
+	const ut64 at = 0x100000 - 6;
+	memcpy(blob + at, "straddling", 10);
+	// utf16le at the end of the buffer, the range going past it
+	const ut64 at_end = size - 12;
+	memcpy(blob + at_end, "l\0a\0s\0t\0!\0", 10);
+	RzBuffer *buf = rz_buf_new_with_bytes(blob, size);
+
+	RzList *str_list = rz_list_newf((RzListFree)rz_detected_string_free);
+	int n = rz_scan_strings(buf, str_list, &opt, 0, size + 0x1000, RZ_STRING_ENC_GUESS);
+	mu_assert_eq(n, 2, "rz_scan_strings windows, number of strings");
+
+	RzDetectedString *s = rz_list_get_n(str_list, 0);
+	mu_assert_streq(s->string, "straddling", "rz_scan_strings windows, straddling string");
+	mu_assert_eq(s->addr, at, "rz_scan_strings windows, straddling address");
+	s = rz_list_get_n(str_list, 1);
+	mu_assert_streq(s->string, "last!", "rz_scan_strings windows, last string");
+	mu_assert_eq(s->addr, at_end, "rz_scan_strings windows, last address");
+	mu_assert_eq(s->type, RZ_STRING_ENC_UTF16LE, "rz_scan_strings windows, last type");
+
+	rz_list_free(str_list);
+	rz_buf_free(buf);
+	free(blob);
+	mu_end;
+}
+
+// Random bytes between strings of all the encodings, some of them long enough to straddle the chunks
+static ut8 *strings_blob_new(size_t size, ut32 seed) {
+	static const char *words[] = { "hello", "rizin", "Who's there?", "Nay, answer me", "\xc3\x99TF-8", "torre", "alfiere", "0123456789" };
+	ut8 *blob = malloc(size);
+	size_t at = 0;
+	while (at < size) {
+		ut32 r = mu_rand(&seed) >> 8;
+		size_t n = RZ_MIN(size - at, 1 + (r % 64));
+		if (r & 0x100) {
+			for (size_t i = 0; i < n; i++) {
+				blob[at++] = mu_rand(&seed) >> 8;
+			}
+			continue;
+		}
+		ut32 enc = (mu_rand(&seed) >> 8) % 6;
+		ut32 nwords = 1 + ((mu_rand(&seed) >> 8) % ((r & 0x200) ? 200 : 8));
+		for (ut32 w = 0; w < nwords && at < size; w++) {
+			const char *word = words[(mu_rand(&seed) >> 8) % RZ_ARRAY_SIZE(words)];
+			for (const char *c = word; *c && at < size; c++) {
+				ut8 ch = *c;
+				switch (enc) {
+				case 1: // utf16le
+					blob[at++] = ch;
+					if (at < size) {
+						blob[at++] = 0;
+					}
+					break;
+				case 2: // utf16be
+					blob[at++] = 0;
+					if (at < size) {
+						blob[at++] = ch;
+					}
+					break;
+				case 3: // utf32le
+					blob[at++] = ch;
+					for (int i = 0; i < 3 && at < size; i++) {
+						blob[at++] = 0;
+					}
+					break;
+				case 4: // ibm037 letters
+					blob[at++] = ch >= 'a' && ch <= 'i' ? 0x81 + ch - 'a' : 0x40;
+					break;
+				default:
+					blob[at++] = ch;
+					break;
+				}
+			}
+		}
+		if (at < size) {
+			blob[at++] = 0;
+		}
+	}
+	return blob;
+}
+
+static char *strings_dump(RzList *list) {
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	RzListIter *it;
+	RzDetectedString *s;
+	rz_list_foreach (list, it, s) {
+		rz_strbuf_appendf(sb, "0x%" PFMT64x " %u %u %d %s\n", s->addr, s->size, s->length, s->type, s->string);
+	}
+	return rz_strbuf_drain(sb);
+}
+
+bool test_rz_scan_strings_threads(void) {
+	RzUtilStrScanOptions opt = {
+		.buf_size = 2048,
+		.max_uni_blocks = 4,
+		.min_str_length = 4,
+		.prefer_big_endian = false
+	};
+	const size_t size = 0x180000;
+	static const RzStrEnc types[] = { RZ_STRING_ENC_GUESS, RZ_STRING_ENC_8BIT, RZ_STRING_ENC_UTF16LE, RZ_STRING_ENC_IBM037 };
+	for (ut32 seed = 1; seed <= 3; seed++) {
+		ut8 *blob = strings_blob_new(size, seed);
+		RzBuffer *buf = rz_buf_new_with_bytes(blob, size);
+		for (size_t t = 0; t < RZ_ARRAY_SIZE(types); t++) {
+			// shifting the range moves the limits of the chunks
+			ut64 from = (seed * 0x1357 + t * 0x11) % 0x1000;
+			opt.max_threads = 1;
+			RzList *seq = rz_list_newf((RzListFree)rz_detected_string_free);
+			int n = rz_scan_strings(buf, seq, &opt, from, size, types[t]);
+			mu_assert_true(n > 0, "strings found");
+			char *expect = strings_dump(seq);
+			for (size_t threads = 2; threads <= 6; threads += 2) {
+				opt.max_threads = threads;
+				RzList *par = rz_list_newf((RzListFree)rz_detected_string_free);
+				mu_assert_eq(rz_scan_strings(buf, par, &opt, from, size, types[t]), n, "same number of strings");
+				char *actual = strings_dump(par);
+				mu_assert_streq(actual, expect, "same strings");
+				free(actual);
+				rz_list_free(par);
+			}
+			free(expect);
+			rz_list_free(seq);
+		}
+		rz_buf_free(buf);
+		free(blob);
+	}
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_ascii);
 	mu_run_test(test_rz_scan_strings_detect_ibm037);
@@ -319,6 +458,8 @@ bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_utf32_be);
 
 	mu_run_test(test_rz_scan_strings_utf16_be);
+	mu_run_test(test_rz_scan_strings_windows);
+	mu_run_test(test_rz_scan_strings_threads);
 	return tests_passed != tests_run;
 }
 
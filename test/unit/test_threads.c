@@ -24,8 +24,55 @@ bool test_thread_pool_cores(void) {
 	mu_end;
 }
 
+typedef struct {
+	const ut32 *values;
+	size_t first;
+	size_t last;
+	ut64 sum;
+} SumShard;
+
+static void sum_shard(void *user) {
+	SumShard *shard = user;
+	for (size_t i = shard->first; i < shard->last; i++) {
+		shard->sum += shard->values[i];
+	}
+}
+
+bool test_thread_pool_shards(void) {
+	ut32 values[1000];
+	ut64 expected = 0;
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(values); i++) {
+		values[i] = i * 7;
+		expected += values[i];
+	}
+	const size_t min_parallel[] = { 0, RZ_ARRAY_SIZE(values) + 1 };
+	for (size_t m = 0; m < RZ_ARRAY_SIZE(min_parallel); m++) {
+		size_t nshards = 0;
+		RzThreadPool *pool = rz_th_pool_new_shards(4, RZ_ARRAY_SIZE(values), min_parallel[m], &nshards);
+		mu_assert_eq(nshards, pool ? pool->size : 1, "shards");
+		if (m) {
+			mu_assert_null(pool, "not worth a thread");
+		}
+		SumShard shards[4] = { 0 };
+		const size_t per_shard = (RZ_ARRAY_SIZE(values) + nshards - 1) / nshards;
+		for (size_t t = 0; t < nshards; t++) {
+			shards[t].values = values;
+			shards[t].first = RZ_MIN(RZ_ARRAY_SIZE(values), t * per_shard);
+			shards[t].last = RZ_MIN(RZ_ARRAY_SIZE(values), shards[t].first + per_shard);
+		}
+		rz_th_pool_run_shards(pool, shards, sizeof(SumShard), nshards, sum_shard);
+		ut64 sum = 0;
+		for (size_t t = 0; t < nshards; t++) {
+			sum += shards[t].sum;
+		}
+		mu_assert_eq(sum, expected, "sum of the shards");
+	}
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_thread_pool_cores);
+	mu_run_test(test_thread_pool_shards);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "minunit.h"
+
+static bool expect_pc(RzTraceStoreReader *reader, ut64 pc) {
+	RzTraceStoreRecord record;
+	return rz_trace_store_reader_next(reader, &record) && record.type == RZ_TRACE_STORE_PC && record.addr == pc;
+}
+
+bool test_trace_store_records(void) {
+	RzTraceStore *store = rz_trace_store_new(NULL);
+	mu_assert_notnull(store, "store");
+	const ut8 data[] = { 0xde, 0xad, 0xbe, 0xef };
+	rz_trace_store_add_pc(store, 0x1000);
+	rz_trace_store_add_reg(store, 3, 0x1337);
+	rz_trace_store_add_pc(store, 0x1004);
+	rz_trace_store_add_mem(store, 0x7ffc, data, sizeof(data));
+	rz_trace_store_add_pc(store, 0x800);
+	rz_trace_store_add_pc(store, UT64_MAX);
+	rz_trace_store_add_pc(store, 0x1000);
+	mu_assert_eq(rz_trace_store_steps(store), 5, "steps");
+	mu_assert_eq(rz_trace_store_hits(store, 0x1000), 2, "hits");
+	mu_assert_eq(rz_trace_store_hits(store, 0x1004), 1, "hits");
+	mu_assert_eq(rz_trace_store_hits(store, 0x1008), 0, "hits");
+
+	RzTraceStoreReader reader;
+	RzTraceStoreRecord record;
+	rz_trace_store_reader_init(&reader, store);
+	mu_assert_true(expect_pc(&reader, 0x1000), "pc");
+	mu_assert_true(rz_trace_store_reader_next(&reader, &record), "reg");
+	mu_assert_eq(record.type, RZ_TRACE_STORE_REG, "reg");
+	mu_assert_eq(record.reg, 3, "reg");
+	mu_assert_eq(record.value, 0x1337, "reg value");
+	mu_assert_true(expect_pc(&reader, 0x1004), "pc");
+	mu_assert_true(rz_trace_store_reader_next(&reader, &record), "mem");
+	mu_assert_eq(record.type, RZ_TRACE_STORE_MEM, "mem");
+	mu_assert_eq(record.addr, 0x7ffc, "mem addr");
+	mu_assert_memeq(record.data, data, sizeof(data), "mem data");
+	mu_assert_true(expect_pc(&reader, 0x800), "backwards pc");
+	mu_assert_true(expect_pc(&reader, UT64_MAX), "far pc");
+	mu_assert_true(expect_pc(&reader, 0x1000), "far pc");
+	mu_assert_false(rz_trace_store_reader_next(&reader, &record), "end");
+	rz_trace_store_free(store);
+	mu_end;
+}
+
+static bool coverage_cb(void *user, ut64 addr, ut64 hits) {
+	RzStrBuf *sb = user;
+	rz_strbuf_appendf(sb, "0x%" PFMT64x ":%" PFMT64u " ", addr, hits);
+	return true;
+}
+
+bool test_trace_store_coverage(void) {
+	RzTraceStore *store = rz_trace_store_new(NULL);
+	const ut64 pcs[] = { 0x30, 0x10, 0x20, 0x10, 0x30, 0x10 };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(pcs); i++) {
+		rz_trace_store_add_pc(store, pcs[i]);
+	}
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	mu_assert_true(rz_trace_store_coverage(store, coverage_cb, &sb), "coverage");
+	mu_assert_streq(rz_strbuf_get(&sb), "0x10:3 0x20:1 0x30:2 ", "sorted coverage");
+	rz_strbuf_fini(&sb);
+	rz_trace_store_free(store);
+	mu_end;
+}
+
+static bool store_chunks(const char *spill) {
+	RzTraceStore *a = rz_trace_store_new(spill);
+	RzTraceStore *b = rz_trace_store_new(NULL);
+	mu_assert_notnull(a, "store");
+	ut8 data[0x180];
+	memset(data, 0x42, sizeof(data));
+	// enough for several chunks
+	const ut64 steps = 200000;
+	for (ut64 i = 0; i < steps; i++) {
+		ut64 pc = 0x400000 + (i % 1000) * 4;
+		rz_trace_store_add_pc(a, pc);
+		rz_trace_store_add_pc(b, i == 150000 ? pc + 1 : pc);
+		if (!(i % 100)) {
+			rz_trace_store_add_reg(a, i % 16, i);
+			rz_trace_store_add_mem(a, pc, data, sizeof(data));
+		}
+	}
+	mu_assert_eq(rz_trace_store_steps(a), steps, "steps");
+	mu_assert_eq(rz_trace_store_hits(a, 0x400000), steps / 1000, "hits");
+	mu_assert_true(rz_trace_store_size(b) < steps * 2, "compact pcs");
+
+	RzTraceStoreReader reader;
+	RzTraceStoreRecord record;
+	rz_trace_store_reader_init(&reader, a);
+	ut64 i = 0, mem = 0;
+	while (rz_trace_store_reader_next(&reader, &record)) {
+		if (record.type == RZ_TRACE_STORE_PC) {
+			mu_assert_eq(record.addr, 0x400000 + (i % 1000) * 4, "pc");
+			i++;
+		} else if (record.type == RZ_TRACE_STORE_MEM) {
+			mu_assert_eq(record.data[0], 0x42, "mem data");
+			mem += record.size;
+		}
+	}
+	mu_assert_eq(i, steps, "all the pcs read");
+	mu_assert_eq(mem, (steps / 100) * sizeof(data), "all the mem writes read");
+
+	mu_assert_eq(rz_trace_store_diff(a, a), UT64_MAX, "same trace");
+	mu_assert_eq(rz_trace_store_diff(a, b), 150000, "diverging trace");
+	rz_trace_store_free(a);
+	rz_trace_store_free(b);
+	if (spill) {
+		mu_assert_false(rz_file_exists(spill), "spill file removed");
+	}
+	mu_end;
+}
+
+bool test_trace_store_chunks(void) {
+	return store_chunks(NULL);
+}
+
+bool test_trace_store_spill(void) {
+	char *spill = rz_file_temp("trace");
+	bool ret = store_chunks(spill);
+	free(spill);
+	return ret;
+}
+
+int all_tests() {
+	mu_run_test(test_trace_store_records);
+	mu_run_test(test_trace_store_coverage);
+	mu_run_test(test_trace_store_chunks);
+	mu_run_test(test_trace_store_spill);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)